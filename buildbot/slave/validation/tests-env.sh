@@ -18,6 +18,11 @@ GAME=$1
 MAP=$2
 AI=$3
 AIVER=$4
+# 1 to run the AIs on worker threads (ThreadedSkirmishAIs)
+THREADEDAI=${5:-0}
+# AI of the second team, the same as the first one by default
+AI2=${6:-$AI}
+AIVER2=${7:-$AIVER}
 
-echo "Env: GAME=$GAME MAP=$MAP AI=$AI AIVER=$AIVER"
+echo "Env: GAME=$GAME MAP=$MAP AI=$AI AIVER=$AIVER THREADEDAI=$THREADEDAI AI2=$AI2 AIVER2=$AIVER2"
 
@@ -12,8 +12,8 @@ PRDL="time ${TESTDIR}/usr/local/bin/pr-downloader --filesystem-writepath=$DOWNLO
 GAME1=$($PRDL --download-game "$GAME" |egrep -o '\[Download\] (.*)' |cut -b 12-)
 $PRDL --download-map "$MAP"
 
-echo "Creating script: test/validation/prepare.sh \"$GAME1\" \"$MAP\" \"$AI\" \"$AIVER\""
-${SOURCEDIR}/test/validation/prepare.sh "$GAME1" "$MAP" "$AI" "$AIVER" > ${CONTENT_DIR}/script.txt
+echo "Creating script: test/validation/prepare.sh \"$GAME1\" \"$MAP\" \"$AI\" \"$AIVER\" \"$AI2\" \"$AIVER2\""
+${SOURCEDIR}/test/validation/prepare.sh "$GAME1" "$MAP" "$AI" "$AIVER" "$AI2" "$AIVER2" > ${CONTENT_DIR}/script.txt
 ${SOURCEDIR}/test/validation/prepare-client.sh ValidationClient 127.0.0.1 8452 >${CONTENT_DIR}/connect.txt
 
 #install required files into spring dir
@@ -44,5 +44,6 @@ cp -v ${SOURCEDIR}/cont/springrc-template-headless.txt ${CONTENT_DIR}/springsett
         echo "LinkIncomingPeakBandwidth = 0"
         echo "LinkIncomingSustainedBandwidth = 0"
         echo "LinkOutgoingBandwidth = 0"
+        echo "ThreadedSkirmishAIs = ${THREADEDAI}"
 ) >> ${CONTENT_DIR}/springsettings.cfg
 
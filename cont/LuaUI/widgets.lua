@@ -127,6 +127,7 @@ local flexCallIns = {
   'UnitCommand',
   'UnitCmdDone',
   'UnitDamaged',
+  'UnitDamagedBatch',
   'UnitEnteredRadar',
   'UnitEnteredLos',
   'UnitLeftRadar',
@@ -1771,6 +1772,24 @@ function widgetHandler:UnitDamaged(unitID, unitDefID, unitTeam,
 end
 
 
+-- values holds count entries of 10 values each: unitID, unitDefID, unitTeam,
+-- damage, paralyzer, weaponDefID, projectileID, attackerID, attackerDefID,
+-- attackerTeam (the last five are -1 for widgets); it is reused next frame
+function widgetHandler:UnitDamagedBatch(frame, count, values)
+  for _,w in ipairs(self.UnitDamagedBatchList) do
+    w:UnitDamagedBatch(frame, count, values)
+  end
+  -- the engine no longer sends UnitDamaged once this call-in exists
+  if (#self.UnitDamagedList > 0) then
+    for i = 0, count - 1 do
+      local b = i * 10
+      self:UnitDamaged(values[b + 1], values[b + 2], values[b + 3], values[b + 4], values[b + 5])
+    end
+  end
+  return
+end
+
+
 function widgetHandler:UnitEnteredRadar(unitID, unitTeam)
   for _,w in ipairs(self.UnitEnteredRadarList) do
     w:UnitEnteredRadar(unitID, unitTeam)
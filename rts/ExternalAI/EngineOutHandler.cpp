@@ -23,16 +23,26 @@
 #include "System/Log/ILog.h"
 #include "System/Util.h"
 #include "System/TimeProfiler.h"
+#include "System/ThreadPool.h"
 
 #include "System/creg/STL_Map.h"
 
+#include <algorithm>
+#include <exception>
+#include <boost/thread/mutex.hpp>
+
 CONFIG(int, CatchAIExceptions).defaultValue(1);
+CONFIG(bool, ThreadedSkirmishAIs).defaultValue(false).description("Lets native (C/C++) Skirmish AIs of different libraries handle the events of a sim frame in parallel on worker threads at the end of that frame, instead of one after another during it. Limitations: the sim frame still waits for all AIs to finish (there is no world snapshot, so the AIs do not overlap the next frame), instances of the same library run one after another, and all AI callbacks share one lock, so only the AI-internal work runs in parallel.");
 //CONFIG(bool, AI_UnpauseAfterInit).defaultValue(true);
 
 CR_BIND_DERIVED(CEngineOutHandler, CObject, )
 CR_REG_METADATA(CEngineOutHandler, (
 	CR_MEMBER(id_skirmishAI),
 	CR_MEMBER(team_skirmishAIs),
+	CR_IGNORED(pendingEvents),
+	CR_IGNORED(pendingPackets),
+	CR_IGNORED(threadedAIs),
+	CR_IGNORED(queueEvents),
 	CR_RESERVED(128)
 ));
 
@@ -78,6 +88,10 @@ void CEngineOutHandler::HandleAIException(const char* description) {
 
 
 CEngineOutHandler* CEngineOutHandler::singleton = NULL;
+bool CEngineOutHandler::runningThreadedAIs = false;
+
+// guards pendingPackets while AIs run threaded
+static boost::mutex pendingPacketsMutex;
 
 CEngineOutHandler* CEngineOutHandler::GetInstance() {
 	static unsigned int numInstances = 0;
@@ -105,6 +119,12 @@ void CEngineOutHandler::Destroy() {
 	}
 }
 
+CEngineOutHandler::CEngineOutHandler()
+	: threadedAIs(configHandler->GetBool("ThreadedSkirmishAIs"))
+	, queueEvents(false)
+{
+}
+
 CEngineOutHandler::~CEngineOutHandler() {
 	// id_skirmishAI should be empty already, but this can not hurt
 	for (id_ai_t::iterator ai = id_skirmishAI.begin(); ai != id_skirmishAI.end(); ++ai) {
@@ -127,12 +147,123 @@ CEngineOutHandler::~CEngineOutHandler() {
 			} CATCH_AI_EXCEPTION;                          \
 		}
 
+#define SEND_EVENT(AI_ID, AI, FUNC)                                          \
+		SendEvent(AI_ID, AI, [=](CSkirmishAIWrapper* saw) { saw->FUNC; });
+
+
+template<typename F>
+void CEngineOutHandler::SendEvent(unsigned char skirmishAIId, CSkirmishAIWrapper* ai, const F& event) {
+	if (queueEvents) {
+		pendingEvents[skirmishAIId].push_back(event);
+		return;
+	}
+
+	try {
+		event(ai);
+	} CATCH_AI_EXCEPTION;
+}
+
+static bool IsThreadSafeAI(const CSkirmishAIWrapper* ai) {
+	// the JVM (and any other interface) is entered from the main thread only
+	return (ai->GetKey().GetInterface().GetShortName() == "C");
+}
+
+void CEngineOutHandler::RunPendingEvents(bool threaded) {
+	typedef std::pair<CSkirmishAIWrapper*, const std::vector<event_t>*> ai_events_t;
+
+	if (pendingEvents.empty())
+		return;
+
+	// events raised by the AIs themselves (eg. through cheats) are queued
+	// again and delivered by the next call
+	id_events_t events;
+	events.swap(pendingEvents);
+
+	// instances of the same library may share static state,
+	// so only different libraries are run concurrently
+	std::map<SkirmishAIKey, std::vector<ai_events_t> > libraryEvents;
+	std::vector<ai_events_t> serialEvents;
+
+	for (id_events_t::const_iterator it = events.begin(); it != events.end(); ++it) {
+		const id_ai_t::const_iterator ai = id_skirmishAI.find(it->first);
+
+		if (ai == id_skirmishAI.end())
+			continue;
+
+		if (threaded && IsThreadSafeAI(ai->second)) {
+			libraryEvents[ai->second->GetKey()].push_back(ai_events_t(ai->second, &it->second));
+		} else {
+			serialEvents.push_back(ai_events_t(ai->second, &it->second));
+		}
+	}
+
+	for (size_t n = 0; n < serialEvents.size(); n++) {
+		for (size_t e = 0; e < serialEvents[n].second->size(); e++) {
+			try {
+				(*serialEvents[n].second)[e](serialEvents[n].first);
+			} CATCH_AI_EXCEPTION;
+		}
+	}
+
+	if (libraryEvents.empty())
+		return;
+
+	std::vector< std::vector<ai_events_t> > tasks;
+	std::vector<std::exception_ptr> errors(libraryEvents.size());
+
+	for (auto it = libraryEvents.begin(); it != libraryEvents.end(); ++it) {
+		tasks.push_back(it->second);
+	}
+
+	// the engine state stays as it is until all AIs are done, the
+	// callbacks only have to be kept from running at the same time
+	// NOTE: the sim frame waits here, a slow AI still stretches it
+	skirmishAiCallback_setLocking(true);
+	runningThreadedAIs = true;
+
+	for_mt(0, tasks.size(), [&](const int i) {
+		try {
+			for (size_t n = 0; n < tasks[i].size(); n++) {
+				for (size_t e = 0; e < tasks[i][n].second->size(); e++) {
+					try {
+						(*tasks[i][n].second)[e](tasks[i][n].first);
+					} CATCH_AI_EXCEPTION;
+				}
+			}
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+	});
+
+	runningThreadedAIs = false;
+	skirmishAiCallback_setLocking(false);
+
+	// each AI ran on a single thread, so sorting by ID keeps
+	// the order of the packets sent by the same AI
+	std::stable_sort(pendingPackets.begin(), pendingPackets.end(), [](const ai_packet_t& a, const ai_packet_t& b) {
+		return (a.first < b.first);
+	});
+
+	for (size_t n = 0; n < pendingPackets.size(); n++) {
+		net->Send(pendingPackets[n].second);
+	}
+
+	pendingPackets.clear();
+
+	for (size_t i = 0; i < errors.size(); i++) {
+		if (errors[i])
+			std::rethrow_exception(errors[i]);
+	}
+}
+
 
 void CEngineOutHandler::PostLoad() {}
 
 void CEngineOutHandler::PreDestroy() {
 	AI_EVT_MTH();
 
+	RunPendingEvents(false);
+
 	DO_FOR_SKIRMISH_AIS(PreDestroy())
 }
 
@@ -145,6 +276,8 @@ void CEngineOutHandler::Load(std::istream* s) {
 void CEngineOutHandler::Save(std::ostream* s) {
 	AI_EVT_MTH();
 
+	RunPendingEvents(false);
+
 	DO_FOR_SKIRMISH_AIS(Save(s))
 }
 
@@ -154,7 +287,38 @@ void CEngineOutHandler::Update() {
 
 	const int frame = gs->frameNum;
 
-	DO_FOR_SKIRMISH_AIS(Update(frame))
+	for (id_ai_t::iterator ai = id_skirmishAI.begin(); ai != id_skirmishAI.end(); ++ai) {
+		SEND_EVENT(ai->first, ai->second, Update(frame))
+	}
+}
+
+void CEngineOutHandler::BeginSimFrame() {
+	queueEvents = (threadedAIs && !id_skirmishAI.empty());
+}
+
+void CEngineOutHandler::EndSimFrame() {
+	if (!queueEvents)
+		return;
+
+	SCOPED_TIMER("AI Total");
+
+	// events raised by the AIs while handling the
+	// frame's events are delivered in the same frame
+	while (!pendingEvents.empty()) {
+		RunPendingEvents(true);
+	}
+
+	queueEvents = false;
+}
+
+void CEngineOutHandler::SendAIPacket(boost::shared_ptr<const netcode::RawPacket> packet) {
+	if (!runningThreadedAIs) {
+		net->Send(packet);
+		return;
+	}
+
+	boost::mutex::scoped_lock lock(pendingPacketsMutex);
+	pendingPackets.push_back(ai_packet_t(skirmishAIHandler.GetCurrentAIID(), packet));
 }
 
 
@@ -167,9 +331,7 @@ void CEngineOutHandler::Update() {
 					ai != id_skirmishAI.end(); ++ai) {									\
 				const int aiAllyTeam = teamHandler->AllyTeam(ai->second->GetTeamId());	\
 				if (teamHandler->Ally(aiAllyTeam, ALLY_TEAM_ID)) {						\
-					try {																\
-						ai->second->FUNC;												\
-					} CATCH_AI_EXCEPTION;												\
+					SEND_EVENT(ai->first, ai->second, FUNC)								\
 				}																		\
 			}																			\
 		}
@@ -217,9 +379,7 @@ void CEngineOutHandler::UnitLeftRadar(const CUnit& unit, int allyTeamId) {
 		if (team_skirmishAIs.find(TEAM_ID) != team_skirmishAIs.end()) {		\
 			for (ids_t::iterator ai = team_skirmishAIs[TEAM_ID].begin();	\
 					ai != team_skirmishAIs[TEAM_ID].end(); ++ai) {			\
-				try {														\
-					id_skirmishAI[*ai]->FUNC;								\
-				} CATCH_AI_EXCEPTION;										\
+				SEND_EVENT(*ai, id_skirmishAI[*ai], FUNC)					\
 			}																\
 		}
 
@@ -235,9 +395,7 @@ void CEngineOutHandler::UnitLeftRadar(const CUnit& unit, int allyTeamId) {
 			if (!teamHandler->Ally(aiAllyTeam, ALLY_TEAM_ID) &&						\
 					(saw->IsCheatEventsEnabled() ||							\
 					IsUnitInLosOrRadarOfAllyTeam(UNIT, aiAllyTeam))) {				\
-				try {																\
-					ai->second->FUNC;												\
-				} CATCH_AI_EXCEPTION;												\
+				SEND_EVENT(ai->first, ai->second, FUNC)								\
 			}																		\
 		}
 
@@ -308,9 +466,7 @@ void CEngineOutHandler::UnitGiven(const CUnit& unit, int oldTeam, int newTeam) {
 			inform = false;
 		}
 		if (inform) {
-			try {
-				ai->second->UnitGiven(unitId, oldTeam, newTeam);
-			} CATCH_AI_EXCEPTION;
+			SEND_EVENT(ai->first, ai->second, UnitGiven(unitId, oldTeam, newTeam))
 		}
 	}
 }
@@ -338,9 +494,7 @@ void CEngineOutHandler::UnitCaptured(const CUnit& unit, int oldTeam, int newTeam
 			inform = false;
 		}
 		if (inform) {
-			try {
-				ai->second->UnitCaptured(unitId, oldTeam, newTeam);
-			} CATCH_AI_EXCEPTION;
+			SEND_EVENT(ai->first, ai->second, UnitCaptured(unitId, oldTeam, newTeam))
 		}
 	}
 }
@@ -363,9 +517,7 @@ void CEngineOutHandler::UnitDestroyed(const CUnit& destroyed, const CUnit* attac
 			if (attackerInLosOrRadar || saw->IsCheatEventsEnabled()) {
 				visibleAttackerId = attackerId;
 			}
-			try {
-				saw->UnitDestroyed(destroyedId, visibleAttackerId);
-			} CATCH_AI_EXCEPTION;
+			SEND_EVENT(*ai, saw, UnitDestroyed(destroyedId, visibleAttackerId))
 		}
 	}
 
@@ -385,9 +537,7 @@ void CEngineOutHandler::UnitDestroyed(const CUnit& destroyed, const CUnit* attac
 		if ((attacker != NULL) && teamHandler->Ally(allyT, attacker->allyteam)) {
 			myAttackerId = attackerId;
 		}
-		try {
-			ai->second->EnemyDestroyed(destroyedId, myAttackerId);
-		} CATCH_AI_EXCEPTION;
+		SEND_EVENT(ai->first, ai->second, EnemyDestroyed(destroyedId, myAttackerId))
 	}
 }
 
@@ -422,9 +572,7 @@ void CEngineOutHandler::UnitDamaged(
 			if (attackerInLosOrRadar || saw->IsCheatEventsEnabled()) {
 				visibleAttackerUnitId = attackerUnitId;
 			}
-			try {
-				id_skirmishAI[*ai]->UnitDamaged(damagedUnitId, visibleAttackerUnitId, damage, attackDir_damagedsView, weaponDefID, paralyzer);
-			} CATCH_AI_EXCEPTION;
+			SEND_EVENT(*ai, saw, UnitDamaged(damagedUnitId, visibleAttackerUnitId, damage, attackDir_damagedsView, weaponDefID, paralyzer))
 		}
 	}
 
@@ -443,10 +591,8 @@ void CEngineOutHandler::UnitDamaged(
 				CSkirmishAIWrapper* saw = id_skirmishAI[*ai];
 				if (damagedInLosOrRadar || saw->IsCheatEventsEnabled())
 				{
-					try {
-						saw->EnemyDamaged(damagedUnitId, attackerUnitId, damage,
-								attackDir, weaponDefID, paralyzer);
-					} CATCH_AI_EXCEPTION;
+					SEND_EVENT(*ai, saw, EnemyDamaged(damagedUnitId, attackerUnitId, damage,
+								attackDir, weaponDefID, paralyzer))
 				}
 			}
 		}
@@ -497,7 +643,12 @@ void CEngineOutHandler::CommandFinished(const CUnit& unit, const Command& comman
 void CEngineOutHandler::SendChatMessage(const char* msg, int fromPlayerId) {
 	AI_EVT_MTH();
 
-	DO_FOR_SKIRMISH_AIS(SendChatMessage(msg, fromPlayerId))
+	// msg may be gone by the time a queued event is delivered
+	const std::string message = msg;
+
+	for (id_ai_t::iterator ai = id_skirmishAI.begin(); ai != id_skirmishAI.end(); ++ai) {
+		SEND_EVENT(ai->first, ai->second, SendChatMessage(message.c_str(), fromPlayerId))
+	}
 }
 
 bool CEngineOutHandler::SendLuaMessages(int aiTeam, const char* inData, std::vector<const char*>& outData) {
@@ -506,6 +657,11 @@ bool CEngineOutHandler::SendLuaMessages(int aiTeam, const char* inData, std::vec
 	if (id_skirmishAI.empty()) {
 		return false;
 	}
+	if (runningThreadedAIs) {
+		// the replies would have to be waited for
+		LOG_L(L_WARNING, "[%s] can not message AIs from an AI callback while they run threaded", __FUNCTION__);
+		return false;
+	}
 
 	id_ai_t::iterator it;
 	unsigned int n = 0;
@@ -651,6 +807,7 @@ void CEngineOutHandler::DestroySkirmishAI(const size_t skirmishAIId) {
 		aiWrapper->Release(reason);
 
 		id_skirmishAI.erase(skirmishAIId);
+		pendingEvents.erase(skirmishAIId);
 		internal_aiErase(team_skirmishAIs[aiWrapper->GetTeamId()], skirmishAIId);
 
 		delete aiWrapper;
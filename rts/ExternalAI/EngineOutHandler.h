@@ -6,9 +6,11 @@
 #include "System/Object.h"
 #include "Sim/Misc/GlobalConstants.h"
 
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
+#include <boost/shared_ptr.hpp>
 
 struct Command;
 class float3;
@@ -18,6 +20,9 @@ struct WeaponDef;
 class SkirmishAIKey;
 class CSkirmishAIWrapper;
 struct SSkirmishAICallback;
+namespace netcode {
+	class RawPacket;
+}
 
 
 void handleAIException(const char* description);
@@ -25,6 +30,7 @@ void handleAIException(const char* description);
 class CEngineOutHandler : public CObject {
 	CR_DECLARE(CEngineOutHandler);
 
+	CEngineOutHandler();
 	~CEngineOutHandler();
 
 public:
@@ -37,6 +43,23 @@ public:
 
 	void Update();
 
+	/**
+	 * With ThreadedSkirmishAIs, the events raised between these two calls
+	 * (one sim frame) are queued and handed to the AIs by EndSimFrame(),
+	 * once the frame is complete and before the units killed in it are
+	 * deleted. Called for every frame, also while skipping.
+	 */
+	void BeginSimFrame();
+	void EndSimFrame();
+
+	/**
+	 * Sends a packet on behalf of the AI whose callback is running.
+	 * While AIs run threaded, the packets are held back and sent in
+	 * AI ID order once all AIs are done, so their commands reach the
+	 * server in the same order on every run.
+	 */
+	void SendAIPacket(boost::shared_ptr<const netcode::RawPacket> packet);
+
 	/** Group should return false if it doenst want the unit for some reason. */
 	bool UnitAddedToGroup(const CUnit& unit, const CGroup& group);
 	/** No way to refuse giving up a unit. */
@@ -115,6 +138,13 @@ public:
 	 * @see CATCH_AI_EXCEPTION
 	 */
 	static void HandleAIException(const char* description);
+
+	/**
+	 * True while EndSimFrame() lets AIs handle their events on worker threads
+	 * (ThreadedSkirmishAIs), during which the engine state may only be read
+	 * through the (then locked) AI callbacks.
+	 */
+	static bool IsRunningThreadedAIs() { return runningThreadedAIs; }
 	/**
 	 * Catches a common set of exceptions thrown by AIs.
 	 * Use like this:
@@ -146,12 +176,29 @@ public:
 
 private:
 	static CEngineOutHandler* singleton;
+	static bool runningThreadedAIs;
 
 private:
 	typedef std::vector<unsigned char> ids_t;
 	typedef std::map<unsigned char, CSkirmishAIWrapper*> id_ai_t;
 	typedef std::map<int, ids_t> team_ais_t;
 
+	typedef std::function<void(CSkirmishAIWrapper*)> event_t;
+	typedef std::map<unsigned char, std::vector<event_t> > id_events_t;
+
+	typedef std::pair<unsigned char, boost::shared_ptr<const netcode::RawPacket> > ai_packet_t;
+
+	/**
+	 * Calls event on the AI right away, or queues it until
+	 * EndSimFrame() if AIs run threaded and a frame is running.
+	 */
+	template<typename F> void SendEvent(unsigned char skirmishAIId, CSkirmishAIWrapper* ai, const F& event);
+	/**
+	 * Delivers the queued events, in parallel for AIs of different
+	 * libraries if threaded is true.
+	 */
+	void RunPendingEvents(bool threaded);
+
 	/// Contains all local Skirmish AIs, indexed by their ID
 	id_ai_t id_skirmishAI;
 
@@ -160,6 +207,14 @@ private:
 	 * There can be multiple Skirmish AIs per team.
 	 */
 	team_ais_t team_skirmishAIs;
+
+	/// events not yet delivered to each AI, see SendEvent()
+	id_events_t pendingEvents;
+	/// packets sent by AIs running threaded, see SendAIPacket()
+	std::vector<ai_packet_t> pendingPackets;
+	bool threadedAIs;
+	/// true between BeginSimFrame() and EndSimFrame() if threadedAIs
+	bool queueEvents;
 };
 
 #define eoh CEngineOutHandler::GetInstance()
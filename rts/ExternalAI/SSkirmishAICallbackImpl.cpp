@@ -42,6 +42,8 @@
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/Log/ILog.h"
 
+#include <boost/thread/recursive_mutex.hpp>
+
 
 static const char* SKIRMISH_AIS_VERSION_COMMON = "common";
 
@@ -52,6 +54,12 @@ static std::map<int, bool>                 skirmishAIId_cheatingEnabled;
 static std::map<int, bool>                 skirmishAIId_usesCheats;
 static std::map<int, int>                  skirmishAIId_teamId;
 
+// held by every callback while AIs run on worker threads (ThreadedSkirmishAIs);
+// the engine state does not change during that time, so it is enough to keep
+// the callbacks of different AIs from running at the same time
+static boost::recursive_mutex callbackMutex;
+static bool callbackLocking = false;
+
 static const size_t MARKERS_MAX_SIZE = 16384;
 static std::vector<PointMarker> tmpPointMarkerArr[MAX_SKIRMISH_AIS];
 static std::vector<LineMarker> tmpLineMarkerArr[MAX_SKIRMISH_AIS];
@@ -3583,19 +3591,18 @@ EXPORT(int) skirmishAiCallback_getTeamUnits(int skirmishAIId, int* unitIds, int
 	int a = 0;
 
 	const int teamId = skirmishAIId_teamId[skirmishAIId];
-	for (std::list<CUnit*>::iterator ui = unitHandler->activeUnits.begin();
-			ui != unitHandler->activeUnits.end(); ++ui) {
-		CUnit* u = *ui;
-
-		if (u->team == teamId) {
-			if (a < unitIds_sizeMax) {
-				if (unitIds != NULL) {
-					unitIds[a] = u->id;
-				}
-				a++;
-			} else {
-				break;
+	const CUnitSet& teamUnits = teamHandler->Team(teamId)->units;
+
+	for (CUnitSet::const_iterator ui = teamUnits.begin(); ui != teamUnits.end(); ++ui) {
+		const CUnit* u = *ui;
+
+		if (a < unitIds_sizeMax) {
+			if (unitIds != NULL) {
+				unitIds[a] = u->id;
 			}
+			a++;
+		} else {
+			break;
 		}
 	}
 
@@ -4532,610 +4539,624 @@ EXPORT(bool) skirmishAiCallback_Group_isSelected(int skirmishAIId, int groupId)
 
 
 
+template<typename F, F func> struct LockedCallback;
+template<typename R, typename... Args, R (CALLING_CONV_FUNC_POINTER *func)(Args...)>
+struct LockedCallback<R (CALLING_CONV_FUNC_POINTER *)(Args...), func> {
+	static R CALLING_CONV Call(Args... args) {
+		if (!callbackLocking)
+			return func(args...);
+
+		boost::recursive_mutex::scoped_lock lock(callbackMutex);
+		return func(args...);
+	}
+};
+
+#define LOCKED_CALLBACK(func) (&LockedCallback<decltype(&func), &func>::Call)
+
 static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	//! register function pointers to the accessors
-	callback->Engine_handleCommand = &skirmishAiCallback_Engine_handleCommand;
-	callback->Engine_Version_getMajor = &skirmishAiCallback_Engine_Version_getMajor;
-	callback->Engine_Version_getMinor = &skirmishAiCallback_Engine_Version_getMinor;
-	callback->Engine_Version_getPatchset = &skirmishAiCallback_Engine_Version_getPatchset;
-	callback->Engine_Version_getCommits = &skirmishAiCallback_Engine_Version_getCommits;
-	callback->Engine_Version_getHash = &skirmishAiCallback_Engine_Version_getHash;
-	callback->Engine_Version_getBranch = &skirmishAiCallback_Engine_Version_getBranch;
-	callback->Engine_Version_getAdditional = &skirmishAiCallback_Engine_Version_getAdditional;
-	callback->Engine_Version_getBuildTime = &skirmishAiCallback_Engine_Version_getBuildTime;
-	callback->Engine_Version_isRelease = &skirmishAiCallback_Engine_Version_isRelease;
-	callback->Engine_Version_getNormal = &skirmishAiCallback_Engine_Version_getNormal;
-	callback->Engine_Version_getSync = &skirmishAiCallback_Engine_Version_getSync;
-	callback->Engine_Version_getFull = &skirmishAiCallback_Engine_Version_getFull;
-	callback->Teams_getSize = &skirmishAiCallback_Teams_getSize;
-	callback->SkirmishAIs_getSize = &skirmishAiCallback_SkirmishAIs_getSize;
-	callback->SkirmishAIs_getMax = &skirmishAiCallback_SkirmishAIs_getMax;
-	callback->SkirmishAI_getTeamId = &skirmishAiCallback_SkirmishAI_getTeamId;
-	callback->SkirmishAI_Info_getSize = &skirmishAiCallback_SkirmishAI_Info_getSize;
-	callback->SkirmishAI_Info_getKey = &skirmishAiCallback_SkirmishAI_Info_getKey;
-	callback->SkirmishAI_Info_getValue = &skirmishAiCallback_SkirmishAI_Info_getValue;
-	callback->SkirmishAI_Info_getDescription = &skirmishAiCallback_SkirmishAI_Info_getDescription;
-	callback->SkirmishAI_Info_getValueByKey = &skirmishAiCallback_SkirmishAI_Info_getValueByKey;
-	callback->SkirmishAI_OptionValues_getSize = &skirmishAiCallback_SkirmishAI_OptionValues_getSize;
-	callback->SkirmishAI_OptionValues_getKey = &skirmishAiCallback_SkirmishAI_OptionValues_getKey;
-	callback->SkirmishAI_OptionValues_getValue = &skirmishAiCallback_SkirmishAI_OptionValues_getValue;
-	callback->SkirmishAI_OptionValues_getValueByKey = &skirmishAiCallback_SkirmishAI_OptionValues_getValueByKey;
-	callback->Log_log = &skirmishAiCallback_Log_log;
-	callback->Log_exception = &skirmishAiCallback_Log_exception;
-	callback->DataDirs_getPathSeparator = &skirmishAiCallback_DataDirs_getPathSeparator;
-	callback->DataDirs_getConfigDir = &skirmishAiCallback_DataDirs_getConfigDir;
-	callback->DataDirs_getWriteableDir = &skirmishAiCallback_DataDirs_getWriteableDir;
-	callback->DataDirs_locatePath = &skirmishAiCallback_DataDirs_locatePath;
-	callback->DataDirs_allocatePath = &skirmishAiCallback_DataDirs_allocatePath;
-	callback->DataDirs_Roots_getSize = &skirmishAiCallback_DataDirs_Roots_getSize;
-	callback->DataDirs_Roots_getDir = &skirmishAiCallback_DataDirs_Roots_getDir;
-	callback->DataDirs_Roots_locatePath = &skirmishAiCallback_DataDirs_Roots_locatePath;
-	callback->DataDirs_Roots_allocatePath = &skirmishAiCallback_DataDirs_Roots_allocatePath;
-	callback->Game_getCurrentFrame = &skirmishAiCallback_Game_getCurrentFrame;
-	callback->Game_getAiInterfaceVersion = &skirmishAiCallback_Game_getAiInterfaceVersion;
-	callback->Game_getMyTeam = &skirmishAiCallback_Game_getMyTeam;
-	callback->Game_getMyAllyTeam = &skirmishAiCallback_Game_getMyAllyTeam;
-	callback->Game_getPlayerTeam = &skirmishAiCallback_Game_getPlayerTeam;
-	callback->Game_getTeams = &skirmishAiCallback_Game_getTeams;
-	callback->Game_getTeamSide = &skirmishAiCallback_Game_getTeamSide;
-	callback->Game_getTeamColor = &skirmishAiCallback_Game_getTeamColor;
-	callback->Game_getTeamIncomeMultiplier = &skirmishAiCallback_Game_getTeamIncomeMultiplier;
-	callback->Game_getTeamAllyTeam = &skirmishAiCallback_Game_getTeamAllyTeam;
-	callback->Game_getTeamResourceCurrent = &skirmishAiCallback_Game_getTeamResourceCurrent;
-	callback->Game_getTeamResourceIncome = &skirmishAiCallback_Game_getTeamResourceIncome;
-	callback->Game_getTeamResourceUsage = &skirmishAiCallback_Game_getTeamResourceUsage;
-	callback->Game_getTeamResourceStorage = &skirmishAiCallback_Game_getTeamResourceStorage;
-	callback->Game_isAllied = &skirmishAiCallback_Game_isAllied;
-	callback->Game_isExceptionHandlingEnabled = &skirmishAiCallback_Game_isExceptionHandlingEnabled;
-	callback->Game_isDebugModeEnabled = &skirmishAiCallback_Game_isDebugModeEnabled;
-	callback->Game_isPaused = &skirmishAiCallback_Game_isPaused;
-	callback->Game_getSpeedFactor = &skirmishAiCallback_Game_getSpeedFactor;
-	callback->Game_getSetupScript = &skirmishAiCallback_Game_getSetupScript;
-	callback->Game_getCategoryFlag = &skirmishAiCallback_Game_getCategoryFlag;
-	callback->Game_getCategoriesFlag = &skirmishAiCallback_Game_getCategoriesFlag;
-	callback->Game_getCategoryName = &skirmishAiCallback_Game_getCategoryName;
-	callback->Gui_getViewRange = &skirmishAiCallback_Gui_getViewRange;
-	callback->Gui_getScreenX = &skirmishAiCallback_Gui_getScreenX;
-	callback->Gui_getScreenY = &skirmishAiCallback_Gui_getScreenY;
-	callback->Gui_Camera_getDirection = &skirmishAiCallback_Gui_Camera_getDirection;
-	callback->Gui_Camera_getPosition = &skirmishAiCallback_Gui_Camera_getPosition;
-	callback->Cheats_isEnabled = &skirmishAiCallback_Cheats_isEnabled;
-	callback->Cheats_setEnabled = &skirmishAiCallback_Cheats_setEnabled;
-	callback->Cheats_setEventsEnabled = &skirmishAiCallback_Cheats_setEventsEnabled;
-	callback->Cheats_isOnlyPassive = &skirmishAiCallback_Cheats_isOnlyPassive;
-	callback->getResources = &skirmishAiCallback_getResources;
-	callback->getResourceByName = &skirmishAiCallback_getResourceByName;
-	callback->Resource_getName = &skirmishAiCallback_Resource_getName;
-	callback->Resource_getOptimum = &skirmishAiCallback_Resource_getOptimum;
-	callback->Economy_getCurrent = &skirmishAiCallback_Economy_getCurrent;
-	callback->Economy_getIncome = &skirmishAiCallback_Economy_getIncome;
-	callback->Economy_getUsage = &skirmishAiCallback_Economy_getUsage;
-	callback->Economy_getStorage = &skirmishAiCallback_Economy_getStorage;
-	callback->File_getSize = &skirmishAiCallback_File_getSize;
-	callback->File_getContent = &skirmishAiCallback_File_getContent;
-	callback->getUnitDefs = &skirmishAiCallback_getUnitDefs;
-	callback->getUnitDefByName = &skirmishAiCallback_getUnitDefByName;
-	callback->UnitDef_getHeight = &skirmishAiCallback_UnitDef_getHeight;
-	callback->UnitDef_getRadius = &skirmishAiCallback_UnitDef_getRadius;
-	callback->UnitDef_getName = &skirmishAiCallback_UnitDef_getName;
-	callback->UnitDef_getHumanName = &skirmishAiCallback_UnitDef_getHumanName;
-	callback->UnitDef_getFileName = &skirmishAiCallback_UnitDef_getFileName;
-	callback->UnitDef_getAiHint = &skirmishAiCallback_UnitDef_getAiHint;
-	callback->UnitDef_getCobId = &skirmishAiCallback_UnitDef_getCobId;
-	callback->UnitDef_getTechLevel = &skirmishAiCallback_UnitDef_getTechLevel;
-	callback->UnitDef_getGaia = &skirmishAiCallback_UnitDef_getGaia;
-	callback->UnitDef_getUpkeep = &skirmishAiCallback_UnitDef_getUpkeep;
-	callback->UnitDef_getResourceMake = &skirmishAiCallback_UnitDef_getResourceMake;
-	callback->UnitDef_getMakesResource = &skirmishAiCallback_UnitDef_getMakesResource;
-	callback->UnitDef_getCost = &skirmishAiCallback_UnitDef_getCost;
-	callback->UnitDef_getExtractsResource = &skirmishAiCallback_UnitDef_getExtractsResource;
-	callback->UnitDef_getResourceExtractorRange = &skirmishAiCallback_UnitDef_getResourceExtractorRange;
-	callback->UnitDef_getWindResourceGenerator = &skirmishAiCallback_UnitDef_getWindResourceGenerator;
-	callback->UnitDef_getTidalResourceGenerator = &skirmishAiCallback_UnitDef_getTidalResourceGenerator;
-	callback->UnitDef_getStorage = &skirmishAiCallback_UnitDef_getStorage;
-	callback->UnitDef_isSquareResourceExtractor = &skirmishAiCallback_UnitDef_isSquareResourceExtractor;
-	callback->UnitDef_getBuildTime = &skirmishAiCallback_UnitDef_getBuildTime;
-	callback->UnitDef_getAutoHeal = &skirmishAiCallback_UnitDef_getAutoHeal;
-	callback->UnitDef_getIdleAutoHeal = &skirmishAiCallback_UnitDef_getIdleAutoHeal;
-	callback->UnitDef_getIdleTime = &skirmishAiCallback_UnitDef_getIdleTime;
-	callback->UnitDef_getPower = &skirmishAiCallback_UnitDef_getPower;
-	callback->UnitDef_getHealth = &skirmishAiCallback_UnitDef_getHealth;
-	callback->UnitDef_getCategory = &skirmishAiCallback_UnitDef_getCategory;
-	callback->UnitDef_getSpeed = &skirmishAiCallback_UnitDef_getSpeed;
-	callback->UnitDef_getTurnRate = &skirmishAiCallback_UnitDef_getTurnRate;
-	callback->UnitDef_isTurnInPlace = &skirmishAiCallback_UnitDef_isTurnInPlace;
-	callback->UnitDef_getTurnInPlaceDistance = &skirmishAiCallback_UnitDef_getTurnInPlaceDistance;
-	callback->UnitDef_getTurnInPlaceSpeedLimit = &skirmishAiCallback_UnitDef_getTurnInPlaceSpeedLimit;
-	callback->UnitDef_isUpright = &skirmishAiCallback_UnitDef_isUpright;
-	callback->UnitDef_isCollide = &skirmishAiCallback_UnitDef_isCollide;
-	callback->UnitDef_getLosRadius = &skirmishAiCallback_UnitDef_getLosRadius;
-	callback->UnitDef_getAirLosRadius = &skirmishAiCallback_UnitDef_getAirLosRadius;
-	callback->UnitDef_getLosHeight = &skirmishAiCallback_UnitDef_getLosHeight;
-	callback->UnitDef_getRadarRadius = &skirmishAiCallback_UnitDef_getRadarRadius;
-	callback->UnitDef_getSonarRadius = &skirmishAiCallback_UnitDef_getSonarRadius;
-	callback->UnitDef_getJammerRadius = &skirmishAiCallback_UnitDef_getJammerRadius;
-	callback->UnitDef_getSonarJamRadius = &skirmishAiCallback_UnitDef_getSonarJamRadius;
-	callback->UnitDef_getSeismicRadius = &skirmishAiCallback_UnitDef_getSeismicRadius;
-	callback->UnitDef_getSeismicSignature = &skirmishAiCallback_UnitDef_getSeismicSignature;
-	callback->UnitDef_isStealth = &skirmishAiCallback_UnitDef_isStealth;
-	callback->UnitDef_isSonarStealth = &skirmishAiCallback_UnitDef_isSonarStealth;
-	callback->UnitDef_isBuildRange3D = &skirmishAiCallback_UnitDef_isBuildRange3D;
-	callback->UnitDef_getBuildDistance = &skirmishAiCallback_UnitDef_getBuildDistance;
-	callback->UnitDef_getBuildSpeed = &skirmishAiCallback_UnitDef_getBuildSpeed;
-	callback->UnitDef_getReclaimSpeed = &skirmishAiCallback_UnitDef_getReclaimSpeed;
-	callback->UnitDef_getRepairSpeed = &skirmishAiCallback_UnitDef_getRepairSpeed;
-	callback->UnitDef_getMaxRepairSpeed = &skirmishAiCallback_UnitDef_getMaxRepairSpeed;
-	callback->UnitDef_getResurrectSpeed = &skirmishAiCallback_UnitDef_getResurrectSpeed;
-	callback->UnitDef_getCaptureSpeed = &skirmishAiCallback_UnitDef_getCaptureSpeed;
-	callback->UnitDef_getTerraformSpeed = &skirmishAiCallback_UnitDef_getTerraformSpeed;
-	callback->UnitDef_getMass = &skirmishAiCallback_UnitDef_getMass;
-	callback->UnitDef_isPushResistant = &skirmishAiCallback_UnitDef_isPushResistant;
-	callback->UnitDef_isStrafeToAttack = &skirmishAiCallback_UnitDef_isStrafeToAttack;
-	callback->UnitDef_getMinCollisionSpeed = &skirmishAiCallback_UnitDef_getMinCollisionSpeed;
-	callback->UnitDef_getSlideTolerance = &skirmishAiCallback_UnitDef_getSlideTolerance;
-	callback->UnitDef_getMaxSlope = &skirmishAiCallback_UnitDef_getMaxSlope;
-	callback->UnitDef_getMaxHeightDif = &skirmishAiCallback_UnitDef_getMaxHeightDif;
-	callback->UnitDef_getMinWaterDepth = &skirmishAiCallback_UnitDef_getMinWaterDepth;
-	callback->UnitDef_getWaterline = &skirmishAiCallback_UnitDef_getWaterline;
-	callback->UnitDef_getMaxWaterDepth = &skirmishAiCallback_UnitDef_getMaxWaterDepth;
-	callback->UnitDef_getArmoredMultiple = &skirmishAiCallback_UnitDef_getArmoredMultiple;
-	callback->UnitDef_getArmorType = &skirmishAiCallback_UnitDef_getArmorType;
-	callback->UnitDef_FlankingBonus_getMode = &skirmishAiCallback_UnitDef_FlankingBonus_getMode;
-	callback->UnitDef_FlankingBonus_getDir = &skirmishAiCallback_UnitDef_FlankingBonus_getDir;
-	callback->UnitDef_FlankingBonus_getMax = &skirmishAiCallback_UnitDef_FlankingBonus_getMax;
-	callback->UnitDef_FlankingBonus_getMin = &skirmishAiCallback_UnitDef_FlankingBonus_getMin;
-	callback->UnitDef_FlankingBonus_getMobilityAdd = &skirmishAiCallback_UnitDef_FlankingBonus_getMobilityAdd;
-	callback->UnitDef_getMaxWeaponRange = &skirmishAiCallback_UnitDef_getMaxWeaponRange;
-	callback->UnitDef_getType = &skirmishAiCallback_UnitDef_getType;
-	callback->UnitDef_getTooltip = &skirmishAiCallback_UnitDef_getTooltip;
-	callback->UnitDef_getWreckName = &skirmishAiCallback_UnitDef_getWreckName;
-	callback->UnitDef_getDeathExplosion = &skirmishAiCallback_UnitDef_getDeathExplosion;
-	callback->UnitDef_getSelfDExplosion = &skirmishAiCallback_UnitDef_getSelfDExplosion;
-	callback->UnitDef_getCategoryString = &skirmishAiCallback_UnitDef_getCategoryString;
-	callback->UnitDef_isAbleToSelfD = &skirmishAiCallback_UnitDef_isAbleToSelfD;
-	callback->UnitDef_getSelfDCountdown = &skirmishAiCallback_UnitDef_getSelfDCountdown;
-	callback->UnitDef_isAbleToSubmerge = &skirmishAiCallback_UnitDef_isAbleToSubmerge;
-	callback->UnitDef_isAbleToFly = &skirmishAiCallback_UnitDef_isAbleToFly;
-	callback->UnitDef_isAbleToMove = &skirmishAiCallback_UnitDef_isAbleToMove;
-	callback->UnitDef_isAbleToHover = &skirmishAiCallback_UnitDef_isAbleToHover;
-	callback->UnitDef_isFloater = &skirmishAiCallback_UnitDef_isFloater;
-	callback->UnitDef_isBuilder = &skirmishAiCallback_UnitDef_isBuilder;
-	callback->UnitDef_isActivateWhenBuilt = &skirmishAiCallback_UnitDef_isActivateWhenBuilt;
-	callback->UnitDef_isOnOffable = &skirmishAiCallback_UnitDef_isOnOffable;
-	callback->UnitDef_isFullHealthFactory = &skirmishAiCallback_UnitDef_isFullHealthFactory;
-	callback->UnitDef_isFactoryHeadingTakeoff = &skirmishAiCallback_UnitDef_isFactoryHeadingTakeoff;
-	callback->UnitDef_isReclaimable = &skirmishAiCallback_UnitDef_isReclaimable;
-	callback->UnitDef_isCapturable = &skirmishAiCallback_UnitDef_isCapturable;
-	callback->UnitDef_isAbleToRestore = &skirmishAiCallback_UnitDef_isAbleToRestore;
-	callback->UnitDef_isAbleToRepair = &skirmishAiCallback_UnitDef_isAbleToRepair;
-	callback->UnitDef_isAbleToSelfRepair = &skirmishAiCallback_UnitDef_isAbleToSelfRepair;
-	callback->UnitDef_isAbleToReclaim = &skirmishAiCallback_UnitDef_isAbleToReclaim;
-	callback->UnitDef_isAbleToAttack = &skirmishAiCallback_UnitDef_isAbleToAttack;
-	callback->UnitDef_isAbleToPatrol = &skirmishAiCallback_UnitDef_isAbleToPatrol;
-	callback->UnitDef_isAbleToFight = &skirmishAiCallback_UnitDef_isAbleToFight;
-	callback->UnitDef_isAbleToGuard = &skirmishAiCallback_UnitDef_isAbleToGuard;
-	callback->UnitDef_isAbleToAssist = &skirmishAiCallback_UnitDef_isAbleToAssist;
-	callback->UnitDef_isAssistable = &skirmishAiCallback_UnitDef_isAssistable;
-	callback->UnitDef_isAbleToRepeat = &skirmishAiCallback_UnitDef_isAbleToRepeat;
-	callback->UnitDef_isAbleToFireControl = &skirmishAiCallback_UnitDef_isAbleToFireControl;
-	callback->UnitDef_getFireState = &skirmishAiCallback_UnitDef_getFireState;
-	callback->UnitDef_getMoveState = &skirmishAiCallback_UnitDef_getMoveState;
-	callback->UnitDef_getWingDrag = &skirmishAiCallback_UnitDef_getWingDrag;
-	callback->UnitDef_getWingAngle = &skirmishAiCallback_UnitDef_getWingAngle;
-	callback->UnitDef_getDrag = &skirmishAiCallback_UnitDef_getDrag;
-	callback->UnitDef_getFrontToSpeed = &skirmishAiCallback_UnitDef_getFrontToSpeed;
-	callback->UnitDef_getSpeedToFront = &skirmishAiCallback_UnitDef_getSpeedToFront;
-	callback->UnitDef_getMyGravity = &skirmishAiCallback_UnitDef_getMyGravity;
-	callback->UnitDef_getMaxBank = &skirmishAiCallback_UnitDef_getMaxBank;
-	callback->UnitDef_getMaxPitch = &skirmishAiCallback_UnitDef_getMaxPitch;
-	callback->UnitDef_getTurnRadius = &skirmishAiCallback_UnitDef_getTurnRadius;
-	callback->UnitDef_getWantedHeight = &skirmishAiCallback_UnitDef_getWantedHeight;
-	callback->UnitDef_getVerticalSpeed = &skirmishAiCallback_UnitDef_getVerticalSpeed;
-	callback->UnitDef_isAbleToCrash = &skirmishAiCallback_UnitDef_isAbleToCrash;
-	callback->UnitDef_isHoverAttack = &skirmishAiCallback_UnitDef_isHoverAttack;
-	callback->UnitDef_isAirStrafe = &skirmishAiCallback_UnitDef_isAirStrafe;
-	callback->UnitDef_getDlHoverFactor = &skirmishAiCallback_UnitDef_getDlHoverFactor;
-	callback->UnitDef_getMaxAcceleration = &skirmishAiCallback_UnitDef_getMaxAcceleration;
-	callback->UnitDef_getMaxDeceleration = &skirmishAiCallback_UnitDef_getMaxDeceleration;
-	callback->UnitDef_getMaxAileron = &skirmishAiCallback_UnitDef_getMaxAileron;
-	callback->UnitDef_getMaxElevator = &skirmishAiCallback_UnitDef_getMaxElevator;
-	callback->UnitDef_getMaxRudder = &skirmishAiCallback_UnitDef_getMaxRudder;
-	callback->UnitDef_getYardMap = &skirmishAiCallback_UnitDef_getYardMap;
-	callback->UnitDef_getXSize = &skirmishAiCallback_UnitDef_getXSize;
-	callback->UnitDef_getZSize = &skirmishAiCallback_UnitDef_getZSize;
-	callback->UnitDef_getBuildAngle = &skirmishAiCallback_UnitDef_getBuildAngle;
-	callback->UnitDef_getLoadingRadius = &skirmishAiCallback_UnitDef_getLoadingRadius;
-	callback->UnitDef_getUnloadSpread = &skirmishAiCallback_UnitDef_getUnloadSpread;
-	callback->UnitDef_getTransportCapacity = &skirmishAiCallback_UnitDef_getTransportCapacity;
-	callback->UnitDef_getTransportSize = &skirmishAiCallback_UnitDef_getTransportSize;
-	callback->UnitDef_getMinTransportSize = &skirmishAiCallback_UnitDef_getMinTransportSize;
-	callback->UnitDef_isAirBase = &skirmishAiCallback_UnitDef_isAirBase;
-	callback->UnitDef_isFirePlatform = &skirmishAiCallback_UnitDef_isFirePlatform;
-	callback->UnitDef_getTransportMass = &skirmishAiCallback_UnitDef_getTransportMass;
-	callback->UnitDef_getMinTransportMass = &skirmishAiCallback_UnitDef_getMinTransportMass;
-	callback->UnitDef_isHoldSteady = &skirmishAiCallback_UnitDef_isHoldSteady;
-	callback->UnitDef_isReleaseHeld = &skirmishAiCallback_UnitDef_isReleaseHeld;
-	callback->UnitDef_isNotTransportable = &skirmishAiCallback_UnitDef_isNotTransportable;
-	callback->UnitDef_isTransportByEnemy = &skirmishAiCallback_UnitDef_isTransportByEnemy;
-	callback->UnitDef_getTransportUnloadMethod = &skirmishAiCallback_UnitDef_getTransportUnloadMethod;
-	callback->UnitDef_getFallSpeed = &skirmishAiCallback_UnitDef_getFallSpeed;
-	callback->UnitDef_getUnitFallSpeed = &skirmishAiCallback_UnitDef_getUnitFallSpeed;
-	callback->UnitDef_isAbleToCloak = &skirmishAiCallback_UnitDef_isAbleToCloak;
-	callback->UnitDef_isStartCloaked = &skirmishAiCallback_UnitDef_isStartCloaked;
-	callback->UnitDef_getCloakCost = &skirmishAiCallback_UnitDef_getCloakCost;
-	callback->UnitDef_getCloakCostMoving = &skirmishAiCallback_UnitDef_getCloakCostMoving;
-	callback->UnitDef_getDecloakDistance = &skirmishAiCallback_UnitDef_getDecloakDistance;
-	callback->UnitDef_isDecloakSpherical = &skirmishAiCallback_UnitDef_isDecloakSpherical;
-	callback->UnitDef_isDecloakOnFire = &skirmishAiCallback_UnitDef_isDecloakOnFire;
-	callback->UnitDef_isAbleToKamikaze = &skirmishAiCallback_UnitDef_isAbleToKamikaze;
-	callback->UnitDef_getKamikazeDist = &skirmishAiCallback_UnitDef_getKamikazeDist;
-	callback->UnitDef_isTargetingFacility = &skirmishAiCallback_UnitDef_isTargetingFacility;
-	callback->UnitDef_canManualFire = &skirmishAiCallback_UnitDef_canManualFire;
-	callback->UnitDef_isNeedGeo = &skirmishAiCallback_UnitDef_isNeedGeo;
-	callback->UnitDef_isFeature = &skirmishAiCallback_UnitDef_isFeature;
-	callback->UnitDef_isHideDamage = &skirmishAiCallback_UnitDef_isHideDamage;
-	callback->UnitDef_isCommander = &skirmishAiCallback_UnitDef_isCommander;
-	callback->UnitDef_isShowPlayerName = &skirmishAiCallback_UnitDef_isShowPlayerName;
-	callback->UnitDef_isAbleToResurrect = &skirmishAiCallback_UnitDef_isAbleToResurrect;
-	callback->UnitDef_isAbleToCapture = &skirmishAiCallback_UnitDef_isAbleToCapture;
-	callback->UnitDef_getHighTrajectoryType = &skirmishAiCallback_UnitDef_getHighTrajectoryType;
-	callback->UnitDef_getNoChaseCategory = &skirmishAiCallback_UnitDef_getNoChaseCategory;
-	callback->UnitDef_isLeaveTracks = &skirmishAiCallback_UnitDef_isLeaveTracks;
-	callback->UnitDef_getTrackWidth = &skirmishAiCallback_UnitDef_getTrackWidth;
-	callback->UnitDef_getTrackOffset = &skirmishAiCallback_UnitDef_getTrackOffset;
-	callback->UnitDef_getTrackStrength = &skirmishAiCallback_UnitDef_getTrackStrength;
-	callback->UnitDef_getTrackStretch = &skirmishAiCallback_UnitDef_getTrackStretch;
-	callback->UnitDef_getTrackType = &skirmishAiCallback_UnitDef_getTrackType;
-	callback->UnitDef_isAbleToDropFlare = &skirmishAiCallback_UnitDef_isAbleToDropFlare;
-	callback->UnitDef_getFlareReloadTime = &skirmishAiCallback_UnitDef_getFlareReloadTime;
-	callback->UnitDef_getFlareEfficiency = &skirmishAiCallback_UnitDef_getFlareEfficiency;
-	callback->UnitDef_getFlareDelay = &skirmishAiCallback_UnitDef_getFlareDelay;
-	callback->UnitDef_getFlareDropVector = &skirmishAiCallback_UnitDef_getFlareDropVector;
-	callback->UnitDef_getFlareTime = &skirmishAiCallback_UnitDef_getFlareTime;
-	callback->UnitDef_getFlareSalvoSize = &skirmishAiCallback_UnitDef_getFlareSalvoSize;
-	callback->UnitDef_getFlareSalvoDelay = &skirmishAiCallback_UnitDef_getFlareSalvoDelay;
-	callback->UnitDef_isAbleToLoopbackAttack = &skirmishAiCallback_UnitDef_isAbleToLoopbackAttack;
-	callback->UnitDef_isLevelGround = &skirmishAiCallback_UnitDef_isLevelGround;
-	callback->UnitDef_isUseBuildingGroundDecal = &skirmishAiCallback_UnitDef_isUseBuildingGroundDecal;
-	callback->UnitDef_getBuildingDecalType = &skirmishAiCallback_UnitDef_getBuildingDecalType;
-	callback->UnitDef_getBuildingDecalSizeX = &skirmishAiCallback_UnitDef_getBuildingDecalSizeX;
-	callback->UnitDef_getBuildingDecalSizeY = &skirmishAiCallback_UnitDef_getBuildingDecalSizeY;
-	callback->UnitDef_getBuildingDecalDecaySpeed = &skirmishAiCallback_UnitDef_getBuildingDecalDecaySpeed;
-	callback->UnitDef_getMaxFuel = &skirmishAiCallback_UnitDef_getMaxFuel;
-	callback->UnitDef_getRefuelTime = &skirmishAiCallback_UnitDef_getRefuelTime;
-	callback->UnitDef_getMinAirBasePower = &skirmishAiCallback_UnitDef_getMinAirBasePower;
-	callback->UnitDef_getMaxThisUnit = &skirmishAiCallback_UnitDef_getMaxThisUnit;
-	callback->UnitDef_getDecoyDef = &skirmishAiCallback_UnitDef_getDecoyDef;
-	callback->UnitDef_isDontLand = &skirmishAiCallback_UnitDef_isDontLand;
-	callback->UnitDef_getShieldDef = &skirmishAiCallback_UnitDef_getShieldDef;
-	callback->UnitDef_getStockpileDef = &skirmishAiCallback_UnitDef_getStockpileDef;
-	callback->UnitDef_getBuildOptions = &skirmishAiCallback_UnitDef_getBuildOptions;
-	callback->UnitDef_getCustomParams = &skirmishAiCallback_UnitDef_getCustomParams;
-	callback->UnitDef_isMoveDataAvailable = &skirmishAiCallback_UnitDef_isMoveDataAvailable;
-	callback->UnitDef_MoveData_getMaxAcceleration = &skirmishAiCallback_UnitDef_MoveData_getMaxAcceleration;
-	callback->UnitDef_MoveData_getMaxBreaking = &skirmishAiCallback_UnitDef_MoveData_getMaxBreaking;
-	callback->UnitDef_MoveData_getMaxSpeed = &skirmishAiCallback_UnitDef_MoveData_getMaxSpeed;
-	callback->UnitDef_MoveData_getMaxTurnRate = &skirmishAiCallback_UnitDef_MoveData_getMaxTurnRate;
-	callback->UnitDef_MoveData_getXSize = &skirmishAiCallback_UnitDef_MoveData_getXSize;
-	callback->UnitDef_MoveData_getZSize = &skirmishAiCallback_UnitDef_MoveData_getZSize;
-	callback->UnitDef_MoveData_getDepth = &skirmishAiCallback_UnitDef_MoveData_getDepth;
-	callback->UnitDef_MoveData_getMaxSlope = &skirmishAiCallback_UnitDef_MoveData_getMaxSlope;
-	callback->UnitDef_MoveData_getSlopeMod = &skirmishAiCallback_UnitDef_MoveData_getSlopeMod;
-	callback->UnitDef_MoveData_getDepthMod = &skirmishAiCallback_UnitDef_MoveData_getDepthMod;
-	callback->UnitDef_MoveData_getPathType = &skirmishAiCallback_UnitDef_MoveData_getPathType;
-	callback->UnitDef_MoveData_getCrushStrength = &skirmishAiCallback_UnitDef_MoveData_getCrushStrength;
-	callback->UnitDef_MoveData_getMoveType = &skirmishAiCallback_UnitDef_MoveData_getMoveType;
-	callback->UnitDef_MoveData_getSpeedModClass = &skirmishAiCallback_UnitDef_MoveData_getSpeedModClass;
-	callback->UnitDef_MoveData_getTerrainClass = &skirmishAiCallback_UnitDef_MoveData_getTerrainClass;
-	callback->UnitDef_MoveData_getFollowGround = &skirmishAiCallback_UnitDef_MoveData_getFollowGround;
-	callback->UnitDef_MoveData_isSubMarine = &skirmishAiCallback_UnitDef_MoveData_isSubMarine;
-	callback->UnitDef_MoveData_getName = &skirmishAiCallback_UnitDef_MoveData_getName;
-	callback->UnitDef_getWeaponMounts = &skirmishAiCallback_UnitDef_getWeaponMounts;
-	callback->UnitDef_WeaponMount_getName = &skirmishAiCallback_UnitDef_WeaponMount_getName;
-	callback->UnitDef_WeaponMount_getWeaponDef = &skirmishAiCallback_UnitDef_WeaponMount_getWeaponDef;
-	callback->UnitDef_WeaponMount_getSlavedTo = &skirmishAiCallback_UnitDef_WeaponMount_getSlavedTo;
-	callback->UnitDef_WeaponMount_getMainDir = &skirmishAiCallback_UnitDef_WeaponMount_getMainDir;
-	callback->UnitDef_WeaponMount_getMaxAngleDif = &skirmishAiCallback_UnitDef_WeaponMount_getMaxAngleDif;
-	callback->UnitDef_WeaponMount_getFuelUsage = &skirmishAiCallback_UnitDef_WeaponMount_getFuelUsage;
-	callback->UnitDef_WeaponMount_getBadTargetCategory = &skirmishAiCallback_UnitDef_WeaponMount_getBadTargetCategory;
-	callback->UnitDef_WeaponMount_getOnlyTargetCategory = &skirmishAiCallback_UnitDef_WeaponMount_getOnlyTargetCategory;
-	callback->Unit_getLimit = &skirmishAiCallback_Unit_getLimit;
-	callback->Unit_getMax = &skirmishAiCallback_Unit_getMax;
-	callback->getEnemyUnits = &skirmishAiCallback_getEnemyUnits;
-	callback->getEnemyUnitsIn = &skirmishAiCallback_getEnemyUnitsIn;
-	callback->getEnemyUnitsInRadarAndLos = &skirmishAiCallback_getEnemyUnitsInRadarAndLos;
-	callback->getFriendlyUnits = &skirmishAiCallback_getFriendlyUnits;
-	callback->getFriendlyUnitsIn = &skirmishAiCallback_getFriendlyUnitsIn;
-	callback->getNeutralUnits = &skirmishAiCallback_getNeutralUnits;
-	callback->getNeutralUnitsIn = &skirmishAiCallback_getNeutralUnitsIn;
-	callback->getTeamUnits = &skirmishAiCallback_getTeamUnits;
-	callback->getSelectedUnits = &skirmishAiCallback_getSelectedUnits;
-	callback->Unit_getDef = &skirmishAiCallback_Unit_getDef;
-	callback->Unit_getModParams = &skirmishAiCallback_Unit_getModParams;
-	callback->Unit_ModParam_getName = &skirmishAiCallback_Unit_ModParam_getName;
-	callback->Unit_ModParam_getValue = &skirmishAiCallback_Unit_ModParam_getValue;
-	callback->Unit_getTeam = &skirmishAiCallback_Unit_getTeam;
-	callback->Unit_getAllyTeam = &skirmishAiCallback_Unit_getAllyTeam;
-	callback->Unit_getAiHint = &skirmishAiCallback_Unit_getAiHint;
-	callback->Unit_getStockpile = &skirmishAiCallback_Unit_getStockpile;
-	callback->Unit_getStockpileQueued = &skirmishAiCallback_Unit_getStockpileQueued;
-	callback->Unit_getCurrentFuel = &skirmishAiCallback_Unit_getCurrentFuel;
-	callback->Unit_getMaxSpeed = &skirmishAiCallback_Unit_getMaxSpeed;
-	callback->Unit_getMaxRange = &skirmishAiCallback_Unit_getMaxRange;
-	callback->Unit_getMaxHealth = &skirmishAiCallback_Unit_getMaxHealth;
-	callback->Unit_getExperience = &skirmishAiCallback_Unit_getExperience;
-	callback->Unit_getGroup = &skirmishAiCallback_Unit_getGroup;
-	callback->Unit_getCurrentCommands = &skirmishAiCallback_Unit_getCurrentCommands;
-	callback->Unit_CurrentCommand_getType = &skirmishAiCallback_Unit_CurrentCommand_getType;
-	callback->Unit_CurrentCommand_getId = &skirmishAiCallback_Unit_CurrentCommand_getId;
-	callback->Unit_CurrentCommand_getOptions = &skirmishAiCallback_Unit_CurrentCommand_getOptions;
-	callback->Unit_CurrentCommand_getTag = &skirmishAiCallback_Unit_CurrentCommand_getTag;
-	callback->Unit_CurrentCommand_getTimeOut = &skirmishAiCallback_Unit_CurrentCommand_getTimeOut;
-	callback->Unit_CurrentCommand_getParams = &skirmishAiCallback_Unit_CurrentCommand_getParams;
-	callback->Unit_getSupportedCommands = &skirmishAiCallback_Unit_getSupportedCommands;
-	callback->Unit_SupportedCommand_getId = &skirmishAiCallback_Unit_SupportedCommand_getId;
-	callback->Unit_SupportedCommand_getName = &skirmishAiCallback_Unit_SupportedCommand_getName;
-	callback->Unit_SupportedCommand_getToolTip = &skirmishAiCallback_Unit_SupportedCommand_getToolTip;
-	callback->Unit_SupportedCommand_isShowUnique = &skirmishAiCallback_Unit_SupportedCommand_isShowUnique;
-	callback->Unit_SupportedCommand_isDisabled = &skirmishAiCallback_Unit_SupportedCommand_isDisabled;
-	callback->Unit_SupportedCommand_getParams = &skirmishAiCallback_Unit_SupportedCommand_getParams;
-	callback->Unit_getHealth = &skirmishAiCallback_Unit_getHealth;
-	callback->Unit_getSpeed = &skirmishAiCallback_Unit_getSpeed;
-	callback->Unit_getPower = &skirmishAiCallback_Unit_getPower;
-	callback->Unit_getResourceUse = &skirmishAiCallback_Unit_getResourceUse;
-	callback->Unit_getResourceMake = &skirmishAiCallback_Unit_getResourceMake;
-	callback->Unit_getPos = &skirmishAiCallback_Unit_getPos;
-	callback->Unit_getVel = &skirmishAiCallback_Unit_getVel;
-	callback->Unit_isActivated = &skirmishAiCallback_Unit_isActivated;
-	callback->Unit_isBeingBuilt = &skirmishAiCallback_Unit_isBeingBuilt;
-	callback->Unit_isCloaked = &skirmishAiCallback_Unit_isCloaked;
-	callback->Unit_isParalyzed = &skirmishAiCallback_Unit_isParalyzed;
-	callback->Unit_isNeutral = &skirmishAiCallback_Unit_isNeutral;
-	callback->Unit_getBuildingFacing = &skirmishAiCallback_Unit_getBuildingFacing;
-	callback->Unit_getLastUserOrderFrame = &skirmishAiCallback_Unit_getLastUserOrderFrame;
-	callback->getGroups = &skirmishAiCallback_getGroups;
-	callback->Group_getSupportedCommands = &skirmishAiCallback_Group_getSupportedCommands;
-	callback->Group_SupportedCommand_getId = &skirmishAiCallback_Group_SupportedCommand_getId;
-	callback->Group_SupportedCommand_getName = &skirmishAiCallback_Group_SupportedCommand_getName;
-	callback->Group_SupportedCommand_getToolTip = &skirmishAiCallback_Group_SupportedCommand_getToolTip;
-	callback->Group_SupportedCommand_isShowUnique = &skirmishAiCallback_Group_SupportedCommand_isShowUnique;
-	callback->Group_SupportedCommand_isDisabled = &skirmishAiCallback_Group_SupportedCommand_isDisabled;
-	callback->Group_SupportedCommand_getParams = &skirmishAiCallback_Group_SupportedCommand_getParams;
-	callback->Group_OrderPreview_getId = &skirmishAiCallback_Group_OrderPreview_getId;
-	callback->Group_OrderPreview_getOptions = &skirmishAiCallback_Group_OrderPreview_getOptions;
-	callback->Group_OrderPreview_getTag = &skirmishAiCallback_Group_OrderPreview_getTag;
-	callback->Group_OrderPreview_getTimeOut = &skirmishAiCallback_Group_OrderPreview_getTimeOut;
-	callback->Group_OrderPreview_getParams = &skirmishAiCallback_Group_OrderPreview_getParams;
-	callback->Group_isSelected = &skirmishAiCallback_Group_isSelected;
-	callback->Mod_getFileName = &skirmishAiCallback_Mod_getFileName;
-	callback->Mod_getHash = &skirmishAiCallback_Mod_getHash;
-	callback->Mod_getHumanName = &skirmishAiCallback_Mod_getHumanName;
-	callback->Mod_getShortName = &skirmishAiCallback_Mod_getShortName;
-	callback->Mod_getVersion = &skirmishAiCallback_Mod_getVersion;
-	callback->Mod_getMutator = &skirmishAiCallback_Mod_getMutator;
-	callback->Mod_getDescription = &skirmishAiCallback_Mod_getDescription;
-	callback->Mod_getAllowTeamColors = &skirmishAiCallback_Mod_getAllowTeamColors;
-	callback->Mod_getConstructionDecay = &skirmishAiCallback_Mod_getConstructionDecay;
-	callback->Mod_getConstructionDecayTime = &skirmishAiCallback_Mod_getConstructionDecayTime;
-	callback->Mod_getConstructionDecaySpeed = &skirmishAiCallback_Mod_getConstructionDecaySpeed;
-	callback->Mod_getMultiReclaim = &skirmishAiCallback_Mod_getMultiReclaim;
-	callback->Mod_getReclaimMethod = &skirmishAiCallback_Mod_getReclaimMethod;
-	callback->Mod_getReclaimUnitMethod = &skirmishAiCallback_Mod_getReclaimUnitMethod;
-	callback->Mod_getReclaimUnitEnergyCostFactor = &skirmishAiCallback_Mod_getReclaimUnitEnergyCostFactor;
-	callback->Mod_getReclaimUnitEfficiency = &skirmishAiCallback_Mod_getReclaimUnitEfficiency;
-	callback->Mod_getReclaimFeatureEnergyCostFactor = &skirmishAiCallback_Mod_getReclaimFeatureEnergyCostFactor;
-	callback->Mod_getReclaimAllowEnemies = &skirmishAiCallback_Mod_getReclaimAllowEnemies;
-	callback->Mod_getReclaimAllowAllies = &skirmishAiCallback_Mod_getReclaimAllowAllies;
-	callback->Mod_getRepairEnergyCostFactor = &skirmishAiCallback_Mod_getRepairEnergyCostFactor;
-	callback->Mod_getResurrectEnergyCostFactor = &skirmishAiCallback_Mod_getResurrectEnergyCostFactor;
-	callback->Mod_getCaptureEnergyCostFactor = &skirmishAiCallback_Mod_getCaptureEnergyCostFactor;
-	callback->Mod_getTransportGround = &skirmishAiCallback_Mod_getTransportGround;
-	callback->Mod_getTransportHover = &skirmishAiCallback_Mod_getTransportHover;
-	callback->Mod_getTransportShip = &skirmishAiCallback_Mod_getTransportShip;
-	callback->Mod_getTransportAir = &skirmishAiCallback_Mod_getTransportAir;
-	callback->Mod_getFireAtKilled = &skirmishAiCallback_Mod_getFireAtKilled;
-	callback->Mod_getFireAtCrashing = &skirmishAiCallback_Mod_getFireAtCrashing;
-	callback->Mod_getFlankingBonusModeDefault = &skirmishAiCallback_Mod_getFlankingBonusModeDefault;
-	callback->Mod_getLosMipLevel = &skirmishAiCallback_Mod_getLosMipLevel;
-	callback->Mod_getAirMipLevel = &skirmishAiCallback_Mod_getAirMipLevel;
-	callback->Mod_getLosMul = &skirmishAiCallback_Mod_getLosMul;
-	callback->Mod_getAirLosMul = &skirmishAiCallback_Mod_getAirLosMul;
-	callback->Mod_getRequireSonarUnderWater = &skirmishAiCallback_Mod_getRequireSonarUnderWater;
-	callback->Map_getChecksum = &skirmishAiCallback_Map_getChecksum;
-	callback->Map_getStartPos = &skirmishAiCallback_Map_getStartPos;
-	callback->Map_getMousePos = &skirmishAiCallback_Map_getMousePos;
-	callback->Map_isPosInCamera = &skirmishAiCallback_Map_isPosInCamera;
-	callback->Map_getWidth = &skirmishAiCallback_Map_getWidth;
-	callback->Map_getHeight = &skirmishAiCallback_Map_getHeight;
-	callback->Map_getHeightMap = &skirmishAiCallback_Map_getHeightMap;
-	callback->Map_getCornersHeightMap = &skirmishAiCallback_Map_getCornersHeightMap;
-	callback->Map_getMinHeight = &skirmishAiCallback_Map_getMinHeight;
-	callback->Map_getMaxHeight = &skirmishAiCallback_Map_getMaxHeight;
-	callback->Map_getSlopeMap = &skirmishAiCallback_Map_getSlopeMap;
-	callback->Map_getLosMap = &skirmishAiCallback_Map_getLosMap;
-	callback->Map_getRadarMap = &skirmishAiCallback_Map_getRadarMap;
-	callback->Map_getJammerMap = &skirmishAiCallback_Map_getJammerMap;
-	callback->Map_getResourceMapRaw = &skirmishAiCallback_Map_getResourceMapRaw;
-	callback->Map_getResourceMapSpotsPositions = &skirmishAiCallback_Map_getResourceMapSpotsPositions;
-	callback->Map_getResourceMapSpotsAverageIncome = &skirmishAiCallback_Map_getResourceMapSpotsAverageIncome;
-	callback->Map_getResourceMapSpotsNearest = &skirmishAiCallback_Map_getResourceMapSpotsNearest;
-	callback->Map_getHash = &skirmishAiCallback_Map_getHash;
-	callback->Map_getName = &skirmishAiCallback_Map_getName;
-	callback->Map_getHumanName = &skirmishAiCallback_Map_getHumanName;
-	callback->Map_getElevationAt = &skirmishAiCallback_Map_getElevationAt;
-	callback->Map_getMaxResource = &skirmishAiCallback_Map_getMaxResource;
-	callback->Map_getExtractorRadius = &skirmishAiCallback_Map_getExtractorRadius;
-	callback->Map_getMinWind = &skirmishAiCallback_Map_getMinWind;
-	callback->Map_getMaxWind = &skirmishAiCallback_Map_getMaxWind;
-	callback->Map_getCurWind = &skirmishAiCallback_Map_getCurWind;
-	callback->Map_getTidalStrength = &skirmishAiCallback_Map_getTidalStrength;
-	callback->Map_getGravity = &skirmishAiCallback_Map_getGravity;
-	callback->Map_getPoints = &skirmishAiCallback_Map_getPoints;
-	callback->Map_Point_getPosition = &skirmishAiCallback_Map_Point_getPosition;
-	callback->Map_Point_getColor = &skirmishAiCallback_Map_Point_getColor;
-	callback->Map_Point_getLabel = &skirmishAiCallback_Map_Point_getLabel;
-	callback->Map_getLines = &skirmishAiCallback_Map_getLines;
-	callback->Map_Line_getFirstPosition = &skirmishAiCallback_Map_Line_getFirstPosition;
-	callback->Map_Line_getSecondPosition = &skirmishAiCallback_Map_Line_getSecondPosition;
-	callback->Map_Line_getColor = &skirmishAiCallback_Map_Line_getColor;
-	callback->Map_isPossibleToBuildAt = &skirmishAiCallback_Map_isPossibleToBuildAt;
-	callback->Map_findClosestBuildSite = &skirmishAiCallback_Map_findClosestBuildSite;
-	callback->getFeatureDefs = &skirmishAiCallback_getFeatureDefs;
-	callback->FeatureDef_getName = &skirmishAiCallback_FeatureDef_getName;
-	callback->FeatureDef_getDescription = &skirmishAiCallback_FeatureDef_getDescription;
-	callback->FeatureDef_getFileName = &skirmishAiCallback_FeatureDef_getFileName;
-	callback->FeatureDef_getContainedResource = &skirmishAiCallback_FeatureDef_getContainedResource;
-	callback->FeatureDef_getMaxHealth = &skirmishAiCallback_FeatureDef_getMaxHealth;
-	callback->FeatureDef_getReclaimTime = &skirmishAiCallback_FeatureDef_getReclaimTime;
-	callback->FeatureDef_getMass = &skirmishAiCallback_FeatureDef_getMass;
-	callback->FeatureDef_isUpright = &skirmishAiCallback_FeatureDef_isUpright;
-	callback->FeatureDef_getDrawType = &skirmishAiCallback_FeatureDef_getDrawType;
-	callback->FeatureDef_getModelName = &skirmishAiCallback_FeatureDef_getModelName;
-	callback->FeatureDef_getResurrectable = &skirmishAiCallback_FeatureDef_getResurrectable;
-	callback->FeatureDef_getSmokeTime = &skirmishAiCallback_FeatureDef_getSmokeTime;
-	callback->FeatureDef_isDestructable = &skirmishAiCallback_FeatureDef_isDestructable;
-	callback->FeatureDef_isReclaimable = &skirmishAiCallback_FeatureDef_isReclaimable;
-	callback->FeatureDef_isBlocking = &skirmishAiCallback_FeatureDef_isBlocking;
-	callback->FeatureDef_isBurnable = &skirmishAiCallback_FeatureDef_isBurnable;
-	callback->FeatureDef_isFloating = &skirmishAiCallback_FeatureDef_isFloating;
-	callback->FeatureDef_isNoSelect = &skirmishAiCallback_FeatureDef_isNoSelect;
-	callback->FeatureDef_isGeoThermal = &skirmishAiCallback_FeatureDef_isGeoThermal;
-	callback->FeatureDef_getDeathFeature = &skirmishAiCallback_FeatureDef_getDeathFeature;
-	callback->FeatureDef_getXSize = &skirmishAiCallback_FeatureDef_getXSize;
-	callback->FeatureDef_getZSize = &skirmishAiCallback_FeatureDef_getZSize;
-	callback->FeatureDef_getCustomParams = &skirmishAiCallback_FeatureDef_getCustomParams;
-	callback->getFeatures = &skirmishAiCallback_getFeatures;
-	callback->getFeaturesIn = &skirmishAiCallback_getFeaturesIn;
-	callback->Feature_getDef = &skirmishAiCallback_Feature_getDef;
-	callback->Feature_getHealth = &skirmishAiCallback_Feature_getHealth;
-	callback->Feature_getReclaimLeft = &skirmishAiCallback_Feature_getReclaimLeft;
-	callback->Feature_getPosition = &skirmishAiCallback_Feature_getPosition;
-	callback->getWeaponDefs = &skirmishAiCallback_getWeaponDefs;
-	callback->getWeaponDefByName = &skirmishAiCallback_getWeaponDefByName;
-	callback->WeaponDef_getName = &skirmishAiCallback_WeaponDef_getName;
-	callback->WeaponDef_getType = &skirmishAiCallback_WeaponDef_getType;
-	callback->WeaponDef_getDescription = &skirmishAiCallback_WeaponDef_getDescription;
-	callback->WeaponDef_getFileName = &skirmishAiCallback_WeaponDef_getFileName;
-	callback->WeaponDef_getCegTag = &skirmishAiCallback_WeaponDef_getCegTag;
-	callback->WeaponDef_getRange = &skirmishAiCallback_WeaponDef_getRange;
-	callback->WeaponDef_getHeightMod = &skirmishAiCallback_WeaponDef_getHeightMod;
-	callback->WeaponDef_getAccuracy = &skirmishAiCallback_WeaponDef_getAccuracy;
-	callback->WeaponDef_getSprayAngle = &skirmishAiCallback_WeaponDef_getSprayAngle;
-	callback->WeaponDef_getMovingAccuracy = &skirmishAiCallback_WeaponDef_getMovingAccuracy;
-	callback->WeaponDef_getTargetMoveError = &skirmishAiCallback_WeaponDef_getTargetMoveError;
-	callback->WeaponDef_getLeadLimit = &skirmishAiCallback_WeaponDef_getLeadLimit;
-	callback->WeaponDef_getLeadBonus = &skirmishAiCallback_WeaponDef_getLeadBonus;
-	callback->WeaponDef_getPredictBoost = &skirmishAiCallback_WeaponDef_getPredictBoost;
-	callback->WeaponDef_getNumDamageTypes = &skirmishAiCallback_WeaponDef_getNumDamageTypes;
-	callback->WeaponDef_Damage_getParalyzeDamageTime = &skirmishAiCallback_WeaponDef_Damage_getParalyzeDamageTime;
-	callback->WeaponDef_Damage_getImpulseFactor = &skirmishAiCallback_WeaponDef_Damage_getImpulseFactor;
-	callback->WeaponDef_Damage_getImpulseBoost = &skirmishAiCallback_WeaponDef_Damage_getImpulseBoost;
-	callback->WeaponDef_Damage_getCraterMult = &skirmishAiCallback_WeaponDef_Damage_getCraterMult;
-	callback->WeaponDef_Damage_getCraterBoost = &skirmishAiCallback_WeaponDef_Damage_getCraterBoost;
-	callback->WeaponDef_Damage_getTypes = &skirmishAiCallback_WeaponDef_Damage_getTypes;
-	callback->WeaponDef_getAreaOfEffect = &skirmishAiCallback_WeaponDef_getAreaOfEffect;
-	callback->WeaponDef_isNoSelfDamage = &skirmishAiCallback_WeaponDef_isNoSelfDamage;
-	callback->WeaponDef_getFireStarter = &skirmishAiCallback_WeaponDef_getFireStarter;
-	callback->WeaponDef_getEdgeEffectiveness = &skirmishAiCallback_WeaponDef_getEdgeEffectiveness;
-	callback->WeaponDef_getSize = &skirmishAiCallback_WeaponDef_getSize;
-	callback->WeaponDef_getSizeGrowth = &skirmishAiCallback_WeaponDef_getSizeGrowth;
-	callback->WeaponDef_getCollisionSize = &skirmishAiCallback_WeaponDef_getCollisionSize;
-	callback->WeaponDef_getSalvoSize = &skirmishAiCallback_WeaponDef_getSalvoSize;
-	callback->WeaponDef_getSalvoDelay = &skirmishAiCallback_WeaponDef_getSalvoDelay;
-	callback->WeaponDef_getReload = &skirmishAiCallback_WeaponDef_getReload;
-	callback->WeaponDef_getBeamTime = &skirmishAiCallback_WeaponDef_getBeamTime;
-	callback->WeaponDef_isBeamBurst = &skirmishAiCallback_WeaponDef_isBeamBurst;
-	callback->WeaponDef_isWaterBounce = &skirmishAiCallback_WeaponDef_isWaterBounce;
-	callback->WeaponDef_isGroundBounce = &skirmishAiCallback_WeaponDef_isGroundBounce;
-	callback->WeaponDef_getBounceRebound = &skirmishAiCallback_WeaponDef_getBounceRebound;
-	callback->WeaponDef_getBounceSlip = &skirmishAiCallback_WeaponDef_getBounceSlip;
-	callback->WeaponDef_getNumBounce = &skirmishAiCallback_WeaponDef_getNumBounce;
-	callback->WeaponDef_getMaxAngle = &skirmishAiCallback_WeaponDef_getMaxAngle;
-	callback->WeaponDef_getUpTime = &skirmishAiCallback_WeaponDef_getUpTime;
-	callback->WeaponDef_getFlightTime = &skirmishAiCallback_WeaponDef_getFlightTime;
-	callback->WeaponDef_getCost = &skirmishAiCallback_WeaponDef_getCost;
-	callback->WeaponDef_getProjectilesPerShot = &skirmishAiCallback_WeaponDef_getProjectilesPerShot;
-	callback->WeaponDef_isTurret = &skirmishAiCallback_WeaponDef_isTurret;
-	callback->WeaponDef_isOnlyForward = &skirmishAiCallback_WeaponDef_isOnlyForward;
-	callback->WeaponDef_isFixedLauncher = &skirmishAiCallback_WeaponDef_isFixedLauncher;
-	callback->WeaponDef_isWaterWeapon = &skirmishAiCallback_WeaponDef_isWaterWeapon;
-	callback->WeaponDef_isFireSubmersed = &skirmishAiCallback_WeaponDef_isFireSubmersed;
-	callback->WeaponDef_isSubMissile = &skirmishAiCallback_WeaponDef_isSubMissile;
-	callback->WeaponDef_isTracks = &skirmishAiCallback_WeaponDef_isTracks;
-	callback->WeaponDef_isDropped = &skirmishAiCallback_WeaponDef_isDropped;
-	callback->WeaponDef_isParalyzer = &skirmishAiCallback_WeaponDef_isParalyzer;
-	callback->WeaponDef_isImpactOnly = &skirmishAiCallback_WeaponDef_isImpactOnly;
-	callback->WeaponDef_isNoAutoTarget = &skirmishAiCallback_WeaponDef_isNoAutoTarget;
-	callback->WeaponDef_isManualFire = &skirmishAiCallback_WeaponDef_isManualFire;
-	callback->WeaponDef_getInterceptor = &skirmishAiCallback_WeaponDef_getInterceptor;
-	callback->WeaponDef_getTargetable = &skirmishAiCallback_WeaponDef_getTargetable;
-	callback->WeaponDef_isStockpileable = &skirmishAiCallback_WeaponDef_isStockpileable;
-	callback->WeaponDef_getCoverageRange = &skirmishAiCallback_WeaponDef_getCoverageRange;
-	callback->WeaponDef_getStockpileTime = &skirmishAiCallback_WeaponDef_getStockpileTime;
-	callback->WeaponDef_getIntensity = &skirmishAiCallback_WeaponDef_getIntensity;
-	callback->WeaponDef_getThickness = &skirmishAiCallback_WeaponDef_getThickness;
-	callback->WeaponDef_getLaserFlareSize = &skirmishAiCallback_WeaponDef_getLaserFlareSize;
-	callback->WeaponDef_getCoreThickness = &skirmishAiCallback_WeaponDef_getCoreThickness;
-	callback->WeaponDef_getDuration = &skirmishAiCallback_WeaponDef_getDuration;
-	callback->WeaponDef_getLodDistance = &skirmishAiCallback_WeaponDef_getLodDistance;
-	callback->WeaponDef_getFalloffRate = &skirmishAiCallback_WeaponDef_getFalloffRate;
-	callback->WeaponDef_getGraphicsType = &skirmishAiCallback_WeaponDef_getGraphicsType;
-	callback->WeaponDef_isSoundTrigger = &skirmishAiCallback_WeaponDef_isSoundTrigger;
-	callback->WeaponDef_isSelfExplode = &skirmishAiCallback_WeaponDef_isSelfExplode;
-	callback->WeaponDef_isGravityAffected = &skirmishAiCallback_WeaponDef_isGravityAffected;
-	callback->WeaponDef_getHighTrajectory = &skirmishAiCallback_WeaponDef_getHighTrajectory;
-	callback->WeaponDef_getMyGravity = &skirmishAiCallback_WeaponDef_getMyGravity;
-	callback->WeaponDef_isNoExplode = &skirmishAiCallback_WeaponDef_isNoExplode;
-	callback->WeaponDef_getStartVelocity = &skirmishAiCallback_WeaponDef_getStartVelocity;
-	callback->WeaponDef_getWeaponAcceleration = &skirmishAiCallback_WeaponDef_getWeaponAcceleration;
-	callback->WeaponDef_getTurnRate = &skirmishAiCallback_WeaponDef_getTurnRate;
-	callback->WeaponDef_getMaxVelocity = &skirmishAiCallback_WeaponDef_getMaxVelocity;
-	callback->WeaponDef_getProjectileSpeed = &skirmishAiCallback_WeaponDef_getProjectileSpeed;
-	callback->WeaponDef_getExplosionSpeed = &skirmishAiCallback_WeaponDef_getExplosionSpeed;
-	callback->WeaponDef_getOnlyTargetCategory = &skirmishAiCallback_WeaponDef_getOnlyTargetCategory;
-	callback->WeaponDef_getWobble = &skirmishAiCallback_WeaponDef_getWobble;
-	callback->WeaponDef_getDance = &skirmishAiCallback_WeaponDef_getDance;
-	callback->WeaponDef_getTrajectoryHeight = &skirmishAiCallback_WeaponDef_getTrajectoryHeight;
-	callback->WeaponDef_isLargeBeamLaser = &skirmishAiCallback_WeaponDef_isLargeBeamLaser;
-	callback->WeaponDef_isShield = &skirmishAiCallback_WeaponDef_isShield;
-	callback->WeaponDef_isShieldRepulser = &skirmishAiCallback_WeaponDef_isShieldRepulser;
-	callback->WeaponDef_isSmartShield = &skirmishAiCallback_WeaponDef_isSmartShield;
-	callback->WeaponDef_isExteriorShield = &skirmishAiCallback_WeaponDef_isExteriorShield;
-	callback->WeaponDef_isVisibleShield = &skirmishAiCallback_WeaponDef_isVisibleShield;
-	callback->WeaponDef_isVisibleShieldRepulse = &skirmishAiCallback_WeaponDef_isVisibleShieldRepulse;
-	callback->WeaponDef_getVisibleShieldHitFrames = &skirmishAiCallback_WeaponDef_getVisibleShieldHitFrames;
-	callback->WeaponDef_Shield_getResourceUse = &skirmishAiCallback_WeaponDef_Shield_getResourceUse;
-	callback->WeaponDef_Shield_getRadius = &skirmishAiCallback_WeaponDef_Shield_getRadius;
-	callback->WeaponDef_Shield_getForce = &skirmishAiCallback_WeaponDef_Shield_getForce;
-	callback->WeaponDef_Shield_getMaxSpeed = &skirmishAiCallback_WeaponDef_Shield_getMaxSpeed;
-	callback->WeaponDef_Shield_getPower = &skirmishAiCallback_WeaponDef_Shield_getPower;
-	callback->WeaponDef_Shield_getPowerRegen = &skirmishAiCallback_WeaponDef_Shield_getPowerRegen;
-	callback->WeaponDef_Shield_getPowerRegenResource = &skirmishAiCallback_WeaponDef_Shield_getPowerRegenResource;
-	callback->WeaponDef_Shield_getStartingPower = &skirmishAiCallback_WeaponDef_Shield_getStartingPower;
-	callback->WeaponDef_Shield_getRechargeDelay = &skirmishAiCallback_WeaponDef_Shield_getRechargeDelay;
-	callback->WeaponDef_Shield_getGoodColor = &skirmishAiCallback_WeaponDef_Shield_getGoodColor;
-	callback->WeaponDef_Shield_getBadColor = &skirmishAiCallback_WeaponDef_Shield_getBadColor;
-	callback->WeaponDef_Shield_getAlpha = &skirmishAiCallback_WeaponDef_Shield_getAlpha;
-	callback->WeaponDef_Shield_getInterceptType = &skirmishAiCallback_WeaponDef_Shield_getInterceptType;
-	callback->WeaponDef_getInterceptedByShieldType = &skirmishAiCallback_WeaponDef_getInterceptedByShieldType;
-	callback->WeaponDef_isAvoidFriendly = &skirmishAiCallback_WeaponDef_isAvoidFriendly;
-	callback->WeaponDef_isAvoidFeature = &skirmishAiCallback_WeaponDef_isAvoidFeature;
-	callback->WeaponDef_isAvoidNeutral = &skirmishAiCallback_WeaponDef_isAvoidNeutral;
-	callback->WeaponDef_getTargetBorder = &skirmishAiCallback_WeaponDef_getTargetBorder;
-	callback->WeaponDef_getCylinderTargetting = &skirmishAiCallback_WeaponDef_getCylinderTargetting;
-	callback->WeaponDef_getMinIntensity = &skirmishAiCallback_WeaponDef_getMinIntensity;
-	callback->WeaponDef_getHeightBoostFactor = &skirmishAiCallback_WeaponDef_getHeightBoostFactor;
-	callback->WeaponDef_getProximityPriority = &skirmishAiCallback_WeaponDef_getProximityPriority;
-	callback->WeaponDef_getCollisionFlags = &skirmishAiCallback_WeaponDef_getCollisionFlags;
-	callback->WeaponDef_isSweepFire = &skirmishAiCallback_WeaponDef_isSweepFire;
-	callback->WeaponDef_isAbleToAttackGround = &skirmishAiCallback_WeaponDef_isAbleToAttackGround;
-	callback->WeaponDef_getCameraShake = &skirmishAiCallback_WeaponDef_getCameraShake;
-	callback->WeaponDef_getDynDamageExp = &skirmishAiCallback_WeaponDef_getDynDamageExp;
-	callback->WeaponDef_getDynDamageMin = &skirmishAiCallback_WeaponDef_getDynDamageMin;
-	callback->WeaponDef_getDynDamageRange = &skirmishAiCallback_WeaponDef_getDynDamageRange;
-	callback->WeaponDef_isDynDamageInverted = &skirmishAiCallback_WeaponDef_isDynDamageInverted;
-	callback->WeaponDef_getCustomParams = &skirmishAiCallback_WeaponDef_getCustomParams;
-	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->Engine_handleCommand = LOCKED_CALLBACK(skirmishAiCallback_Engine_handleCommand);
+	callback->Engine_Version_getMajor = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getMajor);
+	callback->Engine_Version_getMinor = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getMinor);
+	callback->Engine_Version_getPatchset = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getPatchset);
+	callback->Engine_Version_getCommits = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getCommits);
+	callback->Engine_Version_getHash = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getHash);
+	callback->Engine_Version_getBranch = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getBranch);
+	callback->Engine_Version_getAdditional = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getAdditional);
+	callback->Engine_Version_getBuildTime = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getBuildTime);
+	callback->Engine_Version_isRelease = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_isRelease);
+	callback->Engine_Version_getNormal = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getNormal);
+	callback->Engine_Version_getSync = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getSync);
+	callback->Engine_Version_getFull = LOCKED_CALLBACK(skirmishAiCallback_Engine_Version_getFull);
+	callback->Teams_getSize = LOCKED_CALLBACK(skirmishAiCallback_Teams_getSize);
+	callback->SkirmishAIs_getSize = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAIs_getSize);
+	callback->SkirmishAIs_getMax = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAIs_getMax);
+	callback->SkirmishAI_getTeamId = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_getTeamId);
+	callback->SkirmishAI_Info_getSize = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_Info_getSize);
+	callback->SkirmishAI_Info_getKey = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_Info_getKey);
+	callback->SkirmishAI_Info_getValue = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_Info_getValue);
+	callback->SkirmishAI_Info_getDescription = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_Info_getDescription);
+	callback->SkirmishAI_Info_getValueByKey = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_Info_getValueByKey);
+	callback->SkirmishAI_OptionValues_getSize = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_OptionValues_getSize);
+	callback->SkirmishAI_OptionValues_getKey = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_OptionValues_getKey);
+	callback->SkirmishAI_OptionValues_getValue = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_OptionValues_getValue);
+	callback->SkirmishAI_OptionValues_getValueByKey = LOCKED_CALLBACK(skirmishAiCallback_SkirmishAI_OptionValues_getValueByKey);
+	callback->Log_log = LOCKED_CALLBACK(skirmishAiCallback_Log_log);
+	callback->Log_exception = LOCKED_CALLBACK(skirmishAiCallback_Log_exception);
+	callback->DataDirs_getPathSeparator = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_getPathSeparator);
+	callback->DataDirs_getConfigDir = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_getConfigDir);
+	callback->DataDirs_getWriteableDir = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_getWriteableDir);
+	callback->DataDirs_locatePath = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_locatePath);
+	callback->DataDirs_allocatePath = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_allocatePath);
+	callback->DataDirs_Roots_getSize = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_Roots_getSize);
+	callback->DataDirs_Roots_getDir = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_Roots_getDir);
+	callback->DataDirs_Roots_locatePath = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_Roots_locatePath);
+	callback->DataDirs_Roots_allocatePath = LOCKED_CALLBACK(skirmishAiCallback_DataDirs_Roots_allocatePath);
+	callback->Game_getCurrentFrame = LOCKED_CALLBACK(skirmishAiCallback_Game_getCurrentFrame);
+	callback->Game_getAiInterfaceVersion = LOCKED_CALLBACK(skirmishAiCallback_Game_getAiInterfaceVersion);
+	callback->Game_getMyTeam = LOCKED_CALLBACK(skirmishAiCallback_Game_getMyTeam);
+	callback->Game_getMyAllyTeam = LOCKED_CALLBACK(skirmishAiCallback_Game_getMyAllyTeam);
+	callback->Game_getPlayerTeam = LOCKED_CALLBACK(skirmishAiCallback_Game_getPlayerTeam);
+	callback->Game_getTeams = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeams);
+	callback->Game_getTeamSide = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamSide);
+	callback->Game_getTeamColor = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamColor);
+	callback->Game_getTeamIncomeMultiplier = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamIncomeMultiplier);
+	callback->Game_getTeamAllyTeam = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamAllyTeam);
+	callback->Game_getTeamResourceCurrent = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamResourceCurrent);
+	callback->Game_getTeamResourceIncome = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamResourceIncome);
+	callback->Game_getTeamResourceUsage = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamResourceUsage);
+	callback->Game_getTeamResourceStorage = LOCKED_CALLBACK(skirmishAiCallback_Game_getTeamResourceStorage);
+	callback->Game_isAllied = LOCKED_CALLBACK(skirmishAiCallback_Game_isAllied);
+	callback->Game_isExceptionHandlingEnabled = LOCKED_CALLBACK(skirmishAiCallback_Game_isExceptionHandlingEnabled);
+	callback->Game_isDebugModeEnabled = LOCKED_CALLBACK(skirmishAiCallback_Game_isDebugModeEnabled);
+	callback->Game_isPaused = LOCKED_CALLBACK(skirmishAiCallback_Game_isPaused);
+	callback->Game_getSpeedFactor = LOCKED_CALLBACK(skirmishAiCallback_Game_getSpeedFactor);
+	callback->Game_getSetupScript = LOCKED_CALLBACK(skirmishAiCallback_Game_getSetupScript);
+	callback->Game_getCategoryFlag = LOCKED_CALLBACK(skirmishAiCallback_Game_getCategoryFlag);
+	callback->Game_getCategoriesFlag = LOCKED_CALLBACK(skirmishAiCallback_Game_getCategoriesFlag);
+	callback->Game_getCategoryName = LOCKED_CALLBACK(skirmishAiCallback_Game_getCategoryName);
+	callback->Gui_getViewRange = LOCKED_CALLBACK(skirmishAiCallback_Gui_getViewRange);
+	callback->Gui_getScreenX = LOCKED_CALLBACK(skirmishAiCallback_Gui_getScreenX);
+	callback->Gui_getScreenY = LOCKED_CALLBACK(skirmishAiCallback_Gui_getScreenY);
+	callback->Gui_Camera_getDirection = LOCKED_CALLBACK(skirmishAiCallback_Gui_Camera_getDirection);
+	callback->Gui_Camera_getPosition = LOCKED_CALLBACK(skirmishAiCallback_Gui_Camera_getPosition);
+	callback->Cheats_isEnabled = LOCKED_CALLBACK(skirmishAiCallback_Cheats_isEnabled);
+	callback->Cheats_setEnabled = LOCKED_CALLBACK(skirmishAiCallback_Cheats_setEnabled);
+	callback->Cheats_setEventsEnabled = LOCKED_CALLBACK(skirmishAiCallback_Cheats_setEventsEnabled);
+	callback->Cheats_isOnlyPassive = LOCKED_CALLBACK(skirmishAiCallback_Cheats_isOnlyPassive);
+	callback->getResources = LOCKED_CALLBACK(skirmishAiCallback_getResources);
+	callback->getResourceByName = LOCKED_CALLBACK(skirmishAiCallback_getResourceByName);
+	callback->Resource_getName = LOCKED_CALLBACK(skirmishAiCallback_Resource_getName);
+	callback->Resource_getOptimum = LOCKED_CALLBACK(skirmishAiCallback_Resource_getOptimum);
+	callback->Economy_getCurrent = LOCKED_CALLBACK(skirmishAiCallback_Economy_getCurrent);
+	callback->Economy_getIncome = LOCKED_CALLBACK(skirmishAiCallback_Economy_getIncome);
+	callback->Economy_getUsage = LOCKED_CALLBACK(skirmishAiCallback_Economy_getUsage);
+	callback->Economy_getStorage = LOCKED_CALLBACK(skirmishAiCallback_Economy_getStorage);
+	callback->File_getSize = LOCKED_CALLBACK(skirmishAiCallback_File_getSize);
+	callback->File_getContent = LOCKED_CALLBACK(skirmishAiCallback_File_getContent);
+	callback->getUnitDefs = LOCKED_CALLBACK(skirmishAiCallback_getUnitDefs);
+	callback->getUnitDefByName = LOCKED_CALLBACK(skirmishAiCallback_getUnitDefByName);
+	callback->UnitDef_getHeight = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getHeight);
+	callback->UnitDef_getRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getRadius);
+	callback->UnitDef_getName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getName);
+	callback->UnitDef_getHumanName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getHumanName);
+	callback->UnitDef_getFileName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFileName);
+	callback->UnitDef_getAiHint = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getAiHint);
+	callback->UnitDef_getCobId = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCobId);
+	callback->UnitDef_getTechLevel = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTechLevel);
+	callback->UnitDef_getGaia = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getGaia);
+	callback->UnitDef_getUpkeep = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getUpkeep);
+	callback->UnitDef_getResourceMake = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getResourceMake);
+	callback->UnitDef_getMakesResource = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMakesResource);
+	callback->UnitDef_getCost = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCost);
+	callback->UnitDef_getExtractsResource = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getExtractsResource);
+	callback->UnitDef_getResourceExtractorRange = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getResourceExtractorRange);
+	callback->UnitDef_getWindResourceGenerator = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWindResourceGenerator);
+	callback->UnitDef_getTidalResourceGenerator = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTidalResourceGenerator);
+	callback->UnitDef_getStorage = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getStorage);
+	callback->UnitDef_isSquareResourceExtractor = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isSquareResourceExtractor);
+	callback->UnitDef_getBuildTime = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildTime);
+	callback->UnitDef_getAutoHeal = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getAutoHeal);
+	callback->UnitDef_getIdleAutoHeal = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getIdleAutoHeal);
+	callback->UnitDef_getIdleTime = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getIdleTime);
+	callback->UnitDef_getPower = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getPower);
+	callback->UnitDef_getHealth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getHealth);
+	callback->UnitDef_getCategory = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCategory);
+	callback->UnitDef_getSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSpeed);
+	callback->UnitDef_getTurnRate = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTurnRate);
+	callback->UnitDef_isTurnInPlace = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isTurnInPlace);
+	callback->UnitDef_getTurnInPlaceDistance = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTurnInPlaceDistance);
+	callback->UnitDef_getTurnInPlaceSpeedLimit = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTurnInPlaceSpeedLimit);
+	callback->UnitDef_isUpright = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isUpright);
+	callback->UnitDef_isCollide = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isCollide);
+	callback->UnitDef_getLosRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getLosRadius);
+	callback->UnitDef_getAirLosRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getAirLosRadius);
+	callback->UnitDef_getLosHeight = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getLosHeight);
+	callback->UnitDef_getRadarRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getRadarRadius);
+	callback->UnitDef_getSonarRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSonarRadius);
+	callback->UnitDef_getJammerRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getJammerRadius);
+	callback->UnitDef_getSonarJamRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSonarJamRadius);
+	callback->UnitDef_getSeismicRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSeismicRadius);
+	callback->UnitDef_getSeismicSignature = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSeismicSignature);
+	callback->UnitDef_isStealth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isStealth);
+	callback->UnitDef_isSonarStealth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isSonarStealth);
+	callback->UnitDef_isBuildRange3D = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isBuildRange3D);
+	callback->UnitDef_getBuildDistance = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildDistance);
+	callback->UnitDef_getBuildSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildSpeed);
+	callback->UnitDef_getReclaimSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getReclaimSpeed);
+	callback->UnitDef_getRepairSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getRepairSpeed);
+	callback->UnitDef_getMaxRepairSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxRepairSpeed);
+	callback->UnitDef_getResurrectSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getResurrectSpeed);
+	callback->UnitDef_getCaptureSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCaptureSpeed);
+	callback->UnitDef_getTerraformSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTerraformSpeed);
+	callback->UnitDef_getMass = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMass);
+	callback->UnitDef_isPushResistant = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isPushResistant);
+	callback->UnitDef_isStrafeToAttack = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isStrafeToAttack);
+	callback->UnitDef_getMinCollisionSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMinCollisionSpeed);
+	callback->UnitDef_getSlideTolerance = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSlideTolerance);
+	callback->UnitDef_getMaxSlope = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxSlope);
+	callback->UnitDef_getMaxHeightDif = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxHeightDif);
+	callback->UnitDef_getMinWaterDepth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMinWaterDepth);
+	callback->UnitDef_getWaterline = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWaterline);
+	callback->UnitDef_getMaxWaterDepth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxWaterDepth);
+	callback->UnitDef_getArmoredMultiple = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getArmoredMultiple);
+	callback->UnitDef_getArmorType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getArmorType);
+	callback->UnitDef_FlankingBonus_getMode = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_FlankingBonus_getMode);
+	callback->UnitDef_FlankingBonus_getDir = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_FlankingBonus_getDir);
+	callback->UnitDef_FlankingBonus_getMax = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_FlankingBonus_getMax);
+	callback->UnitDef_FlankingBonus_getMin = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_FlankingBonus_getMin);
+	callback->UnitDef_FlankingBonus_getMobilityAdd = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_FlankingBonus_getMobilityAdd);
+	callback->UnitDef_getMaxWeaponRange = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxWeaponRange);
+	callback->UnitDef_getType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getType);
+	callback->UnitDef_getTooltip = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTooltip);
+	callback->UnitDef_getWreckName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWreckName);
+	callback->UnitDef_getDeathExplosion = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getDeathExplosion);
+	callback->UnitDef_getSelfDExplosion = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSelfDExplosion);
+	callback->UnitDef_getCategoryString = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCategoryString);
+	callback->UnitDef_isAbleToSelfD = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToSelfD);
+	callback->UnitDef_getSelfDCountdown = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSelfDCountdown);
+	callback->UnitDef_isAbleToSubmerge = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToSubmerge);
+	callback->UnitDef_isAbleToFly = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToFly);
+	callback->UnitDef_isAbleToMove = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToMove);
+	callback->UnitDef_isAbleToHover = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToHover);
+	callback->UnitDef_isFloater = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isFloater);
+	callback->UnitDef_isBuilder = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isBuilder);
+	callback->UnitDef_isActivateWhenBuilt = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isActivateWhenBuilt);
+	callback->UnitDef_isOnOffable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isOnOffable);
+	callback->UnitDef_isFullHealthFactory = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isFullHealthFactory);
+	callback->UnitDef_isFactoryHeadingTakeoff = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isFactoryHeadingTakeoff);
+	callback->UnitDef_isReclaimable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isReclaimable);
+	callback->UnitDef_isCapturable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isCapturable);
+	callback->UnitDef_isAbleToRestore = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToRestore);
+	callback->UnitDef_isAbleToRepair = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToRepair);
+	callback->UnitDef_isAbleToSelfRepair = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToSelfRepair);
+	callback->UnitDef_isAbleToReclaim = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToReclaim);
+	callback->UnitDef_isAbleToAttack = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToAttack);
+	callback->UnitDef_isAbleToPatrol = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToPatrol);
+	callback->UnitDef_isAbleToFight = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToFight);
+	callback->UnitDef_isAbleToGuard = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToGuard);
+	callback->UnitDef_isAbleToAssist = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToAssist);
+	callback->UnitDef_isAssistable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAssistable);
+	callback->UnitDef_isAbleToRepeat = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToRepeat);
+	callback->UnitDef_isAbleToFireControl = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToFireControl);
+	callback->UnitDef_getFireState = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFireState);
+	callback->UnitDef_getMoveState = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMoveState);
+	callback->UnitDef_getWingDrag = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWingDrag);
+	callback->UnitDef_getWingAngle = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWingAngle);
+	callback->UnitDef_getDrag = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getDrag);
+	callback->UnitDef_getFrontToSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFrontToSpeed);
+	callback->UnitDef_getSpeedToFront = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getSpeedToFront);
+	callback->UnitDef_getMyGravity = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMyGravity);
+	callback->UnitDef_getMaxBank = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxBank);
+	callback->UnitDef_getMaxPitch = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxPitch);
+	callback->UnitDef_getTurnRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTurnRadius);
+	callback->UnitDef_getWantedHeight = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWantedHeight);
+	callback->UnitDef_getVerticalSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getVerticalSpeed);
+	callback->UnitDef_isAbleToCrash = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToCrash);
+	callback->UnitDef_isHoverAttack = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isHoverAttack);
+	callback->UnitDef_isAirStrafe = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAirStrafe);
+	callback->UnitDef_getDlHoverFactor = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getDlHoverFactor);
+	callback->UnitDef_getMaxAcceleration = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxAcceleration);
+	callback->UnitDef_getMaxDeceleration = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxDeceleration);
+	callback->UnitDef_getMaxAileron = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxAileron);
+	callback->UnitDef_getMaxElevator = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxElevator);
+	callback->UnitDef_getMaxRudder = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxRudder);
+	callback->UnitDef_getYardMap = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getYardMap);
+	callback->UnitDef_getXSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getXSize);
+	callback->UnitDef_getZSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getZSize);
+	callback->UnitDef_getBuildAngle = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildAngle);
+	callback->UnitDef_getLoadingRadius = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getLoadingRadius);
+	callback->UnitDef_getUnloadSpread = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getUnloadSpread);
+	callback->UnitDef_getTransportCapacity = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTransportCapacity);
+	callback->UnitDef_getTransportSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTransportSize);
+	callback->UnitDef_getMinTransportSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMinTransportSize);
+	callback->UnitDef_isAirBase = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAirBase);
+	callback->UnitDef_isFirePlatform = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isFirePlatform);
+	callback->UnitDef_getTransportMass = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTransportMass);
+	callback->UnitDef_getMinTransportMass = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMinTransportMass);
+	callback->UnitDef_isHoldSteady = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isHoldSteady);
+	callback->UnitDef_isReleaseHeld = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isReleaseHeld);
+	callback->UnitDef_isNotTransportable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isNotTransportable);
+	callback->UnitDef_isTransportByEnemy = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isTransportByEnemy);
+	callback->UnitDef_getTransportUnloadMethod = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTransportUnloadMethod);
+	callback->UnitDef_getFallSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFallSpeed);
+	callback->UnitDef_getUnitFallSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getUnitFallSpeed);
+	callback->UnitDef_isAbleToCloak = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToCloak);
+	callback->UnitDef_isStartCloaked = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isStartCloaked);
+	callback->UnitDef_getCloakCost = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCloakCost);
+	callback->UnitDef_getCloakCostMoving = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCloakCostMoving);
+	callback->UnitDef_getDecloakDistance = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getDecloakDistance);
+	callback->UnitDef_isDecloakSpherical = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isDecloakSpherical);
+	callback->UnitDef_isDecloakOnFire = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isDecloakOnFire);
+	callback->UnitDef_isAbleToKamikaze = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToKamikaze);
+	callback->UnitDef_getKamikazeDist = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getKamikazeDist);
+	callback->UnitDef_isTargetingFacility = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isTargetingFacility);
+	callback->UnitDef_canManualFire = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_canManualFire);
+	callback->UnitDef_isNeedGeo = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isNeedGeo);
+	callback->UnitDef_isFeature = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isFeature);
+	callback->UnitDef_isHideDamage = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isHideDamage);
+	callback->UnitDef_isCommander = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isCommander);
+	callback->UnitDef_isShowPlayerName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isShowPlayerName);
+	callback->UnitDef_isAbleToResurrect = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToResurrect);
+	callback->UnitDef_isAbleToCapture = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToCapture);
+	callback->UnitDef_getHighTrajectoryType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getHighTrajectoryType);
+	callback->UnitDef_getNoChaseCategory = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getNoChaseCategory);
+	callback->UnitDef_isLeaveTracks = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isLeaveTracks);
+	callback->UnitDef_getTrackWidth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTrackWidth);
+	callback->UnitDef_getTrackOffset = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTrackOffset);
+	callback->UnitDef_getTrackStrength = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTrackStrength);
+	callback->UnitDef_getTrackStretch = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTrackStretch);
+	callback->UnitDef_getTrackType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getTrackType);
+	callback->UnitDef_isAbleToDropFlare = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToDropFlare);
+	callback->UnitDef_getFlareReloadTime = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareReloadTime);
+	callback->UnitDef_getFlareEfficiency = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareEfficiency);
+	callback->UnitDef_getFlareDelay = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareDelay);
+	callback->UnitDef_getFlareDropVector = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareDropVector);
+	callback->UnitDef_getFlareTime = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareTime);
+	callback->UnitDef_getFlareSalvoSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareSalvoSize);
+	callback->UnitDef_getFlareSalvoDelay = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getFlareSalvoDelay);
+	callback->UnitDef_isAbleToLoopbackAttack = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isAbleToLoopbackAttack);
+	callback->UnitDef_isLevelGround = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isLevelGround);
+	callback->UnitDef_isUseBuildingGroundDecal = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isUseBuildingGroundDecal);
+	callback->UnitDef_getBuildingDecalType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildingDecalType);
+	callback->UnitDef_getBuildingDecalSizeX = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildingDecalSizeX);
+	callback->UnitDef_getBuildingDecalSizeY = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildingDecalSizeY);
+	callback->UnitDef_getBuildingDecalDecaySpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildingDecalDecaySpeed);
+	callback->UnitDef_getMaxFuel = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxFuel);
+	callback->UnitDef_getRefuelTime = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getRefuelTime);
+	callback->UnitDef_getMinAirBasePower = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMinAirBasePower);
+	callback->UnitDef_getMaxThisUnit = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getMaxThisUnit);
+	callback->UnitDef_getDecoyDef = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getDecoyDef);
+	callback->UnitDef_isDontLand = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isDontLand);
+	callback->UnitDef_getShieldDef = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getShieldDef);
+	callback->UnitDef_getStockpileDef = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getStockpileDef);
+	callback->UnitDef_getBuildOptions = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getBuildOptions);
+	callback->UnitDef_getCustomParams = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getCustomParams);
+	callback->UnitDef_isMoveDataAvailable = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_isMoveDataAvailable);
+	callback->UnitDef_MoveData_getMaxAcceleration = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMaxAcceleration);
+	callback->UnitDef_MoveData_getMaxBreaking = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMaxBreaking);
+	callback->UnitDef_MoveData_getMaxSpeed = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMaxSpeed);
+	callback->UnitDef_MoveData_getMaxTurnRate = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMaxTurnRate);
+	callback->UnitDef_MoveData_getXSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getXSize);
+	callback->UnitDef_MoveData_getZSize = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getZSize);
+	callback->UnitDef_MoveData_getDepth = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getDepth);
+	callback->UnitDef_MoveData_getMaxSlope = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMaxSlope);
+	callback->UnitDef_MoveData_getSlopeMod = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getSlopeMod);
+	callback->UnitDef_MoveData_getDepthMod = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getDepthMod);
+	callback->UnitDef_MoveData_getPathType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getPathType);
+	callback->UnitDef_MoveData_getCrushStrength = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getCrushStrength);
+	callback->UnitDef_MoveData_getMoveType = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getMoveType);
+	callback->UnitDef_MoveData_getSpeedModClass = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getSpeedModClass);
+	callback->UnitDef_MoveData_getTerrainClass = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getTerrainClass);
+	callback->UnitDef_MoveData_getFollowGround = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getFollowGround);
+	callback->UnitDef_MoveData_isSubMarine = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_isSubMarine);
+	callback->UnitDef_MoveData_getName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_MoveData_getName);
+	callback->UnitDef_getWeaponMounts = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_getWeaponMounts);
+	callback->UnitDef_WeaponMount_getName = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getName);
+	callback->UnitDef_WeaponMount_getWeaponDef = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getWeaponDef);
+	callback->UnitDef_WeaponMount_getSlavedTo = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getSlavedTo);
+	callback->UnitDef_WeaponMount_getMainDir = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getMainDir);
+	callback->UnitDef_WeaponMount_getMaxAngleDif = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getMaxAngleDif);
+	callback->UnitDef_WeaponMount_getFuelUsage = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getFuelUsage);
+	callback->UnitDef_WeaponMount_getBadTargetCategory = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getBadTargetCategory);
+	callback->UnitDef_WeaponMount_getOnlyTargetCategory = LOCKED_CALLBACK(skirmishAiCallback_UnitDef_WeaponMount_getOnlyTargetCategory);
+	callback->Unit_getLimit = LOCKED_CALLBACK(skirmishAiCallback_Unit_getLimit);
+	callback->Unit_getMax = LOCKED_CALLBACK(skirmishAiCallback_Unit_getMax);
+	callback->getEnemyUnits = LOCKED_CALLBACK(skirmishAiCallback_getEnemyUnits);
+	callback->getEnemyUnitsIn = LOCKED_CALLBACK(skirmishAiCallback_getEnemyUnitsIn);
+	callback->getEnemyUnitsInRadarAndLos = LOCKED_CALLBACK(skirmishAiCallback_getEnemyUnitsInRadarAndLos);
+	callback->getFriendlyUnits = LOCKED_CALLBACK(skirmishAiCallback_getFriendlyUnits);
+	callback->getFriendlyUnitsIn = LOCKED_CALLBACK(skirmishAiCallback_getFriendlyUnitsIn);
+	callback->getNeutralUnits = LOCKED_CALLBACK(skirmishAiCallback_getNeutralUnits);
+	callback->getNeutralUnitsIn = LOCKED_CALLBACK(skirmishAiCallback_getNeutralUnitsIn);
+	callback->getTeamUnits = LOCKED_CALLBACK(skirmishAiCallback_getTeamUnits);
+	callback->getSelectedUnits = LOCKED_CALLBACK(skirmishAiCallback_getSelectedUnits);
+	callback->Unit_getDef = LOCKED_CALLBACK(skirmishAiCallback_Unit_getDef);
+	callback->Unit_getModParams = LOCKED_CALLBACK(skirmishAiCallback_Unit_getModParams);
+	callback->Unit_ModParam_getName = LOCKED_CALLBACK(skirmishAiCallback_Unit_ModParam_getName);
+	callback->Unit_ModParam_getValue = LOCKED_CALLBACK(skirmishAiCallback_Unit_ModParam_getValue);
+	callback->Unit_getTeam = LOCKED_CALLBACK(skirmishAiCallback_Unit_getTeam);
+	callback->Unit_getAllyTeam = LOCKED_CALLBACK(skirmishAiCallback_Unit_getAllyTeam);
+	callback->Unit_getAiHint = LOCKED_CALLBACK(skirmishAiCallback_Unit_getAiHint);
+	callback->Unit_getStockpile = LOCKED_CALLBACK(skirmishAiCallback_Unit_getStockpile);
+	callback->Unit_getStockpileQueued = LOCKED_CALLBACK(skirmishAiCallback_Unit_getStockpileQueued);
+	callback->Unit_getCurrentFuel = LOCKED_CALLBACK(skirmishAiCallback_Unit_getCurrentFuel);
+	callback->Unit_getMaxSpeed = LOCKED_CALLBACK(skirmishAiCallback_Unit_getMaxSpeed);
+	callback->Unit_getMaxRange = LOCKED_CALLBACK(skirmishAiCallback_Unit_getMaxRange);
+	callback->Unit_getMaxHealth = LOCKED_CALLBACK(skirmishAiCallback_Unit_getMaxHealth);
+	callback->Unit_getExperience = LOCKED_CALLBACK(skirmishAiCallback_Unit_getExperience);
+	callback->Unit_getGroup = LOCKED_CALLBACK(skirmishAiCallback_Unit_getGroup);
+	callback->Unit_getCurrentCommands = LOCKED_CALLBACK(skirmishAiCallback_Unit_getCurrentCommands);
+	callback->Unit_CurrentCommand_getType = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getType);
+	callback->Unit_CurrentCommand_getId = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getId);
+	callback->Unit_CurrentCommand_getOptions = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getOptions);
+	callback->Unit_CurrentCommand_getTag = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getTag);
+	callback->Unit_CurrentCommand_getTimeOut = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getTimeOut);
+	callback->Unit_CurrentCommand_getParams = LOCKED_CALLBACK(skirmishAiCallback_Unit_CurrentCommand_getParams);
+	callback->Unit_getSupportedCommands = LOCKED_CALLBACK(skirmishAiCallback_Unit_getSupportedCommands);
+	callback->Unit_SupportedCommand_getId = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_getId);
+	callback->Unit_SupportedCommand_getName = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_getName);
+	callback->Unit_SupportedCommand_getToolTip = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_getToolTip);
+	callback->Unit_SupportedCommand_isShowUnique = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_isShowUnique);
+	callback->Unit_SupportedCommand_isDisabled = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_isDisabled);
+	callback->Unit_SupportedCommand_getParams = LOCKED_CALLBACK(skirmishAiCallback_Unit_SupportedCommand_getParams);
+	callback->Unit_getHealth = LOCKED_CALLBACK(skirmishAiCallback_Unit_getHealth);
+	callback->Unit_getSpeed = LOCKED_CALLBACK(skirmishAiCallback_Unit_getSpeed);
+	callback->Unit_getPower = LOCKED_CALLBACK(skirmishAiCallback_Unit_getPower);
+	callback->Unit_getResourceUse = LOCKED_CALLBACK(skirmishAiCallback_Unit_getResourceUse);
+	callback->Unit_getResourceMake = LOCKED_CALLBACK(skirmishAiCallback_Unit_getResourceMake);
+	callback->Unit_getPos = LOCKED_CALLBACK(skirmishAiCallback_Unit_getPos);
+	callback->Unit_getVel = LOCKED_CALLBACK(skirmishAiCallback_Unit_getVel);
+	callback->Unit_isActivated = LOCKED_CALLBACK(skirmishAiCallback_Unit_isActivated);
+	callback->Unit_isBeingBuilt = LOCKED_CALLBACK(skirmishAiCallback_Unit_isBeingBuilt);
+	callback->Unit_isCloaked = LOCKED_CALLBACK(skirmishAiCallback_Unit_isCloaked);
+	callback->Unit_isParalyzed = LOCKED_CALLBACK(skirmishAiCallback_Unit_isParalyzed);
+	callback->Unit_isNeutral = LOCKED_CALLBACK(skirmishAiCallback_Unit_isNeutral);
+	callback->Unit_getBuildingFacing = LOCKED_CALLBACK(skirmishAiCallback_Unit_getBuildingFacing);
+	callback->Unit_getLastUserOrderFrame = LOCKED_CALLBACK(skirmishAiCallback_Unit_getLastUserOrderFrame);
+	callback->getGroups = LOCKED_CALLBACK(skirmishAiCallback_getGroups);
+	callback->Group_getSupportedCommands = LOCKED_CALLBACK(skirmishAiCallback_Group_getSupportedCommands);
+	callback->Group_SupportedCommand_getId = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_getId);
+	callback->Group_SupportedCommand_getName = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_getName);
+	callback->Group_SupportedCommand_getToolTip = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_getToolTip);
+	callback->Group_SupportedCommand_isShowUnique = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_isShowUnique);
+	callback->Group_SupportedCommand_isDisabled = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_isDisabled);
+	callback->Group_SupportedCommand_getParams = LOCKED_CALLBACK(skirmishAiCallback_Group_SupportedCommand_getParams);
+	callback->Group_OrderPreview_getId = LOCKED_CALLBACK(skirmishAiCallback_Group_OrderPreview_getId);
+	callback->Group_OrderPreview_getOptions = LOCKED_CALLBACK(skirmishAiCallback_Group_OrderPreview_getOptions);
+	callback->Group_OrderPreview_getTag = LOCKED_CALLBACK(skirmishAiCallback_Group_OrderPreview_getTag);
+	callback->Group_OrderPreview_getTimeOut = LOCKED_CALLBACK(skirmishAiCallback_Group_OrderPreview_getTimeOut);
+	callback->Group_OrderPreview_getParams = LOCKED_CALLBACK(skirmishAiCallback_Group_OrderPreview_getParams);
+	callback->Group_isSelected = LOCKED_CALLBACK(skirmishAiCallback_Group_isSelected);
+	callback->Mod_getFileName = LOCKED_CALLBACK(skirmishAiCallback_Mod_getFileName);
+	callback->Mod_getHash = LOCKED_CALLBACK(skirmishAiCallback_Mod_getHash);
+	callback->Mod_getHumanName = LOCKED_CALLBACK(skirmishAiCallback_Mod_getHumanName);
+	callback->Mod_getShortName = LOCKED_CALLBACK(skirmishAiCallback_Mod_getShortName);
+	callback->Mod_getVersion = LOCKED_CALLBACK(skirmishAiCallback_Mod_getVersion);
+	callback->Mod_getMutator = LOCKED_CALLBACK(skirmishAiCallback_Mod_getMutator);
+	callback->Mod_getDescription = LOCKED_CALLBACK(skirmishAiCallback_Mod_getDescription);
+	callback->Mod_getAllowTeamColors = LOCKED_CALLBACK(skirmishAiCallback_Mod_getAllowTeamColors);
+	callback->Mod_getConstructionDecay = LOCKED_CALLBACK(skirmishAiCallback_Mod_getConstructionDecay);
+	callback->Mod_getConstructionDecayTime = LOCKED_CALLBACK(skirmishAiCallback_Mod_getConstructionDecayTime);
+	callback->Mod_getConstructionDecaySpeed = LOCKED_CALLBACK(skirmishAiCallback_Mod_getConstructionDecaySpeed);
+	callback->Mod_getMultiReclaim = LOCKED_CALLBACK(skirmishAiCallback_Mod_getMultiReclaim);
+	callback->Mod_getReclaimMethod = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimMethod);
+	callback->Mod_getReclaimUnitMethod = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimUnitMethod);
+	callback->Mod_getReclaimUnitEnergyCostFactor = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimUnitEnergyCostFactor);
+	callback->Mod_getReclaimUnitEfficiency = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimUnitEfficiency);
+	callback->Mod_getReclaimFeatureEnergyCostFactor = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimFeatureEnergyCostFactor);
+	callback->Mod_getReclaimAllowEnemies = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimAllowEnemies);
+	callback->Mod_getReclaimAllowAllies = LOCKED_CALLBACK(skirmishAiCallback_Mod_getReclaimAllowAllies);
+	callback->Mod_getRepairEnergyCostFactor = LOCKED_CALLBACK(skirmishAiCallback_Mod_getRepairEnergyCostFactor);
+	callback->Mod_getResurrectEnergyCostFactor = LOCKED_CALLBACK(skirmishAiCallback_Mod_getResurrectEnergyCostFactor);
+	callback->Mod_getCaptureEnergyCostFactor = LOCKED_CALLBACK(skirmishAiCallback_Mod_getCaptureEnergyCostFactor);
+	callback->Mod_getTransportGround = LOCKED_CALLBACK(skirmishAiCallback_Mod_getTransportGround);
+	callback->Mod_getTransportHover = LOCKED_CALLBACK(skirmishAiCallback_Mod_getTransportHover);
+	callback->Mod_getTransportShip = LOCKED_CALLBACK(skirmishAiCallback_Mod_getTransportShip);
+	callback->Mod_getTransportAir = LOCKED_CALLBACK(skirmishAiCallback_Mod_getTransportAir);
+	callback->Mod_getFireAtKilled = LOCKED_CALLBACK(skirmishAiCallback_Mod_getFireAtKilled);
+	callback->Mod_getFireAtCrashing = LOCKED_CALLBACK(skirmishAiCallback_Mod_getFireAtCrashing);
+	callback->Mod_getFlankingBonusModeDefault = LOCKED_CALLBACK(skirmishAiCallback_Mod_getFlankingBonusModeDefault);
+	callback->Mod_getLosMipLevel = LOCKED_CALLBACK(skirmishAiCallback_Mod_getLosMipLevel);
+	callback->Mod_getAirMipLevel = LOCKED_CALLBACK(skirmishAiCallback_Mod_getAirMipLevel);
+	callback->Mod_getLosMul = LOCKED_CALLBACK(skirmishAiCallback_Mod_getLosMul);
+	callback->Mod_getAirLosMul = LOCKED_CALLBACK(skirmishAiCallback_Mod_getAirLosMul);
+	callback->Mod_getRequireSonarUnderWater = LOCKED_CALLBACK(skirmishAiCallback_Mod_getRequireSonarUnderWater);
+	callback->Map_getChecksum = LOCKED_CALLBACK(skirmishAiCallback_Map_getChecksum);
+	callback->Map_getStartPos = LOCKED_CALLBACK(skirmishAiCallback_Map_getStartPos);
+	callback->Map_getMousePos = LOCKED_CALLBACK(skirmishAiCallback_Map_getMousePos);
+	callback->Map_isPosInCamera = LOCKED_CALLBACK(skirmishAiCallback_Map_isPosInCamera);
+	callback->Map_getWidth = LOCKED_CALLBACK(skirmishAiCallback_Map_getWidth);
+	callback->Map_getHeight = LOCKED_CALLBACK(skirmishAiCallback_Map_getHeight);
+	callback->Map_getHeightMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getHeightMap);
+	callback->Map_getCornersHeightMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getCornersHeightMap);
+	callback->Map_getMinHeight = LOCKED_CALLBACK(skirmishAiCallback_Map_getMinHeight);
+	callback->Map_getMaxHeight = LOCKED_CALLBACK(skirmishAiCallback_Map_getMaxHeight);
+	callback->Map_getSlopeMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getSlopeMap);
+	callback->Map_getLosMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getLosMap);
+	callback->Map_getRadarMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getRadarMap);
+	callback->Map_getJammerMap = LOCKED_CALLBACK(skirmishAiCallback_Map_getJammerMap);
+	callback->Map_getResourceMapRaw = LOCKED_CALLBACK(skirmishAiCallback_Map_getResourceMapRaw);
+	callback->Map_getResourceMapSpotsPositions = LOCKED_CALLBACK(skirmishAiCallback_Map_getResourceMapSpotsPositions);
+	callback->Map_getResourceMapSpotsAverageIncome = LOCKED_CALLBACK(skirmishAiCallback_Map_getResourceMapSpotsAverageIncome);
+	callback->Map_getResourceMapSpotsNearest = LOCKED_CALLBACK(skirmishAiCallback_Map_getResourceMapSpotsNearest);
+	callback->Map_getHash = LOCKED_CALLBACK(skirmishAiCallback_Map_getHash);
+	callback->Map_getName = LOCKED_CALLBACK(skirmishAiCallback_Map_getName);
+	callback->Map_getHumanName = LOCKED_CALLBACK(skirmishAiCallback_Map_getHumanName);
+	callback->Map_getElevationAt = LOCKED_CALLBACK(skirmishAiCallback_Map_getElevationAt);
+	callback->Map_getMaxResource = LOCKED_CALLBACK(skirmishAiCallback_Map_getMaxResource);
+	callback->Map_getExtractorRadius = LOCKED_CALLBACK(skirmishAiCallback_Map_getExtractorRadius);
+	callback->Map_getMinWind = LOCKED_CALLBACK(skirmishAiCallback_Map_getMinWind);
+	callback->Map_getMaxWind = LOCKED_CALLBACK(skirmishAiCallback_Map_getMaxWind);
+	callback->Map_getCurWind = LOCKED_CALLBACK(skirmishAiCallback_Map_getCurWind);
+	callback->Map_getTidalStrength = LOCKED_CALLBACK(skirmishAiCallback_Map_getTidalStrength);
+	callback->Map_getGravity = LOCKED_CALLBACK(skirmishAiCallback_Map_getGravity);
+	callback->Map_getPoints = LOCKED_CALLBACK(skirmishAiCallback_Map_getPoints);
+	callback->Map_Point_getPosition = LOCKED_CALLBACK(skirmishAiCallback_Map_Point_getPosition);
+	callback->Map_Point_getColor = LOCKED_CALLBACK(skirmishAiCallback_Map_Point_getColor);
+	callback->Map_Point_getLabel = LOCKED_CALLBACK(skirmishAiCallback_Map_Point_getLabel);
+	callback->Map_getLines = LOCKED_CALLBACK(skirmishAiCallback_Map_getLines);
+	callback->Map_Line_getFirstPosition = LOCKED_CALLBACK(skirmishAiCallback_Map_Line_getFirstPosition);
+	callback->Map_Line_getSecondPosition = LOCKED_CALLBACK(skirmishAiCallback_Map_Line_getSecondPosition);
+	callback->Map_Line_getColor = LOCKED_CALLBACK(skirmishAiCallback_Map_Line_getColor);
+	callback->Map_isPossibleToBuildAt = LOCKED_CALLBACK(skirmishAiCallback_Map_isPossibleToBuildAt);
+	callback->Map_findClosestBuildSite = LOCKED_CALLBACK(skirmishAiCallback_Map_findClosestBuildSite);
+	callback->getFeatureDefs = LOCKED_CALLBACK(skirmishAiCallback_getFeatureDefs);
+	callback->FeatureDef_getName = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getName);
+	callback->FeatureDef_getDescription = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getDescription);
+	callback->FeatureDef_getFileName = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getFileName);
+	callback->FeatureDef_getContainedResource = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getContainedResource);
+	callback->FeatureDef_getMaxHealth = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getMaxHealth);
+	callback->FeatureDef_getReclaimTime = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getReclaimTime);
+	callback->FeatureDef_getMass = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getMass);
+	callback->FeatureDef_isUpright = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isUpright);
+	callback->FeatureDef_getDrawType = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getDrawType);
+	callback->FeatureDef_getModelName = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getModelName);
+	callback->FeatureDef_getResurrectable = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getResurrectable);
+	callback->FeatureDef_getSmokeTime = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getSmokeTime);
+	callback->FeatureDef_isDestructable = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isDestructable);
+	callback->FeatureDef_isReclaimable = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isReclaimable);
+	callback->FeatureDef_isBlocking = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isBlocking);
+	callback->FeatureDef_isBurnable = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isBurnable);
+	callback->FeatureDef_isFloating = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isFloating);
+	callback->FeatureDef_isNoSelect = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isNoSelect);
+	callback->FeatureDef_isGeoThermal = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_isGeoThermal);
+	callback->FeatureDef_getDeathFeature = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getDeathFeature);
+	callback->FeatureDef_getXSize = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getXSize);
+	callback->FeatureDef_getZSize = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getZSize);
+	callback->FeatureDef_getCustomParams = LOCKED_CALLBACK(skirmishAiCallback_FeatureDef_getCustomParams);
+	callback->getFeatures = LOCKED_CALLBACK(skirmishAiCallback_getFeatures);
+	callback->getFeaturesIn = LOCKED_CALLBACK(skirmishAiCallback_getFeaturesIn);
+	callback->Feature_getDef = LOCKED_CALLBACK(skirmishAiCallback_Feature_getDef);
+	callback->Feature_getHealth = LOCKED_CALLBACK(skirmishAiCallback_Feature_getHealth);
+	callback->Feature_getReclaimLeft = LOCKED_CALLBACK(skirmishAiCallback_Feature_getReclaimLeft);
+	callback->Feature_getPosition = LOCKED_CALLBACK(skirmishAiCallback_Feature_getPosition);
+	callback->getWeaponDefs = LOCKED_CALLBACK(skirmishAiCallback_getWeaponDefs);
+	callback->getWeaponDefByName = LOCKED_CALLBACK(skirmishAiCallback_getWeaponDefByName);
+	callback->WeaponDef_getName = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getName);
+	callback->WeaponDef_getType = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getType);
+	callback->WeaponDef_getDescription = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDescription);
+	callback->WeaponDef_getFileName = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getFileName);
+	callback->WeaponDef_getCegTag = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCegTag);
+	callback->WeaponDef_getRange = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getRange);
+	callback->WeaponDef_getHeightMod = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getHeightMod);
+	callback->WeaponDef_getAccuracy = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getAccuracy);
+	callback->WeaponDef_getSprayAngle = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getSprayAngle);
+	callback->WeaponDef_getMovingAccuracy = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getMovingAccuracy);
+	callback->WeaponDef_getTargetMoveError = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getTargetMoveError);
+	callback->WeaponDef_getLeadLimit = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getLeadLimit);
+	callback->WeaponDef_getLeadBonus = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getLeadBonus);
+	callback->WeaponDef_getPredictBoost = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getPredictBoost);
+	callback->WeaponDef_getNumDamageTypes = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getNumDamageTypes);
+	callback->WeaponDef_Damage_getParalyzeDamageTime = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getParalyzeDamageTime);
+	callback->WeaponDef_Damage_getImpulseFactor = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getImpulseFactor);
+	callback->WeaponDef_Damage_getImpulseBoost = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getImpulseBoost);
+	callback->WeaponDef_Damage_getCraterMult = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getCraterMult);
+	callback->WeaponDef_Damage_getCraterBoost = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getCraterBoost);
+	callback->WeaponDef_Damage_getTypes = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Damage_getTypes);
+	callback->WeaponDef_getAreaOfEffect = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getAreaOfEffect);
+	callback->WeaponDef_isNoSelfDamage = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isNoSelfDamage);
+	callback->WeaponDef_getFireStarter = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getFireStarter);
+	callback->WeaponDef_getEdgeEffectiveness = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getEdgeEffectiveness);
+	callback->WeaponDef_getSize = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getSize);
+	callback->WeaponDef_getSizeGrowth = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getSizeGrowth);
+	callback->WeaponDef_getCollisionSize = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCollisionSize);
+	callback->WeaponDef_getSalvoSize = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getSalvoSize);
+	callback->WeaponDef_getSalvoDelay = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getSalvoDelay);
+	callback->WeaponDef_getReload = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getReload);
+	callback->WeaponDef_getBeamTime = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getBeamTime);
+	callback->WeaponDef_isBeamBurst = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isBeamBurst);
+	callback->WeaponDef_isWaterBounce = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isWaterBounce);
+	callback->WeaponDef_isGroundBounce = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isGroundBounce);
+	callback->WeaponDef_getBounceRebound = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getBounceRebound);
+	callback->WeaponDef_getBounceSlip = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getBounceSlip);
+	callback->WeaponDef_getNumBounce = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getNumBounce);
+	callback->WeaponDef_getMaxAngle = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getMaxAngle);
+	callback->WeaponDef_getUpTime = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getUpTime);
+	callback->WeaponDef_getFlightTime = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getFlightTime);
+	callback->WeaponDef_getCost = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCost);
+	callback->WeaponDef_getProjectilesPerShot = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getProjectilesPerShot);
+	callback->WeaponDef_isTurret = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isTurret);
+	callback->WeaponDef_isOnlyForward = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isOnlyForward);
+	callback->WeaponDef_isFixedLauncher = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isFixedLauncher);
+	callback->WeaponDef_isWaterWeapon = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isWaterWeapon);
+	callback->WeaponDef_isFireSubmersed = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isFireSubmersed);
+	callback->WeaponDef_isSubMissile = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isSubMissile);
+	callback->WeaponDef_isTracks = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isTracks);
+	callback->WeaponDef_isDropped = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isDropped);
+	callback->WeaponDef_isParalyzer = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isParalyzer);
+	callback->WeaponDef_isImpactOnly = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isImpactOnly);
+	callback->WeaponDef_isNoAutoTarget = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isNoAutoTarget);
+	callback->WeaponDef_isManualFire = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isManualFire);
+	callback->WeaponDef_getInterceptor = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getInterceptor);
+	callback->WeaponDef_getTargetable = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getTargetable);
+	callback->WeaponDef_isStockpileable = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isStockpileable);
+	callback->WeaponDef_getCoverageRange = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCoverageRange);
+	callback->WeaponDef_getStockpileTime = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getStockpileTime);
+	callback->WeaponDef_getIntensity = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getIntensity);
+	callback->WeaponDef_getThickness = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getThickness);
+	callback->WeaponDef_getLaserFlareSize = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getLaserFlareSize);
+	callback->WeaponDef_getCoreThickness = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCoreThickness);
+	callback->WeaponDef_getDuration = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDuration);
+	callback->WeaponDef_getLodDistance = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getLodDistance);
+	callback->WeaponDef_getFalloffRate = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getFalloffRate);
+	callback->WeaponDef_getGraphicsType = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getGraphicsType);
+	callback->WeaponDef_isSoundTrigger = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isSoundTrigger);
+	callback->WeaponDef_isSelfExplode = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isSelfExplode);
+	callback->WeaponDef_isGravityAffected = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isGravityAffected);
+	callback->WeaponDef_getHighTrajectory = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getHighTrajectory);
+	callback->WeaponDef_getMyGravity = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getMyGravity);
+	callback->WeaponDef_isNoExplode = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isNoExplode);
+	callback->WeaponDef_getStartVelocity = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getStartVelocity);
+	callback->WeaponDef_getWeaponAcceleration = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getWeaponAcceleration);
+	callback->WeaponDef_getTurnRate = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getTurnRate);
+	callback->WeaponDef_getMaxVelocity = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getMaxVelocity);
+	callback->WeaponDef_getProjectileSpeed = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getProjectileSpeed);
+	callback->WeaponDef_getExplosionSpeed = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getExplosionSpeed);
+	callback->WeaponDef_getOnlyTargetCategory = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getOnlyTargetCategory);
+	callback->WeaponDef_getWobble = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getWobble);
+	callback->WeaponDef_getDance = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDance);
+	callback->WeaponDef_getTrajectoryHeight = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getTrajectoryHeight);
+	callback->WeaponDef_isLargeBeamLaser = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isLargeBeamLaser);
+	callback->WeaponDef_isShield = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isShield);
+	callback->WeaponDef_isShieldRepulser = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isShieldRepulser);
+	callback->WeaponDef_isSmartShield = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isSmartShield);
+	callback->WeaponDef_isExteriorShield = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isExteriorShield);
+	callback->WeaponDef_isVisibleShield = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isVisibleShield);
+	callback->WeaponDef_isVisibleShieldRepulse = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isVisibleShieldRepulse);
+	callback->WeaponDef_getVisibleShieldHitFrames = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getVisibleShieldHitFrames);
+	callback->WeaponDef_Shield_getResourceUse = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getResourceUse);
+	callback->WeaponDef_Shield_getRadius = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getRadius);
+	callback->WeaponDef_Shield_getForce = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getForce);
+	callback->WeaponDef_Shield_getMaxSpeed = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getMaxSpeed);
+	callback->WeaponDef_Shield_getPower = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getPower);
+	callback->WeaponDef_Shield_getPowerRegen = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getPowerRegen);
+	callback->WeaponDef_Shield_getPowerRegenResource = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getPowerRegenResource);
+	callback->WeaponDef_Shield_getStartingPower = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getStartingPower);
+	callback->WeaponDef_Shield_getRechargeDelay = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getRechargeDelay);
+	callback->WeaponDef_Shield_getGoodColor = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getGoodColor);
+	callback->WeaponDef_Shield_getBadColor = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getBadColor);
+	callback->WeaponDef_Shield_getAlpha = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getAlpha);
+	callback->WeaponDef_Shield_getInterceptType = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_Shield_getInterceptType);
+	callback->WeaponDef_getInterceptedByShieldType = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getInterceptedByShieldType);
+	callback->WeaponDef_isAvoidFriendly = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isAvoidFriendly);
+	callback->WeaponDef_isAvoidFeature = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isAvoidFeature);
+	callback->WeaponDef_isAvoidNeutral = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isAvoidNeutral);
+	callback->WeaponDef_getTargetBorder = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getTargetBorder);
+	callback->WeaponDef_getCylinderTargetting = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCylinderTargetting);
+	callback->WeaponDef_getMinIntensity = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getMinIntensity);
+	callback->WeaponDef_getHeightBoostFactor = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getHeightBoostFactor);
+	callback->WeaponDef_getProximityPriority = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getProximityPriority);
+	callback->WeaponDef_getCollisionFlags = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCollisionFlags);
+	callback->WeaponDef_isSweepFire = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isSweepFire);
+	callback->WeaponDef_isAbleToAttackGround = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isAbleToAttackGround);
+	callback->WeaponDef_getCameraShake = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCameraShake);
+	callback->WeaponDef_getDynDamageExp = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDynDamageExp);
+	callback->WeaponDef_getDynDamageMin = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDynDamageMin);
+	callback->WeaponDef_getDynDamageRange = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getDynDamageRange);
+	callback->WeaponDef_isDynDamageInverted = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_isDynDamageInverted);
+	callback->WeaponDef_getCustomParams = LOCKED_CALLBACK(skirmishAiCallback_WeaponDef_getCustomParams);
+	callback->Debug_GraphDrawer_isEnabled = LOCKED_CALLBACK(skirmishAiCallback_Debug_GraphDrawer_isEnabled);
 }
 
 SSkirmishAICallback* skirmishAiCallback_getInstanceFor(int skirmishAIId, int teamId, CAICallback* aiCallback, CAICheats* aiCheats) {
@@ -5164,3 +5185,7 @@ void skirmishAiCallback_release(int skirmishAIId) {
 	skirmishAIId_teamId.erase(skirmishAIId);
 }
 
+void skirmishAiCallback_setLocking(bool enable) {
+	callbackLocking = enable;
+}
+
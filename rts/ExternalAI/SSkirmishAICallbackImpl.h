@@ -1298,6 +1298,12 @@ SSkirmishAICallback* skirmishAiCallback_getInstanceFor(int skirmishAIId, int tea
  */
 void skirmishAiCallback_release(int skirmishAIId);
 
+/**
+ * Makes every callback hold a common lock while it runs,
+ * needed while AIs handle events on worker threads.
+ */
+void skirmishAiCallback_setLocking(bool enable);
+
 #endif // defined __cplusplus && !defined BUILDING_AI
 
 #endif // S_SKIRMISH_AI_CALLBACK_IMPL_H
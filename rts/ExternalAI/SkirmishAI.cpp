@@ -6,6 +6,7 @@
 #include "IAILibraryManager.h"
 #include "SkirmishAILibrary.h"
 #include "SkirmishAIHandler.h"
+#include "EngineOutHandler.h"
 #include "System/TimeProfiler.h"
 #include "System/Util.h"
 
@@ -52,7 +53,17 @@ void CSkirmishAI::Dieing() {
 
 int CSkirmishAI::HandleEvent(int topic, const void* data) const {
 
+	// the profiler is not thread-safe, AIs running on worker
+	// threads are only accounted for as a whole ("AI Total")
+	if (CEngineOutHandler::IsRunningThreadedAIs())
+		return DoHandleEvent(topic, data);
+
 	SCOPED_TIMER(timerName.c_str());
+	return DoHandleEvent(topic, data);
+}
+
+int CSkirmishAI::DoHandleEvent(int topic, const void* data) const {
+
 	if (!dieing || (topic == EVENT_RELEASE)) {
 		return library->HandleEvent(skirmishAIId, topic, data);
 	} else {
@@ -25,10 +25,13 @@ CR_REG_METADATA(CSkirmishAIHandler, (
 	CR_MEMBER(id_dieReason),
 	CR_MEMBER(id_libKey),
 	CR_MEMBER(gameInitialized),
-	CR_MEMBER(luaAIShortNames),
-	CR_IGNORED(currentAIId)
+	CR_MEMBER(luaAIShortNames)
 ));
 
+// per thread, as AIs may handle their events on worker threads
+// (see ThreadedSkirmishAIs)
+static __thread unsigned char currentAIId = MAX_AIS;
+
 
 CSkirmishAIHandler& CSkirmishAIHandler::GetInstance()
 {
@@ -37,7 +40,7 @@ CSkirmishAIHandler& CSkirmishAIHandler::GetInstance()
 }
 
 CSkirmishAIHandler::CSkirmishAIHandler():
-	gameInitialized(false), currentAIId(MAX_AIS)
+	gameInitialized(false)
 {
 }
 
@@ -264,6 +267,14 @@ const std::set<std::string>& CSkirmishAIHandler::GetLuaAIImplShortNames() const
 	return luaAIShortNames;
 }
 
+unsigned char CSkirmishAIHandler::GetCurrentAIID() const {
+	return currentAIId;
+}
+
+void CSkirmishAIHandler::SetCurrentAIID(unsigned char id) {
+	currentAIId = id;
+}
+
 bool CSkirmishAIHandler::IsLuaAI(const SkirmishAIData& aiData) const {
 	assert(gameInitialized);
 	return (luaAIShortNames.find(aiData.shortName) != luaAIShortNames.end());
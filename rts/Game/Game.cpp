@@ -137,6 +137,7 @@
 #include "System/myMath.h"
 #include "Net/GameServer.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/SlabMemPool.h"
 #include "System/SpringApp.h"
 #include "System/Util.h"
 #include "System/Input/KeyInput.h"
@@ -146,7 +147,9 @@
 #include "System/FileSystem/SimpleParser.h"
 #include "System/LoadSave/LoadSaveHandler.h"
 #include "System/LoadSave/DemoRecorder.h"
+#include "System/LoadSave/ReplaySnapshots.h"
 #include "System/Log/ILog.h"
+#include "System/Misc/HeapAllocCounter.h"
 #include "System/Net/PackPacket.h"
 #include "System/Platform/CrashHandler.h"
 #include "System/Platform/Watchdog.h"
@@ -156,6 +159,7 @@
 #include "System/Sync/SyncedPrimitiveIO.h"
 #include "System/Sync/SyncTracer.h"
 #include "System/TimeProfiler.h"
+#include "System/ThreadPool.h"
 
 #include <boost/cstdint.hpp>
 #include "lib/lua/include/LuaUser.h"
@@ -178,6 +182,7 @@ CONFIG(int, ShowPlayerInfo).defaultValue(1);
 CONFIG(float, GuiOpacity).defaultValue(0.8f).minimumValue(0.0f).maximumValue(1.0f).description("Sets the opacity of the built-in Spring UI. Generally has no effect on LuaUI widgets. Can be set in-game using shift+, to decrease and shift+. to increase.");
 CONFIG(std::string, InputTextGeo).defaultValue("");
 CONFIG(bool, LuaModUICtrl).defaultValue(true);
+CONFIG(int, ArchivePrefetchMemory).defaultValue(256).minimumValue(0).description("Maximum MB of game content (unit and weapon definitions, scripts, models, textures) to decompress in parallel when loading starts. 0 disables prefetching.");
 
 
 CGame* game = NULL;
@@ -350,6 +355,7 @@ CGame::CGame(const std::string& mapName, const std::string& modName, ILoadSaveHa
 	, speedControl(-1)
 	, defsParser(NULL)
 	, saveFile(saveFile)
+	, replaySnapshots(NULL)
 	, infoConsole(NULL)
 	, consoleHistory(NULL)
 	, worldDrawer(NULL)
@@ -446,6 +452,7 @@ CGame::~CGame()
 
 	LOG("[%s][6]", __FUNCTION__);
 	SafeDelete(worldDrawer);
+	SafeDelete(replaySnapshots);
 	SafeDelete(guihandler); // frees LuaUI
 	SafeDelete(minimap);
 	SafeDelete(resourceBar);
@@ -533,6 +540,9 @@ void CGame::LoadGame(const std::string& mapName, bool threaded)
 	Threading::SetGameLoadThread();
 	Watchdog::RegisterThread(WDT_LOAD);
 
+	const spring_time loadStartTime = spring_gettime();
+
+	if (!gu->globalQuit) PrefetchArchiveFiles();
 	if (!gu->globalQuit) LoadMap(mapName);
 	if (!gu->globalQuit) LoadDefs();
 	if (!gu->globalQuit) PreLoadSimulation();
@@ -548,10 +558,46 @@ void CGame::LoadGame(const std::string& mapName, bool threaded)
 		saveFile->LoadGame();
 	}
 
+	// whatever was not needed yet is unlikely to be needed soon
+	vfsHandler->ReleasePrefetchedFiles();
+
+	LOG("[Game::%s] loading took %.2fs (archive prefetching %s)", __FUNCTION__,
+		(spring_gettime() - loadStartTime).toMilliSecsf() * 0.001f,
+		(configHandler->GetInt("ArchivePrefetchMemory") > 0)? "enabled": "disabled");
+
 	Watchdog::DeregisterThread(WDT_LOAD);
 }
 
 
+void CGame::PrefetchArchiveFiles()
+{
+	const size_t maxBytes = size_t(configHandler->GetInt("ArchivePrefetchMemory")) * 1024 * 1024;
+
+	if (maxBytes == 0)
+		return;
+
+	// roughly in the order in which loading needs them
+	static const char* dirs[] = {
+		"gamedata/",
+		"units/",
+		"weapons/",
+		"features/",
+		"scripts/",
+		"objects3d/",
+		"unittextures/",
+	};
+
+	loadscreen->SetLoadMessage("Prefetching Game Content");
+
+	const spring_time prefetchStartTime = spring_gettime();
+	const size_t numBytes = vfsHandler->PrefetchFiles(std::vector<std::string>(dirs, dirs + (sizeof(dirs) / sizeof(dirs[0]))), maxBytes);
+
+	LOG("[Game::%s] decompressed %.1f MB in %.2fs on %d thread(s)", __FUNCTION__,
+		numBytes / (1024.0f * 1024.0f), (spring_gettime() - prefetchStartTime).toMilliSecsf() * 0.001f,
+		ThreadPool::GetNumThreads());
+}
+
+
 void CGame::LoadMap(const std::string& mapName)
 {
 	ENTER_SYNCED_CODE();
@@ -829,6 +875,8 @@ void CGame::LoadFinalize()
 		static CBenchmark benchmark;
 	}
 
+	replaySnapshots = CReplaySnapshots::Create();
+
 	lastReadNetTime = spring_gettime();
 	lastSimFrameTime = lastReadNetTime;
 	lastDrawFrameTime = lastReadNetTime;
@@ -842,6 +890,11 @@ void CGame::LoadFinalize()
 void CGame::PostLoad()
 {
 	GameSetupDrawer::Disable();
+
+	// the server already rewound its demo to the restored frame
+	if (replaySnapshots != NULL && replaySnapshots->IsRestoring())
+		return;
+
 	if (gameServer) {
 		gameServer->PostLoad(gs->frameNum);
 	}
@@ -1345,6 +1398,15 @@ bool CGame::Draw() {
 		switch (pathManager->GetPathFinderType()) {
 			case PFS_TYPE_DEFAULT: {
 				font->glFormat(0.03f, 0.12f, 0.7f, DBG_FONT_FLAGS, fmtString, "DEFAULT", pfsUpdates.x, pfsUpdates.y);
+
+				IPathManager::PathCacheStats pcs;
+				pathManager->GetPathCacheStats(-1, true, pcs);
+
+				font->glFormat(
+					0.03f, 0.095f, 0.7f, DBG_FONT_FLAGS,
+					"[DEFAULT-PFS] path-cache: %u hits, %u misses, %u evictions, %u expirations",
+					pcs.numHits, pcs.numMisses, pcs.numEvictions, pcs.numExpirations
+				);
 			} break;
 			case PFS_TYPE_QTPFS: {
 				font->glFormat(0.03f, 0.12f, 0.7f, DBG_FONT_FLAGS, fmtString, "QT", pfsUpdates.x, pfsUpdates.y);
@@ -1363,6 +1425,24 @@ bool CGame::Draw() {
 			luaInfo.numLuaStates
 		);
 
+		for (int i = 0; i < CSlabMemPool::GetNumPools(); i++) {
+			const CSlabMemPool* pool = CSlabMemPool::GetPool(i);
+
+			if (pool == NULL)
+				continue;
+
+			const CSlabMemPool::Stats& ps = pool->GetFrameStats();
+
+			font->glFormat(
+				0.03f, 0.18f + i * 0.025f, 0.7f, DBG_FONT_FLAGS,
+				"[%s-pool] %u/%u blocks used (%.1fMB), last frame: %u allocs, %u frees, %u heap-allocs",
+				pool->GetName(),
+				unsigned(ps.numUsedBlocks), unsigned(ps.numBlocks),
+				pool->GetSlabBytes() / 1024.0f / 1024.0f,
+				unsigned(ps.numAllocs), unsigned(ps.numFrees), unsigned(ps.numHeapAllocs)
+			);
+		}
+
 		font->End();
 	}
 
@@ -1573,6 +1653,7 @@ void CGame::StartPlaying()
 
 void CGame::SimFrame() {
 	ENTER_SYNCED_CODE();
+	HeapAllocCounter::BeginSimFrame();
 
 	good_fpu_control_registers("CGame::SimFrame");
 	lastFrameTime = spring_gettime();
@@ -1586,6 +1667,8 @@ void CGame::SimFrame() {
 	tracefile << "New frame:" << gs->frameNum << " " << gs->GetRandSeed() << "\n";
 #endif
 
+	eoh->BeginSimFrame();
+
 	if (!skipping) {
 		// everything here is unsynced and should ideally moved to Game::Update()
 		infoConsole->Update();
@@ -1623,6 +1706,10 @@ void CGame::SimFrame() {
 	teamHandler->GameFrame(gs->frameNum);
 	playerHandler->GameFrame(gs->frameNum);
 
+	eoh->EndSimFrame();
+
+	HeapAllocCounter::EndSimFrame();
+
 	lastSimFrameTime = spring_gettime();
 	gu->avgSimFrameTime = mix(gu->avgSimFrameTime, (lastSimFrameTime - lastFrameTime).toMilliSecsf(), 0.05f);
 	gu->avgSimFrameTime = std::max(gu->avgSimFrameTime, 0.001f);
@@ -1640,6 +1727,10 @@ void CGame::SimFrame() {
 	}
 	#endif
 
+	if (replaySnapshots != NULL) {
+		replaySnapshots->Update(gs->frameNum);
+	}
+
 	// usefull for desync-debugging enter (enter instead of -1 start & end frame of the range you want to debug)
 	DumpState(-1, -1, 1);
 
@@ -2159,6 +2250,71 @@ void CGame::SaveGame(const std::string& filename, bool overwrite)
 }
 
 
+void CGame::SeekReplay(int targetFrame)
+{
+	const int snapshotFrame = (replaySnapshots != NULL)? replaySnapshots->GetSnapshotFrame(targetFrame): -1;
+
+	// simulating onwards from the current frame beats restoring an older snapshot
+	const bool useSnapshot = (snapshotFrame >= 0) && !(snapshotFrame <= gs->frameNum && gs->frameNum <= targetFrame);
+
+	if (!useSnapshot && targetFrame < gs->frameNum) {
+		LOG_L(L_WARNING, "Cannot seek back to frame %d, there is no replay snapshot before it (see ReplaySnapshotInterval)", targetFrame);
+		return;
+	}
+
+	if (useSnapshot) {
+		CommandMessage pckt("seekdemo " + IntToString(snapshotFrame) + " " + IntToString(targetFrame), gu->myPlayerNum);
+		net->Send(pckt.Pack());
+	} else {
+		CommandMessage pckt("skip f" + IntToString(targetFrame), gu->myPlayerNum);
+		net->Send(pckt.Pack());
+	}
+}
+
+void CGame::RestoreReplaySnapshot(int frameNum)
+{
+	if (replaySnapshots == NULL) {
+		LOG_L(L_ERROR, "Cannot restore the replay snapshot of frame %d, snapshots are disabled", frameNum);
+		return;
+	}
+
+	if (!replaySnapshots->HasSnapshot(frameNum)) {
+		LOG_L(L_ERROR, "Cannot restore the replay snapshot of frame %d, there is none", frameNum);
+		return;
+	}
+
+	// the Lua handlers hold their own state about the abandoned timeline,
+	// they are shut down with it and started on the restored world anew
+	const bool reloadLuaUI = (luaUI != NULL);
+
+	GML_MSTMUTEX_DOUNLOCK(sim); // temporarily unlock this mutex to prevent a deadlock
+	{
+		GML_STDMUTEX_LOCK(draw); // the draw thread must not see the world while it is replaced
+
+		if (reloadLuaUI)
+			guihandler->RunLayoutCommand("disable");
+
+		ENTER_SYNCED_CODE();
+		CLuaGaia::FreeHandler();
+		CLuaRules::FreeHandler();
+
+		replaySnapshots->Restore(frameNum);
+
+		CLuaRules::LoadHandler();
+
+		if (gs->useLuaGaia)
+			CLuaGaia::LoadHandler();
+		LEAVE_SYNCED_CODE();
+
+		if (reloadLuaUI)
+			guihandler->RunLayoutCommand("enable");
+	}
+	GML_MSTMUTEX_DOLOCK(sim); // restore unlocked mutex
+
+	lastSimFrame = gs->frameNum;
+}
+
+
 void CGame::ReloadGame()
 {
 	if (saveFile) {
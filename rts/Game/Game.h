@@ -24,6 +24,7 @@ class IUnsyncedActionExecutor;
 class ChatMessage;
 class SkirmishAIData;
 class CWorldDrawer;
+class CReplaySnapshots;
 
 
 class CGame : public CGameController
@@ -57,6 +58,7 @@ public:
 	void GameEnd(const std::vector<unsigned char>& winningAllyTeams, bool timeout = false);
 
 private:
+	void PrefetchArchiveFiles();
 	void LoadMap(const std::string& mapName);
 	void LoadDefs();
 	void PreLoadSimulation();
@@ -96,6 +98,10 @@ public:
 	void StartSkip(int toFrame);
 	void EndSkip();
 
+	/// jump to <targetFrame> of the replay, through a snapshot if one helps
+	void SeekReplay(int targetFrame);
+	void RestoreReplaySnapshot(int frameNum);
+
 	void ParseInputTextGeometry(const std::string& geo);
 
 	void ReloadGame();
@@ -226,6 +232,9 @@ private:
 	/// for reloading the savefile
 	ILoadSaveHandler* saveFile;
 
+	/// for seeking in replays, NULL unless enabled
+	CReplaySnapshots* replaySnapshots;
+
 	volatile bool finishedLoading;
 	bool gameOver;
 };
@@ -41,6 +41,8 @@
 #include "System/Sound/SoundChannels.h"
 #include "System/Sync/SyncTracer.h"
 
+#include <limits>
+
 #define NUM_WAITING_DAMAGE_LISTS 128
 #define PLAY_SOUNDS 1
 
@@ -361,18 +363,20 @@ static inline void QueryUnits(TFilter filter, TQuery& query)
 {
 	GML_RECMUTEX_LOCK(qnum); // QueryUnits
 
-	const vector<int> &quads = quadField->GetQuads(query.pos, query.radius);
+	CScratchArena::Scope scope;
+
+	const ScratchSpan<int>& quads = quadField->GetQuads(scope, query.pos, query.radius);
 
 	const int tempNum = gs->tempNum++;
 
-	for (vector<int>::const_iterator qi = quads.begin(); qi != quads.end(); ++qi) {
+	for (const int* qi = quads.begin(); qi != quads.end(); ++qi) {
 		const CQuadField::Quad& quad = quadField->GetQuad(*qi);
 		for (int t = 0; t < teamHandler->ActiveAllyTeams(); ++t) {
 			if (!filter.Team(t)) {
 				continue;
 			}
-			std::list<CUnit*>::const_iterator ui;
-			const std::list<CUnit*>& allyTeamUnits = quad.teamUnits[t];
+			std::vector<CUnit*>::const_iterator ui;
+			const std::vector<CUnit*>& allyTeamUnits = quad.teamUnits[t];
 			for (ui = allyTeamUnits.begin(); ui != allyTeamUnits.end(); ++ui) {
 				if ((*ui)->tempNum != tempNum) {
 					(*ui)->tempNum = tempNum;
@@ -640,7 +644,7 @@ namespace {
 static int tempTargetUnits[MAX_UNITS] = {0};
 static int targetTempNum = 2;
 
-void CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* lastTargetUnit, std::multimap<float, CUnit*>& targets)
+ScratchSpan<CGameHelper::WeaponTarget> CGameHelper::GenerateWeaponTargets(CScratchArena::Scope& scope, const CWeapon* weapon, const CUnit* lastTargetUnit)
 {
 	const CUnit* attacker = weapon->owner;
 	const float radius    = weapon->range;
@@ -654,24 +658,36 @@ void CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* last
 	const float secDamage = weaponDef->damages.GetDefaultDamage() * weapon->salvoSize / weapon->reloadTime * GAME_SPEED;
 	const bool paralyzer  = (weaponDef->damages.paralyzeDamageTime != 0);
 
-	const std::vector<int>& quads = quadField->GetQuads(pos, radius + (aHeight - std::max(0.0f, readMap->GetInitMinHeight())) * heightMod);
+	const ScratchSpan<int>& quads = quadField->GetQuads(scope, pos, radius + (aHeight - std::max(0.0f, readMap->GetInitMinHeight())) * heightMod);
 
 	const int tempNum = targetTempNum++;
 
-	typedef std::vector<int>::const_iterator VectorIt;
-	typedef std::list<CUnit*>::const_iterator ListIt;
+	size_t maxCandidates = 0;
+
+	for (const int* qi = quads.begin(); qi != quads.end(); ++qi) {
+		for (int t = 0; t < teamHandler->ActiveAllyTeams(); ++t) {
+			if (teamHandler->Ally(attacker->allyteam, t)) {
+				continue;
+			}
+
+			maxCandidates += quadField->GetQuad(*qi).teamUnits[t].size();
+		}
+	}
+
+	// gather the candidates first; the Lua call-in below may create or
+	// destroy units, which would invalidate iterators into the quad cells
+	ScratchSpan<CUnit*> candidates = scope.Alloc<CUnit*>(maxCandidates);
 
-	for (VectorIt qi = quads.begin(); qi != quads.end(); ++qi) {
+	for (const int* qi = quads.begin(); qi != quads.end(); ++qi) {
 		for (int t = 0; t < teamHandler->ActiveAllyTeams(); ++t) {
 			if (teamHandler->Ally(attacker->allyteam, t)) {
 				continue;
 			}
 
-			const std::list<CUnit*>& allyTeamUnits = quadField->GetQuad(*qi).teamUnits[t];
+			const std::vector<CUnit*>& allyTeamUnits = quadField->GetQuad(*qi).teamUnits[t];
 
-			for (ListIt ui = allyTeamUnits.begin(); ui != allyTeamUnits.end(); ++ui) {
+			for (std::vector<CUnit*>::const_iterator ui = allyTeamUnits.begin(); ui != allyTeamUnits.end(); ++ui) {
 				CUnit* targetUnit = *ui;
-				float targetPriority = 1.0f;
 
 				if (!(targetUnit->category & weapon->onlyTargetCategory)) {
 					continue;
@@ -688,88 +704,110 @@ void CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* last
 				}
 
 				tempTargetUnits[targetUnit->id] = tempNum;
+				candidates.push_back(targetUnit);
+			}
+		}
+	}
 
-				if (targetUnit->IsUnderWater() && !weaponDef->waterweapon) {
-					continue;
-				}
-				if (targetUnit->isDead) {
-					continue;
-				}
+	ScratchSpan<WeaponTarget> targets = scope.Alloc<WeaponTarget>(candidates.size());
 
-				float3 targPos;
-				const unsigned short targetLOSState = targetUnit->losStatus[attacker->allyteam];
+	for (CUnit** ci = candidates.begin(); ci != candidates.end(); ++ci) {
+		CUnit* targetUnit = *ci;
+		float targetPriority = 1.0f;
 
-				if (targetLOSState & LOS_INLOS) {
-					targPos = targetUnit->aimPos;
-				} else if (targetLOSState & LOS_INRADAR) {
-					targPos = targetUnit->aimPos + (targetUnit->posErrorVector * radarHandler->GetAllyTeamRadarErrorSize(attacker->allyteam));
-					targetPriority *= 10.0f;
-				} else {
-					continue;
-				}
+		if (targetUnit->IsUnderWater() && !weaponDef->waterweapon) {
+			continue;
+		}
+		if (targetUnit->isDead) {
+			continue;
+		}
 
-				const float modRange = radius + (aHeight - targPos.y) * heightMod;
+		float3 targPos;
+		const unsigned short targetLOSState = targetUnit->losStatus[attacker->allyteam];
 
-				if ((pos - targPos).SqLength2D() > modRange * modRange) {
-					continue;
-				}
+		if (targetLOSState & LOS_INLOS) {
+			targPos = targetUnit->aimPos;
+		} else if (targetLOSState & LOS_INRADAR) {
+			targPos = targetUnit->aimPos + (targetUnit->posErrorVector * radarHandler->GetAllyTeamRadarErrorSize(attacker->allyteam));
+			targetPriority *= 10.0f;
+		} else {
+			continue;
+		}
 
-				const float dist2D = (pos - targPos).Length2D();
-				const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
-				const float damageMul = weaponDef->damages[targetUnit->armorType] * targetUnit->curArmorMultiple;
+		const float modRange = radius + (aHeight - targPos.y) * heightMod;
 
-				targetPriority *= rangeMul;
+		if ((pos - targPos).SqLength2D() > modRange * modRange) {
+			continue;
+		}
 
-				if (targetLOSState & LOS_INLOS) {
-					targetPriority *= (secDamage + targetUnit->health);
+		const float dist2D = (pos - targPos).Length2D();
+		const float rangeMul = (dist2D * weaponDef->proximityPriority + modRange * 0.4f + 100.0f);
+		const float damageMul = weaponDef->damages[targetUnit->armorType] * targetUnit->curArmorMultiple;
 
-					if (targetUnit == lastTargetUnit) {
-						targetPriority *= weapon->avoidTarget ? 10.0f : 0.4f;
-					}
+		targetPriority *= rangeMul;
 
-					if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health)) {
-						targetPriority *= 4.0f;
-					}
+		if (targetLOSState & LOS_INLOS) {
+			targetPriority *= (secDamage + targetUnit->health);
 
-					if (weapon->hasTargetWeight) {
-						targetPriority *= weapon->TargetWeight(targetUnit);
-					}
-				} else {
-					targetPriority *= (secDamage + 10000.0f);
-				}
+			if (targetUnit == lastTargetUnit) {
+				targetPriority *= weapon->avoidTarget ? 10.0f : 0.4f;
+			}
 
-				if (targetLOSState & LOS_PREVLOS) {
-					targetPriority /= (damageMul * targetUnit->power * (0.7f + gs->randFloat() * 0.6f));
+			if (paralyzer && targetUnit->paralyzeDamage > (modInfo.paralyzeOnMaxHealth? targetUnit->maxHealth: targetUnit->health)) {
+				targetPriority *= 4.0f;
+			}
 
-					if (targetUnit->category & weapon->badTargetCategory) {
-						targetPriority *= 100.0f;
-					}
-					if (targetUnit->IsCrashing()) {
-						targetPriority *= 1000.0f;
-					}
-				}
+			if (weapon->hasTargetWeight) {
+				targetPriority *= weapon->TargetWeight(targetUnit);
+			}
+		} else {
+			targetPriority *= (secDamage + 10000.0f);
+		}
 
-				if (luaRules != NULL) {
-					if (!luaRules->AllowWeaponTarget(attacker->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority)) {
-						continue;
-					}
-				}
+		if (targetLOSState & LOS_PREVLOS) {
+			targetPriority /= (damageMul * targetUnit->power * (0.7f + gs->randFloat() * 0.6f));
+
+			if (targetUnit->category & weapon->badTargetCategory) {
+				targetPriority *= 100.0f;
+			}
+			if (targetUnit->IsCrashing()) {
+				targetPriority *= 1000.0f;
+			}
+		}
 
-				targets.insert(std::pair<float, CUnit*>(targetPriority, targetUnit));
+		if (luaRules != NULL) {
+			if (!luaRules->AllowWeaponTarget(attacker->id, targetUnit->id, weapon->weaponNum, weaponDef->id, &targetPriority)) {
+				continue;
 			}
 		}
+
+		// NaN (e.g. returned by AllowWeaponTarget) does not order against
+		// anything, which makes std::sort undefined; rank such targets last
+		if (math::isnan(targetPriority)) {
+			targetPriority = std::numeric_limits<float>::max();
+		}
+
+		WeaponTarget target;
+		target.priority = targetPriority;
+		target.order = targets.size();
+		target.unit = targetUnit;
+		targets.push_back(target);
 	}
 
+	std::sort(targets.begin(), targets.end());
+
 #ifdef TRACE_SYNC
 	{
 		tracefile << "[GenerateWeaponTargets] attackerID, attackRadius: " << attacker->id << ", " << radius << " ";
 
-		for (std::multimap<float, CUnit*>::const_iterator ti = targets.begin(); ti != targets.end(); ++ti)
-			tracefile << "\tpriority: " << (ti->first) <<  ", targetID: " << (ti->second)->id <<  " ";
+		for (const WeaponTarget* ti = targets.begin(); ti != targets.end(); ++ti)
+			tracefile << "\tpriority: " << (ti->priority) <<  ", targetID: " << (ti->unit)->id <<  " ";
 
 		tracefile << "\n";
 	}
 #endif
+
+	return targets;
 }
 
 CUnit* CGameHelper::GetClosestUnit(const float3& pos, float searchRadius)
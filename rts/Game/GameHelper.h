@@ -9,6 +9,7 @@
 #include "System/float3.h"
 #include "System/type2.h"
 #include "System/MemPool.h"
+#include "System/Misc/ScratchArena.h"
 
 #include <list>
 #include <map>
@@ -117,7 +118,23 @@ public:
 	 */
 	static float3 ClosestBuildSite(int team, const UnitDef* unitDef, float3 pos, float searchRadius, int minDist, int facing = 0);
 
-	static void GenerateWeaponTargets(const CWeapon* weapon, const CUnit* lastTargetUnit, std::multimap<float, CUnit*>& targets);
+	struct WeaponTarget {
+		bool operator < (const WeaponTarget& t) const {
+			// <order> breaks ties so equal-priority targets keep their generation order
+			return ((priority < t.priority) || (priority == t.priority && order < t.order));
+		}
+
+		float priority;
+		unsigned int order;
+		CUnit* unit;
+	};
+
+	/**
+	 * Returns the potential targets of <weapon> sorted by INCREASING order
+	 * of priority (lower equals better); the result is allocated from the
+	 * scratch arena of <scope> and is valid for as long as <scope> lives.
+	 */
+	static ScratchSpan<WeaponTarget> GenerateWeaponTargets(CScratchArena::Scope& scope, const CWeapon* weapon, const CUnit* lastTargetUnit);
 
 	void Update();
 
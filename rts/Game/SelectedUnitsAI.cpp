@@ -12,6 +12,7 @@
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
+#include "Sim/Path/IPathManager.h"
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Units/CommandAI/CommandAI.h"
 #include "Sim/Units/Unit.h"
@@ -105,6 +106,9 @@ void CSelectedUnitsHandlerAI::GiveCommandNet(Command &c, int player)
 	const int nbrOfSelectedUnits = netSelected.size();
 	const int cmd_id = c.GetID();
 
+	// units ordered to the same goal can share their path searches
+	pathManager->BeginRequestBatch();
+
 	if (nbrOfSelectedUnits < 1) {
 		// no units to command
 	}
@@ -242,6 +246,8 @@ void CSelectedUnitsHandlerAI::GiveCommandNet(Command &c, int player)
 			}
 		}
 	}
+
+	pathManager->EndRequestBatch();
 }
 
 
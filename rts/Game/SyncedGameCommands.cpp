@@ -476,7 +476,14 @@ public:
 			"Fast-forwards to a given frame, or stops fast-forwarding") {}
 
 	bool Execute(const SyncedAction& action) const {
-		if (action.GetArgs().find_first_of("start") == 0) {
+		// must be checked first, "start" also matches any leading 'r'
+		if (action.GetArgs().compare(0, 8, "restore ") == 0) {
+			std::istringstream buf(action.GetArgs().substr(8));
+			int snapshotFrame;
+			buf >> snapshotFrame;
+			game->RestoreReplaySnapshot(snapshotFrame);
+		}
+		else if (action.GetArgs().find_first_of("start") == 0) {
 			std::istringstream buf(action.GetArgs().substr(6));
 			int targetFrame;
 			buf >> targetFrame;
@@ -198,7 +198,7 @@ float TraceRay(
 			for (int* quadPtr = begQuad; quadPtr != endQuad; ++quadPtr) {
 				const CQuadField::Quad& quad = quadField->GetQuad(*quadPtr);
 
-				for (std::list<CFeature*>::const_iterator ui = quad.features.begin(); ui != quad.features.end(); ++ui) {
+				for (std::vector<CFeature*>::const_iterator ui = quad.features.begin(); ui != quad.features.end(); ++ui) {
 					CFeature* f = *ui;
 
 					// NOTE:
@@ -226,7 +226,7 @@ float TraceRay(
 			for (int* quadPtr = begQuad; quadPtr != endQuad; ++quadPtr) {
 				const CQuadField::Quad& quad = quadField->GetQuad(*quadPtr);
 
-				for (std::list<CUnit*>::const_iterator ui = quad.units.begin(); ui != quad.units.end(); ++ui) {
+				for (std::vector<CUnit*>::const_iterator ui = quad.units.begin(); ui != quad.units.end(); ++ui) {
 					CUnit* u = *ui;
 
 					if (u == owner)
@@ -314,8 +314,8 @@ float GuiTraceRay(
 
 	quadField->GetQuadsOnRay(start, dir, length, begQuad, endQuad);
 
-	std::list<CUnit*>::const_iterator ui;
-	std::list<CFeature*>::const_iterator fi;
+	std::vector<CUnit*>::const_iterator ui;
+	std::vector<CFeature*>::const_iterator fi;
 
 	CollisionQuery cq;
 
@@ -439,8 +439,8 @@ bool TestCone(
 		const CQuadField::Quad& quad = quadField->GetQuad(*quadPtr);
 
 		if (!ignoreAllies) {
-			const std::list<CUnit*>& units = quad.teamUnits[allyteam];
-			      std::list<CUnit*>::const_iterator unitsIt;
+			const std::vector<CUnit*>& units = quad.teamUnits[allyteam];
+			      std::vector<CUnit*>::const_iterator unitsIt;
 
 			for (unitsIt = units.begin(); unitsIt != units.end(); ++unitsIt) {
 				const CUnit* u = *unitsIt;
@@ -456,8 +456,8 @@ bool TestCone(
 		}
 
 		if (!ignoreNeutrals) {
-			const std::list<CUnit*>& units = quad.units;
-			      std::list<CUnit*>::const_iterator unitsIt;
+			const std::vector<CUnit*>& units = quad.units;
+			      std::vector<CUnit*>::const_iterator unitsIt;
 
 			for (unitsIt = units.begin(); unitsIt != units.end(); ++unitsIt) {
 				const CUnit* u = *unitsIt;
@@ -475,8 +475,8 @@ bool TestCone(
 		}
 
 		if (!ignoreFeatures) {
-			const std::list<CFeature*>& features = quad.features;
-			      std::list<CFeature*>::const_iterator featuresIt;
+			const std::vector<CFeature*>& features = quad.features;
+			      std::vector<CFeature*>::const_iterator featuresIt;
 
 			for (featuresIt = features.begin(); featuresIt != features.end(); ++featuresIt) {
 				const CFeature* f = *featuresIt;
@@ -525,8 +525,8 @@ bool TestTrajectoryCone(
 
 		// friendly units in this quad
 		if (!ignoreAllies) {
-			const std::list<CUnit*>& units = quad.teamUnits[allyteam];
-			      std::list<CUnit*>::const_iterator unitsIt;
+			const std::vector<CUnit*>& units = quad.teamUnits[allyteam];
+			      std::vector<CUnit*>::const_iterator unitsIt;
 
 			for (unitsIt = units.begin(); unitsIt != units.end(); ++unitsIt) {
 				const CUnit* u = *unitsIt;
@@ -544,8 +544,8 @@ bool TestTrajectoryCone(
 
 		// neutral units in this quad
 		if (!ignoreNeutrals) {
-			const std::list<CUnit*>& units = quad.units;
-			      std::list<CUnit*>::const_iterator unitsIt;
+			const std::vector<CUnit*>& units = quad.units;
+			      std::vector<CUnit*>::const_iterator unitsIt;
 
 			for (unitsIt = units.begin(); unitsIt != units.end(); ++unitsIt) {
 				const CUnit* u = *unitsIt;
@@ -564,8 +564,8 @@ bool TestTrajectoryCone(
 
 		// features in this quad
 		if (!ignoreFeatures) {
-			const std::list<CFeature*>& features = quad.features;
-			      std::list<CFeature*>::const_iterator featuresIt;
+			const std::vector<CFeature*>& features = quad.features;
+			      std::vector<CFeature*>::const_iterator featuresIt;
 
 			for (featuresIt = features.begin(); featuresIt != features.end(); ++featuresIt) {
 				const CFeature* f = *featuresIt;
@@ -52,6 +52,7 @@
 #include "Rendering/VerticalSync.h"
 #include "Lua/LuaOpenGL.h"
 #include "Lua/LuaUI.h"
+#include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Units/Scripts/UnitScript.h"
 #include "Sim/Units/Groups/GroupHandler.h"
@@ -2868,6 +2869,19 @@ public:
 };
 
 
+class DebugLosActionExecutor : public IUnsyncedActionExecutor {
+public:
+	DebugLosActionExecutor(): IUnsyncedActionExecutor("DebugLos", "Enable/Disable per map-type profiling of LOS and radar updates (shown by /Debug)") {
+	}
+
+	bool Execute(const UnsyncedAction& action) const {
+		SetBoolArg(CLosHandler::debugTimers, action.GetArgs());
+		LogSystemStatus("LOS and radar update profiling", CLosHandler::debugTimers);
+		return true;
+	}
+};
+
+
 class DebugTraceRayDrawerActionExecutor : public IUnsyncedActionExecutor {
 public:
 	DebugTraceRayDrawerActionExecutor(): IUnsyncedActionExecutor("DebugTraceRay", "Enable/Disable drawing of traceray debug-data") {
@@ -3090,6 +3104,38 @@ public:
 
 
 
+class SeekActionExecutor : public IUnsyncedActionExecutor {
+public:
+	SeekActionExecutor() : IUnsyncedActionExecutor("Seek",
+			"Jumps forward or back in a replay to a given game-second (or frame, if prefixed with f; relative if prefixed with +/-)") {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		if (!gameSetup->hostDemo) {
+			LOG_L(L_WARNING, "/%s: only possible while watching a replay", GetCommand().c_str());
+			return true;
+		}
+
+		std::string timeStr = action.GetArgs();
+
+		const bool seekFrames = (!timeStr.empty() && timeStr[0] == 'f');
+		if (seekFrames)
+			timeStr.erase(0, 1);
+
+		const bool seekRelative = (!timeStr.empty() && (timeStr[0] == '+' || timeStr[0] == '-'));
+		const int amount = atoi(timeStr.c_str());
+
+		int targetFrame = seekFrames? amount: (amount * GAME_SPEED);
+
+		if (seekRelative)
+			targetFrame += gs->frameNum;
+
+		game->SeekReplay(std::max(0, targetFrame));
+		return true;
+	}
+};
+
+
+
 class ReloadShadersActionExecutor : public IUnsyncedActionExecutor {
 public:
 	ReloadShadersActionExecutor() : IUnsyncedActionExecutor("ReloadShaders",
@@ -3360,6 +3406,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new PauseActionExecutor());
 	AddActionExecutor(new DebugActionExecutor());
 	AddActionExecutor(new DebugColVolDrawerActionExecutor());
+	AddActionExecutor(new DebugLosActionExecutor());
 	AddActionExecutor(new DebugPathDrawerActionExecutor());
 	AddActionExecutor(new DebugTraceRayDrawerActionExecutor());
 	AddActionExecutor(new NoSoundActionExecutor());
@@ -3455,6 +3502,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new DumpStateActionExecutor());
 	AddActionExecutor(new SaveActionExecutor());
 	AddActionExecutor(new ReloadGameActionExecutor());
+	AddActionExecutor(new SeekActionExecutor());
 	AddActionExecutor(new ReloadShadersActionExecutor());
 	AddActionExecutor(new DebugInfoActionExecutor());
 
@@ -36,6 +36,7 @@
 #include "System/GlobalConfig.h"
 #include "System/Rectangle.h"
 #include "System/ScopedFPUSettings.h"
+#include "System/TimeProfiler.h"
 #include "System/Log/ILog.h"
 #include "System/Input/KeyInput.h"
 #include "System/FileSystem/FileHandler.h"
@@ -72,6 +73,10 @@ CLuaHandle::CLuaHandle(const string& _name, int _order, bool _userMode)
 	, userMode   (_userMode)
 	, killMe     (false)
 	, callinErrors(0)
+	, batchUnitDamaged(false)
+	, batchProjectileCreated(false)
+	, batchProjectileDestroyed(false)
+	, batchFrame(0)
 {
 	UpdateThreading();
 
@@ -672,6 +677,8 @@ void CLuaHandle::GameFrame(int frameNum)
 		DelayRecvFromSynced(L, 0); // Copy _G.EXPORT --> SYNCED.EXPORT once a game frame
 	luaL_checkstack(L, 4, __FUNCTION__);
 
+	RunBatchCallIns(L);
+
 	const LuaUtils::ScopedDebugTraceBack traceBack(L);
 
 	static const LuaHashString cmdStr("GameFrame");
@@ -1031,6 +1038,20 @@ void CLuaHandle::UnitDamaged(
 	bool paralyzer)
 {
 	LUA_UNIT_BATCH_PUSH(, LuaUnitDamagedEvent(unit, attacker, damage, weaponDefID, projectileID, paralyzer))
+
+	if (batchUnitDamaged) {
+		const UnitDamagedBatchEvent e = {
+			unit->id, unit->unitDef->id, unit->team, damage, paralyzer, weaponDefID, projectileID,
+			((attacker != NULL)? attacker->id: -1),
+			((attacker != NULL)? attacker->unitDef->id: -1),
+			((attacker != NULL)? attacker->team: -1),
+		};
+
+		batchFrame = gs->frameNum;
+		unitDamagedBatch.push_back(e);
+		return;
+	}
+
 	LUA_CALL_IN_CHECK(L);
 	luaL_checkstack(L, 11, __FUNCTION__);
 
@@ -1444,6 +1465,15 @@ void CLuaHandle::ProjectileCreated(const CProjectile* p)
 		return;
 
 	LUA_PROJ_BATCH_PUSH(, LuaProjCreatedEvent(p))
+
+	if (batchProjectileCreated) {
+		const ProjectileBatchEvent e = {p->id, ((owner != NULL)? owner->id: -1), ((wd != NULL)? wd->id: -1)};
+
+		batchFrame = gs->frameNum;
+		projectileCreatedBatch.push_back(e);
+		return;
+	}
+
 	LUA_CALL_IN_CHECK(L);
 	luaL_checkstack(L, 5, __FUNCTION__);
 
@@ -1477,6 +1507,13 @@ void CLuaHandle::ProjectileDestroyed(const CProjectile* p)
 	}
 
 	LUA_PROJ_BATCH_PUSH(, LuaProjDestroyedEvent(p))
+
+	if (batchProjectileDestroyed) {
+		batchFrame = gs->frameNum;
+		projectileDestroyedBatch.push_back(p->id);
+		return;
+	}
+
 	LUA_CALL_IN_CHECK(L);
 	luaL_checkstack(L, 4, __FUNCTION__);
 
@@ -1493,6 +1530,153 @@ void CLuaHandle::ProjectileDestroyed(const CProjectile* p)
 
 /******************************************************************************/
 
+bool CLuaHandle::HasBatchCallIn(lua_State* L, const string& name)
+{
+	// GameFrame delivers the batches
+	if (name == "GameFrame") {
+		return
+			HasCallIn(L, "UnitDamagedBatch") ||
+			HasCallIn(L, "ProjectileCreatedBatch") ||
+			HasCallIn(L, "ProjectileDestroyedBatch");
+	}
+
+	if (name == "UnitDamaged")
+		return (batchUnitDamaged = HasCallIn(L, "UnitDamagedBatch"));
+	if (name == "ProjectileCreated")
+		return (batchProjectileCreated = HasCallIn(L, "ProjectileCreatedBatch"));
+	if (name == "ProjectileDestroyed")
+		return (batchProjectileDestroyed = HasCallIn(L, "ProjectileDestroyedBatch"));
+
+	return false;
+}
+
+void CLuaHandle::UpdateBatchCallIns(const string& name)
+{
+	const string::size_type suffixPos = name.rfind("Batch");
+	const bool isBatchName = (suffixPos != string::npos) && ((suffixPos + 5) == name.size());
+	const string eventName = isBatchName? name.substr(0, suffixPos): name;
+
+	if (eventName == "UnitDamaged" || eventName == "ProjectileCreated" || eventName == "ProjectileDestroyed") {
+		// the event is wanted for either of its call-ins
+		if (WantsEvent(eventName)) {
+			eventHandler.InsertEvent(this, eventName);
+		} else {
+			eventHandler.RemoveEvent(this, eventName);
+		}
+	} else if (eventName != "GameFrame") {
+		return;
+	}
+
+	if (WantsEvent("GameFrame")) {
+		eventHandler.InsertEvent(this, "GameFrame");
+	}
+}
+
+
+// the value tables are kept in the registry and refilled every
+// frame, entries beyond the current count are left over from
+// earlier frames
+static bool PushBatchCallIn(lua_State* L, const LuaHashString& cmdStr, const LuaHashString& valuesStr, int frame, int count, int numValues)
+{
+	if (!cmdStr.GetGlobalFunc(L))
+		return false;
+
+	lua_pushnumber(L, frame);
+	lua_pushnumber(L, count);
+
+	valuesStr.Push(L);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_createtable(L, numValues, 0);
+		valuesStr.Push(L);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, LUA_REGISTRYINDEX);
+	}
+
+	return true;
+}
+
+void CLuaHandle::RunBatchCallIns(lua_State* L)
+{
+	if (unitDamagedBatch.empty() && projectileCreatedBatch.empty() && projectileDestroyedBatch.empty())
+		return;
+
+	SCOPED_TIMER("Lua::BatchCallIns");
+	luaL_checkstack(L, 6, __FUNCTION__);
+
+	const LuaUtils::ScopedDebugTraceBack traceBack(L);
+
+	if (!unitDamagedBatch.empty()) {
+		static const LuaHashString cmdStr("UnitDamagedBatch");
+		static const LuaHashString valuesStr("UnitDamagedBatchValues");
+
+		if (PushBatchCallIn(L, cmdStr, valuesStr, batchFrame, unitDamagedBatch.size(), unitDamagedBatch.size() * 10)) {
+			// weapon, projectile and attacker are hidden as in UnitDamaged
+			const bool fullRead = GetHandleFullRead(L);
+			int n = 1;
+
+			for (size_t i = 0; i < unitDamagedBatch.size(); i++) {
+				const UnitDamagedBatchEvent& e = unitDamagedBatch[i];
+
+				lua_pushnumber(L, e.unitID);        lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, e.unitDefID);     lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, e.unitTeam);      lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, e.damage);        lua_rawseti(L, -2, n++);
+				lua_pushboolean(L, e.paralyzer);    lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, fullRead? e.weaponDefID: -1);   lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, fullRead? e.projectileID: -1);  lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, fullRead? e.attackerID: -1);    lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, fullRead? e.attackerDefID: -1); lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, fullRead? e.attackerTeam: -1);  lua_rawseti(L, -2, n++);
+			}
+
+			RunCallInTraceback(cmdStr, 3, 0, traceBack.GetErrFuncIdx(), false);
+		}
+
+		unitDamagedBatch.clear();
+	}
+
+	if (!projectileCreatedBatch.empty()) {
+		static const LuaHashString cmdStr("ProjectileCreatedBatch");
+		static const LuaHashString valuesStr("ProjectileCreatedBatchValues");
+
+		if (PushBatchCallIn(L, cmdStr, valuesStr, batchFrame, projectileCreatedBatch.size(), projectileCreatedBatch.size() * 3)) {
+			int n = 1;
+
+			for (size_t i = 0; i < projectileCreatedBatch.size(); i++) {
+				const ProjectileBatchEvent& e = projectileCreatedBatch[i];
+
+				lua_pushnumber(L, e.projectileID); lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, e.ownerID);      lua_rawseti(L, -2, n++);
+				lua_pushnumber(L, e.weaponDefID);  lua_rawseti(L, -2, n++);
+			}
+
+			RunCallInTraceback(cmdStr, 3, 0, traceBack.GetErrFuncIdx(), false);
+		}
+
+		projectileCreatedBatch.clear();
+	}
+
+	if (!projectileDestroyedBatch.empty()) {
+		static const LuaHashString cmdStr("ProjectileDestroyedBatch");
+		static const LuaHashString valuesStr("ProjectileDestroyedBatchValues");
+
+		if (PushBatchCallIn(L, cmdStr, valuesStr, batchFrame, projectileDestroyedBatch.size(), projectileDestroyedBatch.size())) {
+			for (size_t i = 0; i < projectileDestroyedBatch.size(); i++) {
+				lua_pushnumber(L, projectileDestroyedBatch[i]); lua_rawseti(L, -2, i + 1);
+			}
+
+			RunCallInTraceback(cmdStr, 3, 0, traceBack.GetErrFuncIdx(), false);
+		}
+
+		projectileDestroyedBatch.clear();
+	}
+}
+
+/******************************************************************************/
+
 bool CLuaHandle::Explosion(int weaponDefID, int projectileID, const float3& pos, const CUnit* owner)
 {
 	// piece-projectile collision (*ALL* other
@@ -3060,7 +3244,10 @@ int CLuaHandle::CallOutSyncedUpdateCallIn(lua_State* L)
 	}
 
 	CLuaHandle* lh = GetHandle(L);
-	lh->SyncedUpdateCallIn(lh->GetActiveState(), luaL_checkstring(L, 1));
+	const string name = luaL_checkstring(L, 1);
+
+	lh->SyncedUpdateCallIn(lh->GetActiveState(), name);
+	lh->UpdateBatchCallIns(name);
 	return 0;
 }
 
@@ -3073,7 +3260,10 @@ int CLuaHandle::CallOutUnsyncedUpdateCallIn(lua_State* L)
 	}
 
 	CLuaHandle* lh = GetHandle(L);
-	lh->UnsyncedUpdateCallIn(lh->GetActiveState(), luaL_checkstring(L, 1));
+	const string name = luaL_checkstring(L, 1);
+
+	lh->UnsyncedUpdateCallIn(lh->GetActiveState(), name);
+	lh->UpdateBatchCallIns(name);
 	return 0;
 }
 
@@ -119,7 +119,7 @@ class CLuaHandle : public CEventClient
 				GML_DRCMUTEX_LOCK(lua); // WantsEvent
 
 				// ask our derived instance
-				if (HasCallIn(L, name))
+				if (HasBatchCallIn(L, name) || HasCallIn(L, name))
 					return true;
 			}
 			END_ITERATE_LUA_STATES();
@@ -360,6 +360,44 @@ class CLuaHandle : public CEventClient
 
 		int callinErrors;
 
+	protected: // batched call-ins
+		// per-event data of the call-ins that can instead be received
+		// once per frame as <Name>Batch(frame, count, values), where
+		// values is a flat array holding count events one after another
+		struct UnitDamagedBatchEvent {
+			int unitID;
+			int unitDefID;
+			int unitTeam;
+			float damage;
+			bool paralyzer;
+			int weaponDefID;
+			int projectileID;
+			int attackerID;
+			int attackerDefID;
+			int attackerTeam;
+		};
+		struct ProjectileBatchEvent {
+			int projectileID;
+			int ownerID;
+			int weaponDefID;
+		};
+
+		/// true if name is delivered through a batch call-in, refreshes batch*
+		bool HasBatchCallIn(lua_State* L, const string& name);
+		/// re-registers the event that a (batch) call-in belongs to
+		void UpdateBatchCallIns(const string& name);
+		/// delivers the batches gathered since the previous GameFrame
+		void RunBatchCallIns(lua_State* L);
+
+		bool batchUnitDamaged;
+		bool batchProjectileCreated;
+		bool batchProjectileDestroyed;
+
+		int batchFrame;
+		std::vector<UnitDamagedBatchEvent> unitDamagedBatch;
+		std::vector<ProjectileBatchEvent> projectileCreatedBatch;
+		std::vector<int> projectileDestroyedBatch;
+
 	public: // EventBatch
 		void ExecuteUnitEventBatch();
 		void ExecuteFeatEventBatch();
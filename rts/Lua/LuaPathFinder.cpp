@@ -56,6 +56,8 @@ bool LuaPathFinder::PushEntries(lua_State* L)
 	REGISTER_LUA_CFUNC(GetPathNodeCosts);
 	REGISTER_LUA_CFUNC(SetPathNodeCost);
 	REGISTER_LUA_CFUNC(GetPathNodeCost);
+	REGISTER_LUA_CFUNC(GetPathCacheStats);
+	REGISTER_LUA_CFUNC(GetPathEstimatorStats);
 
 	return true;
 }
@@ -368,5 +370,52 @@ int LuaPathFinder::GetPathNodeCost(lua_State* L)
 	return 1;
 }
 
+
+int LuaPathFinder::GetPathCacheStats(lua_State* L)
+{
+	// nil or negative for the totals over all MoveDefs
+	const int pathType = luaL_optint(L, 1, -1);
+
+	if (pathType >= int(moveDefHandler->GetNumMoveDefs())) {
+		luaL_error(L, "Invalid moveID passed to GetPathCacheStats");
+	}
+
+	// synced code may only see the synced caches
+	const bool synced = CLuaHandle::GetHandleSynced(L) || luaL_optboolean(L, 2, true);
+
+	IPathManager::PathCacheStats stats;
+
+	if (!pathManager->GetPathCacheStats(pathType, synced, stats)) {
+		return 0;
+	}
+
+	lua_pushnumber(L, stats.numHits);
+	lua_pushnumber(L, stats.numMisses);
+	lua_pushnumber(L, stats.numEvictions);
+	lua_pushnumber(L, stats.numExpirations);
+	return 4;
+}
+
+int LuaPathFinder::GetPathEstimatorStats(lua_State* L)
+{
+	// load times and thread counts differ between clients
+	if (CLuaHandle::GetHandleSynced(L))
+		return 0;
+
+	IPathManager::PathEstimatorStats stats;
+
+	if (!pathManager->GetPathEstimatorStats(luaL_optboolean(L, 1, false), stats)) {
+		return 0;
+	}
+
+	lua_pushnumber(L, stats.loadTime);
+	lua_pushnumber(L, stats.loadThreads);
+	lua_pushboolean(L, stats.cacheLoaded);
+	lua_pushnumber(L, stats.numUpdatedBlocks);
+	lua_pushnumber(L, stats.sumUpdateLatency);
+	lua_pushnumber(L, stats.maxUpdateLatency);
+	return 6;
+}
+
 /******************************************************************************/
 /******************************************************************************/
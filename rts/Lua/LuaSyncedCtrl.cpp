@@ -3512,6 +3512,7 @@ int LuaSyncedCtrl::SetMapSquareTerrainType(lua_State* L)
 	const int ntt = luaL_checkint(L, 3);
 
 	readMap->GetTypeMapSynced()[tz * gs->hmapx + tx] = std::max(0, std::min(ntt, (CMapInfo::NUM_TERRAIN_TYPES - 1)));
+	readMap->SyncedTypeMapChanged();
 	pathManager->TerrainChange(hx, hz,  hx + 1, hz + 1,  TERRAINCHANGE_SQUARE_TYPEMAP_INDEX);
 
 	lua_pushnumber(L, ott);
@@ -3544,6 +3545,8 @@ int LuaSyncedCtrl::SetTerrainTypeData(lua_State* L)
 		return 1;
 	}
 
+	readMap->SyncedTypeMapChanged();
+
 	/*
 	if (!mapDamage->disabled) {
 		CBasicMapDamage* bmd = dynamic_cast<CBasicMapDamage*>(mapDamage);
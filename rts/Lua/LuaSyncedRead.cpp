@@ -1579,10 +1579,31 @@ int LuaSyncedRead::GetAllUnits(lua_State* L)
 			lua_rawseti(L, -2, count++);
 		}
 	} else {
+		const int readAllyTeam = CLuaHandle::GetHandleReadAllyTeam(L);
+
 		lua_newtable(L);
-		for (uit = unitHandler->activeUnits.begin(); uit != unitHandler->activeUnits.end(); ++uit) {
-			if (IsUnitVisible(L, *uit)) {
-				lua_pushnumber(L, (*uit)->id);
+
+		if (readAllyTeam < 0)
+			return 1;
+
+		// our own units, then the others in LOS or radar (see IsUnitVisible)
+		for (int t = 0; t < teamHandler->ActiveTeams(); t++) {
+			if (teamHandler->AllyTeam(t) != readAllyTeam)
+				continue;
+
+			const CUnitSet& teamUnits = teamHandler->Team(t)->units;
+
+			for (CUnitSet::const_iterator it = teamUnits.begin(); it != teamUnits.end(); ++it) {
+				lua_pushnumber(L, (*it)->id);
+				lua_rawseti(L, -2, count++);
+			}
+		}
+
+		const CUnitSet& visibleUnits = losHandler->GetVisibleUnits(readAllyTeam);
+
+		for (CUnitSet::const_iterator it = visibleUnits.begin(); it != visibleUnits.end(); ++it) {
+			if ((*it)->allyteam != readAllyTeam) {
+				lua_pushnumber(L, (*it)->id);
 				lua_rawseti(L, -2, count++);
 			}
 		}
@@ -5022,6 +5043,20 @@ int LuaSyncedRead::Pos2BuildPos(lua_State* L)
 /******************************************************************************/
 /******************************************************************************/
 
+static void FlushLosMoveBatches(lua_State* L)
+{
+	// units moved in the current sim pass only update the LOS and radar
+	// maps at its end; synced queries must see their changes right away
+	// (unsynced ones must not flush, that would change what later synced
+	// readers within the pass see)
+	if (!CLuaHandle::GetHandleSynced(L))
+		return;
+
+	losHandler->FlushPendingUpdates();
+	radarHandler->FlushPendingUpdates();
+}
+
+
 static int GetEffectiveLosAllyTeam(lua_State* L, int arg)
 {
 	if (lua_isnoneornil(L, arg)) {
@@ -5053,6 +5088,8 @@ int LuaSyncedRead::GetPositionLosState(lua_State* L)
 
 	const int allyTeamID = GetEffectiveLosAllyTeam(L, 4);
 
+	FlushLosMoveBatches(L);
+
 	bool inLos    = false;
 	bool inRadar  = false;
 	bool inJammer = false;
@@ -5092,6 +5129,8 @@ int LuaSyncedRead::IsPosInLos(lua_State* L)
 
 	const int allyTeamID = GetEffectiveLosAllyTeam(L, 4);
 
+	FlushLosMoveBatches(L);
+
 	bool state = false;
 	if (allyTeamID >= 0) {
 		state = losHandler->InLos(pos, allyTeamID);
@@ -5118,6 +5157,8 @@ int LuaSyncedRead::IsPosInRadar(lua_State* L)
 
 	const int allyTeamID = GetEffectiveLosAllyTeam(L, 4);
 
+	FlushLosMoveBatches(L);
+
 	bool state = false;
 	if (allyTeamID >= 0) {
 		state = radarHandler->InRadar(pos, allyTeamID);
@@ -5144,6 +5185,8 @@ int LuaSyncedRead::IsPosInAirLos(lua_State* L)
 
 	const int allyTeamID = GetEffectiveLosAllyTeam(L, 4);
 
+	FlushLosMoveBatches(L);
+
 	bool state = false;
 	if (allyTeamID >= 0) {
 		state = losHandler->InAirLos(pos, allyTeamID);
@@ -38,6 +38,7 @@
 #include "Sim/Features/Feature.h"
 #include "Sim/Features/FeatureDef.h"
 #include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/LosHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Units/Unit.h"
@@ -55,6 +56,8 @@
 #include "System/LoadSave/DemoReader.h"
 #include "System/Log/DefaultFilter.h"
 #include "System/Sound/SoundChannels.h"
+#include "System/Misc/HeapAllocCounter.h"
+#include "System/Misc/ScratchArena.h"
 #include "System/Misc/SpringTime.h"
 
 #if !defined(HEADLESS) && !defined(NO_SOUND)
@@ -158,6 +161,8 @@ bool LuaUnsyncedRead::PushEntries(lua_State* L)
 	// moved from LuaUI
 
 	REGISTER_LUA_CFUNC(GetFPS);
+	REGISTER_LUA_CFUNC(GetScratchArenaStats);
+	REGISTER_LUA_CFUNC(GetSimFrameHeapAllocs);
 
 	REGISTER_LUA_CFUNC(GetActiveCommand);
 	REGISTER_LUA_CFUNC(GetDefaultCommand);
@@ -673,7 +678,7 @@ enum UnitAllegiance {
 // never instantiated directly
 template<class T> class CWorldObjectQuadDrawer: public CReadMap::IQuadDrawer {
 public:
-	typedef std::list<T*> ObjectList;
+	typedef std::vector<T*> ObjectList;
 	typedef std::vector< const ObjectList* > ObjectVector;
 
 	void Reset() {
@@ -697,7 +702,7 @@ public:
 	}
 
 protected:
-	// note: stores pointers to lists, not copies
+	// note: stores pointers to cells, not copies
 	// its size equals the number of visible quads
 	ObjectVector objectLists;
 
@@ -788,6 +793,9 @@ int LuaUnsyncedRead::GetVisibleUnits(lua_State* L)
 
 	unsigned int count = 0;
 
+	// the visible set of allyTeamID is not split by team
+	bool filterVisibleSet = false;
+
 	{
 		GML_RECMUTEX_LOCK(quad); // GetVisibleUnits
 
@@ -803,9 +811,17 @@ int LuaUnsyncedRead::GetVisibleUnits(lua_State* L)
 		//
 		// FIXME? one-third != "nearly all"
 		//
-		if (unitQuadIter.GetObjectCount() > unitHandler->activeUnits.size() / 3) {
+		// only the units in LOS of allyTeamID can pass the test below,
+		// those are known without looking at all of them
+		const bool useVisibleSet = (allyTeamID >= 0 && (teamID == AllUnits || teamID == AllyUnits || teamID == EnemyUnits));
+		const size_t numCandidates = useVisibleSet? losHandler->GetVisibleUnits(allyTeamID).size(): unitHandler->activeUnits.size();
+
+		if (unitQuadIter.GetObjectCount() > numCandidates / 3) {
 			if (teamID >= 0) {
 				unitSets.push_back(&teamHandler->Team(teamID)->units);
+			} else if (useVisibleSet) {
+				filterVisibleSet = (teamID != AllUnits);
+				unitSets.push_back(&losHandler->GetVisibleUnits(allyTeamID));
 			} else {
 				for (int t = 0; t < teamHandler->ActiveTeams(); t++) {
 					if ((teamID == AllUnits) ||
@@ -856,6 +872,9 @@ int LuaUnsyncedRead::GetVisibleUnits(lua_State* L)
 			if (allyTeamID >= 0 && !(unit->losStatus[allyTeamID] & LOS_INLOS))
 				continue;
 
+			if (filterVisibleSet && ((teamID == AllyUnits) != (allyTeamID == unit->allyteam)))
+				continue;
+
 			if (noIcons) {
 				const float sqDist = (unit->pos - camera->GetPos()).SqLength();
 				const float iconDistSqrMult = unit->unitDef->iconType->GetDistanceSqr();
@@ -1772,6 +1791,30 @@ int LuaUnsyncedRead::GetFPS(lua_State* L)
 }
 
 
+int LuaUnsyncedRead::GetScratchArenaStats(lua_State* L)
+{
+	CheckNoArgs(L, __FUNCTION__);
+	// heap allocations made by the per-thread query arenas (QuadField
+	// queries, weapon targeting); these stop growing once every thread
+	// has reached its high-water mark
+	lua_pushnumber(L, CScratchArena::GetNumHeapAllocs());
+	lua_pushnumber(L, CScratchArena::GetNumHeapBytes());
+	return 2;
+}
+
+
+int LuaUnsyncedRead::GetSimFrameHeapAllocs(lua_State* L)
+{
+	CheckNoArgs(L, __FUNCTION__);
+	// only counted by builds configured with COUNT_HEAP_ALLOCS
+	if (!HeapAllocCounter::IsEnabled())
+		return 0;
+
+	lua_pushnumber(L, HeapAllocCounter::GetNumSimFrameAllocs());
+	return 1;
+}
+
+
 /******************************************************************************/
 
 int LuaUnsyncedRead::GetActiveCommand(lua_State* L)
@@ -89,6 +89,8 @@ class LuaUnsyncedRead {
 
 		// moved from LuaUI
 		static int GetFPS(lua_State* L);
+		static int GetScratchArenaStats(lua_State* L);
+		static int GetSimFrameHeapAllocs(lua_State* L);
 
 		static int GetMouseState(lua_State* L);
 		static int GetMouseCursor(lua_State* L);
@@ -278,9 +278,9 @@ void CBasicMapDamage::UpdateLos()
 		}
 
 		RelosSquare* rs = &relosQue.front();
-		const std::list<CUnit*>& units = quadField->GetQuadAt(rs->x, rs->y).units;
+		const std::vector<CUnit*>& units = quadField->GetQuadAt(rs->x, rs->y).units;
 
-		std::list<CUnit*>::const_iterator ui;
+		std::vector<CUnit*>::const_iterator ui;
 		for (ui = units.begin(); ui != units.end(); ++ui) {
 			relosUnits.push_back((*ui)->id);
 		}
@@ -290,9 +290,12 @@ void CBasicMapDamage::UpdateLos()
 		relosQue.pop_front();
 	}
 
+	// nothing reads LOS in this loop, so the updates can be batched
+	losHandler->BeginMoveBatch();
+
 	for (int a = 0; a < updateSpeed; ++a) {
 		if (relosUnits.empty()) {
-			return;
+			break;
 		}
 
 		CUnit* unit = unitHandler->units[relosUnits.front()];
@@ -305,4 +308,6 @@ void CBasicMapDamage::UpdateLos()
 		// FIXME: why only losHandler and not also radarHandler?
 		losHandler->MoveUnit(unit, true);
 	}
+
+	losHandler->EndMoveBatch();
 }
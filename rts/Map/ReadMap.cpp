@@ -11,6 +11,8 @@
 #include "SMF/SMFReadMap.h"
 #include "lib/gml/gmlmut.h"
 #include "Game/LoadScreen.h"
+#include "Sim/Misc/LosHandler.h"
+#include "Sim/Misc/RadarHandler.h"
 #include "System/bitops.h"
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
@@ -24,7 +26,6 @@
 
 #ifdef USE_UNSYNCED_HEIGHTMAP
 #include "Game/GlobalUnsynced.h"
-#include "Sim/Misc/LosHandler.h"
 #endif
 
 //////////////////////////////////////////////////////////////////////
@@ -50,6 +51,8 @@ CR_REG_METADATA(CReadMap, (
 	CR_IGNORED(currMinHeight),
 	CR_IGNORED(currMaxHeight),
 	CR_MEMBER(mapChecksum),
+	CR_IGNORED(syncedHeightMapRevision),
+	CR_IGNORED(syncedTypeMapRevision),
 	//CR_MEMBER(heightMapSyncedPtr),
 	//CR_MEMBER(heightMapUnsyncedPtr),
 	CR_MEMBER(originalHeightMap),
@@ -132,6 +135,8 @@ CReadMap::CReadMap()
 	, heightMapSyncedPtr(NULL)
 	, heightMapUnsyncedPtr(NULL)
 	, mapChecksum(0)
+	, syncedHeightMapRevision(0)
+	, syncedTypeMapRevision(0)
 	, initMinHeight(0.0f)
 	, initMaxHeight(0.0f)
 	, currMinHeight(0.0f)
@@ -326,6 +331,15 @@ void CReadMap::UpdateHeightMapSynced(SRectangle rect, bool initialize)
 	rect.x2 = std::min(gs->mapxm1, rect.x2 + 1);
 	rect.z2 = std::min(gs->mapym1, rect.z2 + 1);
 
+	syncedHeightMapRevision += 1;
+
+	// ray-casts queued by a move batch must see the terrain as it was when
+	// they were queued (the handlers do not exist yet during map loading)
+	if (losHandler != NULL)
+		losHandler->FlushPendingUpdates();
+	if (radarHandler != NULL)
+		radarHandler->FlushPendingUpdates();
+
 	UpdateCenterHeightmap(rect, initialize);
 	UpdateMipHeightmaps(rect, initialize);
 	UpdateFaceNormals(rect, initialize);
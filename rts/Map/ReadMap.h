@@ -164,6 +164,11 @@ public:
 	bool HasOnlyVoidWater() const;
 
 	unsigned int GetMapChecksum() const { return mapChecksum; }
+	/// changes whenever the synced heightmap (or data derived from it) is modified
+	unsigned int GetSyncedHeightMapRevision() const { return syncedHeightMapRevision; }
+	/// changes whenever the synced typemap or the terrain-type speeds are modified
+	unsigned int GetSyncedTypeMapRevision() const { return syncedTypeMapRevision; }
+	void SyncedTypeMapChanged() { syncedTypeMapRevision += 1; }
 
 private:
 	void UpdateCenterHeightmap(const SRectangle& rect, bool initialize);
@@ -228,6 +233,8 @@ private:
 #endif
 
 	unsigned int mapChecksum;
+	unsigned int syncedHeightMapRevision;
+	unsigned int syncedTypeMapRevision;
 
 	float initMinHeight, initMaxHeight; //< initial minimum- and maximum-height (before any deformations)
 	float currMinHeight, currMaxHeight; //< current minimum- and maximum-height
@@ -244,6 +251,8 @@ inline float CReadMap::SetHeight(const int idx, const float h, const int add) {
 	// add=1 <--> x = x*1 + h = x+h
 	x = x * add + h;
 
+	syncedHeightMapRevision += 1;
+
 	currMinHeight = std::min(x, currMinHeight);
 	currMaxHeight = std::max(x, currMaxHeight);
 
@@ -129,7 +129,7 @@ const std::string SERVER_COMMANDS[] = {
 	"setminspeed", "setmaxspeed",
 	"nopause", "nohelp", "cheat", "godmode", "globallos",
 	"nocost", "forcestart", "nospectatorchat", "nospecdraw",
-	"skip", "reloadcob", "reloadcegs", "devlua", "editdefs",
+	"skip", "seekdemo", "reloadcob", "reloadcegs", "devlua", "editdefs",
 	"singlestep", "spec", "specbynum"
 };
 
@@ -418,6 +418,14 @@ void CGameServer::SkipTo(int targetFrameNum)
 	if (serverFrameNum >= targetFrameNum) { return; }
 	if (demoReader == NULL) { return; }
 
+	// the demo's keyframe index knows where the stream ends, so
+	// skipping past that stops at its last frame (-1 if unknown)
+	const int numDemoFrames = demoReader->GetNumFrames();
+
+	if (numDemoFrames >= 0)
+		targetFrameNum = std::min(targetFrameNum, numDemoFrames);
+	if (serverFrameNum >= targetFrameNum) { return; }
+
 	CommandMessage startMsg(str(format("skip start %d") %targetFrameNum), SERVER_PLAYER);
 	CommandMessage endMsg("skip end", SERVER_PLAYER);
 	Broadcast(boost::shared_ptr<const netcode::RawPacket>(startMsg.Pack()));
@@ -447,6 +455,55 @@ void CGameServer::SkipTo(int targetFrameNum)
 	isPaused = wasPaused;
 }
 
+bool CGameServer::SeekDemo(int frameNum)
+{
+	if (!gameHasStarted) { return false; }
+	if (demoReader == NULL) { return false; }
+
+	int demoFrameNum = demoReader->SeekToFrame(frameNum);
+
+	if (demoFrameNum < 0) {
+		Message(str(format("Cannot seek to frame %d, the demo has no keyframe index") %frameNum), false);
+		return false;
+	}
+
+	// the block starts with the frame packet of <demoFrameNum + 1>, discard
+	// everything up to and including the one of <frameNum>; what follows it
+	// are the commands the clients executed after that frame
+	float packetTime = demoReader->GetModGameTime() + demoReader->GetDemoTimeOffset();
+	netcode::RawPacket* buf = NULL;
+
+	while (demoFrameNum < frameNum) {
+		packetTime = demoReader->GetModGameTime() + demoReader->GetDemoTimeOffset();
+
+		if ((buf = demoReader->GetData(packetTime)) == NULL)
+			break;
+
+		if (buf->length > 0 && (buf->data[0] == NETMSG_NEWFRAME || buf->data[0] == NETMSG_KEYFRAME))
+			demoFrameNum++;
+
+		delete buf;
+	}
+
+	if (demoFrameNum != frameNum) {
+		Message(str(format("Cannot seek to frame %d, the demo ends at frame %d") %frameNum %demoFrameNum), false);
+		return false;
+	}
+
+	// sync responses of the abandoned timeline are meaningless now
+	outstandingSyncFrames.clear();
+
+	for (std::vector<GameParticipant>::iterator it = players.begin(); it != players.end(); ++it) {
+		it->syncResponse.clear();
+	}
+
+	PostLoad(frameNum);
+
+	modGameTime = packetTime;
+	lastUpdate = spring_gettime();
+	return true;
+}
+
 std::string CGameServer::GetPlayerNames(const std::vector<int>& indices) const
 {
 	std::string playerstring;
@@ -2253,6 +2310,31 @@ void CGameServer::PushAction(const Action& action, bool fromAutoHost)
 			SkipTo(endFrame);
 		}
 	}
+	else if (action.command == "seekdemo") {
+		// only sent by CGame::SeekReplay, as "seekdemo <snapshotFrame> <targetFrame>"
+		if (demoReader) {
+			std::istringstream buf(action.extra);
+			int snapshotFrame = -1;
+			int targetFrame = -1;
+			buf >> snapshotFrame >> targetFrame;
+
+			// remote spectators have no snapshots (or different ones) to restore
+			bool haveRemotePlayers = false;
+
+			for (std::vector<GameParticipant>::const_iterator it = players.begin(); it != players.end(); ++it) {
+				haveRemotePlayers |= (!it->isLocal && it->myState == GameParticipant::CONNECTED);
+			}
+
+			if (haveRemotePlayers) {
+				Message("Seeking is not possible while other clients watch the demo, use /skip instead", false);
+			} else if (snapshotFrame >= 0 && SeekDemo(snapshotFrame)) {
+				CommandMessage restoreMsg(str(format("skip restore %d") %snapshotFrame), SERVER_PLAYER);
+				Broadcast(boost::shared_ptr<const netcode::RawPacket>(restoreMsg.Pack()));
+
+				SkipTo(targetFrame);
+			}
+		}
+	}
 	else if (action.command == "cheat") {
 		SetBoolArg(cheating, action.extra);
 		CommandMessage msg(action, SERVER_PLAYER);
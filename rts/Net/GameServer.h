@@ -157,6 +157,16 @@ private:
 	 */
 	void SkipTo(int targetFrameNum);
 
+	/**
+	 * @brief rewind or fast-forward the demo stream without sending it
+	 *
+	 * Positions the demo right behind the frame packet of <frameNum>, the
+	 * frame at which the local client took the replay snapshot it is told
+	 * to restore (see CReplaySnapshots). Returns false if the demo has no
+	 * keyframe index or ends before <frameNum>.
+	 */
+	bool SeekDemo(int frameNum);
+
 	void Message(const std::string& message, bool broadcast = true);
 	void PrivateMessage(int playerNum, const std::string& message);
 
@@ -11,6 +11,8 @@
 #include "Rendering/ProjectileDrawer.h"
 #include "Sim/Projectiles/ProjectileHandler.h"
 
+CSlabMemPool groundFlashMemPool("GroundFlashes");
+
 CR_BIND_DERIVED(CGroundFlash, CExpGenSpawnable, );
 CR_REG_METADATA(CGroundFlash, (
  	CR_MEMBER_BEGINFLAG(CM_Config),
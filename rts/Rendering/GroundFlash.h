@@ -4,12 +4,15 @@
 #define GROUND_FLASH_H
 
 #include "Sim/Projectiles/ExplosionGenerator.h"
+#include "System/SlabMemPool.h"
 
 struct AtlasedTexture;
 struct GroundFXTexture;
 class CColorMap;
 class CVertexArray;
 
+extern CSlabMemPool groundFlashMemPool;
+
 class CGroundFlash : public CExpGenSpawnable
 {
 public:
@@ -18,6 +21,10 @@ public:
 	CGroundFlash(const float3& p);
 	CGroundFlash();
 	virtual ~CGroundFlash() {}
+
+	static void* operator new(size_t size) { return groundFlashMemPool.Alloc(size); }
+	static void operator delete(void* p, size_t size) { groundFlashMemPool.Free(p, size); }
+
 	virtual void Draw() {}
 	/// @return false when it should be deleted
 	virtual bool Update() { return false; }
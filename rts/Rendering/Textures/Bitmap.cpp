@@ -246,8 +246,15 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 		return false;
 	}
 
-	unsigned char* buffer = new unsigned char[file.FileSize() + 2];
-	file.Read(buffer, file.FileSize());
+	// files from archives are decoded in place, others are read first
+	unsigned char* buffer = NULL;
+	const void* fileData = file.GetFileView().GetData();
+
+	if (fileData == NULL) {
+		buffer = new unsigned char[file.FileSize() + 2];
+		file.Read(buffer, file.FileSize());
+		fileData = buffer;
+	}
 
 	boost::mutex::scoped_lock lck(devilMutex);
 	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
@@ -261,7 +268,7 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 		// do not signal floating point exceptions in devil library
 		ScopedDisableFpuExceptions fe;
 
-		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, buffer, file.FileSize());
+		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, fileData, file.FileSize());
 		ilDisable(IL_ORIGIN_SET);
 		delete[] buffer;
 
@@ -274,7 +281,6 @@ bool CBitmap::Load(std::string const& filename, unsigned char defaultAlpha)
 	{
 		if (!IsValidImageFormat(ilGetInteger(IL_IMAGE_FORMAT))) {
 			LOG_L(L_ERROR, "Invalid image format for %s: %d", filename.c_str(), ilGetInteger(IL_IMAGE_FORMAT));
-			delete[] buffer;
 			return false;
 		}
 	}
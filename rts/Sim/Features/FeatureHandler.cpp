@@ -432,6 +432,51 @@ CFeature* CFeatureHandler::CreateWreckage(
 
 
 
+void CFeatureHandler::DeleteScheduledFeatures()
+{
+	if (toBeRemoved.empty())
+		return;
+
+	GML_RECMUTEX_LOCK(obj); // DeleteScheduledFeatures
+	eventHandler.DeleteSyncedObjects();
+
+	GML_RECMUTEX_LOCK(feat); // DeleteScheduledFeatures
+	eventHandler.DeleteSyncedFeatures();
+
+	GML_RECMUTEX_LOCK(quad); // DeleteScheduledFeatures
+
+	while (!toBeRemoved.empty()) {
+		CFeature* feature = GetFeature(toBeRemoved.back());
+		toBeRemoved.pop_back();
+
+		if (feature) {
+			toBeFreedFeatureIDs.push_back(feature->id);
+			activeFeatures.erase(feature);
+			features[feature->id] = NULL;
+
+			CSolidObject::SetDeletingRefID(feature->id + unitHandler->MaxUnits());
+			// destructor removes feature from update-queue
+			delete feature;
+			CSolidObject::SetDeletingRefID(-1);
+		}
+	}
+}
+
+void CFeatureHandler::DeleteAllFeatures()
+{
+	GML_STDMUTEX_LOCK(rfeat); // DeleteAllFeatures
+
+	// flush the features that are already scheduled first, so none is queued twice
+	DeleteScheduledFeatures();
+
+	for (CFeatureSet::const_iterator fi = activeFeatures.begin(); fi != activeFeatures.end(); ++fi) {
+		DeleteFeature(*fi);
+	}
+
+	DeleteScheduledFeatures();
+}
+
+
 void CFeatureHandler::Update()
 {
 	SCOPED_TIMER("FeatureHandler::Update");
@@ -454,32 +499,7 @@ void CFeatureHandler::Update()
 	{
 		GML_STDMUTEX_LOCK(rfeat); // Update
 
-		if (!toBeRemoved.empty()) {
-
-			GML_RECMUTEX_LOCK(obj); // Update
-			eventHandler.DeleteSyncedObjects();
-
-			GML_RECMUTEX_LOCK(feat); // Update
-			eventHandler.DeleteSyncedFeatures();
-
-			GML_RECMUTEX_LOCK(quad); // Update
-
-			while (!toBeRemoved.empty()) {
-				CFeature* feature = GetFeature(toBeRemoved.back());
-				toBeRemoved.pop_back();
-
-				if (feature) {
-					toBeFreedFeatureIDs.push_back(feature->id);
-					activeFeatures.erase(feature);
-					features[feature->id] = NULL;
-
-					CSolidObject::SetDeletingRefID(feature->id + unitHandler->MaxUnits());
-					// destructor removes feature from update-queue
-					delete feature;
-					CSolidObject::SetDeletingRefID(-1);
-				}
-			}
-		}
+		DeleteScheduledFeatures();
 
 		eventHandler.UpdateFeatures();
 	}
@@ -530,8 +550,8 @@ void CFeatureHandler::TerrainChanged(int x1, int y1, int x2, int y2)
 	);
 
 	for (std::vector<int>::const_iterator qi = quads.begin(); qi != quads.end(); ++qi) {
-		std::list<CFeature*>::const_iterator fi;
-		const std::list<CFeature*>& features = quadField->GetQuad(*qi).features;
+		std::vector<CFeature*>::const_iterator fi;
+		const std::vector<CFeature*>& features = quadField->GetQuad(*qi).features;
 
 		for (fi = features.begin(); fi != features.end(); ++fi) {
 			CFeature* feature = *fi;
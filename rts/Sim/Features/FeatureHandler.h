@@ -50,6 +50,8 @@ public:
 
 	bool AddFeature(CFeature* feature);
 	void DeleteFeature(CFeature* feature);
+	/// removes every feature right away
+	void DeleteAllFeatures();
 	CFeature* GetFeature(int id);
 
 	void LoadFeaturesFromMap(bool onlyCreateDefs);
@@ -78,6 +80,7 @@ private:
 	bool NeedAllocateNewFeatureIDs(const CFeature* feature) const;
 	void AllocateNewFeatureIDs(const CFeature* feature);
 	void InsertActiveFeature(CFeature* feature);
+	void DeleteScheduledFeatures();
 
 	FeatureDef* CreateDefaultTreeFeatureDef(const std::string& name) const;
 	FeatureDef* CreateDefaultGeoFeatureDef(const std::string& name) const;
@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <assert.h>
 
 #include "GroundBlockingObjectMap.h"
@@ -10,13 +11,25 @@
 #include "Sim/Objects/SolidObjectDef.h"
 #include "Sim/Path/IPathManager.h"
 #include "System/creg/STL_Map.h"
+#include "System/Log/ILog.h"
 #include "lib/gml/gmlmut.h"
 
 CGroundBlockingObjectMap* groundBlockingObjectMap;
 
 CR_BIND(CGroundBlockingObjectMap, (1))
 CR_REG_METADATA(CGroundBlockingObjectMap, (
-	CR_MEMBER(groundBlockingMap)
+	CR_MEMBER(cells),
+	CR_MEMBER(squareFlags),
+	CR_MEMBER(overflowEntries),
+	CR_MEMBER(freeOverflowChunks)
+));
+
+CR_BIND(CGroundBlockingObjectMap::Cell, )
+CR_REG_METADATA_SUB(CGroundBlockingObjectMap, Cell, (
+	CR_MEMBER(inlineEntry),
+	CR_MEMBER(count),
+	CR_MEMBER(sizeClass),
+	CR_MEMBER(overflowIdx)
 ));
 
 
@@ -30,6 +43,185 @@ inline static const int GetObjectID(CSolidObject* obj)
 }
 
 
+CGroundBlockingObjectMap::CGroundBlockingObjectMap(int numSquares)
+{
+	cells.resize(numSquares);
+	squareFlags.resize(numSquares, 0);
+
+	if (numSquares > 1) {
+		LOG("[%s] %d squares, %.2f MB (%u bytes per square)",
+			__FUNCTION__, numSquares, GetMemoryFootprint() / (1024.0f * 1024.0f),
+			unsigned(sizeof(Cell) + sizeof(unsigned char)));
+	}
+}
+
+
+size_t CGroundBlockingObjectMap::GetMemoryFootprint() const
+{
+	size_t numBytes = 0;
+
+	numBytes += (cells.capacity() * sizeof(Cell));
+	numBytes += (squareFlags.capacity() * sizeof(unsigned char));
+	numBytes += (overflowEntries.capacity() * sizeof(BlockingMapEntry));
+
+	for (size_t n = 0; n < freeOverflowChunks.size(); n++) {
+		numBytes += (freeOverflowChunks[n].capacity() * sizeof(unsigned int));
+	}
+
+	return numBytes;
+}
+
+
+unsigned int CGroundBlockingObjectMap::AllocOverflowChunk(unsigned int sizeClass)
+{
+	if (sizeClass >= freeOverflowChunks.size())
+		freeOverflowChunks.resize(sizeClass + 1);
+
+	std::vector<unsigned int>& freeChunks = freeOverflowChunks[sizeClass];
+
+	if (!freeChunks.empty()) {
+		const unsigned int chunkIdx = freeChunks.back();
+		freeChunks.pop_back();
+		return chunkIdx;
+	}
+
+	const unsigned int chunkIdx = overflowEntries.size();
+	overflowEntries.resize(chunkIdx + (1 << sizeClass));
+	return chunkIdx;
+}
+
+void CGroundBlockingObjectMap::FreeOverflowChunk(unsigned int chunkIdx, unsigned int sizeClass)
+{
+	assert(sizeClass < freeOverflowChunks.size());
+	freeOverflowChunks[sizeClass].push_back(chunkIdx);
+}
+
+
+void CGroundBlockingObjectMap::InsertObject(int mapSquare, int objID, CSolidObject* object)
+{
+	Cell& cell = cells[mapSquare];
+
+	if (cell.count == 0) {
+		cell.inlineEntry = BlockingMapEntry(objID, object);
+		cell.count = 1;
+		UpdateSquareFlags(mapSquare);
+		return;
+	}
+
+	if (cell.count == 1) {
+		if (cell.inlineEntry.first == objID) {
+			cell.inlineEntry.second = object;
+			return;
+		}
+
+		// spill the inline entry into the smallest overflow chunk
+		const BlockingMapEntry inlineEntry = cell.inlineEntry;
+
+		cell.sizeClass = 1;
+		cell.overflowIdx = AllocOverflowChunk(cell.sizeClass);
+		cell.inlineEntry = BlockingMapEntry(-1, NULL);
+		overflowEntries[cell.overflowIdx] = inlineEntry;
+	} else {
+		BlockingMapEntry* entries = &overflowEntries[cell.overflowIdx];
+
+		for (unsigned int n = 0; n < cell.count; n++) {
+			if (entries[n].first == objID) {
+				entries[n].second = object;
+				return;
+			}
+		}
+
+		if (cell.count == (1 << cell.sizeClass)) {
+			// chunk is full, move to one twice as large
+			const unsigned int oldChunkIdx = cell.overflowIdx;
+			const unsigned int oldSizeClass = cell.sizeClass;
+
+			cell.sizeClass += 1;
+			cell.overflowIdx = AllocOverflowChunk(cell.sizeClass);
+
+			std::copy(
+				overflowEntries.begin() + oldChunkIdx,
+				overflowEntries.begin() + oldChunkIdx + cell.count,
+				overflowEntries.begin() + cell.overflowIdx
+			);
+
+			FreeOverflowChunk(oldChunkIdx, oldSizeClass);
+		}
+	}
+
+	// keep entries sorted by ID, like the std::map this replaces
+	BlockingMapEntry* entries = &overflowEntries[cell.overflowIdx];
+	unsigned int n = cell.count;
+
+	while (n > 0 && entries[n - 1].first > objID) {
+		entries[n] = entries[n - 1]; n--;
+	}
+
+	entries[n] = BlockingMapEntry(objID, object);
+	cell.count += 1;
+
+	UpdateSquareFlags(mapSquare);
+}
+
+void CGroundBlockingObjectMap::EraseObject(int mapSquare, int objID)
+{
+	Cell& cell = cells[mapSquare];
+
+	if (cell.count == 0)
+		return;
+
+	if (cell.count == 1) {
+		if (cell.inlineEntry.first != objID)
+			return;
+
+		cell.inlineEntry = BlockingMapEntry(-1, NULL);
+		cell.count = 0;
+		UpdateSquareFlags(mapSquare);
+		return;
+	}
+
+	BlockingMapEntry* entries = &overflowEntries[cell.overflowIdx];
+	unsigned int n = 0;
+
+	while (n < cell.count && entries[n].first != objID) {
+		n++;
+	}
+
+	if (n == cell.count)
+		return;
+
+	for (cell.count -= 1; n < cell.count; n++) {
+		entries[n] = entries[n + 1];
+	}
+
+	if (cell.count == 1) {
+		// back to a single object, which fits inline again
+		cell.inlineEntry = entries[0];
+
+		FreeOverflowChunk(cell.overflowIdx, cell.sizeClass);
+
+		cell.sizeClass = 0;
+		cell.overflowIdx = 0;
+	}
+
+	UpdateSquareFlags(mapSquare);
+}
+
+
+void CGroundBlockingObjectMap::UpdateSquareFlags(int mapSquare)
+{
+	const BlockingMapCell& cell = GetCell(mapSquare);
+
+	unsigned char flags = 0;
+
+	for (BlockingMapCellIt it = cell.begin(); it != cell.end(); ++it) {
+		flags |= ((it->second)->immobile? SQUARE_HAS_STRUCTURE: SQUARE_HAS_MOBILE);
+	}
+
+	squareFlags[mapSquare] = flags;
+}
+
+
 void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object)
 {
 	if (object->blockMap != NULL) {
@@ -60,8 +252,7 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object)
 
 	for (int zSqr = minZSqr; zSqr < maxZSqr; zSqr++) {
 		for (int xSqr = minXSqr; xSqr < maxXSqr; xSqr++) {
-			BlockingMapCell& cell = groundBlockingMap[xSqr + zSqr * gs->mapx];
-			cell[objID] = object;
+			InsertObject(xSqr + zSqr * gs->mapx, objID, object);
 		}
 	}
 
@@ -98,8 +289,7 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object, con
 			const float3 testPos = float3(x, 0.0f, z) * SQUARE_SIZE;
 
 			if (object->GetGroundBlockingMaskAtPos(testPos) & mask) {
-				BlockingMapCell& cell = groundBlockingMap[x + (z) * gs->mapx];
-				cell[objID] = object;
+				InsertObject(x + z * gs->mapx, objID, object);
 			}
 		}
 	}
@@ -126,10 +316,7 @@ void CGroundBlockingObjectMap::RemoveGroundBlockingObject(CSolidObject* object)
 
 	for (int z = bz; z < bz + sz; ++z) {
 		for (int x = bx; x < bx + sx; ++x) {
-			const int idx = x + z * gs->mapx;
-
-			BlockingMapCell& cell = groundBlockingMap[idx];
-			cell.erase(objID);
+			EraseObject(x + z * gs->mapx, objID);
 		}
 	}
 
@@ -148,12 +335,10 @@ void CGroundBlockingObjectMap::RemoveGroundBlockingObject(CSolidObject* object)
 CSolidObject* CGroundBlockingObjectMap::GroundBlockedUnsafe(int mapSquare) const {
 	GML_STDMUTEX_LOCK(block); // GroundBlockedUnsafe
 
-	const BlockingMapCell& cell = groundBlockingMap[mapSquare];
-
-	if (cell.empty())
+	if (squareFlags[mapSquare] == 0)
 		return NULL;
 
-	return ((cell.begin())->second);
+	return ((GetCell(mapSquare).begin())->second);
 }
 
 
@@ -181,11 +366,11 @@ bool CGroundBlockingObjectMap::GroundBlocked(int x, int z, CSolidObject* ignoreO
 
 	GML_STDMUTEX_LOCK(block); // GroundBlockedUnsafe
 
-	if (groundBlockingMap[mapSquare].empty())
+	if (squareFlags[mapSquare] == 0)
 		return false;
 
 	const int objID = GetObjectID(ignoreObj);
-	const BlockingMapCell& cell = groundBlockingMap[mapSquare];
+	const BlockingMapCell& cell = GetCell(mapSquare);
 
 	BlockingMapCellIt it = cell.begin();
 
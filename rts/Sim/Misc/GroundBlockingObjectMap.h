@@ -3,26 +3,63 @@
 #ifndef GROUNDBLOCKINGOBJECTMAP_H
 #define GROUNDBLOCKINGOBJECTMAP_H
 
-#include <map>
+#include <utility>
+#include <vector>
 #include "System/creg/creg_cond.h"
 
 #include "Sim/Objects/SolidObject.h"
 #include "System/float3.h"
 
 
-typedef std::map<int, CSolidObject*> BlockingMapCell;
+typedef std::pair<int, CSolidObject*> BlockingMapEntry;
+
+/**
+ * Read-only view of the objects blocking one map square, sorted by
+ * increasing blocking-map ID. A view stays valid until the next call
+ * that adds or removes a blocking object.
+ */
+class BlockingMapCell
+{
+public:
+	typedef const BlockingMapEntry* const_iterator;
+
+	BlockingMapCell(const_iterator b, const_iterator e): first(b), last(e) {}
+
+	const_iterator begin() const { return first; }
+	const_iterator end() const { return last; }
+
+	const_iterator find(int objID) const {
+		for (const_iterator it = first; it != last; ++it) {
+			if (it->first == objID) {
+				return it;
+			}
+		}
+		return last;
+	}
+
+	size_t size() const { return (last - first); }
+	bool empty() const { return (last == first); }
+
+private:
+	const_iterator first;
+	const_iterator last;
+};
+
 typedef BlockingMapCell::const_iterator BlockingMapCellIt;
-typedef std::vector<BlockingMapCell> BlockingMap;
 
 
 class CGroundBlockingObjectMap
 {
 	CR_DECLARE_STRUCT(CGroundBlockingObjectMap);
+	CR_DECLARE_SUB(Cell);
 
 public:
-	CGroundBlockingObjectMap(int numSquares) {
-		groundBlockingMap.resize(numSquares);
-	}
+	enum {
+		SQUARE_HAS_STRUCTURE = 1, ///< at least one immobile object blocks the square
+		SQUARE_HAS_MOBILE    = 2, ///< at least one mobile object blocks the square
+	};
+
+	CGroundBlockingObjectMap(int numSquares);
 
 	void AddGroundBlockingObject(CSolidObject* object);
 	void AddGroundBlockingObject(CSolidObject* object, const YardMapStatus& mask);
@@ -44,16 +81,52 @@ public:
 	bool GroundBlocked(int x, int z, CSolidObject* ignoreObj) const;
 	bool GroundBlocked(const float3& pos, CSolidObject* ignoreObj) const;
 
+	// combination of SQUARE_HAS_* bits; zero means the square is empty
+	unsigned char GetSquareFlags(int mapSquare) const { return squareFlags[mapSquare]; }
+
 	// for full thread safety, access via GetCell would need to be mutexed, but it appears only sim thread uses it
-	const BlockingMapCell& GetCell(int mapSquare) const {
-		return groundBlockingMap[mapSquare];
+	BlockingMapCell GetCell(int mapSquare) const {
+		const Cell& cell = cells[mapSquare];
+		const BlockingMapEntry* entries = (cell.count <= 1)? &cell.inlineEntry: &overflowEntries[cell.overflowIdx];
+		return BlockingMapCell(entries, entries + cell.count);
 	}
 
+	size_t GetMemoryFootprint() const;
+
 private:
+	/**
+	 * Squares are almost always blocked by at most one object, which
+	 * is stored inline; larger sets are moved into a power-of-two sized
+	 * chunk of <overflowEntries>. Freed chunks are recycled through
+	 * <freeOverflowChunks> (indexed by size-class) rather than released.
+	 */
+	struct Cell {
+		CR_DECLARE_STRUCT(Cell);
+		Cell(): inlineEntry(-1, NULL), count(0), sizeClass(0), overflowIdx(0) {}
+
+		BlockingMapEntry inlineEntry;
+
+		unsigned short count;
+		unsigned short sizeClass;
+		unsigned int overflowIdx;
+	};
+
+	void InsertObject(int mapSquare, int objID, CSolidObject* object);
+	void EraseObject(int mapSquare, int objID);
+
+	unsigned int AllocOverflowChunk(unsigned int sizeClass);
+	void FreeOverflowChunk(unsigned int chunkIdx, unsigned int sizeClass);
+
+	void UpdateSquareFlags(int mapSquare);
+
 	bool CheckYard(CSolidObject* yardUnit, const YardMapStatus& mask) const;
 
 private:
-	BlockingMap groundBlockingMap;
+	std::vector<Cell> cells;
+	std::vector<unsigned char> squareFlags;
+
+	std::vector<BlockingMapEntry> overflowEntries;
+	std::vector< std::vector<unsigned int> > freeOverflowChunks;
 };
 
 extern CGroundBlockingObjectMap* groundBlockingObjectMap;
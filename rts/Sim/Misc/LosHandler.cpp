@@ -1,20 +1,25 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
 #include <list>
 #include <cstdlib>
 #include <cstring>
 
 #include "LosHandler.h"
+#include "LosKernels.h"
 #include "ModInfo.h"
 
 #include "Sim/Units/Unit.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Map/ReadMap.h"
 #include "System/Log/ILog.h"
+#include "System/ThreadPool.h"
 #include "System/TimeProfiler.h"
+#include "System/Sync/FPUCheck.h"
 #include "System/creg/STL_Deque.h"
 #include "System/creg/STL_List.h"
+#include "System/creg/STL_Set.h"
 
 using std::min;
 using std::max;
@@ -34,24 +39,32 @@ CR_REG_METADATA(LosInstance,(
 	CR_MEMBER(baseAirPos),
 	CR_MEMBER(hashNum),
 	CR_MEMBER(baseHeight),
-	CR_MEMBER(toBeDeleted)
+	CR_MEMBER(toBeDeleted),
+	CR_IGNORED(pendingIndex)
 ));
 
 void CLosHandler::PostLoad()
 {
+	BeginMoveBatch();
+
 	for (int a = 0; a < LOSHANDLER_MAGIC_PRIME; ++a) {
 		for (std::list<LosInstance*>::iterator li = instanceHash[a].begin(); li != instanceHash[a].end(); ++li) {
 			if ((*li)->refCount) {
-				LosAdd(*li);
+				RequestLosAdd(*li);
 			}
 		}
 	}
+
+	EndMoveBatch();
 }
 
 CR_REG_METADATA(CLosHandler,(
 	CR_MEMBER(instanceHash),
 	CR_MEMBER(toBeDeleted),
 	CR_MEMBER(delayQue),
+	CR_IGNORED(pendingInstances), // only non-empty within a move batch
+	CR_IGNORED(pendingRemovals),
+	CR_MEMBER(visibleUnits),
 	CR_RESERVED(8),
 	CR_POSTLOAD(PostLoad)
 ));
@@ -67,6 +80,7 @@ CR_REG_METADATA_SUB(CLosHandler,DelayedInstance, (
 
 
 CLosHandler* losHandler;
+bool CLosHandler::debugTimers = false;
 
 
 CLosHandler::CLosHandler() :
@@ -84,16 +98,29 @@ CLosHandler::CLosHandler() :
 	losSizeX(std::max(1, gs->mapx >> losMipLevel)),
 	losSizeY(std::max(1, gs->mapy >> losMipLevel)),
 	requireSonarUnderWater(modInfo.requireSonarUnderWater),
-	losAlgo(int2(losSizeX, losSizeY), -1e6f, 15, readMap->GetMIPHeightMapSynced(losMipLevel))
+	losAlgo(int2(losSizeX, losSizeY), -1e6f, 15, readMap->GetMIPHeightMapSynced(losMipLevel)),
+	visibleUnits(teamHandler->ActiveAllyTeams()),
+	batchDepth(0)
 {
 	for (int a = 0; a < teamHandler->ActiveAllyTeams(); ++a) {
 		losMaps[a].SetSize(losSizeX, losSizeY, true);
 		airLosMaps[a].SetSize(airSizeX, airSizeY, false);
 	}
+
+	// all kernels give identical results, this only affects speed
+	LosKernels::SelectKernels(springproc::GetProcSSEBits());
+
+	LOG("[%s] using %s ray-casting and %s area kernels", __FUNCTION__,
+		LosKernels::GetTraceLineName(), LosKernels::GetAddSpanName());
 }
 
 
 CLosHandler::~CLosHandler()
+{
+	DeleteAllInstances();
+}
+
+void CLosHandler::DeleteAllInstances()
 {
 	for (int a = 0; a < LOSHANDLER_MAGIC_PRIME; ++a) {
 		for (std::list<LosInstance*>::iterator li = instanceHash[a].begin(); li != instanceHash[a].end(); ++li) {
@@ -101,8 +128,30 @@ CLosHandler::~CLosHandler()
 			i->_DestructInstance(i);
 			mempool.Free(i, sizeof(LosInstance));
 		}
+
+		instanceHash[a].clear();
 	}
 
+	toBeDeleted.clear();
+	delayQue.clear();
+}
+
+
+void CLosHandler::UpdateUnitVisibility(CUnit* unit, int allyTeam)
+{
+	if ((unit->losStatus[allyTeam] & (LOS_INLOS | LOS_INRADAR)) != 0) {
+		visibleUnits[allyTeam].insert(unit);
+	} else {
+		visibleUnits[allyTeam].erase(unit);
+	}
+}
+
+
+void CLosHandler::RemoveUnit(CUnit* unit)
+{
+	for (std::vector<CUnitSet>::iterator it = visibleUnits.begin(); it != visibleUnits.end(); ++it) {
+		it->erase(unit);
+	}
 }
 
 
@@ -179,7 +228,7 @@ void CLosHandler::MoveUnit(CUnit* unit, bool redoCurrent)
 		unit->los = instance;
 	}
 
-	LosAdd(instance);
+	RequestLosAdd(instance);
 }
 
 
@@ -188,10 +237,135 @@ void CLosHandler::LosAdd(LosInstance* instance)
 	assert(instance);
 	assert(teamHandler->IsValidAllyTeam(instance->allyteam));
 
-	losAlgo.LosAdd(instance->basePos, instance->losSize, instance->baseHeight, instance->losSquares);
+	// a reused instance still holds the (already subtracted) squares of its last LosAdd
+	instance->losSquares.clear();
+
+	if (instance->losSize > 0) {
+		LosDebugTimer timer("LOSHandler::LOS");
+		losAlgo.LosAdd(instance->basePos, instance->losSize, instance->baseHeight, instance->losSquares);
+		losMaps[instance->allyteam].AddMapSquares(instance->losSquares, instance->allyteam, 1);
+	}
+	if (instance->airLosSize > 0) {
+		LosDebugTimer timer("LOSHandler::AirLOS");
+		airLosMaps[instance->allyteam].AddMapArea(instance->baseAirPos, instance->allyteam, instance->airLosSize, 1);
+	}
+}
+
+
+void CLosHandler::RequestLosAdd(LosInstance* instance)
+{
+	assert(instance);
+	assert(teamHandler->IsValidAllyTeam(instance->allyteam));
+
+	if (batchDepth == 0) {
+		LosAdd(instance);
+		return;
+	}
+
+	if (instance->pendingIndex >= 0)
+		return;
+
+	instance->pendingIndex = pendingInstances.size();
+	pendingInstances.push_back(instance);
+}
 
-	if (instance->losSize > 0) { losMaps[instance->allyteam].AddMapSquares(instance->losSquares, instance->allyteam, 1); }
-	if (instance->airLosSize > 0) { airLosMaps[instance->allyteam].AddMapArea(instance->baseAirPos, instance->allyteam, instance->airLosSize, 1); }
+
+void CLosHandler::BeginMoveBatch()
+{
+	batchDepth++;
+}
+
+
+void CLosHandler::EndMoveBatch()
+{
+	assert(batchDepth > 0);
+
+	if ((--batchDepth) == 0) {
+		FlushPendingUpdates();
+	}
+}
+
+
+void CLosHandler::FlushPendingUpdates()
+{
+	if (pendingInstances.empty() && pendingRemovals.empty())
+		return;
+
+	SCOPED_TIMER("LOSHandler::FlushPendingUpdates");
+
+	{
+		LosDebugTimer timer("LOSHandler::LOS");
+
+		// each map belongs to exactly one ally-team, so no two
+		// threads ever write to the same counter
+		for_mt(0, int(losMaps.size()), [&](const int allyTeam) {
+			for (size_t i = 0; i < pendingRemovals.size(); i++) {
+				const PendingRemoval& removal = pendingRemovals[i];
+
+				if (removal.allyteam != allyTeam)
+					continue;
+
+				if (removal.losSize > 0) { losMaps[allyTeam].AddMapSquares(removal.losSquares, allyTeam, -1); }
+				if (removal.airLosSize > 0) { airLosMaps[allyTeam].AddMapArea(removal.baseAirPos, allyTeam, removal.airLosSize, -1); }
+			}
+		});
+
+		pendingRemovals.clear();
+	}
+
+	std::vector<CLosAlgorithm::BatchItem> items;
+	items.reserve(pendingInstances.size());
+
+	for (size_t i = 0; i < pendingInstances.size(); i++) {
+		LosInstance* instance = pendingInstances[i];
+
+		if (instance == NULL)
+			continue;
+
+		instance->losSquares.clear();
+
+		if (instance->losSize <= 0)
+			continue;
+
+		const CLosAlgorithm::BatchItem item = {
+			instance->basePos,
+			instance->losSize,
+			instance->baseHeight,
+			instance->allyteam,
+			&instance->losSquares
+		};
+		items.push_back(item);
+	}
+
+	{
+		LosDebugTimer timer("LOSHandler::LOS");
+		losAlgo.LosAddBatch(items, losMaps);
+	}
+	{
+		LosDebugTimer timer("LOSHandler::AirLOS");
+
+		// each map belongs to exactly one ally-team, so no two
+		// threads ever write to the same counter
+		for_mt(0, int(airLosMaps.size()), [&](const int allyTeam) {
+			for (size_t i = 0; i < pendingInstances.size(); i++) {
+				const LosInstance* instance = pendingInstances[i];
+
+				if (instance == NULL) { continue; }
+				if (instance->allyteam != allyTeam) { continue; }
+				if (instance->airLosSize <= 0) { continue; }
+
+				airLosMaps[allyTeam].AddMapArea(instance->baseAirPos, allyTeam, instance->airLosSize, 1);
+			}
+		});
+	}
+
+	for (size_t i = 0; i < pendingInstances.size(); i++) {
+		if (pendingInstances[i] != NULL) {
+			pendingInstances[i]->pendingIndex = -1;
+		}
+	}
+
+	pendingInstances.clear();
 }
 
 
@@ -259,7 +433,7 @@ int CLosHandler::GetHashNum(CUnit* unit)
 void CLosHandler::AllocInstance(LosInstance* instance)
 {
 	if (instance->refCount == 0) {
-		LosAdd(instance);
+		RequestLosAdd(instance);
 	}
 	instance->refCount++;
 }
@@ -267,6 +441,27 @@ void CLosHandler::AllocInstance(LosInstance* instance)
 
 void CLosHandler::CleanupInstance(LosInstance* instance)
 {
+	if (instance->pendingIndex >= 0) {
+		// never made it onto the maps, nothing to subtract
+		pendingInstances[instance->pendingIndex] = NULL;
+		instance->pendingIndex = -1;
+		return;
+	}
+
+	if (batchDepth > 0) {
+		// subtracted at the end of the batch; the squares are moved
+		// out since the instance may be ray-cast again before that
+		pendingRemovals.push_back(PendingRemoval());
+
+		PendingRemoval& removal = pendingRemovals.back();
+		removal.allyteam = instance->allyteam;
+		removal.losSize = instance->losSize;
+		removal.airLosSize = instance->airLosSize;
+		removal.baseAirPos = instance->baseAirPos;
+		removal.losSquares.swap(instance->losSquares);
+		return;
+	}
+
 	if (instance->losSize > 0) { losMaps[instance->allyteam].AddMapSquares(instance->losSquares, instance->allyteam, -1); }
 	if (instance->airLosSize > 0) { airLosMaps[instance->allyteam].AddMapArea(instance->baseAirPos, instance->allyteam, instance->airLosSize, -1); }
 }
@@ -10,8 +10,10 @@
 #include "Map/Ground.h"
 #include "Sim/Objects/WorldObject.h"
 #include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitSet.h"
 #include "Sim/Misc/RadarHandler.h"
 #include "System/MemPool.h"
+#include "System/TimeProfiler.h"
 #include "System/type2.h"
 
 #define LOSHANDLER_ALWAYSVISIBLE_OVERRIDES_CLOAKED
@@ -49,6 +51,7 @@ private:
 		, hashNum(-1)
 		, baseHeight(0.0f)
 		, toBeDeleted(false)
+		, pendingIndex(-1)
 	{}
 
 public:
@@ -64,6 +67,7 @@ public:
 		, hashNum(hashNum)
 		, baseHeight(baseHeight)
 		, toBeDeleted(false)
+		, pendingIndex(-1)
 	{}
 
  	std::vector<int> losSquares;
@@ -77,6 +81,8 @@ public:
 	int hashNum;
 	float baseHeight;
 	bool toBeDeleted;
+	/// index into CLosHandler::pendingInstances while queued (not yet on the maps), -1 otherwise
+	int pendingIndex;
 };
 
 /**
@@ -99,6 +105,21 @@ public:
  * LOS is not removed immediately when a unit gets killed. Instead,
  * DelayedFreeInstance is called. This keeps the LosInstance (including the
  * actual sight) alive until 1.5 game seconds after the unit got killed.
+ *
+ * Between BeginMoveBatch and EndMoveBatch, the maps are left untouched:
+ * MoveUnit only queues the instances to add and the squares to subtract,
+ * and EndMoveBatch ray-casts all queued instances in parallel and then
+ * applies everything to the maps in parallel per ally-team (see
+ * CLosAlgorithm::LosAddBatch). Readers within a batch therefore see the LOS
+ * of when it began, never a half-updated state. The maps are reference
+ * counts, so they end up the same as with immediate updates. A queued
+ * instance that is cleaned up before the end of the batch is dropped from
+ * the queue. Outside of batches, MoveUnit updates the maps immediately.
+ *
+ * Per ally-team, the units that are currently in its LOS or radar (by their
+ * losStatus) are indexed, so that visibility queries from AIs and Lua only
+ * have to look at those instead of at all units. CUnit keeps the index up
+ * to date whenever the LOS_INLOS or LOS_INRADAR bits of a unit change.
  */
 class CLosHandler : public boost::noncopyable
 {
@@ -110,6 +131,32 @@ public:
 	void MoveUnit(CUnit* unit, bool redoCurrent);
 	void FreeInstance(LosInstance* instance);
 
+	/**
+	 * Defers the map updates of all MoveUnit calls until the matching
+	 * EndMoveBatch, which runs them in parallel. Batches may be nested.
+	 * Within a batch, InLos etc. answer with the LOS from before it.
+	 */
+	void BeginMoveBatch();
+	void EndMoveBatch();
+	/**
+	 * Applies what the current batch has queued so far, for synced
+	 * readers that need the LOS as of now (synced Lua queries). Never
+	 * call this from unsynced code, it changes what later synced readers
+	 * within the batch see.
+	 */
+	void FlushPendingUpdates();
+
+	/**
+	 * Units with LOS_INLOS or LOS_INRADAR set in losStatus[allyTeam], sorted
+	 * by id. Includes the ally-team's own units, which always have both set.
+	 */
+	const CUnitSet& GetVisibleUnits(int allyTeam) const { return visibleUnits[allyTeam]; }
+
+	/// updates GetVisibleUnits after unit->losStatus[allyTeam] changed
+	void UpdateUnitVisibility(CUnit* unit, int allyTeam);
+	/// removes a unit that is being deleted from all GetVisibleUnits sets
+	void RemoveUnit(CUnit* unit);
+
 	inline bool InLos(const CWorldObject* obj, int allyTeam) const {
 		if (obj->alwaysVisible || gs->globalLOS[allyTeam])
 			return true;
@@ -212,6 +259,8 @@ private:
 
 	void PostLoad();
 	void LosAdd(LosInstance* instance);
+	/// adds <instance> to the maps now, or at the end of the current move batch
+	void RequestLosAdd(LosInstance* instance);
 	int GetHashNum(CUnit* unit);
 	void AllocInstance(LosInstance* instance);
 	void CleanupInstance(LosInstance* instance);
@@ -221,6 +270,20 @@ private:
 	std::list<LosInstance*> instanceHash[LOSHANDLER_MAGIC_PRIME];
 
 	std::deque<LosInstance*> toBeDeleted;
+	/// queued within a move batch; NULL for instances cleaned up while queued
+	std::vector<LosInstance*> pendingInstances;
+
+	/// the map contribution of an instance cleaned up within a move batch
+	struct PendingRemoval {
+		int allyteam;
+		int losSize;
+		int airLosSize;
+		int2 baseAirPos;
+		std::vector<int> losSquares;
+	};
+
+	std::vector<PendingRemoval> pendingRemovals;
+	int batchDepth;
 
 	struct DelayedInstance {
 		CR_DECLARE_STRUCT(DelayedInstance);
@@ -230,9 +293,42 @@ private:
 
 	std::deque<DelayedInstance> delayQue;
 
+	std::vector<CUnitSet> visibleUnits;
+
 public:
 	void Update();
 	void DelayedFreeInstance(LosInstance* instance);
+	/**
+	 * Frees every instance without touching the LOS maps; only for
+	 * when all units are gone and the maps get replaced as a whole.
+	 */
+	void DeleteAllInstances();
+
+	/// unsynced; if true, LOS and radar map updates are profiled per map-type (/DebugLos)
+	static bool debugTimers;
+};
+
+
+/**
+ * Adds the time spent in its scope to the profiler under <name>,
+ * but only while CLosHandler::debugTimers is enabled.
+ */
+class LosDebugTimer : public boost::noncopyable
+{
+public:
+	LosDebugTimer(const char* name)
+		: name(name)
+		, startTime(CLosHandler::debugTimers? spring_gettime(): spring_notime)
+	{}
+	~LosDebugTimer() {
+		if (CLosHandler::debugTimers && spring_istime(startTime)) {
+			profiler.AddTime(name, spring_difftime(spring_gettime(), startTime));
+		}
+	}
+
+private:
+	const char* name;
+	const spring_time startTime;
 };
 
 extern CLosHandler* losHandler;
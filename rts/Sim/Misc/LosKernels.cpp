@@ -0,0 +1,179 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "LosKernels.h"
+#include "System/maindefines.h"
+
+// the SSE ray-caster is only equivalent to the scalar code if that is
+// compiled to SSE math as well (x87 uses a different intermediate precision)
+#if !defined(DEDICATED_NOSSE) && !defined(STREFLOP_X87) && \
+	(defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1)))
+	#define LOSKERNELS_SSE
+	#include <xmmintrin.h>
+#endif
+
+// engine builds are restricted to SSE1 (-mno-sse2), so the SSE2 kernel is
+// compiled for that target explicitly and only ever called if CPUID says so
+#if defined(LOSKERNELS_SSE) && (defined(__GNUC__) || defined(_MSC_VER))
+	#define LOSKERNELS_SSE2
+	#include <emmintrin.h>
+
+	#if defined(__GNUC__)
+		#define _target_sse2 __attribute__((target("sse2")))
+	#else
+		#define _target_sse2
+	#endif
+#endif
+
+
+namespace LosKernels {
+
+TraceLineFunc TraceLine = TraceLineScalar;
+AddSpanFunc AddSpan = AddSpanScalar;
+
+
+void TraceLineScalar(
+	const float* heightmap,
+	const int* squares,
+	int numSteps,
+	float baseHeight,
+	float extraHeight,
+	float minMaxAng,
+	std::vector<int>& visible
+) {
+	float maxAng[4] = {minMaxAng, minMaxAng, minMaxAng, minMaxAng};
+	float r = 1.0f;
+
+	for (int s = 0; s < numSteps; s++, squares += 4) {
+		const float invR = 1.0f / r;
+
+		for (int q = 0; q < 4; q++) {
+			const int square = squares[q];
+
+			if (square < 0)
+				continue;
+
+			const float dh = heightmap[square] - baseHeight;
+			float ang = (dh + extraHeight) * invR;
+
+			if (ang > maxAng[q]) {
+				visible.push_back(square);
+				ang = dh * invR;
+				if (ang > maxAng[q]) maxAng[q] = ang;
+			}
+		}
+
+		r++;
+	}
+}
+
+
+#ifdef LOSKERNELS_SSE
+__FORCE_ALIGN_STACK__
+void TraceLineSSE(
+	const float* heightmap,
+	const int* squares,
+	int numSteps,
+	float baseHeight,
+	float extraHeight,
+	float minMaxAng,
+	std::vector<int>& visible
+) {
+	// squares outside the map get a height so low that they can never
+	// become visible, and therefore never raise the maximum angle either
+	#define HEIGHT(q) ((squares[q] >= 0)? heightmap[squares[q]]: -1e30f)
+
+	const __m128 base = _mm_set1_ps(baseHeight);
+	const __m128 extra = _mm_set1_ps(extraHeight);
+	__m128 maxAng = _mm_set1_ps(minMaxAng);
+	float r = 1.0f;
+
+	for (int s = 0; s < numSteps; s++, squares += 4) {
+		const __m128 invR = _mm_set1_ps(1.0f / r);
+		const __m128 dh = _mm_sub_ps(_mm_setr_ps(HEIGHT(0), HEIGHT(1), HEIGHT(2), HEIGHT(3)), base);
+		const __m128 ang = _mm_mul_ps(_mm_add_ps(dh, extra), invR);
+		const __m128 vis = _mm_cmpgt_ps(ang, maxAng);
+		const int visMask = _mm_movemask_ps(vis);
+
+		if (visMask != 0) {
+			if (visMask & 1) visible.push_back(squares[0]);
+			if (visMask & 2) visible.push_back(squares[1]);
+			if (visMask & 4) visible.push_back(squares[2]);
+			if (visMask & 8) visible.push_back(squares[3]);
+
+			// max(a, b) returns b unless a > b, same as the scalar test
+			const __m128 newMaxAng = _mm_max_ps(_mm_mul_ps(dh, invR), maxAng);
+			maxAng = _mm_or_ps(_mm_and_ps(vis, newMaxAng), _mm_andnot_ps(vis, maxAng));
+		}
+
+		r++;
+	}
+
+	#undef HEIGHT
+}
+#else
+void TraceLineSSE(const float* heightmap, const int* squares, int numSteps, float baseHeight, float extraHeight, float minMaxAng, std::vector<int>& visible) {
+	TraceLineScalar(heightmap, squares, numSteps, baseHeight, extraHeight, minMaxAng, visible);
+}
+#endif
+
+
+
+void AddSpanScalar(unsigned short* cells, int count, int amount)
+{
+	for (int n = 0; n < count; n++) {
+		cells[n] += amount;
+	}
+}
+
+
+#ifdef LOSKERNELS_SSE2
+_target_sse2
+void AddSpanSSE2(unsigned short* cells, int count, int amount)
+{
+	// 16-bit adds wrap around exactly like the scalar unsigned short ones
+	const __m128i inc = _mm_set1_epi16(short(amount));
+	int n = 0;
+
+	for (; (n + 8) <= count; n += 8) {
+		__m128i* p = reinterpret_cast<__m128i*>(cells + n);
+		_mm_storeu_si128(p, _mm_add_epi16(_mm_loadu_si128(p), inc));
+	}
+
+	AddSpanScalar(cells + n, count - n, amount);
+}
+#else
+void AddSpanSSE2(unsigned short* cells, int count, int amount) {
+	AddSpanScalar(cells, count, amount);
+}
+#endif
+
+
+
+bool HaveKernel(unsigned int cpuBit)
+{
+	switch (cpuBit) {
+		#ifdef LOSKERNELS_SSE
+		case CPU_BIT_SSE: return true;
+		#endif
+		#ifdef LOSKERNELS_SSE2
+		case CPU_BIT_SSE2: return true;
+		#endif
+		default: {} break;
+	}
+
+	return false;
+}
+
+void SelectKernels(unsigned int sseBits)
+{
+	const bool useSSE = HaveKernel(CPU_BIT_SSE) && ((sseBits & CPU_BIT_SSE) != 0);
+	const bool useSSE2 = HaveKernel(CPU_BIT_SSE2) && ((sseBits & CPU_BIT_SSE2) != 0);
+
+	TraceLine = useSSE? TraceLineSSE: TraceLineScalar;
+	AddSpan = useSSE2? AddSpanSSE2: AddSpanScalar;
+}
+
+const char* GetTraceLineName() { return ((TraceLine == TraceLineSSE)? "SSE": "scalar"); }
+const char* GetAddSpanName() { return ((AddSpan == AddSpanSSE2)? "SSE2": "scalar"); }
+
+} // namespace LosKernels
@@ -0,0 +1,66 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LOS_KERNELS_H
+#define LOS_KERNELS_H
+
+#include <vector>
+
+/**
+ * Inner loops of CLosAlgorithm (ray-casting) and CLosMap (filled circles),
+ * in a scalar reference version and SIMD versions that are picked at
+ * runtime by SelectKernels based on the CPUID feature bits.
+ *
+ * Every version MUST produce exactly the same result as the scalar one,
+ * the output is synced (LOS and radar coverage decide what units can see
+ * and target): the SSE ray-caster performs the same IEEE single-precision
+ * operations in the same order, just on four lanes at once.
+ */
+namespace LosKernels {
+	/**
+	 * Traces one line of a LOS-table in all four of its rotations at once.
+	 *
+	 * @param squares numSteps * 4 heightmap indices; step s of rotation q
+	 *   is squares[s * 4 + q], negative if the square is outside the map
+	 * @param visible receives the visible squares, in step-major order
+	 */
+	typedef void (*TraceLineFunc)(
+		const float* heightmap,
+		const int* squares,
+		int numSteps,
+		float baseHeight,
+		float extraHeight,
+		float minMaxAng,
+		std::vector<int>& visible
+	);
+
+	/// adds <amount> to <count> consecutive (wrapping) counters
+	typedef void (*AddSpanFunc)(unsigned short* cells, int count, int amount);
+
+	void TraceLineScalar(const float* heightmap, const int* squares, int numSteps, float baseHeight, float extraHeight, float minMaxAng, std::vector<int>& visible);
+	void TraceLineSSE(const float* heightmap, const int* squares, int numSteps, float baseHeight, float extraHeight, float minMaxAng, std::vector<int>& visible);
+
+	void AddSpanScalar(unsigned short* cells, int count, int amount);
+	void AddSpanSSE2(unsigned short* cells, int count, int amount);
+
+	/// bit-layout as returned by springproc::GetProcSSEBits
+	enum {
+		CPU_BIT_SSE2 = (1 << 4),
+		CPU_BIT_SSE  = (1 << 5),
+	};
+
+	/// true if this build contains the SIMD version for <cpuBit>
+	bool HaveKernel(unsigned int cpuBit);
+
+	/// picks the fastest kernels that <sseBits> supports
+	void SelectKernels(unsigned int sseBits);
+
+	/// the currently selected kernels (scalar until SelectKernels is called)
+	extern TraceLineFunc TraceLine;
+	extern AddSpanFunc AddSpan;
+
+	/// human-readable names of the selected kernels
+	const char* GetTraceLineName();
+	const char* GetAddSpanName();
+}
+
+#endif // LOS_KERNELS_H
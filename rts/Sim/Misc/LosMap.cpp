@@ -3,9 +3,12 @@
 /* based on original los code in LosHandler.{cpp,h} and RadarHandler.{cpp,h} */
 
 #include "LosMap.h"
+#include "LosKernels.h"
 #include "Map/ReadMap.h"
 #include "System/myMath.h"
 #include "System/float3.h"
+#include "System/Misc/ScratchArena.h"
+#include "System/ThreadPool.h"
 
 #ifdef USE_UNSYNCED_HEIGHTMAP
 #include "Game/GlobalUnsynced.h" // for myAllyTeam
@@ -46,13 +49,25 @@ void CLosMap::SetSize(int2 newSize, bool newSendReadmapEvents)
 
 
 
+/// largest dx with (dx * dx) <= rr
+static inline int CircleRowHalfWidth(int rr)
+{
+	int dx = int(math::sqrt(float(rr)));
+
+	while ((dx * dx) > rr) { dx--; }
+	while (((dx + 1) * (dx + 1)) <= rr) { dx++; }
+
+	return dx;
+}
+
 void CLosMap::AddMapArea(int2 pos, int allyteam, int radius, int amount)
 {
 	#ifdef USE_UNSYNCED_HEIGHTMAP
-	static const int LOS2HEIGHT_X = gs->mapx / size.x;
-	static const int LOS2HEIGHT_Z = gs->mapy / size.y;
-
 	const bool updateUnsyncedHeightMap = (sendReadmapEvents && allyteam >= 0 && (allyteam == gu->myAllyTeam || gu->spectatingFullView));
+
+	// radar maps never touch the (unsynced) global state
+	const int LOS2HEIGHT_X = updateUnsyncedHeightMap? (gs->mapx / size.x): 1;
+	const int LOS2HEIGHT_Z = updateUnsyncedHeightMap? (gs->mapy / size.y): 1;
 	#endif
 
 	const int sx = std::max(         0, pos.x - radius);
@@ -63,52 +78,61 @@ void CLosMap::AddMapArea(int2 pos, int allyteam, int radius, int amount)
 	const int rr = (radius * radius);
 
 	for (int lmz = sy; lmz <= ey; ++lmz) {
+		// each row of the circle is one contiguous run of squares
 		const int rrx = rr - Square(pos.y - lmz);
-		for (int lmx = sx; lmx <= ex; ++lmx) {
-			const int losMapSquareIdx = (lmz * size.x) + lmx;
-			#ifdef USE_UNSYNCED_HEIGHTMAP
-			const bool squareEnteredLOS = (map[losMapSquareIdx] == 0 && amount > 0);
-			#endif
+		const int dx = CircleRowHalfWidth(rrx);
+		const int rowBeg = std::max(sx, pos.x - dx);
+		const int rowEnd = std::min(ex, pos.x + dx);
 
-			if (Square(pos.x - lmx) > rrx) {
-				continue;
+		if (rowBeg > rowEnd) {
+			continue;
+		}
+
+		#ifdef USE_UNSYNCED_HEIGHTMAP
+		if (updateUnsyncedHeightMap) {
+			for (int lmx = rowBeg; lmx <= rowEnd; ++lmx) {
+				const int losMapSquareIdx = (lmz * size.x) + lmx;
+				const bool squareEnteredLOS = (map[losMapSquareIdx] == 0 && amount > 0);
+
+				map[losMapSquareIdx] += amount;
+
+				// update unsynced heightmap for all squares that
+				// cover LOSmap square <x, y> (LOSmap resolution
+				// is never greater than that of the heightmap)
+				//
+				// NOTE:
+				//     CLosMap is also used by RadarHandler, so only
+				//     update the unsynced heightmap from LosHandler
+				//     (by checking if allyteam >= 0)
+				//
+				if (!squareEnteredLOS) { continue; }
+
+				const int
+					x1 = lmx * LOS2HEIGHT_X,
+					z1 = lmz * LOS2HEIGHT_Z;
+				const int
+					x2 = std::min((lmx + 1) * LOS2HEIGHT_X, gs->mapxm1),
+					z2 = std::min((lmz + 1) * LOS2HEIGHT_Z, gs->mapym1);
+
+				readMap->UpdateLOS(SRectangle(x1, z1, x2, z2));
 			}
 
-			map[losMapSquareIdx] += amount;
-
-			#ifdef USE_UNSYNCED_HEIGHTMAP
-			// update unsynced heightmap for all squares that
-			// cover LOSmap square <x, y> (LOSmap resolution
-			// is never greater than that of the heightmap)
-			//
-			// NOTE:
-			//     CLosMap is also used by RadarHandler, so only
-			//     update the unsynced heightmap from LosHandler
-			//     (by checking if allyteam >= 0)
-			//
-			if (!updateUnsyncedHeightMap) { continue; }
-			if (!squareEnteredLOS) { continue; }
-
-			const int
-				x1 = lmx * LOS2HEIGHT_X,
-				z1 = lmz * LOS2HEIGHT_Z;
-			const int
-				x2 = std::min((lmx + 1) * LOS2HEIGHT_X, gs->mapxm1),
-				z2 = std::min((lmz + 1) * LOS2HEIGHT_Z, gs->mapym1);
-
-			readMap->UpdateLOS(SRectangle(x1, z1, x2, z2));
-			#endif
+			continue;
 		}
+		#endif
+
+		LosKernels::AddSpan(&map[(lmz * size.x) + rowBeg], rowEnd - rowBeg + 1, amount);
 	}
 }
 
 void CLosMap::AddMapSquares(const std::vector<int>& squares, int allyteam, int amount)
 {
 	#ifdef USE_UNSYNCED_HEIGHTMAP
-	static const int LOS2HEIGHT_X = gs->mapx / size.x;
-	static const int LOS2HEIGHT_Z = gs->mapy / size.y;
-
 	const bool updateUnsyncedHeightMap = (sendReadmapEvents && allyteam >= 0 && (allyteam == gu->myAllyTeam || gu->spectatingFullView));
+
+	// radar maps never touch the (unsynced) global state
+	const int LOS2HEIGHT_X = updateUnsyncedHeightMap? (gs->mapx / size.x): 1;
+	const int LOS2HEIGHT_Z = updateUnsyncedHeightMap? (gs->mapy / size.y): 1;
 	#endif
 
 	std::vector<int>::const_iterator lsi;
@@ -334,20 +358,40 @@ void CLosAlgorithm::LosAdd(int2 pos, int radius, float baseHeight, std::vector<i
 }
 
 
-#define MAP_SQUARE(pos) ((pos).y * size.x + (pos).x)
-#define LOS_ADD(_square, _maxAng) {                  \
-	const int square = _square;                      \
-	const float dh = heightmap[square] - baseHeight; \
-	float ang = (dh + extraHeight) * invR;           \
-                                                     \
-	if (ang > _maxAng) {                             \
-		squares.push_back(square);                   \
-		ang = dh * invR;                             \
-		if (ang > _maxAng) _maxAng = ang;            \
-	}                                                \
+void CLosAlgorithm::LosAddBatch(const std::vector<BatchItem>& items, std::vector<CLosMap>& maps)
+{
+	const int numItems = items.size();
+	const int numMaps = maps.size();
+
+	// ray-casting only reads the heightmap and
+	// writes to the item's own squares
+	for_mt(0, numItems, [&](const int i) {
+		const BatchItem& item = items[i];
+
+		item.squares->clear();
+		LosAdd(item.pos, item.radius, item.baseHeight, *item.squares);
+	});
+
+	// each map belongs to exactly one ally-team, so no two threads
+	// ever write to the same counter; the unsynced heightmap is only
+	// updated for a single ally-team, so at most one thread calls
+	// into readMap
+	for_mt(0, numMaps, [&](const int allyTeam) {
+		for (int i = 0; i < numItems; i++) {
+			const BatchItem& item = items[i];
+
+			if (item.allyteam != allyTeam)
+				continue;
+
+			maps[allyTeam].AddMapSquares(*item.squares, allyTeam, 1);
+		}
+	});
 }
 
 
+#define MAP_SQUARE(pos) ((pos).y * size.x + (pos).x)
+
+
 void CLosAlgorithm::UnsafeLosAdd(int2 pos, int radius, float baseHeight, std::vector<int>& squares)
 {
 	const int mapSquare = MAP_SQUARE(pos);
@@ -357,31 +401,32 @@ void CLosAlgorithm::UnsafeLosAdd(int2 pos, int radius, float baseHeight, std::ve
 	baseHeight += heightmap[mapSquare];
 
 	size_t neededSpace = squares.size() + 1;
+	size_t maxLineSize = 0;
 	for(LosTable::const_iterator li = table.begin(); li != table.end(); ++li) {
 		neededSpace += li->size() * 4;
+		maxLineSize = std::max(maxLineSize, li->size());
 	}
 
 	squares.reserve(neededSpace);
 	squares.push_back(mapSquare);
 
+	// the four rotations of each line are traced side by side
+	CScratchArena::Scope scope;
+	ScratchSpan<int> lineSquares = scope.Alloc<int>(maxLineSize * 4);
+
 	for(LosTable::const_iterator li = table.begin(); li != table.end(); ++li) {
 		const LosLine& line = *li;
-		float maxAng1 = minMaxAng;
-		float maxAng2 = minMaxAng;
-		float maxAng3 = minMaxAng;
-		float maxAng4 = minMaxAng;
-		float r = 1;
-
-		for(LosLine::const_iterator linei = line.begin(); linei != line.end(); ++linei) {
-			const float invR = 1.0f / r;
 
-			LOS_ADD(mapSquare + linei->x + linei->y * size.x, maxAng1);
-			LOS_ADD(mapSquare - linei->x - linei->y * size.x, maxAng2);
-			LOS_ADD(mapSquare - linei->x * size.x + linei->y, maxAng3);
-			LOS_ADD(mapSquare + linei->x * size.x - linei->y, maxAng4);
+		lineSquares.clear();
 
-			r++;
+		for(LosLine::const_iterator linei = line.begin(); linei != line.end(); ++linei) {
+			lineSquares.push_back(mapSquare + linei->x + linei->y * size.x);
+			lineSquares.push_back(mapSquare - linei->x - linei->y * size.x);
+			lineSquares.push_back(mapSquare - linei->x * size.x + linei->y);
+			lineSquares.push_back(mapSquare + linei->x * size.x - linei->y);
 		}
+
+		LosKernels::TraceLine(heightmap, lineSquares.begin(), line.size(), baseHeight, extraHeight, minMaxAng, squares);
 	}
 }
 
@@ -394,33 +439,34 @@ void CLosAlgorithm::SafeLosAdd(int2 pos, int radius, float baseHeight, std::vect
 	// NOTE: floating and flying units have their baseHeight adjusted in MoveType::SlowUpdate
 	baseHeight += heightmap[mapSquare];
 
+	size_t maxLineSize = 0;
+	for (LosTable::const_iterator li = table.begin(); li != table.end(); ++li) {
+		maxLineSize = std::max(maxLineSize, li->size());
+	}
+
 	squares.push_back(mapSquare);
 
+	CScratchArena::Scope scope;
+	ScratchSpan<int> lineSquares = scope.Alloc<int>(maxLineSize * 4);
+
 	for (LosTable::const_iterator li = table.begin(); li != table.end(); ++li) {
 		const LosLine& line = *li;
-		float maxAng1 = minMaxAng;
-		float maxAng2 = minMaxAng;
-		float maxAng3 = minMaxAng;
-		float maxAng4 = minMaxAng;
-		float r = 1;
 
-		for(LosLine::const_iterator linei = line.begin(); linei != line.end(); ++linei) {
-			const float invR = 1.0f / r;
-
-			if ((pos.x + linei->x < size.x) && (pos.y + linei->y < size.y)) {
-				LOS_ADD(mapSquare + linei->x + linei->y * size.x, maxAng1);
-			}
-			if ((pos.x - linei->x >= 0) && (pos.y - linei->y >= 0)) {
-				LOS_ADD(mapSquare - linei->x - linei->y * size.x, maxAng2);
-			}
-			if ((pos.x + linei->y < size.x) && (pos.y - linei->x >= 0)) {
-				LOS_ADD(mapSquare - linei->x * size.x + linei->y, maxAng3);
-			}
-			if ((pos.x - linei->y >= 0) && (pos.y + linei->x < size.y)) {
-				LOS_ADD(mapSquare + linei->x * size.x - linei->y, maxAng4);
-			}
+		lineSquares.clear();
 
-			r++;
+		// squares outside the map are passed as -1 and skipped by the kernel
+		for(LosLine::const_iterator linei = line.begin(); linei != line.end(); ++linei) {
+			const bool inMap1 = (pos.x + linei->x < size.x) && (pos.y + linei->y < size.y);
+			const bool inMap2 = (pos.x - linei->x >= 0) && (pos.y - linei->y >= 0);
+			const bool inMap3 = (pos.x + linei->y < size.x) && (pos.y - linei->x >= 0);
+			const bool inMap4 = (pos.x - linei->y >= 0) && (pos.y + linei->x < size.y);
+
+			lineSquares.push_back(inMap1? (mapSquare + linei->x + linei->y * size.x): -1);
+			lineSquares.push_back(inMap2? (mapSquare - linei->x - linei->y * size.x): -1);
+			lineSquares.push_back(inMap3? (mapSquare - linei->x * size.x + linei->y): -1);
+			lineSquares.push_back(inMap4? (mapSquare + linei->x * size.x - linei->y): -1);
 		}
+
+		LosKernels::TraceLine(heightmap, lineSquares.begin(), line.size(), baseHeight, extraHeight, minMaxAng, squares);
 	}
 }
@@ -49,11 +49,28 @@ class CLosAlgorithm
 	CR_DECLARE_STRUCT(CLosAlgorithm);
 
 public:
+	/// a LOS source of a LosAddBatch
+	struct BatchItem {
+		int2 pos;
+		int radius;
+		float baseHeight;
+		int allyteam;
+		std::vector<int>* squares;
+	};
+
 	CLosAlgorithm(int2 size, float minMaxAng, float extraHeight, const float* heightmap)
 	: size(size), minMaxAng(minMaxAng), extraHeight(extraHeight), heightmap(heightmap) {}
 
 	void LosAdd(int2 pos, int radius, float baseHeight, std::vector<int>& squares);
 
+	/**
+	 * Replaces the squares of all <items> by new ray-casts (in parallel),
+	 * then adds them to maps[allyteam] (in parallel per ally-team, in item
+	 * order). The maps end up exactly as after calling LosAdd and
+	 * AddMapSquares for one item after the other.
+	 */
+	void LosAddBatch(const std::vector<BatchItem>& items, std::vector<CLosMap>& maps);
+
 private:
 	void UnsafeLosAdd(int2 pos, int radius, float baseHeight, std::vector<int>& squares);
 	void SafeLosAdd(int2 pos, int radius, float baseHeight, std::vector<int>& squares);
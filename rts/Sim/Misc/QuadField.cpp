@@ -11,7 +11,6 @@
 #include "Sim/Features/Feature.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Projectiles/Projectile.h"
-#include "System/creg/STL_List.h"
 
 #define CELL_IDX_X(wpx) Clamp(int((wpx) / quadSizeX), 0, numQuadsX - 1)
 #define CELL_IDX_Z(wpz) Clamp(int((wpz) / quadSizeZ), 0, numQuadsZ - 1)
@@ -56,21 +55,21 @@ void CQuadField::Resize(unsigned int nqx, unsigned int nqz)
 			//   if a unit exists in multiple quads in the old field, it will
 			//   be removed from all of them and there is no danger of double
 			//   re-insertion (important if new grid has higher resolution)
-			const std::list<CUnit*      > units       = quad.units;
-			const std::list<CFeature*   > features    = quad.features;
-			const std::list<CProjectile*> projectiles = quad.projectiles;
+			const std::vector<CUnit*      > units       = quad.units;
+			const std::vector<CFeature*   > features    = quad.features;
+			const std::vector<CProjectile*> projectiles = quad.projectiles;
 
-			for (std::list<CUnit*>::const_iterator it = units.begin(); it != units.end(); ++it) {
+			for (std::vector<CUnit*>::const_iterator it = units.begin(); it != units.end(); ++it) {
 				oldQuadField->RemoveUnit(*it);
 				newQuadField->MovedUnit(*it); // handles addition
 			}
 
-			for (std::list<CFeature*>::const_iterator it = features.begin(); it != features.end(); ++it) {
+			for (std::vector<CFeature*>::const_iterator it = features.begin(); it != features.end(); ++it) {
 				oldQuadField->RemoveFeature(*it);
 				newQuadField->AddFeature(*it);
 			}
 
-			for (std::list<CProjectile*>::const_iterator it = projectiles.begin(); it != projectiles.end(); ++it) {
+			for (std::vector<CProjectile*>::const_iterator it = projectiles.begin(); it != projectiles.end(); ++it) {
 				oldQuadField->RemoveProjectile(*it);
 				newQuadField->AddProjectile(*it);
 			}
@@ -155,8 +154,7 @@ unsigned int CQuadField::GetQuads(float3 pos, float radius, int*& begQuad, int*&
 	pos.ClampInBounds();
 	pos.AssertNaNs();
 
-	assert(begQuad == &tempQuads[0]);
-	assert(endQuad == &tempQuads[0]);
+	assert(begQuad == endQuad);
 
 	const int maxx = std::min((int(pos.x + radius)) / quadSizeX + 1, numQuadsX - 1);
 	const int maxz = std::min((int(pos.z + radius)) / quadSizeZ + 1, numQuadsZ - 1);
@@ -186,38 +184,245 @@ unsigned int CQuadField::GetQuads(float3 pos, float radius, int*& begQuad, int*&
 
 
 
-std::vector<CUnit*> CQuadField::GetUnits(const float3& pos, float radius)
+template<typename TUnits>
+void CQuadField::FilterUnitsExact(TUnits& units, const int* begQuad, const int* endQuad, const float3& pos, float radius, bool spherical)
 {
-	GML_RECMUTEX_LOCK(qnum); // GetUnits
+	const int tempNum = gs->tempNum++;
+
+	for (const int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CUnit*>& quadUnits = baseQuads[*a].units;
+
+		for (unsigned int n = 0; n < quadUnits.size(); n++) {
+			CUnit* u = quadUnits[n];
+
+			if (u->tempNum == tempNum)
+				continue;
+
+			const float totRad       = radius + u->radius;
+			const float totRadSq     = totRad * totRad;
+			const float posUnitDstSq = spherical?
+				pos.SqDistance(u->midPos):
+				pos.SqDistance2D(u->midPos);
 
+			if (posUnitDstSq >= totRadSq)
+				continue;
+
+			u->tempNum = tempNum;
+			units.push_back(u);
+		}
+	}
+}
+
+template<typename TFeatures>
+void CQuadField::FilterFeaturesExact(TFeatures& features, const int* begQuad, const int* endQuad, const float3& pos, float radius)
+{
 	const int tempNum = gs->tempNum++;
 
-	int* begQuad = &tempQuads[0];
-	int* endQuad = &tempQuads[0];
+	for (const int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CFeature*>& quadFeatures = baseQuads[*a].features;
 
-	GetQuads(pos, radius, begQuad, endQuad);
+		for (unsigned int n = 0; n < quadFeatures.size(); n++) {
+			CFeature* f = quadFeatures[n];
 
-	std::vector<CUnit*> units;
-	std::list<CUnit*>::iterator ui;
+			if (f->tempNum == tempNum) { continue; }
+			if (pos.SqDistance(f->midPos) >= Square(radius + f->radius)) { continue; }
 
-	for (int* a = begQuad; a != endQuad; ++a) {
-		Quad& quad = baseQuads[*a];
+			f->tempNum = tempNum;
+			features.push_back(f);
+		}
+	}
+}
 
-		for (ui = quad.units.begin(); ui != quad.units.end(); ++ui) {
-			if ((*ui)->tempNum == tempNum)
+template<typename TProjectiles>
+void CQuadField::FilterProjectilesExact(TProjectiles& projectiles, const int* begQuad, const int* endQuad, const float3& pos, float radius)
+{
+	for (const int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CProjectile*>& quadProjectiles = baseQuads[*a].projectiles;
+
+		for (unsigned int n = 0; n < quadProjectiles.size(); n++) {
+			CProjectile* p = quadProjectiles[n];
+
+			if ((pos - p->pos).SqLength() >= Square(radius + p->radius)) {
 				continue;
+			}
 
-			(*ui)->tempNum = tempNum;
-			units.push_back(*ui);
+			projectiles.push_back(p);
 		}
 	}
+}
+
+template<typename TSolids>
+void CQuadField::FilterSolidsExact(
+	TSolids& solids,
+	const int* begQuad,
+	const int* endQuad,
+	const float3& pos,
+	float radius,
+	unsigned int physicalStateBits,
+	unsigned int collisionStateBits
+) {
+	const int tempNum = gs->tempNum++;
+
+	for (const int* a = begQuad; a != endQuad; ++a) {
+		const Quad& quad = baseQuads[*a];
+
+		for (unsigned int n = 0; n < quad.units.size(); n++) {
+			CUnit* u = quad.units[n];
+
+			if (u->tempNum == tempNum)
+				continue;
+			if (!u->HasPhysicalStateBit(physicalStateBits))
+				continue;
+			if (!u->HasCollidableStateBit(collisionStateBits))
+				continue;
+			if ((pos - u->midPos).SqLength() >= Square(radius + u->radius))
+				continue;
+
+			u->tempNum = tempNum;
+			solids.push_back(u);
+		}
+
+		for (unsigned int n = 0; n < quad.features.size(); n++) {
+			CFeature* f = quad.features[n];
+
+			if (f->tempNum == tempNum)
+				continue;
+			if (!f->HasPhysicalStateBit(physicalStateBits))
+				continue;
+			if (!f->HasCollidableStateBit(collisionStateBits))
+				continue;
+			if ((pos - f->midPos).SqLength() >= Square(radius + f->radius))
+				continue;
+
+			f->tempNum = tempNum;
+			solids.push_back(f);
+		}
+	}
+}
+
+
+
+ScratchSpan<int> CQuadField::GetQuads(CScratchArena::Scope& scope, float3 pos, float radius) const
+{
+	pos.ClampInBounds();
+
+	// upper bound on the number of quads GetQuads can touch
+	const int maxx = std::min((int(pos.x + radius)) / quadSizeX + 1, numQuadsX - 1);
+	const int maxz = std::min((int(pos.z + radius)) / quadSizeZ + 1, numQuadsZ - 1);
+	const int minx = std::max((int(pos.x - radius)) / quadSizeX, 0);
+	const int minz = std::max((int(pos.z - radius)) / quadSizeZ, 0);
+
+	if (maxz < minz || maxx < minx)
+		return ScratchSpan<int>();
+
+	ScratchSpan<int> quads = scope.Alloc<int>((maxx - minx + 1) * (maxz - minz + 1));
+
+	int* begQuad = quads.begin();
+	int* endQuad = quads.begin();
+
+	quads.resize(GetQuads(pos, radius, begQuad, endQuad));
+	return quads;
+}
+
+ScratchSpan<CUnit*> CQuadField::GetUnitsExact(CScratchArena::Scope& scope, const float3& pos, float radius, bool spherical)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetUnitsExact
+
+	const ScratchSpan<int>& quads = GetQuads(scope, pos, radius);
+
+	size_t maxUnits = 0;
+
+	for (const int* a = quads.begin(); a != quads.end(); ++a) {
+		maxUnits += baseQuads[*a].units.size();
+	}
+
+	ScratchSpan<CUnit*> units = scope.Alloc<CUnit*>(maxUnits);
+	FilterUnitsExact(units, quads.begin(), quads.end(), pos, radius, spherical);
+	return units;
+}
+
+ScratchSpan<CFeature*> CQuadField::GetFeaturesExact(CScratchArena::Scope& scope, const float3& pos, float radius)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
+
+	const ScratchSpan<int>& quads = GetQuads(scope, pos, radius);
+
+	size_t maxFeatures = 0;
+
+	for (const int* a = quads.begin(); a != quads.end(); ++a) {
+		maxFeatures += baseQuads[*a].features.size();
+	}
+
+	ScratchSpan<CFeature*> features = scope.Alloc<CFeature*>(maxFeatures);
+	FilterFeaturesExact(features, quads.begin(), quads.end(), pos, radius);
+	return features;
+}
+
+ScratchSpan<CProjectile*> CQuadField::GetProjectilesExact(CScratchArena::Scope& scope, const float3& pos, float radius)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetProjectilesExact
+
+	const ScratchSpan<int>& quads = GetQuads(scope, pos, radius);
+
+	size_t maxProjectiles = 0;
+
+	for (const int* a = quads.begin(); a != quads.end(); ++a) {
+		maxProjectiles += baseQuads[*a].projectiles.size();
+	}
+
+	ScratchSpan<CProjectile*> projectiles = scope.Alloc<CProjectile*>(maxProjectiles);
+	FilterProjectilesExact(projectiles, quads.begin(), quads.end(), pos, radius);
+	return projectiles;
+}
+
+ScratchSpan<CSolidObject*> CQuadField::GetSolidsExact(
+	CScratchArena::Scope& scope,
+	const float3& pos,
+	const float radius,
+	const unsigned int physicalStateBits,
+	const unsigned int collisionStateBits
+) {
+	GML_RECMUTEX_LOCK(qnum); // GetSolidsExact
+
+	const ScratchSpan<int>& quads = GetQuads(scope, pos, radius);
 
+	size_t maxSolids = 0;
+
+	for (const int* a = quads.begin(); a != quads.end(); ++a) {
+		maxSolids += (baseQuads[*a].units.size() + baseQuads[*a].features.size());
+	}
+
+	ScratchSpan<CSolidObject*> solids = scope.Alloc<CSolidObject*>(maxSolids);
+	FilterSolidsExact(solids, quads.begin(), quads.end(), pos, radius, physicalStateBits, collisionStateBits);
+	return solids;
+}
+
+
+std::vector<CUnit*> CQuadField::GetUnits(const float3& pos, float radius)
+{
+	std::vector<CUnit*> units;
+	GetUnits(units, pos, radius);
 	return units;
 }
 
 std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, bool spherical)
 {
-	GML_RECMUTEX_LOCK(qnum); // GetUnitsExact
+	std::vector<CUnit*> units;
+	GetUnitsExact(units, pos, radius, spherical);
+	return units;
+}
+
+std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& mins, const float3& maxs)
+{
+	std::vector<CUnit*> units;
+	GetUnitsExact(units, mins, maxs);
+	return units;
+}
+
+
+void CQuadField::GetUnits(std::vector<CUnit*>& units, const float3& pos, float radius)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetUnits
 
 	const int tempNum = gs->tempNum++;
 
@@ -226,49 +431,55 @@ std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, b
 
 	GetQuads(pos, radius, begQuad, endQuad);
 
-	std::vector<CUnit*> units;
-	std::list<CUnit*>::iterator ui;
+	units.clear();
 
 	for (int* a = begQuad; a != endQuad; ++a) {
-		Quad& quad = baseQuads[*a];
+		const std::vector<CUnit*>& quadUnits = baseQuads[*a].units;
 
-		for (ui = quad.units.begin(); ui != quad.units.end(); ++ui) {
-			if ((*ui)->tempNum == tempNum)
-				continue;
+		for (unsigned int n = 0; n < quadUnits.size(); n++) {
+			CUnit* u = quadUnits[n];
 
-			const float totRad       = radius + (*ui)->radius;
-			const float totRadSq     = totRad * totRad;
-			const float posUnitDstSq = spherical?
-				pos.SqDistance((*ui)->midPos):
-				pos.SqDistance2D((*ui)->midPos);
-
-			if (posUnitDstSq >= totRadSq)
+			if (u->tempNum == tempNum)
 				continue;
 
-			(*ui)->tempNum = tempNum;
-			units.push_back(*ui);
+			u->tempNum = tempNum;
+			units.push_back(u);
 		}
 	}
+}
 
-	return units;
+void CQuadField::GetUnitsExact(std::vector<CUnit*>& units, const float3& pos, float radius, bool spherical)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetUnitsExact
+
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuads(pos, radius, begQuad, endQuad);
+
+	units.clear();
+
+	FilterUnitsExact(units, begQuad, endQuad, pos, radius, spherical);
 }
 
-std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& mins, const float3& maxs)
+void CQuadField::GetUnitsExact(std::vector<CUnit*>& units, const float3& mins, const float3& maxs)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetUnitsExact
 
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CUnit*> units;
-	std::vector<int>::const_iterator qi;
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuadsRectangle(mins, maxs, begQuad, endQuad);
+
+	units.clear();
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		std::list<CUnit*>& quadUnits = baseQuads[*qi].units;
-		std::list<CUnit*>::iterator ui;
+	for (int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CUnit*>& quadUnits = baseQuads[*a].units;
 
-		for (ui = quadUnits.begin(); ui != quadUnits.end(); ++ui) {
-			CUnit* unit = *ui;
+		for (unsigned int n = 0; n < quadUnits.size(); n++) {
+			CUnit* unit = quadUnits[n];
 			const float3& pos = unit->midPos;
 
 			if (unit->tempNum == tempNum) { continue; }
@@ -279,12 +490,9 @@ std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& mins, const float3&
 			units.push_back(unit);
 		}
 	}
-
-	return units;
 }
 
 
-
 unsigned int CQuadField::GetQuadsOnRay(float3 start, float3 dir, float length, int*& begQuad, int*& endQuad)
 {
 	assert(!math::isnan(start.x));
@@ -443,60 +651,126 @@ unsigned int CQuadField::GetQuadsOnRay(float3 start, float3 dir, float length, i
 
 
 
-void CQuadField::MovedUnit(CUnit* unit)
+void CQuadField::InsertUnit(CUnit* unit, const int* begQuad, const int* endQuad)
 {
-	const std::vector<int>& newQuads = GetQuads(unit->pos, unit->radius);
+	unit->quads.assign(begQuad, endQuad);
+	unit->quadSlots.resize(unit->quads.size());
 
-	// compare if the quads have changed, if not stop here
-	if (newQuads.size() == unit->quads.size()) {
-		if (std::equal(newQuads.begin(), newQuads.end(), unit->quads.begin())) {
-			return;
+	for (unsigned int n = 0; n < unit->quads.size(); n++) {
+		Quad& quad = baseQuads[unit->quads[n]];
+
+		std::vector<CUnit*>& quadUnits     = quad.units;
+		std::vector<CUnit*>& quadAllyUnits = quad.teamUnits[unit->allyteam];
+
+		unit->quadSlots[n] = int2(quadUnits.size(), quadAllyUnits.size());
+
+		quadUnits.push_back(unit);
+		quadAllyUnits.push_back(unit);
+	}
+}
+
+void CQuadField::EraseUnit(CUnit* unit)
+{
+	assert(unit->quads.size() == unit->quadSlots.size());
+
+	for (unsigned int n = 0; n < unit->quads.size(); n++) {
+		Quad& quad = baseQuads[unit->quads[n]];
+
+		EraseUnitSlot(quad.units,                     unit->quads[n], unit->quadSlots[n].x, false);
+		EraseUnitSlot(quad.teamUnits[unit->allyteam], unit->quads[n], unit->quadSlots[n].y,  true);
+	}
+
+	unit->quads.clear();
+	unit->quadSlots.clear();
+}
+
+void CQuadField::EraseUnitSlot(std::vector<CUnit*>& cell, int quadIdx, int slotIdx, bool allyCell)
+{
+	assert(slotIdx >= 0 && slotIdx < cell.size());
+
+	CUnit* movedUnit = cell.back();
+
+	cell[slotIdx] = movedUnit;
+	cell.pop_back();
+
+	if (slotIdx == cell.size())
+		return;
+
+	// the last unit in this cell now occupies <slotIdx>, update its bookkeeping
+	for (unsigned int n = 0; n < movedUnit->quads.size(); n++) {
+		if (movedUnit->quads[n] != quadIdx)
+			continue;
+
+		if (allyCell) {
+			movedUnit->quadSlots[n].y = slotIdx;
+		} else {
+			movedUnit->quadSlots[n].x = slotIdx;
 		}
+
+		return;
 	}
 
-	GML_RECMUTEX_LOCK(quad); // MovedUnit
+	assert(false);
+}
+
+void CQuadField::EraseProjectileSlot(std::vector<CProjectile*>& cell, int quadIdx, int slotIdx)
+{
+	assert(slotIdx >= 0 && slotIdx < cell.size());
+
+	CProjectile* movedProj = cell.back();
+
+	const int movedSlotIdx = cell.size() - 1;
+
+	cell[slotIdx] = movedProj;
+	cell.pop_back();
 
-	std::vector<int>::const_iterator qi;
-	for (qi = unit->quads.begin(); qi != unit->quads.end(); ++qi) {
-		std::list<CUnit*>& quadUnits     = baseQuads[*qi].units;
-		std::list<CUnit*>& quadAllyUnits = baseQuads[*qi].teamUnits[unit->allyteam];
-		std::list<CUnit*>::iterator ui;
+	if (slotIdx == movedSlotIdx)
+		return;
+
+	CProjectile::QuadFieldCellData& qfcd = movedProj->GetQuadFieldCellData();
 
-		ui = std::find(quadUnits.begin(), quadUnits.end(), unit);
-		if (ui != quadUnits.end())
-			quadUnits.erase(ui);
+	for (unsigned int n = 0; n < 3; n++) {
+		const int2& coor = qfcd.GetCoor(n);
 
-		ui = std::find(quadAllyUnits.begin(), quadAllyUnits.end(), unit);
-		if (ui != quadAllyUnits.end())
-			quadAllyUnits.erase(ui);
+		if ((coor.y * numQuadsX + coor.x) != quadIdx)
+			continue;
+		if (qfcd.GetSlot(n) != movedSlotIdx)
+			continue;
+
+		qfcd.SetSlot(n, slotIdx);
+		return;
 	}
 
-	for (qi = newQuads.begin(); qi != newQuads.end(); ++qi) {
-		baseQuads[*qi].units.push_front(unit);
-		baseQuads[*qi].teamUnits[unit->allyteam].push_front(unit);
+	assert(false);
+}
+
+
+
+void CQuadField::MovedUnit(CUnit* unit)
+{
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuads(unit->pos, unit->radius, begQuad, endQuad);
+
+	// compare if the quads have changed, if not stop here
+	if ((endQuad - begQuad) == unit->quads.size()) {
+		if (std::equal(begQuad, endQuad, unit->quads.begin())) {
+			return;
+		}
 	}
-	unit->quads = newQuads;
+
+	GML_RECMUTEX_LOCK(quad); // MovedUnit
+
+	EraseUnit(unit);
+	InsertUnit(unit, begQuad, endQuad);
 }
 
 void CQuadField::RemoveUnit(CUnit* unit)
 {
 	GML_RECMUTEX_LOCK(quad); // RemoveUnit
 
-	std::vector<int>::const_iterator qi;
-	for (qi = unit->quads.begin(); qi != unit->quads.end(); ++qi) {
-		std::list<CUnit*>& quadUnits     = baseQuads[*qi].units;
-		std::list<CUnit*>& quadAllyUnits = baseQuads[*qi].teamUnits[unit->allyteam];
-		std::list<CUnit*>::iterator ui;
-
-		ui = std::find(quadUnits.begin(), quadUnits.end(), unit);
-		if (ui != quadUnits.end())
-			quadUnits.erase(ui);
-
-		ui = std::find(quadAllyUnits.begin(), quadAllyUnits.end(), unit);
-		if (ui != quadAllyUnits.end())
-			quadAllyUnits.erase(ui);
-	}
-	unit->quads.clear();
+	EraseUnit(unit);
 }
 
 
@@ -505,11 +779,13 @@ void CQuadField::AddFeature(CFeature* feature)
 {
 	GML_RECMUTEX_LOCK(quad); // AddFeature
 
-	const std::vector<int>& newQuads = GetQuads(feature->pos, feature->radius);
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
 
-	std::vector<int>::const_iterator qi;
-	for (qi = newQuads.begin(); qi != newQuads.end(); ++qi) {
-		baseQuads[*qi].features.push_front(feature);
+	GetQuads(feature->pos, feature->radius, begQuad, endQuad);
+
+	for (int* a = begQuad; a != endQuad; ++a) {
+		baseQuads[*a].features.push_back(feature);
 	}
 }
 
@@ -517,24 +793,30 @@ void CQuadField::RemoveFeature(CFeature* feature)
 {
 	GML_RECMUTEX_LOCK(quad); // RemoveFeature
 
-	const std::vector<int>& quads = GetQuads(feature->pos, feature->radius);
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuads(feature->pos, feature->radius, begQuad, endQuad);
+
+	// features rarely move, a linear search per cell is cheap enough
+	for (int* a = begQuad; a != endQuad; ++a) {
+		std::vector<CFeature*>& quadFeatures = baseQuads[*a].features;
+		std::vector<CFeature*>::iterator fi = std::find(quadFeatures.begin(), quadFeatures.end(), feature);
+
+		if (fi == quadFeatures.end())
+			continue;
 
-	std::vector<int>::const_iterator qi;
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		baseQuads[*qi].features.remove(feature);
+		*fi = quadFeatures.back();
+		quadFeatures.pop_back();
 	}
 
 	#ifdef DEBUG_QUADFIELD
 	for (int x = 0; x < numQuadsX; x++) {
 		for (int z = 0; z < numQuadsZ; z++) {
 			const Quad& q = baseQuads[z * numQuadsX + x];
-			const std::list<CFeature*>& f = q.features;
-
-			std::list<CFeature*>::const_iterator fIt;
+			const std::vector<CFeature*>& f = q.features;
 
-			for (fIt = f.begin(); fIt != f.end(); ++fIt) {
-				assert((*fIt) != feature);
-			}
+			assert(std::find(f.begin(), f.end(), feature) == f.end());
 		}
 	}
 	#endif
@@ -573,7 +855,7 @@ void CQuadField::AddProjectile(CProjectile* p)
 	CProjectile::QuadFieldCellData qfcd;
 
 	typedef CQuadField::Quad Cell;
-	typedef std::list<CProjectile*> List;
+	typedef std::vector<CProjectile*> List;
 
 	if (p->hitscan) {
 		// all coordinates always map to a valid quad
@@ -586,7 +868,8 @@ void CQuadField::AddProjectile(CProjectile* p)
 
 		// projectiles are point-objects so they exist
 		// only in a single cell EXCEPT hit-scan types
-		qfcd.SetIter(0, list.insert(list.end(), p));
+		qfcd.SetSlot(0, list.size());
+		list.push_back(p);
 
 		for (unsigned int n = 1; n < 3; n++) {
 			Cell& ncell = baseQuads[numQuadsX * qfcd.GetCoor(n).y + qfcd.GetCoor(n).x];
@@ -595,9 +878,10 @@ void CQuadField::AddProjectile(CProjectile* p)
 			// prevent possible double insertions (into the same quad-list)
 			// if case p->speed is not large enough to reach adjacent quads
 			if (qfcd.GetCoor(n) != qfcd.GetCoor(n - 1)) {
-				qfcd.SetIter(n, nlist.insert(nlist.end(), p));
+				qfcd.SetSlot(n, nlist.size());
+				nlist.push_back(p);
 			} else {
-				qfcd.SetIter(n, nlist.end());
+				qfcd.SetSlot(n, -1);
 			}
 		}
 	} else {
@@ -606,7 +890,8 @@ void CQuadField::AddProjectile(CProjectile* p)
 		Cell& cell = baseQuads[numQuadsX * qfcd.GetCoor(0).y + qfcd.GetCoor(0).x];
 		List& list = cell.projectiles;
 
-		qfcd.SetIter(0, list.insert(list.end(), p));
+		qfcd.SetSlot(0, list.size());
+		list.push_back(p);
 	}
 
 	p->SetQuadFieldCellData(qfcd);
@@ -620,30 +905,25 @@ void CQuadField::RemoveProjectile(CProjectile* p)
 
 	CProjectile::QuadFieldCellData& qfcd = p->GetQuadFieldCellData();
 
-	typedef CQuadField::Quad Cell;
-	typedef std::list<CProjectile*> List;
-
 	if (p->hitscan) {
 		for (unsigned int n = 0; n < 3; n++) {
-			Cell& cell = baseQuads[numQuadsX * qfcd.GetCoor(n).y + qfcd.GetCoor(n).x];
-			List& list = cell.projectiles;
+			const int quadIdx = numQuadsX * qfcd.GetCoor(n).y + qfcd.GetCoor(n).x;
 
-			if (qfcd.GetIter(n) != list.end()) {
+			if (qfcd.GetSlot(n) >= 0) {
 				// this is O(1) instead of O(n) and crucially
-				// important for projectiles, but less clean
-				list.erase(qfcd.GetIter(n));
+				// important for projectiles
+				EraseProjectileSlot(baseQuads[quadIdx].projectiles, quadIdx, qfcd.GetSlot(n));
 			}
 
-			qfcd.SetIter(n, list.end());
+			qfcd.SetSlot(n, -1);
 		}
 	} else {
-		Cell& cell = baseQuads[numQuadsX * qfcd.GetCoor(0).y + qfcd.GetCoor(0).x];
-		List& list = cell.projectiles;
+		const int quadIdx = numQuadsX * qfcd.GetCoor(0).y + qfcd.GetCoor(0).x;
 
-		assert(qfcd.GetIter(0) != list.end());
+		assert(qfcd.GetSlot(0) >= 0);
 
-		list.erase(qfcd.GetIter(0));
-		qfcd.SetIter(0, list.end());
+		EraseProjectileSlot(baseQuads[quadIdx].projectiles, quadIdx, qfcd.GetSlot(0));
+		qfcd.SetSlot(0, -1);
 	}
 }
 
@@ -651,72 +931,89 @@ void CQuadField::RemoveProjectile(CProjectile* p)
 
 std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius)
 {
-	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
+	std::vector<CFeature*> features;
+	GetFeaturesExact(features, pos, radius);
+	return features;
+}
 
-	const std::vector<int>& quads = GetQuads(pos, radius);
-	const int tempNum = gs->tempNum++;
+std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
+{
+	std::vector<CFeature*> features;
+	GetFeaturesExact(features, pos, radius, spherical);
+	return features;
+}
 
+std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& mins, const float3& maxs)
+{
 	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
-	std::list<CFeature*>::iterator fi;
+	GetFeaturesExact(features, mins, maxs);
+	return features;
+}
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		for (fi = baseQuads[*qi].features.begin(); fi != baseQuads[*qi].features.end(); ++fi) {
-			if ((*fi)->tempNum == tempNum) { continue; }
-			if (pos.SqDistance((*fi)->midPos) >= Square(radius + (*fi)->radius)) { continue; }
 
-			(*fi)->tempNum = tempNum;
-			features.push_back(*fi);
-		}
-	}
+void CQuadField::GetFeaturesExact(std::vector<CFeature*>& features, const float3& pos, float radius)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
 
-	return features;
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuads(pos, radius, begQuad, endQuad);
+
+	features.clear();
+
+	FilterFeaturesExact(features, begQuad, endQuad, pos, radius);
 }
 
-std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
+void CQuadField::GetFeaturesExact(std::vector<CFeature*>& features, const float3& pos, float radius, bool spherical)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
 
-	const std::vector<int>& quads = GetQuads(pos, radius);
 	const int tempNum = gs->tempNum++;
-
-	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
-	std::list<CFeature*>::iterator fi;
 	const float totRadSq = radius * radius;
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		for (fi = baseQuads[*qi].features.begin(); fi != baseQuads[*qi].features.end(); ++fi) {
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuads(pos, radius, begQuad, endQuad);
+
+	features.clear();
+
+	for (int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CFeature*>& quadFeatures = baseQuads[*a].features;
+
+		for (unsigned int n = 0; n < quadFeatures.size(); n++) {
+			CFeature* f = quadFeatures[n];
 
-			if ((*fi)->tempNum == tempNum) { continue; }
+			if (f->tempNum == tempNum) { continue; }
 			if ((spherical ?
-				(pos - (*fi)->midPos).SqLength() :
-				(pos - (*fi)->midPos).SqLength2D()) >= totRadSq) { continue; }
+				(pos - f->midPos).SqLength() :
+				(pos - f->midPos).SqLength2D()) >= totRadSq) { continue; }
 
-			(*fi)->tempNum = tempNum;
-			features.push_back(*fi);
+			f->tempNum = tempNum;
+			features.push_back(f);
 		}
 	}
-
-	return features;
 }
 
-std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& mins, const float3& maxs)
+void CQuadField::GetFeaturesExact(std::vector<CFeature*>& features, const float3& mins, const float3& maxs)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetFeaturesExact
 
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
-	std::list<CFeature*>::iterator fi;
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
+
+	GetQuadsRectangle(mins, maxs, begQuad, endQuad);
+
+	features.clear();
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		std::list<CFeature*>& quadFeatures = baseQuads[*qi].features;
+	for (int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CFeature*>& quadFeatures = baseQuads[*a].features;
 
-		for (fi = quadFeatures.begin(); fi != quadFeatures.end(); ++fi) {
-			CFeature* feature = *fi;
+		for (unsigned int n = 0; n < quadFeatures.size(); n++) {
+			CFeature* feature = quadFeatures[n];
 			const float3& pos = feature->midPos;
 
 			if (feature->tempNum == tempNum) { continue; }
@@ -727,52 +1024,55 @@ std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& mins, const fl
 			features.push_back(feature);
 		}
 	}
-
-	return features;
 }
 
 
 
 std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& pos, float radius)
 {
-	GML_RECMUTEX_LOCK(qnum); // GetProjectilesExact
-
-	const std::vector<int>& quads = GetQuads(pos, radius);
+	std::vector<CProjectile*> projectiles;
+	GetProjectilesExact(projectiles, pos, radius);
+	return projectiles;
+}
 
+std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& mins, const float3& maxs)
+{
 	std::vector<CProjectile*> projectiles;
-	std::vector<int>::const_iterator qi;
-	std::list<CProjectile*>::iterator pi;
+	GetProjectilesExact(projectiles, mins, maxs);
+	return projectiles;
+}
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		std::list<CProjectile*>& quadProjectiles = baseQuads[*qi].projectiles;
 
-		for (pi = quadProjectiles.begin(); pi != quadProjectiles.end(); ++pi) {
-			if ((pos - (*pi)->pos).SqLength() >= Square(radius + (*pi)->radius)) {
-				continue;
-			}
+void CQuadField::GetProjectilesExact(std::vector<CProjectile*>& projectiles, const float3& pos, float radius)
+{
+	GML_RECMUTEX_LOCK(qnum); // GetProjectilesExact
 
-			projectiles.push_back(*pi);
-		}
-	}
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
 
-	return projectiles;
+	GetQuads(pos, radius, begQuad, endQuad);
+
+	projectiles.clear();
+
+	FilterProjectilesExact(projectiles, begQuad, endQuad, pos, radius);
 }
 
-std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& mins, const float3& maxs)
+void CQuadField::GetProjectilesExact(std::vector<CProjectile*>& projectiles, const float3& mins, const float3& maxs)
 {
 	GML_RECMUTEX_LOCK(qnum); // GetProjectilesExact
 
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
 
-	std::vector<CProjectile*> projectiles;
-	std::vector<int>::const_iterator qi;
-	std::list<CProjectile*>::iterator pi;
+	GetQuadsRectangle(mins, maxs, begQuad, endQuad);
 
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		std::list<CProjectile*>& quadProjectiles = baseQuads[*qi].projectiles;
+	projectiles.clear();
 
-		for (pi = quadProjectiles.begin(); pi != quadProjectiles.end(); ++pi) {
-			CProjectile* projectile = *pi;
+	for (int* a = begQuad; a != endQuad; ++a) {
+		const std::vector<CProjectile*>& quadProjectiles = baseQuads[*a].projectiles;
+
+		for (unsigned int n = 0; n < quadProjectiles.size(); n++) {
+			CProjectile* projectile = quadProjectiles[n];
 			const float3& pos = projectile->pos;
 
 			if (pos.x < mins.x || pos.x > maxs.x) { continue; }
@@ -781,8 +1081,6 @@ std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& mins, co
 			projectiles.push_back(projectile);
 		}
 	}
-
-	return projectiles;
 }
 
 
@@ -793,52 +1091,28 @@ std::vector<CSolidObject*> CQuadField::GetSolidsExact(
 	const unsigned int physicalStateBits,
 	const unsigned int collisionStateBits
 ) {
-	GML_RECMUTEX_LOCK(qnum); // GetSolidsExact
-
-	const std::vector<int>& quads = GetQuads(pos, radius);
-	const int tempNum = gs->tempNum++;
-
 	std::vector<CSolidObject*> solids;
-	std::vector<int>::const_iterator qi;
-
-	std::list<CUnit*>::iterator ui;
-	std::list<CFeature*>::iterator fi;
-
-	for (qi = quads.begin(); qi != quads.end(); ++qi) {
-		for (ui = baseQuads[*qi].units.begin(); ui != baseQuads[*qi].units.end(); ++ui) {
-			CUnit* u = *ui;
-
-			if (u->tempNum == tempNum)
-				continue;
-			if (!u->HasPhysicalStateBit(physicalStateBits))
-				continue;
-			if (!u->HasCollidableStateBit(collisionStateBits))
-				continue;
-			if ((pos - u->midPos).SqLength() >= Square(radius + u->radius))
-				continue;
+	GetSolidsExact(solids, pos, radius, physicalStateBits, collisionStateBits);
+	return solids;
+}
 
-			u->tempNum = tempNum;
-			solids.push_back(u);
-		}
+void CQuadField::GetSolidsExact(
+	std::vector<CSolidObject*>& solids,
+	const float3& pos,
+	const float radius,
+	const unsigned int physicalStateBits,
+	const unsigned int collisionStateBits
+) {
+	GML_RECMUTEX_LOCK(qnum); // GetSolidsExact
 
-		for (fi = baseQuads[*qi].features.begin(); fi != baseQuads[*qi].features.end(); ++fi) {
-			CFeature* f = *fi;
+	int* begQuad = &tempQuads[0];
+	int* endQuad = &tempQuads[0];
 
-			if (f->tempNum == tempNum)
-				continue;
-			if (!f->HasPhysicalStateBit(physicalStateBits))
-				continue;
-			if (!f->HasCollidableStateBit(collisionStateBits))
-				continue;
-			if ((pos - f->midPos).SqLength() >= Square(radius + f->radius))
-				continue;
+	GetQuads(pos, radius, begQuad, endQuad);
 
-			f->tempNum = tempNum;
-			solids.push_back(f);
-		}
-	}
+	solids.clear();
 
-	return solids;
+	FilterSolidsExact(solids, begQuad, endQuad, pos, radius, physicalStateBits, collisionStateBits);
 }
 
 
@@ -875,6 +1149,35 @@ std::vector<int> CQuadField::GetQuadsRectangle(const float3& pos1, const float3&
 }
 
 
+unsigned int CQuadField::GetQuadsRectangle(const float3& pos1, const float3& pos2, int*& begQuad, int*& endQuad) const
+{
+	assert(!math::isnan(pos1.x));
+	assert(!math::isnan(pos1.z));
+	assert(!math::isnan(pos2.x));
+	assert(!math::isnan(pos2.z));
+
+	assert(begQuad == &tempQuads[0]);
+	assert(endQuad == &tempQuads[0]);
+
+	const int maxx = std::max(0, std::min((int(pos2.x)) / quadSizeX + 1, numQuadsX - 1));
+	const int maxz = std::max(0, std::min((int(pos2.z)) / quadSizeZ + 1, numQuadsZ - 1));
+
+	const int minx = std::max(0, std::min((int(pos1.x)) / quadSizeX, numQuadsX - 1));
+	const int minz = std::max(0, std::min((int(pos1.z)) / quadSizeZ, numQuadsZ - 1));
+
+	if (maxz < minz || maxx < minx)
+		return 0;
+
+	for (int z = minz; z <= maxz; ++z) {
+		for (int x = minx; x <= maxx; ++x) {
+			*endQuad = z * numQuadsX + x; ++endQuad;
+		}
+	}
+
+	return (endQuad - begQuad);
+}
+
+
 // optimization specifically for projectile collisions
 void CQuadField::GetUnitsAndFeaturesColVol(
 	const float3& pos,
@@ -906,8 +1209,8 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 
 	GetQuads(pos, radius, begQuad, endQuad);
 
-	std::list<CUnit*>::const_iterator ui;
-	std::list<CFeature*>::const_iterator fi;
+	std::vector<CUnit*>::const_iterator ui;
+	std::vector<CFeature*>::const_iterator fi;
 
 	for (int* a = begQuad; a != endQuad; ++a) {
 		const Quad& quad = baseQuads[*a];
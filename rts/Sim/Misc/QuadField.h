@@ -3,13 +3,12 @@
 #ifndef QUAD_FIELD_H
 #define QUAD_FIELD_H
 
-#include <set>
 #include <vector>
-#include <list>
 #include <boost/noncopyable.hpp>
 
 #include "System/creg/creg_cond.h"
 #include "System/float3.h"
+#include "System/Misc/ScratchArena.h"
 
 class CUnit;
 class CFeature;
@@ -33,11 +32,13 @@ public:
 	// optimized functions, somewhat less userfriendly
 	//
 	// when calling these, <begQuad> and <endQuad> are both expected
-	// to point to the *start* of an array of int's of size at least
-	// numQuadsX * numQuadsZ (eg. tempQuads) -- GetQuadsOnRay ensures
-	// this by itself, for GetQuads the callers take care of it
+	// to point to the *start* of an array of int's large enough to
+	// hold every quad touched by the query (eg. tempQuads, which has
+	// numQuadsX * numQuadsZ elements) -- GetQuadsOnRay ensures this
+	// by itself, for GetQuads the callers take care of it
 	//
 	unsigned int GetQuads(float3 pos, float radius, int*& begQuad, int*& endQuad) const;
+	unsigned int GetQuadsRectangle(const float3& pos1, const float3& pos2, int*& begQuad, int*& endQuad) const;
 	unsigned int GetQuadsOnRay(float3 start, float3 dir, float length, int*& begQuad, int*& endQuad);
 
 	void GetUnitsAndFeaturesColVol(
@@ -92,6 +93,66 @@ public:
 		const unsigned int collisionStateBits = 0xFFFFFFFF
 	);
 
+	// buffer versions of the above; each clears the passed
+	// vector and fills it with the results, so callers can
+	// re-use one buffer (and its capacity) across queries
+	void GetUnits(std::vector<CUnit*>& units, const float3& pos, float radius);
+	void GetUnitsExact(std::vector<CUnit*>& units, const float3& pos, float radius, bool spherical = true);
+	void GetUnitsExact(std::vector<CUnit*>& units, const float3& mins, const float3& maxs);
+
+	void GetFeaturesExact(std::vector<CFeature*>& features, const float3& pos, float radius);
+	void GetFeaturesExact(std::vector<CFeature*>& features, const float3& pos, float radius, bool spherical);
+	void GetFeaturesExact(std::vector<CFeature*>& features, const float3& mins, const float3& maxs);
+
+	void GetProjectilesExact(std::vector<CProjectile*>& projectiles, const float3& pos, float radius);
+	void GetProjectilesExact(std::vector<CProjectile*>& projectiles, const float3& mins, const float3& maxs);
+
+	void GetSolidsExact(
+		std::vector<CSolidObject*>& solids,
+		const float3& pos,
+		const float radius,
+		const unsigned int physicalStateBits = 0xFFFFFFFF,
+		const unsigned int collisionStateBits = 0xFFFFFFFF
+	);
+
+	// scratch versions of the above; results are allocated from the
+	// calling thread's CScratchArena and remain valid until <scope>
+	// is destroyed. These never touch tempQuads and never allocate
+	// heap memory (once the arena is warm), so they are safe to use
+	// in hot loops and in code that may re-enter the QuadField from
+	// within its own iteration (eg. through Lua call-ins)
+	ScratchSpan<int> GetQuads(CScratchArena::Scope& scope, float3 pos, float radius) const;
+
+	ScratchSpan<CUnit*> GetUnitsExact(CScratchArena::Scope& scope, const float3& pos, float radius, bool spherical = true);
+	ScratchSpan<CFeature*> GetFeaturesExact(CScratchArena::Scope& scope, const float3& pos, float radius);
+	ScratchSpan<CProjectile*> GetProjectilesExact(CScratchArena::Scope& scope, const float3& pos, float radius);
+	ScratchSpan<CSolidObject*> GetSolidsExact(
+		CScratchArena::Scope& scope,
+		const float3& pos,
+		const float radius,
+		const unsigned int physicalStateBits = 0xFFFFFFFF,
+		const unsigned int collisionStateBits = 0xFFFFFFFF
+	);
+
+	// visitor versions; <f> is called once for each object and is
+	// free to query (or modify) the QuadField itself
+	template<typename F> void ForEachUnitExact(const float3& pos, float radius, F f) {
+		CScratchArena::Scope scope;
+		const ScratchSpan<CUnit*>& units = GetUnitsExact(scope, pos, radius);
+
+		for (CUnit** u = units.begin(); u != units.end(); ++u) {
+			f(*u);
+		}
+	}
+	template<typename F> void ForEachFeatureExact(const float3& pos, float radius, F f) {
+		CScratchArena::Scope scope;
+		const ScratchSpan<CFeature*>& features = GetFeaturesExact(scope, pos, radius);
+
+		for (CFeature** ft = features.begin(); ft != features.end(); ++ft) {
+			f(*ft);
+		}
+	}
+
 	void MovedUnit(CUnit* unit);
 	void RemoveUnit(CUnit* unit);
 
@@ -102,13 +163,21 @@ public:
 	void AddProjectile(CProjectile* projectile);
 	void RemoveProjectile(CProjectile* projectile);
 
+	/**
+	 * Objects are stored contiguously and unordered per quad; removal
+	 * moves the last element of a cell into the vacated slot. Units and
+	 * projectiles remember their slot-index in every cell they occupy
+	 * (CUnit::quadSlots, CProjectile::QuadFieldCellData), which makes
+	 * removal O(1). Do not keep references or iterators into the cells
+	 * across calls that can add or remove objects.
+	 */
 	struct Quad {
 		CR_DECLARE_STRUCT(Quad);
 		Quad();
-		std::list<CUnit*> units;
-		std::vector< std::list<CUnit*> > teamUnits;
-		std::list<CFeature*> features;
-		std::list<CProjectile*> projectiles;
+		std::vector<CUnit*> units;
+		std::vector< std::vector<CUnit*> > teamUnits;
+		std::vector<CFeature*> features;
+		std::vector<CProjectile*> projectiles;
 	};
 
 	const Quad& GetQuad(int i) const {
@@ -129,6 +198,17 @@ public:
 	const static unsigned int BASE_QUAD_SIZE =  128;
 	const static unsigned int NUM_TEMP_QUADS = 1024;
 
+private:
+	template<typename TUnits> void FilterUnitsExact(TUnits& units, const int* begQuad, const int* endQuad, const float3& pos, float radius, bool spherical);
+	template<typename TFeatures> void FilterFeaturesExact(TFeatures& features, const int* begQuad, const int* endQuad, const float3& pos, float radius);
+	template<typename TProjectiles> void FilterProjectilesExact(TProjectiles& projectiles, const int* begQuad, const int* endQuad, const float3& pos, float radius);
+	template<typename TSolids> void FilterSolidsExact(TSolids& solids, const int* begQuad, const int* endQuad, const float3& pos, float radius, unsigned int physicalStateBits, unsigned int collisionStateBits);
+
+	void InsertUnit(CUnit* unit, const int* begQuad, const int* endQuad);
+	void EraseUnit(CUnit* unit);
+	void EraseUnitSlot(std::vector<CUnit*>& cell, int quadIdx, int slotIdx, bool allyCell);
+	void EraseProjectileSlot(std::vector<CProjectile*>& cell, int quadIdx, int slotIdx);
+
 private:
 	std::vector<Quad> baseQuads;
 	std::vector<int> tempQuads;
@@ -5,8 +5,11 @@
 #include "LosHandler.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "System/ThreadPool.h"
 #include "System/TimeProfiler.h"
 
+#include <algorithm>
+
 #ifdef RADARHANDLER_SONAR_JAMMER_MAPS
 	#define SONAR_MAPS CR_MEMBER(sonarJammerMaps),
 #else
@@ -35,7 +38,11 @@ CR_REG_METADATA(CRadarHandler, (
 	SONAR_MAPS
 	CR_MEMBER(seismicMaps),
 	CR_MEMBER(commonJammerMap),
-	CR_MEMBER(commonSonarJammerMap)
+	CR_MEMBER(commonSonarJammerMap),
+	CR_IGNORED(pendingAreas), // only non-empty within a move batch
+	CR_IGNORED(pendingRadars),
+	CR_IGNORED(pendingRemovals),
+	CR_IGNORED(batchDepth)
 ));
 
 
@@ -49,6 +56,7 @@ CRadarHandler::CRadarHandler(bool circularRadar)
   circularRadar(circularRadar),
   xsize(std::max(1, gs->mapx >> radarMipLevel)),
   zsize(std::max(1, gs->mapy >> radarMipLevel)),
+  batchDepth(0),
   radarAlgo(int2(xsize, zsize), -1000, 20, readMap->GetMIPHeightMapSynced(radarMipLevel)),
   baseRadarErrorSize(96.0f),
   baseRadarErrorMult(2.0f)
@@ -101,27 +109,43 @@ void CRadarHandler::MoveUnit(CUnit* unit)
 		RemoveUnit(unit);
 
 		if (unit->jammerRadius) {
-			jammerMaps[unit->allyteam].AddMapArea(newPos, -123, unit->jammerRadius, 1);
-			commonJammerMap.AddMapArea(newPos, -123, unit->jammerRadius, 1);
+			LosDebugTimer timer("RadarHandler::Jammer");
+			RequestMapArea(jammerMaps[unit->allyteam], newPos, unit->jammerRadius, 1);
+			RequestMapArea(commonJammerMap, newPos, unit->jammerRadius, 1);
 		}
 		if (unit->sonarJamRadius) {
+			LosDebugTimer timer("RadarHandler::Jammer");
 #ifdef RADARHANDLER_SONAR_JAMMER_MAPS
-			sonarJammerMaps[unit->allyteam].AddMapArea(newPos, -123, unit->sonarJamRadius, 1);
+			RequestMapArea(sonarJammerMaps[unit->allyteam], newPos, unit->sonarJamRadius, 1);
 #endif
-			commonSonarJammerMap.AddMapArea(newPos, -123, unit->sonarJamRadius, 1);
+			RequestMapArea(commonSonarJammerMap, newPos, unit->sonarJamRadius, 1);
 		}
 		if (unit->radarRadius) {
-			airRadarMaps[unit->allyteam].AddMapArea(newPos, -123, unit->radarRadius, 1);
+			{
+				LosDebugTimer timer("RadarHandler::AirRadar");
+				RequestMapArea(airRadarMaps[unit->allyteam], newPos, unit->radarRadius, 1);
+			}
 			if (!circularRadar) {
-				radarAlgo.LosAdd(newPos, unit->radarRadius, unit->radarHeight, unit->radarSquares);
-				radarMaps[unit->allyteam].AddMapSquares(unit->radarSquares, -123, 1);
+				if (batchDepth > 0) {
+					// radarHeight is only raised temporarily by AMoveType::SlowUpdate
+					const PendingRadar radar = {unit, unit->allyteam, newPos, unit->radarRadius, unit->radarHeight};
+
+					unit->radarPendingIndex = pendingRadars.size();
+					pendingRadars.push_back(radar);
+				} else {
+					LosDebugTimer timer("RadarHandler::Radar");
+					radarAlgo.LosAdd(newPos, unit->radarRadius, unit->radarHeight, unit->radarSquares);
+					radarMaps[unit->allyteam].AddMapSquares(unit->radarSquares, -123, 1);
+				}
 			}
 		}
 		if (unit->sonarRadius) {
-			sonarMaps[unit->allyteam].AddMapArea(newPos, -123, unit->sonarRadius, 1);
+			LosDebugTimer timer("RadarHandler::Sonar");
+			RequestMapArea(sonarMaps[unit->allyteam], newPos, unit->sonarRadius, 1);
 		}
 		if (unit->seismicRadius) {
-			seismicMaps[unit->allyteam].AddMapArea(newPos, -123, unit->seismicRadius, 1);
+			LosDebugTimer timer("RadarHandler::Seismic");
+			RequestMapArea(seismicMaps[unit->allyteam], newPos, unit->seismicRadius, 1);
 		}
 		unit->oldRadarPos = newPos;
 		unit->hasRadarPos = true;
@@ -137,28 +161,144 @@ void CRadarHandler::RemoveUnit(CUnit* unit)
 
 	if (unit->hasRadarPos) {
 		if (unit->jammerRadius) {
-			jammerMaps[unit->allyteam].AddMapArea(unit->oldRadarPos, -123, unit->jammerRadius, -1);
-			commonJammerMap.AddMapArea(unit->oldRadarPos, -123, unit->jammerRadius, -1);
+			RequestMapArea(jammerMaps[unit->allyteam], unit->oldRadarPos, unit->jammerRadius, -1);
+			RequestMapArea(commonJammerMap, unit->oldRadarPos, unit->jammerRadius, -1);
 		}
 		if (unit->sonarJamRadius) {
 #ifdef RADARHANDLER_SONAR_JAMMER_MAPS
-			sonarJammerMaps[unit->allyteam].AddMapArea(unit->oldRadarPos, -123, unit->sonarJamRadius, -1);
+			RequestMapArea(sonarJammerMaps[unit->allyteam], unit->oldRadarPos, unit->sonarJamRadius, -1);
 #endif
-			commonSonarJammerMap.AddMapArea(unit->oldRadarPos, -123, unit->sonarJamRadius, -1);
+			RequestMapArea(commonSonarJammerMap, unit->oldRadarPos, unit->sonarJamRadius, -1);
 		}
 		if (unit->radarRadius) {
-			airRadarMaps[unit->allyteam].AddMapArea(unit->oldRadarPos, -123, unit->radarRadius, -1);
+			RequestMapArea(airRadarMaps[unit->allyteam], unit->oldRadarPos, unit->radarRadius, -1);
+
 			if (!circularRadar) {
-				radarMaps[unit->allyteam].AddMapSquares(unit->radarSquares, -123, -1);
+				if (unit->radarPendingIndex >= 0) {
+					// never made it onto the map, nothing to subtract
+					pendingRadars[unit->radarPendingIndex].unit = NULL;
+					unit->radarPendingIndex = -1;
+				} else if (batchDepth > 0) {
+					pendingRemovals.push_back(PendingRemoval());
+					pendingRemovals.back().allyteam = unit->allyteam;
+					pendingRemovals.back().squares.swap(unit->radarSquares);
+				} else {
+					radarMaps[unit->allyteam].AddMapSquares(unit->radarSquares, -123, -1);
+				}
+
 				unit->radarSquares.clear();
 			}
 		}
 		if (unit->sonarRadius) {
-			sonarMaps[unit->allyteam].AddMapArea(unit->oldRadarPos, -123, unit->sonarRadius, -1);
+			RequestMapArea(sonarMaps[unit->allyteam], unit->oldRadarPos, unit->sonarRadius, -1);
 		}
 		if (unit->seismicRadius) {
-			seismicMaps[unit->allyteam].AddMapArea(unit->oldRadarPos, -123, unit->seismicRadius, -1);
+			RequestMapArea(seismicMaps[unit->allyteam], unit->oldRadarPos, unit->seismicRadius, -1);
 		}
 		unit->hasRadarPos = false;
 	}
 }
+
+
+void CRadarHandler::RequestMapArea(CLosMap& map, int2 pos, int radius, int amount)
+{
+	if (batchDepth == 0) {
+		map.AddMapArea(pos, -123, radius, amount);
+		return;
+	}
+
+	const PendingArea area = {&map, pos, radius, amount};
+	pendingAreas.push_back(area);
+}
+
+
+void CRadarHandler::BeginMoveBatch()
+{
+	batchDepth++;
+}
+
+
+void CRadarHandler::EndMoveBatch()
+{
+	assert(batchDepth > 0);
+
+	if ((--batchDepth) == 0) {
+		FlushPendingUpdates();
+	}
+}
+
+
+void CRadarHandler::FlushPendingUpdates()
+{
+	if (pendingAreas.empty() && pendingRadars.empty() && pendingRemovals.empty())
+		return;
+
+	SCOPED_TIMER("RadarHandler::FlushPendingUpdates");
+
+	{
+		LosDebugTimer timer("RadarHandler::Radar");
+
+		for_mt(0, int(radarMaps.size()), [&](const int allyTeam) {
+			for (size_t i = 0; i < pendingRemovals.size(); i++) {
+				if (pendingRemovals[i].allyteam == allyTeam) {
+					radarMaps[allyTeam].AddMapSquares(pendingRemovals[i].squares, -123, -1);
+				}
+			}
+		});
+
+		std::vector<CLosAlgorithm::BatchItem> items;
+		items.reserve(pendingRadars.size());
+
+		for (size_t i = 0; i < pendingRadars.size(); i++) {
+			const PendingRadar& radar = pendingRadars[i];
+
+			if (radar.unit == NULL)
+				continue;
+
+			const CLosAlgorithm::BatchItem item = {
+				radar.pos,
+				radar.radius,
+				radar.height,
+				radar.allyteam,
+				&radar.unit->radarSquares
+			};
+
+			radar.unit->radarPendingIndex = -1;
+			items.push_back(item);
+		}
+
+		// radar maps never send readmap events, so the ally-team passed
+		// along for the unsynced heightmap does not matter here
+		radarAlgo.LosAddBatch(items, radarMaps);
+	}
+	{
+		LosDebugTimer timer("RadarHandler::AirRadar");
+
+		// group the circular changes by map, each map is then
+		// updated by one task (in queue order)
+		std::vector<CLosMap*> maps;
+		maps.reserve(pendingAreas.size());
+
+		for (size_t i = 0; i < pendingAreas.size(); i++) {
+			maps.push_back(pendingAreas[i].map);
+		}
+
+		std::sort(maps.begin(), maps.end());
+		maps.erase(std::unique(maps.begin(), maps.end()), maps.end());
+
+		for_mt(0, int(maps.size()), [&](const int n) {
+			for (size_t i = 0; i < pendingAreas.size(); i++) {
+				const PendingArea& area = pendingAreas[i];
+
+				if (area.map != maps[n])
+					continue;
+
+				area.map->AddMapArea(area.pos, -123, area.radius, area.amount);
+			}
+		});
+	}
+
+	pendingAreas.clear();
+	pendingRadars.clear();
+	pendingRemovals.clear();
+}
@@ -31,6 +31,17 @@ public:
 	void MoveUnit(CUnit* unit);
 	void RemoveUnit(CUnit* unit);
 
+	/**
+	 * Same as CLosHandler's move batches: the maps are left untouched until
+	 * the matching EndMoveBatch (readers see the coverage from before the
+	 * batch), which then runs the radar ray-casts in parallel and applies
+	 * all queued changes in parallel per map. Batches may be nested.
+	 */
+	void BeginMoveBatch();
+	void EndMoveBatch();
+	/// see CLosHandler::FlushPendingUpdates
+	void FlushPendingUpdates();
+
 	inline int GetSquare(const float3& pos) const
 	{
 		const int gx = pos.x * invRadarDiv;
@@ -160,6 +171,37 @@ public:
 	int zsize;
 
 private:
+	/// changes <map> now, or at the end of the current move batch
+	void RequestMapArea(CLosMap& map, int2 pos, int radius, int amount);
+
+	/// an AddMapArea deferred by a move batch
+	struct PendingArea {
+		CLosMap* map;
+		int2 pos;
+		int radius;
+		int amount;
+	};
+
+	/// a non-circular radar ray-cast deferred by a move batch
+	struct PendingRadar {
+		CUnit* unit; ///< NULL if its radar was removed again while queued
+		int allyteam;
+		int2 pos;
+		int radius;
+		float height;
+	};
+
+	/// non-circular radar squares subtracted within a move batch
+	struct PendingRemoval {
+		int allyteam;
+		std::vector<int> squares;
+	};
+
+	std::vector<PendingArea> pendingAreas;
+	std::vector<PendingRadar> pendingRadars;
+	std::vector<PendingRemoval> pendingRemovals;
+	int batchDepth;
+
 	CLosAlgorithm radarAlgo;
 
 	float baseRadarErrorSize;
@@ -62,6 +62,7 @@ void CClassicGroundMoveType::LeaveTransport() {}
 #include "Sim/Weapons/WeaponDef.h"
 #include "Sim/Weapons/Weapon.h"
 #include "System/EventHandler.h"
+#include "System/Misc/ScratchArena.h"
 #include "System/Sound/SoundChannels.h"
 #include "System/FastMath.h"
 #include "System/myMath.h"
@@ -1102,16 +1103,25 @@ bool CClassicGroundMoveType::CheckColH(int x, int y1, int y2, float xmove, int s
 		bool blocked = false;
 		const int idx1 = y * gs->mapx + x;
 		const int idx2 = y * gs->mapx + squareTestX;
-		const BlockingMapCell& c = groundBlockingObjectMap->GetCell(idx1);
 		const BlockingMapCell& d = groundBlockingObjectMap->GetCell(idx2);
-		BlockingMapCellIt it;
 		float3 posDelta = ZeroVector;
 
 		if (!d.empty() && d.find(owner->id) == d.end()) {
 			continue;
 		}
 
-		for (it = c.begin(); it != c.end(); ++it) {
+		// Move and Kill below change the blocking map and would
+		// invalidate the cell's entries, so iterate over a copy
+		const BlockingMapCell& c = groundBlockingObjectMap->GetCell(idx1);
+
+		CScratchArena::Scope scope;
+		ScratchSpan<BlockingMapEntry> cellObjects = scope.Alloc<BlockingMapEntry>(c.size());
+
+		for (BlockingMapCellIt it = c.begin(); it != c.end(); ++it) {
+			cellObjects.push_back(*it);
+		}
+
+		for (const BlockingMapEntry* it = cellObjects.begin(); it != cellObjects.end(); ++it) {
 			CSolidObject* obj = it->second;
 
 			if (CMoveMath::IsNonBlocking(*m, obj, owner)) {
@@ -1180,16 +1190,25 @@ bool CClassicGroundMoveType::CheckColV(int y, int x1, int x2, float zmove, int s
 		bool blocked = false;
 		const int idx1 = y * gs->mapx + x;
 		const int idx2 = squareTestY * gs->mapx + x;
-		const BlockingMapCell& c = groundBlockingObjectMap->GetCell(idx1);
 		const BlockingMapCell& d = groundBlockingObjectMap->GetCell(idx2);
-		BlockingMapCellIt it;
 		float3 posDelta = ZeroVector;
 
 		if (!d.empty() && d.find(owner->id) == d.end()) {
 			continue;
 		}
 
-		for (it = c.begin(); it != c.end(); ++it) {
+		// Move and Kill below change the blocking map and would
+		// invalidate the cell's entries, so iterate over a copy
+		const BlockingMapCell& c = groundBlockingObjectMap->GetCell(idx1);
+
+		CScratchArena::Scope scope;
+		ScratchSpan<BlockingMapEntry> cellObjects = scope.Alloc<BlockingMapEntry>(c.size());
+
+		for (BlockingMapCellIt it = c.begin(); it != c.end(); ++it) {
+			cellObjects.push_back(*it);
+		}
+
+		for (const BlockingMapEntry* it = cellObjects.begin(); it != cellObjects.end(); ++it) {
 			CSolidObject* obj = it->second;
 
 			if (CMoveMath::IsNonBlocking(*m, obj, owner)) {
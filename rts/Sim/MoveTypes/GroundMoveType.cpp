@@ -77,6 +77,8 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_GMT)
 CR_BIND_DERIVED(CGroundMoveType, AMoveType, (NULL));
 CR_REG_METADATA(CGroundMoveType, (
 	CR_IGNORED(pathController),
+	CR_IGNORED(stagedTerrain),
+	CR_IGNORED(stagedSteering),
 	CR_MEMBER(turnRate),
 	CR_MEMBER(accRate),
 	CR_MEMBER(decRate),
@@ -252,6 +254,54 @@ bool CGroundMoveType::OwnerMoved(const short oldHeading, const float3& posDif, c
 	return true;
 }
 
+void CGroundMoveType::StageUpdate()
+{
+	// NOTE:
+	//   called concurrently for all units, so this must not write to
+	//   anything except stagedTerrain and stagedSteering (and only read
+	//   from the world)
+	const float3& pos = owner->pos;
+
+	stagedTerrain.pos      = pos;
+	stagedTerrain.normal   = ground->GetNormal(pos.x, pos.z);
+	stagedTerrain.slope    = ground->GetSlope(pos.x, pos.z);
+	stagedTerrain.height   = ground->GetHeightReal(pos.x, pos.z);
+	stagedTerrain.revision = readMap->GetSyncedHeightMapRevision();
+	stagedTerrain.valid    = true;
+
+	// the same math as FollowPath and ChangeSpeed, done for the current
+	// waypoint and heading; if GetNextWayPoint or ChangeHeading change
+	// those (or an earlier unit pushes us), Update() recomputes it all
+	StagedSteering& ss = stagedSteering;
+
+	ss.pos             = pos;
+	ss.wayPoint        = currWayPoint;
+	ss.goalPos         = goalPos;
+	ss.frontDir        = owner->frontdir;
+	ss.flatFrontDir    = flatFrontDir;
+	ss.moveDef         = owner->moveDef;
+	ss.turnRate        = turnRate;
+	ss.accRate         = accRate;
+	ss.decRate         = decRate;
+	ss.maxSpeed        = maxSpeed;
+	ss.maxReverseSpeed = maxReverseSpeed;
+	ss.currentSpeed    = currentSpeed;
+	ss.canReverse      = canReverse;
+	ss.reversing       = reversing;
+
+	ss.waypointDir.x = currWayPoint.x - pos.x;
+	ss.waypointDir.z = currWayPoint.z - pos.z;
+	ss.waypointDir.y = 0.0f;
+	ss.waypointDir.SafeNormalize();
+
+	ss.wantReverse = (ss.waypointDir.dot(flatFrontDir) < 0.0f) && WantReverse(ss.waypointDir);
+	ss.groundSpeedMod = (owner->moveDef != NULL)? CMoveMath::GetPosSpeedMod(*owner->moveDef, pos, flatFrontDir): 0.0f;
+
+	ss.heightMapRevision = readMap->GetSyncedHeightMapRevision();
+	ss.typeMapRevision   = readMap->GetSyncedTypeMapRevision();
+	ss.valid             = true;
+}
+
 bool CGroundMoveType::Update()
 {
 	ASSERT_SYNCED(owner->pos);
@@ -468,17 +518,22 @@ bool CGroundMoveType::FollowPath()
 		}
 
 		// set direction to waypoint AFTER requesting it
-		waypointDir.x = currWayPoint.x - owner->pos.x;
-		waypointDir.z = currWayPoint.z - owner->pos.z;
-		waypointDir.y = 0.0f;
-		waypointDir.SafeNormalize();
-
-		ASSERT_SYNCED(waypointDir);
+		if (HaveStagedSteering()) {
+			waypointDir = stagedSteering.waypointDir;
+			wantReverse = stagedSteering.wantReverse;
+		} else {
+			waypointDir.x = currWayPoint.x - owner->pos.x;
+			waypointDir.z = currWayPoint.z - owner->pos.z;
+			waypointDir.y = 0.0f;
+			waypointDir.SafeNormalize();
 
-		if (waypointDir.dot(flatFrontDir) < 0.0f) {
-			wantReverse = WantReverse(waypointDir);
+			if (waypointDir.dot(flatFrontDir) < 0.0f) {
+				wantReverse = WantReverse(waypointDir);
+			}
 		}
 
+		ASSERT_SYNCED(waypointDir);
+
 		// apply obstacle avoidance (steering)
 		const float3 rawWantedDir = waypointDir * Sign(int(!wantReverse));
 		const float3& modWantedDir = GetObstacleAvoidanceDir(rawWantedDir);
@@ -523,7 +578,7 @@ void CGroundMoveType::ChangeSpeed(float newWantedSpeed, bool wantReverse, bool f
 			// the pathfinders do NOT check the entire footprint to determine
 			// passability wrt. terrain (only wrt. structures), so we look at
 			// the center square ONLY for our current speedmod
-			const float groundSpeedMod = CMoveMath::GetPosSpeedMod(*md, owner->pos, flatFrontDir);
+			const float groundSpeedMod = HaveStagedSpeedMod()? stagedSteering.groundSpeedMod: CMoveMath::GetPosSpeedMod(*md, owner->pos, flatFrontDir);
 
 			const float curGoalDistSq = (owner->pos - goalPos).SqLength2D();
 			const float minGoalDistSq = Square(BrakingDistance(currentSpeed));
@@ -826,12 +881,14 @@ void CGroundMoveType::CheckCollisionSkid()
 	//     derived from o->pos (!)
 	const float3& pos = collider->pos;
 
+	CScratchArena::Scope scope;
+
 	const UnitDef* colliderUD = collider->unitDef;
-	const vector<CUnit*>& nearUnits = quadField->GetUnitsExact(pos, collider->radius);
-	const vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(pos, collider->radius);
+	const ScratchSpan<CUnit*>& nearUnits = quadField->GetUnitsExact(scope, pos, collider->radius);
+	const ScratchSpan<CFeature*>& nearFeatures = quadField->GetFeaturesExact(scope, pos, collider->radius);
 
-	vector<CUnit*>::const_iterator ui;
-	vector<CFeature*>::const_iterator fi;
+	CUnit** ui;
+	CFeature** fi;
 
 	for (ui = nearUnits.begin(); ui != nearUnits.end(); ++ui) {
 		CUnit* collidee = *ui;
@@ -1025,9 +1082,11 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 	const float avoidanceRadius = std::max(currentSpeed, 1.0f) * (avoider->radius * 2.0f);
 	const float avoiderRadius = FOOTPRINT_RADIUS(avoiderMD->xsize, avoiderMD->zsize, 1.0f);
 
-	const vector<CSolidObject*>& objects = quadField->GetSolidsExact(avoider->pos, avoidanceRadius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
+	CScratchArena::Scope scope;
+
+	const ScratchSpan<CSolidObject*>& objects = quadField->GetSolidsExact(scope, avoider->pos, avoidanceRadius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 
-	for (vector<CSolidObject*>::const_iterator oi = objects.begin(); oi != objects.end(); ++oi) {
+	for (CSolidObject** oi = objects.begin(); oi != objects.end(); ++oi) {
 		const CSolidObject* avoidee = *oi;
 		const MoveDef* avoideeMD = avoidee->moveDef;
 		const UnitDef* avoideeUD = dynamic_cast<const UnitDef*>(avoidee->objectDef);
@@ -1691,8 +1750,10 @@ void CGroundMoveType::HandleUnitCollisions(
 ) {
 	const float searchRadius = std::max(colliderSpeed, 1.0f) * (colliderRadius * 1.0f);
 
-	const std::vector<CUnit*>& nearUnits = quadField->GetUnitsExact(collider->pos, searchRadius);
-	      std::vector<CUnit*>::const_iterator uit;
+	CScratchArena::Scope scope;
+
+	const ScratchSpan<CUnit*>& nearUnits = quadField->GetUnitsExact(scope, collider->pos, searchRadius);
+	      CUnit** uit;
 
 	// NOTE: probably too large for most units (eg. causes tree falling animations to be skipped)
 	const int dirSign = Sign(int(!reversing));
@@ -1882,8 +1943,10 @@ void CGroundMoveType::HandleFeatureCollisions(
 ) {
 	const float searchRadius = std::max(colliderSpeed, 1.0f) * (colliderRadius * 1.0f);
 
-	const std::vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(collider->pos, searchRadius);
-	      std::vector<CFeature*>::const_iterator fit;
+	CScratchArena::Scope scope;
+
+	const ScratchSpan<CFeature*>& nearFeatures = quadField->GetFeaturesExact(scope, collider->pos, searchRadius);
+	      CFeature** fit;
 
 	const int dirSign = Sign(int(!reversing));
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
@@ -2078,7 +2141,7 @@ bool CGroundMoveType::OnSlope(float minSlideTolerance) {
 	// (otherwise the unit could stop on an invalid path location, and be teleported
 	// back)
 	const float slopeMul = mix(ud->slideTolerance, 1.0f, (minSlideTolerance <= 0.0f));
-	const float curSlope = ground->GetSlope(pos.x, pos.z);
+	const float curSlope = HaveStagedTerrain(pos)? stagedTerrain.slope: ground->GetSlope(pos.x, pos.z);
 	const float maxSlope = md->maxSlope * slopeMul;
 
 	return (curSlope > maxSlope);
@@ -2086,6 +2149,65 @@ bool CGroundMoveType::OnSlope(float minSlideTolerance) {
 
 
 
+bool CGroundMoveType::HaveStagedTerrain(const float3& p) const
+{
+	// samples are only usable if taken at exactly the same position
+	// (no epsilon) and the synced heightmap has not changed since, so
+	// results are bit-identical to querying the ground directly
+	if (!stagedTerrain.valid)
+		return false;
+	if (stagedTerrain.revision != readMap->GetSyncedHeightMapRevision())
+		return false;
+
+	return (p.x == stagedTerrain.pos.x && p.z == stagedTerrain.pos.z);
+}
+
+bool CGroundMoveType::HaveStagedSteering() const
+{
+	// every input of the staged waypoint math must be bit-identical
+	const StagedSteering& ss = stagedSteering;
+	const float3& pos = owner->pos;
+	const float3& dir = owner->frontdir;
+
+	if (!ss.valid)
+		return false;
+	if (ss.pos.x != pos.x || ss.pos.z != pos.z)
+		return false;
+	if (ss.wayPoint.x != currWayPoint.x || ss.wayPoint.z != currWayPoint.z)
+		return false;
+	if (ss.goalPos.x != goalPos.x || ss.goalPos.z != goalPos.z)
+		return false;
+	if (ss.frontDir.x != dir.x || ss.frontDir.y != dir.y || ss.frontDir.z != dir.z)
+		return false;
+	if (ss.flatFrontDir.x != flatFrontDir.x || ss.flatFrontDir.y != flatFrontDir.y || ss.flatFrontDir.z != flatFrontDir.z)
+		return false;
+	if (ss.turnRate != turnRate || ss.accRate != accRate || ss.decRate != decRate)
+		return false;
+	if (ss.maxSpeed != maxSpeed || ss.maxReverseSpeed != maxReverseSpeed || ss.currentSpeed != currentSpeed)
+		return false;
+
+	return (ss.canReverse == canReverse && ss.reversing == reversing);
+}
+
+bool CGroundMoveType::HaveStagedSpeedMod() const
+{
+	const StagedSteering& ss = stagedSteering;
+	const float3& pos = owner->pos;
+
+	if (!ss.valid)
+		return false;
+	if (ss.heightMapRevision != readMap->GetSyncedHeightMapRevision())
+		return false;
+	if (ss.typeMapRevision != readMap->GetSyncedTypeMapRevision())
+		return false;
+	if (ss.moveDef != owner->moveDef)
+		return false;
+	if (ss.pos.x != pos.x || ss.pos.z != pos.z)
+		return false;
+
+	return (ss.flatFrontDir.x == flatFrontDir.x && ss.flatFrontDir.y == flatFrontDir.y && ss.flatFrontDir.z == flatFrontDir.z);
+}
+
 const float3& CGroundMoveType::GetGroundNormal(const float3& p) const
 {
 	if (owner->IsInWater() && !owner->IsOnGround()) {
@@ -2093,13 +2215,16 @@ const float3& CGroundMoveType::GetGroundNormal(const float3& p) const
 		return UpVector;
 	}
 
+	if (HaveStagedTerrain(p))
+		return stagedTerrain.normal;
+
 	return (ground->GetNormal(p.x, p.z));
 }
 
 float CGroundMoveType::GetGroundHeight(const float3& p) const
 {
 	// in [minHeight, maxHeight]
-	const float gh = ground->GetHeightReal(p.x, p.z);
+	const float gh = HaveStagedTerrain(p)? stagedTerrain.height: ground->GetHeightReal(p.x, p.z);
 	const float wh = -owner->unitDef->waterline * (gh <= 0.0f);
 
 	if (owner->unitDef->floatOnWater) {
@@ -21,6 +21,7 @@ public:
 
 	void PostLoad();
 
+	void StageUpdate();
 	bool Update();
 	void SlowUpdate();
 
@@ -99,6 +100,10 @@ private:
 	void CheckCollisionSkid();
 	void CalcSkidRot();
 
+	bool HaveStagedTerrain(const float3&) const;
+	bool HaveStagedSteering() const;
+	bool HaveStagedSpeedMod() const;
+
 	const float3& GetGroundNormal(const float3&) const;
 	float GetGroundHeight(const float3&) const;
 	void AdjustPosToWaterLine();
@@ -112,6 +117,67 @@ private:
 private:
 	IPathController* pathController;
 
+	/// terrain sampled at owner->pos by StageUpdate (unsynced scratch-data)
+	struct StagedTerrain {
+		StagedTerrain(): normal(UpVector), slope(0.0f), height(0.0f), revision(0), valid(false) {}
+
+		float3 pos;
+		float3 normal;
+		float slope;
+		float height;
+
+		unsigned int revision;
+		bool valid;
+	};
+
+	/// waypoint direction, reverse decision and terrain speed-modifier
+	/// computed by StageUpdate from the owner state listed first; only
+	/// used if all of that state is still identical (unsynced scratch-data)
+	struct StagedSteering {
+		StagedSteering()
+			: moveDef(NULL)
+			, turnRate(0.0f)
+			, accRate(0.0f)
+			, decRate(0.0f)
+			, maxSpeed(0.0f)
+			, maxReverseSpeed(0.0f)
+			, currentSpeed(0.0f)
+			, canReverse(false)
+			, reversing(false)
+			, wantReverse(false)
+			, groundSpeedMod(0.0f)
+			, heightMapRevision(0)
+			, typeMapRevision(0)
+			, valid(false)
+		{}
+
+		float3 pos;
+		float3 wayPoint;
+		float3 goalPos;
+		float3 frontDir;
+		float3 flatFrontDir;
+		const MoveDef* moveDef;
+		float turnRate;
+		float accRate;
+		float decRate;
+		float maxSpeed;
+		float maxReverseSpeed;
+		float currentSpeed;
+		bool canReverse;
+		bool reversing;
+
+		float3 waypointDir;
+		bool wantReverse;
+		float groundSpeedMod;
+
+		unsigned int heightMapRevision;
+		unsigned int typeMapRevision;
+		bool valid;
+	};
+
+	StagedTerrain stagedTerrain;
+	StagedSteering stagedSteering;
+
 public:
 	float turnRate;
 	float accRate;
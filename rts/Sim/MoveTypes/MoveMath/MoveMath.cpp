@@ -125,6 +125,16 @@ CMoveMath::BlockType CMoveMath::IsBlockedNoSpeedModCheck(const MoveDef& moveDef,
 	return ret;
 }
 
+/* Only immobile objects (and the map edge) make SquareIsBlocked return BLOCK_STRUCTURE,
+   so squares without any can be skipped without walking their blocking-map cell */
+static inline bool SquareMayHaveStructure(int xSquare, int zSquare)
+{
+	if (xSquare < 0 || zSquare < 0 || xSquare >= gs->mapx || zSquare >= gs->mapy)
+		return true;
+
+	return ((groundBlockingObjectMap->GetSquareFlags(xSquare + zSquare * gs->mapx) & CGroundBlockingObjectMap::SQUARE_HAS_STRUCTURE) != 0);
+}
+
 /* Optimized function to check if the square at the given position has a structure block,
    provided that the square at (xSquare - 1, zSquare) did not have a structure block */
 bool CMoveMath::IsBlockedStructureXmax(const MoveDef& moveDef, int xSquare, int zSquare, const CSolidObject* collider)
@@ -135,6 +145,8 @@ bool CMoveMath::IsBlockedStructureXmax(const MoveDef& moveDef, int xSquare, int
 
 	// (footprints are point-symmetric around <xSquare, zSquare>)
 	for (int z = zmin; z <= zmax; z += zstep) {
+		if (!SquareMayHaveStructure(xmax, z))
+			continue;
 		if (SquareIsBlocked(moveDef, xmax, z, collider) & BLOCK_STRUCTURE)
 			return true;
 	}
@@ -152,6 +164,8 @@ bool CMoveMath::IsBlockedStructureZmax(const MoveDef& moveDef, int xSquare, int
 
 	// (footprints are point-symmetric around <xSquare, zSquare>)
 	for (int x = xmin; x <= xmax; x += xstep) {
+		if (!SquareMayHaveStructure(x, zmax))
+			continue;
 		if (SquareIsBlocked(moveDef, x, zmax, collider) & BLOCK_STRUCTURE)
 			return true;
 	}
@@ -258,9 +272,15 @@ CMoveMath::BlockType CMoveMath::SquareIsBlocked(const MoveDef& moveDef, int xSqu
 	if (xSquare < 0 || zSquare < 0 || xSquare >= gs->mapx || zSquare >= gs->mapy)
 		return BLOCK_IMPASSABLE;
 
+	const int mapSquare = xSquare + zSquare * gs->mapx;
+
+	// common case: nothing on this square at all
+	if (groundBlockingObjectMap->GetSquareFlags(mapSquare) == 0)
+		return BLOCK_NONE;
+
 	BlockType r = BLOCK_NONE;
 
-	const BlockingMapCell& c = groundBlockingObjectMap->GetCell(xSquare + zSquare * gs->mapx);
+	const BlockingMapCell& c = groundBlockingObjectMap->GetCell(mapSquare);
 
 	for (BlockingMapCellIt it = c.begin(); it != c.end(); ++it) {
 		const CSolidObject* collidee = it->second;
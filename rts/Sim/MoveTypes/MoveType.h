@@ -39,6 +39,14 @@ public:
 	virtual void SetMaxSpeed(float speed) { maxSpeed = std::max(0.001f, speed); }
 	virtual void SetWantedMaxSpeed(float speed) { maxWantedSpeed = speed; }
 
+	/**
+	 * First half of the split-phase update (see CUnitHandler::UpdateUnitMoveTypes),
+	 * called for all active units in parallel before the serial Update() pass.
+	 * Implementations may only read shared sim-state and only write unsynced data
+	 * of their own; anything Update() consumes from there must be validated such
+	 * that the outcome is identical to a purely serial update.
+	 */
+	virtual void StageUpdate() {}
 	virtual bool Update() = 0;
 	virtual void SlowUpdate();
 
@@ -1,12 +1,14 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <algorithm>
+#include <cassert>
 
 #include "PathCache.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "System/Log/ILog.h"
 
-#define MAX_CACHE_QUEUE_SIZE   200
+#define MAX_CACHE_ITEMS          512
+#define MAX_CACHE_MEMORY         (1024 * 1024)
 #define MAX_PATH_LIFETIME_SECS   7
 #define USE_NONCOLLIDABLE_HASH   1
 
@@ -15,19 +17,43 @@ CPathCache::CPathCache(int blocksX, int blocksZ)
 	, numBlocksZ(blocksZ)
 	, numBlocks(numBlocksX * numBlocksZ)
 
+	, clockHand(0)
+	, slotBits(0)
+	, numBytesUsed(0)
+
 	, maxCacheSize(0)
 	, numCacheHits(0)
 	, numCacheMisses(0)
 	, numHashCollisions(0)
-{}
+{
+	// keep the table at most half full
+	while ((1U << slotBits) < (MAX_CACHE_ITEMS * 2))
+		slotBits++;
+
+	CacheSlot emptySlot;
+	emptySlot.hash = 0;
+	emptySlot.entry = -1;
+
+	cacheSlots.resize(1 << slotBits, emptySlot);
+	cacheEntries.resize(MAX_CACHE_ITEMS);
+	freeEntries.reserve(MAX_CACHE_ITEMS);
+
+	for (int n = MAX_CACHE_ITEMS - 1; n >= 0; n--) {
+		cacheEntries[n].used = false;
+		cacheEntries[n].referenced = false;
+		freeEntries.push_back(n);
+	}
+}
 
 CPathCache::~CPathCache()
 {
-	LOG("[%s(%ux%u)] cacheHits=%u hitPercentage=%.0f%% numHashColls=%u maxCacheSize=%lu",
-		__FUNCTION__, numBlocksX, numBlocksZ, numCacheHits, GetCacheHitPercentage(), numHashCollisions, maxCacheSize);
+	unsigned int numEvictions = 0;
+
+	for (unsigned int n = 0; n < stats.size(); n++)
+		numEvictions += stats[n].numEvictions;
 
-	for (CachedPathConstIter iter = cachedPaths.begin(); iter != cachedPaths.end(); ++iter)
-		delete (iter->second);
+	LOG("[%s(%ux%u)] cacheHits=%u hitPercentage=%.0f%% numHashColls=%u numEvictions=%u maxCacheSize=%lu",
+		__FUNCTION__, numBlocksX, numBlocksZ, numCacheHits, GetCacheHitPercentage(), numHashCollisions, numEvictions, maxCacheSize);
 }
 
 bool CPathCache::AddPath(
@@ -38,34 +64,49 @@ bool CPathCache::AddPath(
 	float goalRadius,
 	int pathType
 ) {
-	if (cacheQue.size() > MAX_CACHE_QUEUE_SIZE)
-		RemoveFrontQueItem();
-
 	const boost::uint64_t hash = GetHash(strtBlock, goalBlock, goalRadius, pathType);
 	const boost::uint32_t cols = numHashCollisions;
-	const CachedPathConstIter iter = cachedPaths.find(hash);
+	const int slot = FindSlot(hash);
 
 	// register any hash collisions
-	if (iter != cachedPaths.end()) {
-		return ((numHashCollisions += HashCollision(iter->second, strtBlock, goalBlock, goalRadius, pathType)) != cols);
+	if (slot >= 0) {
+		const CacheItem* ci = &cacheEntries[cacheSlots[slot].entry].item;
+		return ((numHashCollisions += HashCollision(ci, strtBlock, goalBlock, goalRadius, pathType)) != cols);
 	}
 
-	CacheItem* ci = new CacheItem();
-	ci->path       = *path; // copy
-	ci->result     = result;
-	ci->strtBlock  = strtBlock;
-	ci->goalBlock  = goalBlock;
-	ci->goalRadius = goalRadius;
-	ci->pathType   = pathType;
+	// NOTE: sizes, not capacities (these differ between platforms)
+	const unsigned int numBytes =
+		sizeof(CacheEntry) +
+		path->path.size() * sizeof(float3) +
+		path->squares.size() * sizeof(int2);
+
+	const int entryIdx = AllocEntry(numBytes);
 
-	cachedPaths[hash] = ci;
+	if (entryIdx < 0)
+		return false;
+
+	CacheEntry& ce = cacheEntries[entryIdx];
+	CacheItem& ci = ce.item;
+	ci.path       = *path; // copy (reuses the pooled waypoint storage)
+	ci.result     = result;
+	ci.strtBlock  = strtBlock;
+	ci.goalBlock  = goalBlock;
+	ci.goalRadius = goalRadius;
+	ci.pathType   = pathType;
+
+	ce.hash = hash;
+	ce.timeout = gs->frameNum + GAME_SPEED * MAX_PATH_LIFETIME_SECS;
+	ce.numBytes = numBytes;
+
+	InsertSlot(hash, entryIdx);
 
 	CacheQue cq;
+	cq.timeout = ce.timeout;
+	cq.entry = entryIdx;
 	cq.hash = hash;
-	cq.timeout = gs->frameNum + GAME_SPEED * MAX_PATH_LIFETIME_SECS;
 
 	cacheQue.push_back(cq);
-	maxCacheSize = std::max<boost::uint64_t>(maxCacheSize, cacheQue.size());
+	maxCacheSize = std::max<boost::uint64_t>(maxCacheSize, MAX_CACHE_ITEMS - freeEntries.size());
 	return false;
 }
 
@@ -76,40 +117,173 @@ const CPathCache::CacheItem* CPathCache::GetCachedPath(
 	int pathType
 ) {
 	const boost::uint64_t hash = GetHash(strtBlock, goalBlock, goalRadius, pathType);
-	const CachedPathConstIter iter = cachedPaths.find(hash);
+	const int slot = FindSlot(hash);
 
-	if (iter == cachedPaths.end()) {
-		++numCacheMisses; return NULL;
+	Stats& s = GetStatsRef(pathType);
+
+	if (slot < 0) {
+		++numCacheMisses; ++s.numMisses; return NULL;
 	}
-	if (iter->second->strtBlock != strtBlock) {
-		++numCacheMisses; return NULL;
+
+	CacheEntry& ce = cacheEntries[cacheSlots[slot].entry];
+
+	if (ce.item.strtBlock != strtBlock) {
+		++numCacheMisses; ++s.numMisses; return NULL;
 	}
-	if (iter->second->goalBlock != goalBlock) {
-		++numCacheMisses; return NULL;
+	if (ce.item.goalBlock != goalBlock) {
+		++numCacheMisses; ++s.numMisses; return NULL;
 	}
-	if (iter->second->pathType != pathType) {
-		++numCacheMisses; return NULL;
+	if (ce.item.pathType != pathType) {
+		++numCacheMisses; ++s.numMisses; return NULL;
 	}
 
-	++numCacheHits;
-	return (iter->second);
+	ce.referenced = true;
+
+	++numCacheHits; ++s.numHits;
+	return &ce.item;
 }
 
 void CPathCache::Update()
 {
-	while (!cacheQue.empty() && (cacheQue.front().timeout) < gs->frameNum)
-		RemoveFrontQueItem();
+	while (!cacheQue.empty() && (cacheQue.front().timeout) < gs->frameNum) {
+		const CacheQue& cq = cacheQue.front();
+		const CacheEntry& ce = cacheEntries[cq.entry];
+
+		// skip entries that were evicted (and possibly reused) before expiring
+		if (ce.used && ce.hash == cq.hash && ce.timeout == cq.timeout) {
+			GetStatsRef(ce.item.pathType).numExpirations += 1;
+			FreeEntry(cq.entry);
+		}
+
+		cacheQue.pop_front();
+	}
+}
+
+
+
+int CPathCache::AllocEntry(unsigned int numBytes)
+{
+	if (numBytes > MAX_CACHE_MEMORY)
+		return -1;
+
+	while (freeEntries.empty() || (numBytesUsed + numBytes) > MAX_CACHE_MEMORY) {
+		if (!EvictEntry())
+			return -1;
+	}
+
+	const int entryIdx = freeEntries.back();
+
+	freeEntries.pop_back();
+	cacheEntries[entryIdx].used = true;
+	cacheEntries[entryIdx].referenced = false;
+
+	numBytesUsed += numBytes;
+	return entryIdx;
+}
+
+void CPathCache::FreeEntry(int entryIdx)
+{
+	CacheEntry& ce = cacheEntries[entryIdx];
+	const int slot = FindSlot(ce.hash);
+
+	assert(ce.used);
+	assert(slot >= 0 && cacheSlots[slot].entry == entryIdx);
+
+	EraseSlot(slot);
+
+	ce.used = false;
+	ce.referenced = false;
+
+	numBytesUsed -= ce.numBytes;
+	freeEntries.push_back(entryIdx);
 }
 
-void CPathCache::RemoveFrontQueItem()
+bool CPathCache::EvictEntry()
 {
-	const CachedPathConstIter it = cachedPaths.find((cacheQue.front()).hash);
+	// CLOCK: entries that were hit since the hand last passed
+	// them get a second chance, the first other one is evicted
+	for (unsigned int n = 0; n < (MAX_CACHE_ITEMS * 2); n++) {
+		CacheEntry& ce = cacheEntries[clockHand];
+		const int entryIdx = clockHand;
 
-	assert(it != cachedPaths.end());
-	delete (it->second);
+		clockHand = (clockHand + 1) % MAX_CACHE_ITEMS;
+
+		if (!ce.used)
+			continue;
+
+		if (ce.referenced) {
+			ce.referenced = false;
+			continue;
+		}
+
+		GetStatsRef(ce.item.pathType).numEvictions += 1;
+		FreeEntry(entryIdx);
+		return true;
+	}
+
+	return false;
+}
+
+
+
+unsigned int CPathCache::GetHomeSlot(boost::uint64_t hash) const
+{
+	// Fibonacci hashing, the keys themselves are far from uniform
+	return ((hash * 0x9E3779B97F4A7C15ULL) >> (64 - slotBits));
+}
+
+int CPathCache::FindSlot(boost::uint64_t hash) const
+{
+	const unsigned int mask = cacheSlots.size() - 1;
+
+	for (unsigned int i = GetHomeSlot(hash); cacheSlots[i].entry >= 0; i = (i + 1) & mask) {
+		if (cacheSlots[i].hash == hash)
+			return i;
+	}
+
+	return -1;
+}
+
+void CPathCache::InsertSlot(boost::uint64_t hash, int entryIdx)
+{
+	const unsigned int mask = cacheSlots.size() - 1;
+
+	unsigned int i = GetHomeSlot(hash);
+
+	while (cacheSlots[i].entry >= 0)
+		i = (i + 1) & mask;
+
+	cacheSlots[i].hash = hash;
+	cacheSlots[i].entry = entryIdx;
+}
+
+void CPathCache::EraseSlot(unsigned int i)
+{
+	const unsigned int mask = cacheSlots.size() - 1;
+
+	// backward-shift deletion, keeps probe sequences intact without tombstones
+	for (unsigned int j = (i + 1) & mask; cacheSlots[j].entry >= 0; j = (j + 1) & mask) {
+		const unsigned int k = GetHomeSlot(cacheSlots[j].hash);
+
+		// entry at j may stay if its home slot lies cyclically in (i, j]
+		if ((i <= j)? ((i < k) && (k <= j)): ((i < k) || (k <= j)))
+			continue;
+
+		cacheSlots[i] = cacheSlots[j];
+		i = j;
+	}
+
+	cacheSlots[i].entry = -1;
+}
+
+
+
+CPathCache::Stats& CPathCache::GetStatsRef(unsigned int pathType)
+{
+	if (pathType >= stats.size())
+		stats.resize(pathType + 1);
 
-	cachedPaths.erase(it);
-	cacheQue.pop_front();
+	return stats[pathType];
 }
 
 boost::uint64_t CPathCache::GetHash(
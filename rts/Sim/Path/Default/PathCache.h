@@ -3,12 +3,24 @@
 #ifndef PATHCACHE_H
 #define PATHCACHE_H
 
-#include <map>
-#include <list>
+#include <deque>
+#include <vector>
 
 #include "IPath.h"
+#include "Sim/Path/IPathManager.h"
 #include "System/type2.h"
 
+/**
+ * Estimator paths by (start-block, goal-block, goal-radius, MoveDef).
+ *
+ * Items live in a fixed pool (so their waypoint storage is reused) and are
+ * indexed by an open-addressing hash-table. An item is dropped when it is
+ * older than MAX_PATH_LIFETIME_SECS, or by CLOCK (second-chance LRU) when
+ * the pool is full or the waypoints exceed the memory budget.
+ *
+ * NOTE: the synced cache decides which paths units follow, so eviction may
+ * only ever depend on synced state (no timers, no allocator capacities).
+ */
 class CPathCache
 {
 public:
@@ -24,6 +36,8 @@ public:
 		int pathType;
 	};
 
+	typedef IPathManager::PathCacheStats Stats;
+
 	void Update();
 	bool AddPath(
 		const IPath::Path* path,
@@ -41,8 +55,45 @@ public:
 		int pathType
 	);
 
+	/// counters for paths of <pathType>, NULL if none were recorded yet
+	const Stats* GetStats(unsigned int pathType) const {
+		return ((pathType < stats.size())? &stats[pathType]: NULL);
+	}
+
+	size_t GetMemFootPrint() const { return numBytesUsed; }
+
 private:
-	void RemoveFrontQueItem();
+	struct CacheEntry {
+		CacheItem item;
+		boost::uint64_t hash;
+		boost::int32_t timeout;
+		boost::uint32_t numBytes;
+
+		bool used;
+		bool referenced;
+	};
+
+	struct CacheSlot {
+		boost::uint64_t hash;
+		boost::int32_t entry; ///< -1 if the slot is empty
+	};
+
+	struct CacheQue {
+		boost::int32_t timeout;
+		boost::int32_t entry;
+		boost::uint64_t hash;
+	};
+
+	int FindSlot(boost::uint64_t hash) const;
+	unsigned int GetHomeSlot(boost::uint64_t hash) const;
+	void InsertSlot(boost::uint64_t hash, int entry);
+	void EraseSlot(unsigned int slot);
+
+	int AllocEntry(unsigned int numBytes);
+	void FreeEntry(int entry);
+	bool EvictEntry();
+
+	Stats& GetStatsRef(unsigned int pathType);
 
 	boost::uint64_t GetHash(
 		const int2 strtBlk,
@@ -67,20 +118,20 @@ private:
 	}
 
 private:
-	struct CacheQue {
-		boost::int32_t timeout;
-		boost::uint64_t hash;
-	};
-
-	std::list<CacheQue> cacheQue;
-	std::map<boost::uint64_t, CacheItem*> cachedPaths;
-
-	typedef std::map<boost::uint64_t, CacheItem*>::const_iterator CachedPathConstIter;
+	std::vector<CacheSlot> cacheSlots;
+	std::vector<CacheEntry> cacheEntries;
+	std::vector<int> freeEntries;
+	std::deque<CacheQue> cacheQue;
+	std::vector<Stats> stats;
 
 	boost::uint32_t numBlocksX;
 	boost::uint32_t numBlocksZ;
 	boost::uint64_t numBlocks;
 
+	boost::uint32_t clockHand;
+	boost::uint32_t slotBits;
+	boost::uint64_t numBytesUsed;
+
 	boost::uint64_t maxCacheSize;
 	boost::uint32_t numCacheHits;
 	boost::uint32_t numCacheMisses;
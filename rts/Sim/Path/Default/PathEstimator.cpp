@@ -4,11 +4,8 @@
 
 #include "PathEstimator.h"
 
+#include <algorithm>
 #include <fstream>
-#include <boost/bind.hpp>
-#include <boost/thread/barrier.hpp>
-
-#include "minizip/zip.h"
 
 #include "PathAllocator.h"
 #include "PathCache.h"
@@ -16,7 +13,10 @@
 #include "PathFinderDef.h"
 #include "PathFlowMap.hpp"
 #include "PathLog.h"
+#include "Sim/Path/PathCacheFile.h"
 #include "Map/ReadMap.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "Game/LoadScreen.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveMath/MoveMath.h"
@@ -25,9 +25,8 @@
 #include "Net/Protocol/NetProtocol.h"
 #include "System/ThreadPool.h"
 #include "System/TimeProfiler.h"
+#include "System/Misc/SpringTime.h"
 #include "System/Config/ConfigHandler.h"
-#include "System/FileSystem/Archives/IArchive.h"
-#include "System/FileSystem/ArchiveLoader.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
@@ -42,10 +41,13 @@ static const std::string GetPathCacheDir() {
 
 static size_t GetNumThreads() {
 	const size_t numThreads = std::max(0, configHandler->GetInt("PathingThreadCount"));
-	const size_t numCores = Threading::GetAvailableCores();
-	return ((numThreads == 0)? numCores: numThreads);
+	const size_t numPoolThreads = ThreadPool::GetNumThreads();
+	return ((numThreads == 0)? numPoolThreads: std::min(numThreads, numPoolThreads));
 }
 
+// frames between two infolog reports of the runtime update stats
+static const int UPDATE_STATS_REPORT_RATE = GAME_SPEED * 60;
+
 void* CPathEstimator::operator new(size_t size) { return PathAllocator::Alloc(size); }
 void CPathEstimator::operator delete(void* p, size_t size) { PathAllocator::Free(p, size); }
 
@@ -61,8 +63,8 @@ CPathEstimator::CPathEstimator(CPathFinder* pf, unsigned int BSIZE, const std::s
 	nextOffsetMessageIdx(0),
 	nextCostMessageIdx(0),
 	pathChecksum(0),
-	offsetBlockNum(nbrOfBlocksX * nbrOfBlocksZ),
-	costBlockNum(nbrOfBlocksX * nbrOfBlocksZ),
+	nextOffsetItem(0),
+	nextCostItem(0),
 	blockStates(int2(nbrOfBlocksX, nbrOfBlocksZ), int2(gs->mapx, gs->mapy)),
 
 	mStartBlockIdx(0),
@@ -91,7 +93,12 @@ CPathEstimator::CPathEstimator(CPathFinder* pf, unsigned int BSIZE, const std::s
 	mGoalSqrOffset.x = BLOCK_SIZE >> 1;
 	mGoalSqrOffset.y = BLOCK_SIZE >> 1;
 
-	vertexCosts.resize(moveDefHandler->GetNumMoveDefs() * blockStates.GetSize() * PATH_DIRECTION_VERTICES, PATHCOST_INFINITY);
+	numVertexCosts = moveDefHandler->GetNumMoveDefs() * blockStates.GetSize() * PATH_DIRECTION_VERTICES;
+	vertexCostsBuffer.resize(numVertexCosts, PATHCOST_INFINITY);
+	vertexCosts = &vertexCostsBuffer[0];
+	blockObsoleteFrames.resize(blockStates.GetSize(), 0);
+	blockPathCounts.resize(blockStates.GetSize(), 0);
+	blockPathStamps.resize(blockStates.GetSize(), 0);
 
 	// load precalculated data if it exists
 	InitEstimator(cacheFileName, mapFileName);
@@ -107,10 +114,10 @@ CPathEstimator::~CPathEstimator()
 void CPathEstimator::InitEstimator(const std::string& cacheFileName, const std::string& map)
 {
 	const unsigned int numThreads = GetNumThreads();
+	const spring_time loadStartTime = spring_gettime();
 
-	if (threads.size() != numThreads) {
-		threads.resize(numThreads);
-		pathFinders.resize(numThreads);
+	if (pathFinders.size() != numThreads) {
+		pathFinders.resize(numThreads, NULL);
 	}
 
 	pathFinders[0] = pathFinder;
@@ -118,9 +125,13 @@ void CPathEstimator::InitEstimator(const std::string& cacheFileName, const std::
 	// Not much point in multithreading these...
 	InitBlocks();
 
-	if (!ReadFile(cacheFileName, map)) {
-		// start extra threads if applicable, but always keep the total
-		// memory-footprint made by CPathFinder instances within bounds
+	stats.cacheLoaded = ReadFile(cacheFileName, map);
+	stats.loadThreads = 0;
+
+	if (!stats.cacheLoaded) {
+		// use as many ThreadPool workers as there are threads, but always
+		// keep the total memory-footprint made by CPathFinder instances
+		// within bounds
 		const unsigned int minMemFootPrint = sizeof(CPathFinder) + pathFinder->GetMemFootPrint();
 		const unsigned int maxMemFootPrint = configHandler->GetInt("MaxPathCostsMemoryFootPrint") * 1024 * 1024;
 		const unsigned int numExtraThreads = std::min(int(numThreads - 1), std::max(0, int(maxMemFootPrint / minMemFootPrint) - 1));
@@ -136,32 +147,37 @@ void CPathEstimator::InitEstimator(const std::string& cacheFileName, const std::
 			loadscreen->SetLoadMessage(calcMsg);
 		}
 
-		// note: only really needed if numExtraThreads > 0
-		pathBarrier = new boost::barrier(numExtraThreads + 1);
-
 		for (unsigned int i = 1; i <= numExtraThreads; i++) {
 			pathFinders[i] = new CPathFinder();
-			threads[i] = new boost::thread(boost::bind(&CPathEstimator::CalcOffsetsAndPathCosts, this, i));
 		}
 
-		// Use the current thread as thread zero
-		CalcOffsetsAndPathCosts(0);
+		CalcOffsetsAndPathCosts(numExtraThreads + 1);
 
 		for (unsigned int i = 1; i <= numExtraThreads; i++) {
-			threads[i]->join();
-			delete threads[i];
 			delete pathFinders[i];
+			pathFinders[i] = NULL;
 		}
 
-		delete pathBarrier;
+		stats.loadThreads = numExtraThreads + 1;
 
 		loadscreen->SetLoadMessage("PathCosts: writing", true);
-		WriteFile(cacheFileName, map);
+
+		// map the written cache, so its pages can be shared with
+		// any other engine processes that start on the same map
+		if (WriteFile(cacheFileName, map))
+			ReadFile(cacheFileName, map);
+
 		loadscreen->SetLoadMessage("PathCosts: written", true);
 	}
 
 	pathCache[0] = new CPathCache(nbrOfBlocksX, nbrOfBlocksZ);
 	pathCache[1] = new CPathCache(nbrOfBlocksX, nbrOfBlocksZ);
+
+	stats.loadTime = spring_diffmsecs(spring_gettime(), loadStartTime);
+
+	LOG("[%s] PE%u cache %s in %.0fms (%u blocks, %u MoveDefs, %u PF threads)",
+		__FUNCTION__, BLOCK_SIZE, (stats.cacheLoaded? "read": "generated"), stats.loadTime,
+		blockStates.GetSize(), moveDefHandler->GetNumMoveDefs(), stats.loadThreads);
 }
 
 
@@ -177,58 +193,64 @@ void CPathEstimator::InitBlocks() {
 }
 
 
-__FORCE_ALIGN_STACK__
-void CPathEstimator::CalcOffsetsAndPathCosts(unsigned int threadNum) {
-	// reset FPU state for synced computations
-	streflop::streflop_init<streflop::Simple>();
-
-	if (threadNum > 0) {
-		// FIXME: not running any thread on core 0 is a big perf-hit
-		// Threading::SetAffinity(1 << threadNum);
-		Threading::SetAffinity(~0);
-		Threading::SetThreadName(IntToString(threadNum, "pathhelper%i"));
-	}
-
+void CPathEstimator::CalcOffsetsAndPathCosts(unsigned int numPathFinders) {
 	// NOTE: EstimatePathCosts() [B] is temporally dependent on CalculateBlockOffsets() [A],
 	// A must be completely finished before B_i can be safely called. This means we cannot
 	// let thread i execute (A_i, B_i), but instead have to split the work such that every
 	// thread finishes its part of A before any starts B_i.
-	const unsigned int maxBlockIdx = blockStates.GetSize() - 1;
-	int i;
-
-	while ((i = --offsetBlockNum) >= 0)
-		CalculateBlockOffsets(maxBlockIdx - i, threadNum);
+	//
+	// The work is split into (block, MoveDef) items and handed out through an atomic
+	// counter: there is one ThreadPool task per CPathFinder instance, and each keeps
+	// pulling items until none are left, so idle workers take over the remainder
+	// of slower ones (blocks differ a lot in cost, e.g. water vs. dense cliffs).
+	const int numMoveDefs = moveDefHandler->GetNumMoveDefs();
+	const int numItems = blockStates.GetSize() * numMoveDefs;
+
+	nextOffsetItem = 0;
+	nextCostItem = 0;
+
+	for_mt(0, numPathFinders, [&](const int pfNum) {
+		// reset FPU state for synced computations
+		streflop::streflop_init<streflop::Simple>();
+
+		for (int i = nextOffsetItem++; i < numItems; i = nextOffsetItem++) {
+			CalculateBlockOffsets(i / numMoveDefs, i % numMoveDefs, pfNum);
+		}
+	});
 
-	pathBarrier->wait();
+	for_mt(0, numPathFinders, [&](const int pfNum) {
+		streflop::streflop_init<streflop::Simple>();
 
-	while ((i = --costBlockNum) >= 0)
-		EstimatePathCosts(maxBlockIdx - i, threadNum);
+		for (int i = nextCostItem++; i < numItems; i = nextCostItem++) {
+			EstimatePathCosts(i / numMoveDefs, i % numMoveDefs, pfNum);
+		}
+	});
 }
 
 
-void CPathEstimator::CalculateBlockOffsets(unsigned int blockIdx, unsigned int threadNum)
+void CPathEstimator::CalculateBlockOffsets(unsigned int blockIdx, unsigned int pathType, unsigned int /*pfNum*/)
 {
 	const unsigned int x = blockIdx % nbrOfBlocksX;
 	const unsigned int z = blockIdx / nbrOfBlocksX;
 
-	if (threadNum == 0 && blockIdx >= nextOffsetMessageIdx) {
+	// progress is only reported by tasks that run on the loading thread
+	if (ThreadPool::GetThreadNum() == 0 && blockIdx >= nextOffsetMessageIdx) {
 		nextOffsetMessageIdx = blockIdx + blockStates.GetSize() / 16;
 		net->Send(CBaseNetProtocol::Get().SendCPUUsage(BLOCK_SIZE | (blockIdx << 8)));
 	}
 
-	for (unsigned int i = 0; i < moveDefHandler->GetNumMoveDefs(); i++) {
-		MoveDef* md = moveDefHandler->GetMoveDefByPathType(i);
-		if (md->udRefCount > 0) {
-			blockStates.peNodeOffsets[blockIdx][md->pathType] = FindOffset(*md, x, z);
-		}
+	const MoveDef* md = moveDefHandler->GetMoveDefByPathType(pathType);
+
+	if (md->udRefCount > 0) {
+		blockStates.peNodeOffsets[blockIdx][md->pathType] = FindOffset(*md, x, z);
 	}
 }
 
-void CPathEstimator::EstimatePathCosts(unsigned int blockIdx, unsigned int threadNum) {
+void CPathEstimator::EstimatePathCosts(unsigned int blockIdx, unsigned int pathType, unsigned int pfNum) {
 	const unsigned int x = blockIdx % nbrOfBlocksX;
 	const unsigned int z = blockIdx / nbrOfBlocksX;
 
-	if (threadNum == 0 && blockIdx >= nextCostMessageIdx) {
+	if (ThreadPool::GetThreadNum() == 0 && blockIdx >= nextCostMessageIdx) {
 		nextCostMessageIdx = blockIdx + blockStates.GetSize() / 16;
 
 		char calcMsg[128];
@@ -238,11 +260,10 @@ void CPathEstimator::EstimatePathCosts(unsigned int blockIdx, unsigned int threa
 		loadscreen->SetLoadMessage(calcMsg, (blockIdx != 0));
 	}
 
-	for (unsigned int i = 0; i < moveDefHandler->GetNumMoveDefs(); i++) {
-		MoveDef* md = moveDefHandler->GetMoveDefByPathType(i);
-		if (md->udRefCount > 0) {
-			CalculateVertices(*md, x, z, threadNum);
-		}
+	const MoveDef* md = moveDefHandler->GetMoveDefByPathType(pathType);
+
+	if (md->udRefCount > 0) {
+		CalculateVertices(*md, x, z, pfNum);
 	}
 }
 
@@ -427,6 +448,7 @@ void CPathEstimator::MapChanged(unsigned int x1, unsigned int z1, unsigned int x
 
 						updatedBlocks.push_back(sb);
 						blockStates.nodeMask[z * nbrOfBlocksX + x] |= PATHOPT_OBSOLETE;
+						blockObsoleteFrames[z * nbrOfBlocksX + x] = gs->frameNum;
 					}
 				}
 			}
@@ -435,13 +457,54 @@ void CPathEstimator::MapChanged(unsigned int x1, unsigned int z1, unsigned int x
 }
 
 
+void CPathEstimator::AddActivePath(const IPath::Path& path, unsigned int pathID) {
+	std::vector<unsigned int>& pathBlocks = activePathBlocks[pathID];
+
+	for (IPath::path_list_type::const_iterator it = path.path.begin(); it != path.path.end(); ++it) {
+		const int blockX = Clamp(int(it->x / (BLOCK_SIZE * SQUARE_SIZE)), 0, int(nbrOfBlocksX) - 1);
+		const int blockZ = Clamp(int(it->z / (BLOCK_SIZE * SQUARE_SIZE)), 0, int(nbrOfBlocksZ) - 1);
+		const int blockN = blockZ * nbrOfBlocksX + blockX;
+
+		// count every path at most once per block, it can have
+		// several waypoints in a block and is passed per resolution
+		if (blockPathStamps[blockN] == pathID)
+			continue;
+
+		blockPathStamps[blockN] = pathID;
+		blockPathCounts[blockN] += 1;
+
+		pathBlocks.push_back(blockN);
+	}
+}
+
+void CPathEstimator::RemoveActivePath(unsigned int pathID) {
+	const std::map<unsigned int, std::vector<unsigned int> >::iterator it = activePathBlocks.find(pathID);
+
+	if (it == activePathBlocks.end())
+		return;
+
+	for (size_t i = 0; i < it->second.size(); i++) {
+		const unsigned int blockN = it->second[i];
+
+		// clear the stamp, the path may be counted again
+		blockPathCounts[blockN] -= 1;
+		blockPathStamps[blockN] = 0;
+	}
+
+	activePathBlocks.erase(it);
+}
+
+
 /**
- * Update some obsolete blocks using the FIFO-principle
+ * Update some obsolete blocks, those crossed by the most active paths first
+ * and otherwise using the FIFO-principle
  */
 void CPathEstimator::Update() {
 	pathCache[0]->Update();
 	pathCache[1]->Update();
 
+	ReportUpdateStats();
+
 	static const unsigned int MIN_BLOCKS_TO_UPDATE = std::max(BLOCKS_TO_UPDATE >> 1, 4U);
 	static const unsigned int MAX_BLOCKS_TO_UPDATE = std::min(BLOCKS_TO_UPDATE << 1, MIN_BLOCKS_TO_UPDATE);
 	const unsigned int progressiveUpdates = updatedBlocks.size() * 0.007f * ((BLOCK_SIZE >= 16)? 1.0f : 0.6f);
@@ -455,37 +518,51 @@ void CPathEstimator::Update() {
 	if (updatedBlocks.empty())
 		return;
 
-	std::vector<SingleBlock> v;
-	v.reserve(blocksToUpdate);
+	// each MapChanged() call adds the SingleBlock's of all MoveDefs of a
+	// PE-block consecutively; they must always be processed in one rush,
+	// since blockStates.nodeMask saves PATHOPT_OBSOLETE just for the block
+	// and not per MoveDef (otherwise changes could be missed for some)
+	struct BlockGroup {
+		std::list<SingleBlock>::iterator beg;
+		std::list<SingleBlock>::iterator end;
+		unsigned int numPaths;
 
-	// CalculateVertices (not threadsafe)
-	for (unsigned int n = 0; !updatedBlocks.empty() && n < blocksToUpdate; ) {
-		// copy the next block in line
-		const SingleBlock sb = updatedBlocks.front();
-		updatedBlocks.pop_front();
-
-		// check if it's not already updated
-		if (blockStates.nodeMask[sb.blockPos.y * nbrOfBlocksX + sb.blockPos.x] & PATHOPT_OBSOLETE) {
-			// no need to check for duplicates, cause FindOffset is deterministic
-			// and so even when we compute it multiple times the result will be the same
-			v.push_back(sb);
-
-			// always process all movedefs of a square in one rush
-			// needed cause blockStates.nodeMask saves PATHOPT_OBSOLETE just for the square and not the movedefs
-			// if we wouldn't process them in one rush, it could happen that square changes are missed for `lower` movdefs
-			for (auto it = updatedBlocks.begin(), E = updatedBlocks.end(); it != E; ++it) {
-				if ((it->blockPos.x == sb.blockPos.x) && (it->blockPos.y == sb.blockPos.y)) {
-					v.push_back(sb);
-					n++;
-				} else {
-					updatedBlocks.erase(updatedBlocks.begin(), ++it);
-					break;
-				}
-			}
+		bool operator < (const BlockGroup& g) const { return (numPaths > g.numPaths); }
+	};
+
+	std::vector<BlockGroup> groups;
+
+	for (std::list<SingleBlock>::iterator it = updatedBlocks.begin(); it != updatedBlocks.end(); ) {
+		const int2 blockPos = it->blockPos;
+		const unsigned int blockN = blockPos.y * nbrOfBlocksX + blockPos.x;
+
+		BlockGroup g;
+		g.beg = it;
+		g.numPaths = blockPathCounts[blockN];
+
+		while (it != updatedBlocks.end() && it->blockPos == blockPos)
+			++it;
 
-			// one stale SingleBlock consumed
-			n++;
+		g.end = it;
+
+		// drop groups whose block is not obsolete anymore
+		if ((blockStates.nodeMask[blockN] & PATHOPT_OBSOLETE) == 0) {
+			updatedBlocks.erase(g.beg, g.end);
+			continue;
 		}
+
+		groups.push_back(g);
+	}
+
+	// stable, so blocks crossed by equally many paths stay in FIFO order
+	std::stable_sort(groups.begin(), groups.end());
+
+	std::vector<SingleBlock> v;
+	v.reserve(blocksToUpdate);
+
+	for (unsigned int i = 0; i < groups.size() && v.size() < blocksToUpdate; i++) {
+		v.insert(v.end(), groups[i].beg, groups[i].end);
+		updatedBlocks.erase(groups[i].beg, groups[i].end);
 	}
 
 	blockUpdatePenalty += std::max(0, int(v.size()) - int(blocksToUpdate));
@@ -516,28 +593,47 @@ void CPathEstimator::Update() {
 
 			const unsigned int blockX = sb.blockPos.x;
 			const unsigned int blockZ = sb.blockPos.y;
-			const unsigned int blockN = blockZ * nbrOfBlocksX + blockX;
 
-			const MoveDef* currBlockMD = sb.moveDef;
-			const MoveDef* nextBlockMD = NULL;
-			if ((n + 1) < v.size()) {
-				nextBlockMD = v[n + 1].moveDef;
-			}
+			CalculateVertices(*sb.moveDef, blockX, blockZ);
+		}
+	}
 
-			CalculateVertices(*currBlockMD, blockX, blockZ);
+	for (unsigned int n = 0; n < v.size(); ++n) {
+		const unsigned int blockN = v[n].blockPos.y * nbrOfBlocksX + v[n].blockPos.x;
 
-			// each MapChanged() call adds AT MOST <moveDefs.size()> SingleBlock's
-			// in ascending pathType order per (x, z) PE-block, therefore when the
-			// next SingleBlock's pathType is less or equal to the current we know
-			// that all have been processed (for one PE-block)
-			if (nextBlockMD == NULL || nextBlockMD->pathType <= currBlockMD->pathType) {
-				blockStates.nodeMask[blockN] &= ~PATHOPT_OBSOLETE;
-			}
-		}
+		if ((blockStates.nodeMask[blockN] & PATHOPT_OBSOLETE) == 0)
+			continue;
+
+		const unsigned int latency = gs->frameNum - blockObsoleteFrames[blockN];
+
+		blockStates.nodeMask[blockN] &= ~PATHOPT_OBSOLETE;
+
+		stats.numUpdatedBlocks += 1;
+		stats.sumUpdateLatency += latency;
+		stats.maxUpdateLatency = std::max(stats.maxUpdateLatency, latency);
 	}
 }
 
 
+void CPathEstimator::ReportUpdateStats() {
+	if ((gs->frameNum % UPDATE_STATS_REPORT_RATE) != 0)
+		return;
+	if (stats.numUpdatedBlocks == reportedStats.numUpdatedBlocks)
+		return;
+
+	// stats are cumulative (see GetStats), report what changed since the last time
+	const unsigned int numUpdatedBlocks = stats.numUpdatedBlocks - reportedStats.numUpdatedBlocks;
+	const unsigned int sumUpdateLatency = stats.sumUpdateLatency - reportedStats.sumUpdateLatency;
+
+	LOG("[%s] PE%u: %u blocks updated, latency %.1f (avg) %u (max) frames, %u queued",
+		__FUNCTION__, BLOCK_SIZE, numUpdatedBlocks,
+		sumUpdateLatency / float(numUpdatedBlocks), stats.maxUpdateLatency,
+		(unsigned int) updatedBlocks.size());
+
+	reportedStats = stats;
+}
+
+
 void CPathEstimator::UpdateFull() {
 	while (!updatedBlocks.empty()) {
 		Update();
@@ -565,6 +661,7 @@ IPath::SearchResult CPathEstimator::GetPath(
 
 	// initial calculations
 	maxBlocksToBeSearched = std::min(maxSearchedBlocks, MAX_SEARCHED_NODES_PE - 8U);
+	testedBlocks = 0;
 
 	int2 startBlock;
 		startBlock.x = start.x / BLOCK_PIXEL_SIZE;
@@ -757,7 +854,7 @@ void CPathEstimator::TestBlock(
 		return;
 	}
 
-	if (vertexIdx < 0 || vertexIdx >= vertexCosts.size())
+	if (vertexIdx < 0 || vertexIdx >= numVertexCosts)
 		return;
 
 	if (vertexCosts[vertexIdx] >= PATHCOST_INFINITY)
@@ -868,8 +965,7 @@ void CPathEstimator::ResetSearch() {
 
 
 /**
- * Try to read offset and vertices data from file, return false on failure
- * TODO: Read-error-check.
+ * Try to map offset and vertices data from file, return false on failure
  */
 bool CPathEstimator::ReadFile(const std::string& cacheFileName, const std::string& map)
 {
@@ -879,115 +975,70 @@ bool CPathEstimator::ReadFile(const std::string& cacheFileName, const std::strin
 	sprintf(hashString, "%u", hash);
 	LOG("[PathEstimator::%s] hash=%s\n", __FUNCTION__, hashString);
 
-	std::string filename = GetPathCacheDir() + map + hashString + "." + cacheFileName + ".zip";
+	const std::string filename = GetPathCacheDir() + map + hashString + "." + cacheFileName + ".pecache";
 	if (!FileSystem::FileExists(filename))
 		return false;
-	// open file for reading from a suitable location (where the file exists)
-	IArchive* pfile = archiveLoader.OpenArchive(dataDirsAccess.LocateFile(filename), "sdz");
-
-	if (!pfile || !pfile->IsOpen()) {
-		delete pfile;
-		return false;
-	}
 
 	char calcMsg[512];
 	sprintf(calcMsg, "Reading Estimate PathCosts [%d]", BLOCK_SIZE);
 	loadscreen->SetLoadMessage(calcMsg);
 
-	std::auto_ptr<IArchive> auto_pfile(pfile);
-	IArchive& file(*pfile);
-
-	const unsigned fid = file.FindFile("pathinfo");
-
-	if (fid < file.NumFiles()) {
-		pathChecksum = file.GetCrc32(fid);
-
-		std::vector<boost::uint8_t> buffer;
-		file.GetFile(fid, buffer);
-
-		if (buffer.size() < 4)
-			return false;
-
-		unsigned filehash = *((unsigned*)&buffer[0]);
-		if (filehash != hash)
-			return false;
+	// copy-on-write: blocks recalculated at runtime only
+	// give this process private copies of their pages
+	if (!cacheFile.Open(dataDirsAccess.LocateFile(filename), hash, 2, CMappedFile::MAP_COPYONWRITE))
+		return false;
 
-		unsigned pos = sizeof(unsigned);
+	const unsigned int blockSize = moveDefHandler->GetNumMoveDefs() * sizeof(int2);
 
-		// Read block-center-offset data.
-		const unsigned blockSize = moveDefHandler->GetNumMoveDefs() * sizeof(int2);
-		if (buffer.size() < pos + blockSize * blockStates.GetSize())
-			return false;
+	if (cacheFile.GetSectionSize(0) != (blockSize * blockStates.GetSize()) || cacheFile.GetSectionSize(1) != (numVertexCosts * sizeof(float))) {
+		cacheFile.Close();
+		return false;
+	}
 
-		for (int blocknr = 0; blocknr < blockStates.GetSize(); blocknr++) {
-			std::memcpy(&blockStates.peNodeOffsets[blocknr][0], &buffer[pos], blockSize);
-			pos += blockSize;
-		}
+	// Read block-center-offset data (small, copied).
+	for (int blocknr = 0; blocknr < blockStates.GetSize(); blocknr++) {
+		std::memcpy(&blockStates.peNodeOffsets[blocknr][0], cacheFile.GetSection(0) + blocknr * blockSize, blockSize);
+	}
 
-		// Read vertices data.
-		if (buffer.size() < pos + vertexCosts.size() * sizeof(float))
-			return false;
-		std::memcpy(&vertexCosts[0], &buffer[pos], vertexCosts.size() * sizeof(float));
+	// Use vertices data in-place.
+	vertexCosts = reinterpret_cast<float*>(cacheFile.GetMutableSection(1));
+	std::vector<float>().swap(vertexCostsBuffer);
 
-		// File read successful.
-		return true;
-	} else {
-		return false;
-	}
+	pathChecksum = cacheFile.GetChecksum();
+	return true;
 }
 
 
 /**
  * Try to write offset and vertex data to file.
  */
-void CPathEstimator::WriteFile(const std::string& cacheFileName, const std::string& map)
+bool CPathEstimator::WriteFile(const std::string& cacheFileName, const std::string& map)
 {
-	// We need this directory to exist
-	if (!FileSystem::CreateDirectory(GetPathCacheDir()))
-		return;
-
 	const unsigned int hash = Hash();
 	char hashString[64] = {0};
 
 	sprintf(hashString, "%u", hash);
 	LOG("[PathEstimator::%s] hash=%s\n", __FUNCTION__, hashString);
 
-	const std::string filename = GetPathCacheDir() + map + hashString + "." + cacheFileName + ".zip";
-
-	// open file for writing in a suitable location
-	zipFile file = zipOpen(dataDirsAccess.LocateFile(filename, FileQueryFlags::WRITE).c_str(), APPEND_STATUS_CREATE);
-
-	if (file == NULL)
-		return;
-
-	zipOpenNewFileInZip(file, "pathinfo", NULL, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_BEST_COMPRESSION);
+	const std::string filename = GetPathCacheDir() + map + hashString + "." + cacheFileName + ".pecache";
+	const unsigned int blockSize = moveDefHandler->GetNumMoveDefs() * sizeof(int2);
 
-	// Write hash. (NOTE: this also affects the CRC!)
-	zipWriteInFileInZip(file, (void*) &hash, 4);
+	// gather the block-center-offsets
+	std::vector<int2> offsets;
+	offsets.reserve(blockStates.GetSize() * moveDefHandler->GetNumMoveDefs());
 
-	// Write block-center-offsets.
 	for (int blocknr = 0; blocknr < blockStates.GetSize(); blocknr++)
-		zipWriteInFileInZip(file, (void*) &blockStates.peNodeOffsets[blocknr][0], moveDefHandler->GetNumMoveDefs() * sizeof(int2));
+		offsets.insert(offsets.end(), blockStates.peNodeOffsets[blocknr].begin(), blockStates.peNodeOffsets[blocknr].end());
 
-	// Write vertices.
-	zipWriteInFileInZip(file, &vertexCosts[0], vertexCosts.size() * sizeof(float));
+	std::vector<CPathCacheFile::Section> sections;
+	sections.push_back(CPathCacheFile::Section(&offsets[0], blockSize * blockStates.GetSize()));
+	sections.push_back(CPathCacheFile::Section(vertexCosts, numVertexCosts * sizeof(float)));
 
-	zipCloseFileInZip(file);
-	zipClose(file, NULL);
-
-
-	// get the CRC over the written path data
-	IArchive* pfile = archiveLoader.OpenArchive(dataDirsAccess.LocateFile(filename), "sdz");
-
-	if (pfile == NULL)
-		return;
-
-	if (pfile->IsOpen()) {
-		assert(pfile->FindFile("pathinfo") < pfile->NumFiles());
-		pathChecksum = pfile->GetCrc32(pfile->FindFile("pathinfo"));
-	}
+	// We need this directory to exist; if it can not be created,
+	// Write fails but still sets pathChecksum from the sections
+	FileSystem::CreateDirectory(GetPathCacheDir());
 
-	delete pfile;
+	return (CPathCacheFile::Write(dataDirsAccess.LocateFile(filename, FileQueryFlags::WRITE), hash, sections, &pathChecksum));
 }
 
 
@@ -5,14 +5,17 @@
 
 #include <string>
 #include <list>
+#include <map>
 #include <queue>
 
 #include "IPath.h"
 #include "PathConstants.h"
 #include "PathDataTypes.h"
+#include "Sim/Path/IPathManager.h"
+#include "Sim/Path/PathCacheFile.h"
 #include "System/float3.h"
 
-#include <boost/detail/atomic_count.hpp>
+#include <atomic>
 #include <boost/cstdint.hpp>
 
 struct MoveDef;
@@ -21,13 +24,10 @@ class CPathEstimatorDef;
 class CPathFinderDef;
 class CPathCache;
 
-namespace boost {
-	class thread;
-	class barrier;
-}
-
 class CPathEstimator {
 public:
+	typedef IPathManager::PathEstimatorStats Stats;
+
 	/**
 	 * Creates a new estimator based on a couple of parameters
 	 * @param pathFinder
@@ -94,6 +94,15 @@ public:
 	 */
 	void MapChanged(unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2);
 
+	/**
+	 * Obsolete blocks crossed by more active paths are recalculated first.
+	 * CPathManager adds the waypoints of a path whenever it is (re)computed
+	 * and removes the path when it is deleted; only synced paths may be
+	 * counted.
+	 */
+	void AddActivePath(const IPath::Path& path, unsigned int pathID);
+	void RemoveActivePath(unsigned int pathID);
+
 
 	/**
 	 * called every frame
@@ -108,18 +117,24 @@ public:
 	boost::uint32_t GetPathChecksum() const { return pathChecksum; }
 
 	unsigned int GetBlockSize() const { return BLOCK_SIZE; }
+	/// number of blocks tested by the last GetPath call (0 if it was cached)
+	unsigned int GetNumTestedBlocks() const { return testedBlocks; }
 	unsigned int GetNumBlocksX() const { return nbrOfBlocksX; }
 	unsigned int GetNumBlocksZ() const { return nbrOfBlocksZ; }
 
 	PathNodeStateBuffer& GetNodeStateBuffer() { return blockStates; }
+	const CPathCache* GetPathCache(bool synced) const { return pathCache[synced]; }
+
+	const Stats& GetStats() const { return stats; }
 
 private:
 	void InitEstimator(const std::string& cacheFileName, const std::string& map);
 	void InitBlocks();
 
-	void CalcOffsetsAndPathCosts(unsigned int threadNum);
-	void CalculateBlockOffsets(unsigned int, unsigned int);
-	void EstimatePathCosts(unsigned int, unsigned int);
+	void CalcOffsetsAndPathCosts(unsigned int numPathFinders);
+	void CalculateBlockOffsets(unsigned int, unsigned int, unsigned int);
+	void EstimatePathCosts(unsigned int, unsigned int, unsigned int);
+	void ReportUpdateStats();
 
 	int2 FindOffset(const MoveDef&, unsigned int, unsigned int);
 	void CalculateVertices(const MoveDef&, unsigned int, unsigned int, unsigned int threadNum = 0);
@@ -132,7 +147,7 @@ private:
 	void ResetSearch();
 
 	bool ReadFile(const std::string& cacheFileName, const std::string& map);
-	void WriteFile(const std::string& cacheFileName, const std::string& map);
+	bool WriteFile(const std::string& cacheFileName, const std::string& map);
 	unsigned int Hash() const;
 
 private:
@@ -158,11 +173,10 @@ private:
 	unsigned int nextOffsetMessageIdx;
 	unsigned int nextCostMessageIdx;
 
-	boost::uint32_t pathChecksum;               ///< currently crc from the zip
+	boost::uint32_t pathChecksum;               ///< combined crc of the cache-file sections
 
-	boost::detail::atomic_count offsetBlockNum;
-	boost::detail::atomic_count costBlockNum;
-	boost::barrier* pathBarrier;
+	std::atomic<int> nextOffsetItem;            ///< next (block, MoveDef) item to calculate the offset for
+	std::atomic<int> nextCostItem;              ///< next (block, MoveDef) item to calculate the vertex costs for
 
 	CPathFinder* pathFinder;
 	CPathCache* pathCache[2];                   /// [0] = !synced, [1] = synced
@@ -172,12 +186,23 @@ private:
 	PathPriorityQueue openBlocks;               /// The priority-queue used to select next block to be searched.
 
 	std::vector<CPathFinder*> pathFinders;
-	std::vector<boost::thread*> threads;
 
-	std::vector<float> vertexCosts;
+	CPathCacheFile cacheFile;                   /// Backs vertexCosts if the cache could be mapped,
+	std::vector<float> vertexCostsBuffer;       /// ... and this if it could not (yet).
+	float* vertexCosts;
+	unsigned int numVertexCosts;
+
 	std::list<unsigned int> dirtyBlocks;        /// List of blocks changed in last search.
 	std::list<SingleBlock> updatedBlocks;       /// Blocks that may need an update due to map changes.
 
+	std::vector<int> blockObsoleteFrames;       /// Frame in which each block was last marked obsolete.
+	std::vector<unsigned int> blockPathCounts;  /// Number of active paths crossing each block.
+	std::vector<unsigned int> blockPathStamps;  /// ID of the last path counted for each block.
+	std::map<unsigned int, std::vector<unsigned int> > activePathBlocks; /// Blocks counted for each active path.
+
+	Stats stats;
+	Stats reportedStats;                        /// stats at the time of the last report
+
 	int2 directionVectors[PATH_DIRECTIONS];
 	int2 mStartBlock;
 	int2 mGoalBlock;
@@ -5,9 +5,11 @@
 #include "PathConstants.h"
 #include "PathFinder.h"
 #include "PathEstimator.h"
+#include "PathCache.h"
 #include "PathFlowMap.hpp"
 #include "PathHeatMap.hpp"
 #include "Map/MapInfo.h"
+#include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Objects/SolidObjectDef.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
@@ -21,7 +23,7 @@
 
 
 
-CPathManager::CPathManager(): nextPathID(0)
+CPathManager::CPathManager(): nextPathID(0), batchDepth(0)
 {
 	pathFlowMap = PathFlowMap::GetInstance();
 	pathHeatMap = PathHeatMap::GetInstance();
@@ -54,6 +56,91 @@ CPathManager::~CPathManager()
 
 
 
+void CPathManager::BeginRequestBatch()
+{
+	batchDepth += 1;
+}
+
+void CPathManager::EndRequestBatch()
+{
+	assert(batchDepth > 0);
+
+	if ((batchDepth -= 1) == 0) {
+		sharedSearches.clear();
+	}
+}
+
+/*
+Runs an estimator search, or (inside a request batch) reuses the result of
+an earlier one for the same MoveDef and goal that started in the same or an
+adjacent block; the caller's own start is connected to it by LowRes2MedRes
+and MedRes2MaxRes as usual.
+*/
+IPath::SearchResult CPathManager::GetEstimatorPath(
+	CPathEstimator* pe,
+	const MoveDef& moveDef,
+	const CPathFinderDef& peDef,
+	const float3& startPos,
+	IPath::Path& path,
+	bool synced
+) {
+	if (batchDepth == 0)
+		return (pe->GetPath(moveDef, peDef, startPos, path, MAX_SEARCHED_NODES_PE >> 3, synced));
+
+	const int blockPixelSize = pe->GetBlockSize() * SQUARE_SIZE;
+	const int2 startBlock(startPos.x / blockPixelSize, startPos.z / blockPixelSize);
+	const int2 goalSquare(peDef.goalSquareX, peDef.goalSquareZ);
+
+	batchStats.numRequests += 1;
+
+	for (std::vector<SharedSearch>::const_iterator it = sharedSearches.begin(); it != sharedSearches.end(); ++it) {
+		if (it->pe != pe || it->pathType != moveDef.pathType || it->synced != synced)
+			continue;
+		if (it->goalSquare != goalSquare || it->sqGoalRadius != peDef.sqGoalRadius)
+			continue;
+		if (std::abs(it->startBlock.x - startBlock.x) > 1 || std::abs(it->startBlock.y - startBlock.y) > 1)
+			continue;
+
+		path = it->path;
+
+		batchStats.numCoalesced += 1;
+		batchStats.numSavedBlocks += it->numTestedBlocks;
+		return it->result;
+	}
+
+	SharedSearch search;
+	search.pe = pe;
+	search.pathType = moveDef.pathType;
+	search.startBlock = startBlock;
+	search.goalSquare = goalSquare;
+	search.sqGoalRadius = peDef.sqGoalRadius;
+	search.synced = synced;
+	search.result = pe->GetPath(moveDef, peDef, startPos, path, MAX_SEARCHED_NODES_PE >> 3, synced);
+	search.path = path;
+	search.numTestedBlocks = pe->GetNumTestedBlocks();
+
+	sharedSearches.push_back(search);
+
+	batchStats.numSearches += 1;
+	batchStats.numSearchedBlocks += search.numTestedBlocks;
+	return search.result;
+}
+
+void CPathManager::ReportBatchStats()
+{
+	if ((gs->frameNum % (GAME_SPEED * 60)) != 0)
+		return;
+	if (batchStats.numRequests == 0)
+		return;
+
+	LOG("[%s] %u batched PE requests: %.1f%% coalesced, %u blocks searched, ~%u blocks saved",
+		__FUNCTION__, batchStats.numRequests, (batchStats.numCoalesced * 100.0f) / batchStats.numRequests,
+		batchStats.numSearchedBlocks, batchStats.numSavedBlocks);
+
+	batchStats = BatchStats();
+}
+
+
 /*
 Help-function.
 Turns a start->goal-request into a well-defined request.
@@ -131,7 +218,7 @@ unsigned int CPathManager::RequestPath(
 			result = lowResPE->GetPath(*moveDef, *pfDef, startPos, newPath->lowResPath, MAX_SEARCHED_NODES_PE >> 3, synced);
 		}
 	} else if (goalDist2D < ESTIMATE_DISTANCE) {
-		result = medResPE->GetPath(*moveDef, *pfDef, startPos, newPath->medResPath, MAX_SEARCHED_NODES_PE >> 3, synced);
+		result = GetEstimatorPath(medResPE, *moveDef, *pfDef, startPos, newPath->medResPath, synced);
 
 		// CantGetCloser may be a false positive due to PE approximations and large goalRadius
 		if (result == IPath::CantGetCloser && (startPos - goalPos).SqLength2D() > pfDef->sqGoalRadius)
@@ -146,7 +233,7 @@ unsigned int CPathManager::RequestPath(
 			result = medResPE->GetPath(*moveDef, *pfDef, startPos, newPath->medResPath, MAX_SEARCHED_NODES_PE >> 3, synced);
 		}
 	} else {
-		result = lowResPE->GetPath(*moveDef, *pfDef, startPos, newPath->lowResPath, MAX_SEARCHED_NODES_PE >> 3, synced);
+		result = GetEstimatorPath(lowResPE, *moveDef, *pfDef, startPos, newPath->lowResPath, synced);
 
 		// CantGetCloser may be a false positive due to PE approximations and large goalRadius
 		if (result == IPath::CantGetCloser && (startPos - goalPos).SqLength2D() > pfDef->sqGoalRadius) {
@@ -188,6 +275,8 @@ unsigned int CPathManager::RequestPath(
 
 		newPath->searchResult = result;
 		pathID = Store(newPath);
+
+		UpdateActivePath(pathID, newPath);
 	} else {
 		delete newPath;
 	}
@@ -356,6 +445,8 @@ float3 CPathManager::NextWayPoint(
 		if (multiPath->caller) {
 			multiPath->caller->Block();
 		}
+
+		UpdateActivePath(pathID, multiPath);
 	}
 
 	float3 waypoint;
@@ -405,6 +496,31 @@ void CPathManager::DeletePath(unsigned int pathID) {
 	MultiPath* multiPath = pi->second;
 	pathMap.erase(pathID);
 	delete multiPath;
+
+	medResPE->RemoveActivePath(pathID);
+	lowResPE->RemoveActivePath(pathID);
+}
+
+
+// let the estimators recalculate the obsolete blocks crossed
+// by the most paths first; counts the blocks of all waypoints
+// left whenever a path is computed or refined, not as they are
+// consumed, so every path is only walked once per refinement
+void CPathManager::UpdateActivePath(unsigned int pathID, const MultiPath* path) {
+	// unsynced requests have no caller and must
+	// not influence the (synced) update order
+	if (path->caller == NULL)
+		return;
+
+	medResPE->RemoveActivePath(pathID);
+	lowResPE->RemoveActivePath(pathID);
+
+	medResPE->AddActivePath(path->maxResPath, pathID);
+	medResPE->AddActivePath(path->medResPath, pathID);
+	medResPE->AddActivePath(path->lowResPath, pathID);
+	lowResPE->AddActivePath(path->maxResPath, pathID);
+	lowResPE->AddActivePath(path->medResPath, pathID);
+	lowResPE->AddActivePath(path->lowResPath, pathID);
 }
 
 
@@ -426,6 +542,8 @@ void CPathManager::Update()
 
 	medResPE->Update();
 	lowResPE->Update();
+
+	ReportBatchStats();
 }
 
 
@@ -578,3 +696,34 @@ int2 CPathManager::GetNumQueuedUpdates() const {
 	return data;
 }
 
+bool CPathManager::GetPathCacheStats(int pathType, bool synced, PathCacheStats& stats) const {
+	const CPathCache* caches[2] = {medResPE->GetPathCache(synced), lowResPE->GetPathCache(synced)};
+
+	const unsigned int minType = (pathType < 0)? 0: pathType;
+	const unsigned int maxType = (pathType < 0)? moveDefHandler->GetNumMoveDefs(): (pathType + 1);
+
+	stats = PathCacheStats();
+
+	for (unsigned int i = 0; i < 2; i++) {
+		for (unsigned int t = minType; t < maxType; t++) {
+			const CPathCache::Stats* s = caches[i]->GetStats(t);
+
+			if (s == NULL)
+				continue;
+
+			stats.numHits        += s->numHits;
+			stats.numMisses      += s->numMisses;
+			stats.numEvictions   += s->numEvictions;
+			stats.numExpirations += s->numExpirations;
+		}
+	}
+
+	return true;
+}
+
+
+bool CPathManager::GetPathEstimatorStats(bool lowRes, PathEstimatorStats& stats) const {
+	stats = (lowRes? lowResPE: medResPE)->GetStats();
+	return true;
+}
+
@@ -4,6 +4,7 @@
 #define PATHMANAGER_H
 
 #include <map>
+#include <vector>
 #include <boost/cstdint.hpp> /* Replace with <stdint.h> if appropriate */
 
 #include "Sim/Path/IPathManager.h"
@@ -50,6 +51,9 @@ public:
 		bool synced
 	);
 
+	void BeginRequestBatch();
+	void EndRequestBatch();
+
 	/**
 	 * Returns waypoints of the max-resolution path segments.
 	 * @param pathID
@@ -79,6 +83,8 @@ public:
 	const float* GetNodeExtraCosts(bool) const;
 
 	int2 GetNumQueuedUpdates() const;
+	bool GetPathCacheStats(int pathType, bool synced, PathCacheStats& stats) const;
+	bool GetPathEstimatorStats(bool lowRes, PathEstimatorStats& stats) const;
 
 private:
 	unsigned int RequestPath(
@@ -118,8 +124,43 @@ private:
 		CSolidObject* caller;
 	};
 
+	/// an estimator search whose result is shared within a request batch
+	struct SharedSearch {
+		const CPathEstimator* pe;
+		int pathType;
+		int2 startBlock;
+		int2 goalSquare;
+		float sqGoalRadius;
+		bool synced;
+
+		IPath::SearchResult result;
+		IPath::Path path;
+		unsigned int numTestedBlocks;
+	};
+
+	struct BatchStats {
+		BatchStats(): numRequests(0), numSearches(0), numCoalesced(0), numSearchedBlocks(0), numSavedBlocks(0) {}
+
+		unsigned int numRequests;       ///< estimator requests made inside batches
+		unsigned int numSearches;       ///< ... that ran their own search
+		unsigned int numCoalesced;      ///< ... that reused the search of another
+		unsigned int numSearchedBlocks; ///< blocks tested by the searches
+		unsigned int numSavedBlocks;    ///< blocks the coalesced requests would have tested
+	};
+
+	IPath::SearchResult GetEstimatorPath(
+		CPathEstimator* pe,
+		const MoveDef& moveDef,
+		const CPathFinderDef& peDef,
+		const float3& startPos,
+		IPath::Path& path,
+		bool synced
+	);
+	void ReportBatchStats();
+
 	inline MultiPath* GetMultiPath(int pathID) const;
 	unsigned int Store(MultiPath* path);
+	void UpdateActivePath(unsigned int pathID, const MultiPath* path);
 	void LowRes2MedRes(MultiPath& path, const float3& startPos, const CSolidObject* owner, bool synced) const;
 	void MedRes2MaxRes(MultiPath& path, const float3& startPos, const CSolidObject* owner, bool synced) const;
 
@@ -132,6 +173,11 @@ private:
 
 	std::map<unsigned int, MultiPath*> pathMap;
 	unsigned int nextPathID;
+
+	std::vector<SharedSearch> sharedSearches;
+	unsigned int batchDepth;
+
+	BatchStats batchStats;
 };
 
 inline CPathManager::MultiPath* CPathManager::GetMultiPath(int pathID) const {
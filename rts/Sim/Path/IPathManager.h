@@ -3,6 +3,7 @@
 #ifndef I_PATH_MANAGER_H
 #define I_PATH_MANAGER_H
 
+#include <vector>
 #include <boost/cstdint.hpp> /* Replace with <stdint.h> if appropriate */
 
 #include "PFSTypes.h"
@@ -14,6 +15,42 @@ class CSolidObject;
 
 class IPathManager {
 public:
+	struct PathRequest {
+		CSolidObject* caller;
+		const MoveDef* moveDef;
+		float3 startPos;
+		float3 goalPos;
+		float goalRadius;
+	};
+
+	struct PathCacheStats {
+		PathCacheStats(): numHits(0), numMisses(0), numEvictions(0), numExpirations(0) {}
+
+		unsigned int numHits;
+		unsigned int numMisses;
+		unsigned int numEvictions;   ///< paths dropped to stay within the memory budget
+		unsigned int numExpirations; ///< paths dropped for being too old
+	};
+
+	struct PathEstimatorStats {
+		PathEstimatorStats()
+			: loadTime(0.0f)
+			, loadThreads(0)
+			, cacheLoaded(false)
+			, numUpdatedBlocks(0)
+			, sumUpdateLatency(0)
+			, maxUpdateLatency(0)
+		{}
+
+		float loadTime;                  ///< msecs spent reading or generating the cache
+		unsigned int loadThreads;        ///< number of CPathFinder's used for generating it
+		bool cacheLoaded;                ///< true if the cache was read from disk
+
+		unsigned int numUpdatedBlocks;   ///< blocks recalculated after MapChanged
+		unsigned int sumUpdateLatency;   ///< frames between MapChanged and recalculation, summed
+		unsigned int maxUpdateLatency;   ///< ... and the maximum thereof
+	};
+
 	static IPathManager* GetInstance(unsigned int type);
 
 	virtual ~IPathManager() {}
@@ -135,6 +172,38 @@ public:
 		bool synced
 	) { return 0; }
 
+	/**
+	 * Requests several paths at once, see RequestPath; the path-id (or 0)
+	 * for requests[i] is stored in pathIDs[i]. Equivalent searches, e.g.
+	 * those of a group of units ordered to the same goal, may be shared.
+	 */
+	virtual void RequestPaths(
+		const std::vector<PathRequest>& requests,
+		std::vector<unsigned int>& pathIDs,
+		bool synced
+	) {
+		pathIDs.clear();
+		pathIDs.reserve(requests.size());
+
+		BeginRequestBatch();
+
+		for (unsigned int i = 0; i < requests.size(); i++) {
+			const PathRequest& r = requests[i];
+			pathIDs.push_back(RequestPath(r.caller, r.moveDef, r.startPos, r.goalPos, r.goalRadius, synced));
+		}
+
+		EndRequestBatch();
+	}
+
+	/**
+	 * RequestPath calls made between these two may share searches with
+	 * each other (for callers that can not collect their requests up front,
+	 * such as the move-types of a group of units receiving an order).
+	 * Batches may be nested, but must not span multiple simulation frames.
+	 */
+	virtual void BeginRequestBatch() {}
+	virtual void EndRequestBatch() {}
+
 	/**
 	 * Whenever there are any changes in the terrain
 	 * (examples: explosions, new buildings, etc.)
@@ -161,6 +230,20 @@ public:
 	virtual const float* GetNodeExtraCosts(bool synced) const { return NULL; }
 
 	virtual int2 GetNumQueuedUpdates() const { return (int2(0, 0)); }
+
+	/**
+	 * Sums the path-cache counters for MoveDef <pathType> (or for all of
+	 * them if pathType is negative) of the synced or unsynced caches.
+	 * Returns false if this path-manager has no such caches.
+	 */
+	virtual bool GetPathCacheStats(int pathType, bool synced, PathCacheStats& stats) const { return false; }
+
+	/**
+	 * Copies the load and update counters of the medium (<lowRes> false)
+	 * or low resolution path-estimator.
+	 * Returns false if this path-manager has no path-estimators.
+	 */
+	virtual bool GetPathEstimatorStats(bool lowRes, PathEstimatorStats& stats) const { return false; }
 };
 
 extern IPathManager* pathManager;
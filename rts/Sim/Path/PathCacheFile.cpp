@@ -0,0 +1,191 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PathCacheFile.h"
+#include "System/CRC.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/FileSystem.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+CONFIG(bool, VerifyPathCaches).defaultValue(false).description("Checksum the whole pathfinder cache-files when loading them, instead of only their headers.");
+
+static const char PATH_CACHE_MAGIC[8] = {'S', 'P', 'R', 'P', 'A', 'T', 'H', '\0'};
+
+
+boost::uint32_t CPathCacheFile::GetHeaderCRC(Header h)
+{
+	h.headerCRC = 0;
+
+	CRC crc;
+	crc.Update(&h, sizeof(Header));
+	return crc.GetDigest();
+}
+
+boost::uint32_t CPathCacheFile::GetChecksum(const Header& h)
+{
+	CRC crc;
+
+	for (unsigned int i = 0; i < h.numSections; i++) {
+		crc.Update(h.sections[i].crc);
+	}
+
+	return crc.GetDigest();
+}
+
+
+bool CPathCacheFile::Write(const std::string& fileName, boost::uint32_t dataHash, const std::vector<Section>& sections, boost::uint32_t* checksum)
+{
+	assert(sections.size() <= MAX_SECTIONS);
+
+	Header h;
+	memset(&h, 0, sizeof(Header));
+	memcpy(h.magic, PATH_CACHE_MAGIC, sizeof(h.magic));
+
+	h.version = FORMAT_VERSION;
+	h.dataHash = dataHash;
+	h.numSections = sections.size();
+
+	boost::uint64_t offset = SECTION_ALIGNMENT;
+
+	for (unsigned int i = 0; i < sections.size(); i++) {
+		CRC crc;
+		crc.Update(sections[i].data, sections[i].size);
+
+		h.sections[i].offset = offset;
+		h.sections[i].size = sections[i].size;
+		h.sections[i].crc = crc.GetDigest();
+
+		offset += ((sections[i].size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT) * SECTION_ALIGNMENT;
+	}
+
+	h.headerCRC = GetHeaderCRC(h);
+
+	if (checksum != NULL)
+		*checksum = GetChecksum(h);
+
+	// write to a temporary file first, other processes
+	// might map the cache while this one is creating it
+	const std::string tmpFileName = fileName + ".tmp";
+	const std::vector<char> padding(SECTION_ALIGNMENT, 0);
+
+	{
+		std::ofstream ofs(tmpFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!ofs.good())
+			return false;
+
+		ofs.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+		ofs.write(&padding[0], SECTION_ALIGNMENT - sizeof(Header));
+
+		for (unsigned int i = 0; i < sections.size(); i++) {
+			const size_t padSize = (SECTION_ALIGNMENT - (sections[i].size % SECTION_ALIGNMENT)) % SECTION_ALIGNMENT;
+
+			ofs.write(static_cast<const char*>(sections[i].data), sections[i].size);
+			ofs.write(&padding[0], padSize);
+		}
+
+		if (!ofs.good()) {
+			ofs.close();
+			FileSystem::Remove(tmpFileName);
+			return false;
+		}
+	}
+
+	// rename() does not replace existing files on Windows
+	FileSystem::Remove(fileName);
+
+	if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+		FileSystem::Remove(tmpFileName);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool CPathCacheFile::Open(const std::string& fileName, boost::uint32_t dataHash, unsigned int numSections, CMappedFile::MapMode mode)
+{
+	Close();
+
+	file = new CMappedFile(fileName, mode);
+
+	if (!file->IsOpen() || file->GetSize() < sizeof(Header)) {
+		Close();
+		return false;
+	}
+
+	const Header* h = reinterpret_cast<const Header*>(file->GetData());
+
+	bool valid = true;
+	valid = valid && (memcmp(h->magic, PATH_CACHE_MAGIC, sizeof(h->magic)) == 0);
+	valid = valid && (h->version == FORMAT_VERSION);
+	valid = valid && (h->dataHash == dataHash);
+	valid = valid && (h->numSections == numSections);
+	valid = valid && (h->headerCRC == GetHeaderCRC(*h));
+
+	// checksumming the data would touch every page of the
+	// file, which is what mapping it is meant to avoid
+	const bool verifyData = configHandler->GetBool("VerifyPathCaches");
+
+	for (unsigned int i = 0; valid && i < numSections; i++) {
+		const SectionHeader& sh = h->sections[i];
+
+		valid = valid && ((sh.offset % SECTION_ALIGNMENT) == 0);
+		valid = valid && (sh.offset + sh.size <= file->GetSize());
+
+		if (valid && verifyData) {
+			CRC crc;
+			crc.Update(file->GetData() + sh.offset, sh.size);
+			valid = (crc.GetDigest() == sh.crc);
+		}
+	}
+
+	if (!valid) {
+		Close();
+		return false;
+	}
+
+	header = h;
+	return true;
+}
+
+void CPathCacheFile::Close()
+{
+	delete file;
+
+	file = NULL;
+	header = NULL;
+}
+
+
+const unsigned char* CPathCacheFile::GetSection(unsigned int i) const
+{
+	assert(IsOpen() && i < header->numSections);
+	return (file->GetData() + header->sections[i].offset);
+}
+
+unsigned char* CPathCacheFile::GetMutableSection(unsigned int i)
+{
+	assert(IsOpen() && i < header->numSections);
+
+	if (file->GetMutableData() == NULL)
+		return NULL;
+
+	return (file->GetMutableData() + header->sections[i].offset);
+}
+
+size_t CPathCacheFile::GetSectionSize(unsigned int i) const
+{
+	assert(IsOpen() && i < header->numSections);
+	return header->sections[i].size;
+}
+
+
+boost::uint32_t CPathCacheFile::GetChecksum() const
+{
+	assert(IsOpen());
+	return (GetChecksum(*header));
+}
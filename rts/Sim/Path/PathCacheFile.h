@@ -0,0 +1,96 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PATH_CACHE_FILE_H
+#define PATH_CACHE_FILE_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "System/FileSystem/MappedFile.h"
+
+/**
+ * Uncompressed on-disk format of the pathfinder caches, meant to be mapped
+ * into memory instead of being read: engine processes on the same host that
+ * use the same cache then share one physical copy of it.
+ *
+ * The file consists of a header followed by up to MAX_SECTIONS sections of
+ * raw data, each starting at a multiple of SECTION_ALIGNMENT (which is a
+ * multiple of the page-size on all supported platforms) and protected by
+ * its own CRC32. The header is protected by a CRC32 over itself, and so
+ * also over the section CRCs; the section data is only checksummed when it
+ * is written, or on open if VerifyPathCaches is set. The data is stored in
+ * host byte-order.
+ */
+class CPathCacheFile : boost::noncopyable
+{
+public:
+	static const unsigned int FORMAT_VERSION = 1;
+	static const unsigned int MAX_SECTIONS = 4;
+	static const unsigned int SECTION_ALIGNMENT = 64 * 1024;
+
+	struct Section {
+		Section(const void* d, size_t s): data(d), size(s) {}
+
+		const void* data;
+		size_t size;
+	};
+
+	/**
+	 * Writes <sections> to <fileName>; the file is replaced atomically so
+	 * other processes never map a partially written cache.
+	 * @param dataHash identifies the input the data was generated from
+	 * @param checksum if not NULL, receives the same checksum as
+	 *   GetChecksum would return, even if writing fails
+	 */
+	static bool Write(const std::string& fileName, boost::uint32_t dataHash, const std::vector<Section>& sections, boost::uint32_t* checksum = NULL);
+
+	CPathCacheFile(): file(NULL), header(NULL) {}
+	~CPathCacheFile() { Close(); }
+
+	/**
+	 * Maps <fileName> and checks it has the current format version, was
+	 * generated from <dataHash>, consists of <numSections> sections and
+	 * has an intact header. The section data is only checked against its
+	 * CRCs if VerifyPathCaches is set.
+	 */
+	bool Open(const std::string& fileName, boost::uint32_t dataHash, unsigned int numSections, CMappedFile::MapMode mode);
+	void Close();
+
+	bool IsOpen() const { return (header != NULL); }
+
+	const unsigned char* GetSection(unsigned int i) const;
+	/// only non-NULL for MAP_COPYONWRITE files
+	unsigned char* GetMutableSection(unsigned int i);
+	size_t GetSectionSize(unsigned int i) const;
+
+	/// checksum over the data of all sections
+	boost::uint32_t GetChecksum() const;
+
+private:
+	struct SectionHeader {
+		boost::uint64_t offset;
+		boost::uint64_t size;
+		boost::uint32_t crc;
+		boost::uint32_t padding;
+	};
+
+	struct Header {
+		char magic[8];
+		boost::uint32_t version;
+		boost::uint32_t dataHash;
+		boost::uint32_t numSections;
+		boost::uint32_t headerCRC;  ///< over the whole header, with this field set to 0
+
+		SectionHeader sections[MAX_SECTIONS];
+	};
+
+	static boost::uint32_t GetHeaderCRC(Header header);
+	static boost::uint32_t GetChecksum(const Header& header);
+
+	CMappedFile* file;
+	const Header* header;
+};
+
+#endif // PATH_CACHE_FILE_H
@@ -648,7 +648,7 @@ unsigned int QTPFS::QTNode::GetMaxNumNeighbors() const {
 
 
 
-void QTPFS::QTNode::Serialize(std::fstream& fStream, NodeLayer& nodeLayer, unsigned int* streamSize, bool readMode) {
+void QTPFS::QTNode::Serialize(std::iostream& fStream, NodeLayer& nodeLayer, unsigned int* streamSize, bool readMode) {
 	// overwritten when de-serializing
 	unsigned int numChildren = QTNODE_CHILD_COUNT * (1 - int(IsLeaf()));
 
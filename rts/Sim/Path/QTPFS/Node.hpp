@@ -4,7 +4,7 @@
 #define QTPFS_NODE_HDR
 
 #include <vector>
-#include <fstream>
+#include <iostream>
 #include <boost/cstdint.hpp>
 
 #include "PathEnums.hpp"
@@ -34,7 +34,7 @@ namespace QTPFS {
 		bool operator >= (const INode* n) const { return (fCost >= n->fCost); }
 
 		#ifdef QTPFS_VIRTUAL_NODE_FUNCTIONS
-		virtual void Serialize(std::fstream&, NodeLayer&, unsigned int*, bool) = 0;
+		virtual void Serialize(std::iostream&, NodeLayer&, unsigned int*, bool) = 0;
 		virtual unsigned int GetNeighbors(const std::vector<INode*>&, std::vector<INode*>&) = 0;
 		virtual const std::vector<INode*>& GetNeighbors(const std::vector<INode*>& v) = 0;
 		virtual bool UpdateNeighborCache(const std::vector<INode*>& nodes) = 0;
@@ -127,7 +127,7 @@ namespace QTPFS {
 		void Delete();
 		void PreTesselate(NodeLayer& nl, const SRectangle& r, SRectangle& ur);
 		void Tesselate(NodeLayer& nl, const SRectangle& r);
-		void Serialize(std::fstream& fStream, NodeLayer& nodeLayer, unsigned int* streamSize, bool readMode);
+		void Serialize(std::iostream& fStream, NodeLayer& nodeLayer, unsigned int* streamSize, bool readMode);
 
 		bool IsLeaf() const;
 		bool CanSplit(bool forced) const;
@@ -4,6 +4,7 @@
 #include <boost/thread.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/cstdint.hpp>
+#include <sstream>
 
 #include "System/ThreadPool.h"
 
@@ -18,6 +19,7 @@
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveMath/MoveMath.h"
 #include "Sim/Objects/SolidObject.h"
+#include "Sim/Path/PathCacheFile.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/FileSystem/FileSystem.h"
@@ -170,6 +172,7 @@ void QTPFS::PathManager::Load() {
 	maxNumLeafNodes   = 0;
 
 	nodeTrees.resize(moveDefHandler->GetNumMoveDefs(), NULL);
+	cacheFiles.resize(moveDefHandler->GetNumMoveDefs(), NULL);
 	nodeLayers.resize(moveDefHandler->GetNumMoveDefs());
 	pathCaches.resize(moveDefHandler->GetNumMoveDefs());
 	pathSearches.resize(moveDefHandler->GetNumMoveDefs());
@@ -185,7 +188,7 @@ void QTPFS::PathManager::Load() {
 
 		{
 			layersInited = false;
-			haveCacheDir = FileSystem::DirExists(cacheDirName);
+			haveCacheDir = FileSystem::DirExists(cacheDirName) && OpenCacheFiles(cacheDirName);
 
 			InitNodeLayersThreaded(MAP_RECTANGLE);
 			Serialize(cacheDirName);
@@ -525,9 +528,56 @@ std::string QTPFS::PathManager::GetCacheDirName(boost::uint32_t mapCheckSum, boo
 	return dir;
 }
 
+std::string QTPFS::PathManager::GetCacheFileName(const std::string& cacheFileDir, unsigned int pathType) const {
+	return (cacheFileDir + "tree" + IntToString(pathType, "%02x") + "-" + moveDefHandler->GetMoveDefByPathType(pathType)->name);
+}
+
+// maps the tree cache-files of all layers in use, fails
+// (and closes them all again) if any is missing or corrupt
+bool QTPFS::PathManager::OpenCacheFiles(const std::string& cacheFileDir) {
+	for (unsigned int i = 0; i < nodeTrees.size(); i++) {
+		if (moveDefHandler->GetMoveDefByPathType(i)->udRefCount == 0)
+			continue;
+
+		const std::string& fileName = GetCacheFileName(cacheFileDir, i);
+
+		#ifdef QTPFS_CACHE_XACCESS
+		// another (concurrently loading) Spring process might still be
+		// creating the cache; files are renamed into place when complete
+		for (unsigned int n = 0; n < 600 && !FileSystem::FileExists(fileName); n++) {
+			boost::this_thread::sleep(boost::posix_time::millisec(100));
+		}
+		#endif
+
+		cacheFiles[i] = new CPathCacheFile();
+
+		if (!cacheFiles[i]->Open(fileName, QTPFS_CACHE_VERSION, 1, CMappedFile::MAP_READONLY)) {
+			LOG_L(L_WARNING, "[PathManager::%s] cache-file %s is missing or corrupt", __FUNCTION__, fileName.c_str());
+
+			for (unsigned int j = 0; j <= i; j++) {
+				delete cacheFiles[j];
+				cacheFiles[j] = NULL;
+			}
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+namespace {
+	// read-only std::streambuf over a block of (mapped) memory
+	struct MemoryStreamBuf: public std::streambuf {
+		MemoryStreamBuf(const unsigned char* data, size_t size) {
+			char* mem = const_cast<char*>(reinterpret_cast<const char*>(data));
+			setg(mem, mem, mem + size);
+		}
+	};
+};
+
 void QTPFS::PathManager::Serialize(const std::string& cacheFileDir) {
-	std::vector<std::string> fileNames(nodeTrees.size(), "");
-	std::vector<std::fstream*> fileStreams(nodeTrees.size(), NULL);
 	std::vector<unsigned int> fileSizes(nodeTrees.size(), 0);
 
 	if (!haveCacheDir) {
@@ -540,74 +590,42 @@ void QTPFS::PathManager::Serialize(const std::string& cacheFileDir) {
 	const char* fmtString = "[PathManager::%s] serializing node-tree %u (%s)";
 	#endif
 
-	// TODO: compress the tree cache-files?
 	for (unsigned int i = 0; i < nodeTrees.size(); i++) {
 		const MoveDef* md = moveDefHandler->GetMoveDefByPathType(i);
 
 		if (md->udRefCount == 0)
 			continue;
 
-		fileNames[i] = cacheFileDir + "tree" + IntToString(i, "%02x") + "-" + md->name;
-		fileStreams[i] = new std::fstream();
-
-		if (haveCacheDir) {
-			#ifdef QTPFS_CACHE_XACCESS
-			{
-				// FIXME: lock fileNames[i] instead of doing this
-				// fstreams can not be easily locked however, see
-				// http://stackoverflow.com/questions/839856/
-				while (!FileSystem::FileExists(fileNames[i] + "-tmp")) {
-					boost::this_thread::sleep(boost::posix_time::millisec(100));
-				}
-				while (FileSystem::GetFileSize(fileNames[i] + "-tmp") != sizeof(unsigned int)) {
-					boost::this_thread::sleep(boost::posix_time::millisec(100));
-				}
-
-				fileStreams[i]->open((fileNames[i] + "-tmp").c_str(), std::ios::in | std::ios::binary);
-				fileStreams[i]->read(reinterpret_cast<char*>(&fileSizes[i]), sizeof(unsigned int));
-				fileStreams[i]->close();
-
-				while (!FileSystem::FileExists(fileNames[i])) {
-					boost::this_thread::sleep(boost::posix_time::millisec(100));
-				}
-				while (FileSystem::GetFileSize(fileNames[i]) != fileSizes[i]) {
-					boost::this_thread::sleep(boost::posix_time::millisec(100));
-				}
-			}
-			#else
-			assert(FileSystem::FileExists(fileNames[i]));
-			#endif
-
-			// read fileNames[i] into nodeTrees[i]
-			fileStreams[i]->open(fileNames[i].c_str(), std::ios::in | std::ios::binary);
-			assert(fileStreams[i]->good());
-			assert(nodeTrees[i]->IsLeaf());
-		} else {
-			// write nodeTrees[i] into fileNames[i]
-			fileStreams[i]->open(fileNames[i].c_str(), std::ios::out | std::ios::binary);
-		}
-
 		#ifndef NDEBUG
 		sprintf(loadMsg, fmtString, __FUNCTION__, i, md->name.c_str());
 		pmLoadScreen.AddLoadMessage(loadMsg);
 		#endif
 
-		nodeTrees[i]->Serialize(*fileStreams[i], nodeLayers[i], &fileSizes[i], haveCacheDir);
+		if (haveCacheDir) {
+			// read the mapped cache-file into nodeTrees[i]
+			assert(cacheFiles[i] != NULL);
+			assert(nodeTrees[i]->IsLeaf());
 
-		fileStreams[i]->flush();
-		fileStreams[i]->close();
+			MemoryStreamBuf streamBuf(cacheFiles[i]->GetSection(0), cacheFiles[i]->GetSectionSize(0));
+			std::iostream stream(&streamBuf);
 
-		#ifdef QTPFS_CACHE_XACCESS
-		if (!haveCacheDir) {
-			// signal any other (concurrently loading) Spring processes; needed for validation-tests
-			fileStreams[i]->open((fileNames[i] + "-tmp").c_str(), std::ios::out | std::ios::binary);
-			fileStreams[i]->write(reinterpret_cast<const char*>(&fileSizes[i]), sizeof(unsigned int));
-			fileStreams[i]->flush();
-			fileStreams[i]->close();
-		}
-		#endif
+			nodeTrees[i]->Serialize(stream, nodeLayers[i], &fileSizes[i], true);
 
-		delete fileStreams[i];
+			delete cacheFiles[i];
+			cacheFiles[i] = NULL;
+		} else {
+			// write nodeTrees[i] into its cache-file
+			std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+			nodeTrees[i]->Serialize(stream, nodeLayers[i], &fileSizes[i], false);
+
+			const std::string& data = stream.str();
+			const std::vector<CPathCacheFile::Section> sections(1, CPathCacheFile::Section(data.data(), data.size()));
+
+			if (!CPathCacheFile::Write(GetCacheFileName(cacheFileDir, i), QTPFS_CACHE_VERSION, sections)) {
+				LOG_L(L_WARNING, "[PathManager::%s] could not write cache-file for node-tree %u", __FUNCTION__, i);
+			}
+		}
 	}
 }
 
@@ -15,6 +15,7 @@
 struct MoveDef;
 struct SRectangle;
 class CSolidObject;
+class CPathCacheFile;
 
 #ifdef QTPFS_ENABLE_THREADED_UPDATE
 namespace boost {
@@ -135,10 +136,13 @@ namespace QTPFS {
 
 
 		std::string GetCacheDirName(boost::uint32_t mapCheckSum, boost::uint32_t modCheckSum) const;
+		bool OpenCacheFiles(const std::string& cacheFileDir);
 		void Serialize(const std::string& cacheFileDir);
+		std::string GetCacheFileName(const std::string& cacheFileDir, unsigned int pathType) const;
 
 		std::vector<NodeLayer> nodeLayers;
 		std::vector<QTNode*> nodeTrees;
+		std::vector<CPathCacheFile*> cacheFiles;
 		std::vector<PathCache> pathCaches;
 		std::vector< std::list<IPathSearch*> > pathSearches;
 		std::map<unsigned int, unsigned int> pathTypes;
@@ -0,0 +1,381 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "ExpGenSpawnProgram.h"
+#include "System/float3.h"
+#include "System/Log/ILog.h"
+#include "System/Util.h"
+#include "lib/streflop/streflop_cond.h"
+
+
+template<typename T> static inline T ReadOperand(const char*& code)
+{
+	// the byte code is packed, operands are not aligned
+	T v;
+	memcpy(&v, code, sizeof(T));
+	code += sizeof(T);
+	return v;
+}
+
+// OP_STOREI and OP_STOREC truncate to int first
+template<typename T> static inline void StoreValue(char* addr, float val) { *reinterpret_cast<T*>(addr) = (int) val; }
+template<> inline void StoreValue<float>(char* addr, float val) { *reinterpret_cast<float*>(addr) = val; }
+
+static inline bool IsSourceOp(int op) { return (op == CExpGenSpawnProgram::OP_RAND || op == CExpGenSpawnProgram::OP_DAMAGE || op == CExpGenSpawnProgram::OP_INDEX); }
+static inline bool IsBufferOp(int op) { return (op == CExpGenSpawnProgram::OP_YANK || op == CExpGenSpawnProgram::OP_MULTIPLY || op == CExpGenSpawnProgram::OP_ADDBUFF || op == CExpGenSpawnProgram::OP_POWBUFF); }
+
+
+
+void CExpGenSpawnProgram::ParseValueCode(const std::string& script, std::string& code)
+{
+	int p = 0;
+
+	while (p < script.length()) {
+		char opcode = OP_END;
+		char c = script[p++];
+
+		// consume whitespace
+		if (c == ' ')
+			continue;
+
+		bool useInt = false;
+
+		     if (c == 'i')   opcode = OP_INDEX;
+		else if (c == 'r')   opcode = OP_RAND;
+		else if (c == 'd')   opcode = OP_DAMAGE;
+		else if (c == 'm')   opcode = OP_SAWTOOTH;
+		else if (c == 'k')   opcode = OP_DISCRETE;
+		else if (c == 's')   opcode = OP_SINE;
+		else if (c == 'p')   opcode = OP_POW;
+		else if (c == 'y') { opcode = OP_YANK;     useInt = true; }
+		else if (c == 'x') { opcode = OP_MULTIPLY; useInt = true; }
+		else if (c == 'a') { opcode = OP_ADDBUFF;  useInt = true; }
+		else if (c == 'q') { opcode = OP_POWBUFF;  useInt = true; }
+		else if (isdigit(c) || c == '.' || c == '-') { opcode = OP_ADD; p--; }
+		else {
+			const char* fmt = "[CCEG::ParseExplosionCode] unknown op-code \"%c\" in \"%s\" at index %d";
+			LOG_L(L_WARNING, fmt, c, script.c_str(), p);
+			continue;
+		}
+
+		// be sure to exit cleanly if there are no more operators or operands
+		if (p >= script.size())
+			continue;
+
+		char* endp = NULL;
+
+		if (!useInt) {
+			// strtod&co expect C-style strings with NULLs,
+			// c_str() is guaranteed to be NULL-terminated
+			// (whether .data() == .c_str() depends on the
+			// implementation of std::string)
+			const float v = (float)strtod(&script.c_str()[p], &endp);
+
+			p += (endp - &script.c_str()[p]);
+			code += opcode;
+			code.append((char*) &v, ((char*) &v) + 4);
+		} else {
+			const int v = std::max(0, std::min(BUFFER_SIZE - 1, (int)strtol(&script.c_str()[p], &endp, 10)));
+
+			p += (endp - &script.c_str()[p]);
+			code += opcode;
+			code.append((char*) &v, ((char*) &v) + 4);
+		}
+	}
+}
+
+
+
+void CExpGenSpawnProgram::clear()
+{
+	setters.clear();
+	valueOps.clear();
+	constantRuns.clear();
+	constantBytes.clear();
+	usesBuffer = false;
+}
+
+bool CExpGenSpawnProgram::Compile(const char* code)
+{
+	clear();
+
+	std::vector<ValueOp> ops;
+	void* ptr = NULL;
+
+	for (;;) {
+		const int op = *(code++);
+
+		switch (op) {
+			case OP_END: {
+				BakeConstants();
+				return true;
+			}
+			case OP_STOREI:
+			case OP_STOREF:
+			case OP_STOREC: {
+				AddValueSetter(op, ReadOperand<boost::uint16_t>(code), ops);
+				ops.clear();
+			} break;
+			case OP_ADD:
+			case OP_RAND:
+			case OP_DAMAGE:
+			case OP_INDEX:
+			case OP_SAWTOOTH:
+			case OP_DISCRETE:
+			case OP_SINE:
+			case OP_POW: {
+				const ValueOp vop = {op, ReadOperand<float>(code), 0};
+				ops.push_back(vop);
+			} break;
+			case OP_YANK:
+			case OP_MULTIPLY:
+			case OP_ADDBUFF:
+			case OP_POWBUFF: {
+				const ValueOp vop = {op, 0.0f, std::max(0, std::min(BUFFER_SIZE - 1, ReadOperand<int>(code)))};
+				ops.push_back(vop);
+			} break;
+			case OP_LOADP: {
+				ptr = ReadOperand<void*>(code);
+			} break;
+			case OP_STOREP: {
+				const Setter s = {&SetPointer, ReadOperand<boost::uint16_t>(code), sizeof(void*), true, 0.0f, 0.0f, ptr, 0, 0};
+				setters.push_back(s);
+				ptr = NULL;
+			} break;
+			case OP_DIR: {
+				const Setter s = {&SetDirection, ReadOperand<boost::uint16_t>(code), sizeof(float3), false, 0.0f, 0.0f, NULL, 0, 0};
+				setters.push_back(s);
+			} break;
+			default: {
+				clear();
+				return false;
+			}
+		}
+	}
+}
+
+
+void CExpGenSpawnProgram::AddValueSetter(int storeOp, boost::uint16_t offset, const std::vector<ValueOp>& ops)
+{
+	Setter s = {NULL, offset, 0, false, 0.0f, 0.0f, NULL, 0, 0};
+
+	switch (storeOp) {
+		case OP_STOREI: { s.size = sizeof(int); } break;
+		case OP_STOREF: { s.size = sizeof(float); } break;
+		case OP_STOREC: { s.size = sizeof(unsigned char); } break;
+	}
+
+	bool constant = true;
+	bool buffered = false;
+
+	for (size_t i = 0; i < ops.size(); i++) {
+		constant &= !IsSourceOp(ops[i].op);
+		buffered |= IsBufferOp(ops[i].op);
+	}
+
+	if (constant && !buffered) {
+		// no inputs, evaluate it right now
+		State state;
+		s.base = EvalValue(ops.empty()? NULL: &ops[0], ops.size(), state);
+		s.constant = true;
+
+		switch (storeOp) {
+			case OP_STOREI: { s.func = &SetConstant<int>; } break;
+			case OP_STOREF: { s.func = &SetConstant<float>; } break;
+			case OP_STOREC: { s.func = &SetConstant<unsigned char>; } break;
+		}
+
+		setters.push_back(s);
+		return;
+	}
+
+	// "a + x * b", with x one of rand, damage or index (the common case);
+	// val starts at zero, so adding a before or after the product is the same
+	int source = -1;
+
+	if (ops.size() == 1 && IsSourceOp(ops[0].op)) {
+		source = ops[0].op;
+		s.scale = ops[0].value;
+	}
+	if (ops.size() == 2 && ops[0].op == OP_ADD && IsSourceOp(ops[1].op)) {
+		source = ops[1].op;
+		s.base = 0.0f + ops[0].value;
+		s.scale = ops[1].value;
+	}
+	if (ops.size() == 2 && IsSourceOp(ops[0].op) && ops[1].op == OP_ADD) {
+		source = ops[0].op;
+		s.base = 0.0f + ops[1].value;
+		s.scale = ops[0].value;
+	}
+
+	#define AFFINE_SETTER(T)                                                   \
+		switch (source) {                                                      \
+			case OP_RAND:   { s.func = &SetAffine<T, SOURCE_RAND>;   } break;  \
+			case OP_DAMAGE: { s.func = &SetAffine<T, SOURCE_DAMAGE>; } break;  \
+			case OP_INDEX:  { s.func = &SetAffine<T, SOURCE_INDEX>;  } break;  \
+			default:        { s.func = &SetExpression<T>;            } break;  \
+		}
+
+	switch (storeOp) {
+		case OP_STOREI: { AFFINE_SETTER(int)           } break;
+		case OP_STOREF: { AFFINE_SETTER(float)         } break;
+		case OP_STOREC: { AFFINE_SETTER(unsigned char) } break;
+	}
+
+	#undef AFFINE_SETTER
+
+	if (source == -1) {
+		s.base = 0.0f;
+		s.scale = 0.0f;
+		s.firstOp = valueOps.size();
+		s.numOps = ops.size();
+
+		valueOps.insert(valueOps.end(), ops.begin(), ops.end());
+		usesBuffer |= buffered;
+	}
+
+	setters.push_back(s);
+}
+
+
+
+void CExpGenSpawnProgram::BakeConstants()
+{
+	std::vector<Setter> dynamicSetters;
+	dynamicSetters.reserve(setters.size());
+
+	for (size_t i = 0; i < setters.size(); i++) {
+		const Setter& s = setters[i];
+
+		bool bake = s.constant;
+
+		// the baked bytes are copied before all other setters run, so a
+		// constant may only move if no other setter writes the same bytes
+		for (size_t j = 0; j < setters.size() && bake; j++) {
+			const Setter& t = setters[j];
+
+			if (j == i)
+				continue;
+
+			bake &= (t.offset >= (s.offset + s.size) || s.offset >= (t.offset + t.size));
+		}
+
+		if (!bake) {
+			dynamicSetters.push_back(s);
+			continue;
+		}
+
+		// let the setter store its value into a scratch instance
+		std::vector<char> scratch(s.offset + s.size);
+		State state;
+		state.instance = &scratch[0];
+
+		s.func(*this, s, state);
+
+		if (!constantRuns.empty() && (constantRuns.back().offset + constantRuns.back().size) == s.offset) {
+			constantRuns.back().size += s.size;
+		} else {
+			const ConstantRun run = {s.offset, s.size, static_cast<unsigned int>(constantBytes.size())};
+			constantRuns.push_back(run);
+		}
+
+		constantBytes.insert(constantBytes.end(), scratch.begin() + s.offset, scratch.end());
+	}
+
+	setters.swap(dynamicSetters);
+}
+
+
+float CExpGenSpawnProgram::EvalValue(const ValueOp* ops, unsigned int numOps, State& state) const
+{
+	float val = 0.0f;
+
+	for (unsigned int i = 0; i < numOps; i++) {
+		const ValueOp& op = ops[i];
+
+		switch (op.op) {
+			case OP_ADD:      { val += op.value; } break;
+			case OP_RAND:     { val += state.randFunc() * op.value; } break;
+			case OP_DAMAGE:   { val += state.damage * op.value; } break;
+			case OP_INDEX:    { val += state.spawnIndex * op.value; } break;
+			// this translates to modulo except it works with floats
+			case OP_SAWTOOTH: { val -= op.value * math::floor(val / op.value); } break;
+			case OP_DISCRETE: { val = op.value * math::floor(SafeDivide(val, op.value)); } break;
+			case OP_SINE:     { val = op.value * math::sin(val); } break;
+			case OP_YANK:     { state.buffer[op.index] = val; val = 0.0f; } break;
+			case OP_MULTIPLY: { val *= state.buffer[op.index]; } break;
+			case OP_ADDBUFF:  { val += state.buffer[op.index]; } break;
+			case OP_POW:      { val = math::pow(val, op.value); } break;
+			case OP_POWBUFF:  { val = math::pow(val, state.buffer[op.index]); } break;
+		}
+	}
+
+	return val;
+}
+
+
+void CExpGenSpawnProgram::Execute(char* instance, float damage, int spawnIndex, const float3& dir, RandFunc randFunc) const
+{
+	State state;
+	state.instance = instance;
+	state.damage = damage;
+	state.spawnIndex = spawnIndex;
+	state.dir = &dir;
+	state.randFunc = randFunc;
+
+	if (usesBuffer)
+		std::fill(state.buffer, state.buffer + BUFFER_SIZE, 0.0f);
+
+	for (size_t i = 0; i < constantRuns.size(); i++) {
+		const ConstantRun& r = constantRuns[i];
+		memcpy(instance + r.offset, &constantBytes[r.firstByte], r.size);
+	}
+
+	for (size_t i = 0; i < setters.size(); i++) {
+		const Setter& s = setters[i];
+		s.func(*this, s, state);
+	}
+}
+
+
+
+template<typename T>
+void CExpGenSpawnProgram::SetConstant(const CExpGenSpawnProgram& program, const Setter& setter, State& state)
+{
+	StoreValue<T>(state.instance + setter.offset, setter.base);
+}
+
+template<typename T, int Source>
+void CExpGenSpawnProgram::SetAffine(const CExpGenSpawnProgram& program, const Setter& setter, State& state)
+{
+	float x = 0.0f;
+
+	switch (Source) {
+		case SOURCE_RAND:   { x = state.randFunc(); } break;
+		case SOURCE_DAMAGE: { x = state.damage; } break;
+		case SOURCE_INDEX:  { x = state.spawnIndex; } break;
+	}
+
+	StoreValue<T>(state.instance + setter.offset, setter.base + x * setter.scale);
+}
+
+template<typename T>
+void CExpGenSpawnProgram::SetExpression(const CExpGenSpawnProgram& program, const Setter& setter, State& state)
+{
+	const float val = program.EvalValue(&program.valueOps[setter.firstOp], setter.numOps, state);
+	StoreValue<T>(state.instance + setter.offset, val);
+}
+
+void CExpGenSpawnProgram::SetDirection(const CExpGenSpawnProgram& program, const Setter& setter, State& state)
+{
+	*reinterpret_cast<float3*>(state.instance + setter.offset) = *state.dir;
+}
+
+void CExpGenSpawnProgram::SetPointer(const CExpGenSpawnProgram& program, const Setter& setter, State& state)
+{
+	*reinterpret_cast<void**>(state.instance + setter.offset) = setter.ptr;
+}
@@ -0,0 +1,142 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef EXP_GEN_SPAWN_PROGRAM_H
+#define EXP_GEN_SPAWN_PROGRAM_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+class float3;
+
+/**
+ * Explosion code of a CEG spawner, compiled when the CEG is loaded.
+ *
+ * Every projectile property becomes one setter: a function specialised for
+ * the stored type and for the shape of the value expression (a constant,
+ * "a + rand/damage/index * b", a direction, a pointer), with its operands
+ * already decoded. Only properties using the buffer or wave ops fall back to
+ * evaluating a list of pre-decoded ops. Constant and pointer properties that
+ * no other setter touches are baked into runs of bytes, which are copied in
+ * one go before the remaining setters run. The results are the same as those
+ * of interpreting the byte code op by op.
+ */
+class CExpGenSpawnProgram
+{
+public:
+	/// byte code emitted by the CEG parser and compiled by Compile
+	enum {
+		OP_END      =  0,
+		OP_STOREI   =  1, // int
+		OP_STOREF   =  2, // float
+		OP_STOREC   =  3, // char
+		OP_ADD      =  4,
+		OP_RAND     =  5,
+		OP_DAMAGE   =  6,
+		OP_INDEX    =  7,
+		OP_LOADP    =  8, // load a void* into the pointer register
+		OP_STOREP   =  9, // store the pointer register into a void*
+		OP_DIR      = 10, // store the float3 direction
+		OP_SAWTOOTH = 11, // Performs a modulo to create a sawtooth wave
+		OP_DISCRETE = 12, // Floors the value to a multiple of its parameter
+		OP_SINE     = 13, // Uses val as the phase of a sine wave
+		OP_YANK     = 14, // Moves the input value into a buffer, returns zero
+		OP_MULTIPLY = 15, // Multiplies with buffer value
+		OP_ADDBUFF  = 16, // Adds buffer value
+		OP_POW      = 17, // Power with code as exponent
+		OP_POWBUFF  = 18, // Power with buffer as exponent
+	};
+
+	static const int BUFFER_SIZE = 16;
+
+	typedef float (*RandFunc)();
+
+	CExpGenSpawnProgram(): usesBuffer(false) {}
+
+	/**
+	 * Appends the value ops for a numeric property definition like
+	 * "5 r2.5" to code; the caller adds the store op.
+	 */
+	static void ParseValueCode(const std::string& script, std::string& code);
+
+	/**
+	 * Builds the setters from OP_END terminated byte code.
+	 * @return false if the code contains an unknown op
+	 */
+	bool Compile(const char* code);
+
+	/// sets all properties of a freshly created projectile
+	void Execute(char* instance, float damage, int spawnIndex, const float3& dir, RandFunc randFunc) const;
+
+	bool empty() const { return (setters.empty() && constantRuns.empty()); }
+	void clear();
+
+private:
+	struct ValueOp {
+		int op;
+		float value;
+		int index;
+	};
+
+	struct State {
+		char* instance;
+		float damage;
+		float spawnIndex;
+		const float3* dir;
+		RandFunc randFunc;
+		float buffer[BUFFER_SIZE];
+	};
+
+	struct Setter;
+	typedef void (*SetterFunc)(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+
+	struct Setter {
+		SetterFunc func;
+		boost::uint16_t offset;
+		boost::uint16_t size; ///< number of bytes written
+
+		bool constant;
+
+		float base;
+		float scale;
+		void* ptr;
+
+		unsigned int firstOp;
+		unsigned int numOps;
+	};
+
+	/// constant bytes of adjacent properties, copied as a whole
+	struct ConstantRun {
+		boost::uint16_t offset;
+		boost::uint16_t size;
+		unsigned int firstByte;
+	};
+
+	enum {
+		SOURCE_RAND   = 0,
+		SOURCE_DAMAGE = 1,
+		SOURCE_INDEX  = 2,
+	};
+
+	void AddValueSetter(int storeOp, boost::uint16_t offset, const std::vector<ValueOp>& ops);
+	void BakeConstants();
+	float EvalValue(const ValueOp* ops, unsigned int numOps, State& state) const;
+
+	template<typename T> static void SetConstant(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+	template<typename T, int Source> static void SetAffine(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+	template<typename T> static void SetExpression(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+	static void SetDirection(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+	static void SetPointer(const CExpGenSpawnProgram& program, const Setter& setter, State& state);
+
+private:
+	std::vector<Setter> setters;
+	std::vector<ValueOp> valueOps;
+
+	std::vector<ConstantRun> constantRuns;
+	std::vector<char> constantBytes;
+
+	/// whether any setter reads or writes the buffer, so it has to be cleared
+	bool usesBuffer;
+};
+
+#endif // EXP_GEN_SPAWN_PROGRAM_H
@@ -38,6 +38,9 @@
 #include "System/Util.h"
 
 
+static float SpawnRandFloat() { return gu->RandFloat(); }
+
+
 CR_BIND_DERIVED_INTERFACE(CExpGenSpawnable, CWorldObject);
 CR_REG_METADATA(CExpGenSpawnable, );
 
@@ -597,128 +600,6 @@ bool CStdExplosionGenerator::Explosion(
 
 
 
-void CCustomExplosionGenerator::ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir)
-{
-	float val = 0.0f;
-	void* ptr = NULL;
-	float buffer[16];
-
-	for (;;) {
-		switch (*(code++)) {
-			case OP_END: {
-				return;
-			}
-			case OP_STOREI: {
-				boost::uint16_t offset = *(boost::uint16_t*) code;
-				code += 2;
-				*(int*) (instance + offset) = (int) val;
-				val = 0.0f;
-				break;
-			}
-			case OP_STOREF: {
-				boost::uint16_t offset = *(boost::uint16_t*) code;
-				code += 2;
-				*(float*) (instance + offset) = val;
-				val = 0.0f;
-				break;
-			}
-			case OP_STOREC: {
-				boost::uint16_t offset = *(boost::uint16_t*) code;
-				code += 2;
-				*(unsigned char*) (instance + offset) = (int) val;
-				val = 0.0f;
-				break;
-			}
-			case OP_ADD: {
-				val += *(float*) code;
-				code += 4;
-				break;
-			}
-			case OP_RAND: {
-				val += gu->RandFloat() * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_DAMAGE: {
-				val += damage * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_INDEX: {
-				val += spawnIndex * (*(float*) code);
-				code += 4;
-				break;
-			}
-			case OP_LOADP: {
-				ptr = *(void**) code;
-				code += sizeof(void*);
-				break;
-			}
-			case OP_STOREP: {
-				boost::uint16_t offset = *(boost::uint16_t*) code;
-				code += 2;
-				*(void**) (instance + offset) = ptr;
-				ptr = NULL;
-				break;
-			}
-			case OP_DIR: {
-				boost::uint16_t offset = *(boost::uint16_t*) code;
-				code += 2;
-				*reinterpret_cast<float3*>(instance + offset) = dir;
-				break;
-			}
-			case OP_SAWTOOTH: {
-				// this translates to modulo except it works with floats
-				val -= (*(float*) code) * math::floor(val / (*(float*) code));
-				code += 4;
-				break;
-			}
-			case OP_DISCRETE: {
-				val = (*(float*) code) * math::floor(SafeDivide(val, (*(float*) code)));
-				code += 4;
-				break;
-			}
-			case OP_SINE: {
-				val = (*(float*) code) * math::sin(val);
-				code += 4;
-				break;
-			}
-			case OP_YANK: {
-				buffer[(*(int*) code)] = val;
-				val = 0;
-				code += 4;
-				break;
-			}
-			case OP_MULTIPLY: {
-				val *= buffer[(*(int*) code)];
-				code += 4;
-				break;
-			}
-			case OP_ADDBUFF: {
-				val += buffer[(*(int*) code)];
-				code += 4;
-				break;
-			}
-			case OP_POW: {
-				val = math::pow(val, (*(float*) code));
-				code += 4;
-				break;
-			}
-			case OP_POWBUFF: {
-				val = math::pow(val, buffer[(*(int*) code)]);
-				code += 4;
-				break;
-			}
-			default: {
-				assert(false);
-				break;
-			}
-		}
-	}
-}
-
-
-
 void CCustomExplosionGenerator::ParseExplosionCode(
 	CCustomExplosionGenerator::ProjectileSpawnInfo* psi,
 	const int offset,
@@ -731,7 +612,7 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 
 	if (vastr == "dir") { // first see if we can match any keywords
 		// if the user uses a keyword assume he knows that it is put on the right datatype for now
-		code += OP_DIR;
+		code += CExpGenSpawnProgram::OP_DIR;
 		boost::uint16_t ofs = offset;
 		code.append((char*) &ofs, (char*) &ofs + 2);
 	}
@@ -747,66 +628,13 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			throw content_error("[CCEG::ParseExplosionCode] projectile type-properties other than int, float, uchar, or bool are not supported (" + script + ")");
 		}
 
-		int p = 0;
-
-		while (p < script.length()) {
-			char opcode = OP_END;
-			char c = script[p++];
-
-			// consume whitespace
-			if (c == ' ')
-				continue;
-
-			bool useInt = false;
-
-			     if (c == 'i')   opcode = OP_INDEX;
-			else if (c == 'r')   opcode = OP_RAND;
-			else if (c == 'd')   opcode = OP_DAMAGE;
-			else if (c == 'm')   opcode = OP_SAWTOOTH;
-			else if (c == 'k')   opcode = OP_DISCRETE;
-			else if (c == 's')   opcode = OP_SINE;
-			else if (c == 'p')   opcode = OP_POW;
-			else if (c == 'y') { opcode = OP_YANK;     useInt = true; }
-			else if (c == 'x') { opcode = OP_MULTIPLY; useInt = true; }
-			else if (c == 'a') { opcode = OP_ADDBUFF;  useInt = true; }
-			else if (c == 'q') { opcode = OP_POWBUFF;  useInt = true; }
-			else if (isdigit(c) || c == '.' || c == '-') { opcode = OP_ADD; p--; }
-			else {
-				const char* fmt = "[CCEG::ParseExplosionCode] unknown op-code \"%c\" in \"%s\" at index %d";
-				LOG_L(L_WARNING, fmt, c, script.c_str(), p);
-				continue;
-			}
-
-			// be sure to exit cleanly if there are no more operators or operands
-			if (p >= script.size())
-				continue;
-
-			char* endp = NULL;
-
-			if (!useInt) {
-				// strtod&co expect C-style strings with NULLs,
-				// c_str() is guaranteed to be NULL-terminated
-				// (whether .data() == .c_str() depends on the
-				// implementation of std::string)
-				const float v = (float)strtod(&script.c_str()[p], &endp);
-
-				p += (endp - &script.c_str()[p]);
-				code += opcode;
-				code.append((char*) &v, ((char*) &v) + 4);
-			} else {
-				const int v = std::max(0, std::min(16, (int)strtol(&script.c_str()[p], &endp, 10)));
-
-				p += (endp - &script.c_str()[p]);
-				code += opcode;
-				code.append((char*) &v, ((char*) &v) + 4);
-			}
-		}
+		CExpGenSpawnProgram::ParseValueCode(script, code);
 
 		switch (basicType->id) {
-			case creg::crInt:   code.push_back(OP_STOREI); break;
-			case creg::crBool:  code.push_back(OP_STOREI); break;
-			case creg::crFloat: code.push_back(OP_STOREF); break;
-			case creg::crUChar: code.push_back(OP_STOREC); break;
+			case creg::crInt:   code.push_back(CExpGenSpawnProgram::OP_STOREI); break;
+			case creg::crBool:  code.push_back(CExpGenSpawnProgram::OP_STOREI); break;
+			case creg::crFloat: code.push_back(CExpGenSpawnProgram::OP_STOREF); break;
+			case creg::crUChar: code.push_back(CExpGenSpawnProgram::OP_STOREC); break;
 			default: break;
 		}
 
@@ -844,9 +672,9 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			string texname = script.substr(0, end);
 			// this memory is managed by textureAtlas (CTextureAtlas)
 			void* tex = &projectileDrawer->textureAtlas->GetTexture(texname);
-			code += OP_LOADP;
+			code += CExpGenSpawnProgram::OP_LOADP;
 			code.append((char*)(&tex), ((char*)(&tex)) + sizeof(void*));
-			code += OP_STOREP;
+			code += CExpGenSpawnProgram::OP_STOREP;
 			boost::uint16_t ofs = offset;
 			code.append((char*)&ofs, (char*)&ofs + 2);
 		} else if (type->GetName() == "GroundFXTexture*") {
@@ -854,9 +682,9 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			string texname = script.substr(0, end);
 			// this memory is managed by groundFXAtlas (CTextureAtlas)
 			void* tex = &projectileDrawer->groundFXAtlas->GetTexture(texname);
-			code += OP_LOADP;
+			code += CExpGenSpawnProgram::OP_LOADP;
 			code.append((char*)(&tex), ((char*)(&tex)) + sizeof(void*));
-			code += OP_STOREP;
+			code += CExpGenSpawnProgram::OP_STOREP;
 			boost::uint16_t ofs = offset;
 			code.append((char*)&ofs, (char*)&ofs + 2);
 		} else if (type->GetName() == "CColorMap*") {
@@ -864,9 +692,9 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			string colorstring = script.substr(0, end);
 			// gets stored and deleted at game end from inside CColorMap
 			void* colormap = CColorMap::LoadFromDefString(colorstring);
-			code += OP_LOADP;
+			code += CExpGenSpawnProgram::OP_LOADP;
 			code.append((char*)(&colormap), ((char*)(&colormap)) + sizeof(void*));
-			code += OP_STOREP;
+			code += CExpGenSpawnProgram::OP_STOREP;
 			boost::uint16_t ofs = offset;
 			code.append((char*)&ofs, (char*)&ofs + 2);
 		} else if (type->GetName() == "IExplosionGenerator*") {
@@ -877,9 +705,9 @@ void CCustomExplosionGenerator::ParseExplosionCode(
 			IExplosionGenerator* explGen = explGenHandler->LoadGenerator(name);
 
 			void* explGenRaw = (void*) explGen;
-			code += OP_LOADP;
+			code += CExpGenSpawnProgram::OP_LOADP;
 			code.append((char*)(&explGenRaw), ((char*)(&explGenRaw)) + sizeof(void*));
-			code += OP_STOREP;
+			code += CExpGenSpawnProgram::OP_STOREP;
 			boost::uint16_t ofs = offset;
 			code.append((char*)&ofs, (char*)&ofs + 2);
 		}
@@ -951,10 +779,15 @@ bool CCustomExplosionGenerator::Load(CExplosionGeneratorHandler* handler, const
 			}
 		}
 
-		code += (char)OP_END;
+		code += (char)CExpGenSpawnProgram::OP_END;
 		psi.code.resize(code.size());
 		copy(code.begin(), code.end(), psi.code.begin());
 
+		if (!psi.program.Compile(&psi.code[0])) {
+			LOG_L(L_WARNING, "[CCEG::%s] %s: invalid code for class \"%s\"", __FUNCTION__, tag.c_str(), className.c_str());
+			continue;
+		}
+
 		expGenParams.projectiles.push_back(psi);
 	}
 
@@ -1020,7 +853,7 @@ bool CCustomExplosionGenerator::Explosion(
 
 		for (unsigned int c = 0; c < psi.count; c++) {
 			CExpGenSpawnable* projectile = static_cast<CExpGenSpawnable*>((psi.projectileClass)->CreateInstance());
-			ExecuteExplosionCode(&psi.code[0], damage, (char*) projectile, c, dir);
+			psi.program.Execute((char*) projectile, damage, c, dir, &SpawnRandFloat);
 			projectile->Init(owner, pos);
 		}
 	}
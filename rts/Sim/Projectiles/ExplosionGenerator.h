@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "Sim/Objects/WorldObject.h"
+#include "Sim/Projectiles/ExpGenSpawnProgram.h"
 
 #define CEG_PREFIX_STRING "custom:"
 
@@ -173,6 +174,7 @@ protected:
 		ProjectileSpawnInfo(const ProjectileSpawnInfo& psi)
 			: projectileClass(psi.projectileClass)
 			, code(psi.code)
+			, program(psi.program)
 			, count(psi.count)
 			, flags(psi.flags)
 		{}
@@ -181,6 +183,8 @@ protected:
 
 		/// parsed explosion script code
 		std::vector<char> code;
+		/// code compiled into setters, run for every spawned projectile
+		CExpGenSpawnProgram program;
 
 		/// number of projectiles spawned of this type
 		unsigned int count;
@@ -242,31 +246,8 @@ public:
 		SPW_NO_UNIT    = 32,  // only execute when the explosion doesn't hit a unit (environment)
 	};
 
-	enum {
-		OP_END      =  0,
-		OP_STOREI   =  1, // int
-		OP_STOREF   =  2, // float
-		OP_STOREC   =  3, // char
-		OP_ADD      =  4,
-		OP_RAND     =  5,
-		OP_DAMAGE   =  6,
-		OP_INDEX    =  7,
-		OP_LOADP    =  8, // load a void* into the pointer register
-		OP_STOREP   =  9, // store the pointer register into a void*
-		OP_DIR      = 10, // store the float3 direction
-		OP_SAWTOOTH = 11, // Performs a modulo to create a sawtooth wave
-		OP_DISCRETE = 12, // Floors the value to a multiple of its parameter
-		OP_SINE     = 13, // Uses val as the phase of a sine wave
-		OP_YANK     = 14, // Moves the input value into a buffer, returns zero
-		OP_MULTIPLY = 15, // Multiplies with buffer value
-		OP_ADDBUFF  = 16, // Adds buffer value
-		OP_POW      = 17, // Power with code as exponent
-		OP_POWBUFF  = 18, // Power with buffer as exponent
-	};
-
 private:
 	void ParseExplosionCode(ProjectileSpawnInfo* psi, const int offset, const boost::shared_ptr<creg::IType> type, const std::string& script, std::string& code);
-	void ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir);
 
 protected:
 	ExpGenParams expGenParams;
@@ -10,6 +10,8 @@
 #include "Sim/Units/UnitHandler.h"
 #include "System/Matrix44f.h"
 
+CSlabMemPool projectileMemPool("Projectiles");
+
 CR_BIND_DERIVED(CProjectile, CExpGenSpawnable, );
 
 CR_REG_METADATA(CProjectile,
@@ -45,6 +47,10 @@ CR_REG_METADATA(CProjectile,
 ));
 
 CR_BIND(CProjectile::QuadFieldCellData, )
+CR_REG_METADATA_SUB(CProjectile, QuadFieldCellData, (
+	CR_MEMBER(coors),
+	CR_MEMBER(slots)
+));
 
 
 
@@ -11,6 +11,7 @@
 
 #include "ExplosionGenerator.h"
 #include "System/float3.h"
+#include "System/SlabMemPool.h"
 #include "System/type2.h"
 
 class CUnit;
@@ -18,10 +19,14 @@ class CFeature;
 class CVertexArray;
 class CMatrix44f;
 
+/// memory of all projectiles, see CProjectile::operator new
+extern CSlabMemPool projectileMemPool;
+
 
 class CProjectile: public CExpGenSpawnable
 {
 	CR_DECLARE(CProjectile);
+	CR_DECLARE_SUB(QuadFieldCellData);
 
 	/// used only by creg
 	CProjectile();
@@ -39,6 +44,9 @@ public:
 	virtual ~CProjectile();
 	virtual void Detach();
 
+	static void* operator new(size_t size) { return projectileMemPool.Alloc(size); }
+	static void operator delete(void* p, size_t size) { projectileMemPool.Free(p, size); }
+
 	virtual void Collision();
 	virtual void Collision(CUnit* unit);
 	virtual void Collision(CFeature* feature);
@@ -52,20 +60,20 @@ public:
 	struct QuadFieldCellData {
 		CR_DECLARE_STRUCT(QuadFieldCellData)
 
-		// must match typeof(QuadField::Quad::projectiles)
-		typedef std::list<CProjectile*>::iterator iter;
+		QuadFieldCellData() { slots[0] = slots[1] = slots[2] = -1; }
 
 		const int2& GetCoor(unsigned int idx) const { return coors[idx]; }
-		const iter& GetIter(unsigned int idx) const { return iters[idx]; }
+		int GetSlot(unsigned int idx) const { return slots[idx]; }
 
 		void SetCoor(unsigned int idx, const int2& co) { coors[idx] = co; }
-		void SetIter(unsigned int idx, const iter& it) { iters[idx] = it; }
+		void SetSlot(unsigned int idx, int slot) { slots[idx] = slot; }
 
 	private:
-		// coordinates and iterators for pos, (pos+spd)*0.5, pos+spd
-		// non-hitscan projectiles *only* use coors[0] and iters[0]!
+		// coordinates and indices into QuadField::Quad::projectiles for pos,
+		// (pos+spd)*0.5, pos+spd; a slot of -1 means "not inserted" and
+		// non-hitscan projectiles *only* use coors[0] and slots[0]!
 		int2 coors[3];
-		iter iters[3];
+		int slots[3];
 	};
 
 	// override WorldObject::SetVelocityAndSpeed so
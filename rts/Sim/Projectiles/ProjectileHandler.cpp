@@ -161,7 +161,27 @@ void CProjectileHandler::Serialize(creg::ISerializer* s)
 
 void CProjectileHandler::PostLoad()
 {
-	//TODO
+	// the render-side maps and event batches are not saved, register
+	// every loaded projectile with them again (as AddProjectile does)
+	for (ProjectileMap::const_iterator it = syncedProjectileIDs.begin(); it != syncedProjectileIDs.end(); ++it) {
+		const ProjectileMapValPair& vp = it->second;
+
+		syncedRenderProjectileIDs.push(vp.first, vp);
+		(eventBatchHandler->GetSyncedProjectileCreatedDestroyedBatch()).insert(vp.first);
+	}
+
+#if UNSYNCED_PROJ_NOEVENT
+	for (ProjectileContainer::iterator it = unsyncedProjectiles.begin(); it != unsyncedProjectiles.end(); ++it) {
+		eventHandler.UnsyncedProjectileCreated(*it);
+	}
+#else
+	for (ProjectileMap::const_iterator it = unsyncedProjectileIDs.begin(); it != unsyncedProjectileIDs.end(); ++it) {
+		const ProjectileMapValPair& vp = it->second;
+
+		unsyncedRenderProjectileIDs.push(vp.first, vp);
+		(eventBatchHandler->GetUnsyncedProjectileCreatedDestroyedBatch()).insert(vp.first);
+	}
+#endif
 }
 
 
@@ -231,6 +251,43 @@ void CProjectileHandler::UpdateProjectileContainer(ProjectileContainer& pc, bool
 
 
 
+void CProjectileHandler::CommitProjectileChanges()
+{
+	GML_STDMUTEX_LOCK(rproj); // CommitProjectileChanges
+
+	syncedRenderProjectileIDs.delay_delete();
+	syncedRenderProjectileIDs.delay_add();
+#if !UNSYNCED_PROJ_NOEVENT
+	unsyncedRenderProjectileIDs.delay_delete();
+	unsyncedRenderProjectileIDs.delay_add();
+#endif
+
+	if (syncedProjectiles.can_delete_synced()) {
+		eventHandler.DeleteSyncedProjectiles();
+		//! delete all projectiles that were
+		//! queued (push_back'ed) for deletion
+		syncedProjectiles.detach_erased_synced();
+	}
+
+	eventHandler.UpdateProjectiles();
+}
+
+void CProjectileHandler::DeleteAllProjectiles()
+{
+	for (ProjectileContainer::iterator it = syncedProjectiles.begin(); it != syncedProjectiles.end(); ++it) {
+		(*it)->deleteMe = true;
+	}
+	for (ProjectileContainer::iterator it = unsyncedProjectiles.begin(); it != unsyncedProjectiles.end(); ++it) {
+		(*it)->deleteMe = true;
+	}
+
+	// nothing is left to update, so this only takes the regular removal path
+	UpdateProjectileContainer(syncedProjectiles, true);
+	UpdateProjectileContainer(unsyncedProjectiles, false);
+	CommitProjectileChanges();
+}
+
+
 void CProjectileHandler::Update()
 {
 	CheckCollisions();
@@ -241,27 +298,7 @@ void CProjectileHandler::Update()
 
 		UpdateProjectileContainer(syncedProjectiles, true);
 		UpdateProjectileContainer(unsyncedProjectiles, false);
-
-
-		{
-			GML_STDMUTEX_LOCK(rproj); // Update
-
-			syncedRenderProjectileIDs.delay_delete();
-			syncedRenderProjectileIDs.delay_add();
-#if !UNSYNCED_PROJ_NOEVENT
-			unsyncedRenderProjectileIDs.delay_delete();
-			unsyncedRenderProjectileIDs.delay_add();
-#endif
-
-			if (syncedProjectiles.can_delete_synced()) {
-				eventHandler.DeleteSyncedProjectiles();
-				//! delete all projectiles that were
-				//! queued (push_back'ed) for deletion
-				syncedProjectiles.detach_erased_synced();
-			}
-
-			eventHandler.UpdateProjectiles();
-		}
+		CommitProjectileChanges();
 
 
 		GroundFlashContainer::iterator gfi = groundFlashes.begin();
@@ -307,6 +344,10 @@ void CProjectileHandler::Update()
 			flyingPiecesS3O.delay_add();
 		}
 	}
+
+	projectileMemPool.UpdateFrameStats();
+	groundFlashMemPool.UpdateFrameStats();
+	flyingPieceMemPool.UpdateFrameStats();
 }
 
 
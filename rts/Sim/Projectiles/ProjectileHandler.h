@@ -94,6 +94,8 @@ public:
 	void SetMaxNanoParticles(int value) { maxNanoParticles = value; }
 
 	void Update();
+	/// removes every synced and unsynced projectile right away
+	void DeleteAllProjectiles();
 	void UpdateParticleSaturation() {
 		particleSaturation = (maxParticles > 0)? (currentParticles / float(maxParticles)): 1.0f;
 	}
@@ -121,6 +123,7 @@ public:
 
 private:
 	void UpdateProjectileContainer(ProjectileContainer&, bool);
+	void CommitProjectileChanges();
 
 	ProjectileRenderMap syncedRenderProjectileIDs;        // same as syncedProjectileIDs, used by render thread
 	ProjectileRenderMap unsyncedRenderProjectileIDs;      // same as unsyncedProjectileIDs, used by render thread
@@ -12,6 +12,8 @@
 #include "Rendering/Models/3DOParser.h"
 #include "Rendering/Models/S3OParser.h"
 
+CSlabMemPool flyingPieceMemPool("FlyingPieces");
+
 SS3OFlyingPiece::~SS3OFlyingPiece() {
 	delete[] chunk;
 }
@@ -3,20 +3,17 @@
 #ifndef FLYING_PIECE_H
 #define FLYING_PIECE_H
 
-#include "lib/gml/gmlcnf.h"
-
-#if !(defined(USE_GML) && GML_ENABLE_SIM)
-#include "System/MemPool.h"
-#endif
-
 #include "System/float3.h"
 #include "System/Matrix44f.h"
+#include "System/SlabMemPool.h"
 
 class CVertexArray;
 struct S3DOPrimitive;
 struct S3DOPiece;
 struct SS3OVertex;
 
+extern CSlabMemPool flyingPieceMemPool;
+
 struct FlyingPiece {
 public:
 	virtual ~FlyingPiece() {}
@@ -27,10 +24,9 @@ public:
 	size_t GetTeam() const { return team; }
 	size_t GetTexture() const { return texture; }
 
-	#if !(defined(USE_GML) && GML_ENABLE_SIM)
-	inline void* operator new(size_t size) { return mempool.Alloc(size); }
-	inline void operator delete(void* p, size_t size) { mempool.Free(p, size); }
-	#endif
+	// the pool is thread-safe, so this is fine with GML as well
+	inline void* operator new(size_t size) { return flyingPieceMemPool.Alloc(size); }
+	inline void operator delete(void* p, size_t size) { flyingPieceMemPool.Free(p, size); }
 
 protected:
 	void InitCommon(const float3& _pos, const float3& _speed, int _team);
@@ -29,6 +29,7 @@ int GCurrentTime;
 
 CCobEngine::CCobEngine()
 	: curThread(NULL)
+	, threadMemPool(sizeof(CCobThread), 256)
 {
 	GCurrentTime = 0;
 }
@@ -48,10 +49,12 @@ CCobEngine::~CCobEngine()
 			wantToRun.pop_front();
 			delete tmp;
 		}
-		while (!sleeping.empty()) {
-			CCobThread* tmp = sleeping.top();
-			sleeping.pop();
-			delete tmp;
+		if (!sleeping.empty()) {
+			std::vector<CCobThread*> tmp;
+			sleeping.Clear(tmp);
+			for (size_t n = 0; n < tmp.size(); n++) {
+				delete tmp[n];
+			}
 		}
 		// callbacks may add new threads
 	} while (!running.empty() || !wantToRun.empty() || !sleeping.empty());
@@ -75,7 +78,7 @@ void CCobEngine::AddThread(CCobThread *thread)
 			wantToRun.push_front(thread);
 			break;
 		case CCobThread::Sleep:
-			sleeping.push(thread);
+			sleeping.Insert(thread, thread->GetWakeTime());
 			break;
 		default:
 			LOG_L(L_ERROR, "thread added to scheduler with unknown state (%d)", thread->state);
@@ -125,34 +128,26 @@ void CCobEngine::Tick(int deltaTime)
 
 	wantToRun.clear();
 
-	//Check on the sleeping threads
-	if (!sleeping.empty()) {
-		CCobThread* cur = sleeping.top();
+	// Wake the sleeping threads due before now, by wake time (in the order
+	// they went to sleep for equal times). They can go back to sleep while
+	// this runs, but not for this tick since they sleep for >= 0 ms
+	sleeping.Advance(GCurrentTime, [this](CCobThread* thread) { WakeThread(thread); });
+}
 
-		while ((cur != NULL) && (cur->GetWakeTime() < GCurrentTime)) {
-			// Start with removing the executing thread from the queue
-			sleeping.pop();
 
-			//Run forward again. This can quite possibly readd the thread to the sleeping array again
-			//But it will not interfere since it is guaranteed to sleep > 0 ms
-			//LOG_L(L_DEBUG, "Now 2running %d: %s", GCurrentTime, cur->GetName().c_str());
+void CCobEngine::WakeThread(CCobThread* thread)
+{
+	//LOG_L(L_DEBUG, "Now 2running %d: %s", GCurrentTime, thread->GetName().c_str());
 #ifdef _CONSOLE
-			printf("+++\n");
+	printf("+++\n");
 #endif
-			if (cur->state == CCobThread::Sleep) {
-				cur->state = CCobThread::Run;
-				TickThread(cur);
-			} else if (cur->state == CCobThread::Dead) {
-				delete cur;
-			} else {
-				LOG_L(L_ERROR, "Sleeping thread strange state %d", cur->state);
-			}
-
-			if (!sleeping.empty())
-				cur = sleeping.top();
-			else
-				cur = NULL;
-		}
+	if (thread->state == CCobThread::Sleep) {
+		thread->state = CCobThread::Run;
+		TickThread(thread);
+	} else if (thread->state == CCobThread::Dead) {
+		delete thread;
+	} else {
+		LOG_L(L_ERROR, "Sleeping thread strange state %d", thread->state);
 	}
 }
 
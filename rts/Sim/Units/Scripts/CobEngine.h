@@ -10,9 +10,10 @@
  */
 
 #include "CobThread.h"
+#include "System/MemPool.h"
+#include "System/Misc/TimerWheel.h"
 
 #include <list>
-#include <queue>
 #include <map>
 
 class CCobThread;
@@ -20,14 +21,6 @@ class CCobInstance;
 class CCobFile;
 
 
-class CCobThreadPtr_less : public std::binary_function<CCobThread*, CCobThread*, bool> {
-public:
-	bool operator() (const CCobThread* const& a, const CCobThread* const& b) const {
-		return a->GetWakeTime() > b->GetWakeTime();
-	}
-};
-
-
 class CCobEngine
 {
 protected:
@@ -37,15 +30,22 @@ protected:
 	 * And moved to real running after running is empty.
 	 */
 	std::list<CCobThread*> wantToRun;
-	std::priority_queue<CCobThread*, std::vector<CCobThread*>, CCobThreadPtr_less> sleeping;
+	/// sleeping threads, keyed on their wake time
+	CTimerWheel<CCobThread> sleeping;
 	CCobThread* curThread;
+	/// memory of all CCobThread instances (threads are created and killed all the time)
+	CFixedSizeMemPool threadMemPool;
 	void TickThread(CCobThread* thread);
+	void WakeThread(CCobThread* thread);
 public:
 	CCobEngine();
 	~CCobEngine();
 	void AddThread(CCobThread* thread);
 	void Tick(int deltaTime);
 	void ShowScriptError(const std::string& msg);
+
+	void* AllocThread(size_t size) { return threadMemPool.Alloc(size); }
+	void FreeThread(void* p, size_t size) { threadMemPool.Free(p, size); }
 };
 
 
@@ -3,6 +3,7 @@
 
 #include "Sim/Misc/GlobalConstants.h"
 #include "CobFile.h"
+#include "CobInstructions.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Log/ILog.h"
 #include "System/Sound/ISound.h"
@@ -149,7 +150,7 @@ CCobFile::CCobFile(CFileHandler &in, string name)
 
 	int code_octets = size - ch.OffsetToScriptCode;
 	int code_ints = (code_octets) / 4 + 4;
-	code = new int[code_ints];
+	code = new int[code_ints]();
 	memcpy(code, &cobdata[ch.OffsetToScriptCode], code_octets);
 	for (int i = 0; i < code_ints; i++) {
 		swabDWordInPlace(code[i]);
@@ -194,6 +195,65 @@ CCobFile::CCobFile(CFileHandler &in, string name)
 			scriptIndex[it->second] = fn;
 		}
 	}
+
+	fireScripts.resize(scriptNames.size(), false);
+	for (int i = 0; i < MAX_WEAPONS_PER_UNIT; ++i) {
+		const int fn = scriptIndex[COBFN_FirePrimary + COBFN_Weapon_Funcs * i];
+		if (fn >= 0) {
+			fireScripts[fn] = true;
+		}
+	}
+
+	DecodeCode(code_ints);
+}
+
+
+void CCobFile::DecodeCode(int numCodeInts)
+{
+	const int badJumpPos = numCodeInts + 1;
+
+	// every position is decoded on its own, jumps can land anywhere
+	ops.resize(numCodeInts + 2);
+
+	for (int i = 0; i < numCodeInts + 2; ++i) {
+		DecodedOp& op = ops[i];
+
+		op.instr = (i < numCodeInts)? DecodeCobOpcode(code[i]): COB_UNKNOWN;
+		op.operands[0] = 0;
+		op.operands[1] = 0;
+
+		// an instruction whose operands run past the end is not executable
+		if ((i + GetCobOperandCount(op.instr)) >= numCodeInts) {
+			op.instr = COB_UNKNOWN;
+		}
+
+		op.length = 1 + GetCobOperandCount(op.instr);
+
+		for (int n = 1; n < op.length; ++n) {
+			op.operands[n - 1] = code[i + n];
+		}
+
+		switch (op.instr) {
+			case COB_CALL: {
+				// resolve calls to Lua or to other COB functions (stays a
+				// CALL, and fails when executed, if the function does not exist)
+				const int fn = op.operands[0];
+
+				if (fn >= 0 && fn < int(scriptNames.size())) {
+					op.instr = (scriptNames[fn].find("lua_") == 0)? COB_LUA_CALL: COB_REAL_CALL;
+				}
+			} break;
+			case COB_JUMP:
+			case COB_JUMP_NOT_EQUAL: {
+				// the trailing COB_UNKNOWN is still a valid target
+				if (op.operands[0] < 0 || op.operands[0] > numCodeInts) {
+					op.operands[0] = badJumpPos;
+				}
+			} break;
+		}
+	}
+
+	ops[badJumpPos].instr = COB_BAD_JUMP;
 }
 
 
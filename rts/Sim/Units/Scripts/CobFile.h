@@ -20,6 +20,17 @@ public:
 
 	int GetFunctionId(const std::string& name);
 
+	/// a code position decoded into its instruction and operands
+	struct DecodedOp {
+		unsigned char instr;  ///< see CobInstructions.h
+		unsigned char length; ///< 1 + number of operands
+		int operands[2];
+	};
+
+private:
+	void DecodeCode(int numCodeInts);
+
+public:
 
 	std::vector<std::string> scriptNames;
 	std::vector<int> scriptOffsets;
@@ -31,6 +42,15 @@ public:
 	std::map<std::string, int> scriptMap;
 	std::vector<LuaHashString> luaScripts;
 	int* code;
+	/**
+	 * Pre-decoded instruction for every int in code, plus a trailing
+	 * COB_UNKNOWN and COB_BAD_JUMP; built once when the script is loaded
+	 * so that the interpreter never looks at the raw code, fixes up CALLs
+	 * or range-checks jumps.
+	 */
+	std::vector<DecodedOp> ops;
+	/// whether a function is one of the weapon Fire scripts (SHOW emits a flare there)
+	std::vector<bool> fireScripts;
 	int numStaticVars;
 	std::string name;
 };
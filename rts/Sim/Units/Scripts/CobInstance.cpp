@@ -77,13 +77,13 @@ CCobInstance::~CCobInstance()
 
 	do {
 		for (int animType = ATurn; animType <= AMove; animType++) {
-			for (std::list<AnimInfo *>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+			// indexed, deleting a listener can run callbacks that add anims
+			for (size_t n = 0; n < anims[animType].size(); n++) {
 				// All threads blocking on animations can be killed safely from here since the scheduler does not
 				// know about them
-				std::list<IAnimListener *>& listeners = (*i)->listeners;
-				while (!listeners.empty()) {
-					IAnimListener* al = listeners.front();
-					listeners.pop_front();
+				while (!anims[animType][n].listeners.empty()) {
+					IAnimListener* al = anims[animType][n].listeners.front();
+					anims[animType][n].listeners.pop_front();
 					delete al;
 				}
 				// the anims are deleted in ~CUnitScript
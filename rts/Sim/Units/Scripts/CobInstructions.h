@@ -0,0 +1,188 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef COB_INSTRUCTIONS_H
+#define COB_INSTRUCTIONS_H
+
+// Command documentation from http://visualta.tauniverse.com/Downloads/cob-commands.txt
+// And some information from basm0.8 source (basm ops.txt)
+
+// Model interaction
+static const int MOVE       = 0x10001000;
+static const int TURN       = 0x10002000;
+static const int SPIN       = 0x10003000;
+static const int STOP_SPIN  = 0x10004000;
+static const int SHOW       = 0x10005000;
+static const int HIDE       = 0x10006000;
+static const int CACHE      = 0x10007000;
+static const int DONT_CACHE = 0x10008000;
+static const int MOVE_NOW   = 0x1000B000;
+static const int TURN_NOW   = 0x1000C000;
+static const int SHADE      = 0x1000D000;
+static const int DONT_SHADE = 0x1000E000;
+static const int EMIT_SFX   = 0x1000F000;
+
+// Blocking operations
+static const int WAIT_TURN  = 0x10011000;
+static const int WAIT_MOVE  = 0x10012000;
+static const int SLEEP      = 0x10013000;
+
+// Stack manipulation
+static const int PUSH_CONSTANT    = 0x10021001;
+static const int PUSH_LOCAL_VAR   = 0x10021002;
+static const int PUSH_STATIC      = 0x10021004;
+static const int CREATE_LOCAL_VAR = 0x10022000;
+static const int POP_LOCAL_VAR    = 0x10023002;
+static const int POP_STATIC       = 0x10023004;
+static const int POP_STACK        = 0x10024000; ///< Not sure what this is supposed to do
+
+// Arithmetic operations
+static const int ADD         = 0x10031000;
+static const int SUB         = 0x10032000;
+static const int MUL         = 0x10033000;
+static const int DIV         = 0x10034000;
+static const int MOD         = 0x10034001; ///< spring specific
+static const int BITWISE_AND = 0x10035000;
+static const int BITWISE_OR  = 0x10036000;
+static const int BITWISE_XOR = 0x10037000;
+static const int BITWISE_NOT = 0x10038000;
+
+// Native function calls
+static const int RAND           = 0x10041000;
+static const int GET_UNIT_VALUE = 0x10042000;
+static const int GET            = 0x10043000;
+
+// Comparison
+static const int SET_LESS             = 0x10051000;
+static const int SET_LESS_OR_EQUAL    = 0x10052000;
+static const int SET_GREATER          = 0x10053000;
+static const int SET_GREATER_OR_EQUAL = 0x10054000;
+static const int SET_EQUAL            = 0x10055000;
+static const int SET_NOT_EQUAL        = 0x10056000;
+static const int LOGICAL_AND          = 0x10057000;
+static const int LOGICAL_OR           = 0x10058000;
+static const int LOGICAL_XOR          = 0x10059000;
+static const int LOGICAL_NOT          = 0x1005A000;
+
+// Flow control
+static const int START           = 0x10061000;
+static const int CALL            = 0x10062000; ///< resolved when the script is loaded
+static const int REAL_CALL       = 0x10062001; ///< spring custom
+static const int LUA_CALL        = 0x10062002; ///< spring custom
+static const int JUMP            = 0x10064000;
+static const int RETURN          = 0x10065000;
+static const int JUMP_NOT_EQUAL  = 0x10066000;
+static const int SIGNAL          = 0x10067000;
+static const int SET_SIGNAL_MASK = 0x10068000;
+
+// Piece destruction
+static const int EXPLODE    = 0x10071000;
+static const int PLAY_SOUND = 0x10072000;
+
+// Special functions
+static const int SET    = 0x10082000;
+static const int ATTACH = 0x10083000;
+static const int DROP   = 0x10084000;
+
+
+/**
+ * All opcodes with the number of operands that follow them in the code,
+ * in the order of their (dense) instruction numbers.
+ * COB_INSTR(name, numOperands) is expanded once per opcode.
+ */
+#define COB_INSTRUCTION_LIST \
+	COB_INSTR(MOVE,                 2) \
+	COB_INSTR(TURN,                 2) \
+	COB_INSTR(SPIN,                 2) \
+	COB_INSTR(STOP_SPIN,            2) \
+	COB_INSTR(SHOW,                 1) \
+	COB_INSTR(HIDE,                 1) \
+	COB_INSTR(CACHE,                1) \
+	COB_INSTR(DONT_CACHE,           1) \
+	COB_INSTR(MOVE_NOW,             2) \
+	COB_INSTR(TURN_NOW,             2) \
+	COB_INSTR(SHADE,                1) \
+	COB_INSTR(DONT_SHADE,           1) \
+	COB_INSTR(EMIT_SFX,             1) \
+	COB_INSTR(WAIT_TURN,            2) \
+	COB_INSTR(WAIT_MOVE,            2) \
+	COB_INSTR(SLEEP,                0) \
+	COB_INSTR(PUSH_CONSTANT,        1) \
+	COB_INSTR(PUSH_LOCAL_VAR,       1) \
+	COB_INSTR(PUSH_STATIC,          1) \
+	COB_INSTR(CREATE_LOCAL_VAR,     0) \
+	COB_INSTR(POP_LOCAL_VAR,        1) \
+	COB_INSTR(POP_STATIC,           1) \
+	COB_INSTR(POP_STACK,            0) \
+	COB_INSTR(ADD,                  0) \
+	COB_INSTR(SUB,                  0) \
+	COB_INSTR(MUL,                  0) \
+	COB_INSTR(DIV,                  0) \
+	COB_INSTR(MOD,                  0) \
+	COB_INSTR(BITWISE_AND,          0) \
+	COB_INSTR(BITWISE_OR,           0) \
+	COB_INSTR(BITWISE_XOR,          0) \
+	COB_INSTR(BITWISE_NOT,          0) \
+	COB_INSTR(RAND,                 0) \
+	COB_INSTR(GET_UNIT_VALUE,       0) \
+	COB_INSTR(GET,                  0) \
+	COB_INSTR(SET_LESS,             0) \
+	COB_INSTR(SET_LESS_OR_EQUAL,    0) \
+	COB_INSTR(SET_GREATER,          0) \
+	COB_INSTR(SET_GREATER_OR_EQUAL, 0) \
+	COB_INSTR(SET_EQUAL,            0) \
+	COB_INSTR(SET_NOT_EQUAL,        0) \
+	COB_INSTR(LOGICAL_AND,          0) \
+	COB_INSTR(LOGICAL_OR,           0) \
+	COB_INSTR(LOGICAL_XOR,          0) \
+	COB_INSTR(LOGICAL_NOT,          0) \
+	COB_INSTR(START,                2) \
+	COB_INSTR(CALL,                 2) \
+	COB_INSTR(REAL_CALL,            2) \
+	COB_INSTR(LUA_CALL,             2) \
+	COB_INSTR(JUMP,                 1) \
+	COB_INSTR(RETURN,               0) \
+	COB_INSTR(JUMP_NOT_EQUAL,       1) \
+	COB_INSTR(SIGNAL,               0) \
+	COB_INSTR(SET_SIGNAL_MASK,      0) \
+	COB_INSTR(EXPLODE,              1) \
+	COB_INSTR(PLAY_SOUND,           1) \
+	COB_INSTR(SET,                  0) \
+	COB_INSTR(ATTACH,               0) \
+	COB_INSTR(DROP,                 0)
+
+enum CobInstruction {
+#define COB_INSTR(name, numOperands) COB_##name,
+	COB_INSTRUCTION_LIST
+#undef COB_INSTR
+	COB_UNKNOWN,
+	COB_BAD_JUMP, ///< target of every jump that leaves the code
+	COB_NUM_INSTRUCTIONS
+};
+
+/// maps a raw opcode to its instruction number, COB_UNKNOWN if it is not one
+static inline unsigned char DecodeCobOpcode(int opcode)
+{
+	switch (opcode) {
+#define COB_INSTR(name, numOperands) case name: return COB_##name;
+		COB_INSTRUCTION_LIST
+#undef COB_INSTR
+	}
+
+	return COB_UNKNOWN;
+}
+
+/// number of operands following an instruction in the code
+static inline int GetCobOperandCount(unsigned char instr)
+{
+	static const unsigned char operandCounts[COB_NUM_INSTRUCTIONS] = {
+#define COB_INSTR(name, numOperands) numOperands,
+		COB_INSTRUCTION_LIST
+#undef COB_INSTR
+		0,
+		0
+	};
+
+	return operandCounts[instr];
+}
+
+#endif // COB_INSTRUCTIONS_H
@@ -3,6 +3,7 @@
 
 #include "CobThread.h"
 #include "CobFile.h"
+#include "CobInstructions.h"
 #include "CobInstance.h"
 #include "CobEngine.h"
 #include "UnitScriptLog.h"
@@ -10,6 +11,7 @@
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -18,8 +20,10 @@ CCobThread::CCobThread(CCobFile& script, CCobInstance* owner)
 	, owner(owner)
 	, wakeTime(0)
 	, PC(0)
+	, stackSize(0)
 	, paramCount(0)
 	, retCode(0)
+	, callStackSize(0)
 	, callback(NULL)
 	, cbParam1(NULL)
 	, cbParam2(NULL)
@@ -43,6 +47,16 @@ CCobThread::~CCobThread()
 	SetCallback(NULL, NULL, NULL);
 }
 
+void* CCobThread::operator new(size_t size)
+{
+	return GCobEngine.AllocThread(size);
+}
+
+void CCobThread::operator delete(void* p, size_t size)
+{
+	GCobEngine.FreeThread(p, size);
+}
+
 void CCobThread::SetCallback(CBCobThreadFinish cb, void* p1, void* p2)
 {
 	callback = cb;
@@ -56,17 +70,18 @@ void CCobThread::Start(int functionId, const vector<int>& args, bool schedule)
 	state = Run;
 	PC = script.scriptOffsets[functionId];
 
-	struct callInfo ci;
+	callInfo& ci = callStack[0];
 	ci.functionId = functionId;
 	ci.returnAddr = -1;
 	ci.stackTop = 0;
-	callStack.push_back(ci);
+	callStackSize = 1;
 	paramCount = args.size();
 	signalMask = 0;
 	callback = NULL;
 	retCode = -1;
 	// copy arguments
-	stack = args;
+	stackSize = std::min(args.size(), size_t(MAX_STACK_SIZE));
+	std::copy(args.begin(), args.begin() + stackSize, stack);
 
 	// Add to scheduler
 	if (schedule)
@@ -80,18 +95,18 @@ const string& CCobThread::GetName()
 
 int CCobThread::CheckStack(unsigned int size, bool warn)
 {
-	if ((unsigned)size > stack.size()) {
+	if (size > stackSize) {
 		static char msg[512];
 		static const char* fmt =
-			"stack-size mismatch: need %u but have %lu arguments "
+			"stack-size mismatch: need %u but have %u arguments "
 			"(too many passed to function or too few returned?)";
 
 		if (warn) {
-			SNPRINTF(msg, sizeof(msg), fmt, size, stack.size());
+			SNPRINTF(msg, sizeof(msg), fmt, size, stackSize);
 			ShowError(msg);
 		}
 
-		return stack.size();
+		return stackSize;
 	}
 
 	return size;
@@ -107,86 +122,6 @@ int CCobThread::GetWakeTime() const
 	return wakeTime;
 }
 
-// Command documentation from http://visualta.tauniverse.com/Downloads/cob-commands.txt
-// And some information from basm0.8 source (basm ops.txt)
-
-// Model interaction
-const int MOVE       = 0x10001000;
-const int TURN       = 0x10002000;
-const int SPIN       = 0x10003000;
-const int STOP_SPIN  = 0x10004000;
-const int SHOW       = 0x10005000;
-const int HIDE       = 0x10006000;
-const int CACHE      = 0x10007000;
-const int DONT_CACHE = 0x10008000;
-const int MOVE_NOW   = 0x1000B000;
-const int TURN_NOW   = 0x1000C000;
-const int SHADE      = 0x1000D000;
-const int DONT_SHADE = 0x1000E000;
-const int EMIT_SFX   = 0x1000F000;
-
-// Blocking operations
-const int WAIT_TURN  = 0x10011000;
-const int WAIT_MOVE  = 0x10012000;
-const int SLEEP      = 0x10013000;
-
-// Stack manipulation
-const int PUSH_CONSTANT    = 0x10021001;
-const int PUSH_LOCAL_VAR   = 0x10021002;
-const int PUSH_STATIC      = 0x10021004;
-const int CREATE_LOCAL_VAR = 0x10022000;
-const int POP_LOCAL_VAR    = 0x10023002;
-const int POP_STATIC       = 0x10023004;
-const int POP_STACK        = 0x10024000; ///< Not sure what this is supposed to do
-
-// Arithmetic operations
-const int ADD         = 0x10031000;
-const int SUB         = 0x10032000;
-const int MUL         = 0x10033000;
-const int DIV         = 0x10034000;
-const int MOD		  = 0x10034001; ///< spring specific
-const int BITWISE_AND = 0x10035000;
-const int BITWISE_OR  = 0x10036000;
-const int BITWISE_XOR = 0x10037000;
-const int BITWISE_NOT = 0x10038000;
-
-// Native function calls
-const int RAND           = 0x10041000;
-const int GET_UNIT_VALUE = 0x10042000;
-const int GET            = 0x10043000;
-
-// Comparison
-const int SET_LESS             = 0x10051000;
-const int SET_LESS_OR_EQUAL    = 0x10052000;
-const int SET_GREATER          = 0x10053000;
-const int SET_GREATER_OR_EQUAL = 0x10054000;
-const int SET_EQUAL            = 0x10055000;
-const int SET_NOT_EQUAL        = 0x10056000;
-const int LOGICAL_AND          = 0x10057000;
-const int LOGICAL_OR           = 0x10058000;
-const int LOGICAL_XOR          = 0x10059000;
-const int LOGICAL_NOT          = 0x1005A000;
-
-// Flow control
-const int START           = 0x10061000;
-const int CALL            = 0x10062000; ///< converted when executed
-const int REAL_CALL       = 0x10062001; ///< spring custom
-const int LUA_CALL        = 0x10062002; ///< spring custom
-const int JUMP            = 0x10064000;
-const int RETURN          = 0x10065000;
-const int JUMP_NOT_EQUAL  = 0x10066000;
-const int SIGNAL          = 0x10067000;
-const int SET_SIGNAL_MASK = 0x10068000;
-
-// Piece destruction
-const int EXPLODE    = 0x10071000;
-const int PLAY_SOUND = 0x10072000;
-
-// Special functions
-const int SET    = 0x10082000;
-const int ATTACH = 0x10083000;
-const int DROP   = 0x10084000;
-
 // Indices for SET, GET, and GET_UNIT_VALUE for LUA return values
 #define LUA0 110 // (LUA0 returns the lua call status, 0 or 1)
 #define LUA1 111
@@ -201,16 +136,30 @@ const int DROP   = 0x10084000;
 
 
 // Handy macros
-#define GET_LONG_PC() (script.code[PC++])
-// #define POP() (stack.size() > 0) ? stack.back(), stack.pop_back(); : 0
+#define OPERAND(n) (op->operands[n])
+#define PUSH(x) do { if (stackSize >= MAX_STACK_SIZE) goto stack_overflow; stack[stackSize++] = (x); } while (0)
+#define LOCAL_VAR(i, idx) do { idx = CurrentCall().stackTop + (i); if (idx >= MAX_STACK_SIZE) goto bad_local_var; } while (0)
+#define COB_TRACE() LOG_L(L_DEBUG, "PC: %x opcode: %x (%s)", PC, script.code[PC], GetOpcodeName(script.code[PC]).c_str())
+
+// With GCC (and clang) every instruction jumps straight to the code of the
+// next one through a table of label addresses, which lets the CPU predict
+// each dispatch separately; other compilers fall back to a switch.
+#if defined(__GNUC__)
+	#define COB_DIRECT_THREADED
+#endif
+
+#ifdef COB_DIRECT_THREADED
+	#define COB_OP(name) op_##name:
+	#define COB_NEXT() do { if (state != Run) goto done; COB_TRACE(); op = &ops[PC]; PC += op->length; goto *dispatchTable[op->instr]; } while (0)
+#else
+	#define COB_OP(name) case COB_##name:
+	#define COB_NEXT() continue
+#endif
 
 int CCobThread::POP()
 {
-	if (!stack.empty()) {
-		int r = stack.back();
-		stack.pop_back();
-		return r;
-	}
+	if (stackSize > 0)
+		return stack[--stackSize];
 
 	return 0;
 }
@@ -227,471 +176,506 @@ bool CCobThread::Tick()
 	state = Run;
 
 	int r1, r2, r3, r4, r5, r6;
+	size_t idx;
 
 	vector<int> args;
-	vector<int>::iterator ei;
 
-	execTrace.clear();
+	// instructions decoded when the script was loaded, one per code int
+	const CCobFile::DecodedOp* ops = &script.ops[0];
+	const CCobFile::DecodedOp* op = NULL;
+
+	LOG_L(L_DEBUG, "Executing in %s (from %s)", script.scriptNames[CurrentCall().functionId].c_str(), GetName().c_str());
 
-	LOG_L(L_DEBUG, "Executing in %s (from %s)", script.scriptNames[callStack.back().functionId].c_str(), GetName().c_str());
+#ifdef COB_DIRECT_THREADED
+	static void* const dispatchTable[COB_NUM_INSTRUCTIONS] = {
+	#define COB_INSTR(name, numOperands) &&op_##name,
+		COB_INSTRUCTION_LIST
+	#undef COB_INSTR
+		&&op_UNKNOWN,
+		&&op_BAD_JUMP
+	};
 
+	COB_NEXT();
+#else
 	while (state == Run) {
-		//int opcode = *(int*)&script.code[PC];
-
-		// Disabling exec trace gives about a 50% speedup on vm-intensive code
-		//execTrace.push_back(PC);
-
-		int opcode = GET_LONG_PC();
-
-		LOG_L(L_DEBUG, "PC: %x opcode: %x (%s)", PC - 1, opcode, GetOpcodeName(opcode).c_str());
-
-		switch(opcode) {
-			case PUSH_CONSTANT:
-				r1 = GET_LONG_PC();
-				stack.push_back(r1);
-				break;
-			case SLEEP:
-				r1 = POP();
-				wakeTime = GCurrentTime + r1;
-				state = Sleep;
-				GCobEngine.AddThread(this);
-				LOG_L(L_DEBUG, "%s sleeping for %d ms", script.scriptNames[callStack.back().functionId].c_str(), r1);
-				return true;
-			case SPIN:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				r3 = POP();         // speed
-				r4 = POP();         // accel
-				owner->Spin(r1, r2, r3, r4);
-				break;
-			case STOP_SPIN:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				r3 = POP();         // decel
-				//LOG_L(L_DEBUG, "Stop spin of %s around %d", script.pieceNames[r1].c_str(), r2);
-				owner->StopSpin(r1, r2, r3);
-				break;
-			case RETURN:
-				retCode = POP();
-				if (callStack.back().returnAddr == -1) {
-					LOG_L(L_DEBUG, "%s returned %d", script.scriptNames[callStack.back().functionId].c_str(), retCode);
-					state = Dead;
-					//callStack.pop_back();
-					// Leave values intact on stack in case caller wants to check them
-					return false;
-				}
-
-				PC = callStack.back().returnAddr;
-				while (stack.size() > callStack.back().stackTop) {
-					stack.pop_back();
-				}
-				callStack.pop_back();
-				LOG_L(L_DEBUG, "Returning to %s", script.scriptNames[callStack.back().functionId].c_str());
-				break;
-			case SHADE:
-				r1 = GET_LONG_PC();
-				break;
-			case DONT_SHADE:
-				r1 = GET_LONG_PC();
-				break;
-			case CACHE:
-				r1 = GET_LONG_PC();
-				break;
-			case DONT_CACHE:
-				r1 = GET_LONG_PC();
-				break;
-			case CALL: {
-				r1 = GET_LONG_PC();
-				PC--;
-				const string& name = script.scriptNames[r1];
-				if (name.find("lua_") == 0) {
-					script.code[PC - 1] = LUA_CALL;
-					LuaCall();
-					break;
-				}
-				script.code[PC - 1] = REAL_CALL;
-
-				// fall through //
+		COB_TRACE();
+
+		op = &ops[PC];
+		PC += op->length;
+
+		switch (op->instr) {
+#endif
+		COB_OP(PUSH_CONSTANT) {
+			r1 = OPERAND(0);
+			PUSH(r1);
+			COB_NEXT();
+		}
+		COB_OP(SLEEP) {
+			r1 = POP();
+			wakeTime = GCurrentTime + r1;
+			state = Sleep;
+			GCobEngine.AddThread(this);
+			LOG_L(L_DEBUG, "%s sleeping for %d ms", script.scriptNames[CurrentCall().functionId].c_str(), r1);
+			return true;
+		}
+		COB_OP(SPIN) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			r3 = POP();         // speed
+			r4 = POP();         // accel
+			owner->Spin(r1, r2, r3, r4);
+			COB_NEXT();
+		}
+		COB_OP(STOP_SPIN) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			r3 = POP();         // decel
+			//LOG_L(L_DEBUG, "Stop spin of %s around %d", script.pieceNames[r1].c_str(), r2);
+			owner->StopSpin(r1, r2, r3);
+			COB_NEXT();
+		}
+		COB_OP(RETURN) {
+			retCode = POP();
+			if (CurrentCall().returnAddr == -1) {
+				LOG_L(L_DEBUG, "%s returned %d", script.scriptNames[CurrentCall().functionId].c_str(), retCode);
+				state = Dead;
+				// Leave values intact on stack in case caller wants to check them
+				return false;
 			}
-			case REAL_CALL:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-
-				if (script.scriptLengths[r1] == 0) {
-					//LOG_L(L_DEBUG, "Preventing call to zero-len script %s", script.scriptNames[r1].c_str());
-					break;
-				}
-
-				struct callInfo ci;
-				ci.functionId = r1;
-				ci.returnAddr = PC;
-				ci.stackTop = stack.size() - r2;
-				callStack.push_back(ci);
-				paramCount = r2;
-
-				PC = script.scriptOffsets[r1];
-				//LOG_L(L_DEBUG, "Calling %s", script.scriptNames[r1].c_str());
-				break;
-			case LUA_CALL:
-				LuaCall();
-				break;
-			case POP_STATIC:
-				r1 = GET_LONG_PC();
-				r2 = POP();
-				owner->staticVars[r1] = r2;
-				//LOG_L(L_DEBUG, "Pop static var %d val %d", r1, r2);
-				break;
-			case POP_STACK:
-				POP();
-				break;
-			case START: {
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-
-				if (script.scriptLengths[r1] == 0) {
-					//LOG_L(L_DEBUG, "Preventing start of zero-len script %s", script.scriptNames[r1].c_str());
-					break;
-				}
-
-				args.clear();
-				args.reserve(r2);
-				for (r3 = 0; r3 < r2; ++r3) {
-					r4 = POP();
-					args.push_back(r4);
-				}
-
-				CCobThread* thread = new CCobThread(script, owner);
-				thread->Start(r1, args, true);
-
-				// Seems that threads should inherit signal mask from creator
-				thread->signalMask = signalMask;
-				LOG_L(L_DEBUG, "Starting %s %d", script.scriptNames[r1].c_str(), signalMask);
-			} break;
-			case CREATE_LOCAL_VAR:
-				if (paramCount == 0) {
-					stack.push_back(0);
-				} else {
-					paramCount--;
-				}
-				break;
-			case GET_UNIT_VALUE:
-				r1 = POP();
-				if ((r1 >= LUA0) && (r1 <= LUA9)) {
-					stack.push_back(luaArgs[r1 - LUA0]);
-					break;
-				}
-				r1 = owner->GetUnitVal(r1, 0, 0, 0, 0);
-				stack.push_back(r1);
-				break;
-			case JUMP_NOT_EQUAL:
-				r1 = GET_LONG_PC();
-				r2 = POP();
-				if (r2 == 0) {
-					PC = r1;
-				}
-				break;
-			case JUMP:
-				r1 = GET_LONG_PC();
-				// this seem to be an error in the docs..
-				//r2 = script.scriptOffsets[callStack.back().functionId] + r1;
-				PC = r1;
-				break;
-			case POP_LOCAL_VAR:
-				r1 = GET_LONG_PC();
-				r2 = POP();
-				stack[callStack.back().stackTop + r1] = r2;
-				break;
-			case PUSH_LOCAL_VAR:
-				r1 = GET_LONG_PC();
-				r2 = stack[callStack.back().stackTop + r1];
-				stack.push_back(r2);
-				break;
-			case SET_LESS_OR_EQUAL:
-				r2 = POP();
-				r1 = POP();
-				if (r1 <= r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case BITWISE_AND:
-				r1 = POP();
-				r2 = POP();
-				stack.push_back(r1 & r2);
-				break;
-			case BITWISE_OR: // seems to want stack contents or'd, result places on stack
-				r1 = POP();
-				r2 = POP();
-				stack.push_back(r1 | r2);
-				break;
-			case BITWISE_XOR:
-				r1 = POP();
-				r2 = POP();
-				stack.push_back(r1 ^ r2);
-				break;
-			case BITWISE_NOT:
-				r1 = POP();
-				stack.push_back(~r1);
-				break;
-			case EXPLODE:
-				r1 = GET_LONG_PC();
-				r2 = POP();
-				owner->Explode(r1, r2);
-				break;
-			case PLAY_SOUND:
-				r1 = GET_LONG_PC();
-				r2 = POP();
-				owner->PlayUnitSound(r1, r2);
-				break;
-			case PUSH_STATIC:
-				r1 = GET_LONG_PC();
-				stack.push_back(owner->staticVars[r1]);
-				//LOG_L(L_DEBUG, "Push static %d val %d", r1, owner->staticVars[r1]);
-				break;
-			case SET_NOT_EQUAL:
-				r1 = POP();
-				r2 = POP();
-				if (r1 != r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case SET_EQUAL:
-				r1 = POP();
-				r2 = POP();
-				if (r1 == r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case SET_LESS:
-				r2 = POP();
-				r1 = POP();
-				if (r1 < r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case SET_GREATER:
-				r2 = POP();
-				r1 = POP();
-				if (r1 > r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case SET_GREATER_OR_EQUAL:
-				r2 = POP();
-				r1 = POP();
-				if (r1 >= r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case RAND:
-				r2 = POP();
-				r1 = POP();
-				r3 = gs->randInt() % (r2 - r1 + 1) + r1;
-				stack.push_back(r3);
-				break;
-			case EMIT_SFX:
-				r1 = POP();
-				r2 = GET_LONG_PC();
-				owner->EmitSfx(r1, r2);
-				break;
-			case MUL:
-				r1 = POP();
-				r2 = POP();
-				stack.push_back(r1 * r2);
-				break;
-			case SIGNAL:
-				r1 = POP();
-				owner->Signal(r1);
-				break;
-			case SET_SIGNAL_MASK:
-				r1 = POP();
-				signalMask = r1;
-				break;
-			case TURN:
-				r2 = POP();
-				r1 = POP();
-				r3 = GET_LONG_PC();
-				r4 = GET_LONG_PC();
-				//LOG_L(L_DEBUG, "Turning piece %s axis %d to %d speed %d", script.pieceNames[r3].c_str(), r4, r2, r1);
-				owner->Turn(r3, r4, r1, r2);
-				break;
-			case GET:
-				r5 = POP();
-				r4 = POP();
-				r3 = POP();
-				r2 = POP();
-				r1 = POP();
-				if ((r1 >= LUA0) && (r1 <= LUA9)) {
-					stack.push_back(luaArgs[r1 - LUA0]);
-					break;
-				}
-				r6 = owner->GetUnitVal(r1, r2, r3, r4, r5);
-				stack.push_back(r6);
-				break;
-			case ADD:
-				r2 = POP();
-				r1 = POP();
-				stack.push_back(r1 + r2);
-				break;
-			case SUB:
-				r2 = POP();
-				r1 = POP();
-				r3 = r1 - r2;
-				stack.push_back(r3);
-				break;
-			case DIV:
-				r2 = POP();
-				r1 = POP();
-				if (r2 != 0)
-					r3 = r1 / r2;
-				else {
-					r3 = 1000; // infinity!
-					LOG_L(L_ERROR, "division by zero");
-				}
-				stack.push_back(r3);
-				break;
-			case MOD:
-				r2 = POP();
-				r1 = POP();
-				if (r2 != 0)
-					stack.push_back(r1 % r2);
-				else {
-					stack.push_back(0);
-					LOG_L(L_ERROR, "modulo division by zero");
-				}
-				break;
-			case MOVE:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				r4 = POP();
-				r3 = POP();
-				owner->Move(r1, r2, r3, r4);
-				break;
-			case MOVE_NOW:{
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				r3 = POP();
-				owner->MoveNow(r1, r2, r3);
-				break;}
-			case TURN_NOW:{
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				r3 = POP();
-				owner->TurnNow(r1, r2, r3);
-				break;}
-			case WAIT_TURN:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				//LOG_L(L_DEBUG, "Waiting for turn on piece %s around axis %d", script.pieceNames[r1].c_str(), r2);
-				if (owner->AddAnimListener(CCobInstance::ATurn, r1, r2, this)) {
-					state = WaitTurn;
-					return true;
-				}
-				else
-					break;
-			case WAIT_MOVE:
-				r1 = GET_LONG_PC();
-				r2 = GET_LONG_PC();
-				//LOG_L(L_DEBUG, "Waiting for move on piece %s on axis %d", script.pieceNames[r1].c_str(), r2);
-				if (owner->AddAnimListener(CCobInstance::AMove, r1, r2, this)) {
-					state = WaitMove;
-					return true;
-				}
-				break;
-			case SET:
-				r2 = POP();
-				r1 = POP();
-				//LOG_L(L_DEBUG, "Setting unit value %d to %d", r1, r2);
-				if ((r1 >= LUA0) && (r1 <= LUA9)) {
-					luaArgs[r1 - LUA0] = r2;
-					break;
-				}
-				owner->SetUnitVal(r1, r2);
-				break;
-			case ATTACH:
-				r3 = POP();
-				r2 = POP();
-				r1 = POP();
-				owner->AttachUnit(r2, r1);
-				break;
-			case DROP:
-				r1 = POP();
-				owner->DropUnit(r1);
-				break;
-			case LOGICAL_NOT: // Like bitwise, but only on values 1 and 0.
-				r1 = POP();
-				if (r1 == 0)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case LOGICAL_AND:
-				r1 = POP();
-				r2 = POP();
-				if (r1 && r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case LOGICAL_OR:
-				r1 = POP();
-				r2 = POP();
-				if (r1 || r2)
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case LOGICAL_XOR:
-				r1 = POP();
-				r2 = POP();
-				if ( (!!r1) ^ (!!r2))
-					stack.push_back(1);
-				else
-					stack.push_back(0);
-				break;
-			case HIDE:
-				r1 = GET_LONG_PC();
-				owner->SetVisibility(r1, false);
-				//LOG_L(L_DEBUG, "Hiding %d", r1);
-				break;
-			case SHOW:{
-				r1 = GET_LONG_PC();
-				int i;
-				for (i = 0; i < MAX_WEAPONS_PER_UNIT; ++i)
-					if (callStack.back().functionId == script.scriptIndex[COBFN_FirePrimary + COBFN_Weapon_Funcs * i])
-						break;
-
-				// If true, we are in a Fire-script and should show a special flare effect
-				if (i < MAX_WEAPONS_PER_UNIT) {
-					owner->ShowFlare(r1);
-				}
-				else {
-					owner->SetVisibility(r1, true);
-				}
-				//LOG_L(L_DEBUG, "Showing %d", r1);
-				break;}
-			default:
-				LOG_L(L_ERROR, "Unknown opcode %x (in %s:%s at %x)",
-						opcode, script.name.c_str(),
-						script.scriptNames[callStack.back().functionId].c_str(),
-						PC - 1);
-				LOG_L(L_ERROR, "Exec trace:");
-				ei = execTrace.begin();
-				while (ei != execTrace.end()) {
-					LOG_L(L_ERROR, "PC: %3x  opcode: %s", *ei, GetOpcodeName(script.code[*ei]).c_str());
-					++ei;
-				}
+
+			PC = CurrentCall().returnAddr;
+			if (stackSize > CurrentCall().stackTop) {
+				stackSize = CurrentCall().stackTop;
+			}
+			callStackSize--;
+			LOG_L(L_DEBUG, "Returning to %s", script.scriptNames[CurrentCall().functionId].c_str());
+			COB_NEXT();
+		}
+		COB_OP(SHADE)
+		COB_OP(DONT_SHADE)
+		COB_OP(CACHE)
+		COB_OP(DONT_CACHE) {
+			COB_NEXT();
+		}
+		COB_OP(CALL) {
+			// only left unresolved by CCobFile if the function does not exist
+			ShowError("call to unknown function");
+			state = Dead;
+			return false;
+		}
+		COB_OP(REAL_CALL) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+
+			if (script.scriptLengths[r1] == 0) {
+				//LOG_L(L_DEBUG, "Preventing call to zero-len script %s", script.scriptNames[r1].c_str());
+				COB_NEXT();
+			}
+			if (callStackSize >= MAX_CALL_STACK_SIZE) {
+				ShowError("call stack overflow");
 				state = Dead;
 				return false;
+			}
+
+			callInfo& ci = callStack[callStackSize++];
+			ci.functionId = r1;
+			ci.returnAddr = PC;
+			ci.stackTop = stackSize - r2;
+			paramCount = r2;
+
+			PC = script.scriptOffsets[r1];
+			//LOG_L(L_DEBUG, "Calling %s", script.scriptNames[r1].c_str());
+			COB_NEXT();
+		}
+		COB_OP(LUA_CALL) {
+			LuaCall(OPERAND(0), OPERAND(1));
+			COB_NEXT();
+		}
+		COB_OP(POP_STATIC) {
+			r1 = OPERAND(0);
+			r2 = POP();
+			owner->staticVars[r1] = r2;
+			//LOG_L(L_DEBUG, "Pop static var %d val %d", r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(POP_STACK) {
+			POP();
+			COB_NEXT();
+		}
+		COB_OP(START) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+
+			if (script.scriptLengths[r1] == 0) {
+				//LOG_L(L_DEBUG, "Preventing start of zero-len script %s", script.scriptNames[r1].c_str());
+				COB_NEXT();
+			}
+
+			args.clear();
+			args.reserve(r2);
+			for (r3 = 0; r3 < r2; ++r3) {
+				r4 = POP();
+				args.push_back(r4);
+			}
+
+			CCobThread* thread = new CCobThread(script, owner);
+			thread->Start(r1, args, true);
+
+			// Seems that threads should inherit signal mask from creator
+			thread->signalMask = signalMask;
+			LOG_L(L_DEBUG, "Starting %s %d", script.scriptNames[r1].c_str(), signalMask);
+			COB_NEXT();
+		}
+		COB_OP(CREATE_LOCAL_VAR) {
+			if (paramCount == 0) {
+				PUSH(0);
+			} else {
+				paramCount--;
+			}
+			COB_NEXT();
+		}
+		COB_OP(GET_UNIT_VALUE) {
+			r1 = POP();
+			if ((r1 >= LUA0) && (r1 <= LUA9)) {
+				PUSH(luaArgs[r1 - LUA0]);
+				COB_NEXT();
+			}
+			r1 = owner->GetUnitVal(r1, 0, 0, 0, 0);
+			PUSH(r1);
+			COB_NEXT();
+		}
+		COB_OP(JUMP_NOT_EQUAL) {
+			r1 = OPERAND(0);
+			r2 = POP();
+			if (r2 == 0) {
+				PC = r1;
+			}
+			COB_NEXT();
+		}
+		COB_OP(JUMP) {
+			r1 = OPERAND(0);
+			// this seem to be an error in the docs..
+			//r2 = script.scriptOffsets[CurrentCall().functionId] + r1;
+			PC = r1;
+			COB_NEXT();
+		}
+		COB_OP(POP_LOCAL_VAR) {
+			r1 = OPERAND(0);
+			r2 = POP();
+			LOCAL_VAR(r1, idx);
+			stack[idx] = r2;
+			COB_NEXT();
+		}
+		COB_OP(PUSH_LOCAL_VAR) {
+			r1 = OPERAND(0);
+			LOCAL_VAR(r1, idx);
+			r2 = stack[idx];
+			PUSH(r2);
+			COB_NEXT();
+		}
+		COB_OP(SET_LESS_OR_EQUAL) {
+			r2 = POP();
+			r1 = POP();
+			PUSH((r1 <= r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(BITWISE_AND) {
+			r1 = POP();
+			r2 = POP();
+			PUSH(r1 & r2);
+			COB_NEXT();
+		}
+		COB_OP(BITWISE_OR) { // seems to want stack contents or'd, result places on stack
+			r1 = POP();
+			r2 = POP();
+			PUSH(r1 | r2);
+			COB_NEXT();
+		}
+		COB_OP(BITWISE_XOR) {
+			r1 = POP();
+			r2 = POP();
+			PUSH(r1 ^ r2);
+			COB_NEXT();
+		}
+		COB_OP(BITWISE_NOT) {
+			r1 = POP();
+			PUSH(~r1);
+			COB_NEXT();
+		}
+		COB_OP(EXPLODE) {
+			r1 = OPERAND(0);
+			r2 = POP();
+			owner->Explode(r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(PLAY_SOUND) {
+			r1 = OPERAND(0);
+			r2 = POP();
+			owner->PlayUnitSound(r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(PUSH_STATIC) {
+			r1 = OPERAND(0);
+			PUSH(owner->staticVars[r1]);
+			//LOG_L(L_DEBUG, "Push static %d val %d", r1, owner->staticVars[r1]);
+			COB_NEXT();
+		}
+		COB_OP(SET_NOT_EQUAL) {
+			r1 = POP();
+			r2 = POP();
+			PUSH((r1 != r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(SET_EQUAL) {
+			r1 = POP();
+			r2 = POP();
+			PUSH((r1 == r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(SET_LESS) {
+			r2 = POP();
+			r1 = POP();
+			PUSH((r1 < r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(SET_GREATER) {
+			r2 = POP();
+			r1 = POP();
+			PUSH((r1 > r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(SET_GREATER_OR_EQUAL) {
+			r2 = POP();
+			r1 = POP();
+			PUSH((r1 >= r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(RAND) {
+			r2 = POP();
+			r1 = POP();
+			r3 = gs->randInt() % (r2 - r1 + 1) + r1;
+			PUSH(r3);
+			COB_NEXT();
+		}
+		COB_OP(EMIT_SFX) {
+			r1 = POP();
+			r2 = OPERAND(0);
+			owner->EmitSfx(r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(MUL) {
+			r1 = POP();
+			r2 = POP();
+			PUSH(r1 * r2);
+			COB_NEXT();
+		}
+		COB_OP(SIGNAL) {
+			r1 = POP();
+			owner->Signal(r1);
+			COB_NEXT();
+		}
+		COB_OP(SET_SIGNAL_MASK) {
+			r1 = POP();
+			signalMask = r1;
+			COB_NEXT();
+		}
+		COB_OP(TURN) {
+			r2 = POP();
+			r1 = POP();
+			r3 = OPERAND(0);
+			r4 = OPERAND(1);
+			//LOG_L(L_DEBUG, "Turning piece %s axis %d to %d speed %d", script.pieceNames[r3].c_str(), r4, r2, r1);
+			owner->Turn(r3, r4, r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(GET) {
+			r5 = POP();
+			r4 = POP();
+			r3 = POP();
+			r2 = POP();
+			r1 = POP();
+			if ((r1 >= LUA0) && (r1 <= LUA9)) {
+				PUSH(luaArgs[r1 - LUA0]);
+				COB_NEXT();
+			}
+			r6 = owner->GetUnitVal(r1, r2, r3, r4, r5);
+			PUSH(r6);
+			COB_NEXT();
+		}
+		COB_OP(ADD) {
+			r2 = POP();
+			r1 = POP();
+			PUSH(r1 + r2);
+			COB_NEXT();
+		}
+		COB_OP(SUB) {
+			r2 = POP();
+			r1 = POP();
+			r3 = r1 - r2;
+			PUSH(r3);
+			COB_NEXT();
+		}
+		COB_OP(DIV) {
+			r2 = POP();
+			r1 = POP();
+			if (r2 != 0)
+				r3 = r1 / r2;
+			else {
+				r3 = 1000; // infinity!
+				LOG_L(L_ERROR, "division by zero");
+			}
+			PUSH(r3);
+			COB_NEXT();
+		}
+		COB_OP(MOD) {
+			r2 = POP();
+			r1 = POP();
+			if (r2 != 0)
+				PUSH(r1 % r2);
+			else {
+				PUSH(0);
+				LOG_L(L_ERROR, "modulo division by zero");
+			}
+			COB_NEXT();
+		}
+		COB_OP(MOVE) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			r4 = POP();
+			r3 = POP();
+			owner->Move(r1, r2, r3, r4);
+			COB_NEXT();
+		}
+		COB_OP(MOVE_NOW) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			r3 = POP();
+			owner->MoveNow(r1, r2, r3);
+			COB_NEXT();
+		}
+		COB_OP(TURN_NOW) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			r3 = POP();
+			owner->TurnNow(r1, r2, r3);
+			COB_NEXT();
+		}
+		COB_OP(WAIT_TURN) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			//LOG_L(L_DEBUG, "Waiting for turn on piece %s around axis %d", script.pieceNames[r1].c_str(), r2);
+			if (owner->AddAnimListener(CCobInstance::ATurn, r1, r2, this)) {
+				state = WaitTurn;
+				return true;
+			}
+			COB_NEXT();
+		}
+		COB_OP(WAIT_MOVE) {
+			r1 = OPERAND(0);
+			r2 = OPERAND(1);
+			//LOG_L(L_DEBUG, "Waiting for move on piece %s on axis %d", script.pieceNames[r1].c_str(), r2);
+			if (owner->AddAnimListener(CCobInstance::AMove, r1, r2, this)) {
+				state = WaitMove;
+				return true;
+			}
+			COB_NEXT();
+		}
+		COB_OP(SET) {
+			r2 = POP();
+			r1 = POP();
+			//LOG_L(L_DEBUG, "Setting unit value %d to %d", r1, r2);
+			if ((r1 >= LUA0) && (r1 <= LUA9)) {
+				luaArgs[r1 - LUA0] = r2;
+				COB_NEXT();
+			}
+			owner->SetUnitVal(r1, r2);
+			COB_NEXT();
+		}
+		COB_OP(ATTACH) {
+			r3 = POP();
+			r2 = POP();
+			r1 = POP();
+			owner->AttachUnit(r2, r1);
+			COB_NEXT();
+		}
+		COB_OP(DROP) {
+			r1 = POP();
+			owner->DropUnit(r1);
+			COB_NEXT();
+		}
+		COB_OP(LOGICAL_NOT) { // Like bitwise, but only on values 1 and 0.
+			r1 = POP();
+			PUSH((r1 == 0)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(LOGICAL_AND) {
+			r1 = POP();
+			r2 = POP();
+			PUSH((r1 && r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(LOGICAL_OR) {
+			r1 = POP();
+			r2 = POP();
+			PUSH((r1 || r2)? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(LOGICAL_XOR) {
+			r1 = POP();
+			r2 = POP();
+			PUSH(((!!r1) ^ (!!r2))? 1: 0);
+			COB_NEXT();
+		}
+		COB_OP(HIDE) {
+			r1 = OPERAND(0);
+			owner->SetVisibility(r1, false);
+			//LOG_L(L_DEBUG, "Hiding %d", r1);
+			COB_NEXT();
+		}
+		COB_OP(SHOW) {
+			r1 = OPERAND(0);
+
+			// If true, we are in a Fire-script and should show a special flare effect
+			if (script.fireScripts[CurrentCall().functionId]) {
+				owner->ShowFlare(r1);
+			} else {
+				owner->SetVisibility(r1, true);
+			}
+			//LOG_L(L_DEBUG, "Showing %d", r1);
+			COB_NEXT();
+		}
+		COB_OP(UNKNOWN) {
+			LOG_L(L_ERROR, "Unknown opcode %x (in %s:%s at %x)",
+					script.code[PC - 1], script.name.c_str(),
+					script.scriptNames[CurrentCall().functionId].c_str(),
+					PC - 1);
+			state = Dead;
+			return false;
+		}
+		COB_OP(BAD_JUMP) {
+			ShowError("jump out of range");
+			state = Dead;
+			return false;
+		}
+#ifndef COB_DIRECT_THREADED
 		}
 	}
+#endif
 
+#ifdef COB_DIRECT_THREADED
+done:
+#endif
 	return (state != Dead); // can arrive here as dead, through CCobInstance::Signal()
+
+stack_overflow:
+	ShowError("stack overflow");
+	state = Dead;
+	return false;
+
+bad_local_var:
+	ShowError("local variable out of range");
+	state = Dead;
+	return false;
 }
 
 void CCobThread::ShowError(const string& msg)
@@ -699,12 +683,12 @@ void CCobThread::ShowError(const string& msg)
 	static int spamPrevention = 100;
 	if (spamPrevention < 0) return;
 	--spamPrevention;
-	if (callStack.empty()) {
+	if (callStackSize == 0) {
 		LOG_L(L_ERROR, "%s outside script execution (?)", msg.c_str());
 	} else {
 		LOG_L(L_ERROR, "%s (in %s:%s at %x)", msg.c_str(),
 				script.name.c_str(),
-				script.scriptNames[callStack.back().functionId].c_str(),
+				script.scriptNames[CurrentCall().functionId].c_str(),
 				PC - 1);
 	}
 }
@@ -792,25 +776,22 @@ void CCobThread::DependentDied(CObject* o)
 
 /******************************************************************************/
 
-void CCobThread::LuaCall()
+void CCobThread::LuaCall(int scriptId, int numArgs)
 {
-	const int r1 = GET_LONG_PC(); // script id
-	const int r2 = GET_LONG_PC(); // arg count
-
 	// setup the parameter array
-	const int size = (int) stack.size();
-	const int argCount = std::min(r2, MAX_LUA_COB_ARGS);
-	const int start = std::max(0, size - r2);
+	const int size = (int) stackSize;
+	const int argCount = std::min(numArgs, MAX_LUA_COB_ARGS);
+	const int start = std::max(0, size - numArgs);
 	const int end = std::min(size, start + argCount);
 	int a = 0;
 	for (int i = start; i < end; i++) {
 		luaArgs[a] = stack[i];
 		a++;
 	}
-	if (r2 >= size) {
-		stack.clear();
+	if (numArgs >= size) {
+		stackSize = 0;
 	} else {
-		stack.resize(size - r2);
+		stackSize = size - numArgs;
 	}
 
 	if (!luaRules) {
@@ -819,11 +800,11 @@ void CCobThread::LuaCall()
 	}
 
 	// check script index validity
-	if ((r1 < 0) || (static_cast<size_t>(r1) >= script.luaScripts.size())) {
+	if ((scriptId < 0) || (static_cast<size_t>(scriptId) >= script.luaScripts.size())) {
 		luaArgs[0] = 0; // failure
 		return;
 	}
-	const LuaHashString& hs = script.luaScripts[r1];
+	const LuaHashString& hs = script.luaScripts[scriptId];
 
 	LOG_L(L_DEBUG, "Cob2Lua %s", hs.GetString().c_str());
 
@@ -21,6 +21,10 @@ public:
 	/// Inform the vultures that we finally croaked
 	~CCobThread();
 
+	/// threads are allocated from a pool of the CCobEngine
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size);
+
 	/**
 	 * Returns false if this thread is dead and needs to be killed.
 	 */
@@ -57,32 +61,41 @@ public:
 
 protected:
 	std::string GetOpcodeName(int opcode);
-	void LuaCall();
+	void LuaCall(int scriptId, int numArgs);
 	// implementation of IAnimListener
 	void AnimFinished(CUnitScript::AnimType type, int piece, int axis);
 
 	inline int POP();
 
+	struct callInfo {
+		int functionId;
+		int returnAddr;
+		size_t stackTop;
+	};
+
+	const callInfo& CurrentCall() const { return callStack[callStackSize - 1]; }
+
 
 	CCobFile& script;
 	CCobInstance* owner;
 
 	int wakeTime;
 	int PC;
-	vector<int> stack;
-	vector<int> execTrace;
+
+	/// fixed capacities; a script exceeding either is killed with an error
+	static const unsigned int MAX_STACK_SIZE = 256;
+	static const unsigned int MAX_CALL_STACK_SIZE = 32;
+
+	int stack[MAX_STACK_SIZE];
+	unsigned int stackSize;
 
 	int paramCount;
 	int retCode;
 
 	int luaArgs[MAX_LUA_COB_ARGS];
 
-	struct callInfo {
-		int functionId;
-		int returnAddr;
-		size_t stackTop;
-	};
-	vector<struct callInfo> callStack;
+	callInfo callStack[MAX_CALL_STACK_SIZE];
+	unsigned int callStackSize;
 
 	CBCobThreadFinish callback;
 	void* cbParam1;
@@ -73,6 +73,7 @@ CUnitScript::CUnitScript(CUnit* unit, const std::vector<LocalModelPiece*>& piece
 	, busy(false)
 	, hasSetSFXOccupy(false)
 	, hasRockUnit(false)
+	, animatingIndex(-1)
 	, hasStartBuilding(false)
 	, pieces(pieces)
 {
@@ -82,425 +83,15 @@ CUnitScript::CUnitScript(CUnit* unit, const std::vector<LocalModelPiece*>& piece
 
 CUnitScript::~CUnitScript()
 {
-	bool haveAnimations = false;
-
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo*>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
-			// anim listeners are not owned by the anim in general, so don't delete them here
-			delete *i;
-		}
-
-		haveAnimations = (haveAnimations || !anims[animType].empty());
-	}
-
+	// anim listeners are not owned by the anims in general, so don't delete them here
 	// Remove us from possible animation ticking
-	if (haveAnimations)
-		GUnitScriptEngine.RemoveInstance(this);
+	GUnitScriptEngine.RemoveInstance(this);
 }
 
 
 /******************************************************************************/
 
 
-/**
- * @brief Unblocks all threads waiting on an animation
- * @param anim AnimInfo the corresponding animation
- */
-void CUnitScript::UnblockAll(AnimInfo* anim)
-{
-	std::list<IAnimListener *>::iterator li;
-
-	for (li = anim->listeners.begin(); li != anim->listeners.end(); ++li) {
-		(*li)->AnimFinished(anim->type, anim->piece, anim->axis);
-	}
-}
-
-
-/**
- * @brief Updates move animations
- * @param cur float value to update
- * @param dest float final value
- * @param speed float max increment per tick
- * @return returns true if destination was reached, false otherwise
- */
-bool CUnitScript::MoveToward(float& cur, float dest, float speed)
-{
-	const float delta = dest - cur;
-
-	if (math::fabsf(delta) <= speed) {
-		cur = dest;
-		return true;
-	}
-
-	if (delta > 0.0f) {
-		cur += speed;
-	} else {
-		cur -= speed;
-	}
-
-	return false;
-}
-
-
-/**
- * @brief Updates turn animations
- * @param cur float value to update
- * @param dest float final value
- * @param speed float max increment per tick
- * @return returns true if destination was reached, false otherwise
- */
-bool CUnitScript::TurnToward(float& cur, float dest, float speed)
-{
-	float delta = dest - cur;
-
-	// clamp: -pi .. 0 .. +pi (remainder(x,TWOPI) would do the same but is slower due to streflop)
-	if (delta > PI) {
-		delta -= TWOPI;
-	} else if (delta<=-PI) {
-		delta += TWOPI;
-	}
-
-	if (math::fabsf(delta) <= speed) {
-		cur = dest;
-		return true;
-	}
-
-	if (delta > 0.0f) {
-		cur += speed;
-	} else {
-		cur -= speed;
-	}
-
-	ClampRad(&cur);
-
-	return false;
-}
-
-
-/**
- * @brief Updates spin animations
- * @param cur float value to update
- * @param dest float the final desired speed (NOT the final angle!)
- * @param speed float is updated if it is not equal to dest
- * @param divisor int is the deltatime, it is not added before the call because speed may have to be updated
- * @return true if the desired speed is 0 and it is reached, false otherwise
- */
-bool CUnitScript::DoSpin(float& cur, float dest, float &speed, float accel, int divisor)
-{
-	const float delta = dest - speed;
-
-	// Check if we are not at the final speed and
-	// make sure we dont go past desired speed
-	if (math::fabsf(delta) <= accel) {
-		speed = dest;
-		if (speed == 0.0f)
-			return true;
-	}
-	else {
-		if (delta > 0.0f) {
-			// accelerations are defined in speed/frame (at GAME_SPEED fps)
-			speed += accel * (float(GAME_SPEED) / divisor);
-		} else {
-			speed -= accel * (float(GAME_SPEED) / divisor);
-		}
-	}
-
-	cur += (speed / divisor);
-	ClampRad(&cur);
-
-	return false;
-}
-
-
-
-void CUnitScript::TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims) {
-	switch (type) {
-		case AMove: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-
-				// NOTE: we should not need to copy-and-set here, because
-				// MoveToward/TurnToward/DoSpin modify pos/rot by reference
-				float3 pos = pieces[ai->piece]->GetPosition();
-
-				if (MoveToward(pos[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
-				}
-
-				pieces[ai->piece]->SetPosition(pos);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
-
-		case ATurn: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-				float3 rot = pieces[ai->piece]->GetRotation();
-
-				if (TurnToward(rot[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
-				}
-
-				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
-
-		case ASpin: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
-				float3 rot = pieces[ai->piece]->GetRotation();
-
-				if (DoSpin(rot[ai->axis], ai->dest, ai->speed, ai->accel, 1000 / deltaTime)) {
-					ai->done = true; doneAnims.push_back(it);
-				}
-
-				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
-			}
-		} break;
-
-		default: {
-		} break;
-	}
-}
-
-/**
- * @brief Called by the engine when we are registered as animating.
-          If we return false there are no active animations left.
- * @param deltaTime int delta time to update
- * @return true if there are still active animations
- */
-bool CUnitScript::Tick(int deltaTime)
-{
-	typedef std::list<AnimInfo*>::iterator AnimInfoIt;
-
-	// list of _iterators_ to finished animations,
-	// so we can get rid of them in constant time
-	std::list<AnimInfoIt> doneAnims;
-
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		TickAnims(deltaTime, AnimType(animType), doneAnims);
-	}
-
-	//! Tell listeners to unblock, and remove finished animations from the unit/script.
-	//! NOTE:
-	//!     removing a finished animation _must_ happen before notifying its listeners,
-	//!     otherwise the callback function (AnimFinished()) can call AddAnimListener()
-	//!     and append it to the listeners-list again (causing an endless loop)!
-	//! NOTE: UnblockAll might result in new anims being added
-	for (std::list<AnimInfoIt>::const_iterator it = doneAnims.begin(); it != doneAnims.end(); ++it) {
-		AnimInfoIt animInfoIt = *it;
-		AnimInfo* animInfo = *animInfoIt;
-
-		anims[animInfo->type].erase(animInfoIt);
-		UnblockAll(animInfo);
-		delete animInfo;
-	}
-
-	return (HaveAnimations());
-}
-
-
-
-std::list<CUnitScript::AnimInfo*>::iterator CUnitScript::FindAnim(AnimType type, int piece, int axis)
-{
-	for (std::list<AnimInfo*>::iterator i = anims[type].begin(); i != anims[type].end(); ++i) {
-		if (((*i)->piece == piece) && ((*i)->axis == axis))
-			return i;
-	}
-
-	return anims[type].end();
-}
-
-void CUnitScript::RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt)
-{
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
-		anims[type].erase(animInfoIt);
-
-		// If this was the last animation, remove from currently animating list
-		// FIXME: this could be done in a cleaner way
-		if (!HaveAnimations()) {
-			GUnitScriptEngine.RemoveInstance(this);
-		}
-
-		//! We need to unblock threads waiting on this animation, otherwise they will be lost in the void
-		//! NOTE: UnblockAll might result in new anims being added
-		UnblockAll(ai);
-
-		delete ai;
-	}
-}
-
-
-//Overwrites old information. This means that threads blocking on turn completion
-//will now wait for this new turn instead. Not sure if this is the expected behaviour
-//Other option would be to kill them. Or perhaps unblock them.
-void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel)
-{
-	if (!PieceExists(piece)) {
-		ShowScriptError("Invalid piecenumber");
-		return;
-	}
-
-	float destf = 0.0f;
-
-	if (type == AMove) {
-		destf = pieces[piece]->original->offset[axis] + dest;
-	} else {
-		destf = dest;
-		if (type == ATurn) {
-			ClampRad(&destf);
-		}
-	}
-
-	std::list<AnimInfo*>::iterator animInfoIt;
-	AnimInfo* ai = NULL;
-	AnimType overrideType = ANone;
-
-	// first find an animation of a type we override
-	// Turns override spins.. Not sure about the other way around? If so
-	// the system should probably be redesigned to only have two types of
-	// anims (turns and moves), with spin as a bool
-	switch (type) {
-		case ATurn: {
-			overrideType = ASpin;
-			animInfoIt = FindAnim(overrideType, piece, axis);
-		} break;
-		case ASpin: {
-			overrideType = ATurn;
-			animInfoIt = FindAnim(overrideType, piece, axis);
-		} break;
-		case AMove: {
-			// ensure we never remove an animation of this type
-			overrideType = AMove;
-			animInfoIt = anims[overrideType].end();
-		} break;
-		default: {
-		} break;
-	}
-
-	if (animInfoIt != anims[overrideType].end())
-		RemoveAnim(overrideType, animInfoIt);
-
-	// now find an animation of our own type
-	animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt == anims[type].end()) {
-		// If we were not animating before, inform the engine of this so it can schedule us
-		// FIXME: this could be done in a cleaner way
-		if (!HaveAnimations()) {
-			GUnitScriptEngine.AddInstance(this);
-		}
-
-		ai = new AnimInfo();
-		ai->type = type;
-		ai->piece = piece;
-		ai->axis = axis;
-		anims[type].push_back(ai);
-	} else {
-		ai = *animInfoIt;
-	}
-
-	ai->dest  = destf;
-	ai->speed = speed;
-	ai->accel = accel;
-	ai->done = false;
-}
-
-
-void CUnitScript::Spin(int piece, int axis, float speed, float accel)
-{
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
-
-	//If we are already spinning, we may have to decelerate to the new speed
-	if (animInfoIt != anims[ASpin].end()) {
-		AnimInfo* ai = *animInfoIt;
-		ai->dest = speed;
-
-		if (accel > 0) {
-			ai->accel = accel;
-		} else {
-			//Go there instantly. Or have a defaul accel?
-			ai->speed = speed;
-			ai->accel = 0;
-		}
-	} else {
-		//No accel means we start at desired speed instantly
-		if (accel <= 0)
-			AddAnim(ASpin, piece, axis, speed, speed, 0);
-		else
-			AddAnim(ASpin, piece, axis, 0, speed, accel);
-	}
-}
-
-
-void CUnitScript::StopSpin(int piece, int axis, float decel)
-{
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
-
-	if (decel <= 0) {
-		RemoveAnim(ASpin, animInfoIt);
-	} else {
-		if (animInfoIt == anims[ASpin].end())
-			return;
-
-		AnimInfo* ai = *animInfoIt;
-		ai->dest = 0;
-		ai->accel = decel;
-	}
-}
-
-
-void CUnitScript::Turn(int piece, int axis, float speed, float destination)
-{
-	AddAnim(ATurn, piece, axis, std::max(speed, -speed), destination, 0);
-}
-
-
-void CUnitScript::Move(int piece, int axis, float speed, float destination)
-{
-	AddAnim(AMove, piece, axis, std::max(speed, -speed), destination, 0);
-}
-
-
-void CUnitScript::MoveNow(int piece, int axis, float destination)
-{
-	if (!PieceExists(piece)) {
-		ShowScriptError("Invalid piecenumber");
-		return;
-	}
-
-	LocalModel* m = unit->localModel;
-	LocalModelPiece* p = pieces[piece];
-
-	float3 pos = p->GetPosition();
-	pos[axis] = pieces[piece]->original->offset[axis] + destination;
-
-	p->SetPosition(pos);
-	m->PieceUpdated(piece);
-}
-
-
-void CUnitScript::TurnNow(int piece, int axis, float destination)
-{
-	if (!PieceExists(piece)) {
-		ShowScriptError("Invalid piecenumber");
-		return;
-	}
-
-	LocalModel* m = unit->localModel;
-	LocalModelPiece* p = pieces[piece];
-
-	float3 rot = p->GetRotation();
-	rot[axis] = destination;
-
-	p->SetRotation(rot);
-	m->PieceUpdated(piece);
-}
-
-
 void CUnitScript::SetVisibility(int piece, bool visible)
 {
 	if (!PieceExists(piece)) {
@@ -718,35 +309,6 @@ void CUnitScript::DropUnit(int u)
 }
 
 
-//Returns true if there was an animation to listen to
-bool CUnitScript::AddAnimListener(AnimType type, int piece, int axis, IAnimListener *listener)
-{
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
-
-		if (!ai->done) {
-			ai->listeners.push_back(listener);
-			return true;
-		}
-
-		// if the animation is already finished, listening for
-		// it just adds some overhead since either the current
-		// or the next Tick will remove it and call UnblockAll
-		// (which calls AnimFinished for each listener)
-		//
-		// we could notify the listener here, but a cleaner way
-		// is to treat the animation as if it did not exist and
-		// simply disregard the WaitFor* (no side-effects)
-		//
-		// listener->AnimFinished(ai->type, ai->piece, ai->axis);
-	}
-
-	return false;
-}
-
-
 //Flags as defined by the cob standard
 void CUnitScript::Explode(int piece, int flags)
 {
@@ -19,6 +19,8 @@ class CPlasmaRepulser;
 
 class CUnitScript : public CObject
 {
+	friend class CUnitScriptEngine;
+
 public:
 	enum AnimType {ANone = -1, ATurn = 0, ASpin = 1, AMove = 2};
 
@@ -74,7 +76,15 @@ protected:
 		std::list<IAnimListener*> listeners;
 	};
 
-	std::list<AnimInfo*> anims[AMove + 1];
+	typedef std::vector<AnimInfo> AnimContainer;
+
+	/// running animations by type, stored contiguously and in the order they were started
+	AnimContainer anims[AMove + 1];
+	/// finished animations while FinishAnims unblocks them, kept to reuse its capacity
+	AnimContainer doneAnims;
+
+	/// position in CUnitScriptEngine::animating, -1 if not registered there
+	int animatingIndex;
 
 	bool hasSetSFXOccupy;
 	bool hasRockUnit;
@@ -86,8 +96,8 @@ protected:
 	bool TurnToward(float& cur, float dest, float speed);
 	bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
 
-	std::list<AnimInfo*>::iterator FindAnim(AnimType anim, int piece, int axis);
-	void RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt);
+	AnimContainer::iterator FindAnim(AnimType anim, int piece, int axis);
+	void RemoveAnim(AnimType type, const AnimContainer::iterator& animInfoIt);
 	void AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel);
 
 	virtual void ShowScriptError(const std::string& msg) = 0;
@@ -138,8 +148,17 @@ public:
 	      CUnit* GetUnit()       { return unit; }
 	const CUnit* GetUnit() const { return unit; }
 
-	bool Tick(int deltaTime);
-	void TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims);
+	/**
+	 * Advances all animations, only touching the pieces of our own unit (so
+	 * the scripts of different units can be ticked concurrently).
+	 * @return true if an animation finished, see FinishAnims
+	 */
+	bool TickAnims(int deltaTime);
+	/**
+	 * Removes the animations that finished in TickAnims and unblocks their
+	 * listeners; must be called from the sim thread.
+	 */
+	void FinishAnims();
 
 	// animation, used by CCobThread
 	void Spin(int piece, int axis, float speed, float accel);
@@ -226,8 +245,8 @@ public:
 
 inline bool CUnitScript::HaveListeners() const {
 	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo *>::const_iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
-			if (!(*i)->listeners.empty()) {
+		for (AnimContainer::const_iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+			if (!i->listeners.empty()) {
 				return true;
 			}
 		}
@@ -0,0 +1,441 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+/* the animation part of CUnitScript, kept apart so it can be tested on its own */
+#include "UnitScript.h"
+#include "UnitScriptEngine.h"
+
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Units/Unit.h"
+#include "System/myMath.h"
+
+
+/**
+ * @brief Unblocks all threads waiting on an animation
+ * @param anim AnimInfo the corresponding animation
+ */
+void CUnitScript::UnblockAll(AnimInfo* anim)
+{
+	std::list<IAnimListener *>::iterator li;
+
+	for (li = anim->listeners.begin(); li != anim->listeners.end(); ++li) {
+		(*li)->AnimFinished(anim->type, anim->piece, anim->axis);
+	}
+}
+
+
+/**
+ * @brief Updates move animations
+ * @param cur float value to update
+ * @param dest float final value
+ * @param speed float max increment per tick
+ * @return returns true if destination was reached, false otherwise
+ */
+bool CUnitScript::MoveToward(float& cur, float dest, float speed)
+{
+	const float delta = dest - cur;
+
+	if (math::fabsf(delta) <= speed) {
+		cur = dest;
+		return true;
+	}
+
+	if (delta > 0.0f) {
+		cur += speed;
+	} else {
+		cur -= speed;
+	}
+
+	return false;
+}
+
+
+/**
+ * @brief Updates turn animations
+ * @param cur float value to update
+ * @param dest float final value
+ * @param speed float max increment per tick
+ * @return returns true if destination was reached, false otherwise
+ */
+bool CUnitScript::TurnToward(float& cur, float dest, float speed)
+{
+	float delta = dest - cur;
+
+	// clamp: -pi .. 0 .. +pi (remainder(x,TWOPI) would do the same but is slower due to streflop)
+	if (delta > PI) {
+		delta -= TWOPI;
+	} else if (delta<=-PI) {
+		delta += TWOPI;
+	}
+
+	if (math::fabsf(delta) <= speed) {
+		cur = dest;
+		return true;
+	}
+
+	if (delta > 0.0f) {
+		cur += speed;
+	} else {
+		cur -= speed;
+	}
+
+	ClampRad(&cur);
+
+	return false;
+}
+
+
+/**
+ * @brief Updates spin animations
+ * @param cur float value to update
+ * @param dest float the final desired speed (NOT the final angle!)
+ * @param speed float is updated if it is not equal to dest
+ * @param divisor int is the deltatime, it is not added before the call because speed may have to be updated
+ * @return true if the desired speed is 0 and it is reached, false otherwise
+ */
+bool CUnitScript::DoSpin(float& cur, float dest, float &speed, float accel, int divisor)
+{
+	const float delta = dest - speed;
+
+	// Check if we are not at the final speed and
+	// make sure we dont go past desired speed
+	if (math::fabsf(delta) <= accel) {
+		speed = dest;
+		if (speed == 0.0f)
+			return true;
+	}
+	else {
+		if (delta > 0.0f) {
+			// accelerations are defined in speed/frame (at GAME_SPEED fps)
+			speed += accel * (float(GAME_SPEED) / divisor);
+		} else {
+			speed -= accel * (float(GAME_SPEED) / divisor);
+		}
+	}
+
+	cur += (speed / divisor);
+	ClampRad(&cur);
+
+	return false;
+}
+
+
+
+bool CUnitScript::TickAnims(int deltaTime)
+{
+	bool haveDoneAnims = false;
+
+	{
+		AnimContainer& turns = anims[ATurn];
+
+		for (size_t n = 0; n < turns.size(); n++) {
+			AnimInfo& ai = turns[n];
+			float3 rot = pieces[ai.piece]->GetRotation();
+
+			if (TurnToward(rot[ai.axis], ai.dest, ai.speed / (1000 / deltaTime))) {
+				ai.done = true; haveDoneAnims = true;
+			}
+
+			pieces[ai.piece]->SetRotation(rot);
+			unit->localModel->PieceUpdated(ai.piece);
+		}
+	}
+	{
+		AnimContainer& spins = anims[ASpin];
+
+		for (size_t n = 0; n < spins.size(); n++) {
+			AnimInfo& ai = spins[n];
+			float3 rot = pieces[ai.piece]->GetRotation();
+
+			if (DoSpin(rot[ai.axis], ai.dest, ai.speed, ai.accel, 1000 / deltaTime)) {
+				ai.done = true; haveDoneAnims = true;
+			}
+
+			pieces[ai.piece]->SetRotation(rot);
+			unit->localModel->PieceUpdated(ai.piece);
+		}
+	}
+	{
+		AnimContainer& moves = anims[AMove];
+
+		for (size_t n = 0; n < moves.size(); n++) {
+			AnimInfo& ai = moves[n];
+
+			// NOTE: we should not need to copy-and-set here, because
+			// MoveToward/TurnToward/DoSpin modify pos/rot by reference
+			float3 pos = pieces[ai.piece]->GetPosition();
+
+			if (MoveToward(pos[ai.axis], ai.dest, ai.speed / (1000 / deltaTime))) {
+				ai.done = true; haveDoneAnims = true;
+			}
+
+			pieces[ai.piece]->SetPosition(pos);
+			unit->localModel->PieceUpdated(ai.piece);
+		}
+	}
+
+	return haveDoneAnims;
+}
+
+
+void CUnitScript::FinishAnims()
+{
+	assert(doneAnims.empty());
+
+	//! Remove finished animations from the unit/script, then tell their listeners to unblock.
+	//! NOTE:
+	//!     removing a finished animation _must_ happen before notifying its listeners,
+	//!     otherwise the callback function (AnimFinished()) can call AddAnimListener()
+	//!     and append it to the listeners-list again (causing an endless loop)!
+	//! NOTE: UnblockAll might result in new anims being added (or others removed),
+	//!     so all finished ones are taken out before any listener is called
+	for (int animType = ATurn; animType <= AMove; animType++) {
+		AnimContainer& container = anims[animType];
+		AnimContainer::iterator keep = container.begin();
+
+		for (AnimContainer::iterator it = container.begin(); it != container.end(); ++it) {
+			if (it->done) {
+				doneAnims.push_back(AnimInfo());
+				std::swap(doneAnims.back(), *it);
+			} else {
+				if (keep != it)
+					std::swap(*keep, *it);
+				++keep;
+			}
+		}
+
+		container.erase(keep, container.end());
+	}
+
+	for (size_t n = 0; n < doneAnims.size(); n++) {
+		UnblockAll(&doneAnims[n]);
+	}
+
+	doneAnims.clear();
+}
+
+
+
+CUnitScript::AnimContainer::iterator CUnitScript::FindAnim(AnimType type, int piece, int axis)
+{
+	for (AnimContainer::iterator i = anims[type].begin(); i != anims[type].end(); ++i) {
+		if ((i->piece == piece) && (i->axis == axis))
+			return i;
+	}
+
+	return anims[type].end();
+}
+
+void CUnitScript::RemoveAnim(AnimType type, const AnimContainer::iterator& animInfoIt)
+{
+	if (animInfoIt != anims[type].end()) {
+		AnimInfo ai;
+		std::swap(ai, *animInfoIt);
+		anims[type].erase(animInfoIt);
+
+		// If this was the last animation, remove from currently animating list
+		// FIXME: this could be done in a cleaner way
+		if (!HaveAnimations()) {
+			GUnitScriptEngine.RemoveInstance(this);
+		}
+
+		//! We need to unblock threads waiting on this animation, otherwise they will be lost in the void
+		//! NOTE: UnblockAll might result in new anims being added
+		UnblockAll(&ai);
+	}
+}
+
+
+//Overwrites old information. This means that threads blocking on turn completion
+//will now wait for this new turn instead. Not sure if this is the expected behaviour
+//Other option would be to kill them. Or perhaps unblock them.
+void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel)
+{
+	if (!PieceExists(piece)) {
+		ShowScriptError("Invalid piecenumber");
+		return;
+	}
+
+	float destf = 0.0f;
+
+	if (type == AMove) {
+		destf = pieces[piece]->original->offset[axis] + dest;
+	} else {
+		destf = dest;
+		if (type == ATurn) {
+			ClampRad(&destf);
+		}
+	}
+
+	AnimContainer::iterator animInfoIt;
+	AnimInfo* ai = NULL;
+	AnimType overrideType = ANone;
+
+	// first find an animation of a type we override
+	// Turns override spins.. Not sure about the other way around? If so
+	// the system should probably be redesigned to only have two types of
+	// anims (turns and moves), with spin as a bool
+	switch (type) {
+		case ATurn: {
+			overrideType = ASpin;
+			animInfoIt = FindAnim(overrideType, piece, axis);
+		} break;
+		case ASpin: {
+			overrideType = ATurn;
+			animInfoIt = FindAnim(overrideType, piece, axis);
+		} break;
+		case AMove: {
+			// ensure we never remove an animation of this type
+			overrideType = AMove;
+			animInfoIt = anims[overrideType].end();
+		} break;
+		default: {
+		} break;
+	}
+
+	if (animInfoIt != anims[overrideType].end())
+		RemoveAnim(overrideType, animInfoIt);
+
+	// now find an animation of our own type
+	animInfoIt = FindAnim(type, piece, axis);
+
+	if (animInfoIt == anims[type].end()) {
+		// If we were not animating before, inform the engine of this so it can schedule us
+		// FIXME: this could be done in a cleaner way
+		if (!HaveAnimations()) {
+			GUnitScriptEngine.AddInstance(this);
+		}
+
+		anims[type].push_back(AnimInfo());
+		ai = &anims[type].back();
+		ai->type = type;
+		ai->piece = piece;
+		ai->axis = axis;
+	} else {
+		ai = &(*animInfoIt);
+	}
+
+	ai->dest  = destf;
+	ai->speed = speed;
+	ai->accel = accel;
+	ai->done = false;
+}
+
+
+void CUnitScript::Spin(int piece, int axis, float speed, float accel)
+{
+	AnimContainer::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+
+	//If we are already spinning, we may have to decelerate to the new speed
+	if (animInfoIt != anims[ASpin].end()) {
+		AnimInfo* ai = &(*animInfoIt);
+		ai->dest = speed;
+
+		if (accel > 0) {
+			ai->accel = accel;
+		} else {
+			//Go there instantly. Or have a defaul accel?
+			ai->speed = speed;
+			ai->accel = 0;
+		}
+	} else {
+		//No accel means we start at desired speed instantly
+		if (accel <= 0)
+			AddAnim(ASpin, piece, axis, speed, speed, 0);
+		else
+			AddAnim(ASpin, piece, axis, 0, speed, accel);
+	}
+}
+
+
+void CUnitScript::StopSpin(int piece, int axis, float decel)
+{
+	AnimContainer::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+
+	if (decel <= 0) {
+		RemoveAnim(ASpin, animInfoIt);
+	} else {
+		if (animInfoIt == anims[ASpin].end())
+			return;
+
+		AnimInfo* ai = &(*animInfoIt);
+		ai->dest = 0;
+		ai->accel = decel;
+	}
+}
+
+
+void CUnitScript::Turn(int piece, int axis, float speed, float destination)
+{
+	AddAnim(ATurn, piece, axis, std::max(speed, -speed), destination, 0);
+}
+
+
+void CUnitScript::Move(int piece, int axis, float speed, float destination)
+{
+	AddAnim(AMove, piece, axis, std::max(speed, -speed), destination, 0);
+}
+
+
+void CUnitScript::MoveNow(int piece, int axis, float destination)
+{
+	if (!PieceExists(piece)) {
+		ShowScriptError("Invalid piecenumber");
+		return;
+	}
+
+	LocalModel* m = unit->localModel;
+	LocalModelPiece* p = pieces[piece];
+
+	float3 pos = p->GetPosition();
+	pos[axis] = pieces[piece]->original->offset[axis] + destination;
+
+	p->SetPosition(pos);
+	m->PieceUpdated(piece);
+}
+
+
+void CUnitScript::TurnNow(int piece, int axis, float destination)
+{
+	if (!PieceExists(piece)) {
+		ShowScriptError("Invalid piecenumber");
+		return;
+	}
+
+	LocalModel* m = unit->localModel;
+	LocalModelPiece* p = pieces[piece];
+
+	float3 rot = p->GetRotation();
+	rot[axis] = destination;
+
+	p->SetRotation(rot);
+	m->PieceUpdated(piece);
+}
+
+
+//Returns true if there was an animation to listen to
+bool CUnitScript::AddAnimListener(AnimType type, int piece, int axis, IAnimListener *listener)
+{
+	AnimContainer::iterator animInfoIt = FindAnim(type, piece, axis);
+
+	if (animInfoIt != anims[type].end()) {
+		AnimInfo* ai = &(*animInfoIt);
+
+		if (!ai->done) {
+			ai->listeners.push_back(listener);
+			return true;
+		}
+
+		// if the animation is already finished, listening for
+		// it just adds some overhead since either the current
+		// or the next Tick will remove it and call UnblockAll
+		// (which calls AnimFinished for each listener)
+		//
+		// we could notify the listener here, but a cleaner way
+		// is to treat the animation as if it did not exist and
+		// simply disregard the WaitFor* (no side-effects)
+		//
+		// listener->AnimFinished(ai->type, ai->piece, ai->axis);
+	}
+
+	return false;
+}
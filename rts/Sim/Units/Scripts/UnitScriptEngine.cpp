@@ -7,6 +7,9 @@
 #include "UnitScriptLog.h"
 
 #include "System/FileSystem/FileHandler.h"
+#include "System/Sync/SyncedParallel.h"
+
+#include <algorithm>
 
 #ifndef _CONSOLE
 	#include "System/TimeProfiler.h"
@@ -20,12 +23,14 @@
 
 CUnitScriptEngine GUnitScriptEngine;
 
+static const int ANIM_TICK_BATCH_SIZE = 32;
+
 
 /******************************************************************************/
 /******************************************************************************/
 
 
-CUnitScriptEngine::CUnitScriptEngine() : currentScript(NULL)
+CUnitScriptEngine::CUnitScriptEngine()
 {
 }
 
@@ -35,61 +40,77 @@ CUnitScriptEngine::~CUnitScriptEngine()
 }
 
 
-void CUnitScriptEngine::CheckForDuplicates(const char* name, CUnitScript* instance)
+void CUnitScriptEngine::AddInstance(CUnitScript* instance)
 {
-	int found = 0;
+	if (instance->animatingIndex >= 0)
+		return;
 
-	for (std::list<CUnitScript*>::iterator i = animating.begin(); i != animating.end(); ++i) {
-		if (*i == instance)
-			found++;
-	}
-
-	if (found > 1)
-		LOG_L(L_WARNING, "%s found duplicates %d", name, found);
+	instance->animatingIndex = animating.size();
+	animating.push_back(instance);
 }
 
 
-void CUnitScriptEngine::AddInstance(CUnitScript *instance)
+void CUnitScriptEngine::RemoveInstance(CUnitScript* instance)
 {
-	if (instance != currentScript)
-		animating.push_front(instance);
+	if (instance->animatingIndex < 0)
+		return;
 
-	// Error checking
-#ifdef _DEBUG
-	CheckForDuplicates(__FUNCTION__, instance);
-#endif
+	animating[instance->animatingIndex] = NULL;
+	instance->animatingIndex = -1;
 }
 
 
-void CUnitScriptEngine::RemoveInstance(CUnitScript *instance)
+void CUnitScriptEngine::Tick(int deltaTime)
 {
-	// Error checking
-#ifdef _DEBUG
-	CheckForDuplicates(__FUNCTION__, instance);
-#endif
+	SCOPED_TIMER("UnitScriptEngine::Tick");
 
-	//This is slow. would be better if instance was a hashlist perhaps
-	if (instance != currentScript)
-		animating.remove(instance);
-}
+	const int numScripts = animating.size();
 
+	finished.clear();
+	finished.resize(numScripts, 0);
 
-void CUnitScriptEngine::Tick(int deltaTime)
-{
-	SCOPED_TIMER("UnitScriptEngine::Tick");
+	// Advance all animations. A script only modifies the pieces of its own
+	// unit and does not call anything else, so the scripts are ticked in
+	// parallel (in batches, to keep the per-task overhead low)
+	for_mt_synced(0, numScripts, ANIM_TICK_BATCH_SIZE, [&](const int idx) {
+		const int end = std::min(idx + ANIM_TICK_BATCH_SIZE, numScripts);
 
-	// Tick all instances that have registered themselves as animating
-	for (std::list<CUnitScript*>::iterator it = animating.begin(); it != animating.end(); ) {
-		currentScript = *it;
+		for (int n = idx; n < end; n++) {
+			if (animating[n] != NULL) {
+				finished[n] = animating[n]->TickAnims(deltaTime);
+			}
+		}
+	});
+
+	// Unblock the listeners of finished animations serially and in a fixed
+	// order. They can start or stop animations of any unit (and even kill
+	// it), so only scripts that are still registered are looked at and new
+	// ones are appended (and ticked from the next frame on).
+	for (int n = 0; n < numScripts; n++) {
+		if (finished[n] && animating[n] != NULL) {
+			animating[n]->FinishAnims();
+		}
+	}
 
-		if (currentScript->Tick(deltaTime)) {
-			++it;
-		} else {
-			it = animating.erase(it);
+	// Drop removed scripts and those without animations left
+	size_t numAnimating = 0;
+
+	for (size_t n = 0; n < animating.size(); n++) {
+		CUnitScript* script = animating[n];
+
+		if (script == NULL)
+			continue;
+
+		if (!script->HaveAnimations()) {
+			script->animatingIndex = -1;
+			continue;
 		}
+
+		script->animatingIndex = numAnimating;
+		animating[numAnimating++] = script;
 	}
 
-	currentScript = NULL;
+	animating.resize(numAnimating);
 }
 
 
@@ -5,7 +5,7 @@
 #ifndef UNIT_SCRIPT_ENGINE_H
 #define UNIT_SCRIPT_ENGINE_H
 
-#include <list>
+#include <vector>
 
 class CUnit;
 class CUnitScript;
@@ -14,8 +14,13 @@ class CUnitScript;
 class CUnitScriptEngine
 {
 protected:
-	std::list<CUnitScript*> animating; // hash would be optimal, but not crucial
-	void CheckForDuplicates(const char* name, CUnitScript* instance);
+	/**
+	 * Scripts with running animations, in the order they started animating.
+	 * Removed scripts leave a NULL behind until the end of the next Tick.
+	 */
+	std::vector<CUnitScript*> animating;
+	/// per entry of animating, whether an animation finished during this Tick
+	std::vector<char> finished;
 
 public:
 	CUnitScriptEngine();
@@ -23,9 +28,6 @@ public:
 	void AddInstance(CUnitScript* instance);
 	void RemoveInstance(CUnitScript* instance);
 	void Tick(int deltaTime);
-
-private:
-	CUnitScript* currentScript;
 };
 
 extern CUnitScriptEngine GUnitScriptEngine;
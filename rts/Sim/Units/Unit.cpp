@@ -173,6 +173,7 @@ CUnit::CUnit() : CSolidObject(),
 	hasRadarCapacity(false),
 	oldRadarPos(0, 0),
 	hasRadarPos(false),
+	radarPendingIndex(-1),
 	stealth(false),
 	sonarStealth(false),
 	condUseMetal(0.0f),
@@ -308,6 +309,7 @@ CUnit::~CUnit()
 
 	quadField->RemoveUnit(this);
 	losHandler->DelayedFreeInstance(los);
+	losHandler->RemoveUnit(this);
 	los = NULL;
 	radarHandler->RemoveUnit(this);
 
@@ -390,6 +392,7 @@ void CUnit::PreInit(const UnitLoadParams& params)
 	hasRadarPos = false;
 
 	losStatus[allyteam] = LOS_ALL_MASK_BITS | LOS_INLOS | LOS_INRADAR | LOS_PREVLOS | LOS_CONTRADAR;
+	losHandler->UpdateUnitVisibility(this, allyteam);
 
 #ifdef TRACE_SYNC
 	tracefile << "[" << __FUNCTION__ << "] id: " << id << ", name: " << unitDef->name << " ";
@@ -740,6 +743,9 @@ void CUnit::SetLosStatus(int at, unsigned short newStatus)
 	losStatus[at] |= newStatus;
 
 	if (diffBits) {
+		// the visibility index has to match the state the call-ins see
+		losHandler->UpdateUnitVisibility(this, at);
+
 		if (diffBits & LOS_INLOS) {
 			if (newStatus & LOS_INLOS) {
 				eventHandler.UnitEnteredLos(this, at);
@@ -747,6 +753,7 @@ void CUnit::SetLosStatus(int at, unsigned short newStatus)
 			} else {
 				// clear before sending the event
 				losStatus[at] &= ~LOS_INLOS;
+				losHandler->UpdateUnitVisibility(this, at);
 
 				eventHandler.UnitLeftLos(this, at);
 				eoh->UnitLeftLos(*this, at);
@@ -760,6 +767,7 @@ void CUnit::SetLosStatus(int at, unsigned short newStatus)
 			} else {
 				// clear before sending the event
 				losStatus[at] &= ~LOS_INRADAR;
+				losHandler->UpdateUnitVisibility(this, at);
 
 				eventHandler.UnitLeftRadar(this, at);
 				eoh->UnitLeftRadar(*this, at);
@@ -1407,7 +1415,6 @@ bool CUnit::ChangeTeam(int newteam, ChangeType type)
 	eoh->UnitCaptured(*this, oldteam, newteam);
 
 	quadField->RemoveUnit(this);
-	quads.clear();
 	losHandler->FreeInstance(los);
 	los = 0;
 	radarHandler->RemoveUnit(this);
@@ -1446,6 +1453,7 @@ bool CUnit::ChangeTeam(int newteam, ChangeType type)
 		} else {
 			// re-calc LOS status
 			losStatus[at] = 0;
+			losHandler->UpdateUnitVisibility(this, at);
 			UpdateLosStatus(at);
 		}
 	}
@@ -2353,6 +2361,7 @@ CR_REG_METADATA(CUnit, (
 	CR_MEMBER(category),
 
 	CR_MEMBER(quads),
+	CR_MEMBER(quadSlots),
 	CR_MEMBER(los),
 
 	CR_MEMBER(tempNum),
@@ -2376,6 +2385,7 @@ CR_REG_METADATA(CUnit, (
 	CR_MEMBER(radarSquares),
 	CR_MEMBER(oldRadarPos),
 	CR_MEMBER(hasRadarPos),
+	CR_IGNORED(radarPendingIndex), // only set within a move batch
 	CR_MEMBER(stealth),
 	CR_MEMBER(sonarStealth),
 
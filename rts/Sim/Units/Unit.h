@@ -258,6 +258,8 @@ public:
 	std::vector<CWeapon*> weapons;
 	/// quads the unit is part of
 	std::vector<int> quads;
+	/// per entry in quads: slot in Quad::units (x) and Quad::teamUnits[allyteam] (y)
+	std::vector<int2> quadSlots;
 	std::vector<int> radarSquares;
 
 	/// indicate the los/radar status the allyteam has on this unit
@@ -396,6 +398,8 @@ public:
 	bool hasRadarCapacity;
 	int2 oldRadarPos;
 	bool hasRadarPos;
+	/// index into CRadarHandler::pendingRadars while the radar ray-cast is queued, -1 otherwise
+	int radarPendingIndex;
 	bool stealth;
 	bool sonarStealth;
 
@@ -10,13 +10,17 @@
 #include "CommandAI/BuilderCAI.h"
 #include "Rendering/Models/3DModel.h"
 #include "Sim/Misc/AirBaseHandler.h"
+#include "Sim/Misc/LosHandler.h"
+#include "Sim/Misc/RadarHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "System/EventHandler.h"
 #include "System/EventBatchHandler.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 #include "System/myMath.h"
+#include "System/Sync/SyncedParallel.h"
 #include "System/Sync/SyncTracer.h"
 #include "System/creg/STL_Deque.h"
 #include "System/creg/STL_List.h"
@@ -27,8 +31,34 @@
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
+CONFIG(bool, StageMoveTypeUpdates).defaultValue(true).description("Lets ground units precompute terrain and steering values on worker threads before the serial MoveType pass. Sync is the same either way, so the gain can be measured by comparing the Unit::MoveType::Update profiler timer with this on and off.");
+
 CUnitHandler* unitHandler = NULL;
 
+// number of consecutive units staged by one worker task (see UpdateUnitMoveTypes)
+static const int MOVETYPE_STAGE_BATCH_SIZE = 64;
+// number of consecutive units whose piece matrices are updated by one worker task
+static const int PIECE_MATRIX_BATCH_SIZE = 64;
+
+#define MAPPOS_SANITY_CHECK(unit)                          \
+	if (unit->unitDef->IsGroundUnit()) {                   \
+		assert(unit->pos.x >= -(float3::maxxpos * 16.0f)); \
+		assert(unit->pos.x <=  (float3::maxxpos * 16.0f)); \
+		assert(unit->pos.z >= -(float3::maxzpos * 16.0f)); \
+		assert(unit->pos.z <=  (float3::maxzpos * 16.0f)); \
+	}
+#define UNIT_SANITY_CHECK(unit)         \
+	unit->pos.AssertNaNs();             \
+	unit->midPos.AssertNaNs();          \
+	unit->relMidPos.AssertNaNs();       \
+	unit->speed.AssertNaNs();           \
+	unit->deathSpeed.AssertNaNs();      \
+	unit->rightdir.AssertNaNs();        \
+	unit->updir.AssertNaNs();           \
+	unit->frontdir.AssertNaNs();        \
+	MAPPOS_SANITY_CHECK(unit);
+
+
 CR_BIND(CUnitHandler, );
 CR_REG_METADATA(CUnitHandler, (
 	CR_MEMBER(units),
@@ -54,7 +84,8 @@ void CUnitHandler::PostLoad()
 CUnitHandler::CUnitHandler()
 :
 	maxUnits(0),
-	maxUnitRadius(0.0f)
+	maxUnitRadius(0.0f),
+	stageMoveTypes(configHandler->GetBool("StageMoveTypeUpdates"))
 {
 	// set the global (runtime-constant) unit-limit as the sum
 	// of  all team unit-limits, which is *always* <= MAX_UNITS
@@ -181,77 +212,119 @@ void CUnitHandler::DeleteUnitNow(CUnit* delUnit)
 }
 
 
-void CUnitHandler::Update()
+void CUnitHandler::UpdateUnitMoveTypes()
 {
-	{
-		GML_STDMUTEX_LOCK(runit); // Update
+	SCOPED_TIMER("Unit::MoveType::Update");
 
-		if (!unitsToBeRemoved.empty()) {
-			GML_RECMUTEX_LOCK(obj); // Update
+	if (stageMoveTypes) {
+		SCOPED_TIMER("Unit::MoveType::Update::Stage");
 
-			while (!unitsToBeRemoved.empty()) {
-				eventHandler.DeleteSyncedObjects(); // the unit destructor may invoke eventHandler, so we need to call these for every unit to clear invaild references from the batching systems
+		// compute-phase: lets every MoveType gather what it needs from
+		// the world concurrently; any synced writes made here go to the
+		// checksum of their batch, which keeps it independent from the
+		// thread count (units are split into batches to keep the per-task
+		// overhead low)
+		parallelUpdateUnits.assign(activeUnits.begin(), activeUnits.end());
 
-				GML_RECMUTEX_LOCK(unit); // Update
+		const int numUnits = parallelUpdateUnits.size();
 
-				eventHandler.DeleteSyncedUnits();
+		for_mt_synced(0, numUnits, MOVETYPE_STAGE_BATCH_SIZE, [&](const int idx) {
+			const int end = std::min(idx + MOVETYPE_STAGE_BATCH_SIZE, numUnits);
 
-				GML_RECMUTEX_LOCK(proj); // Update - projectile drawing may access owner() and lead to crash
-				GML_RECMUTEX_LOCK(sel);  // Update - unit is removed from selectedUnits in ~CObject, which is too late.
-				GML_RECMUTEX_LOCK(quad); // Update - make sure unit does not get partially deleted before before being removed from the quadfield
+			for (int n = idx; n < end; n++) {
+				parallelUpdateUnits[n]->moveType->StageUpdate();
+			}
+		});
+	}
 
-				CUnit* delUnit = unitsToBeRemoved.back();
-				unitsToBeRemoved.pop_back();
+	// commit-phase: must run serially and in activeUnits order, this
+	// is where all synced state (positions, collisions, events) changes
+	// (without a stage, MoveTypes compute everything here by themselves)
+	std::list<CUnit*>::iterator usi;
+	for (usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
+		CUnit* unit = *usi;
+		AMoveType* moveType = unit->moveType;
 
-				DeleteUnitNow(delUnit);
-			}
+		UNIT_SANITY_CHECK(unit);
+
+		if (moveType->Update()) {
+			eventHandler.UnitMoved(unit);
+		}
+		if (!unit->pos.IsInBounds() && (Square(unit->speed.w) > (MAX_UNIT_SPEED * MAX_UNIT_SPEED))) {
+			// this unit is not coming back, kill it now without any death
+			// sequence (so deathScriptFinished becomes true immediately)
+			unit->KillUnit(NULL, false, true, false);
 		}
 
-		eventHandler.UpdateUnits();
+		UNIT_SANITY_CHECK(unit);
+		GML::GetTicks(unit->lastUnitUpdate);
 	}
+}
 
-	GML::UpdateTicks();
 
-	#define MAPPOS_SANITY_CHECK(unit)                          \
-		if (unit->unitDef->IsGroundUnit()) {                   \
-			assert(unit->pos.x >= -(float3::maxxpos * 16.0f)); \
-			assert(unit->pos.x <=  (float3::maxxpos * 16.0f)); \
-			assert(unit->pos.z >= -(float3::maxzpos * 16.0f)); \
-			assert(unit->pos.z <=  (float3::maxzpos * 16.0f)); \
-		}
-	#define UNIT_SANITY_CHECK(unit)         \
-		unit->pos.AssertNaNs();             \
-		unit->midPos.AssertNaNs();          \
-		unit->relMidPos.AssertNaNs();       \
-		unit->speed.AssertNaNs();           \
-		unit->deathSpeed.AssertNaNs();      \
-		unit->rightdir.AssertNaNs();        \
-		unit->updir.AssertNaNs();           \
-		unit->frontdir.AssertNaNs();        \
-		MAPPOS_SANITY_CHECK(unit);
+void CUnitHandler::DeleteScheduledUnits()
+{
+	if (unitsToBeRemoved.empty())
+		return;
 
-	{
-		SCOPED_TIMER("Unit::MoveType::Update");
-		std::list<CUnit*>::iterator usi;
-		for (usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
-			CUnit* unit = *usi;
-			AMoveType* moveType = unit->moveType;
+	GML_RECMUTEX_LOCK(obj); // DeleteScheduledUnits
 
-			UNIT_SANITY_CHECK(unit);
+	while (!unitsToBeRemoved.empty()) {
+		eventHandler.DeleteSyncedObjects(); // the unit destructor may invoke eventHandler, so we need to call these for every unit to clear invaild references from the batching systems
 
-			if (moveType->Update()) {
-				eventHandler.UnitMoved(unit);
-			}
-			if (!unit->pos.IsInBounds() && (Square(unit->speed.w) > (MAX_UNIT_SPEED * MAX_UNIT_SPEED))) {
-				// this unit is not coming back, kill it now without any death
-				// sequence (so deathScriptFinished becomes true immediately)
-				unit->KillUnit(NULL, false, true, false);
-			}
+		GML_RECMUTEX_LOCK(unit); // DeleteScheduledUnits
 
-			UNIT_SANITY_CHECK(unit);
-			GML::GetTicks(unit->lastUnitUpdate);
-		}
+		eventHandler.DeleteSyncedUnits();
+
+		GML_RECMUTEX_LOCK(proj); // DeleteScheduledUnits - projectile drawing may access owner() and lead to crash
+		GML_RECMUTEX_LOCK(sel);  // DeleteScheduledUnits - unit is removed from selectedUnits in ~CObject, which is too late.
+		GML_RECMUTEX_LOCK(quad); // DeleteScheduledUnits - make sure unit does not get partially deleted before before being removed from the quadfield
+
+		CUnit* delUnit = unitsToBeRemoved.back();
+		unitsToBeRemoved.pop_back();
+
+		DeleteUnitNow(delUnit);
 	}
+}
+
+void CUnitHandler::DeleteAllUnits()
+{
+	GML_STDMUTEX_LOCK(runit); // DeleteAllUnits
+
+	// flush the units that are already scheduled first, so none is queued twice
+	DeleteScheduledUnits();
+
+	for (std::list<CUnit*>::iterator usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
+		CUnit* unit = *usi;
+
+		// no death sequence and no wreck
+		unit->delayedWreckLevel = -1;
+		DeleteUnit(unit);
+	}
+
+	DeleteScheduledUnits();
+}
+
+
+void CUnitHandler::Update()
+{
+	{
+		GML_STDMUTEX_LOCK(runit); // Update
+
+		DeleteScheduledUnits();
+
+		eventHandler.UpdateUnits();
+	}
+
+	GML::UpdateTicks();
+
+	// the LOS and radar changes of all units moved below are applied at
+	// once (and in parallel) at the end; until then, every reader sees the
+	// coverage as it was before this update
+	losHandler->BeginMoveBatch();
+	radarHandler->BeginMoveBatch();
+
+	UpdateUnitMoveTypes();
 
 	{
 		// Delete dead units
@@ -271,14 +344,23 @@ void CUnitHandler::Update()
 
 	{
 		SCOPED_TIMER("Unit::UpdatePieceMatrices");
-		std::list<CUnit*>::iterator usi;
-		for (usi = activeUnits.begin(); usi != activeUnits.end(); ++usi) {
-			// UnitScript only applies piece-space transforms so
-			// we apply the forward kinematics update separately
-			// (only if we have any dirty pieces)
-			CUnit* unit = *usi;
-			unit->localModel->UpdatePieceMatrices();
-		}
+
+		// UnitScript only applies piece-space transforms so
+		// we apply the forward kinematics update separately
+		// (only if we have any dirty pieces); this touches
+		// nothing but the unit's own model, so all units are
+		// updated in parallel
+		parallelUpdateUnits.assign(activeUnits.begin(), activeUnits.end());
+
+		const int numUnits = parallelUpdateUnits.size();
+
+		for_mt_synced(0, numUnits, PIECE_MATRIX_BATCH_SIZE, [&](const int idx) {
+			const int end = std::min(idx + PIECE_MATRIX_BATCH_SIZE, numUnits);
+
+			for (int n = idx; n < end; n++) {
+				parallelUpdateUnits[n]->localModel->UpdatePieceMatrices();
+			}
+		});
 	}
 
 	{
@@ -313,6 +395,9 @@ void CUnitHandler::Update()
 			n--;
 		}
 	}
+
+	radarHandler->EndMoveBatch();
+	losHandler->EndMoveBatch();
 }
 
 
@@ -25,6 +25,8 @@ public:
 	void Update();
 	void DeleteUnit(CUnit* unit);
 	void DeleteUnitNow(CUnit* unit);
+	/// removes every unit right away, without death sequences or wrecks
+	void DeleteAllUnits();
 	bool AddUnit(CUnit* unit);
 	void PostLoad();
 
@@ -60,12 +62,15 @@ public:
 
 private:
 	void InsertActiveUnit(CUnit* unit);
+	void DeleteScheduledUnits();
+	void UpdateUnitMoveTypes();
 
 private:
 	SimObjectIDPool idPool;
 
 	std::vector<CUnit*> unitsToBeRemoved;              ///< units that will be removed at start of next update
 	std::list<CUnit*>::iterator activeSlowUpdateUnit;  ///< first unit of batch that will be SlowUpdate'd this frame
+	std::vector<CUnit*> parallelUpdateUnits;           ///< random-access copy of activeUnits for the parallel update passes (not saved)
 
 	///< global unit-limit (derived from the per-team limit)
 	///< units.size() is equal to this and constant at runtime
@@ -74,6 +79,9 @@ private:
 	///< largest radius of any unit added so far (some
 	///< spatial query filters in GameHelper use this)
 	float maxUnitRadius;
+
+	///< whether UpdateUnitMoveTypes runs the parallel stage (StageMoveTypeUpdates, not saved)
+	bool stageMoveTypes;
 };
 
 extern CUnitHandler* unitHandler;
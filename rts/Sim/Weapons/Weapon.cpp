@@ -731,15 +731,13 @@ bool CWeapon::AllowWeaponTargetCheck()
 void CWeapon::AutoTarget() {
 	lastTargetRetry = gs->frameNum;
 
-	std::multimap<float, CUnit*> targets;
-	std::multimap<float, CUnit*>::const_iterator targetsIt;
+	CScratchArena::Scope scope;
 
 	// NOTE:
 	//   sorts by INCREASING order of priority, so lower equals better
-	//   <targets> can contain duplicates if a unit covers multiple quads
 	//   <targets> is normally sorted such that all bad TC units are at the
 	//   end, but Lua can mess with the ordering arbitrarily
-	CGameHelper::GenerateWeaponTargets(this, targetUnit, targets);
+	const ScratchSpan<CGameHelper::WeaponTarget>& targets = CGameHelper::GenerateWeaponTargets(scope, this, targetUnit);
 
 	CUnit* prevTargetUnit = NULL;
 	CUnit* goodTargetUnit = NULL;
@@ -747,8 +745,8 @@ void CWeapon::AutoTarget() {
 
 	float3 nextTargetPos = ZeroVector;
 
-	for (targetsIt = targets.begin(); targetsIt != targets.end(); ++targetsIt) {
-		CUnit* nextTargetUnit = targetsIt->second;
+	for (const CGameHelper::WeaponTarget* targetsIt = targets.begin(); targetsIt != targets.end(); ++targetsIt) {
+		CUnit* nextTargetUnit = targetsIt->unit;
 
 		if (nextTargetUnit == prevTargetUnit)
 			continue; // filter consecutive duplicates
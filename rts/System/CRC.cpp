@@ -7,16 +7,21 @@ extern "C" {
 };
 
 
-static bool crcTableInitialized;
+static bool InitTable()
+{
+	CrcGenerateTable();
+	return true;
+}
 
 
 CRC::CRC()
 {
+	// archives are checksummed from multiple threads, the
+	// initialization of function-local statics is thread-safe
+	static const bool tableInitialized = InitTable();
+
 	crc = CRC_INIT_VAL;
-	if (!crcTableInitialized) {
-		crcTableInitialized = true;
-		CrcGenerateTable();
-	}
+	(void) tableInitialized;
 }
 
 
@@ -3,10 +3,13 @@
 
 #include <list>
 #include <algorithm>
+#include <cstring>
+#include <ctime>
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "ArchiveScanner.h"
 #include "ArchiveLoader.h"
@@ -23,6 +26,7 @@
 #include "System/Exceptions.h"
 #include "System/ThreadPool.h"
 #if       !defined(DEDICATED) && !defined(UNITSYNC)
+#include "System/Platform/Threading.h"
 #include "System/Platform/Watchdog.h"
 #endif // !defined(DEDICATED) && !defined(UNITSYNC)
 
@@ -350,7 +354,10 @@ CArchiveScanner::CArchiveScanner()
 	file << "ArchiveCache.lua";
 
 	cachefile = file.str();
-	ReadCacheData(dataDirLocater.GetWriteDirPath() + GetFilename());
+
+	if (!ReadBinaryCacheData(dataDirLocater.GetWriteDirPath() + GetFilename())) {
+		ReadCacheData(dataDirLocater.GetWriteDirPath() + GetFilename());
+	}
 
 	const std::vector<std::string>& datadirs = dataDirLocater.GetDataDirPaths();
 	std::vector<std::string> scanDirs;
@@ -393,56 +400,105 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs, bool do
 }
 
 
+void CArchiveScanner::ListDir(const std::string& dirPath, DirInfo& dirInfo)
+{
+	const std::vector<std::string>& found = dataDirsAccess.FindFiles(dirPath, "*", FileQueryFlags::INCLUDE_DIRS);
+
+	dirInfo.archives.clear();
+	dirInfo.subDirs.clear();
+
+	for (auto f: found) {
+		std::string fullName = f;
+
+		// Strip
+		const char lastFullChar = fullName[fullName.size() - 1];
+		if ((lastFullChar == '/') || (lastFullChar == '\\')) {
+			fullName = fullName.substr(0, fullName.size() - 1);
+		}
+
+		const std::string fpath = FileSystem::GetDirectory(fullName);
+		const std::string lcfpath = StringToLower(fpath);
+
+		// Exclude archivefiles found inside directory archives (.sdd)
+		if (lcfpath.find(".sdd") != std::string::npos) {
+			continue;
+		}
+
+		// Exclude archivefiles found inside hidden directories
+		if ((lcfpath.find("/hidden/")   != std::string::npos) ||
+		    (lcfpath.find("\\hidden\\") != std::string::npos)) {
+			continue;
+		}
+
+		// Is this an archive we should look into?
+		if (archiveLoader.IsArchiveFile(fullName)) {
+			dirInfo.archives.push_back(fullName);
+		} else
+		if (FileSystem::DirExists(fullName)) {
+			dirInfo.subDirs.push_back(fullName);
+		}
+	}
+}
+
+
 void CArchiveScanner::Scan(const std::string& curPath, bool doChecksum)
 {
 	isDirty = true;
 
+	// directories whose mtime is within a second of now could still change
+	// without their mtime doing so, their listings are not trusted next time
+	const unsigned int scanTime = time(NULL);
+
+	unsigned int numDirs = 0;
+	unsigned int numListedDirs = 0;
+
+	std::vector<std::string> archives;
+
 	// check recursive dirs when NOT being sdd's!
 	std::list<std::string> subDirs;
 	subDirs.push_back(curPath);
 
 	while (!subDirs.empty()) {
-		FileSystem::EnsurePathSepAtEnd(subDirs.front());
-		const std::vector<std::string>& found = dataDirsAccess.FindFiles(subDirs.front(), "*", FileQueryFlags::INCLUDE_DIRS);
+		std::string dirPath = subDirs.front();
 		subDirs.pop_front();
 
-		for (auto f: found) {
-			std::string fullName = f;
+		// stat() on windows fails for paths with a trailing separator
+		struct stat info = {0};
+		const int statfailed = stat(dirPath.c_str(), &info);
+		const unsigned int modified = (statfailed == 0)? info.st_mtime: 0;
 
-			// Strip
-			const char lastFullChar = fullName[fullName.size() - 1];
-			if ((lastFullChar == '/') || (lastFullChar == '\\')) {
-				fullName = fullName.substr(0, fullName.size() - 1);
-			}
+		FileSystem::EnsurePathSepAtEnd(dirPath);
+		DirInfo& dirInfo = dirInfos[dirPath];
 
-			const std::string fpath = FileSystem::GetDirectory(fullName);
-			const std::string lcfpath = StringToLower(fpath);
+		// adding, removing or renaming an entry changes the mtime of
+		// its directory, so an unchanged one can reuse its old listing
+		if (modified == 0 || modified != dirInfo.modified) {
+			ListDir(dirPath, dirInfo);
+			dirInfo.modified = ((modified + 1) < scanTime)? modified: 0;
+			numListedDirs++;
+		}
 
-			// Exclude archivefiles found inside directory archives (.sdd)
-			if (lcfpath.find(".sdd") != std::string::npos) {
-				continue;
-			}
+		dirInfo.updated = true;
+		numDirs++;
 
-			// Exclude archivefiles found inside hidden directories
-			if ((lcfpath.find("/hidden/")   != std::string::npos) ||
-			    (lcfpath.find("\\hidden\\") != std::string::npos)) {
-				continue;
-			}
+		archives.insert(archives.end(), dirInfo.archives.begin(), dirInfo.archives.end());
+		subDirs.insert(subDirs.end(), dirInfo.subDirs.begin(), dirInfo.subDirs.end());
+	}
 
-		#if       !defined(DEDICATED) && !defined(UNITSYNC)
-			Watchdog::ClearTimer(WDT_MAIN);
-		#endif // !defined(DEDICATED) && !defined(UNITSYNC)
-
-			// Is this an archive we should look into?
-			if (archiveLoader.IsArchiveFile(fullName)) {
-				ScanArchive(fullName, doChecksum);
-			} else
-			if (FileSystem::DirExists(fullName)) {
-				subDirs.push_back(fullName);
-			}
-		}
+	// the archive-info is read by Lua, which can not run multithreaded
+	for (const std::string& fullName: archives) {
+	#if       !defined(DEDICATED) && !defined(UNITSYNC)
+		Watchdog::ClearTimer(WDT_MAIN);
+	#endif // !defined(DEDICATED) && !defined(UNITSYNC)
+
+		ScanArchive(fullName, false);
 	}
 
+	const unsigned int numChecksums = doChecksum? ChecksumArchives(archives): 0;
+
+	LOG_S(LOG_SECTION_ARCHIVESCANNER, "%s: %u archive(s), %u checksum(s) computed, %u of %u directories listed",
+			curPath.c_str(), unsigned(archives.size()), numChecksums, numListedDirs, numDirs);
+
 	// Now we'll have to parse the replaces-stuff found in the mods
 	for (auto aii: archiveInfos) {
 		for (auto i: aii.second.archiveData.GetReplaces()) {
@@ -701,93 +757,172 @@ IFileFilter* CArchiveScanner::CreateIgnoreFilter(IArchive* ar)
 }
 
 
+unsigned int CArchiveScanner::ChecksumArchives(const std::vector<std::string>& fullNames)
+{
+	std::vector<std::string> names;
+	std::vector<ArchiveInfo*> infos;
+
+	for (const std::string& fullName: fullNames) {
+		const std::map<std::string, ArchiveInfo>::iterator aii = archiveInfos.find(StringToLower(FileSystem::GetFilename(fullName)));
+
+		if (aii == archiveInfos.end())
+			continue;
+
+		ArchiveInfo& ai = aii->second;
+
+		// broken, replaced, already known, or shadowed by another
+		// archive with the same name (the last one scanned wins)
+		if (!ai.updated || !ai.replaced.empty() || ai.checksum != 0)
+			continue;
+		if (ai.path != FileSystem::GetDirectory(fullName))
+			continue;
+		if (std::find(infos.begin(), infos.end(), &ai) != infos.end())
+			continue;
+
+		names.push_back(fullName);
+		infos.push_back(&ai);
+	}
+
+	std::vector<unsigned int> checksums;
+	GetCRCs(names, checksums);
+
+	for (size_t i = 0; i < infos.size(); i++) {
+		infos[i]->checksum = checksums[i];
+	}
+
+	return names.size();
+}
+
+
 /// used below
 struct CRCPair {
-	std::string* filename;
+	const std::string* filename;
+	unsigned int archive;
 	unsigned int nameCRC;
 	unsigned int dataCRC;
 };
 
 
 
-/**
- * Get CRC of the data in the specified archive.
- * Returns 0 if file could not be opened.
- */
 unsigned int CArchiveScanner::GetCRC(const std::string& arcName)
 {
-	CRC crc;
-	std::list<std::string> files;
+	std::vector<unsigned int> checksums;
+	GetCRCs(std::vector<std::string>(1, arcName), checksums);
+	return checksums[0];
+}
 
-	// Try to open an archive
-	boost::scoped_ptr<IArchive> ar(archiveLoader.OpenArchive(arcName));
-	if (!ar) {
-		return 0; // It wasn't an archive
-	}
+void CArchiveScanner::GetCRCs(const std::vector<std::string>& arcNames, std::vector<unsigned int>& checksums)
+{
+	// all archives of a batch are open at the same time
+	static const size_t MAX_OPEN_ARCHIVES = 32;
 
-	// Load ignore list.
-	boost::scoped_ptr<IFileFilter> ignore(CreateIgnoreFilter(ar.get()));
+	if (arcNames.size() > MAX_OPEN_ARCHIVES) {
+		checksums.clear();
+		checksums.reserve(arcNames.size());
 
-	// Insert all files to check in lowercase format
-	for (unsigned fid = 0; fid != ar->NumFiles(); ++fid) {
-		std::string name;
-		int size;
-		ar->FileInfo(fid, name, size);
+		for (size_t n = 0; n < arcNames.size(); n += MAX_OPEN_ARCHIVES) {
+			const std::vector<std::string> batchNames(arcNames.begin() + n, arcNames.begin() + std::min(n + MAX_OPEN_ARCHIVES, arcNames.size()));
+			std::vector<unsigned int> batchChecksums;
 
-		if (ignore->Match(name)) {
-			continue;
+			GetCRCs(batchNames, batchChecksums);
+			checksums.insert(checksums.end(), batchChecksums.begin(), batchChecksums.end());
 		}
 
-		StringToLowerInPlace(name); // case insensitive hash
-		files.push_back(name);
+		return;
 	}
 
-	// Sort by FileName
-	files.sort();
-
-	// Push the filenames into a std::vector, cause OMP can better iterate over those
+	std::vector< boost::shared_ptr<IArchive> > archives(arcNames.size());
+	std::vector< std::vector<std::string> > files(arcNames.size());
 	std::vector<CRCPair> crcs;
-	crcs.reserve(files.size());
-	CRCPair crcp;
-	for (std::list<std::string>::iterator it = files.begin(); it != files.end(); ++it) {
-		crcp.filename = &(*it);
-		crcs.push_back(crcp);
+
+	checksums.clear();
+	checksums.resize(arcNames.size(), 0);
+
+	for (unsigned int a = 0; a < arcNames.size(); ++a) {
+		// Try to open an archive
+		archives[a].reset(archiveLoader.OpenArchive(arcNames[a]));
+
+		if (!archives[a])
+			continue; // It wasn't an archive
+
+		IArchive* ar = archives[a].get();
+		checksums[a] = CRC().GetDigest();
+
+		// Load ignore list.
+		boost::scoped_ptr<IFileFilter> ignore(CreateIgnoreFilter(ar));
+
+		// Insert all files to check in lowercase format
+		for (unsigned fid = 0; fid != ar->NumFiles(); ++fid) {
+			std::string name;
+			int size;
+			ar->FileInfo(fid, name, size);
+
+			if (ignore->Match(name)) {
+				continue;
+			}
+
+			StringToLowerInPlace(name); // case insensitive hash
+			files[a].push_back(name);
+		}
+
+		// Sort by FileName
+		std::sort(files[a].begin(), files[a].end());
+
+		for (std::vector<std::string>::const_iterator it = files[a].begin(); it != files[a].end(); ++it) {
+			const CRCPair crcp = {&(*it), a, 0, 0};
+			crcs.push_back(crcp);
+		}
+
+	#if !defined(DEDICATED) && !defined(UNITSYNC)
+		Watchdog::ClearTimer(WDT_MAIN);
+	#endif
 	}
 
-	// Compute CRCs of the files
-	// Hint: Multithreading only speedups `.sdd` loading. For those the CRC generation is extremely slow -
+#if !defined(DEDICATED) && !defined(UNITSYNC)
+	// only the calling thread may touch its watchdog timer, for_mt
+	// also runs part of the work on it while waiting for the pool
+	const Threading::NativeThreadId callerThreadId = Threading::GetCurrentThreadId();
+#endif
+
+	// Compute CRCs of the files of all archives in one go
+	// Hint: Multithreading mostly speeds up `.sdd` loading. For those the CRC generation is extremely slow -
 	//       it has to load the full file to calc it! For the other formats (sd7, sdz, sdp) the CRC is saved
-	//       in the metainformation of the container and so the loading is much faster. Neither does any of our
-	//       current (2011) packing libraries support multithreading :/
+	//       in the metainformation of the container and so the loading is much faster.
 	for_mt(0, crcs.size(), [&](const int i) {
 		CRCPair& crcp = crcs[i];
-		const unsigned int nameCRC = CRC().Update(crcp.filename->data(), crcp.filename->size()).GetDigest();
+		IArchive* ar = archives[crcp.archive].get();
 		const unsigned fid = ar->FindFile(*crcp.filename);
-		const unsigned int dataCRC = ar->GetCrc32(fid);
-		crcp.nameCRC = nameCRC;
-		crcp.dataCRC = dataCRC;
+
+		crcp.nameCRC = CRC().Update(crcp.filename->data(), crcp.filename->size()).GetDigest();
+		crcp.dataCRC = ar->GetCrc32(fid);
+
 	#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer(WDT_MAIN);
+		if (Threading::NativeThreadIdsEqual(Threading::GetCurrentThreadId(), callerThreadId))
+			Watchdog::ClearTimer(WDT_MAIN);
 	#endif
 	});
 
-	// Add file CRCs to the main archive CRC
-	for (std::vector<CRCPair>::iterator it = crcs.begin(); it != crcs.end(); ++it) {
-		crc.Update(it->nameCRC);
-		crc.Update(it->dataCRC);
-	#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer();
-	#endif
+	// Add file CRCs to the archive CRCs, crcs is ordered by archive
+	for (size_t i = 0; i < crcs.size(); ) {
+		const unsigned int a = crcs[i].archive;
+		CRC crc;
+
+		for (; i < crcs.size() && crcs[i].archive == a; ++i) {
+			crc.Update(crcs[i].nameCRC);
+			crc.Update(crcs[i].dataCRC);
+		}
+
+		checksums[a] = crc.GetDigest();
 	}
 
-	unsigned int digest = crc.GetDigest();
+	for (unsigned int a = 0; a < arcNames.size(); ++a) {
+		if (!archives[a])
+			continue;
 
-	// A value of 0 is used to indicate no crc.. so never return that
-	// Shouldn't happen all that often
-	if (digest == 0) {
-		return 4711;
-	} else {
-		return digest;
+		// A value of 0 is used to indicate no crc.. so never return that
+		// Shouldn't happen all that often
+		if (checksums[a] == 0)
+			checksums[a] = 4711;
 	}
 }
 
@@ -914,6 +1049,13 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 			++i;
 		}
 	}
+	for (std::map<std::string, DirInfo>::iterator i = dirInfos.begin(); i != dirInfos.end(); ) {
+		if (!i->second.updated) {
+			i = set_erase(dirInfos, i);
+		} else {
+			++i;
+		}
+	}
 
 	fprintf(out, "local archiveCache = {\n\n");
 	fprintf(out, "\tinternalver = %i,\n\n", INTERNAL_VER);
@@ -998,7 +1140,288 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 	if (fclose(out) == EOF)
 		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
 
+	WriteBinaryCacheData(GetBinaryCacheFilename(filename));
+
+	isDirty = false;
+}
+
+
+
+/*
+ * Binary archive cache
+ *
+ * Holds the same data as ArchiveCache.lua plus the directory listings, in
+ * native byte order (a mismatch just fails the magic check); parsing the
+ * Lua version takes much longer with thousands of archives installed.
+ */
+namespace {
+	const boost::uint32_t BINARY_CACHE_MAGIC = 0x53414342; // "SACB"
+
+	class CacheWriter {
+	public:
+		void WriteInt(boost::uint32_t i) { buf.append(reinterpret_cast<const char*>(&i), sizeof(i)); }
+		void WriteString(const std::string& s) { WriteInt(s.size()); buf.append(s); }
+		void WriteStrings(const std::vector<std::string>& v) {
+			WriteInt(v.size());
+			for (const std::string& s: v) {
+				WriteString(s);
+			}
+		}
+
+		const std::string& GetBuffer() const { return buf; }
+
+	private:
+		std::string buf;
+	};
+
+	class CacheReader {
+	public:
+		CacheReader(const std::vector<char>& buf): buf(buf), pos(0), failed(false) {}
+
+		boost::uint32_t ReadInt() {
+			boost::uint32_t i = 0;
+			if (Check(sizeof(i))) {
+				memcpy(&i, &buf[pos], sizeof(i));
+				pos += sizeof(i);
+			}
+			return i;
+		}
+		std::string ReadString() {
+			const boost::uint32_t size = ReadInt();
+			if (!Check(size))
+				return "";
+
+			pos += size;
+			return std::string(&buf[pos - size], size);
+		}
+		void ReadStrings(std::vector<std::string>& v) {
+			const boost::uint32_t count = ReadInt();
+			v.clear();
+			for (boost::uint32_t n = 0; n < count && !failed; n++) {
+				v.push_back(ReadString());
+			}
+		}
+
+		bool Failed() const { return failed; }
+		bool AtEnd() const { return (pos == buf.size()); }
+
+	private:
+		bool Check(size_t size) {
+			failed = failed || (size > (buf.size() - pos));
+			return !failed;
+		}
+
+		const std::vector<char>& buf;
+		size_t pos;
+		bool failed;
+	};
+}
+
+std::string CArchiveScanner::GetBinaryCacheFilename(const std::string& filename)
+{
+	return FileSystem::GetDirectory(filename) + FileSystem::GetBasename(filename) + ".bin";
+}
+
+bool CArchiveScanner::ReadBinaryCacheData(const std::string& filename)
+{
+	const std::string binFilename = GetBinaryCacheFilename(filename);
+
+	struct stat luaInfo = {0};
+	struct stat binInfo = {0};
+
+	if (stat(binFilename.c_str(), &binInfo) != 0) {
+		return false;
+	}
+	// a Lua cache written later (e.g. by an older unitsync) takes precedence
+	if (stat(filename.c_str(), &luaInfo) == 0 && luaInfo.st_mtime > binInfo.st_mtime) {
+		LOG_L(L_INFO, "Binary archive cache is outdated: %s", binFilename.c_str());
+		return false;
+	}
+
+	FILE* in = fopen(binFilename.c_str(), "rb");
+	if (!in) {
+		return false;
+	}
+
+	std::vector<char> buf(binInfo.st_size);
+	const bool readFailed = (!buf.empty() && fread(&buf[0], buf.size(), 1, in) != 1);
+	fclose(in);
+
+	if (readFailed) {
+		LOG_L(L_ERROR, "Failed to read archive cache: %s", binFilename.c_str());
+		return false;
+	}
+
+	CacheReader reader(buf);
+
+	// Do not load old version caches
+	if (reader.ReadInt() != BINARY_CACHE_MAGIC || reader.ReadInt() != INTERNAL_VER) {
+		return false;
+	}
+
+	std::map<std::string, ArchiveInfo> cachedArchiveInfos;
+	std::map<std::string, BrokenArchive> cachedBrokenArchives;
+	std::map<std::string, DirInfo> cachedDirInfos;
+
+	const boost::uint32_t numArchives = reader.ReadInt();
+	for (boost::uint32_t n = 0; n < numArchives && !reader.Failed(); n++) {
+		ArchiveInfo ai;
+
+		ai.origName = reader.ReadString();
+		ai.path     = reader.ReadString();
+		ai.modified = reader.ReadInt();
+		ai.checksum = reader.ReadInt();
+		ai.updated  = false;
+
+		const boost::uint32_t numItems = reader.ReadInt();
+		for (boost::uint32_t i = 0; i < numItems && !reader.Failed(); i++) {
+			const std::string key = reader.ReadString();
+			const boost::uint32_t type = reader.ReadInt();
+
+			if (ArchiveData::IsReservedKey(key))
+				return false;
+
+			switch (type) {
+				case INFO_VALUE_TYPE_STRING: {
+					ai.archiveData.SetInfoItemValueString(key, reader.ReadString());
+				} break;
+				case INFO_VALUE_TYPE_INTEGER: {
+					ai.archiveData.SetInfoItemValueInteger(key, int(reader.ReadInt()));
+				} break;
+				case INFO_VALUE_TYPE_FLOAT: {
+					const boost::uint32_t bits = reader.ReadInt();
+					float value;
+					memcpy(&value, &bits, sizeof(value));
+					ai.archiveData.SetInfoItemValueFloat(key, value);
+				} break;
+				case INFO_VALUE_TYPE_BOOL: {
+					ai.archiveData.SetInfoItemValueBool(key, reader.ReadInt() != 0);
+				} break;
+				default: {
+					return false;
+				} break;
+			}
+		}
+
+		reader.ReadStrings(ai.archiveData.GetDependencies());
+		reader.ReadStrings(ai.archiveData.GetReplaces());
+
+		cachedArchiveInfos[StringToLower(ai.origName)] = ai;
+	}
+
+	const boost::uint32_t numBroken = reader.ReadInt();
+	for (boost::uint32_t n = 0; n < numBroken && !reader.Failed(); n++) {
+		BrokenArchive ba;
+		const std::string name = reader.ReadString();
+
+		ba.path     = reader.ReadString();
+		ba.modified = reader.ReadInt();
+		ba.updated  = false;
+		ba.problem  = reader.ReadString();
+
+		cachedBrokenArchives[name] = ba;
+	}
+
+	const boost::uint32_t numDirs = reader.ReadInt();
+	for (boost::uint32_t n = 0; n < numDirs && !reader.Failed(); n++) {
+		DirInfo di;
+		const std::string path = reader.ReadString();
+
+		di.modified = reader.ReadInt();
+		di.updated  = false;
+		reader.ReadStrings(di.archives);
+		reader.ReadStrings(di.subDirs);
+
+		cachedDirInfos[path] = di;
+	}
+
+	if (reader.Failed() || !reader.AtEnd()) {
+		LOG_L(L_ERROR, "Failed to parse archive cache: %s", binFilename.c_str());
+		return false;
+	}
+
+	archiveInfos.swap(cachedArchiveInfos);
+	brokenArchives.swap(cachedBrokenArchives);
+	dirInfos.swap(cachedDirInfos);
+
 	isDirty = false;
+	return true;
+}
+
+void CArchiveScanner::WriteBinaryCacheData(const std::string& filename)
+{
+	CacheWriter writer;
+
+	writer.WriteInt(BINARY_CACHE_MAGIC);
+	writer.WriteInt(INTERNAL_VER);
+
+	writer.WriteInt(archiveInfos.size());
+	for (std::map<std::string, ArchiveInfo>::const_iterator arcIt = archiveInfos.begin(); arcIt != archiveInfos.end(); ++arcIt) {
+		const ArchiveInfo& arcInfo = arcIt->second;
+		const ArchiveData& archData = arcInfo.archiveData;
+
+		writer.WriteString(arcInfo.origName);
+		writer.WriteString(arcInfo.path);
+		writer.WriteInt(arcInfo.modified);
+		writer.WriteInt(arcInfo.checksum);
+
+		const std::map<std::string, InfoItem>& info = archData.GetInfo();
+
+		writer.WriteInt(info.size());
+		for (std::map<std::string, InfoItem>::const_iterator ii = info.begin(); ii != info.end(); ++ii) {
+			writer.WriteString(ii->first);
+			writer.WriteInt(ii->second.valueType);
+
+			switch (ii->second.valueType) {
+				case INFO_VALUE_TYPE_STRING: {
+					writer.WriteString(ii->second.valueTypeString);
+				} break;
+				case INFO_VALUE_TYPE_INTEGER: {
+					writer.WriteInt(ii->second.value.typeInteger);
+				} break;
+				case INFO_VALUE_TYPE_FLOAT: {
+					boost::uint32_t bits;
+					memcpy(&bits, &ii->second.value.typeFloat, sizeof(bits));
+					writer.WriteInt(bits);
+				} break;
+				case INFO_VALUE_TYPE_BOOL: {
+					writer.WriteInt(ii->second.value.typeBool);
+				} break;
+			}
+		}
+
+		writer.WriteStrings(archData.GetDependencies());
+		writer.WriteStrings(archData.GetReplaces());
+	}
+
+	writer.WriteInt(brokenArchives.size());
+	for (std::map<std::string, BrokenArchive>::const_iterator bai = brokenArchives.begin(); bai != brokenArchives.end(); ++bai) {
+		writer.WriteString(bai->first);
+		writer.WriteString(bai->second.path);
+		writer.WriteInt(bai->second.modified);
+		writer.WriteString(bai->second.problem);
+	}
+
+	writer.WriteInt(dirInfos.size());
+	for (std::map<std::string, DirInfo>::const_iterator dii = dirInfos.begin(); dii != dirInfos.end(); ++dii) {
+		writer.WriteString(dii->first);
+		writer.WriteInt(dii->second.modified);
+		writer.WriteStrings(dii->second.archives);
+		writer.WriteStrings(dii->second.subDirs);
+	}
+
+	FILE* out = fopen(filename.c_str(), "wb");
+	if (!out) {
+		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
+		return;
+	}
+
+	const std::string& buf = writer.GetBuffer();
+	const bool writeFailed = (fwrite(buf.data(), buf.size(), 1, out) != 1);
+
+	if ((fclose(out) == EOF) || writeFailed) {
+		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
+	}
 }
 
 
@@ -175,10 +175,25 @@ private:
 		bool updated;
 		std::string problem;
 	};
+	/// contents of a scanned directory, valid as long as its mtime is unchanged
+	struct DirInfo
+	{
+		DirInfo()
+			: modified(0)
+			, updated(false)
+			{}
+		unsigned int modified; ///< 0 if the listing has to be redone next time
+		bool updated;
+		std::vector<std::string> archives;
+		std::vector<std::string> subDirs;
+	};
 
 private:
 	void ScanDirs(const std::vector<std::string>& dirs, bool checksum = false);
 	void Scan(const std::string& curPath, bool doChecksum);
+	void ListDir(const std::string& dirPath, DirInfo& dirInfo);
+	/// computes the missing checksums of the given archives in parallel, returns how many
+	unsigned int ChecksumArchives(const std::vector<std::string>& fullNames);
 
 	/// scan mapinfo / modinfo lua files
 	bool ScanArchiveLua(IArchive* ar, const std::string& fileName, ArchiveInfo& ai, std::string& err);
@@ -186,6 +201,11 @@ private:
 	void ReadCacheData(const std::string& filename);
 	void WriteCacheData(const std::string& filename);
 
+	/// the same data as ArchiveCache.lua (plus directory listings), without the cost of running Lua
+	bool ReadBinaryCacheData(const std::string& filename);
+	void WriteBinaryCacheData(const std::string& filename);
+	static std::string GetBinaryCacheFilename(const std::string& filename);
+
 	IFileFilter* CreateIgnoreFilter(IArchive* ar);
 
 	/**
@@ -193,10 +213,13 @@ private:
 	 * Returns 0 if file could not be opened.
 	 */
 	unsigned int GetCRC(const std::string& filename);
+	/// GetCRC for several archives, the files of all of them are checksummed in one parallel loop
+	void GetCRCs(const std::vector<std::string>& filenames, std::vector<unsigned int>& checksums);
 
 private:
 	std::map<std::string, ArchiveInfo> archiveInfos;
 	std::map<std::string, BrokenArchive> brokenArchives;
+	std::map<std::string, DirInfo> dirInfos;
 
 	bool isDirty;
 	std::string cachefile;
@@ -3,9 +3,12 @@
 
 #include "BufferedArchive.h"
 
+#include <assert.h>
+
 
 CBufferedArchive::CBufferedArchive(const std::string& name, bool cache)
 	: IArchive(name)
+	, cacheSize(0)
 {
 	caching = cache;
 }
@@ -14,24 +17,150 @@ CBufferedArchive::~CBufferedArchive()
 {
 }
 
-bool CBufferedArchive::GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+void CBufferedArchive::AddCachedFile(unsigned int fid, const FileData& data)
+{
+	FileBuffer& fb = cache[fid];
+
+	// files that would take up most of the cache on their own are not cached
+	if (data->size() > (MAX_CACHE_SIZE / 2)) {
+		fb.populated = false;
+		return;
+	}
+
+	fb.data = data;
+	fb.lruPos = lruFiles.insert(lruFiles.begin(), fid);
+	cacheSize += data->size();
+
+	while (cacheSize > MAX_CACHE_SIZE) {
+		FileBuffer& victim = cache[lruFiles.back()];
+
+		cacheSize -= victim.data->size();
+		lruFiles.pop_back();
+
+		// read it again on the next request
+		victim.data.reset();
+		victim.populated = false;
+	}
+}
+
+bool CBufferedArchive::GetFileData(unsigned int fid, FileData& data)
 {
-	boost::mutex::scoped_lock lck(archiveLock);
 	assert(IsFileId(fid));
 
+	if (fid < cache.size() && cache[fid].prefetched) {
+		FileBuffer& fb = cache[fid];
+
+		data = fb.data;
+
+		// from now on it is a regular cache entry (or gone)
+		fb.prefetched = false;
+		fb.data.reset();
+		fb.populated = caching;
+
+		if (caching)
+			AddCachedFile(fid, data);
+
+		return true;
+	}
+
 	if (!caching) {
-		return GetFileImpl(fid,buffer);
+		data.reset(new std::vector<boost::uint8_t>());
+		return GetFileImpl(fid, *data);
 	}
 
 	if (fid >= cache.size()) {
 		cache.resize(fid + 1);
 	}
-	
-	if (!cache[fid].populated) {
-		cache[fid].exists = GetFileImpl(fid, cache[fid].data);
-		cache[fid].populated = true;
+
+	FileBuffer& fb = cache[fid];
+
+	if (fb.populated) {
+		if (fb.data) {
+			lruFiles.splice(lruFiles.begin(), lruFiles, fb.lruPos);
+		}
+
+		data = fb.data;
+		return fb.exists;
+	}
+
+	data.reset(new std::vector<boost::uint8_t>());
+
+	fb.exists = GetFileImpl(fid, *data);
+	fb.populated = true;
+
+	// missing files are remembered for free
+	if (fb.exists)
+		AddCachedFile(fid, data);
+
+	return fb.exists;
+}
+
+bool CBufferedArchive::GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+
+	FileData data;
+
+	if (!GetFileData(fid, data)) {
+		buffer.clear();
+		return false;
 	}
 
-	buffer = cache[fid].data;
-	return cache[fid].exists;
+	buffer = *data;
+	return true;
+}
+
+bool CBufferedArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+
+	FileData data;
+
+	if (!GetFileData(fid, data))
+		return false;
+
+	view = CFileView(data);
+	return true;
+}
+
+
+bool CBufferedArchive::IsFileCached(unsigned int fid)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+	assert(IsFileId(fid));
+
+	return (fid < cache.size() && cache[fid].populated && cache[fid].data);
+}
+
+void CBufferedArchive::AddPrefetchedFile(unsigned int fid, const FileData& data)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+	assert(IsFileId(fid));
+
+	if (fid >= cache.size()) {
+		cache.resize(fid + 1);
+	}
+
+	FileBuffer& fb = cache[fid];
+
+	// fetched (and cached) in the meantime
+	if (fb.populated)
+		return;
+
+	fb.populated = true;
+	fb.exists = true;
+	fb.prefetched = true;
+	fb.data = data;
+}
+
+void CBufferedArchive::ReleasePrefetchedFiles()
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+
+	for (size_t n = 0; n < cache.size(); n++) {
+		if (!cache[n].prefetched)
+			continue;
+
+		cache[n] = FileBuffer();
+	}
 }
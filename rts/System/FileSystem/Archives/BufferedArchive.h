@@ -3,7 +3,8 @@
 #ifndef _BUFFERED_ARCHIVE_H
 #define _BUFFERED_ARCHIVE_H
 
-#include <map>
+#include <list>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include "IArchive.h"
@@ -11,6 +12,14 @@
 /**
  * Provides a helper implementation for archive types that can only uncompress
  * one file to memory at a time.
+ *
+ * Uncompressed files are kept in a cache that is bounded by MAX_CACHE_SIZE
+ * bytes and drops the least recently used ones first; views handed out by
+ * GetFileView share the cached buffers and keep them alive after eviction.
+ *
+ * Files can also be decompressed ahead of time from other threads through
+ * IFileReader handles (see CVFSHandler::PrefetchFiles); these are kept
+ * outside of the cache bound until they are fetched for the first time.
  */
 class CBufferedArchive : public IArchive
 {
@@ -19,20 +28,63 @@ public:
 	virtual ~CBufferedArchive();
 
 	virtual bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
+
+	/// bytes of uncompressed files cached per archive
+	static const size_t MAX_CACHE_SIZE = 32 * 1024 * 1024;
+
+	typedef boost::shared_ptr< std::vector<boost::uint8_t> > FileData;
+
+	/**
+	 * Handle on the archive with its own file handle and decompression
+	 * state, so that several threads can read files at the same time.
+	 */
+	class IFileReader
+	{
+	public:
+		virtual ~IFileReader() {}
+		virtual bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer) = 0;
+	};
+
+	/// returns NULL if files of this archive can not be read concurrently
+	virtual IFileReader* OpenFileReader() { return NULL; }
+	/**
+	 * Files with the same group are decompressed together (eg. the files
+	 * of a solid block) and should be read by the same IFileReader.
+	 */
+	virtual unsigned int GetFileGroup(unsigned int fid) const { return fid; }
+
+	/// true if the file is cached or was prefetched
+	bool IsFileCached(unsigned int fid);
+	/// keeps the contents of a file read by an IFileReader until fetched
+	void AddPrefetchedFile(unsigned int fid, const FileData& data);
+	/// drops prefetched files that were never fetched
+	void ReleasePrefetchedFiles();
 
 protected:
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer) = 0;
 
 	boost::mutex archiveLock; // neither 7zip nor zlib are threadsafe
+
+private:
+	/// archiveLock must be held
+	bool GetFileData(unsigned int fid, FileData& data);
+	/// archiveLock must be held
+	void AddCachedFile(unsigned int fid, const FileData& data);
+
 	struct FileBuffer
 	{
-		FileBuffer() : populated(false), exists(false) {};
+		FileBuffer() : populated(false), exists(false), prefetched(false) {};
 		bool populated; // cause a file may be 0 bytes big
 		bool exists;
-		std::vector<boost::uint8_t> data;
+		bool prefetched; // not fetched yet, not in lruFiles
+		FileData data;
+		std::list<unsigned int>::iterator lruPos; // valid while data is set and not prefetched
 	};
 	std::vector<FileBuffer> cache; // cache[fileId]
-private:
+	std::list<unsigned int> lruFiles; // most recently used first
+	size_t cacheSize;
+
 	bool caching;
 };
 
@@ -9,6 +9,7 @@
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/Util.h"
 
 
@@ -77,6 +78,21 @@ bool CDirArchive::GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
 	}
 }
 
+bool CDirArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	assert(IsFileId(fid));
+
+	const std::string rawpath = dataDirsAccess.LocateFile(dirName + searchFiles[fid]);
+	const boost::shared_ptr<CMappedFile> mapping(new CMappedFile(rawpath));
+
+	// empty files can not be mapped, GetFile handles them (and errors)
+	if (!mapping->IsOpen())
+		return IArchive::GetFileView(fid, view);
+
+	view = CFileView(mapping);
+	return true;
+}
+
 void CDirArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
 {
 	assert(IsFileId(fid));
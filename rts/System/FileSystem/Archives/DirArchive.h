@@ -36,6 +36,7 @@ public:
 	
 	virtual unsigned int NumFiles() const;
 	virtual bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
 	
 private:
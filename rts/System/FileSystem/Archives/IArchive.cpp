@@ -63,3 +63,24 @@ bool IArchive::GetFile(const std::string& name, std::vector<boost::uint8_t>& buf
 
 	return found;
 }
+
+bool IArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	boost::shared_ptr< std::vector<boost::uint8_t> > buffer(new std::vector<boost::uint8_t>());
+
+	if (!GetFile(fid, *buffer))
+		return false;
+
+	view = CFileView(buffer);
+	return true;
+}
+
+bool IArchive::GetFileView(const std::string& name, CFileView& view)
+{
+	const unsigned int fid = FindFile(name);
+
+	if (fid >= NumFiles())
+		return false;
+
+	return GetFileView(fid, view);
+}
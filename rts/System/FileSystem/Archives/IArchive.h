@@ -8,6 +8,8 @@
 #include <map>
 #include <boost/cstdint.hpp>
 
+#include "System/FileSystem/FileView.h"
+
 /**
  * @brief Abstraction of different archive types
  *
@@ -72,6 +74,21 @@ public:
 	 * @see GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
 	 */
 	bool GetFile(const std::string& name, std::vector<boost::uint8_t>& buffer);
+	/**
+	 * Fetches a read-only view of the content of a file by its ID.
+	 * Archives that can serve files without copying them (mapped
+	 * directory files, cached buffers) override this; the default
+	 * implementation wraps a buffer filled by GetFile.
+	 * @param fid file ID in [0, NumFiles())
+	 * @param view on success, this will refer to the contents of the file
+	 * @return true if the file was found and could be read
+	 */
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
+	/**
+	 * Fetches a read-only view of the content of a file by its name.
+	 * @see GetFileView(unsigned int fid, CFileView& view)
+	 */
+	bool GetFileView(const std::string& name, CFileView& view);
 	/**
 	 * Fetches the name and size in bytes of a file by its ID.
 	 */
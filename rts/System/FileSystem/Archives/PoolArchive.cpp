@@ -13,6 +13,7 @@
 
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/MappedFile.h"
 #include "System/Util.h"
 #include "System/Log/ILog.h"
 
@@ -116,11 +117,9 @@ unsigned int CPoolArchive::GetCrc32(unsigned int fid)
 }
 
 
-bool CPoolArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+std::string CPoolArchive::GetPoolFilePath(unsigned int fid) const
 {
-	assert(IsFileId(fid));
-
-	FileData* f = files[fid];
+	const FileData* f = files[fid];
 
 	char table[] = "0123456789abcdef";
 	char c_hex[32];
@@ -136,7 +135,47 @@ bool CPoolArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& bu
 	std::string rpath = accu.str();
 
 	FileSystem::FixSlashes(rpath);
-	std::string path = dataDirsAccess.LocateFile(rpath);
+	return dataDirsAccess.LocateFile(rpath);
+}
+
+
+bool CPoolArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	assert(IsFileId(fid));
+
+	{
+		boost::mutex::scoped_lock lck(archiveLock);
+
+		FileData* f = files[fid];
+
+		if (f->mappable) {
+			const boost::shared_ptr<CMappedFile> mapping(new CMappedFile(GetPoolFilePath(fid)));
+
+			// gzread passes files without a gzip header through unchanged,
+			// those can be handed out directly instead of being copied
+			const unsigned char* data = mapping->GetData();
+			const bool gzipped = (mapping->GetSize() >= 2 && data[0] == 0x1f && data[1] == 0x8b);
+
+			if (mapping->IsOpen() && !gzipped && mapping->GetSize() == f->size) {
+				view = CFileView(mapping);
+				return true;
+			}
+
+			f->mappable = false;
+		}
+	}
+
+	return CBufferedArchive::GetFileView(fid, view);
+}
+
+
+bool CPoolArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+{
+	assert(IsFileId(fid));
+
+	FileData* f = files[fid];
+
+	std::string path = GetPoolFilePath(fid);
 	gzFile in = gzopen(path.c_str(), "rb");
 	if (in == NULL){
 		LOG_L(L_ERROR, "couldn't open %s", path.c_str());
@@ -157,3 +196,26 @@ bool CPoolArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& bu
 
 	return true;
 }
+
+
+class CPoolArchive::CFileReader : public CBufferedArchive::IFileReader
+{
+public:
+	CFileReader(CPoolArchive* archive): archive(archive) {}
+
+	// GetFileImpl only reads the (constant) file table
+	bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer) {
+		return archive->GetFileImpl(fid, buffer);
+	}
+
+private:
+	CPoolArchive* archive;
+};
+
+CBufferedArchive::IFileReader* CPoolArchive::OpenFileReader()
+{
+	if (!isOpen)
+		return NULL;
+
+	return new CFileReader(this);
+}
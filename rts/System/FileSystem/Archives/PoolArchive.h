@@ -83,17 +83,31 @@ public:
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
 	virtual unsigned GetCrc32(unsigned int fid);
 
+	/// files stored without gzip compression in the pool are mapped
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
+
+	/// every pool file is opened separately anyway
+	virtual IFileReader* OpenFileReader();
+
 protected:
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer);
 
+	std::string GetPoolFilePath(unsigned int fid) const;
+
 	struct FileData {
+		FileData(): mappable(true) {}
+
 		std::string name;
 		unsigned char md5[16];
 		unsigned int crc32;
 		unsigned int size;
+		/// false once the pool file turned out to be compressed
+		bool mappable;
 	};
 
 private:
+	class CFileReader;
+
 	bool isOpen;
 	std::vector<FileData*> files;
 };
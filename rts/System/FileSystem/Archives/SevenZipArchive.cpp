@@ -272,3 +272,38 @@ unsigned int CSevenZipArchive::GetCrc32(unsigned int fid)
 	assert(IsFileId(fid));
 	return fileData[fid].crc;
 }
+
+
+class CSevenZipArchive::CFileReader : public CBufferedArchive::IFileReader
+{
+public:
+	CFileReader(const std::string& name): archive(name) {}
+
+	bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer) {
+		return (archive.IsOpen() && archive.GetFileImpl(fid, buffer));
+	}
+
+private:
+	CSevenZipArchive archive;
+};
+
+CBufferedArchive::IFileReader* CSevenZipArchive::OpenFileReader()
+{
+	if (!isOpen)
+		return NULL;
+
+	return new CFileReader(GetArchiveName());
+}
+
+unsigned int CSevenZipArchive::GetFileGroup(unsigned int fid) const
+{
+	assert(IsFileId(fid));
+
+	const UInt32 folderIndex = db.FileIndexToFolderIndexMap[fileData[fid].fp];
+
+	// files without a folder are stored on their own
+	if (folderIndex == ((UInt32)-1))
+		return (db.db.NumFolders + fid);
+
+	return folderIndex;
+}
@@ -43,7 +43,14 @@ public:
 	virtual bool HasLowReadingCost(unsigned int fid) const;
 	virtual unsigned GetCrc32(unsigned int fid);
 
+	/// opens the archive once more, with its own solid block buffer
+	virtual IFileReader* OpenFileReader();
+	/// the solid block of the file
+	virtual unsigned int GetFileGroup(unsigned int fid) const;
+
 private:
+	class CFileReader;
+
 	UInt32 blockIndex;
 	Byte* outBuffer;
 	size_t outBufferSize;
@@ -101,7 +101,13 @@ bool CZipArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buf
 	}
 	assert(IsFileId(fid));
 
-	unzGoToFilePos(zip, &fileData[fid].fp);
+	return ReadFile(zip, fileData[fid], buffer);
+}
+
+bool CZipArchive::ReadFile(unzFile zip, const FileData& fd, std::vector<boost::uint8_t>& buffer)
+{
+	unz_file_pos fp = fd.fp;
+	unzGoToFilePos(zip, &fp);
 
 	unz_file_info fi;
 	unzGetCurrentFileInfo(zip, &fi, NULL, 0, NULL, 0, NULL, 0);
@@ -127,3 +133,39 @@ bool CZipArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buf
 
 	return ret;
 }
+
+
+class CZipArchive::CFileReader : public CBufferedArchive::IFileReader
+{
+public:
+	CFileReader(const CZipArchive* archive)
+		: archive(archive)
+		, zip(unzOpen(archive->GetArchiveName().c_str()))
+	{}
+	~CFileReader() {
+		if (zip) {
+			unzClose(zip);
+		}
+	}
+
+	bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer) {
+		if (!zip) {
+			return false;
+		}
+
+		return ReadFile(zip, archive->fileData[fid], buffer);
+	}
+
+private:
+	const CZipArchive* archive;
+	unzFile zip;
+};
+
+CBufferedArchive::IFileReader* CZipArchive::OpenFileReader()
+{
+	if (!zip) {
+		return NULL;
+	}
+
+	return new CFileReader(this);
+}
@@ -38,6 +38,9 @@ public:
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
 	virtual unsigned int GetCrc32(unsigned int fid);
 
+	/// opens the zip-file once more
+	virtual IFileReader* OpenFileReader();
+
 protected:
 	unzFile zip;
 
@@ -50,6 +53,11 @@ protected:
 	std::vector<FileData> fileData;
 	
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+
+	static bool ReadFile(unzFile zip, const FileData& fd, std::vector<boost::uint8_t>& buffer);
+
+private:
+	class CFileReader;
 };
 
 #endif // _ZIP_ARCHIVE_H
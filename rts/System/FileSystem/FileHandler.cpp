@@ -103,12 +103,8 @@ bool CFileHandler::TryReadFromModFS(const string& fileName)
 	}
 
 	const string file = StringToLower(fileName);
-	if (vfsHandler->LoadFile(file, fileBuffer)) {
-		// did we allocated more mem than needed
-		// (e.g. because of incorrect usage of std::vector)?
-		assert(fileBuffer.size() == fileBuffer.capacity());
-
-		fileSize = fileBuffer.size();
+	if (vfsHandler->LoadFileView(file, fileView)) {
+		fileSize = fileView.GetSize();
 		return true;
 	}
 #endif
@@ -192,13 +188,13 @@ int CFileHandler::Read(void* buf, int length)
 		ifs.read(static_cast<char*>(buf), length);
 		return ifs.gcount();
 	}
-	else if (!fileBuffer.empty()) {
+	else if (!fileView.empty()) {
 		if ((length + filePos) > fileSize) {
 			length = fileSize - filePos;
 		}
 		if (length > 0) {
-			assert(fileBuffer.size() >= (filePos + length));
-			memcpy(buf, &fileBuffer[filePos], length);
+			assert(fileView.GetSize() >= (filePos + length));
+			memcpy(buf, fileView.GetData() + filePos, length);
 			filePos += length;
 		}
 		return length;
@@ -220,7 +216,7 @@ void CFileHandler::Seek(int length, std::ios_base::seekdir where)
 		ifs.clear();
 		ifs.seekg(length, where);
 	}
-	else if (!fileBuffer.empty())
+	else if (!fileView.empty())
 	{
 		if (where == std::ios_base::beg)
 		{
@@ -244,7 +240,7 @@ bool CFileHandler::Eof() const
 	if (ifs.is_open()) {
 		return ifs.eof();
 	}
-	if (!fileBuffer.empty()) {
+	if (!fileView.empty()) {
 		return (filePos >= fileSize);
 	}
 	return true;
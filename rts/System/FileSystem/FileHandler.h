@@ -9,6 +9,7 @@
 #include <fstream>
 #include <boost/cstdint.hpp>
 
+#include "FileView.h"
 #include "VFSModes.h"
 
 /**
@@ -40,6 +41,12 @@ public:
 	int FileSize() const;
 
 	bool LoadStringData(std::string& data);
+	/**
+	 * Contents of a file that was opened from the VFS, for parsing them in
+	 * place; empty for files opened from the real file-system (use Read).
+	 * Copies of the view stay valid after this handler is destroyed.
+	 */
+	const CFileView& GetFileView() const { return fileView; }
 	std::string GetFileExt() const;
 
 	static bool InReadDir(const std::string& path);
@@ -71,7 +78,7 @@ private:
 
 	std::string fileName;
 	std::ifstream ifs;
-	std::vector<boost::uint8_t> fileBuffer;
+	CFileView fileView;
 	int filePos;
 	int fileSize;
 };
@@ -0,0 +1,51 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _FILE_VIEW_H
+#define _FILE_VIEW_H
+
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "MappedFile.h"
+
+/**
+ * Read-only contents of a (VFS) file, without owning a copy of them.
+ *
+ * The bytes either live in a memory-mapped file or in a buffer shared with
+ * an archive cache; every copy of a view holds a reference to it, so the
+ * data stays valid until the last view (not the archive) lets go of it.
+ * Callers may therefore parse files in place instead of copying them first.
+ */
+class CFileView
+{
+public:
+	CFileView(): data(NULL), size(0) {}
+
+	explicit CFileView(const boost::shared_ptr<CMappedFile>& mapping)
+		: data(mapping->GetData())
+		, size(mapping->GetSize())
+		, owner(mapping)
+	{}
+
+	explicit CFileView(const boost::shared_ptr< std::vector<boost::uint8_t> >& buffer)
+		: data(buffer->empty()? NULL: &(*buffer)[0])
+		, size(buffer->size())
+		, owner(buffer)
+	{}
+
+	const boost::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+	bool empty() const { return (size == 0); }
+	void clear() { *this = CFileView(); }
+
+private:
+	const boost::uint8_t* data;
+	size_t size;
+
+	boost::shared_ptr<const void> owner;
+};
+
+#endif // _FILE_VIEW_H
@@ -0,0 +1,97 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "MappedFile.h"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#include <windows.h>
+#endif
+
+
+CMappedFile::CMappedFile(const std::string& fileName, MapMode mapMode)
+	: data(NULL)
+	, size(0)
+	, mode(mapMode)
+#ifdef _WIN32
+	, fileHandle(INVALID_HANDLE_VALUE)
+	, mapHandle(NULL)
+#endif
+{
+#ifndef _WIN32
+	const int fd = open(fileName.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return;
+
+	struct stat info;
+
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		const int prot = (mode == MAP_COPYONWRITE)? (PROT_READ | PROT_WRITE): PROT_READ;
+		void* mem = mmap(NULL, info.st_size, prot, MAP_PRIVATE, fd, 0);
+
+		if (mem != MAP_FAILED) {
+			data = static_cast<unsigned char*>(mem);
+			size = info.st_size;
+		}
+	}
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+#else
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		return;
+
+	mapHandle = CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+	if (mapHandle == NULL)
+		return;
+
+	data = static_cast<unsigned char*>(MapViewOfFile(mapHandle, (mode == MAP_COPYONWRITE)? FILE_MAP_COPY: FILE_MAP_READ, 0, 0, 0));
+	size = (data != NULL)? size_t(fileSize.QuadPart): 0;
+#endif
+}
+
+CMappedFile::~CMappedFile()
+{
+#ifndef _WIN32
+	if (data != NULL)
+		munmap(data, size);
+#else
+	if (data != NULL)
+		UnmapViewOfFile(data);
+	if (mapHandle != NULL)
+		CloseHandle(mapHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+#endif
+}
+
+
+size_t CMappedFile::GetPageSize()
+{
+#ifndef _WIN32
+	static const size_t pageSize = sysconf(_SC_PAGESIZE);
+#else
+	static size_t pageSize = 0;
+
+	if (pageSize == 0) {
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		// views must start at multiples of this
+		pageSize = info.dwAllocationGranularity;
+	}
+#endif
+
+	return pageSize;
+}
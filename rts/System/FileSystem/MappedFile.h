@@ -0,0 +1,50 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <boost/noncopyable.hpp>
+
+/**
+ * A file mapped into memory as a whole.
+ *
+ * Pages of a read-only or copy-on-write mapping are shared by every process
+ * that maps the same file, until a process writes to one of its private
+ * (copy-on-write) pages; they are only read from disk when first accessed.
+ */
+class CMappedFile : boost::noncopyable
+{
+public:
+	enum MapMode {
+		MAP_READONLY,    ///< pages may not be written to
+		MAP_COPYONWRITE, ///< writes go to private copies of the touched pages, never to the file
+	};
+
+	CMappedFile(const std::string& fileName, MapMode mode = MAP_READONLY);
+	~CMappedFile();
+
+	bool IsOpen() const { return (data != NULL); }
+
+	const unsigned char* GetData() const { return data; }
+	/// only non-NULL for MAP_COPYONWRITE mappings
+	unsigned char* GetMutableData() { return ((mode == MAP_COPYONWRITE)? data: NULL); }
+
+	size_t GetSize() const { return size; }
+
+	/// granularity of mappings (and of the sharing thereof)
+	static size_t GetPageSize();
+
+private:
+	unsigned char* data;
+	size_t size;
+
+	MapMode mode;
+
+#ifdef _WIN32
+	void* fileHandle;
+	void* mapHandle;
+#endif
+};
+
+#endif // MAPPED_FILE_H
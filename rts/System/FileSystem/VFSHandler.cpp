@@ -8,11 +8,13 @@
 #include <cstring>
 
 #include "ArchiveLoader.h"
+#include "System/FileSystem/Archives/BufferedArchive.h"
 #include "System/FileSystem/Archives/IArchive.h"
 #include "FileSystem.h"
 #include "ArchiveScanner.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
+#include "System/ThreadPool.h"
 #include "System/Util.h"
 
 
@@ -169,6 +171,26 @@ bool CVFSHandler::LoadFile(const std::string& filePath, std::vector<boost::uint8
 	return true;
 }
 
+bool CVFSHandler::LoadFileView(const std::string& filePath, CFileView& view)
+{
+	LOG_L(L_DEBUG, "LoadFileView(filePath = \"%s\", )", filePath.c_str());
+
+	const std::string normalizedPath = GetNormalizedPath(filePath);
+
+	const FileData* fileData = GetFileData(normalizedPath);
+	if (fileData == NULL) {
+		LOG_L(L_DEBUG, "LoadFileView: File '%s' does not exist in VFS.", filePath.c_str());
+		return false;
+	}
+
+	if (!fileData->ar->GetFileView(normalizedPath, view))
+	{
+		LOG_L(L_DEBUG, "LoadFileView: File '%s' does not exist in archive.", filePath.c_str());
+		return false;
+	}
+	return true;
+}
+
 bool CVFSHandler::FileExists(const std::string& filePath)
 {
 	LOG_L(L_DEBUG, "FileExists(filePath = \"%s\", )", filePath.c_str());
@@ -189,6 +211,125 @@ bool CVFSHandler::FileExists(const std::string& filePath)
 	return true;
 }
 
+size_t CVFSHandler::PrefetchFiles(const std::vector<std::string>& dirs, size_t maxBytes)
+{
+	struct PrefetchFile {
+		unsigned int group;
+		unsigned int fid;
+		int size;
+
+		bool operator < (const PrefetchFile& f) const {
+			return ((group != f.group)? (group < f.group): (fid < f.fid));
+		}
+	};
+	struct PrefetchChunk {
+		CBufferedArchive* ar;
+		std::vector<unsigned int> fids;
+	};
+
+	std::map<CBufferedArchive*, std::vector<PrefetchFile> > archiveFiles;
+	size_t numBytes = 0;
+
+	for (std::vector<std::string>::const_iterator di = dirs.begin(); di != dirs.end(); ++di) {
+		const std::string dir = GetNormalizedPath(*di);
+
+		std::map<std::string, FileData>::const_iterator fi;
+
+		for (fi = files.lower_bound(dir); fi != files.end() && fi->first.compare(0, dir.size(), dir) == 0; ++fi) {
+			// only compressed archives need this
+			CBufferedArchive* ar = dynamic_cast<CBufferedArchive*>(fi->second.ar);
+
+			if (ar == NULL)
+				continue;
+			if ((numBytes + fi->second.size) > maxBytes)
+				continue;
+
+			const unsigned int fid = ar->FindFile(fi->first);
+
+			if (ar->IsFileCached(fid))
+				continue;
+
+			const PrefetchFile file = {ar->GetFileGroup(fid), fid, fi->second.size};
+			archiveFiles[ar].push_back(file);
+			numBytes += file.size;
+		}
+	}
+
+	// split the files of each archive into one chunk per thread; every
+	// chunk gets its own reader, and files of a group (solid block) are
+	// never split so the group is only decompressed once
+	std::vector<PrefetchChunk> chunks;
+
+	for (std::map<CBufferedArchive*, std::vector<PrefetchFile> >::iterator ai = archiveFiles.begin(); ai != archiveFiles.end(); ++ai) {
+		std::vector<PrefetchFile>& arFiles = ai->second;
+		std::sort(arFiles.begin(), arFiles.end());
+
+		size_t arBytes = 0;
+
+		for (size_t n = 0; n < arFiles.size(); n++) {
+			arBytes += arFiles[n].size;
+		}
+
+		const size_t chunkBytes = arBytes / ThreadPool::GetNumThreads() + 1;
+		size_t curChunkBytes = chunkBytes;
+
+		for (size_t n = 0; n < arFiles.size(); n++) {
+			if (curChunkBytes >= chunkBytes && (n == 0 || arFiles[n].group != arFiles[n - 1].group)) {
+				chunks.push_back(PrefetchChunk());
+				chunks.back().ar = ai->first;
+				curChunkBytes = 0;
+			}
+
+			chunks.back().fids.push_back(arFiles[n].fid);
+			curChunkBytes += arFiles[n].size;
+		}
+	}
+
+	std::vector<size_t> chunkBytes(chunks.size(), 0);
+
+	for_mt(0, chunks.size(), [&](const int i) {
+		PrefetchChunk& chunk = chunks[i];
+		CBufferedArchive::IFileReader* reader = chunk.ar->OpenFileReader();
+
+		if (reader == NULL)
+			return;
+
+		for (size_t n = 0; n < chunk.fids.size(); n++) {
+			const CBufferedArchive::FileData data(new std::vector<boost::uint8_t>());
+
+			if (!reader->GetFile(chunk.fids[n], *data))
+				continue;
+
+			chunk.ar->AddPrefetchedFile(chunk.fids[n], data);
+			chunkBytes[i] += data->size();
+		}
+
+		delete reader;
+	});
+
+	numBytes = 0;
+
+	for (size_t n = 0; n < chunkBytes.size(); n++) {
+		numBytes += chunkBytes[n];
+	}
+
+	LOG("[VFSHandler::%s] %u KB from %u archive(s) in %u chunk(s)", __FUNCTION__,
+		unsigned(numBytes / 1024), unsigned(archiveFiles.size()), unsigned(chunks.size()));
+
+	return numBytes;
+}
+
+void CVFSHandler::ReleasePrefetchedFiles()
+{
+	for (std::map<std::string, IArchive*>::iterator i = archives.begin(); i != archives.end(); ++i) {
+		CBufferedArchive* ar = dynamic_cast<CBufferedArchive*>(i->second);
+
+		if (ar != NULL) {
+			ar->ReleasePrefetchedFiles();
+		}
+	}
+}
+
 std::vector<std::string> CVFSHandler::GetFilesInDir(const std::string& rawDir)
 {
 	LOG_L(L_DEBUG, "GetFilesInDir(rawDir = \"%s\")", rawDir.c_str());
@@ -9,6 +9,7 @@
 #include <boost/cstdint.hpp>
 
 class IArchive;
+class CFileView;
 
 /**
  * Main API for accessing the Virtual File System (VFS).
@@ -37,6 +38,28 @@ public:
 	 * @return true if the file exists in the VFS and was successfully read
 	 */
 	bool LoadFile(const std::string& filePath, std::vector<boost::uint8_t>& buffer);
+	/**
+	 * Like LoadFile, but without copying the contents if the archive can
+	 * hand them out directly (eg. mapped files of directory archives).
+	 * @param filePath raw file path, for example "maps/myMap.smf",
+	 *   case-insensitive
+	 * @return true if the file exists in the VFS and was successfully read
+	 */
+	bool LoadFileView(const std::string& filePath, CFileView& view);
+
+	/**
+	 * Decompresses the files in the given directories of all compressed
+	 * archives ahead of them being loaded, in parallel on the ThreadPool.
+	 * Directories are taken in the given order until maxBytes of data
+	 * would be exceeded. The files stay in memory until they are loaded
+	 * or ReleasePrefetchedFiles is called.
+	 * @param dirs raw directory paths, for example "units/" (not "units"),
+	 *   case-insensitive
+	 * @return the number of (uncompressed) bytes read
+	 */
+	size_t PrefetchFiles(const std::vector<std::string>& dirs, size_t maxBytes);
+	/// drops the prefetched files that were not loaded
+	void ReleasePrefetchedFiles();
 
 	/**
 	 * Returns all the files in the given (virtual) directory without the
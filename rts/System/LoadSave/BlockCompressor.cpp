@@ -0,0 +1,147 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#include <boost/cstdint.hpp>
+
+#include "BlockCompressor.h"
+#include "System/ThreadPool.h"
+#include "System/Platform/byteorder.h"
+
+#define BLOCK_STREAM_MAGIC "CRZB"
+
+namespace {
+	struct BlockStreamHeader {
+		char magic[4];
+		boost::uint32_t numBlocks;
+		boost::uint32_t blockSize;
+		boost::uint32_t pad;
+		boost::uint64_t rawSize;
+
+		void swab() {
+			swabDWordInPlace(numBlocks);
+			swabDWordInPlace(blockSize);
+			swab64InPlace(rawSize);
+		}
+	};
+}
+
+
+namespace BlockCompressor {
+
+bool IsCompressed(const char* data, size_t size)
+{
+	return (size >= sizeof(BlockStreamHeader) && memcmp(data, BLOCK_STREAM_MAGIC, 4) == 0);
+}
+
+
+void Compress(const char* data, size_t size, std::vector<char>& out, unsigned int blockSize)
+{
+	BlockStreamHeader header;
+	memcpy(header.magic, BLOCK_STREAM_MAGIC, 4);
+	header.numBlocks = (size + blockSize - 1) / blockSize;
+	header.blockSize = blockSize;
+	header.pad = 0;
+	header.rawSize = size;
+
+	std::vector< std::vector<char> > blocks(header.numBlocks);
+
+	for_mt(0, header.numBlocks, [&](const int i) {
+		const size_t rawOffset = size_t(i) * blockSize;
+		const size_t rawSize = std::min(size - rawOffset, size_t(blockSize));
+
+		std::vector<char>& block = blocks[i];
+		uLongf blockCompressedSize = compressBound(rawSize);
+		block.resize(blockCompressedSize);
+
+		// can only fail if the buffer is too small
+		compress2(reinterpret_cast<Bytef*>(&block[0]), &blockCompressedSize, reinterpret_cast<const Bytef*>(data + rawOffset), rawSize, Z_BEST_SPEED);
+		block.resize(blockCompressedSize);
+	});
+
+	size_t outSize = sizeof(BlockStreamHeader) + blocks.size() * sizeof(boost::uint32_t);
+
+	for (size_t n = 0; n < blocks.size(); n++) {
+		outSize += blocks[n].size();
+	}
+
+	out.resize(outSize);
+
+	char* pos = &out[0];
+	const unsigned int numBlocks = header.numBlocks;
+
+	header.swab();
+	memcpy(pos, &header, sizeof(header));
+	pos += sizeof(header);
+
+	for (size_t n = 0; n < numBlocks; n++) {
+		const boost::uint32_t blockCompressedSize = swabDWord(boost::uint32_t(blocks[n].size()));
+		memcpy(pos, &blockCompressedSize, sizeof(blockCompressedSize));
+		pos += sizeof(blockCompressedSize);
+	}
+
+	for (size_t n = 0; n < numBlocks; n++) {
+		if (!blocks[n].empty())
+			memcpy(pos, &blocks[n][0], blocks[n].size());
+		pos += blocks[n].size();
+	}
+}
+
+
+bool Decompress(const char* data, size_t size, std::vector<char>& out)
+{
+	if (!IsCompressed(data, size))
+		return false;
+
+	BlockStreamHeader header;
+	memcpy(&header, data, sizeof(header));
+	header.swab();
+
+	if (header.blockSize == 0)
+		return false;
+	if (((header.rawSize + header.blockSize - 1) / header.blockSize) != header.numBlocks)
+		return false;
+	if ((size - sizeof(header)) / sizeof(boost::uint32_t) < header.numBlocks)
+		return false;
+
+	// offsets of the compressed blocks
+	std::vector<size_t> offsets(header.numBlocks + 1);
+	offsets[0] = sizeof(header) + header.numBlocks * sizeof(boost::uint32_t);
+
+	for (size_t n = 0; n < header.numBlocks; n++) {
+		boost::uint32_t blockCompressedSize;
+		memcpy(&blockCompressedSize, data + sizeof(header) + n * sizeof(blockCompressedSize), sizeof(blockCompressedSize));
+		offsets[n + 1] = offsets[n] + swabDWord(blockCompressedSize);
+	}
+
+	if (offsets[header.numBlocks] > size)
+		return false;
+
+	out.resize(header.rawSize);
+
+	std::vector<char> blockOk(header.numBlocks, 0);
+
+	for_mt(0, header.numBlocks, [&](const int i) {
+		const size_t rawOffset = size_t(i) * header.blockSize;
+		const size_t rawSize = std::min(size_t(header.rawSize) - rawOffset, size_t(header.blockSize));
+
+		uLongf blockRawSize = rawSize;
+
+		const int ret = uncompress(
+			reinterpret_cast<Bytef*>(&out[rawOffset]), &blockRawSize,
+			reinterpret_cast<const Bytef*>(data + offsets[i]), offsets[i + 1] - offsets[i]
+		);
+
+		blockOk[i] = (ret == Z_OK && blockRawSize == rawSize);
+	});
+
+	for (size_t n = 0; n < header.numBlocks; n++) {
+		if (!blockOk[n])
+			return false;
+	}
+
+	return true;
+}
+
+} // namespace BlockCompressor
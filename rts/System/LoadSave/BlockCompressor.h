@@ -0,0 +1,30 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef BLOCK_COMPRESSOR_H
+#define BLOCK_COMPRESSOR_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * zlib compression of large buffers (savegames, replay snapshots) that
+ * splits the input into independent blocks and (de)compresses them on
+ * the ThreadPool, so a 100MB game state does not take 100MB worth of
+ * single-threaded deflate time.
+ *
+ * Layout: BlockStreamHeader, numBlocks compressed block sizes, the
+ * compressed blocks; every block but the last holds blockSize raw bytes.
+ */
+namespace BlockCompressor {
+	static const unsigned int DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+	/// true if <data> starts like the output of Compress
+	bool IsCompressed(const char* data, size_t size);
+
+	void Compress(const char* data, size_t size, std::vector<char>& out, unsigned int blockSize = DEFAULT_BLOCK_SIZE);
+
+	/// returns false if <data> is not a complete compressed stream
+	bool Decompress(const char* data, size_t size, std::vector<char>& out);
+}
+
+#endif // BLOCK_COMPRESSOR_H
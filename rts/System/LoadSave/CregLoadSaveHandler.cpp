@@ -1,9 +1,12 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <fstream>
+#include <iterator>
+#include <sstream>
 
 #include "ExternalAI/EngineOutHandler.h"
 #include "CregLoadSaveHandler.h"
+#include "BlockCompressor.h"
 #include "Map/ReadMap.h"
 #include "Game/Game.h"
 #include "Game/GameSetup.h"
@@ -123,19 +126,17 @@ void CCregLoadSaveHandler::SaveGame(const std::string& file)
 		WriteString(ofs, modName);
 		WriteString(ofs, mapName);
 
-		CGameStateCollector gsc = CGameStateCollector();
+		std::ostringstream state(std::ios::out | std::ios::binary);
+		SaveState(&state);
 
-		// save creg state
-		creg::COutputStreamSerializer os;
-		os.SavePackage(&ofs, &gsc, gsc.GetClass());
-		PrintSize("Game", ofs.tellp());
+		// save it compressed (savegames without header are loaded as-is)
+		const std::string& rawState = state.str();
+		std::vector<char> compressedState;
+		BlockCompressor::Compress(rawState.data(), rawState.size(), compressedState);
+		ofs.write(&compressedState[0], compressedState.size());
 
-		// save ai state
-		int aistart = ofs.tellp();
-		eoh->Save(&ofs);
-		PrintSize("AIs", ((int)ofs.tellp()) - aistart);
-
-		//FIXME add lua state
+		PrintSize("Game", rawState.size());
+		PrintSize("Game (compressed)", compressedState.size());
 	} catch (const content_error& ex) {
 		LOG_L(L_ERROR, "Save failed(content error): %s", ex.what());
 	} catch (const std::exception& ex) {
@@ -149,6 +150,39 @@ void CCregLoadSaveHandler::SaveGame(const std::string& file)
 	}
 }
 
+void CCregLoadSaveHandler::SaveState(std::ostream* os)
+{
+	CGameStateCollector gsc = CGameStateCollector();
+
+	// save creg state
+	creg::COutputStreamSerializer oss;
+	oss.SavePackage(os, &gsc, gsc.GetClass());
+
+	// save ai state
+	eoh->Save(os);
+
+	//FIXME add lua state
+}
+
+void CCregLoadSaveHandler::LoadState(std::istream* is)
+{
+	void* pGSC = NULL;
+	creg::Class* gsccls = NULL;
+
+	// load creg state
+	creg::CInputStreamSerializer iss;
+	iss.LoadPackage(is, pGSC, gsccls);
+	assert(pGSC && gsccls == CGameStateCollector::StaticClass());
+
+	CGameStateCollector* gsc = static_cast<CGameStateCollector*>(pGSC);
+	delete gsc; // the only job of gsc is to collect gamestate data
+	gsc = NULL;
+
+	// load ai state
+	eoh->Load(is);
+}
+
+
 /// this just loads the mapname and some other early stuff
 void CCregLoadSaveHandler::LoadGameStartInfo(const std::string& file)
 {
@@ -179,20 +213,22 @@ void CCregLoadSaveHandler::LoadGame()
 {
 	ENTER_SYNCED_CODE();
 
-	void* pGSC = NULL;
-	creg::Class* gsccls = NULL;
+	const std::streampos statePos = ifs->tellg();
+	const std::vector<char> stateData((std::istreambuf_iterator<char>(*ifs)), std::istreambuf_iterator<char>());
 
-	// load creg state
-	creg::CInputStreamSerializer inputStream;
-	inputStream.LoadPackage(ifs, pGSC, gsccls);
-	assert(pGSC && gsccls == CGameStateCollector::StaticClass());
+	if (!stateData.empty() && BlockCompressor::IsCompressed(&stateData[0], stateData.size())) {
+		std::vector<char> rawState;
 
-	CGameStateCollector* gsc = static_cast<CGameStateCollector*>(pGSC);
-	delete gsc; // the only job of gsc is to collect gamestate data
-	gsc = NULL;
+		if (!BlockCompressor::Decompress(&stateData[0], stateData.size(), rawState))
+			throw content_error("Savegame is damaged");
 
-	// load ai state
-	eoh->Load(ifs);
+		std::istringstream state(std::string(rawState.begin(), rawState.end()), std::ios::in | std::ios::binary);
+		LoadState(&state);
+	} else {
+		ifs->clear();
+		ifs->seekg(statePos);
+		LoadState(ifs);
+	}
 	//for (int a=0; a < teamHandler->ActiveTeams(); a++) { // For old savegames
 	//	if (teamHandler->Team(a)->isDead && eoh->IsSkirmishAI(a)) {
 	//		eoh->DestroySkirmishAI(skirmishAIId(a), 2 /* = team died */);
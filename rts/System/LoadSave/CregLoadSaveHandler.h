@@ -5,6 +5,7 @@
 
 #include <string>
 #include <fstream>
+#include <iosfwd>
 #include "LoadSaveHandler.h"
 
 class CCregLoadSaveHandler : public ILoadSaveHandler
@@ -17,6 +18,14 @@ public:
 	void LoadGameStartInfo(const std::string& file);
 	void LoadGame();
 
+	/**
+	 * Writes / reads the creg and AI state only, without the savegame
+	 * header; used by SaveGame and LoadGame, and for in-memory snapshots
+	 * (see CReplaySnapshots). LoadState must be called inside synced code.
+	 */
+	static void SaveState(std::ostream* os);
+	static void LoadState(std::istream* is);
+
 protected:
 	std::ifstream* ifs;
 };
@@ -14,12 +14,17 @@ CONFIG(bool, DisableDemoVersionCheck).defaultValue(false).description("Allow to
 
 #include <limits.h>
 #include <stdexcept>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <zlib.h>
 
 
 CDemoReader::CDemoReader(const std::string& filename, float curTime)
 	: playbackDemo(NULL)
+	, blockDataPos(0)
+	, keyFrameIndexLoaded(false)
+	, numFrames(-1)
 {
 	playbackDemo = new CFileHandler(filename, SPRING_VFS_PWD_ALL);
 
@@ -58,26 +63,30 @@ CDemoReader::CDemoReader(const std::string& filename, float curTime)
 		delete[] buf;
 	}
 
-	playbackDemo->Read((char*)&chunkHeader, sizeof(chunkHeader));
-	chunkHeader.swab();
-
-	demoTimeOffset = curTime - chunkHeader.modGameTime - 0.1f;
-	nextDemoReadTime = curTime - 0.01f;
-
-	long curPos = playbackDemo->GetPos();
+	streamStart = playbackDemo->GetPos();
 	playbackDemo->Seek(0, std::ios::end);
 	playbackDemoSize = playbackDemo->GetPos();
+	playbackDemo->Seek(streamStart);
+
 	if (fileHeader.demoStreamSize != 0) {
-		bytesRemaining = fileHeader.demoStreamSize;
+		streamEnd = streamStart + fileHeader.demoStreamSize;
 	}
 	else {
 		// Spring crashed while recording the demo: replay until EOF,
 		// but at most filesize bytes to block watching demo of running game.
-		// For this we must determine the file size.
-		// (if this had still used CFileHandler that would have been easier ;-))
-		bytesRemaining = playbackDemoSize - curPos;
+		streamEnd = playbackDemoSize;
 	}
-	playbackDemo->Seek(curPos);
+
+	bytesRemaining = streamEnd - streamStart;
+
+	if (!ReadStream(&chunkHeader, sizeof(chunkHeader))) {
+		memset(&chunkHeader, 0, sizeof(chunkHeader));
+		bytesRemaining = 0;
+	}
+	chunkHeader.swab();
+
+	demoTimeOffset = curTime - chunkHeader.modGameTime - 0.1f;
+	nextDemoReadTime = curTime - 0.01f;
 }
 
 
@@ -97,23 +106,21 @@ netcode::RawPacket* CDemoReader::GetData(const float readTime)
 	// check needed
 	if (readTime >= nextDemoReadTime) {
 		netcode::RawPacket* buf = new netcode::RawPacket(chunkHeader.length);
-		if (playbackDemo->Read((char*)(buf->data), chunkHeader.length) < chunkHeader.length) {
+		if (!ReadStream(buf->data, chunkHeader.length)) {
 			delete buf;
 			bytesRemaining = 0;
 			return NULL;
 		}
-		bytesRemaining -= chunkHeader.length;
 
 		if (!ReachedEnd()) {
 			// read next chunk header
-			if (playbackDemo->Read((char*)&chunkHeader, sizeof(chunkHeader)) < sizeof(chunkHeader)) {
+			if (!ReadStream(&chunkHeader, sizeof(chunkHeader))) {
 				delete buf;
 				bytesRemaining = 0;
 				return NULL;
 			}
 			chunkHeader.swab();
 			nextDemoReadTime = chunkHeader.modGameTime + demoTimeOffset;
-			bytesRemaining -= sizeof(chunkHeader);
 		}
 
 		return (readTime < 0) ? NULL : buf;
@@ -124,7 +131,10 @@ netcode::RawPacket* CDemoReader::GetData(const float readTime)
 
 bool CDemoReader::ReachedEnd()
 {
-	if (bytesRemaining <= 0 || playbackDemo->Eof() ||
+	if (blockDataPos < blockData.size())
+		return false;
+
+	if (bytesRemaining < int(sizeof(DemoStreamBlockHeader)) || playbackDemo->Eof() ||
 		(playbackDemo->GetPos() > playbackDemoSize) )
 		return true;
 	else
@@ -132,6 +142,169 @@ bool CDemoReader::ReachedEnd()
 }
 
 
+bool CDemoReader::ReadStream(void* buf, unsigned int length)
+{
+	char* dst = static_cast<char*>(buf);
+
+	while (length > 0) {
+		if (blockDataPos >= blockData.size() && !ReadBlock())
+			return false;
+
+		const unsigned int n = std::min(length, unsigned(blockData.size() - blockDataPos));
+
+		memcpy(dst, &blockData[blockDataPos], n);
+		blockDataPos += n;
+		dst += n;
+		length -= n;
+	}
+
+	return true;
+}
+
+bool CDemoReader::ReadBlock()
+{
+	DemoStreamBlockHeader blockHeader;
+
+	blockData.clear();
+	blockDataPos = 0;
+
+	if (bytesRemaining < int(sizeof(blockHeader)))
+		return false;
+	if (playbackDemo->Read((char*)&blockHeader, sizeof(blockHeader)) < int(sizeof(blockHeader)))
+		return false;
+
+	blockHeader.swab();
+	bytesRemaining -= sizeof(blockHeader);
+
+	// the last block of a crashed game's demo can be incomplete
+	if (blockHeader.rawSize == 0 || blockHeader.compressedSize == 0 || blockHeader.compressedSize > unsigned(bytesRemaining))
+		return false;
+
+	compressedData.resize(blockHeader.compressedSize);
+
+	if (playbackDemo->Read(&compressedData[0], blockHeader.compressedSize) < int(blockHeader.compressedSize))
+		return false;
+
+	bytesRemaining -= blockHeader.compressedSize;
+	blockData.resize(blockHeader.rawSize);
+
+	uLongf rawSize = blockHeader.rawSize;
+	Bytef* dst = reinterpret_cast<Bytef*>(&blockData[0]);
+	const Bytef* src = reinterpret_cast<const Bytef*>(&compressedData[0]);
+
+	if (uncompress(dst, &rawSize, src, blockHeader.compressedSize) != Z_OK || rawSize != blockHeader.rawSize) {
+		LOG_L(L_WARNING, "[DemoReader::%s] corrupt demo stream block at frame %d", __FUNCTION__, blockHeader.frameNum);
+		blockData.clear();
+		return false;
+	}
+
+	return true;
+}
+
+
+void CDemoReader::LoadKeyFrameIndex()
+{
+	if (keyFrameIndexLoaded)
+		return;
+
+	keyFrameIndexLoaded = true;
+	keyFrameIndex.clear();
+
+	const int curPos = playbackDemo->GetPos();
+
+	if (fileHeader.demoStreamSize != 0 && fileHeader.keyFrameIndexSize > 0) {
+		playbackDemo->Seek(streamEnd + fileHeader.winningAllyTeamsSize + fileHeader.playerStatSize + fileHeader.teamStatSize);
+		keyFrameIndex.resize(fileHeader.keyFrameIndexSize / sizeof(DemoKeyFrameIndexEntry));
+
+		if (playbackDemo->Read((char*)&keyFrameIndex[0], keyFrameIndex.size() * sizeof(DemoKeyFrameIndexEntry)) == int(keyFrameIndex.size() * sizeof(DemoKeyFrameIndexEntry))) {
+			for (size_t n = 0; n < keyFrameIndex.size(); n++) {
+				keyFrameIndex[n].swab();
+			}
+
+			// the terminating entry holds the total frame count
+			numFrames = keyFrameIndex.back().frameNum;
+		} else {
+			keyFrameIndex.clear();
+		}
+	}
+
+	if (keyFrameIndex.empty()) {
+		// no index (crashed game): walk over the block headers instead,
+		// which does not require decompressing any of the blocks
+		DemoStreamBlockHeader blockHeader;
+		int blockPos = streamStart;
+
+		while ((blockPos + int(sizeof(blockHeader))) <= streamEnd) {
+			playbackDemo->Seek(blockPos);
+
+			if (playbackDemo->Read((char*)&blockHeader, sizeof(blockHeader)) < int(sizeof(blockHeader)))
+				break;
+
+			blockHeader.swab();
+
+			DemoKeyFrameIndexEntry entry;
+			entry.frameNum = blockHeader.frameNum;
+			entry.streamOffset = blockPos - streamStart;
+			keyFrameIndex.push_back(entry);
+
+			blockPos += (sizeof(blockHeader) + blockHeader.compressedSize);
+		}
+
+		numFrames = -1;
+	}
+
+	playbackDemo->Seek(curPos);
+}
+
+int CDemoReader::GetNumFrames()
+{
+	LoadKeyFrameIndex();
+	return numFrames;
+}
+
+int CDemoReader::SeekToFrame(int frameNum)
+{
+	LoadKeyFrameIndex();
+
+	// the terminating entry does not refer to a block
+	const size_t numBlocks = keyFrameIndex.size() - (numFrames >= 0);
+
+	if (numBlocks == 0 || keyFrameIndex[0].frameNum > frameNum)
+		return -1;
+
+	// last block that starts at or before frameNum
+	size_t lo = 0;
+	size_t hi = numBlocks;
+
+	while ((hi - lo) > 1) {
+		const size_t mid = (lo + hi) / 2;
+
+		if (keyFrameIndex[mid].frameNum <= frameNum) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	const DemoKeyFrameIndexEntry& entry = keyFrameIndex[lo];
+
+	playbackDemo->Seek(streamStart + entry.streamOffset);
+	bytesRemaining = streamEnd - (streamStart + entry.streamOffset);
+	blockData.clear();
+	blockDataPos = 0;
+
+	if (!ReadStream(&chunkHeader, sizeof(chunkHeader))) {
+		bytesRemaining = 0;
+		return -1;
+	}
+
+	chunkHeader.swab();
+	nextDemoReadTime = chunkHeader.modGameTime + demoTimeOffset;
+
+	return entry.frameNum;
+}
+
+
 void CDemoReader::LoadStats()
 {
 	// Stats are not available if Spring crashed while writing the demo.
@@ -140,7 +313,7 @@ void CDemoReader::LoadStats()
 	}
 
 	const int curPos = playbackDemo->GetPos();
-	playbackDemo->Seek(fileHeader.headerSize + fileHeader.scriptSize + fileHeader.demoStreamSize);
+	playbackDemo->Seek(streamEnd);
 
 	winningAllyTeams.clear();
 	playerStats.clear();
@@ -55,6 +55,22 @@ public:
 	/// Not needed for normal demo watching
 	void LoadStats();
 
+	/**
+	@brief move the read position to the start of the last stream block at or before frameNum
+	@return the number of frames in the stream before the new read position, or -1 on failure
+	The next packet read is then the NETMSG_NEWFRAME or NETMSG_KEYFRAME of the following frame
+	(unless the position is at the start of the stream). Only the target block is decompressed.
+	*/
+	int SeekToFrame(int frameNum);
+
+	/// total number of frames in the demo stream, -1 if unknown (demo of a crashed game)
+	int GetNumFrames();
+
+private:
+	bool ReadStream(void* buf, unsigned int length);
+	bool ReadBlock();
+	void LoadKeyFrameIndex();
+
 private:
 	CFileHandler* playbackDemo;
 
@@ -63,6 +79,20 @@ private:
 	int bytesRemaining;
 	int playbackDemoSize;
 
+	/// file offsets of the demo stream
+	int streamStart;
+	int streamEnd;
+
+	/// decompressed contents of the current stream block
+	std::vector<char> blockData;
+	std::vector<char> compressedData;
+	unsigned int blockDataPos;
+
+	/// one entry per stream block, plus a terminating one if numFrames is known
+	std::vector<DemoKeyFrameIndexEntry> keyFrameIndex;
+	bool keyFrameIndexLoaded;
+	int numFrames;
+
 	DemoStreamChunkHeader chunkHeader;
 
 	std::string setupScript;	// the original, unaltered version from script
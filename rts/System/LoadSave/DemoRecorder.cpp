@@ -11,27 +11,58 @@
 #include "System/TimeUtil.h"
 
 #include "System/Log/ILog.h"
+#include "System/Platform/Threading.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+#include "Sim/Misc/GlobalConstants.h"
 
 #include <cassert>
 #include <cerrno>
 #include <cstring>
-#include <fstream>
+#include <zlib.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// blocks end at the first frame after reaching either limit; this bounds
+// how much of the demo is lost on a crash as well as the distance between
+// two seek points
+static const unsigned int BLOCK_FLUSH_SIZE = 256 * 1024;
+static const int BLOCK_FLUSH_FRAMES = GAME_SPEED * 5;
+
 
 CDemoRecorder::CDemoRecorder(const std::string& mapName, const std::string& modName, bool serverDemo):
-demoStream(std::ios::binary | std::ios::out)
+	demoStreamSize(0),
+	writerThread(NULL),
+	stopWriter(false),
+	numFrames(0)
 {
+	memset(&blockHeader, 0, sizeof(blockHeader));
+
 	SetName(mapName, modName, serverDemo);
 	SetFileHeader();
+
+	demoFile.open(dataDirsAccess.LocateFile(demoName, FileQueryFlags::WRITE).c_str(), std::ios::binary | std::ios::out);
+
+	if (!demoFile.is_open())
+		LOG_L(L_ERROR, "[%s] could not open demo file %s for writing", __FUNCTION__, demoName.c_str());
+
+	StartWriterThread();
+	WriteFileHeader(false);
 }
 
 CDemoRecorder::~CDemoRecorder()
 {
 	LOG("Writing demo: %s", GetName().c_str());
+
+	FlushBlock();
+	StopWriterThread();
+
 	WriteWinnerList();
 	WritePlayerStats();
 	WriteTeamStats();
+	WriteKeyFrameIndex();
 	WriteFileHeader(true);
-	WriteDemoFile(dataDirsAccess.LocateFile(demoName, FileQueryFlags::WRITE), demoStream.str());
+
+	demoFile.close();
 }
 
 void CDemoRecorder::SetFileHeader()
@@ -46,46 +77,173 @@ void CDemoRecorder::SetFileHeader()
 	fileHeader.teamStatElemSize = sizeof(TeamStatistics);
 	fileHeader.teamStatPeriod = TeamStatistics::statsPeriod;
 	fileHeader.winningAllyTeamsSize = 0;
-
-	demoStream.seekp(WriteFileHeader(false) + sizeof(DemoFileHeader));
-}
-
-void CDemoRecorder::WriteDemoFile(const std::string& name, const std::string& data)
-{
-	std::ofstream file;
-
-	// using operator<<(basic_stringbuf*) requires the stream to be opened with std::ios::in
-	// stringbuf::{eback(), egptr(), gptr()} are protected so we cannot access them directly
-	// (plus data is not guaranteed to be stored contiguously) ==> the only clean OO solution
-	// that avoids str()'s copy would be to supply our own stringbuffer backend to demoStream
-	// which is slightly overdoing it
-	file.open(name.c_str(), std::ios::binary | std::ios::out);
-	file.write(data.c_str(), data.size());
-	file.flush();
-	file.close();
 }
 
 void CDemoRecorder::WriteSetupText(const std::string& text)
 {
 	int length = text.length();
-	while (text.c_str()[length - 1] == '\0') {
+	while (length > 0 && text.c_str()[length - 1] == '\0') {
 		--length;
 	}
 
+	// the script has to precede the demo stream in the file
+	assert(blockData.empty() && numFrames == 0);
+
 	fileHeader.scriptSize = length;
-	demoStream.write(text.c_str(), length);
+	WriteFileHeader(false);
+
+	WriteJob job;
+	job.offset = -1;
+	job.isBlock = false;
+	job.data.assign(text.c_str(), text.c_str() + length);
+
+	QueueWriteJob(job);
 }
 
 void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime)
 {
+	const bool newFrame = (length > 0) && (buf[0] == NETMSG_NEWFRAME || buf[0] == NETMSG_KEYFRAME);
+
+	if (newFrame && !blockData.empty()) {
+		if (blockData.size() >= BLOCK_FLUSH_SIZE || (numFrames - blockHeader.frameNum) >= BLOCK_FLUSH_FRAMES) {
+			FlushBlock();
+		}
+	}
+
+	if (blockData.empty()) {
+		blockHeader.frameNum = numFrames;
+		blockHeader.modGameTime = modGameTime;
+	}
+
 	DemoStreamChunkHeader chunkHeader;
 
 	chunkHeader.modGameTime = modGameTime;
 	chunkHeader.length = length;
 	chunkHeader.swab();
-	demoStream.write((char*) &chunkHeader, sizeof(chunkHeader));
-	demoStream.write((char*) buf, length);
-	fileHeader.demoStreamSize += length + sizeof(chunkHeader);
+
+	blockData.insert(blockData.end(), (const char*) &chunkHeader, (const char*) &chunkHeader + sizeof(chunkHeader));
+	blockData.insert(blockData.end(), (const char*) buf, (const char*) buf + length);
+
+	numFrames += newFrame;
+}
+
+
+void CDemoRecorder::FlushBlock()
+{
+	if (blockData.empty())
+		return;
+
+	WriteJob job;
+	job.offset = -1;
+	job.isBlock = true;
+	job.blockHeader = blockHeader;
+	job.data.swap(blockData);
+
+	QueueWriteJob(job);
+}
+
+void CDemoRecorder::QueueWriteJob(WriteJob& job)
+{
+	boost::mutex::scoped_lock lock(writeQueueMutex);
+
+	writeQueue.push_back(WriteJob());
+	writeQueue.back().offset = job.offset;
+	writeQueue.back().isBlock = job.isBlock;
+	writeQueue.back().blockHeader = job.blockHeader;
+	writeQueue.back().data.swap(job.data);
+
+	writeQueueCond.notify_one();
+}
+
+void CDemoRecorder::StartWriterThread()
+{
+	assert(writerThread == NULL);
+
+	stopWriter = false;
+	writerThread = new boost::thread(boost::bind(&CDemoRecorder::WriterThreadFunc, this));
+}
+
+void CDemoRecorder::StopWriterThread()
+{
+	if (writerThread == NULL)
+		return;
+
+	{
+		boost::mutex::scoped_lock lock(writeQueueMutex);
+		stopWriter = true;
+		writeQueueCond.notify_one();
+	}
+
+	writerThread->join();
+	delete writerThread;
+	writerThread = NULL;
+}
+
+void CDemoRecorder::WriterThreadFunc()
+{
+	Threading::SetThreadName("demowriter");
+
+	WriteJob job;
+
+	while (true) {
+		{
+			boost::mutex::scoped_lock lock(writeQueueMutex);
+
+			while (writeQueue.empty() && !stopWriter)
+				writeQueueCond.wait(lock);
+
+			// the queue is always drained before exiting
+			if (writeQueue.empty())
+				break;
+
+			job.offset = writeQueue.front().offset;
+			job.isBlock = writeQueue.front().isBlock;
+			job.blockHeader = writeQueue.front().blockHeader;
+			job.data.swap(writeQueue.front().data);
+			writeQueue.pop_front();
+		}
+
+		if (job.isBlock) {
+			WriteBlock(job);
+		} else if (job.data.empty()) {
+			// eg. WriteSetupText with an empty script, nothing to write
+		} else if (job.offset >= 0) {
+			demoFile.seekp(job.offset);
+			demoFile.write(&job.data[0], job.data.size());
+			demoFile.seekp(0, std::ios::end);
+		} else {
+			demoFile.write(&job.data[0], job.data.size());
+		}
+
+		// keep everything written so far readable if we crash
+		demoFile.flush();
+	}
+}
+
+void CDemoRecorder::WriteBlock(const WriteJob& job)
+{
+	uLongf compressedSize = compressBound(job.data.size());
+	std::vector<Bytef> compressed(compressedSize);
+
+	if (compress2(&compressed[0], &compressedSize, reinterpret_cast<const Bytef*>(&job.data[0]), job.data.size(), Z_BEST_SPEED) != Z_OK) {
+		LOG_L(L_ERROR, "[%s] could not compress demo stream block (frame %d)", __FUNCTION__, job.blockHeader.frameNum);
+		return;
+	}
+
+	DemoKeyFrameIndexEntry indexEntry;
+	indexEntry.frameNum = job.blockHeader.frameNum;
+	indexEntry.streamOffset = demoStreamSize;
+	keyFrameIndex.push_back(indexEntry);
+
+	DemoStreamBlockHeader blockHeader = job.blockHeader;
+	blockHeader.compressedSize = compressedSize;
+	blockHeader.rawSize = job.data.size();
+	blockHeader.swab();
+
+	demoFile.write((const char*) &blockHeader, sizeof(blockHeader));
+	demoFile.write((const char*) &compressed[0], compressedSize);
+
+	demoStreamSize += (sizeof(blockHeader) + compressedSize);
 }
 
 void CDemoRecorder::SetName(const std::string& mapName, const std::string& modName, bool serverDemo)
@@ -170,35 +328,28 @@ void CDemoRecorder::SetWinningAllyTeams(const std::vector<unsigned char>& winnin
 }
 
 /** @brief Write DemoFileHeader
-Write the DemoFileHeader at the start of the file and restores the original
-position in the file afterwards. */
-unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
+Writes the DemoFileHeader at the start of the file, through the writer thread
+while that is running. */
+void CDemoRecorder::WriteFileHeader(bool updateStreamLength)
 {
-#ifdef _MSC_VER // MSVC8 behaves strange if tell/seek is called before anything has been written
-	const bool empty = (demoStream.str() == "");
-	const unsigned int pos = empty? 0 : demoStream.tellp();
-#else
-	const unsigned int pos = demoStream.tellp();
-#endif
-
 	DemoFileHeader tmpHeader;
 	memcpy(&tmpHeader, &fileHeader, sizeof(fileHeader));
 	if (!updateStreamLength)
 		tmpHeader.demoStreamSize = 0;
 	tmpHeader.swab(); // to little endian
 
-#ifdef _MSC_VER
-	if (!empty)
-#endif
-	{
-		demoStream.seekp(0);
+	if (writerThread != NULL) {
+		WriteJob job;
+		job.offset = 0;
+		job.isBlock = false;
+		job.data.assign((const char*) &tmpHeader, (const char*) &tmpHeader + sizeof(tmpHeader));
+
+		QueueWriteJob(job);
+	} else {
+		demoFile.seekp(0);
+		demoFile.write((char*) &tmpHeader, sizeof(tmpHeader));
+		demoFile.seekp(0, std::ios::end);
 	}
-
-
-	demoStream.write((char*) &tmpHeader, sizeof(tmpHeader));
-	demoStream.seekp(pos);
-
-	return pos;
 }
 
 /** @brief Write the CPlayer::Statistics at the current position in the file. */
@@ -207,16 +358,16 @@ void CDemoRecorder::WritePlayerStats()
 	if (fileHeader.numPlayers == 0)
 		return;
 
-	int pos = demoStream.tellp();
+	int pos = demoFile.tellp();
 
 	for (std::vector< PlayerStatistics >::iterator it = playerStats.begin(); it != playerStats.end(); ++it) {
 		PlayerStatistics& stats = *it;
 		stats.swab();
-		demoStream.write(reinterpret_cast<char*>(&stats), sizeof(PlayerStatistics));
+		demoFile.write(reinterpret_cast<char*>(&stats), sizeof(PlayerStatistics));
 	}
 	playerStats.clear();
 
-	fileHeader.playerStatSize = (int)demoStream.tellp() - pos;
+	fileHeader.playerStatSize = (int)demoFile.tellp() - pos;
 }
 
 
@@ -227,16 +378,16 @@ void CDemoRecorder::WriteWinnerList()
 	if (fileHeader.numTeams == 0)
 		return;
 
-	const int pos = demoStream.tellp();
+	const int pos = demoFile.tellp();
 
 	// Write the array of winningAllyTeams.
 	for (std::vector<unsigned char>::const_iterator it = winningAllyTeams.begin(); it != winningAllyTeams.end(); ++it) {
-		demoStream.write((char*) &(*it), sizeof(unsigned char));
+		demoFile.write((char*) &(*it), sizeof(unsigned char));
 	}
 
 	winningAllyTeams.clear();
 
-	fileHeader.winningAllyTeamsSize = int(demoStream.tellp()) - pos;
+	fileHeader.winningAllyTeamsSize = int(demoFile.tellp()) - pos;
 }
 
 /** @brief Write the TeamStatistics at the current position in the file. */
@@ -245,12 +396,12 @@ void CDemoRecorder::WriteTeamStats()
 	if (fileHeader.numTeams == 0)
 		return;
 
-	int pos = demoStream.tellp();
+	int pos = demoFile.tellp();
 
 	// Write array of dwords indicating number of TeamStatistics per team.
 	for (std::vector< std::vector< TeamStatistics > >::iterator it = teamStats.begin(); it != teamStats.end(); ++it) {
 		unsigned int c = swabDWord(it->size());
-		demoStream.write((char*)&c, sizeof(unsigned int));
+		demoFile.write((char*)&c, sizeof(unsigned int));
 	}
 
 	// Write big array of TeamStatistics.
@@ -258,10 +409,33 @@ void CDemoRecorder::WriteTeamStats()
 		for (std::vector< TeamStatistics >::iterator it2 = it->begin(); it2 != it->end(); ++it2) {
 			TeamStatistics& stats = *it2;
 			stats.swab();
-			demoStream.write(reinterpret_cast<char*>(&stats), sizeof(TeamStatistics));
+			demoFile.write(reinterpret_cast<char*>(&stats), sizeof(TeamStatistics));
 		}
 	}
 	teamStats.clear();
 
-	fileHeader.teamStatSize = (int)demoStream.tellp() - pos;
+	fileHeader.teamStatSize = (int)demoFile.tellp() - pos;
+}
+
+/** @brief Write the keyframe index at the current position in the file. */
+void CDemoRecorder::WriteKeyFrameIndex()
+{
+	const int pos = demoFile.tellp();
+
+	fileHeader.demoStreamSize = demoStreamSize;
+
+	// terminating entry, holds the total number of frames
+	DemoKeyFrameIndexEntry endEntry;
+	endEntry.frameNum = numFrames;
+	endEntry.streamOffset = demoStreamSize;
+	keyFrameIndex.push_back(endEntry);
+
+	for (std::vector<DemoKeyFrameIndexEntry>::iterator it = keyFrameIndex.begin(); it != keyFrameIndex.end(); ++it) {
+		DemoKeyFrameIndexEntry entry = *it;
+		entry.swab();
+		demoFile.write(reinterpret_cast<char*>(&entry), sizeof(DemoKeyFrameIndexEntry));
+	}
+	keyFrameIndex.clear();
+
+	fileHeader.keyFrameIndexSize = (int)demoFile.tellp() - pos;
 }
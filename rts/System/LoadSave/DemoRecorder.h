@@ -3,16 +3,29 @@
 #ifndef DEMO_RECORDER
 #define DEMO_RECORDER
 
+#include <deque>
+#include <fstream>
 #include <vector>
-#include <sstream>
 #include <list>
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include "Demo.h"
 #include "Game/Players/PlayerStatistics.h"
 #include "Sim/Misc/TeamStatistics.h"
 
+namespace boost {
+	class thread;
+}
+
 /**
  * @brief Used to record demos
+ *
+ * The demo stream is collected into blocks of a few seconds each, which
+ * are compressed and appended to the file by a background thread, so that
+ * only the most recent block is lost if the process dies before the game
+ * ends. The statistics and the keyframe index are written at the end.
  */
 class CDemoRecorder : public CDemo
 {
@@ -38,14 +51,47 @@ public:
 	void SetWinningAllyTeams(const std::vector<unsigned char>& winningAllyTeams);
 
 private:
-	unsigned int WriteFileHeader(bool updateStreamLength);
+	/// a write request for the writer thread
+	struct WriteJob {
+		/// file offset of <data>, or -1 to append it
+		int offset;
+		/// whether <data> is a raw demo stream block that should be compressed
+		bool isBlock;
+
+		DemoStreamBlockHeader blockHeader;
+		std::vector<char> data;
+	};
+
+	void WriteFileHeader(bool updateStreamLength);
 	void SetFileHeader();
 	void WritePlayerStats();
 	void WriteTeamStats();
 	void WriteWinnerList();
-	void WriteDemoFile(const std::string& name, const std::string& data);
+	void WriteKeyFrameIndex();
+
+	void FlushBlock();
+	void QueueWriteJob(WriteJob& job);
+	void StartWriterThread();
+	void StopWriterThread();
+	void WriterThreadFunc();
+	void WriteBlock(const WriteJob& job);
+
+	/// only accessed by the writer thread while it is running
+	std::ofstream demoFile;
+	std::vector<DemoKeyFrameIndexEntry> keyFrameIndex;
+	unsigned int demoStreamSize;
+
+	boost::thread* writerThread;
+	boost::mutex writeQueueMutex;
+	boost::condition_variable writeQueueCond;
+	std::deque<WriteJob> writeQueue;
+	bool stopWriter;
+
+	/// the block that is currently being collected
+	std::vector<char> blockData;
+	DemoStreamBlockHeader blockHeader;
+	int numFrames;
 
-	std::stringstream demoStream;
 	std::vector<PlayerStatistics> playerStats;
 	std::vector< std::vector<TeamStatistics> > teamStats;
 	std::vector<unsigned char> winningAllyTeams;
@@ -0,0 +1,215 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <sstream>
+
+#include "ReplaySnapshots.h"
+#include "BlockCompressor.h"
+#include "CregLoadSaveHandler.h"
+#include "Game/GameSetup.h"
+#include "Game/SelectedUnitsHandler.h"
+#include "Sim/Features/Feature.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/LosHandler.h"
+#include "Sim/Projectiles/ProjectileHandler.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/EventBatchHandler.h"
+#include "System/Log/ILog.h"
+#include "System/TimeProfiler.h"
+
+CONFIG(int, ReplaySnapshotInterval)
+	.defaultValue(0)
+	.minimumValue(0)
+	.description("Minutes of game time between in-memory snapshots taken while watching a replay, used to seek with /seek. 0 disables them.");
+
+CONFIG(int, ReplaySnapshotMemory)
+	.defaultValue(512)
+	.minimumValue(1)
+	.description("Maximum memory in MB that replay snapshots may use. Older snapshots are thinned out once it is reached.");
+
+
+CReplaySnapshots::CReplaySnapshots(int intervalFrames, size_t maxMemory)
+	: intervalFrames(intervalFrames)
+	, maxMemory(maxMemory)
+	, memoryUsage(0)
+	, restoring(false)
+{
+	assert(intervalFrames > 0);
+}
+
+CReplaySnapshots::~CReplaySnapshots()
+{
+}
+
+
+CReplaySnapshots* CReplaySnapshots::Create()
+{
+	if (gameSetup == NULL || !gameSetup->hostDemo)
+		return NULL;
+
+	const int interval = configHandler->GetInt("ReplaySnapshotInterval");
+	const int memory = configHandler->GetInt("ReplaySnapshotMemory");
+
+	if (interval <= 0)
+		return NULL;
+
+	LOG("[%s] taking a snapshot every %d minute(s), using at most %d MB", __FUNCTION__, interval, memory);
+	return new CReplaySnapshots(interval * 60 * GAME_SPEED, size_t(memory) * 1024 * 1024);
+}
+
+
+std::vector<CReplaySnapshots::Snapshot>::iterator CReplaySnapshots::FindSnapshot(int frameNum)
+{
+	std::vector<Snapshot>::iterator it = snapshots.begin();
+
+	// few enough (tens) that a linear search does not matter
+	while (it != snapshots.end() && it->frameNum < frameNum)
+		++it;
+
+	return it;
+}
+
+void CReplaySnapshots::Update(int frameNum)
+{
+	if ((frameNum % intervalFrames) != 0)
+		return;
+
+	// replaying a stretch of the demo again after seeking back
+	const std::vector<Snapshot>::iterator it = FindSnapshot(frameNum);
+
+	if (it != snapshots.end() && it->frameNum == frameNum)
+		return;
+
+	Take(frameNum);
+	Trim();
+}
+
+int CReplaySnapshots::GetSnapshotFrame(int frameNum) const
+{
+	int snapshotFrame = -1;
+
+	for (std::vector<Snapshot>::const_iterator it = snapshots.begin(); it != snapshots.end() && it->frameNum <= frameNum; ++it) {
+		snapshotFrame = it->frameNum;
+	}
+
+	return snapshotFrame;
+}
+
+
+void CReplaySnapshots::Take(int frameNum)
+{
+	SCOPED_TIMER("ReplaySnapshots::Take");
+
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+	CCregLoadSaveHandler::SaveState(&stream);
+
+	const std::string& raw = stream.str();
+
+	const std::vector<Snapshot>::iterator snapshot = snapshots.insert(FindSnapshot(frameNum), Snapshot());
+	snapshot->frameNum = frameNum;
+
+	BlockCompressor::Compress(raw.data(), raw.size(), snapshot->data);
+	memoryUsage += snapshot->data.size();
+
+	LOG_L(L_DEBUG, "[%s] frame %d: %u KB (%u KB raw), %u snapshot(s) using %u KB",
+		__FUNCTION__, frameNum, unsigned(snapshot->data.size() / 1024), unsigned(raw.size() / 1024),
+		unsigned(snapshots.size()), unsigned(memoryUsage / 1024));
+}
+
+void CReplaySnapshots::Trim()
+{
+	while (memoryUsage > maxMemory && !snapshots.empty()) {
+		// the newest one is where playback currently is, never drop it
+		// unless it alone exceeds the limit
+		size_t victim = snapshots.size() - 1;
+		int minGap = -1;
+
+		for (size_t n = 0; (n + 1) < snapshots.size(); n++) {
+			// the demo start is as good as a snapshot at frame 0
+			const int prevFrame = (n > 0)? snapshots[n - 1].frameNum: 0;
+			const int gap = snapshots[n + 1].frameNum - prevFrame;
+
+			if (minGap < 0 || gap < minGap) {
+				minGap = gap;
+				victim = n;
+			}
+		}
+
+		if (victim == (snapshots.size() - 1)) {
+			LOG_L(L_WARNING, "[%s] a single snapshot needs more than ReplaySnapshotMemory (%u MB)", __FUNCTION__, unsigned(maxMemory / (1024 * 1024)));
+		}
+
+		memoryUsage -= snapshots[victim].data.size();
+		snapshots.erase(snapshots.begin() + victim);
+	}
+}
+
+
+void CReplaySnapshots::ReBlock(CSolidObject* object)
+{
+	if (!object->IsBlocking())
+		return;
+
+	object->ClearPhysicalStateBit(CSolidObject::PSTATE_BIT_BLOCKING);
+	object->Block();
+}
+
+bool CReplaySnapshots::HasSnapshot(int frameNum)
+{
+	const std::vector<Snapshot>::iterator it = FindSnapshot(frameNum);
+	return (it != snapshots.end() && it->frameNum == frameNum);
+}
+
+bool CReplaySnapshots::Restore(int frameNum)
+{
+	if (!HasSnapshot(frameNum)) {
+		LOG_L(L_ERROR, "[%s] no snapshot of frame %d", __FUNCTION__, frameNum);
+		return false;
+	}
+
+	const std::vector<Snapshot>::iterator it = FindSnapshot(frameNum);
+
+	SCOPED_TIMER("ReplaySnapshots::Restore");
+
+	std::vector<char> raw;
+
+	if (!BlockCompressor::Decompress(&it->data[0], it->data.size(), raw)) {
+		LOG_L(L_ERROR, "[%s] could not decompress the snapshot of frame %d", __FUNCTION__, frameNum);
+		return false;
+	}
+
+	selectedUnitsHandler.ClearSelected();
+
+	// bring the world down through the regular removal paths, so every
+	// object of the abandoned timeline is freed and all render and event
+	// clients forget about it; the snapshot is then loaded into the empty
+	// handlers, like a savegame into a freshly started game
+	projectileHandler->DeleteAllProjectiles();
+	unitHandler->DeleteAllUnits();
+	featureHandler->DeleteAllFeatures();
+	losHandler->DeleteAllInstances();
+
+	std::istringstream stream(std::string(raw.begin(), raw.end()), std::ios::in | std::ios::binary);
+
+	restoring = true;
+	CCregLoadSaveHandler::LoadState(&stream);
+	restoring = false;
+
+	// the blocking map is not part of the state, the loaded objects still
+	// carry their blocking bit from when the snapshot was taken
+	for (std::list<CUnit*>::const_iterator ui = unitHandler->activeUnits.begin(); ui != unitHandler->activeUnits.end(); ++ui) {
+		ReBlock(*ui);
+	}
+
+	// units re-register themselves in CUnit::PostLoad, features do not
+	for (CFeatureSet::const_iterator fi = featureHandler->GetActiveFeatures().begin(); fi != featureHandler->GetActiveFeatures().end(); ++fi) {
+		ReBlock(*fi);
+		(eventBatchHandler->GetFeatureCreatedDestroyedEventBatch()).enqueue(*fi);
+	}
+
+	LOG("[%s] restored the snapshot of frame %d", __FUNCTION__, frameNum);
+	return true;
+}
@@ -0,0 +1,77 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef REPLAY_SNAPSHOTS_H
+#define REPLAY_SNAPSHOTS_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+class CSolidObject;
+
+/**
+ * @brief In-memory simulation snapshots for seeking in replays
+ *
+ * While a demo is played back, the complete creg state (the same data a
+ * savegame contains) is captured every ReplaySnapshotInterval minutes and
+ * kept zlib-compressed in memory. Seeking to a frame then only needs to
+ * restore the latest snapshot at or before it and simulate the remainder,
+ * instead of re-simulating everything from the current frame (or the start).
+ *
+ * Once the pool exceeds ReplaySnapshotMemory, snapshots are thinned out by
+ * dropping the one whose removal leaves the smallest gap, so the remaining
+ * ones stay spread over the whole demo; the newest one is always kept.
+ *
+ * A restore first removes every unit, feature and projectile through the
+ * regular deletion paths and then loads the snapshot into the emptied
+ * handlers. The Lua handlers are not part of the snapshot, CGame shuts
+ * them down before and starts them anew after a restore.
+ */
+class CReplaySnapshots : boost::noncopyable
+{
+public:
+	CReplaySnapshots(int intervalFrames, size_t maxMemory);
+	~CReplaySnapshots();
+
+	/// returns NULL if snapshots are disabled by the config
+	static CReplaySnapshots* Create();
+
+	/// called at the end of every SimFrame, takes a snapshot when one is due
+	void Update(int frameNum);
+
+	/// frame of the latest snapshot at or before <frameNum>, -1 if none
+	int GetSnapshotFrame(int frameNum) const;
+
+	bool HasSnapshot(int frameNum);
+
+	/// replaces the world with the snapshot taken at <frameNum>, must be called inside synced code
+	bool Restore(int frameNum);
+
+	/// true while Restore is loading a snapshot (for creg PostLoad handlers)
+	bool IsRestoring() const { return restoring; }
+
+	size_t GetNumSnapshots() const { return snapshots.size(); }
+	size_t GetMemoryUsage() const { return memoryUsage; }
+
+private:
+	struct Snapshot {
+		int frameNum;
+		std::vector<char> data; ///< BlockCompressor stream
+	};
+
+	std::vector<Snapshot>::iterator FindSnapshot(int frameNum);
+
+	void Take(int frameNum);
+	void Trim();
+
+	static void ReBlock(CSolidObject* object);
+
+	std::vector<Snapshot> snapshots; ///< sorted by frameNum
+
+	int intervalFrames;
+	size_t maxMemory;
+	size_t memoryUsage;
+
+	bool restoring;
+};
+
+#endif // REPLAY_SNAPSHOTS_H
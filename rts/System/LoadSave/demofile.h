@@ -21,7 +21,7 @@
  * The current demofile version. Only change on major modifications for which
  * appending stuff to DemoFileHeader is not sufficient.
  */
-#define DEMOFILE_VERSION 5
+#define DEMOFILE_VERSION 6
 
 #pragma pack(push, 1)
 
@@ -33,13 +33,15 @@
  * - DemoFileHeader
  *   - Data chunks:
  *     - Startscript (scriptSize)
- *     - Demo stream (demoStreamSize)
+ *     - Demo stream (demoStreamSize), see DemoStreamBlockHeader
+ *     - Winning ally teams, one byte for each ally team (winningAllyTeamsSize)
  *     - Player statistics, one PlayerStatistic for each player
  *     - Team statistics, consisting of:
  *       - Array of numTeams dwords indicating the number of
  *         CTeam::Statistics for each team.
  *       - Array of all CTeam::Statistics (total number of items is the
  *         sum of the elements in the array of dwords).
+ *     - Keyframe index (keyFrameIndexSize), see DemoKeyFrameIndexEntry
  *
  * The header is designed to be extensible: it contains a version field and a
  * headerSize field to support this. The version field is a major version number
@@ -48,7 +50,9 @@
  * minor version number, which happens to be equal to sizeof(DemoFileHeader).
  *
  * If Spring did not cleanup properly (crashed), the demoStreamSize is 0 and it
- * can be assumed the demo stream continues until the end of the file.
+ * can be assumed the demo stream continues until the end of the file (the last
+ * block may be incomplete then). The keyframe index is missing in that case,
+ * but can be rebuilt by walking over the block headers.
  */
 struct DemoFileHeader
 {
@@ -70,6 +74,7 @@ struct DemoFileHeader
 	int teamStatElemSize;         ///< sizeof(CTeam::Statistics)
 	int teamStatPeriod;           ///< Interval (in seconds) between team stats.
 	int winningAllyTeamsSize;     ///< The size of the vector of the winning ally teams
+	int keyFrameIndexSize;        ///< Size of the keyframe index chunk.
 
 
 	/// Change structure from host endian to little endian or vice versa.
@@ -89,6 +94,57 @@ struct DemoFileHeader
 		swabDWordInPlace(teamStatElemSize);
 		swabDWordInPlace(teamStatPeriod);
 		swabDWordInPlace(winningAllyTeamsSize);
+		swabDWordInPlace(keyFrameIndexSize);
+	}
+};
+
+/**
+ * @brief Spring demo stream block header
+ *
+ * The demo stream is written as a sequence of independently zlib-compressed
+ * blocks, each preceded by this header:
+ *
+ * - DemoStreamBlockHeader
+ * - compressedSize bytes, which inflate to rawSize bytes of demo stream chunks
+ * - DemoStreamBlockHeader
+ * - ...
+ *
+ * Chunks never span blocks, and every block except the first starts with the
+ * NETMSG_NEWFRAME or NETMSG_KEYFRAME packet of frame frameNum + 1, so reading
+ * can be started at any block.
+ */
+struct DemoStreamBlockHeader
+{
+	boost::uint32_t compressedSize; ///< Length of the compressed data following this header.
+	boost::uint32_t rawSize;        ///< Length of the data after decompression.
+	boost::int32_t frameNum;        ///< Number of frames in the stream before this block.
+	float modGameTime;              ///< Gametime of the first chunk in this block.
+
+	/// Change structure from host endian to little endian or vice versa.
+	void swab() {
+		swabDWordInPlace(compressedSize);
+		swabDWordInPlace(rawSize);
+		swabDWordInPlace(frameNum);
+		swabFloatInPlace(modGameTime);
+	}
+};
+
+/**
+ * @brief Spring demo keyframe index entry
+ *
+ * One entry for every block of the demo stream, in stream order, followed
+ * by one more entry whose frameNum is the total number of frames in the
+ * stream and whose streamOffset is demoStreamSize.
+ */
+struct DemoKeyFrameIndexEntry
+{
+	boost::int32_t frameNum;       ///< DemoStreamBlockHeader::frameNum of the block.
+	boost::uint32_t streamOffset;  ///< Offset of the block from the start of the demo stream.
+
+	/// Change structure from host endian to little endian or vice versa.
+	void swab() {
+		swabDWordInPlace(frameNum);
+		swabDWordInPlace(streamOffset);
 	}
 };
 
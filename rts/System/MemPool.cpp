@@ -1,6 +1,8 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include "System/MemPool.h"
+
+#include <algorithm>
 //#include "System/mmgr.h"
 
 CMemPool mempool;
@@ -58,3 +60,55 @@ CMemPool::~CMemPool()
 	for(std::vector<void *>::iterator i = allocated.begin(); i != allocated.end(); ++i)
 		::operator delete(*i);
 }
+
+
+
+CFixedSizeMemPool::CFixedSizeMemPool(size_t blockSize, size_t blocksPerChunk)
+	: blockSize(blockSize)
+	, blockStride(std::max(blockSize, sizeof(void*)))
+	, blocksPerChunk(blocksPerChunk)
+	, nextFree(NULL)
+{
+}
+
+CFixedSizeMemPool::~CFixedSizeMemPool()
+{
+	for (std::vector<void *>::iterator i = allocated.begin(); i != allocated.end(); ++i)
+		::operator delete(*i);
+}
+
+void* CFixedSizeMemPool::Alloc(size_t numBytes)
+{
+	if (numBytes != blockSize)
+		return ::operator new(numBytes);
+
+	if (nextFree == NULL) {
+		char* newBlock = (char*) ::operator new(blockStride * blocksPerChunk);
+		allocated.push_back(newBlock);
+
+		for (size_t i = 0; i < (blocksPerChunk - 1); ++i) {
+			*(void**)&newBlock[i * blockStride] = (void*)&newBlock[(i + 1) * blockStride];
+		}
+
+		*(void**)&newBlock[(blocksPerChunk - 1) * blockStride] = NULL;
+		nextFree = newBlock;
+	}
+
+	void* pnt = nextFree;
+	nextFree = (*(void**)pnt);
+	return pnt;
+}
+
+void CFixedSizeMemPool::Free(void* pnt, size_t numBytes)
+{
+	if (pnt == NULL) {
+		return;
+	}
+
+	if (numBytes != blockSize) {
+		::operator delete(pnt);
+	} else {
+		*(void**)pnt = nextFree;
+		nextFree = pnt;
+	}
+}
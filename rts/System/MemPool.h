@@ -36,6 +36,29 @@ private:
 	std::vector<void *> allocated;
 };
 
+/**
+ * Like CMemPool, but for blocks of a single size, which may be larger than
+ * MAX_MEM_SIZE; requests of any other size are passed on to operator new.
+ * Blocks are carved out of chunks that are only released with the pool.
+ */
+class CFixedSizeMemPool
+{
+public:
+	CFixedSizeMemPool(size_t blockSize, size_t blocksPerChunk);
+	~CFixedSizeMemPool();
+
+	void* Alloc(size_t numBytes);
+	void Free(void* pnt, size_t numBytes);
+
+private:
+	size_t blockSize;
+	size_t blockStride;
+	size_t blocksPerChunk;
+
+	void* nextFree;
+	std::vector<void *> allocated;
+};
+
 extern CMemPool mempool;
 
 #endif // _MEM_POOL_H_
@@ -0,0 +1,78 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "HeapAllocCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> numAllocs(0);
+
+static size_t simFrameStartAllocs = 0;
+static size_t simFrameAllocs = 0;
+
+
+#ifdef COUNT_HEAP_ALLOCS
+// NOTE:
+//   replaces the global allocation functions of the whole executable,
+//   which is why the build does not link tcmalloc with this enabled
+void* operator new(size_t size)
+{
+	numAllocs.fetch_add(1, std::memory_order_relaxed);
+
+	void* p = malloc(size);
+
+	if (p == NULL)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+	numAllocs.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw() { return operator new(size, std::nothrow); }
+
+void operator delete(void* p) throw() { free(p); }
+void operator delete[](void* p) throw() { free(p); }
+void operator delete(void* p, const std::nothrow_t&) throw() { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) throw() { free(p); }
+void operator delete(void* p, size_t) throw() { free(p); }
+void operator delete[](void* p, size_t) throw() { free(p); }
+#endif
+
+
+bool HeapAllocCounter::IsEnabled()
+{
+#ifdef COUNT_HEAP_ALLOCS
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t HeapAllocCounter::GetNumAllocs()
+{
+	return numAllocs.load(std::memory_order_relaxed);
+}
+
+
+void HeapAllocCounter::BeginSimFrame()
+{
+	simFrameStartAllocs = GetNumAllocs();
+}
+
+void HeapAllocCounter::EndSimFrame()
+{
+	simFrameAllocs = GetNumAllocs() - simFrameStartAllocs;
+}
+
+size_t HeapAllocCounter::GetNumSimFrameAllocs()
+{
+	return simFrameAllocs;
+}
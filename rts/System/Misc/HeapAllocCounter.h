@@ -0,0 +1,31 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef HEAP_ALLOC_COUNTER_H
+#define HEAP_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * Counts the calls of the global operator new, to measure the heap
+ * allocations made per sim frame. Only active in builds configured
+ * with COUNT_HEAP_ALLOCS, which replace operator new and delete; all
+ * counts stay zero otherwise.
+ *
+ * The counter is shared by all threads, so allocations made by the
+ * sound or network threads during a sim frame are included as well.
+ */
+namespace HeapAllocCounter {
+	bool IsEnabled();
+
+	/// operator new calls since startup
+	size_t GetNumAllocs();
+
+	/// called by CGame::SimFrame at its start and end
+	void BeginSimFrame();
+	void EndSimFrame();
+
+	/// operator new calls made during the last completed sim frame
+	size_t GetNumSimFrameAllocs();
+}
+
+#endif // HEAP_ALLOC_COUNTER_H
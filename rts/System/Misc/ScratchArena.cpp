@@ -0,0 +1,113 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ScratchArena.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+static __declspec(thread) CScratchArena* threadArena = NULL;
+#else
+static __thread CScratchArena* threadArena = NULL;
+#endif
+
+std::atomic<size_t> CScratchArena::numHeapAllocs(0);
+std::atomic<size_t> CScratchArena::numHeapBytes(0);
+
+
+CScratchArena& CScratchArena::GetThreadArena()
+{
+	// NOTE:
+	//   intentionally never freed; the arena (and its blocks) lives as
+	//   long as the thread does, and all engine threads that run queries
+	//   (main, sim, pool workers) persist until shutdown
+	if (threadArena == NULL)
+		threadArena = new CScratchArena();
+
+	return *threadArena;
+}
+
+
+CScratchArena::CScratchArena(size_t blockSize)
+	: blockSize(blockSize)
+	, curBlock(0)
+	, curOffset(0)
+{
+	blocks.reserve(16);
+}
+
+CScratchArena::~CScratchArena()
+{
+	for (size_t n = 0; n < blocks.size(); n++) {
+		delete[] blocks[n].mem;
+	}
+
+	blocks.clear();
+}
+
+
+void* CScratchArena::Alloc(size_t numBytes)
+{
+	// reserve room to align the block start as well
+	const size_t reqBytes = numBytes + ALIGNMENT;
+
+	while (curBlock < blocks.size()) {
+		const Block& block = blocks[curBlock];
+		const size_t addr = reinterpret_cast<size_t>(block.mem + curOffset);
+		const size_t pad = (ALIGNMENT - (addr & (ALIGNMENT - 1))) & (ALIGNMENT - 1);
+
+		if ((curOffset + pad + numBytes) <= block.size) {
+			char* mem = block.mem + curOffset + pad;
+			curOffset += (pad + numBytes);
+			return mem;
+		}
+
+		// skip to the next block; a Rewind past this point makes
+		// the remainder of the current one available again
+		curBlock += 1;
+		curOffset = 0;
+	}
+
+	// grow; only happens until the high-water mark is reached
+	Block block;
+	block.size = std::max(blockSize, reqBytes);
+	block.mem = new char[block.size];
+
+	blocks.push_back(block);
+
+	numHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+	numHeapBytes.fetch_add(block.size, std::memory_order_relaxed);
+
+	curBlock = blocks.size() - 1;
+	curOffset = 0;
+
+	return Alloc(numBytes);
+}
+
+
+CScratchArena::Marker CScratchArena::GetMarker() const
+{
+	Marker marker;
+	marker.block = curBlock;
+	marker.offset = curOffset;
+	return marker;
+}
+
+void CScratchArena::Rewind(const Marker& marker)
+{
+	assert(marker.block < curBlock || (marker.block == curBlock && marker.offset <= curOffset));
+
+	curBlock = marker.block;
+	curOffset = marker.offset;
+}
+
+
+size_t CScratchArena::GetNumBytesInUse() const
+{
+	size_t numBytes = curOffset;
+
+	for (size_t n = 0; n < std::min(curBlock, blocks.size()); n++) {
+		numBytes += blocks[n].size;
+	}
+
+	return numBytes;
+}
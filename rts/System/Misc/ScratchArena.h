@@ -0,0 +1,115 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+/**
+ * Fixed-capacity view of a block of scratch memory, filled by
+ * push_back. Only meant for trivially copyable element types
+ * (pointers, indices, POD structs): no constructors or destructors
+ * are ever run on the elements.
+ */
+template<typename T> class ScratchSpan
+{
+public:
+	ScratchSpan(): first(NULL), last(NULL), limit(NULL) {}
+	ScratchSpan(T* mem, size_t capacity): first(mem), last(mem), limit(mem + capacity) {}
+
+	void push_back(const T& t) { assert(last != limit); *(last++) = t; }
+	void clear() { last = first; }
+	void resize(size_t n) { assert(n <= capacity()); last = first + n; }
+
+	T* begin() const { return first; }
+	T* end() const { return last; }
+
+	T& operator [] (size_t i) const { assert(i < size()); return first[i]; }
+
+	size_t size() const { return (last - first); }
+	size_t capacity() const { return (limit - first); }
+	bool empty() const { return (last == first); }
+
+private:
+	T* first;
+	T* last;
+	T* limit;
+};
+
+
+/**
+ * Per-thread bump allocator for short-lived query results.
+ *
+ * Memory is handed out from a list of blocks that are kept for the
+ * lifetime of the owning thread, so once the arena has grown to its
+ * high-water mark no further heap allocations take place. Allocations
+ * are released in LIFO order through Scope objects; a nested Scope
+ * (e.g. a Lua call-in that queries the QuadField while an outer query
+ * result is still being iterated) never touches memory of its parent.
+ */
+class CScratchArena : boost::noncopyable
+{
+public:
+	struct Marker {
+		size_t block;
+		size_t offset;
+	};
+
+	class Scope : boost::noncopyable
+	{
+	public:
+		Scope(): arena(CScratchArena::GetThreadArena()), marker(arena.GetMarker()) {}
+		~Scope() { arena.Rewind(marker); }
+
+		template<typename T> ScratchSpan<T> Alloc(size_t count) {
+			return ScratchSpan<T>(static_cast<T*>(arena.Alloc(count * sizeof(T))), count);
+		}
+
+	private:
+		CScratchArena& arena;
+		Marker marker;
+	};
+
+public:
+	static CScratchArena& GetThreadArena();
+
+	CScratchArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+	~CScratchArena();
+
+	// returned memory is aligned to ALIGNMENT bytes
+	void* Alloc(size_t numBytes);
+
+	Marker GetMarker() const;
+	void Rewind(const Marker& marker);
+
+	size_t GetNumBlocks() const { return blocks.size(); }
+	size_t GetNumBytesInUse() const;
+
+	/// blocks allocated (and their total size) by all arenas, since startup
+	static size_t GetNumHeapAllocs() { return numHeapAllocs.load(std::memory_order_relaxed); }
+	static size_t GetNumHeapBytes() { return numHeapBytes.load(std::memory_order_relaxed); }
+
+	static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+	static const size_t ALIGNMENT = 16;
+
+private:
+	struct Block {
+		char* mem;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;
+
+	size_t blockSize;
+	size_t curBlock;
+	size_t curOffset;
+
+	static std::atomic<size_t> numHeapAllocs;
+	static std::atomic<size_t> numHeapBytes;
+};
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,178 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Hierarchical timer wheel holding items that are due at an (integer) time.
+ *
+ * The first level has one slot per time unit for the next 256 units, each
+ * further level has 64 slots that are 64 times coarser than those of the
+ * level below; items that are due in more than 2^26 units wait in an
+ * overflow list. Inserting an item is O(1), and so is advancing the wheel
+ * by one unit apart from the occasional redistribution of a coarse slot.
+ *
+ * Items are handed out ordered by their time and, for equal times, in the
+ * order they were inserted, so the result is deterministic.
+ */
+template<typename T> class CTimerWheel
+{
+public:
+	CTimerWheel(): curTime(0), numItems(0) {}
+
+	/**
+	 * Schedules item for time; items due before the current time of the
+	 * wheel are run as soon as possible.
+	 */
+	void Insert(T* item, int time) {
+		const Entry e = {item, std::max(time, curTime)};
+		GetSlot(e.time).push_back(e);
+		numItems++;
+	}
+
+	/**
+	 * Calls func(item) for all items due before endTime and removes them.
+	 * func may insert new items; those due before endTime are run as well.
+	 */
+	template<typename F> void Advance(int endTime, F func) {
+		for (; curTime < endTime; curTime++) {
+			const int index = curTime & (ROOT_SIZE - 1);
+
+			// refill the root slots from the coarser levels when they wrap
+			if (index == 0) {
+				int level = 0;
+				while (level < NUM_LEVELS && Cascade(level))
+					level++;
+				if (level == NUM_LEVELS)
+					Cascade(overflow, NUM_LEVELS);
+			}
+
+			std::vector<Entry>& slot = root[index];
+
+			// func can append to this slot, so do not hold on to elements
+			for (size_t i = 0; i < slot.size(); i++) {
+				T* item = slot[i].item;
+				numItems--;
+				func(item);
+			}
+
+			slot.clear();
+		}
+	}
+
+	/// removes all items from the wheel and appends them to items
+	void Clear(std::vector<T*>& items) {
+		for (int i = 0; i < ROOT_SIZE; i++)
+			Extract(root[i], items);
+		for (int l = 0; l < NUM_LEVELS; l++)
+			for (int i = 0; i < LEVEL_SIZE; i++)
+				Extract(levels[l][i], items);
+		Extract(overflow, items);
+
+		numItems = 0;
+	}
+
+	int GetTime() const { return curTime; }
+	size_t size() const { return numItems; }
+	bool empty() const { return (numItems == 0); }
+
+private:
+	struct Entry {
+		T* item;
+		int time;
+	};
+
+	static const int ROOT_BITS = 8;
+	static const int LEVEL_BITS = 6;
+	static const int NUM_LEVELS = 3;
+	static const int ROOT_SIZE = 1 << ROOT_BITS;
+	static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+
+	static int LevelShift(int level) { return ROOT_BITS + level * LEVEL_BITS; }
+
+	std::vector<Entry>& GetSlot(int time) {
+		// time >= curTime, so this does not overflow
+		const int delta = time - curTime;
+
+		if (delta < ROOT_SIZE)
+			return root[time & (ROOT_SIZE - 1)];
+
+		for (int l = 0; l < NUM_LEVELS; l++) {
+			if (delta < (1 << LevelShift(l + 1)))
+				return levels[l][(time >> LevelShift(l)) & (LEVEL_SIZE - 1)];
+		}
+
+		return overflow;
+	}
+
+	/**
+	 * Moves the items of the current slot of a level to the finer levels.
+	 * @return true if the level wrapped around and the next coarser one
+	 *   has to be cascaded as well
+	 */
+	bool Cascade(int level) {
+		const int index = (curTime >> LevelShift(level)) & (LEVEL_SIZE - 1);
+		Cascade(levels[level][index], level);
+		return (index == 0);
+	}
+
+	/// moves the items of a slot of level to the finer levels (or back to overflow)
+	void Cascade(std::vector<Entry>& slot, int level) {
+		if (slot.empty())
+			return;
+
+		std::vector<Entry> entries;
+		entries.swap(slot);
+
+		// The cascaded items were inserted before any item that already
+		// sits in a finer slot for the same time (those were inserted when
+		// their time was closer), so they have to end up in front of them.
+		std::vector<size_t>& sizes = cascadeSizes;
+		sizes.clear();
+
+		for (int i = 0; i < ROOT_SIZE; i++)
+			sizes.push_back(root[i].size());
+		for (int l = 0; l < level; l++)
+			for (int i = 0; i < LEVEL_SIZE; i++)
+				sizes.push_back(levels[l][i].size());
+
+		for (size_t i = 0; i < entries.size(); i++)
+			GetSlot(entries[i].time).push_back(entries[i]);
+
+		for (int i = 0; i < ROOT_SIZE; i++)
+			MoveToFront(root[i], sizes[i]);
+		for (int l = 0; l < level; l++)
+			for (int i = 0; i < LEVEL_SIZE; i++)
+				MoveToFront(levels[l][i], sizes[ROOT_SIZE + l * LEVEL_SIZE + i]);
+	}
+
+	/// moves the elements appended to slot after it had oldSize elements to its front
+	static void MoveToFront(std::vector<Entry>& slot, size_t oldSize) {
+		if (oldSize == 0 || oldSize == slot.size())
+			return;
+
+		std::rotate(slot.begin(), slot.begin() + oldSize, slot.end());
+	}
+
+	static void Extract(std::vector<Entry>& slot, std::vector<T*>& items) {
+		for (size_t i = 0; i < slot.size(); i++)
+			items.push_back(slot[i].item);
+		slot.clear();
+	}
+
+private:
+	int curTime;
+	size_t numItems;
+
+	std::vector<Entry> root[ROOT_SIZE];
+	std::vector<Entry> levels[NUM_LEVELS][LEVEL_SIZE];
+	std::vector<Entry> overflow;
+
+	std::vector<size_t> cascadeSizes;
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,204 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/SlabMemPool.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#if defined(_MSC_VER)
+static __declspec(thread) CSlabMemPool::FreeList* threadFreeLists = NULL;
+#else
+static __thread CSlabMemPool::FreeList* threadFreeLists = NULL;
+#endif
+
+int CSlabMemPool::numPools = 0;
+CSlabMemPool* CSlabMemPool::pools[MAX_POOLS];
+
+
+CSlabMemPool::CSlabMemPool(const char* name)
+	: name(name)
+	, poolIndex(numPools++)
+	, numSlabs(0)
+	, numBlocks(0)
+	, numPooledAllocs(0)
+	, numPooledFrees(0)
+	, numLargeAllocs(0)
+	, numLargeFrees(0)
+{
+	// indices are never reused, threads may still have lists for a dead pool
+	assert(poolIndex < MAX_POOLS);
+
+	pools[poolIndex] = this;
+	memset(sharedLists, 0, sizeof(sharedLists));
+}
+
+CSlabMemPool::~CSlabMemPool()
+{
+	pools[poolIndex] = NULL;
+
+	for (std::vector<void*>::iterator i = slabs.begin(); i != slabs.end(); ++i)
+		::operator delete(*i);
+}
+
+
+CSlabMemPool::FreeList& CSlabMemPool::GetThreadFreeList(int sizeClass)
+{
+	// NOTE:
+	//   intentionally never freed, like the scratch arenas; the blocks in
+	//   the lists of an exiting thread stay unused until the pool dies
+	if (threadFreeLists == NULL) {
+		threadFreeLists = new FreeList[MAX_POOLS * NUM_SIZE_CLASSES];
+		memset(threadFreeLists, 0, sizeof(FreeList) * MAX_POOLS * NUM_SIZE_CLASSES);
+	}
+
+	return threadFreeLists[poolIndex * NUM_SIZE_CLASSES + sizeClass];
+}
+
+
+void* CSlabMemPool::Alloc(size_t numBytes)
+{
+	if (numBytes == 0 || numBytes > SLAB_MAX_BLOCK_SIZE) {
+		numLargeAllocs.fetch_add(1, std::memory_order_relaxed);
+		return ::operator new(numBytes);
+	}
+
+	const int sizeClass = GetSizeClass(numBytes);
+	FreeList& list = GetThreadFreeList(sizeClass);
+
+	if (list.head == NULL)
+		Refill(list, sizeClass);
+
+	void* pnt = list.head;
+	list.head = *(void**)pnt;
+	list.size--;
+
+	numPooledAllocs.fetch_add(1, std::memory_order_relaxed);
+	return pnt;
+}
+
+void CSlabMemPool::Free(void* pnt, size_t numBytes)
+{
+	if (pnt == NULL)
+		return;
+
+	if (numBytes == 0 || numBytes > SLAB_MAX_BLOCK_SIZE) {
+		numLargeFrees.fetch_add(1, std::memory_order_relaxed);
+		::operator delete(pnt);
+		return;
+	}
+
+	const int sizeClass = GetSizeClass(numBytes);
+	FreeList& list = GetThreadFreeList(sizeClass);
+
+	*(void**)pnt = list.head;
+	list.head = pnt;
+	list.size++;
+
+	// give blocks back when a thread mostly frees what others allocated
+	if (list.size >= (2 * BATCH_SIZE))
+		Drain(list, sizeClass);
+
+	numPooledFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void CSlabMemPool::Refill(FreeList& list, int sizeClass)
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	FreeList& shared = sharedLists[sizeClass];
+
+	if (shared.head != NULL) {
+		// take (up to) a batch from the front of the shared list
+		void* first = shared.head;
+		void* last = first;
+		int n = 1;
+
+		for (; n < BATCH_SIZE && *(void**)last != NULL; n++)
+			last = *(void**)last;
+
+		shared.head = *(void**)last;
+		shared.size -= n;
+
+		*(void**)last = list.head;
+		list.head = first;
+		list.size += n;
+		return;
+	}
+
+	const size_t blockSize = GetBlockSize(sizeClass);
+	const size_t numSlabBlocks = SLAB_SIZE / blockSize;
+
+	char* slab = (char*) ::operator new(SLAB_SIZE);
+	slabs.push_back(slab);
+
+	for (size_t i = 0; i < (numSlabBlocks - 1); ++i) {
+		*(void**)&slab[i * blockSize] = (void*)&slab[(i + 1) * blockSize];
+	}
+
+	*(void**)&slab[(numSlabBlocks - 1) * blockSize] = list.head;
+	list.head = slab;
+	list.size += numSlabBlocks;
+
+	numSlabs.fetch_add(1, std::memory_order_relaxed);
+	numBlocks.fetch_add(numSlabBlocks, std::memory_order_relaxed);
+}
+
+void CSlabMemPool::Drain(FreeList& list, int sizeClass)
+{
+	// detach a batch from the front of the thread's list
+	void* first = list.head;
+	void* last = first;
+
+	for (int n = 1; n < BATCH_SIZE; n++)
+		last = *(void**)last;
+
+	list.head = *(void**)last;
+	list.size -= BATCH_SIZE;
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	FreeList& shared = sharedLists[sizeClass];
+
+	*(void**)last = shared.head;
+	shared.head = first;
+	shared.size += BATCH_SIZE;
+}
+
+
+size_t CSlabMemPool::GetSlabBytes() const
+{
+	return (numSlabs.load(std::memory_order_relaxed) * SLAB_SIZE);
+}
+
+CSlabMemPool::Stats CSlabMemPool::GetStats() const
+{
+	Stats stats;
+
+	// frees first, blocks are only freed after they were allocated
+	const size_t pooledFrees = numPooledFrees.load(std::memory_order_relaxed);
+	const size_t pooledAllocs = numPooledAllocs.load(std::memory_order_relaxed);
+	const size_t largeAllocs = numLargeAllocs.load(std::memory_order_relaxed);
+	const size_t largeFrees = numLargeFrees.load(std::memory_order_relaxed);
+
+	stats.numSlabs = numSlabs.load(std::memory_order_relaxed);
+	stats.numBlocks = numBlocks.load(std::memory_order_relaxed);
+	stats.numUsedBlocks = pooledAllocs - pooledFrees;
+	stats.numAllocs = pooledAllocs + largeAllocs;
+	stats.numFrees = pooledFrees + largeFrees;
+	stats.numHeapAllocs = stats.numSlabs + largeAllocs;
+	return stats;
+}
+
+void CSlabMemPool::UpdateFrameStats()
+{
+	const Stats stats = GetStats();
+
+	frameStats = stats;
+	frameStats.numAllocs = stats.numAllocs - lastStats.numAllocs;
+	frameStats.numFrees = stats.numFrees - lastStats.numFrees;
+	frameStats.numHeapAllocs = stats.numHeapAllocs - lastStats.numHeapAllocs;
+
+	lastStats = stats;
+}
@@ -0,0 +1,109 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _SLAB_MEM_POOL_H_
+#define _SLAB_MEM_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * Pool for the objects of one family of classes (all projectiles, all
+ * ground flashes, ...), meant to be used by their operator new/delete.
+ *
+ * Requests are rounded up to size classes of SLAB_GRANULARITY bytes and each
+ * size class is carved out of its own slabs, so objects of the same type end
+ * up next to each other. Every thread has a private free list per pool and
+ * size class and only takes the pool lock to exchange blocks in batches with
+ * the shared lists, or to allocate a new slab. Requests larger than
+ * SLAB_MAX_BLOCK_SIZE are passed on to operator new. Slabs are only released
+ * with the pool, so after warming up a pool no longer touches the heap.
+ */
+class CSlabMemPool
+{
+public:
+	struct Stats {
+		Stats()
+			: numSlabs(0)
+			, numBlocks(0)
+			, numUsedBlocks(0)
+			, numAllocs(0)
+			, numFrees(0)
+			, numHeapAllocs(0)
+		{}
+
+		size_t numSlabs;
+		size_t numBlocks;     ///< blocks carved out of the slabs
+		size_t numUsedBlocks; ///< blocks currently handed out
+		size_t numAllocs;
+		size_t numFrees;
+		size_t numHeapAllocs; ///< slabs and oversized requests
+	};
+
+	explicit CSlabMemPool(const char* name);
+	~CSlabMemPool();
+
+	void* Alloc(size_t numBytes);
+	void Free(void* pnt, size_t numBytes);
+
+	const char* GetName() const { return name; }
+	size_t GetSlabBytes() const;
+
+	/// totals since the pool was created
+	Stats GetStats() const;
+	/// allocs, frees and heap allocs between the last two UpdateFrameStats calls
+	const Stats& GetFrameStats() const { return frameStats; }
+
+	/// call once per (sim) frame
+	void UpdateFrameStats();
+
+	static int GetNumPools() { return numPools; }
+	static CSlabMemPool* GetPool(int index) { return pools[index]; }
+
+	static const int MAX_POOLS = 8;
+	static const int SLAB_SIZE = 64 * 1024;
+	static const int SLAB_GRANULARITY = 16;
+	static const int SLAB_MAX_BLOCK_SIZE = 1024;
+	static const int NUM_SIZE_CLASSES = SLAB_MAX_BLOCK_SIZE / SLAB_GRANULARITY;
+	/// number of blocks moved between a thread and the shared lists at once
+	static const int BATCH_SIZE = 64;
+
+	struct FreeList {
+		void* head;
+		unsigned int size;
+	};
+
+private:
+	static int GetSizeClass(size_t numBytes) { return ((numBytes - 1) / SLAB_GRANULARITY); }
+	static size_t GetBlockSize(int sizeClass) { return ((sizeClass + 1) * SLAB_GRANULARITY); }
+
+	FreeList& GetThreadFreeList(int sizeClass);
+
+	void Refill(FreeList& list, int sizeClass);
+	void Drain(FreeList& list, int sizeClass);
+
+private:
+	const char* name;
+	int poolIndex;
+
+	boost::mutex mutex;
+
+	FreeList sharedLists[NUM_SIZE_CLASSES];
+	std::vector<void*> slabs;
+
+	std::atomic<size_t> numSlabs;
+	std::atomic<size_t> numBlocks;
+	std::atomic<size_t> numPooledAllocs;
+	std::atomic<size_t> numPooledFrees;
+	std::atomic<size_t> numLargeAllocs;
+	std::atomic<size_t> numLargeFrees;
+
+	Stats lastStats;
+	Stats frameStats;
+
+	static int numPools;
+	static CSlabMemPool* pools[MAX_POOLS];
+};
+
+#endif // _SLAB_MEM_POOL_H_
@@ -5,9 +5,74 @@
 
 #include "SyncChecker.h"
 
+#ifdef TRACE_SYNC_HEAVY
+	#include <sstream>
+#endif
+
 
 unsigned CSyncChecker::g_checksum;
 int CSyncChecker::inSyncedCode;
 
+std::vector<CSyncChecker::Partition> CSyncChecker::partitions;
+__thread CSyncChecker::Partition* CSyncChecker::partition = NULL;
+
+#ifdef TRACE_SYNC_HEAVY
+std::vector<std::string> CSyncChecker::partitionTraces;
+#endif
+
+
+void CSyncChecker::BeginParallelSection(unsigned numPartitions)
+{
+	// sections can not be nested, partitions of an outer one could be
+	// running on other threads while the inner one resizes the vector
+	assert(partitions.empty());
+	assert(partition == NULL);
+
+	partitions.assign(numPartitions, Partition());
+
+#ifdef TRACE_SYNC_HEAVY
+	partitionTraces.assign(numPartitions, std::string());
+#endif
+}
+
+void CSyncChecker::EndParallelSection()
+{
+	// a section that makes no Sync calls leaves the frame checksum
+	// as it was, the same as running its work serially would
+	for (unsigned n = 0; n < partitions.size(); ++n) {
+		if (!partitions[n].written)
+			continue;
+
+		Sync(&partitions[n].checksum, sizeof(unsigned));
+	}
+
+	partitions.clear();
+
+#ifdef TRACE_SYNC_HEAVY
+	for (unsigned n = 0; n < partitionTraces.size(); ++n) {
+		tracefile << partitionTraces[n];
+	}
+
+	partitionTraces.clear();
+#endif
+}
+
+
+#ifdef TRACE_SYNC_HEAVY
+void CSyncChecker::TraceSync(const char* msg)
+{
+	if (partition == NULL) {
+		tracefile << "Sync " << msg << " " << g_checksum << "\n";
+		return;
+	}
+
+	// only this thread writes to the partition's buffer
+	std::ostringstream line;
+	line << "Sync " << msg << " " << partition->checksum << "\n";
+
+	partitionTraces[partition - &partitions[0]] += line.str();
+}
+#endif
+
 
 #endif // SYNCDEBUG
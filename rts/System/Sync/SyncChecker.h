@@ -14,6 +14,12 @@
 #endif
 
 #include <assert.h>
+#include <cstddef>
+#include <vector>
+
+#ifdef TRACE_SYNC_HEAVY
+	#include <string>
+#endif
 
 /**
  * @brief sync checker class
@@ -38,47 +44,49 @@ class CSyncChecker {
 		static void NewFrame() { g_checksum = 0xfade1eaf; }
 
 		static void Sync(const void* p, unsigned size) {
+			unsigned& checksum = (partition != NULL)? partition->Write(): g_checksum;
+
 			// most common cases first, make it easy for compiler to optimize for it
 			// simple xor is not enough to detect multiple zeroes, e.g.
 #ifdef TRACE_SYNC_HEAVY
-			g_checksum = HsiehHash((const char*)p, size, g_checksum);
+			checksum = HsiehHash((const char*)p, size, checksum);
 #else
 			switch(size) {
 			case 1:
-				g_checksum += *(const unsigned char*)p;
-				g_checksum ^= g_checksum << 10;
-				g_checksum += g_checksum >> 1;
+				checksum += *(const unsigned char*)p;
+				checksum ^= checksum << 10;
+				checksum += checksum >> 1;
 				break;
 			case 2:
-				g_checksum += *(const unsigned short*)(const char*)p;
-				g_checksum ^= g_checksum << 11;
-				g_checksum += g_checksum >> 17;
+				checksum += *(const unsigned short*)(const char*)p;
+				checksum ^= checksum << 11;
+				checksum += checksum >> 17;
 				break;
 			case 3:
 				// just here to make the switch statements contiguous (so it can be optimized)
 				for (unsigned i = 0; i < 3; ++i) {
-					g_checksum += *(const unsigned char*)p + i;
-					g_checksum ^= g_checksum << 10;
-					g_checksum += g_checksum >> 1;
+					checksum += *(const unsigned char*)p + i;
+					checksum ^= checksum << 10;
+					checksum += checksum >> 1;
 				}
 				break;
 			case 4:
-				g_checksum += *(const unsigned int*)(const char*)p;
-				g_checksum ^= g_checksum << 16;
-				g_checksum += g_checksum >> 11;
+				checksum += *(const unsigned int*)(const char*)p;
+				checksum ^= checksum << 16;
+				checksum += checksum >> 11;
 				break;
 			default:
 			{
 				unsigned i = 0;
 				for (; i < (size & ~3) / 4; ++i) {
-					g_checksum += *(reinterpret_cast<const unsigned int*>(p) + i);
-					g_checksum ^= g_checksum << 16;
-					g_checksum += g_checksum >> 11;
+					checksum += *(reinterpret_cast<const unsigned int*>(p) + i);
+					checksum ^= checksum << 16;
+					checksum += checksum >> 11;
 				}
 				for (; i < size; ++i) {
-					g_checksum += *(const unsigned char*)p + i;
-					g_checksum ^= g_checksum << 10;
-					g_checksum += g_checksum >> 1;
+					checksum += *(const unsigned char*)p + i;
+					checksum ^= checksum << 10;
+					checksum += checksum >> 1;
 				}
 				break;
 			}
@@ -86,6 +94,39 @@ class CSyncChecker {
 #endif
 		}
 
+		/**
+		 * Parallel sections let synced code run concurrently (e.g. in a for_mt)
+		 * without making the checksum depend on thread scheduling: the work is
+		 * split into a fixed number of partitions, every partition gets its own
+		 * checksum, and those are folded into the frame checksum in partition
+		 * order when the section ends (partitions without any Sync call are left
+		 * out). The result is the same for any number of threads, as long as
+		 * partitions are assigned by work item (not by the executing thread).
+		 * See for_mt_synced in SyncedParallel.h.
+		 */
+		static void BeginParallelSection(unsigned numPartitions);
+		static void EndParallelSection();
+
+		/// redirects the calling thread's Sync calls to <partition>
+		static void EnterPartition(unsigned n) {
+			assert(n < partitions.size());
+			assert(partition == NULL);
+			partition = &partitions[n];
+		}
+		static void LeavePartition() {
+			assert(partition != NULL);
+			partition = NULL;
+		}
+
+#ifdef TRACE_SYNC_HEAVY
+		/**
+		 * Writes a line for a Sync call to the tracefile. Inside a partition
+		 * the line is buffered and written when the parallel section ends, in
+		 * partition order like the checksums.
+		 */
+		static void TraceSync(const char* msg);
+#endif
+
 	private:
 
 		/**
@@ -93,6 +134,26 @@ class CSyncChecker {
 		 */
 		static unsigned g_checksum;
 
+		struct Partition {
+			Partition(): checksum(0xfade1eaf), written(false) {}
+
+			unsigned& Write() { written = true; return checksum; }
+
+			unsigned checksum;
+			bool written;
+		};
+
+		/**
+		 * Partitions of the current parallel section, and the one
+		 * the calling thread writes to (NULL outside of partitions)
+		 */
+		static std::vector<Partition> partitions;
+		static __thread Partition* partition;
+
+#ifdef TRACE_SYNC_HEAVY
+		static std::vector<std::string> partitionTraces;
+#endif
+
 		/**
 		 * @brief in synced code
 		 *
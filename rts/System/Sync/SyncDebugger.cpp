@@ -52,6 +52,9 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_SYNC_DEBUGGER)
 static CLogger logger;
 
 
+__thread std::vector<CSyncDebugger::HistItemWithBacktrace>* CSyncDebugger::partitionHistory = NULL;
+
+
 CSyncDebugger* CSyncDebugger::GetInstance() {
 	static CSyncDebugger instance;
 	return &instance;
@@ -118,22 +121,24 @@ void CSyncDebugger::Sync(const void* p, unsigned size, const char* op)
 		return;
 	}
 
-	HistItem* h = &history[historyIndex];
+	HistItemWithBacktrace item;
+	item.bt_size = 0;
 
 #ifdef HAVE_BACKTRACE
 	if (historybt) {
 		// HACK to skip the uppermost 2 or 3 (32 resp. 64 bit) frames without memcpy'ing the whole backtrace
+		// (this overwrites op, frameNum and bt_size, which are set afterwards)
 		const int frameskip = (8 + sizeof(void*)) / sizeof(void*);
-		historybt[historyIndex].bt_size = backtrace(historybt[historyIndex].bt - frameskip, MAX_STACK + frameskip) - frameskip;
-		historybt[historyIndex].op = op;
-		historybt[historyIndex].frameNum = gs->frameNum;
-		h = &historybt[historyIndex];
+		item.bt_size = backtrace(item.bt - frameskip, MAX_STACK + frameskip) - frameskip;
 	}
 #endif
 
+	item.op = op;
+	item.frameNum = gs->frameNum;
+
 	if (size == 4) {
 		// common case
-		h->data = *(const unsigned*) p;
+		item.data = *(const unsigned*) p;
 	}
 	else {
 		// > XOR seems dangerous in that every bit is independent of any other, this is bad.
@@ -141,13 +146,31 @@ void CSyncDebugger::Sync(const void* p, unsigned size, const char* op)
 		// of data at a time, so most of it fits in the checksum anyway.
 		// (see SyncedPrimitiveBase / SyncedPrimitive, the main client of this method)
 		unsigned i = 0;
-		h->data = 0;
+		item.data = 0;
 		// whole dwords
 		for (; i < (size & ~3); i += 4)
-			h->data ^= *(const unsigned*) ((const unsigned char*) p + i);
+			item.data ^= *(const unsigned*) ((const unsigned char*) p + i);
 		// remaining 0 to 3 bytes
 		for (; i < size; ++i)
-			h->data ^= *((const unsigned char*) p + i);
+			item.data ^= *((const unsigned char*) p + i);
+	}
+
+	if (partitionHistory != NULL) {
+		// added to the history when the parallel section ends
+		partitionHistory->push_back(item);
+		return;
+	}
+
+	AddHistItem(item);
+}
+
+
+void CSyncDebugger::AddHistItem(const HistItemWithBacktrace& item)
+{
+	if (historybt) {
+		historybt[historyIndex] = item;
+	} else {
+		history[historyIndex].data = item.data;
 	}
 
 	if (++historyIndex == HISTORY_SIZE * BLOCK_SIZE) {
@@ -157,6 +180,43 @@ void CSyncDebugger::Sync(const void* p, unsigned size, const char* op)
 }
 
 
+void CSyncDebugger::BeginParallelSection(unsigned numPartitions)
+{
+	assert(partitionHistories.empty());
+	assert(partitionHistory == NULL);
+
+	partitionHistories.resize(numPartitions);
+}
+
+void CSyncDebugger::EndParallelSection()
+{
+	for (unsigned n = 0; n < partitionHistories.size(); ++n) {
+		const std::vector<HistItemWithBacktrace>& items = partitionHistories[n];
+
+		for (unsigned i = 0; i < items.size(); ++i) {
+			AddHistItem(items[i]);
+		}
+	}
+
+	partitionHistories.clear();
+}
+
+void CSyncDebugger::EnterPartition(unsigned partition)
+{
+	assert(partition < partitionHistories.size());
+	assert(partitionHistory == NULL);
+
+	partitionHistory = &partitionHistories[partition];
+}
+
+void CSyncDebugger::LeavePartition()
+{
+	assert(partitionHistory != NULL);
+
+	partitionHistory = NULL;
+}
+
+
 void CSyncDebugger::Backtrace(int index, const char* prefix) const
 {
 	if (historybt) {
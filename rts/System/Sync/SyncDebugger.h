@@ -112,6 +112,13 @@ class CSyncDebugger {
 		std::deque<unsigned> pendingBlocksToRequest; ///< We still need to receive these blocks (slowly emptied).
 		bool waitingForBlockResponse;                ///< Are we still waiting for a block response?
 
+		// parallel sections
+
+		/// Assignments made in each partition of the current parallel section.
+		std::vector< std::vector<HistItemWithBacktrace> > partitionHistories;
+		/// The partition the calling thread records to (NULL outside of partitions).
+		static __thread std::vector<HistItemWithBacktrace>* partitionHistory;
+
 	private:
 
 		// don't construct or copy
@@ -175,6 +182,10 @@ class CSyncDebugger {
 		 * & line number.
 		 */
 		void ServerDumpStack();
+		/**
+		 * @brief append one assignment to the history
+		 */
+		void AddHistItem(const HistItemWithBacktrace& item);
 
 	public:
 
@@ -187,6 +198,20 @@ class CSyncDebugger {
 		 */
 		void Sync(const void* p, unsigned size, const char* op);
 
+		/**
+		 * @brief parallel sections
+		 *
+		 * Same as the ones of the CSyncChecker (see for_mt_synced): inside a
+		 * partition, Sync() records to a buffer of that partition, and the
+		 * buffers are appended to the history in partition order when the
+		 * section ends. This keeps the history independent of the number of
+		 * threads and of which of them ran a partition.
+		 */
+		void BeginParallelSection(unsigned numPartitions);
+		void EndParallelSection();
+		void EnterPartition(unsigned partition);
+		void LeavePartition();
+
 		/**
 		 * @brief initialize
 		 *
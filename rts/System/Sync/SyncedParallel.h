@@ -0,0 +1,75 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SYNCED_PARALLEL_H
+#define SYNCED_PARALLEL_H
+
+#include "System/ThreadPool.h"
+
+#ifdef SYNCCHECK
+	#include "SyncChecker.h"
+#endif
+
+#ifdef SYNCDEBUG
+	#include "SyncDebugger.h"
+#endif
+
+
+/**
+ * for_mt for loops that write synced state: every iteration is a partition
+ * of its own in the CSyncChecker, so the checksum of the frame does not depend
+ * on the number of worker threads or on which of them ran an iteration.
+ * The iterations themselves must of course still be independent.
+ */
+static inline void for_mt_synced(int start, int end, int step, const std::function<void(const int i)>&& f)
+{
+#if defined(SYNCCHECK) || defined(SYNCDEBUG)
+	if (end <= start)
+		return;
+
+	const unsigned numPartitions = (end - start + step - 1) / step;
+
+	#ifdef SYNCCHECK
+	CSyncChecker::BeginParallelSection(numPartitions);
+	#endif
+	#ifdef SYNCDEBUG
+	CSyncDebugger::GetInstance()->BeginParallelSection(numPartitions);
+	#endif
+
+	for_mt(start, end, step, [&](const int i) {
+		const unsigned partition = (i - start) / step;
+
+	#ifdef SYNCCHECK
+		CSyncChecker::EnterPartition(partition);
+	#endif
+	#ifdef SYNCDEBUG
+		CSyncDebugger::GetInstance()->EnterPartition(partition);
+	#endif
+
+		f(i);
+
+	#ifdef SYNCDEBUG
+		CSyncDebugger::GetInstance()->LeavePartition();
+	#endif
+	#ifdef SYNCCHECK
+		CSyncChecker::LeavePartition();
+	#endif
+	});
+
+	#ifdef SYNCDEBUG
+	CSyncDebugger::GetInstance()->EndParallelSection();
+	#endif
+	#ifdef SYNCCHECK
+	CSyncChecker::EndParallelSection();
+	#endif
+#else
+	for_mt(start, end, step, std::move(f));
+#endif
+}
+
+
+static inline void for_mt_synced(int start, int end, const std::function<void(const int i)>&& f)
+{
+	for_mt_synced(start, end, 1, std::move(f));
+}
+
+#endif // SYNCED_PARALLEL_H
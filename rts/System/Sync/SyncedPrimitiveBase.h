@@ -34,7 +34,7 @@ namespace Sync {
 		assert(CSyncChecker::InSyncedCode());
 		CSyncChecker::Sync(p, size);
 	#ifdef TRACE_SYNC_HEAVY
-		tracefile << "Sync " << msg << " " << CSyncChecker::GetChecksum() << "\n";
+		CSyncChecker::TraceSync(msg);
 	#endif
 #endif
 	}
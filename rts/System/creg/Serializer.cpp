@@ -17,14 +17,13 @@
 #include <fstream>
 #include <assert.h>
 #include <stdexcept>
-#include <map>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <string.h>
 
 using namespace creg;
 using std::string;
-using std::map;
 using std::vector;
 
 LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_CREG_SERIALIZER)
@@ -76,33 +75,7 @@ static std::string ReadZStr(std::istream& file)
 	return std::string(cstr);
 }
 
-static void WriteZStr(std::ostream& file, const std::string& str)
-{
-	assert(str.length() < 1024); // check func above!
-	file.write(str.c_str(), str.length() + 1);
-}
-
-void WriteVarSizeUInt(std::ostream* stream, unsigned int val)
-{
-	if (val < 0x80) {
-		unsigned char a = val;
-		stream->write((char*)&a, sizeof(char));
-	} else if (val < 0x4000) {
-		unsigned char a = (val & 0x7F) | 0x80;
-		unsigned char b = val >> 7;
-		stream->write((char*)&a, sizeof(char));
-		stream->write((char*)&b, sizeof(char));
-	} else if (val < 0x40000000) {
-		unsigned char a = (val & 0x7F) | 0x80;
-		unsigned char b = ((val >> 7) & 0x7F) | 0x80;
-		unsigned short c = swabWord(val >> 14);
-		stream->write((char*)&a, sizeof(char));
-		stream->write((char*)&b, sizeof(char));
-		stream->write((char*)&c, sizeof(short));
-	} else throw "Cannot save varible-size int";
-}
-
-void ReadVarSizeUInt(std::istream* stream, unsigned int* buf)
+static void ReadVarSizeUInt(std::istream* stream, unsigned int* buf)
 {
 	unsigned char a;
 	stream->read((char*)&a, sizeof(char));
@@ -124,6 +97,14 @@ void ReadVarSizeUInt(std::istream* stream, unsigned int* buf)
 //-------------------------------------------------------------------------
 // Base output serializer
 //-------------------------------------------------------------------------
+
+// table sizes of the previous package, so that the next one (typically
+// of a similar size) does not have to grow its tables step by step
+static size_t numBytesHint = 0;
+static size_t numObjectsHint = 0;
+static size_t numMemberGroupsHint = 0;
+static size_t numMembersHint = 0;
+
 COutputStreamSerializer::COutputStreamSerializer()
 {
 	stream = NULL;
@@ -134,23 +115,95 @@ bool COutputStreamSerializer::IsWriting()
 	return true;
 }
 
+void COutputStreamSerializer::Write(const void* data, int byteSize)
+{
+	if (byteSize <= 0)
+		return;
+
+	const size_t pos = buffer.size();
+	buffer.resize(pos + byteSize);
+	memcpy(&buffer[pos], data, byteSize);
+}
+
+void COutputStreamSerializer::WriteVarSizeUInt(unsigned int val)
+{
+	if (val < 0x80) {
+		unsigned char a = val;
+		Write(&a, sizeof(char));
+	} else if (val < 0x4000) {
+		unsigned char a = (val & 0x7F) | 0x80;
+		unsigned char b = val >> 7;
+		Write(&a, sizeof(char));
+		Write(&b, sizeof(char));
+	} else if (val < 0x40000000) {
+		unsigned char a = (val & 0x7F) | 0x80;
+		unsigned char b = ((val >> 7) & 0x7F) | 0x80;
+		unsigned short c = swabWord(val >> 14);
+		Write(&a, sizeof(char));
+		Write(&b, sizeof(char));
+		Write(&c, sizeof(short));
+	} else throw "Cannot save varible-size int";
+}
+
+void COutputStreamSerializer::WriteZStr(const std::string& str)
+{
+	assert(str.length() < 1024); // check ReadZStr!
+	Write(str.c_str(), str.length() + 1);
+}
+
 COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(void* inst, creg::Class* objClass, bool isEmbedded)
 {
-	std::vector<ObjectRef*>* refs = &(ptrToId[inst]);
-	for (std::vector<ObjectRef*>::iterator i = refs->begin(); i != refs->end(); ++i) {
-		if ((*i)->isThisObject(inst, objClass, isEmbedded))
-			return *i;
+	const boost::unordered_map<void*, int>::const_iterator it = ptrToId.find(inst);
+
+	if (it == ptrToId.end())
+		return NULL;
+
+	for (int id = it->second; id >= 0; id = objects[id].nextSamePtr) {
+		if (objects[id].isThisObject(inst, objClass, isEmbedded))
+			return &objects[id];
 	}
 	return NULL;
 }
 
-void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* objr)
+COutputStreamSerializer::ObjectRef* COutputStreamSerializer::AddObjectRef(void* inst, creg::Class* objClass, bool isEmbedded)
+{
+	const int id = objects.size();
+	objects.push_back(ObjectRef(inst, id, isEmbedded, objClass));
+
+	const std::pair<boost::unordered_map<void*, int>::iterator, bool> ins = ptrToId.insert(std::make_pair(inst, id));
+
+	if (!ins.second) {
+		// append, FindObjectRef returns the first match
+		int last = ins.first->second;
+		while (objects[last].nextSamePtr >= 0)
+			last = objects[last].nextSamePtr;
+		objects[last].nextSamePtr = id;
+	}
+
+	return &objects[id];
+}
+
+void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, int objId)
+{
+	const size_t groupStart = groupStack.size();
+
+	SerializeMembers(c, ptr);
+
+	// <objects> may have grown in the meantime
+	ObjectRef& objr = objects[objId];
+	objr.firstGroup = memberGroups.size();
+	objr.numGroups = groupStack.size() - groupStart;
+
+	memberGroups.insert(memberGroups.end(), groupStack.begin() + groupStart, groupStack.end());
+	groupStack.resize(groupStart);
+}
+
+void COutputStreamSerializer::SerializeMembers(Class* c, void* ptr)
 {
 	if (c->base)
-		SerializeObject(c->base, ptr, objr);
+		SerializeMembers(c->base, ptr);
 
-	ObjectMemberGroup omg;
-	omg.membersClass = c;
+	const size_t memberStart = memberStack.size();
 
 	for (uint a = 0; a < c->members.size(); a++)
 	{
@@ -158,35 +211,37 @@ void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* ob
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		ObjectMember om;
-		om.member = m;
-		om.memberId = a;
 		void* memberAddr = ((char*)ptr) + m->offset;
-		unsigned mstart = stream->tellp();
+		const size_t mstart = buffer.size();
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s", c->name.c_str(), m->name, m->type->GetName().c_str());
 		m->type->Serialize(this, memberAddr);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
+
+		ObjectMember om;
+		om.memberId = a;
+		om.size = buffer.size() - mstart;
+		memberStack.push_back(om);
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s size:%d", c->name.c_str(), m->name, m->type->GetName().c_str(), om.size);
 	}
 
-
 	if (c->serializeProc) {
-		ObjectMember om;
-		om.member = NULL;
-		om.memberId = -1;
-		unsigned mstart = stream->tellp();
+		const size_t mstart = buffer.size();
 		_DummyStruct *obj = (_DummyStruct*)ptr;
 		(obj->*(c->serializeProc))(*this);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
+
+		ObjectMember om;
+		om.memberId = -1;
+		om.size = buffer.size() - mstart;
+		memberStack.push_back(om);
 	}
 
-	objr->memberGroups.push_back(omg);
+	ObjectMemberGroup omg;
+	omg.membersClass = c;
+	omg.firstMember = members.size();
+	omg.numMembers = memberStack.size() - memberStart;
+
+	members.insert(members.end(), memberStack.begin() + memberStart, memberStack.end());
+	memberStack.resize(memberStart);
+	groupStack.push_back(omg);
 }
 
 void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* objClass)
@@ -194,53 +249,48 @@ void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* o
 	// register the object, and mark it as embedded if a pointer was already referencing it
 	ObjectRef* obj = FindObjectRef(inst, objClass, true);
 	if (!obj) {
-		objects.push_back(ObjectRef(inst, objects.size(), true, objClass));
-		obj = &objects.back();
-		ptrToId[inst].push_back(obj);
+		obj = AddObjectRef(inst, objClass, true);
 	} else if (obj->isEmbedded) {
 		throw "Reserialization of embedded object (" + objClass->name + ")";
+	} else if (!obj->isPending) {
+		throw "Object pointer was serialized (" + objClass->name + ")";
 	} else {
-		std::vector<ObjectRef*>::iterator it = std::find(pendingObjects.begin(), pendingObjects.end(), obj);
-		if (it == pendingObjects.end()) {
-			throw "Object pointer was serialized (" + objClass->name + ")";
-		} else {
-			pendingObjects.erase(it);
-		}
+		// saved here instead, SavePackage skips it
+		obj->isPending = false;
 	}
 	obj->class_ = objClass;
 	obj->isEmbedded = true;
 
+	const int id = obj->id;
+
 	// write an object ID
-	WriteVarSizeUInt(stream, obj->id);
+	WriteVarSizeUInt(id);
 
 	// write the object
-	SerializeObject(objClass, inst, obj);
+	SerializeObject(objClass, inst, id);
 }
 
 void COutputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* objClass)
 {
 	if (*ptr) {
 		// valid pointer, write a one and the object ID
-		int id;
 		ObjectRef* obj = FindObjectRef(*ptr, objClass, false);
 		if (!obj) {
-			objects.push_back(ObjectRef(*ptr, objects.size(), false, objClass));
-			obj = &objects.back();
-			ptrToId[*ptr].push_back(obj);
-			pendingObjects.push_back(obj);
+			obj = AddObjectRef(*ptr, objClass, false);
+			obj->isPending = true;
+			pendingObjects.push_back(obj->id);
 		}
-		id = obj->id;
 
-		WriteVarSizeUInt(stream, id);
+		WriteVarSizeUInt(obj->id);
 	} else {
 		// null pointer, write a zero
-		WriteVarSizeUInt(stream, 0);
+		WriteVarSizeUInt(0);
 	}
 }
 
 void COutputStreamSerializer::Serialize(void* data, int byteSize)
 {
-	stream->write((char*)data, byteSize);
+	Write(data, byteSize);
 }
 
 void COutputStreamSerializer::SerializeInt(void* data, int byteSize)
@@ -268,7 +318,7 @@ void COutputStreamSerializer::SerializeInt(void* data, int byteSize)
 			throw "Unknown int type";
 		}
 	}
-	stream->write((char*)data, byteSize); //TODO write buf?
+	Write(buf, byteSize);
 }
 
 
@@ -283,52 +333,61 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	PackageHeader ph;
 
 	stream = s;
-	unsigned startOffset = stream->tellp();
-	stream->write((char*)&ph, sizeof(PackageHeader));
-	stream->seekp(startOffset + sizeof(PackageHeader));
-	ph.objDataOffset = (int)stream->tellp();
+	const int startOffset = stream->tellp();
+	const int dataOffset = startOffset + sizeof(PackageHeader);
+	ph.objDataOffset = dataOffset;
+
+	buffer.reserve(numBytesHint);
+	objects.reserve(numObjectsHint);
+	memberGroups.reserve(numMemberGroupsHint);
+	members.reserve(numMembersHint);
+	ptrToId.rehash(numObjectsHint);
 
 	// Insert dummy object with id 0
 	objects.push_back(ObjectRef(0, 0, true, 0));
-	ObjectRef* obj = &objects.back();
-	obj->classIndex = 0;
 
 	// Insert the first object that will provide references to everything
-	objects.push_back(ObjectRef(rootObj, objects.size(), false, rootObjClass));
-	obj = &objects.back();
-	ptrToId[rootObj].push_back(obj);
-	pendingObjects.push_back(obj);
+	ObjectRef* root = AddObjectRef(rootObj, rootObjClass, false);
+	root->isPending = true;
+	pendingObjects.push_back(root->id);
 
-	std::map<creg::Class*, int> classSizes;
 	// Save until all the referenced objects have been stored
+	std::vector<int> po;
+
 	while (!pendingObjects.empty())
 	{
-		const std::vector<ObjectRef*> po = pendingObjects;
-		pendingObjects.clear();
+		po.clear();
+		po.swap(pendingObjects);
+
+		// from here on, embedding one of these is an error
+		for (std::vector<int>::const_iterator i = po.begin(); i != po.end(); ++i)
+			objects[*i].isPending = false;
 
-		for (std::vector<ObjectRef*>::const_iterator i = po.begin(); i != po.end(); ++i)
+		for (std::vector<int>::const_iterator i = po.begin(); i != po.end(); ++i)
 		{
-			ObjectRef* obj = *i;
-			const unsigned objstart = stream->tellp();
-			SerializeObject(obj->class_, obj->ptr, obj);
-			const unsigned objend = stream->tellp();
-			const int sz = objend - objstart;
-			classSizes[obj->class_] += sz;
-			LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s size:%i", obj->class_->name.c_str(), sz);
+			// it was embedded somewhere after being referenced
+			if (objects[*i].isEmbedded)
+				continue;
+
+#if (LOG_LEVEL_DEBUG >= _LOG_LEVEL_MIN)
+			const size_t objstart = buffer.size();
+			SerializeObject(objects[*i].class_, objects[*i].ptr, *i);
+			LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s size:%i", objects[*i].class_->name.c_str(), int(buffer.size() - objstart));
+#else
+			SerializeObject(objects[*i].class_, objects[*i].ptr, *i);
+#endif
 		}
 	}
 
 	// Collect a set of all used classes
-	std::map<creg::Class*, ClassRef> classMap;
+	boost::unordered_map<creg::Class*, ClassRef> classMap;
 	std::vector<ClassRef*> classRefs;
-	std::map<int, int> classObjects;
-	for (std::list<ObjectRef>::iterator i = objects.begin(); i != objects.end(); ++i) {
+	for (std::vector<ObjectRef>::iterator i = objects.begin(); i != objects.end(); ++i) {
 		if (i->ptr == NULL) continue;
 
 		creg::Class* c = i->class_;
 		while (c) {
-			std::map<creg::Class*, ClassRef>::iterator cr = classMap.find(c);
-			if (cr == classMap.end()) {
+			if (classMap.find(c) == classMap.end()) {
 				ClassRef* pRef = &classMap[c];
 				pRef->index = classRefs.size();
 				pRef->class_ = c;
@@ -337,67 +396,57 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 			c = c->base;
 		}
 
-		std::map<creg::Class*, ClassRef>::iterator cr = classMap.find(i->class_);
-		i->classIndex = cr->second.index;
-		classObjects[i->classIndex]++;
-	}
-
-/*
-	if (LOG_IS_ENABLED(L_DEBUG)) {
-		for (std::map<int, int>::iterator i = classObjects.begin(); i != classObjects.end(); i++) {
-			LOG_L(L_DEBUG, "%20s %10u %10u",
-					classRefs[i->first]->class_->name.c_str(),
-					i->second,
-					classSizes[classRefs[i->first]->class_]);
-		}
+		i->classIndex = classMap[i->class_].index;
 	}
-*/
 
 	// Write the class references & calc their checksum
 	ph.numObjClassRefs = classRefs.size();
-	ph.objClassRefOffset = (int)stream->tellp();
+	ph.objClassRefOffset = dataOffset + (int)buffer.size();
 	for (uint a = 0; a < classRefs.size(); a++) {
 		creg::Class* c =  classRefs[a]->class_;
-		WriteZStr(*stream, c->name);
+		WriteZStr(c->name);
 	};
 
 	// Write object info
-	ph.objTableOffset = (int)stream->tellp();
+	ph.objTableOffset = dataOffset + (int)buffer.size();
 	ph.numObjects = objects.size();
-	for (std::list<ObjectRef>::iterator i = objects.begin(); i != objects.end(); ++i) {
+	for (std::vector<ObjectRef>::const_iterator i = objects.begin(); i != objects.end(); ++i) {
 		int classRefIndex = i->classIndex;
 		char isEmbedded = i->isEmbedded ? 1 : 0;
-		WriteVarSizeUInt(stream, classRefIndex);
-		stream->write((char*)&isEmbedded, sizeof(char));
+		WriteVarSizeUInt(classRefIndex);
+		Write(&isEmbedded, sizeof(char));
+
+		char mgcnt = i->numGroups;
+		WriteVarSizeUInt(mgcnt);
 
-		char mgcnt = i->memberGroups.size();
-		WriteVarSizeUInt(stream, mgcnt);
+		for (int g = i->firstGroup; g < (i->firstGroup + i->numGroups); g++) {
+			const ObjectMemberGroup& omg = memberGroups[g];
 
-		std::vector<COutputStreamSerializer::ObjectMemberGroup>::iterator j;
-		for (j = i->memberGroups.begin(); j != i->memberGroups.end(); ++j) {
-			std::map<creg::Class*, ClassRef>::iterator cr = classMap.find(j->membersClass);
+			boost::unordered_map<creg::Class*, ClassRef>::const_iterator cr = classMap.find(omg.membersClass);
 			if (cr == classMap.end()) throw "Cannot find member class ref";
 			int cid = cr->second.index;
-			WriteVarSizeUInt(stream, cid);
+			WriteVarSizeUInt(cid);
 
-			unsigned int mcnt = j->members.size();
-			WriteVarSizeUInt(stream, mcnt);
+			unsigned int mcnt = omg.numMembers;
+			WriteVarSizeUInt(mcnt);
+
+			const ObjectMember* firstMember = (mcnt > 0)? &members[omg.firstMember]: NULL;
+			const ObjectMember* lastMember = firstMember + mcnt;
 
 			bool hasSerializerMember = false;
 			char groupFlags = 0;
-			if (!j->members.empty() && (j->members.back().memberId == -1)) {
+			if ((mcnt > 0) && ((lastMember - 1)->memberId == -1)) {
 				groupFlags |= 0x01;
 				hasSerializerMember = true;
 			}
-			stream->write((char*)&groupFlags, sizeof(char));
+			Write(&groupFlags, sizeof(char));
 
 			int midx = 0;
-			std::vector<COutputStreamSerializer::ObjectMember>::iterator k;
-			for (k = j->members.begin(); k != j->members.end(); ++k, ++midx) {
-				if ((k->memberId != midx) && (!hasSerializerMember || k != (j->members.end() - 1))) {
+			for (const ObjectMember* k = firstMember; k != lastMember; ++k, ++midx) {
+				if ((k->memberId != midx) && (!hasSerializerMember || k != (lastMember - 1))) {
 					throw "Invalid member id";
 				}
-				WriteVarSizeUInt(stream, k->size);
+				WriteVarSizeUInt(k->size);
 			}
 		}
 	}
@@ -410,20 +459,26 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 		c->CalculateChecksum(ph.metadataChecksum);
 	}
 
-	int endOffset = stream->tellp();
-	stream->seekp(startOffset);
 	memcpy(ph.magic, CREG_PACKAGE_FILE_ID, 4);
 	ph.SwapBytes();
 	stream->write((const char*)&ph, sizeof(PackageHeader));
+	stream->write(&buffer[0], buffer.size());
 
 	LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG,
 			"Checksum: %X\nNumber of objects saved: %d\nNumber of classes involved: %d",
 			ph.metadataChecksum, objects.size(), classRefs.size());
 
-	stream->seekp(endOffset);
+	numBytesHint = buffer.size();
+	numObjectsHint = objects.size();
+	numMemberGroupsHint = memberGroups.size();
+	numMembersHint = members.size();
+
+	buffer.clear();
 	ptrToId.clear();
 	pendingObjects.clear();
 	objects.clear();
+	memberGroups.clear();
+	members.clear();
 }
 
 //-------------------------------------------------------------------------
@@ -432,6 +487,7 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 
 CInputStreamSerializer::CInputStreamSerializer()
 	: stream(NULL)
+	, bufferPos(0)
 {
 }
 
@@ -461,10 +517,10 @@ void CInputStreamSerializer::SerializeObject(Class* c, void* ptr)
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		const unsigned oldPos = stream->tellg();
+		const size_t oldPos = bufferPos;
 		void* memberAddr = ((char*)ptr) + m->offset;
 		m->type->Serialize(this, memberAddr);
-		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Deserialized %s::%s type:%s size:%u", c->name.c_str(), m->name, m->type->GetName().c_str(), unsigned(stream->tellg()) - oldPos);
+		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Deserialized %s::%s type:%s size:%u", c->name.c_str(), m->name, m->type->GetName().c_str(), unsigned(bufferPos - oldPos));
 	}
 
 	if (c->serializeProc) {
@@ -473,15 +529,45 @@ void CInputStreamSerializer::SerializeObject(Class* c, void* ptr)
 	}
 }
 
+void CInputStreamSerializer::Read(void* data, int byteSize)
+{
+	if (byteSize <= 0)
+		return;
+	if ((bufferPos + byteSize) > buffer.size())
+		throw std::runtime_error("Package object data is truncated");
+
+	memcpy(data, &buffer[bufferPos], byteSize);
+	bufferPos += byteSize;
+}
+
+void CInputStreamSerializer::ReadVarSizeUInt(unsigned int* val)
+{
+	unsigned char a;
+	Read(&a, sizeof(char));
+	if (a & 0x80) {
+		unsigned char b;
+		Read(&b, sizeof(char));
+		if (b & 0x80) {
+			unsigned short c;
+			Read(&c, sizeof(short));
+			*val = (a & 0x7F) | ((b & 0x7F) << 7) | (c << 14);
+		} else {
+			*val = (a & 0x7F) | ((b & 0x7F) << 7);
+		}
+	} else {
+		*val = a & 0x7F;
+	}
+}
+
 void CInputStreamSerializer::Serialize(void* data, int byteSize)
 {
-	stream->read((char*)data, byteSize);
+	Read(data, byteSize);
 }
 
 void CInputStreamSerializer::SerializeInt(void* data, int byteSize)
 {
 	//FIXME transform to template?
-	stream->read((char*)data, byteSize);
+	Read(data, byteSize);
 	switch (byteSize) {
 		case 1: {
 			*(char*)data = *(char*) data;
@@ -508,7 +594,7 @@ void CInputStreamSerializer::SerializeInt(void* data, int byteSize)
 void CInputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* cls)
 {
 	unsigned int id;
-	ReadVarSizeUInt(stream, &id);
+	ReadVarSizeUInt(&id);
 	if (id) {
 		StoredObject& o = objects [id];
 		if (o.obj) *ptr = o.obj;
@@ -528,7 +614,7 @@ void CInputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* cls)
 void CInputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* cls)
 {
 	unsigned int id;
-	ReadVarSizeUInt(stream, &id);
+	ReadVarSizeUInt(&id);
 
 	if (id == 0)
 		return; // this is old save game and it has not this object - skip it
@@ -589,19 +675,19 @@ void CInputStreamSerializer::LoadPackage(std::istream* s, void*& root, creg::Cla
 		unsigned int classRefIndex;
 		char isEmbedded;
 		unsigned int mgcnt;
-		ReadVarSizeUInt(stream, &classRefIndex);
+		::ReadVarSizeUInt(stream, &classRefIndex);
 		stream->read((char*)&isEmbedded, sizeof(char));
-		ReadVarSizeUInt(stream, &mgcnt);
+		::ReadVarSizeUInt(stream, &mgcnt);
 
 		for (unsigned int b = 0; b < mgcnt; b++) {
 			unsigned int cid, mcnt;
 			char groupFlags;
-			ReadVarSizeUInt(stream, &cid);
-			ReadVarSizeUInt(stream, &mcnt);
+			::ReadVarSizeUInt(stream, &cid);
+			::ReadVarSizeUInt(stream, &mcnt);
 			stream->read((char*)&groupFlags, sizeof(char));
 			for (unsigned int c = 0; c < mcnt; c++) {
 				unsigned int size;
-				ReadVarSizeUInt(stream, &size);
+				::ReadVarSizeUInt(stream, &size);
 			}
 		}
 
@@ -619,7 +705,14 @@ void CInputStreamSerializer::LoadPackage(std::istream* s, void*& root, creg::Cla
 	int endOffset = s->tellg();
 
 	// Read the object data using serialization
+	buffer.resize(std::max(0, ph.objClassRefOffset - ph.objDataOffset));
+	bufferPos = 0;
+
 	s->seekg(ph.objDataOffset);
+
+	if (!buffer.empty() && (!s->read(&buffer[0], buffer.size()) || s->gcount() != (std::streamsize)buffer.size()))
+		throw std::runtime_error("Package file is truncated");
+
 	for (uint a = 0; a < objects.size(); a++)
 	{
 		if (!objects[a].isEmbedded) {
@@ -666,6 +759,7 @@ void CInputStreamSerializer::LoadPackage(std::istream* s, void*& root, creg::Cla
 	s->seekg(endOffset);
 	unfixedPointers.clear();
 	objects.clear();
+	buffer.clear();
 }
 
 ISerializer::~ISerializer() {
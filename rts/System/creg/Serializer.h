@@ -5,10 +5,10 @@
 
 #include "ISerializer.h"
 #include "creg_cond.h"
-#include <map>
+#include <string>
 #include <vector>
-#include <list>
 #include <istream>
+#include <boost/unordered_map.hpp>
 
 namespace creg {
 
@@ -16,47 +16,45 @@ namespace creg {
 	 * Output stream serializer
 	 * Usage: create an instance of this class and call SavePackage
 	 * @see SavePackage
+	 *
+	 * The package is assembled in memory and written to the stream in one
+	 * go; object and member bookkeeping lives in flat arrays indexed by id
+	 * rather than in per-object containers.
 	 */
 	class COutputStreamSerializer : public ISerializer
 	{
 	protected:
 		struct ObjectMember {
-			Class::Member* member;
 			int memberId;
 			int size;
 		};
 		struct ObjectMemberGroup {
 			Class* membersClass;
-			std::vector<COutputStreamSerializer::ObjectMember> members;
-			int size;
+			int firstMember; ///< index into members
+			int numMembers;
 		};
 		struct ObjectRef {
-			ObjectRef() {
-				ptr = 0;
-				id=0;
-				classIndex=0;
-				isEmbedded=false;
-				class_=0;
-			}
-			ObjectRef(void* ptr, int id, bool isEmbedded, Class* class_) {
-				this->ptr = ptr;
-				this->id=id;
-				classIndex=0;
-				this->isEmbedded=isEmbedded;
-				this->class_=class_;
-			}
-			ObjectRef(const ObjectRef&src) :memberGroups(src.memberGroups){
-				ptr=src.ptr;
-				id=src.id;
-				classIndex=src.classIndex;
-				isEmbedded=src.isEmbedded;
-				class_=src.class_;
-			}
+			ObjectRef(void* ptr, int id, bool isEmbedded, Class* class_)
+				: ptr(ptr)
+				, id(id)
+				, classIndex(0)
+				, nextSamePtr(-1)
+				, firstGroup(0)
+				, numGroups(0)
+				, isEmbedded(isEmbedded)
+				, isPending(false)
+				, class_(class_)
+			{}
+
 			void* ptr;
 			int id, classIndex;
+			int nextSamePtr; ///< next object at the same address (e.g. an embedded first member), -1 if none
+			int firstGroup;  ///< index into memberGroups
+			int numGroups;
 			bool isEmbedded;
+			bool isPending;
 			Class* class_;
-			std::vector<COutputStreamSerializer::ObjectMemberGroup> memberGroups;
+
 			bool isThisObject(void* objPtr, Class* objClass, bool objEmbedded) const
 			{
 				if (ptr != objPtr) return false;
@@ -78,18 +76,30 @@ namespace creg {
 		struct ClassRef;
 
 		std::ostream* stream;
-		std::map<void*,std::vector<ObjectRef*> > ptrToId;
-		std::list<ObjectRef> objects;
-		std::vector<ObjectRef*> pendingObjects; // these objects still have to be saved
+		std::vector<char> buffer; ///< everything behind the package header
 
-		// Serialize all class names
-		void WriteObjectInfo();
-		// Helper for instance/ptr saving
-		void WriteObjectRef(void* inst, Class* cls, bool embedded);
+		boost::unordered_map<void*, int> ptrToId; ///< first object at an address
+		std::vector<ObjectRef> objects;
+		std::vector<int> pendingObjects; // these objects still have to be saved
 
+		std::vector<ObjectMemberGroup> memberGroups;
+		std::vector<ObjectMember> members;
+
+		// groups and members of the objects that are being serialized; nested
+		// objects are finished first, so each object's entries stay contiguous
+		std::vector<ObjectMemberGroup> groupStack;
+		std::vector<ObjectMember> memberStack;
+
+		// Helper for instance/ptr saving
 		ObjectRef* FindObjectRef(void* inst, Class* objClass, bool isEmbedded);
+		ObjectRef* AddObjectRef(void* inst, Class* objClass, bool isEmbedded);
 
-		void SerializeObject(Class* c, void* ptr, ObjectRef* objr);
+		void SerializeObject(Class* c, void* ptr, int objId);
+		void SerializeMembers(Class* c, void* ptr);
+
+		void Write(const void* data, int byteSize);
+		void WriteVarSizeUInt(unsigned int val);
+		void WriteZStr(const std::string& str);
 
 	public:
 		COutputStreamSerializer();
@@ -131,6 +141,10 @@ namespace creg {
 		std::istream* stream;
 		std::vector<Class*> classRefs;
 
+		/// the object data section of the package, read in one go
+		std::vector<char> buffer;
+		size_t bufferPos;
+
 		struct UnfixedPtr {
 			void** ptrAddr;
 			int objID;
@@ -153,6 +167,9 @@ namespace creg {
 		std::vector<PostLoadCallback> callbacks;
 
 		void SerializeObject(Class* c, void* ptr);
+
+		void Read(void* data, int byteSize);
+		void ReadVarSizeUInt(unsigned int* val);
 	public:
 		CInputStreamSerializer();
 		~CInputStreamSerializer();
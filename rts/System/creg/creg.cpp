@@ -36,7 +36,7 @@ vector<Class*> System::classes;
 
 ClassBinder::ClassBinder(const char* className, unsigned int cf,
 		ClassBinder* baseClsBinder, IMemberRegistrator** mreg, int instanceSize, int instanceAlignment, bool hasVTable,
-		void (*constructorProc)(void* inst), void (*destructorProc)(void* inst))
+		void* (*newProc)(), void (*deleteProc)(void* inst))
 	: class_(NULL)
 	, base(baseClsBinder)
 	, flags((ClassFlags)cf)
@@ -45,8 +45,8 @@ ClassBinder::ClassBinder(const char* className, unsigned int cf,
 	, size(instanceSize)
 	, alignment(instanceAlignment)
 	, hasVTable(hasVTable)
-	, constructor(constructorProc)
-	, destructor(destructorProc)
+	, newInstance(newProc)
+	, deleteInstance(deleteProc)
 	, nextBinder(NULL)
 {
 
@@ -234,18 +234,18 @@ void Class::SetMemberFlag(const char* name, ClassMemberFlag f)
 
 void* Class::CreateInstance()
 {
-	void* inst = operator_new(binder->size);
-
-	if (binder->constructor) {
-		binder->constructor(inst);
+	if (binder->newInstance) {
+		return binder->newInstance();
 	}
-	return inst;
+
+	return operator_new(binder->size);
 }
 
 void Class::DeleteInstance(void* inst)
 {
-	if (binder->destructor) {
-		binder->destructor(inst);
+	if (binder->deleteInstance) {
+		binder->deleteInstance(inst);
+		return;
 	}
 
 	operator_delete(inst);
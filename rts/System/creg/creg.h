@@ -86,8 +86,8 @@ namespace creg {
 	public:
 		ClassBinder(const char* className, unsigned int cf, ClassBinder* base,
 				IMemberRegistrator** mreg, int instanceSize, int instanceAlignment, bool hasVTable,
-				void (*constructorProc)(void* instance),
-				void (*destructorProc)(void* instance));
+				void* (*newProc)(),
+				void (*deleteProc)(void* instance));
 
 		Class* class_;
 		ClassBinder* base;
@@ -98,12 +98,14 @@ namespace creg {
 		int alignment;
 		bool hasVTable;
 
-		void (*constructor)(void* instance);
 		/**
-		 * Needed for classes without virtual destructor.
+		 * Create and delete instances with new and delete, so classes
+		 * with their own operator new/delete (memory pools) get them.
+		 * Delete is also needed for classes without virtual destructor.
 		 * (classes/structs declared with CR_DECLARE_STRUCT)
 		 */
-		void (*destructor)(void* instance);
+		void* (*newInstance)();
+		void (*deleteInstance)(void* instance);
 
 		ClassBinder* nextBinder;
 	};
@@ -369,6 +371,8 @@ namespace creg {
 	static creg::IMemberRegistrator* memberRegistrator;	 \
 	static void _ConstructInstance(void* d);			\
 	static void _DestructInstance(void* d);			\
+	static void* _NewInstance();					\
+	static void _DeleteInstance(void* d);			\
 	friend struct TCls##MemberRegistrator;			\
 	inline static creg::Class* StaticClass() { return binder.class_; } \
 	virtual creg::Class* GetClass() const; \
@@ -386,6 +390,8 @@ namespace creg {
 	static creg::IMemberRegistrator* memberRegistrator;	\
 	static void _ConstructInstance(void* d);			\
 	static void _DestructInstance(void* d);			\
+	static void* _NewInstance();					\
+	static void _DeleteInstance(void* d);			\
 	friend struct TStr##MemberRegistrator;			\
 	inline static creg::Class* StaticClass() { return binder.class_; } \
 	creg::Class* GetClass() const; \
@@ -408,9 +414,11 @@ namespace creg {
 #define CR_BIND_DERIVED(TCls, TBase, ctor_args) \
 	creg::IMemberRegistrator* TCls::memberRegistrator=0;	\
 	creg::Class* TCls::GetClass() const { return binder.class_; } \
-	void TCls::_ConstructInstance(void* d) { new(d) MyType ctor_args; } \
+	void TCls::_ConstructInstance(void* d) { ::new(d) MyType ctor_args; } \
 	void TCls::_DestructInstance(void* d) { ((MyType*)d)->~MyType(); } \
-	creg::ClassBinder TCls::binder(#TCls, 0, &TBase::binder, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_ConstructInstance, TCls::_DestructInstance);
+	void* TCls::_NewInstance() { return new MyType ctor_args; } \
+	void TCls::_DeleteInstance(void* d) { delete ((MyType*)d); } \
+	creg::ClassBinder TCls::binder(#TCls, 0, &TBase::binder, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_NewInstance, TCls::_DeleteInstance);
 
 /** @def CR_BIND_DERIVED_SUB
  * Bind a derived class inside another class to creg
@@ -423,9 +431,11 @@ namespace creg {
 #define CR_BIND_DERIVED_SUB(TSuper, TCls, TBase, ctor_args) \
 	creg::IMemberRegistrator* TSuper::TCls::memberRegistrator=0;	 \
 	creg::Class* TSuper::TCls::GetClass() const { return binder.class_; }  \
-	void TSuper::TCls::_ConstructInstance(void* d) { new(d) TCls ctor_args; }  \
+	void TSuper::TCls::_ConstructInstance(void* d) { ::new(d) TCls ctor_args; }  \
 	void TSuper::TCls::_DestructInstance(void* d) { ((TCls*)d)->~TCls(); }  \
-	creg::ClassBinder TSuper::TCls::binder(#TSuper "::" #TCls, 0, &TBase::binder, &TSuper::TCls::memberRegistrator, sizeof(TSuper::TCls), alignof(TCls), TCls::hasVTable, TSuper::TCls::_ConstructInstance, TSuper::TCls::_DestructInstance);
+	void* TSuper::TCls::_NewInstance() { return new TCls ctor_args; } \
+	void TSuper::TCls::_DeleteInstance(void* d) { delete ((TCls*)d); } \
+	creg::ClassBinder TSuper::TCls::binder(#TSuper "::" #TCls, 0, &TBase::binder, &TSuper::TCls::memberRegistrator, sizeof(TSuper::TCls), alignof(TCls), TCls::hasVTable, TSuper::TCls::_NewInstance, TSuper::TCls::_DeleteInstance);
 
 /** @def CR_BIND
  * Bind a class not derived from CObject
@@ -436,25 +446,31 @@ namespace creg {
 #define CR_BIND(TCls, ctor_args) \
 	creg::IMemberRegistrator* TCls::memberRegistrator=0;	\
 	creg::Class* TCls::GetClass() const { return binder.class_; } \
-	void TCls::_ConstructInstance(void* d) { new(d) MyType ctor_args; } \
+	void TCls::_ConstructInstance(void* d) { ::new(d) MyType ctor_args; } \
 	void TCls::_DestructInstance(void* d) { ((MyType*)d)->~MyType(); } \
-	creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_ConstructInstance, TCls::_DestructInstance);
+	void* TCls::_NewInstance() { return new MyType ctor_args; } \
+	void TCls::_DeleteInstance(void* d) { delete ((MyType*)d); } \
+	creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_NewInstance, TCls::_DeleteInstance);
 
 #ifdef __clang__
 	// LLVM/Clang expects a different order
 	#define CR_BIND_TEMPLATE(TCls, ctor_args) \
 		template<> creg::IMemberRegistrator* TCls::memberRegistrator=0; \
-		template<> void TCls::_ConstructInstance(void* d) { new(d) MyType ctor_args; } \
+		template<> void TCls::_ConstructInstance(void* d) { ::new(d) MyType ctor_args; } \
 		template<> void TCls::_DestructInstance(void* d) { ((MyType*)d)->~MyType(); } \
-		template<> creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_ConstructInstance, TCls::_DestructInstance); \
+		template<> void* TCls::_NewInstance() { return new MyType ctor_args; } \
+		template<> void TCls::_DeleteInstance(void* d) { delete ((MyType*)d); } \
+		template<> creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_NewInstance, TCls::_DeleteInstance); \
 		template<> creg::Class* TCls::GetClass() const { return binder.class_; }
 #else
 	#define CR_BIND_TEMPLATE(TCls, ctor_args) \
 		template<> creg::IMemberRegistrator* TCls::memberRegistrator=0; \
 		template<> creg::Class* TCls::GetClass() const { return binder.class_; } \
-		template<> void TCls::_ConstructInstance(void* d) { new(d) MyType ctor_args; } \
+		template<> void TCls::_ConstructInstance(void* d) { ::new(d) MyType ctor_args; } \
 		template<> void TCls::_DestructInstance(void* d) { ((MyType*)d)->~MyType(); } \
-		template<> creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_ConstructInstance, TCls::_DestructInstance);
+		template<> void* TCls::_NewInstance() { return new MyType ctor_args; } \
+		template<> void TCls::_DeleteInstance(void* d) { delete ((MyType*)d); } \
+		template<> creg::ClassBinder TCls::binder(#TCls, 0, 0, &TCls::memberRegistrator, sizeof(TCls), alignof(TCls), TCls::hasVTable, TCls::_NewInstance, TCls::_DeleteInstance);
 #endif
 
 /** @def CR_BIND_DERIVED_INTERFACE
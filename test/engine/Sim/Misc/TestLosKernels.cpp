@@ -0,0 +1,353 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/LosKernels.h"
+#include "Sim/Misc/LosMap.h"
+#include "Game/GlobalUnsynced.h"
+#include "Map/ReadMap.h"
+#include "Map/SMF/SMFFormat.h"
+#include "System/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define BOOST_TEST_MODULE LosKernels
+#include <boost/test/unit_test.hpp>
+
+// runs CLosAlgorithm and CLosMap with the scalar and with the SIMD kernels
+// selected, compares the results and reports their timings; set
+// LOSKERNELS_SMF=<path to an uncompressed .smf file> to run on a real
+// map heightmap instead of the synthetic one
+static const int LOS_MIP_LEVEL = 1;
+static const int NUM_QUERIES = 4000;
+static const int MAX_RADIUS = 40;
+
+// CLosMap only touches these when it sends readmap events (LOS maps of
+// the local allyteam), which the maps below never do
+CGlobalSynced* gs = NULL;
+CGlobalUnsynced* gu = NULL;
+CReadMap* readMap = NULL;
+void CReadMap::UpdateLOS(const SRectangle& rect) {}
+
+struct HeightMap {
+	int sizeX;
+	int sizeY;
+	std::vector<float> heights;
+};
+
+
+static bool LoadSMFHeightMap(const char* fileName, HeightMap* hm)
+{
+	FILE* f = fopen(fileName, "rb");
+
+	if (f == NULL)
+		return false;
+
+	SMFHeader header;
+	bool ok = (fread(&header, sizeof(header), 1, f) == 1) && (header.mapx > 0) && (header.mapy > 0);
+
+	std::vector<unsigned short> raw((header.mapx + 1) * (header.mapy + 1));
+
+	ok = ok && (fseek(f, header.heightmapPtr, SEEK_SET) == 0);
+	ok = ok && (fread(&raw[0], sizeof(unsigned short), raw.size(), f) == raw.size());
+	fclose(f);
+
+	if (!ok)
+		return false;
+
+	// point-sample the corner heightmap down to LOS resolution
+	const int step = 1 << LOS_MIP_LEVEL;
+	const float scale = (header.maxHeight - header.minHeight) / 65536.0f;
+
+	hm->sizeX = header.mapx >> LOS_MIP_LEVEL;
+	hm->sizeY = header.mapy >> LOS_MIP_LEVEL;
+	hm->heights.resize(hm->sizeX * hm->sizeY);
+
+	for (int y = 0; y < hm->sizeY; y++) {
+		for (int x = 0; x < hm->sizeX; x++) {
+			hm->heights[y * hm->sizeX + x] = header.minHeight + raw[(y * step) * (header.mapx + 1) + (x * step)] * scale;
+		}
+	}
+
+	return true;
+}
+
+static void MakeSyntheticHeightMap(HeightMap* hm)
+{
+	hm->sizeX = 512;
+	hm->sizeY = 512;
+	hm->heights.resize(hm->sizeX * hm->sizeY);
+
+	unsigned int seed = 1;
+
+	for (int y = 0; y < hm->sizeY; y++) {
+		for (int x = 0; x < hm->sizeX; x++) {
+			seed = seed * 1103515245 + 12345;
+
+			const float hills = 150.0f * std::sin(x * 0.031f) * std::cos(y * 0.023f);
+			const float ridges = 60.0f * std::sin((x + y) * 0.11f);
+			const float noise = ((seed >> 16) & 0xFF) * 0.1f;
+
+			hm->heights[y * hm->sizeX + x] = hills + ridges + noise;
+		}
+	}
+}
+
+static const HeightMap& GetHeightMap()
+{
+	static HeightMap hm;
+
+	if (hm.heights.empty()) {
+		const char* smf = getenv("LOSKERNELS_SMF");
+
+		if (smf == NULL || !LoadSMFHeightMap(smf, &hm)) {
+			MakeSyntheticHeightMap(&hm);
+		}
+	}
+
+	return hm;
+}
+
+
+struct Query {
+	int2 pos;
+	int radius;
+	float height;
+	int amount;
+};
+
+// random positions, including ones near the edges (CLosAlgorithm::SafeLosAdd)
+static std::vector<Query> MakeQueries(const HeightMap& hm, unsigned int seed)
+{
+	std::vector<Query> queries(NUM_QUERIES);
+
+	for (int q = 0; q < NUM_QUERIES; q++) {
+		seed = seed * 1103515245 + 12345; queries[q].pos.x = (seed >> 8) % hm.sizeX;
+		seed = seed * 1103515245 + 12345; queries[q].pos.y = (seed >> 8) % hm.sizeY;
+		seed = seed * 1103515245 + 12345; queries[q].radius = 1 + (seed >> 8) % MAX_RADIUS;
+		seed = seed * 1103515245 + 12345; queries[q].height = 5.0f + ((seed >> 8) % 100);
+
+		// removals let the counters wrap around below zero, too
+		queries[q].amount = ((q % 3) == 2)? -1: 1;
+	}
+
+	return queries;
+}
+
+static void UseKernels(bool simd)
+{
+	LosKernels::SelectKernels(simd? (LosKernels::CPU_BIT_SSE | LosKernels::CPU_BIT_SSE2): 0);
+}
+
+static void LosAddAll(const HeightMap& hm, const std::vector<Query>& queries, std::vector< std::vector<int> >& squares)
+{
+	CLosAlgorithm losAlgo(int2(hm.sizeX, hm.sizeY), -1e6f, 15.0f, &hm.heights[0]);
+
+	squares.clear();
+	squares.resize(queries.size());
+
+	for (size_t q = 0; q < queries.size(); q++) {
+		losAlgo.LosAdd(queries[q].pos, queries[q].radius, queries[q].height, squares[q]);
+	}
+}
+
+template<typename F> static double TimeMSecs(F f)
+{
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	f();
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+
+
+BOOST_AUTO_TEST_CASE(LosAdd)
+{
+	const HeightMap& hm = GetHeightMap();
+	const std::vector<Query> queries = MakeQueries(hm, 7);
+
+	std::vector< std::vector<int> > scalarSquares;
+	std::vector< std::vector<int> > simdSquares;
+
+	// warm up the LOS tables and the scratch arena
+	UseKernels(false); LosAddAll(hm, queries, scalarSquares);
+
+	UseKernels(false); const double scalarTime = TimeMSecs([&]() { LosAddAll(hm, queries, scalarSquares); });
+	UseKernels(true);  const double simdTime = TimeMSecs([&]() { LosAddAll(hm, queries, simdSquares); });
+
+	BOOST_TEST_MESSAGE("CLosAlgorithm::LosAdd on " << hm.sizeX << "x" << hm.sizeY << " squares, " << NUM_QUERIES << " queries: "
+		<< scalarTime << "ms (scalar), " << simdTime << "ms (" << LosKernels::GetTraceLineName() << ")");
+
+	// same squares in the same order
+	BOOST_CHECK(!scalarSquares[0].empty());
+	BOOST_CHECK(scalarSquares == simdSquares);
+}
+
+BOOST_AUTO_TEST_CASE(AddMapArea)
+{
+	const HeightMap& hm = GetHeightMap();
+	const std::vector<Query> queries = MakeQueries(hm, 11);
+
+	CLosMap scalarMap; scalarMap.SetSize(hm.sizeX, hm.sizeY, false);
+	CLosMap simdMap; simdMap.SetSize(hm.sizeX, hm.sizeY, false);
+
+	// what AddMapArea did before it was split into spans
+	std::vector<unsigned short> refCells(hm.sizeX * hm.sizeY, 0);
+
+	for (size_t q = 0; q < queries.size(); q++) {
+		const Query& qu = queries[q];
+		const int rr = qu.radius * qu.radius;
+
+		for (int y = std::max(0, qu.pos.y - qu.radius); y <= std::min(hm.sizeY - 1, qu.pos.y + qu.radius); y++) {
+			for (int x = std::max(0, qu.pos.x - qu.radius); x <= std::min(hm.sizeX - 1, qu.pos.x + qu.radius); x++) {
+				if ((qu.pos.x - x) * (qu.pos.x - x) > (rr - (qu.pos.y - y) * (qu.pos.y - y)))
+					continue;
+
+				refCells[y * hm.sizeX + x] += qu.amount;
+			}
+		}
+	}
+
+	UseKernels(false);
+	const double scalarTime = TimeMSecs([&]() {
+		for (size_t q = 0; q < queries.size(); q++) {
+			scalarMap.AddMapArea(queries[q].pos, -1, queries[q].radius, queries[q].amount);
+		}
+	});
+
+	UseKernels(true);
+	const double simdTime = TimeMSecs([&]() {
+		for (size_t q = 0; q < queries.size(); q++) {
+			simdMap.AddMapArea(queries[q].pos, -1, queries[q].radius, queries[q].amount);
+		}
+	});
+
+	BOOST_TEST_MESSAGE("CLosMap::AddMapArea on " << hm.sizeX << "x" << hm.sizeY << " squares, " << NUM_QUERIES << " circles: "
+		<< scalarTime << "ms (scalar), " << simdTime << "ms (" << LosKernels::GetAddSpanName() << ")");
+
+	int numScalarDiffs = 0;
+	int numSimdDiffs = 0;
+
+	for (int i = 0; i < hm.sizeX * hm.sizeY; i++) {
+		numScalarDiffs += (scalarMap[i] != refCells[i]);
+		numSimdDiffs += (simdMap[i] != refCells[i]);
+	}
+
+	BOOST_CHECK(numScalarDiffs == 0);
+	BOOST_CHECK(numSimdDiffs == 0);
+}
+
+BOOST_AUTO_TEST_CASE(AddMapSquares)
+{
+	// the LOS maps as CLosHandler fills them, with either set of kernels
+	const HeightMap& hm = GetHeightMap();
+	const std::vector<Query> queries = MakeQueries(hm, 13);
+
+	CLosMap scalarMap; scalarMap.SetSize(hm.sizeX, hm.sizeY, false);
+	CLosMap simdMap; simdMap.SetSize(hm.sizeX, hm.sizeY, false);
+
+	std::vector< std::vector<int> > squares;
+
+	UseKernels(false);
+	LosAddAll(hm, queries, squares);
+
+	for (size_t q = 0; q < queries.size(); q++) {
+		scalarMap.AddMapSquares(squares[q], -1, queries[q].amount);
+	}
+
+	UseKernels(true);
+	LosAddAll(hm, queries, squares);
+
+	for (size_t q = 0; q < queries.size(); q++) {
+		simdMap.AddMapSquares(squares[q], -1, queries[q].amount);
+	}
+
+	int numDiffs = 0;
+	int numSeen = 0;
+
+	for (int i = 0; i < hm.sizeX * hm.sizeY; i++) {
+		numDiffs += (scalarMap[i] != simdMap[i]);
+		numSeen += (scalarMap[i] != 0);
+	}
+
+	BOOST_CHECK(numSeen > 0);
+	BOOST_CHECK(numDiffs == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LosAddBatch)
+{
+	// CLosHandler's move batches against the per-instance updates they replace
+	static const int NUM_ALLYTEAMS = 5;
+
+	const HeightMap& hm = GetHeightMap();
+	const std::vector<Query> queries = MakeQueries(hm, 17);
+
+	CLosAlgorithm losAlgo(int2(hm.sizeX, hm.sizeY), -1e6f, 15.0f, &hm.heights[0]);
+
+	std::vector<CLosMap> serialMaps(NUM_ALLYTEAMS);
+	std::vector<CLosMap> batchMaps(NUM_ALLYTEAMS);
+
+	for (int a = 0; a < NUM_ALLYTEAMS; a++) {
+		serialMaps[a].SetSize(hm.sizeX, hm.sizeY, false);
+		batchMaps[a].SetSize(hm.sizeX, hm.sizeY, false);
+	}
+
+	std::vector< std::vector<int> > serialSquares(queries.size());
+	std::vector< std::vector<int> > batchSquares(queries.size());
+	std::vector<CLosAlgorithm::BatchItem> items(queries.size());
+
+	for (size_t q = 0; q < queries.size(); q++) {
+		const int allyTeam = q % NUM_ALLYTEAMS;
+
+		losAlgo.LosAdd(queries[q].pos, queries[q].radius, queries[q].height, serialSquares[q]);
+		serialMaps[allyTeam].AddMapSquares(serialSquares[q], -1, 1);
+
+		// batches must replace any squares left over from earlier ray-casts
+		batchSquares[q].assign(3, 0);
+
+		const CLosAlgorithm::BatchItem item = {queries[q].pos, queries[q].radius, queries[q].height, allyTeam, &batchSquares[q]};
+		items[q] = item;
+	}
+
+	for (int numThreads = 1; numThreads <= 4; numThreads *= 2) {
+		ThreadPool::SetThreadCount(numThreads);
+
+		for (int a = 0; a < NUM_ALLYTEAMS; a++) {
+			batchMaps[a].SetSize(hm.sizeX, hm.sizeY, false);
+		}
+
+		const double batchTime = TimeMSecs([&]() { losAlgo.LosAddBatch(items, batchMaps); });
+
+		BOOST_TEST_MESSAGE("CLosAlgorithm::LosAddBatch with " << numThreads << " thread(s): " << batchTime << "ms");
+
+		int numDiffs = 0;
+		int numSeen = 0;
+
+		for (int a = 0; a < NUM_ALLYTEAMS; a++) {
+			for (int i = 0; i < hm.sizeX * hm.sizeY; i++) {
+				numDiffs += (serialMaps[a][i] != batchMaps[a][i]);
+				numSeen += (serialMaps[a][i] != 0);
+			}
+		}
+
+		BOOST_CHECK(numSeen > 0);
+		BOOST_CHECK(numDiffs == 0);
+		BOOST_CHECK(serialSquares == batchSquares);
+	}
+
+	ThreadPool::SetThreadCount(1);
+}
+
+BOOST_AUTO_TEST_CASE(SelectKernels)
+{
+	LosKernels::SelectKernels(0);
+	BOOST_CHECK(LosKernels::TraceLine == LosKernels::TraceLineScalar);
+	BOOST_CHECK(LosKernels::AddSpan == LosKernels::AddSpanScalar);
+
+	LosKernels::SelectKernels(LosKernels::CPU_BIT_SSE | LosKernels::CPU_BIT_SSE2);
+	BOOST_CHECK((LosKernels::TraceLine == LosKernels::TraceLineSSE) == LosKernels::HaveKernel(LosKernels::CPU_BIT_SSE));
+	BOOST_CHECK((LosKernels::AddSpan == LosKernels::AddSpanSSE2) == LosKernels::HaveKernel(LosKernels::CPU_BIT_SSE2));
+}
@@ -0,0 +1,352 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Projectiles/ExpGenSpawnProgram.h"
+#include "System/float3.h"
+#include "System/Util.h"
+#include "lib/streflop/streflop_cond.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE ExpGenSpawnProgram
+#include <boost/test/unit_test.hpp>
+
+typedef CExpGenSpawnProgram P;
+
+// number of explosions per CEG, each spawning all of its projectiles
+static const int NUM_EXPLOSIONS = 20000;
+static const int NUM_RING_PROJECTILES = 256;
+static const int NUM_TIMING_RUNS = 5;
+
+
+// stand-in for the config members of a CEG projectile class
+struct Projectile {
+	float3 pos;
+	float3 speed;
+	float3 dir;
+	float size;
+	float sizeGrowth;
+	float alpha;
+	float alphaFalloff;
+	float rotation;
+	float drag;
+	int ttl;
+	int frames;
+	unsigned char color[4];
+	void* texture;
+};
+
+struct Property {
+	char store;
+	int offset;
+	const char* script;
+};
+
+struct Spawner {
+	const char* name;
+	int count;
+	std::vector<Property> props;
+};
+
+#define PROP(store, member, script) {store, offsetof(Projectile, member), script}
+#define PROP_ELEM(store, member, elemType, index, script) {store, int(offsetof(Projectile, member) + sizeof(elemType) * index), script}
+
+// spawners shaped like the ones of common games (dirt, smoke, sparks, flashes)
+static const Property dirtProps[] = {
+	PROP(P::OP_DIR, dir, "dir"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 0, "-1 r2"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 1, "0.5 r1.5"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 2, "-1 r2"),
+	PROP(P::OP_STOREF, size, "2 d0.05"),
+	PROP(P::OP_STOREF, sizeGrowth, "0.1"),
+	PROP(P::OP_STOREF, alpha, "1"),
+	PROP(P::OP_STOREF, alphaFalloff, "0.02 r0.01"),
+	PROP(P::OP_STOREI, ttl, "15 r10"),
+	PROP(P::OP_STOREP, texture, "dirt"),
+};
+static const Property smokeProps[] = {
+	PROP_ELEM(P::OP_STOREF, pos, float, 0, "-8 r16"),
+	PROP_ELEM(P::OP_STOREF, pos, float, 1, "i4"),
+	PROP_ELEM(P::OP_STOREF, pos, float, 2, "-8 r16"),
+	PROP(P::OP_STOREF, size, "r5 8"),
+	PROP(P::OP_STOREF, sizeGrowth, "0.3 r0.2"),
+	PROP(P::OP_STOREF, drag, "0.9"),
+	PROP(P::OP_STOREI, ttl, "40 r20 i2"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 0, "180 r50"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 1, "180"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 2, "160 r30"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 3, "255"),
+	PROP(P::OP_STOREP, texture, "smoke"),
+};
+static const Property sparkProps[] = {
+	PROP(P::OP_DIR, dir, "dir"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 0, "r6.2832 y0 s1 x1"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 1, "r2 y1 1 x1"),
+	PROP_ELEM(P::OP_STOREF, speed, float, 2, "i0.7 m6.2832 s3"),
+	PROP(P::OP_STOREF, rotation, "i30 k45 p1.5"),
+	PROP(P::OP_STOREF, size, "r1 y2 d0.02 a2 q2"),
+	PROP(P::OP_STOREI, frames, "i m4"),
+	PROP(P::OP_STOREI, ttl, "8 r4"),
+};
+static const Property flashProps[] = {
+	PROP(P::OP_STOREF, size, "d0.8"),
+	PROP(P::OP_STOREF, sizeGrowth, "-0.5"),
+	PROP(P::OP_STOREF, alpha, "0.8"),
+	PROP(P::OP_STOREI, ttl, "6"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 0, "255"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 1, "200 r55"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 2, "100"),
+	PROP(P::OP_STOREP, texture, "flash"),
+};
+// properties defined more than once; the last definition wins, so none of
+// these constants may be baked ahead of the other setters
+static const Property overlapProps[] = {
+	PROP(P::OP_STOREF, size, "1"),
+	PROP(P::OP_STOREF, size, "r2"),
+	PROP(P::OP_STOREF, alpha, "r1"),
+	PROP(P::OP_STOREF, alpha, "0.5"),
+	PROP(P::OP_STOREI, ttl, "3"),
+	PROP(P::OP_STOREI, ttl, "4"),
+	PROP_ELEM(P::OP_STOREC, color, unsigned char, 1, "7"),
+	PROP(P::OP_STOREI, frames, "r3"),
+	PROP(P::OP_DIR, dir, "dir"),
+	PROP_ELEM(P::OP_STOREF, dir, float, 1, "2"),
+};
+
+#undef PROP_ELEM
+#undef PROP
+
+#define SPAWNER(name, count, props) {name, count, std::vector<Property>(props, props + sizeof(props) / sizeof(props[0]))}
+
+static std::vector<Spawner> MakeSpawners()
+{
+	const Spawner spawners[] = {
+		SPAWNER("dirt",    8, dirtProps),
+		SPAWNER("smoke",   4, smokeProps),
+		SPAWNER("sparks", 16, sparkProps),
+		SPAWNER("flash",   1, flashProps),
+		SPAWNER("overlap", 2, overlapProps),
+	};
+
+	return std::vector<Spawner>(spawners, spawners + sizeof(spawners) / sizeof(spawners[0]));
+}
+
+#undef SPAWNER
+
+
+
+static unsigned int randSeed = 1;
+static float RandFloat() {
+	randSeed = randSeed * 214013 + 2531011;
+	return ((randSeed >> 16) & 0x7FFF) / float(0x8000);
+}
+
+template<typename F> static double TimeSecs(F f)
+{
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	f();
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+
+// what CCustomExplosionGenerator::ParseExplosionCode emits for these properties
+static std::vector<char> BuildCode(const Property* props, int numProps)
+{
+	std::string code;
+
+	for (int n = 0; n < numProps; n++) {
+		const Property& prop = props[n];
+		const boost::uint16_t ofs = prop.offset;
+
+		if (prop.store == P::OP_DIR) {
+			code += P::OP_DIR;
+		} else if (prop.store == P::OP_STOREP) {
+			// any unique address does, the setter only copies it
+			const void* tex = prop.script;
+			code += P::OP_LOADP;
+			code.append((const char*) &tex, ((const char*) &tex) + sizeof(void*));
+			code += P::OP_STOREP;
+		} else {
+			P::ParseValueCode(prop.script, code);
+			code += prop.store;
+		}
+
+		code.append((const char*) &ofs, (const char*) &ofs + 2);
+	}
+
+	code += (char) P::OP_END;
+	return std::vector<char>(code.begin(), code.end());
+}
+
+
+// the op by op interpreter the programs replace
+static void ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir)
+{
+	float val = 0.0f;
+	void* ptr = NULL;
+	float buffer[P::BUFFER_SIZE] = {0.0f};
+
+	for (;;) {
+		switch (*(code++)) {
+			case P::OP_END: {
+				return;
+			}
+			case P::OP_STOREI: {
+				boost::uint16_t offset; memcpy(&offset, code, 2); code += 2;
+				*(int*) (instance + offset) = (int) val;
+				val = 0.0f;
+			} break;
+			case P::OP_STOREF: {
+				boost::uint16_t offset; memcpy(&offset, code, 2); code += 2;
+				*(float*) (instance + offset) = val;
+				val = 0.0f;
+			} break;
+			case P::OP_STOREC: {
+				boost::uint16_t offset; memcpy(&offset, code, 2); code += 2;
+				*(unsigned char*) (instance + offset) = (int) val;
+				val = 0.0f;
+			} break;
+			case P::OP_LOADP: {
+				memcpy(&ptr, code, sizeof(void*)); code += sizeof(void*);
+			} break;
+			case P::OP_STOREP: {
+				boost::uint16_t offset; memcpy(&offset, code, 2); code += 2;
+				*(void**) (instance + offset) = ptr;
+				ptr = NULL;
+			} break;
+			case P::OP_DIR: {
+				boost::uint16_t offset; memcpy(&offset, code, 2); code += 2;
+				*reinterpret_cast<float3*>(instance + offset) = dir;
+			} break;
+			default: {
+				const char op = *(code - 1);
+				float f; memcpy(&f, code, 4);
+				int i; memcpy(&i, code, 4);
+				code += 4;
+
+				switch (op) {
+					case P::OP_ADD:      { val += f; } break;
+					case P::OP_RAND:     { val += RandFloat() * f; } break;
+					case P::OP_DAMAGE:   { val += damage * f; } break;
+					case P::OP_INDEX:    { val += spawnIndex * f; } break;
+					case P::OP_SAWTOOTH: { val -= f * math::floor(val / f); } break;
+					case P::OP_DISCRETE: { val = f * math::floor(SafeDivide(val, f)); } break;
+					case P::OP_SINE:     { val = f * math::sin(val); } break;
+					case P::OP_YANK:     { buffer[i] = val; val = 0; } break;
+					case P::OP_MULTIPLY: { val *= buffer[i]; } break;
+					case P::OP_ADDBUFF:  { val += buffer[i]; } break;
+					case P::OP_POW:      { val = math::pow(val, f); } break;
+					case P::OP_POWBUFF:  { val = math::pow(val, buffer[i]); } break;
+					default:             { BOOST_FAIL("unknown op"); } break;
+				}
+			} break;
+		}
+	}
+}
+
+
+
+BOOST_AUTO_TEST_CASE(SameResultsAsInterpreter)
+{
+	const std::vector<Spawner> ceg = MakeSpawners();
+
+	std::vector< std::vector<char> > codes;
+	std::vector<CExpGenSpawnProgram> programs(ceg.size());
+
+	for (size_t n = 0; n < ceg.size(); n++) {
+		codes.push_back(BuildCode(&ceg[n].props[0], ceg[n].props.size()));
+		BOOST_CHECK(programs[n].Compile(&codes[n][0]));
+	}
+
+	int numSpawned = 0;
+
+	for (size_t n = 0; n < ceg.size(); n++)
+		numSpawned += ceg[n].count * NUM_EXPLOSIONS;
+
+	// value-initialised, which zeroes the padding as well; whole
+	// projectiles are compared below
+	std::vector<Projectile> interpreted(numSpawned);
+	std::vector<Projectile> compiled(numSpawned);
+
+	const float3 dir(0.0f, 1.0f, 0.0f);
+
+	randSeed = 1;
+
+	for (int e = 0, k = 0; e < NUM_EXPLOSIONS; e++) {
+		for (size_t n = 0; n < ceg.size(); n++) {
+			for (int c = 0; c < ceg[n].count; c++) {
+				ExecuteExplosionCode(&codes[n][0], 10.0f + e % 300, (char*) &interpreted[k++], c, dir);
+			}
+		}
+	}
+
+	randSeed = 1;
+
+	for (int e = 0, k = 0; e < NUM_EXPLOSIONS; e++) {
+		for (size_t n = 0; n < ceg.size(); n++) {
+			for (int c = 0; c < ceg[n].count; c++) {
+				programs[n].Execute((char*) &compiled[k++], 10.0f + e % 300, c, dir, &RandFloat);
+			}
+		}
+	}
+
+	BOOST_CHECK(memcmp(&interpreted[0], &compiled[0], sizeof(Projectile) * numSpawned) == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(SpawnerTimings)
+{
+	const std::vector<Spawner> ceg = MakeSpawners();
+	const float3 dir(0.0f, 1.0f, 0.0f);
+
+	// an explosion only spawns a few dozen projectiles, which stay in cache
+	// until Init; reuse a small ring of them so the timings do not measure
+	// the memory bandwidth instead
+	std::vector<Projectile> ring(NUM_RING_PROJECTILES);
+
+	for (size_t n = 0; n < ceg.size(); n++) {
+		const std::vector<char> code = BuildCode(&ceg[n].props[0], ceg[n].props.size());
+
+		CExpGenSpawnProgram program;
+		BOOST_CHECK(program.Compile(&code[0]));
+
+		double interpreterTime = 1e9;
+		double programTime = 1e9;
+
+		// best of a few runs, single runs are too noisy on a loaded machine
+		for (int run = 0; run < NUM_TIMING_RUNS; run++) {
+			interpreterTime = std::min(interpreterTime, TimeSecs([&]() {
+				for (int e = 0, k = 0; e < NUM_EXPLOSIONS; e++) {
+					for (int c = 0; c < ceg[n].count; c++) {
+						ExecuteExplosionCode(&code[0], 10.0f + e % 300, (char*) &ring[(k++) % NUM_RING_PROJECTILES], c, dir);
+					}
+				}
+			}));
+			programTime = std::min(programTime, TimeSecs([&]() {
+				for (int e = 0, k = 0; e < NUM_EXPLOSIONS; e++) {
+					for (int c = 0; c < ceg[n].count; c++) {
+						program.Execute((char*) &ring[(k++) % NUM_RING_PROJECTILES], 10.0f + e % 300, c, dir, &RandFloat);
+					}
+				}
+			}));
+		}
+
+		BOOST_TEST_MESSAGE(ceg[n].name << ": " << (ceg[n].count * NUM_EXPLOSIONS) << " projectiles, interpreter "
+			<< (interpreterTime * 1000.0) << "ms, compiled " << (programTime * 1000.0) << "ms");
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(RejectsUnknownOps)
+{
+	const char code[] = {P::OP_ADD, 0, 0, 0, 0, 42, P::OP_END};
+
+	CExpGenSpawnProgram program;
+	BOOST_CHECK(!program.Compile(code));
+	BOOST_CHECK(program.empty());
+}
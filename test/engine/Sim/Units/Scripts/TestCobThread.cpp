@@ -0,0 +1,1340 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/Scripts/CobEngine.h"
+#include "Sim/Units/Scripts/CobFile.h"
+#include "Sim/Units/Scripts/CobInstance.h"
+#include "Sim/Units/Scripts/CobInstructions.h"
+#include "Sim/Units/Scripts/CobThread.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Lua/LuaRules.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/MemPool.h"
+#include "System/Sound/ISound.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// LuaRules.h pulls in lstate.h, whose G(L) macro breaks
+// the header-only Boost.Test (execution_monitor.ipp)
+#undef G
+
+#define BOOST_TEST_MODULE CobThread
+#include <boost/test/unit_test.hpp>
+
+// runs COB scripts through CCobThread::Tick and through a copy of the
+// interpreter it replaced (RefCobThread below, which reads the raw code
+// and patches CALLs in place) and compares everything the scripts did
+static const int MAX_TICKS = 16;
+static const int NUM_RANDOM_PROGRAMS = 300;
+
+
+/******************************************************************************/
+// everything a script does through its owner ends up in here
+
+static std::vector<std::string> trace;
+static std::vector<CCobThread*> startedThreads;
+static unsigned int testRandSeed = 1;
+
+static void Trace(const char* fmt, ...)
+{
+	char buf[256];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	trace.push_back(buf);
+}
+
+static void TraceSleep(int wakeTime) { Trace("sleep %d", wakeTime); }
+
+static void TraceStart(CCobThread* thread)
+{
+	std::string args;
+	const int numArgs = thread->CheckStack(-1u, false);
+
+	for (int i = 0; i < numArgs; i++) {
+		char buf[16];
+		snprintf(buf, sizeof(buf), " %d", thread->GetStackVal(i));
+		args += buf;
+	}
+
+	Trace("start %s%s", thread->GetName().c_str(), args.c_str());
+	startedThreads.push_back(thread);
+}
+
+
+/******************************************************************************/
+// link-time stand-ins for the engine around the interpreter
+
+CGlobalSynced* gs = NULL;
+CLuaRules* luaRules = NULL;
+ISound* ISound::singleton = NULL;
+int GCurrentTime = 1000;
+
+int CGlobalSynced::randInt() { testRandSeed = testRandSeed * 214013 + 2531011; return (testRandSeed >> 16) & 0x7FFF; }
+void CLuaRules::Cob2Lua(const LuaHashString& funcName, const CUnit* unit, int& argsCount, int* args) {}
+lua_Hash lua_calchash(const char* s, size_t l) { return l; }
+
+CFixedSizeMemPool::CFixedSizeMemPool(size_t blockSize, size_t blocksPerChunk) {}
+CFixedSizeMemPool::~CFixedSizeMemPool() {}
+void* CFixedSizeMemPool::Alloc(size_t numBytes) { return malloc(numBytes); }
+void CFixedSizeMemPool::Free(void* pnt, size_t numBytes) { free(pnt); }
+
+CCobEngine GCobEngine;
+CCobEngine::CCobEngine(): curThread(NULL), threadMemPool(sizeof(CCobThread), 64) {}
+CCobEngine::~CCobEngine() {}
+
+void CCobEngine::AddThread(CCobThread* thread)
+{
+	if (thread->state == CCobThread::Sleep) {
+		TraceSleep(thread->GetWakeTime());
+	} else {
+		TraceStart(thread);
+	}
+}
+
+// CCobFile reads the script through this
+static std::vector<char> cobImage;
+
+CFileHandler::CFileHandler(const char* fileName, const char* modes) {}
+CFileHandler::~CFileHandler() {}
+int CFileHandler::FileSize() const { return cobImage.size(); }
+int CFileHandler::Read(void* buf, int length) { memcpy(buf, &cobImage[0], length); return length; }
+
+CObject::CObject() {}
+CObject::~CObject() {}
+creg::Class* CObject::GetClass() const { return NULL; }
+void CObject::Detach() {}
+void CObject::DeleteDeathDependence(CObject* obj, DependenceType dep) {}
+void CObject::AddDeathDependence(CObject* obj, DependenceType dep) {}
+void CObject::DependentDied(CObject* obj) {}
+
+CUnitScript::CUnitScript(CUnit* unit, const std::vector<LocalModelPiece*>& pieces): unit(unit), pieces(pieces) {}
+CUnitScript::~CUnitScript() {}
+
+void CUnitScript::Spin(int piece, int axis, float speed, float accel) { Trace("spin %d %d %.9g %.9g", piece, axis, speed, accel); }
+void CUnitScript::StopSpin(int piece, int axis, float decel) { Trace("stop-spin %d %d %.9g", piece, axis, decel); }
+void CUnitScript::Turn(int piece, int axis, float speed, float destination) { Trace("turn %d %d %.9g %.9g", piece, axis, speed, destination); }
+void CUnitScript::Move(int piece, int axis, float speed, float destination) { Trace("move %d %d %.9g %.9g", piece, axis, speed, destination); }
+void CUnitScript::MoveNow(int piece, int axis, float destination) { Trace("move-now %d %d %.9g", piece, axis, destination); }
+void CUnitScript::TurnNow(int piece, int axis, float destination) { Trace("turn-now %d %d %.9g", piece, axis, destination); }
+void CUnitScript::SetVisibility(int piece, bool visible) { Trace("visibility %d %d", piece, visible); }
+void CUnitScript::EmitSfx(int type, int piece) { Trace("sfx %d %d", type, piece); }
+void CUnitScript::Explode(int piece, int flags) { Trace("explode %d %d", piece, flags); }
+void CUnitScript::ShowFlare(int piece) { Trace("flare %d", piece); }
+void CUnitScript::AttachUnit(int piece, int unit) { Trace("attach %d %d", piece, unit); }
+void CUnitScript::DropUnit(int unit) { Trace("drop %d", unit); }
+void CUnitScript::SetUnitVal(int val, int param) { Trace("set %d %d", val, param); }
+
+int CUnitScript::GetUnitVal(int val, int p1, int p2, int p3, int p4)
+{
+	Trace("get %d %d %d %d %d", val, p1, p2, p3, p4);
+	return (val * 7 + p1 * 3 + p2 - p3 + p4 * 5);
+}
+
+bool CUnitScript::AddAnimListener(AnimType type, int piece, int axis, IAnimListener* listener)
+{
+	// odd pieces are busy, the thread has to wait for them
+	Trace("wait %d %d %d", type, piece, axis);
+	return ((piece & 1) != 0);
+}
+
+CCobInstance::CCobInstance(CCobFile& script, CUnit* unit): CUnitScript(unit, pieces), script(script) {}
+CCobInstance::~CCobInstance() {}
+
+void CCobInstance::Signal(int signal) { Trace("signal %d", signal); }
+void CCobInstance::PlayUnitSound(int snr, int attr) { Trace("sound %d %d", snr, attr); }
+void CCobInstance::ShowScriptError(const std::string& msg) {}
+bool CCobInstance::HasBlockShot(int weaponNum) const { return false; }
+bool CCobInstance::HasTargetWeight(int weaponNum) const { return false; }
+
+// callins, never used by the interpreter
+void CCobInstance::RawCall(int functionId) {}
+void CCobInstance::Create() {}
+void CCobInstance::Killed() {}
+void CCobInstance::WindChanged(float heading, float speed) {}
+void CCobInstance::ExtractionRateChanged(float speed) {}
+void CCobInstance::RockUnit(const float3& rockDir) {}
+void CCobInstance::HitByWeapon(const float3& hitDir, int weaponDefId, float& inout_damage) {}
+void CCobInstance::SetSFXOccupy(int curTerrainType) {}
+void CCobInstance::QueryLandingPads(std::vector<int>& out_pieces) {}
+void CCobInstance::BeginTransport(const CUnit* unit) {}
+int  CCobInstance::QueryTransport(const CUnit* unit) { return -1; }
+void CCobInstance::TransportPickup(const CUnit* unit) {}
+void CCobInstance::TransportDrop(const CUnit* unit, const float3& pos) {}
+void CCobInstance::StartBuilding(float heading, float pitch) {}
+int  CCobInstance::QueryNanoPiece() { return -1; }
+int  CCobInstance::QueryBuildInfo() { return -1; }
+void CCobInstance::Destroy() {}
+void CCobInstance::StartMoving(bool reversing) {}
+void CCobInstance::StopMoving() {}
+void CCobInstance::StartUnload() {}
+void CCobInstance::EndTransport() {}
+void CCobInstance::StartBuilding() {}
+void CCobInstance::StopBuilding() {}
+void CCobInstance::Falling() {}
+void CCobInstance::Landed() {}
+void CCobInstance::Activate() {}
+void CCobInstance::Deactivate() {}
+void CCobInstance::MoveRate(int curRate) {}
+void CCobInstance::FireWeapon(int weaponNum) {}
+void CCobInstance::EndBurst(int weaponNum) {}
+int   CCobInstance::QueryWeapon(int weaponNum) { return -1; }
+void  CCobInstance::AimWeapon(int weaponNum, float heading, float pitch) {}
+void  CCobInstance::AimShieldWeapon(CPlasmaRepulser* weapon) {}
+int   CCobInstance::AimFromWeapon(int weaponNum) { return -1; }
+void  CCobInstance::Shot(int weaponNum) {}
+bool  CCobInstance::BlockShot(int weaponNum, const CUnit* targetUnit, bool userTarget) { return false; }
+float CCobInstance::TargetWeight(int weaponNum, const CUnit* targetUnit) { return 1.0f; }
+
+
+/******************************************************************************/
+// the interpreter before the code was pre-decoded, as it was
+
+#define LUA0 110
+#define LUA9 119
+
+class RefCobThread : public CUnitScript::IAnimListener
+{
+public:
+	RefCobThread(CCobFile& script, CCobInstance* owner)
+		: script(script)
+		, owner(owner)
+		, code(script.code, script.code + script.ops.size() - 2)
+		, wakeTime(0)
+		, PC(0)
+		, paramCount(0)
+		, retCode(0)
+		, state(CCobThread::Init)
+		, signalMask(42)
+	{
+		memset(&luaArgs[0], 0, MAX_LUA_COB_ARGS * sizeof(luaArgs[0]));
+	}
+
+	void Start(int functionId, const std::vector<int>& args)
+	{
+		wakeTime = 0;
+		state = CCobThread::Run;
+		PC = script.scriptOffsets[functionId];
+
+		struct callInfo ci;
+		ci.functionId = functionId;
+		ci.returnAddr = -1;
+		ci.stackTop = 0;
+		callStack.push_back(ci);
+		paramCount = args.size();
+		signalMask = 0;
+		retCode = -1;
+		stack = args;
+	}
+
+	void AnimFinished(CUnitScript::AnimType type, int piece, int axis) {}
+
+	bool Tick();
+	void LuaCall();
+
+	int POP()
+	{
+		if (!stack.empty()) {
+			int r = stack.back();
+			stack.pop_back();
+			return r;
+		}
+
+		return 0;
+	}
+
+	struct callInfo {
+		int functionId;
+		int returnAddr;
+		size_t stackTop;
+	};
+
+	CCobFile& script;
+	CCobInstance* owner;
+	std::vector<int> code;
+
+	int wakeTime;
+	int PC;
+	std::vector<int> stack;
+	std::vector<callInfo> callStack;
+	int paramCount;
+	int retCode;
+	int luaArgs[MAX_LUA_COB_ARGS];
+	CCobThread::State state;
+	int signalMask;
+};
+
+#define GET_LONG_PC() (code[PC++])
+
+bool RefCobThread::Tick()
+{
+	if (state == CCobThread::Dead) {
+		return false;
+	}
+
+	state = CCobThread::Run;
+
+	int r1, r2, r3, r4, r5, r6;
+
+	std::vector<int> args;
+
+	while (state == CCobThread::Run) {
+		int opcode = GET_LONG_PC();
+
+		switch(opcode) {
+			case PUSH_CONSTANT:
+				r1 = GET_LONG_PC();
+				stack.push_back(r1);
+				break;
+			case SLEEP:
+				r1 = POP();
+				wakeTime = GCurrentTime + r1;
+				state = CCobThread::Sleep;
+				TraceSleep(wakeTime);
+				return true;
+			case SPIN:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				r3 = POP();         // speed
+				r4 = POP();         // accel
+				owner->Spin(r1, r2, r3, r4);
+				break;
+			case STOP_SPIN:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				r3 = POP();         // decel
+				owner->StopSpin(r1, r2, r3);
+				break;
+			case RETURN:
+				retCode = POP();
+				if (callStack.back().returnAddr == -1) {
+					state = CCobThread::Dead;
+					return false;
+				}
+
+				PC = callStack.back().returnAddr;
+				while (stack.size() > callStack.back().stackTop) {
+					stack.pop_back();
+				}
+				callStack.pop_back();
+				break;
+			case SHADE:
+				r1 = GET_LONG_PC();
+				break;
+			case DONT_SHADE:
+				r1 = GET_LONG_PC();
+				break;
+			case CACHE:
+				r1 = GET_LONG_PC();
+				break;
+			case DONT_CACHE:
+				r1 = GET_LONG_PC();
+				break;
+			case CALL: {
+				r1 = GET_LONG_PC();
+				PC--;
+				const std::string& name = script.scriptNames[r1];
+				if (name.find("lua_") == 0) {
+					code[PC - 1] = LUA_CALL;
+					LuaCall();
+					break;
+				}
+				code[PC - 1] = REAL_CALL;
+
+				// fall through //
+			}
+			case REAL_CALL:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+
+				if (script.scriptLengths[r1] == 0) {
+					break;
+				}
+
+				struct callInfo ci;
+				ci.functionId = r1;
+				ci.returnAddr = PC;
+				ci.stackTop = stack.size() - r2;
+				callStack.push_back(ci);
+				paramCount = r2;
+
+				PC = script.scriptOffsets[r1];
+				break;
+			case LUA_CALL:
+				LuaCall();
+				break;
+			case POP_STATIC:
+				r1 = GET_LONG_PC();
+				r2 = POP();
+				owner->staticVars[r1] = r2;
+				break;
+			case POP_STACK:
+				POP();
+				break;
+			case START: {
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+
+				if (script.scriptLengths[r1] == 0) {
+					break;
+				}
+
+				args.clear();
+				args.reserve(r2);
+				for (r3 = 0; r3 < r2; ++r3) {
+					r4 = POP();
+					args.push_back(r4);
+				}
+
+				CCobThread* thread = new CCobThread(script, owner);
+				thread->Start(r1, args, true);
+
+				// Seems that threads should inherit signal mask from creator
+				thread->signalMask = signalMask;
+			} break;
+			case CREATE_LOCAL_VAR:
+				if (paramCount == 0) {
+					stack.push_back(0);
+				} else {
+					paramCount--;
+				}
+				break;
+			case GET_UNIT_VALUE:
+				r1 = POP();
+				if ((r1 >= LUA0) && (r1 <= LUA9)) {
+					stack.push_back(luaArgs[r1 - LUA0]);
+					break;
+				}
+				r1 = owner->GetUnitVal(r1, 0, 0, 0, 0);
+				stack.push_back(r1);
+				break;
+			case JUMP_NOT_EQUAL:
+				r1 = GET_LONG_PC();
+				r2 = POP();
+				if (r2 == 0) {
+					PC = r1;
+				}
+				break;
+			case JUMP:
+				r1 = GET_LONG_PC();
+				PC = r1;
+				break;
+			case POP_LOCAL_VAR:
+				r1 = GET_LONG_PC();
+				r2 = POP();
+				stack[callStack.back().stackTop + r1] = r2;
+				break;
+			case PUSH_LOCAL_VAR:
+				r1 = GET_LONG_PC();
+				r2 = stack[callStack.back().stackTop + r1];
+				stack.push_back(r2);
+				break;
+			case SET_LESS_OR_EQUAL:
+				r2 = POP();
+				r1 = POP();
+				stack.push_back((r1 <= r2)? 1: 0);
+				break;
+			case BITWISE_AND:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back(r1 & r2);
+				break;
+			case BITWISE_OR:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back(r1 | r2);
+				break;
+			case BITWISE_XOR:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back(r1 ^ r2);
+				break;
+			case BITWISE_NOT:
+				r1 = POP();
+				stack.push_back(~r1);
+				break;
+			case EXPLODE:
+				r1 = GET_LONG_PC();
+				r2 = POP();
+				owner->Explode(r1, r2);
+				break;
+			case PLAY_SOUND:
+				r1 = GET_LONG_PC();
+				r2 = POP();
+				owner->PlayUnitSound(r1, r2);
+				break;
+			case PUSH_STATIC:
+				r1 = GET_LONG_PC();
+				stack.push_back(owner->staticVars[r1]);
+				break;
+			case SET_NOT_EQUAL:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back((r1 != r2)? 1: 0);
+				break;
+			case SET_EQUAL:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back((r1 == r2)? 1: 0);
+				break;
+			case SET_LESS:
+				r2 = POP();
+				r1 = POP();
+				stack.push_back((r1 < r2)? 1: 0);
+				break;
+			case SET_GREATER:
+				r2 = POP();
+				r1 = POP();
+				stack.push_back((r1 > r2)? 1: 0);
+				break;
+			case SET_GREATER_OR_EQUAL:
+				r2 = POP();
+				r1 = POP();
+				stack.push_back((r1 >= r2)? 1: 0);
+				break;
+			case RAND:
+				r2 = POP();
+				r1 = POP();
+				r3 = gs->randInt() % (r2 - r1 + 1) + r1;
+				stack.push_back(r3);
+				break;
+			case EMIT_SFX:
+				r1 = POP();
+				r2 = GET_LONG_PC();
+				owner->EmitSfx(r1, r2);
+				break;
+			case MUL:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back(r1 * r2);
+				break;
+			case SIGNAL:
+				r1 = POP();
+				owner->Signal(r1);
+				break;
+			case SET_SIGNAL_MASK:
+				r1 = POP();
+				signalMask = r1;
+				break;
+			case TURN:
+				r2 = POP();
+				r1 = POP();
+				r3 = GET_LONG_PC();
+				r4 = GET_LONG_PC();
+				owner->Turn(r3, r4, r1, r2);
+				break;
+			case GET:
+				r5 = POP();
+				r4 = POP();
+				r3 = POP();
+				r2 = POP();
+				r1 = POP();
+				if ((r1 >= LUA0) && (r1 <= LUA9)) {
+					stack.push_back(luaArgs[r1 - LUA0]);
+					break;
+				}
+				r6 = owner->GetUnitVal(r1, r2, r3, r4, r5);
+				stack.push_back(r6);
+				break;
+			case ADD:
+				r2 = POP();
+				r1 = POP();
+				stack.push_back(r1 + r2);
+				break;
+			case SUB:
+				r2 = POP();
+				r1 = POP();
+				r3 = r1 - r2;
+				stack.push_back(r3);
+				break;
+			case DIV:
+				r2 = POP();
+				r1 = POP();
+				if (r2 != 0)
+					r3 = r1 / r2;
+				else
+					r3 = 1000; // infinity!
+				stack.push_back(r3);
+				break;
+			case MOD:
+				r2 = POP();
+				r1 = POP();
+				if (r2 != 0)
+					stack.push_back(r1 % r2);
+				else
+					stack.push_back(0);
+				break;
+			case MOVE:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				r4 = POP();
+				r3 = POP();
+				owner->Move(r1, r2, r3, r4);
+				break;
+			case MOVE_NOW:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				r3 = POP();
+				owner->MoveNow(r1, r2, r3);
+				break;
+			case TURN_NOW:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				r3 = POP();
+				owner->TurnNow(r1, r2, r3);
+				break;
+			case WAIT_TURN:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				if (owner->AddAnimListener(CCobInstance::ATurn, r1, r2, this)) {
+					state = CCobThread::WaitTurn;
+					return true;
+				}
+				break;
+			case WAIT_MOVE:
+				r1 = GET_LONG_PC();
+				r2 = GET_LONG_PC();
+				if (owner->AddAnimListener(CCobInstance::AMove, r1, r2, this)) {
+					state = CCobThread::WaitMove;
+					return true;
+				}
+				break;
+			case SET:
+				r2 = POP();
+				r1 = POP();
+				if ((r1 >= LUA0) && (r1 <= LUA9)) {
+					luaArgs[r1 - LUA0] = r2;
+					break;
+				}
+				owner->SetUnitVal(r1, r2);
+				break;
+			case ATTACH:
+				r3 = POP();
+				r2 = POP();
+				r1 = POP();
+				owner->AttachUnit(r2, r1);
+				break;
+			case DROP:
+				r1 = POP();
+				owner->DropUnit(r1);
+				break;
+			case LOGICAL_NOT:
+				r1 = POP();
+				stack.push_back((r1 == 0)? 1: 0);
+				break;
+			case LOGICAL_AND:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back((r1 && r2)? 1: 0);
+				break;
+			case LOGICAL_OR:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back((r1 || r2)? 1: 0);
+				break;
+			case LOGICAL_XOR:
+				r1 = POP();
+				r2 = POP();
+				stack.push_back(((!!r1) ^ (!!r2))? 1: 0);
+				break;
+			case HIDE:
+				r1 = GET_LONG_PC();
+				owner->SetVisibility(r1, false);
+				break;
+			case SHOW: {
+				r1 = GET_LONG_PC();
+				int i;
+				for (i = 0; i < MAX_WEAPONS_PER_UNIT; ++i)
+					if (callStack.back().functionId == script.scriptIndex[COBFN_FirePrimary + COBFN_Weapon_Funcs * i])
+						break;
+
+				if (i < MAX_WEAPONS_PER_UNIT) {
+					owner->ShowFlare(r1);
+				} else {
+					owner->SetVisibility(r1, true);
+				}
+			} break;
+			default:
+				state = CCobThread::Dead;
+				return false;
+		}
+	}
+
+	return (state != CCobThread::Dead);
+}
+
+void RefCobThread::LuaCall()
+{
+	(void) GET_LONG_PC(); // script id, unused
+	const int r2 = GET_LONG_PC(); // arg count
+
+	const int size = (int) stack.size();
+	const int argCount = std::min(r2, MAX_LUA_COB_ARGS);
+	const int start = std::max(0, size - r2);
+	const int end = std::min(size, start + argCount);
+	int a = 0;
+	for (int i = start; i < end; i++) {
+		luaArgs[a] = stack[i];
+		a++;
+	}
+	if (r2 >= size) {
+		stack.clear();
+	} else {
+		stack.resize(size - r2);
+	}
+
+	// there is no LuaRules in this test
+	luaArgs[0] = 0;
+}
+
+#undef GET_LONG_PC
+
+
+/******************************************************************************/
+// assembles scripts into a .cob image
+
+class CobBuilder
+{
+public:
+	/// starts a new function at the current position
+	void Function(const std::string& name) {
+		names.push_back(name);
+		offsets.push_back(code.size());
+	}
+
+	int Pos() const { return code.size(); }
+
+	/// returns the position of the instruction
+	int Op(int opcode) { code.push_back(opcode); return (code.size() - 1); }
+	int Op(int opcode, int a) { const int pos = Op(opcode); code.push_back(a); return pos; }
+	int Op(int opcode, int a, int b) { const int pos = Op(opcode, a); code.push_back(b); return pos; }
+
+	/// sets the target of the jump at <pos>
+	void SetTarget(int pos, int target) { code[pos + 1] = target; }
+
+	int FunctionId(const std::string& name) const {
+		return (std::find(names.begin(), names.end(), name) - names.begin());
+	}
+
+	void Build(int numStaticVars, std::vector<char>* image) const;
+
+private:
+	std::vector<std::string> names;
+	std::vector<int> offsets;
+	std::vector<int> code;
+};
+
+void CobBuilder::Build(int numStaticVars, std::vector<char>* image) const
+{
+	// header, code index array, name offset array, piece name offset
+	// array, names; CCobFile reads the code from its offset to the end
+	const int numFuncs = names.size();
+	const int headerSize = 13 * sizeof(int);
+	const int indexOfs = headerSize;
+	const int nameOfs = indexOfs + numFuncs * sizeof(int);
+	const int pieceOfs = nameOfs + numFuncs * sizeof(int);
+
+	std::vector<char> strings;
+	std::vector<int> nameOffsets;
+
+	for (int i = 0; i < numFuncs; i++) {
+		nameOffsets.push_back(pieceOfs + strings.size());
+		strings.insert(strings.end(), names[i].begin(), names[i].end());
+		strings.push_back(0);
+	}
+	while ((strings.size() % sizeof(int)) != 0) {
+		strings.push_back(0);
+	}
+
+	const int codeOfs = pieceOfs + strings.size();
+	const int header[13] = {
+		4, numFuncs, 0, int(code.size()), numStaticVars, 0,
+		indexOfs, nameOfs, pieceOfs, codeOfs, 0, 0, 0
+	};
+
+	image->clear();
+	image->insert(image->end(), (const char*) &header[0], (const char*) &header[13]);
+	image->insert(image->end(), (const char*) &offsets[0], (const char*) &offsets[0] + numFuncs * sizeof(int));
+	image->insert(image->end(), (const char*) &nameOffsets[0], (const char*) &nameOffsets[0] + numFuncs * sizeof(int));
+	image->insert(image->end(), strings.begin(), strings.end());
+	image->insert(image->end(), (const char*) &code[0], (const char*) &code[0] + code.size() * sizeof(int));
+}
+
+
+/******************************************************************************/
+// runs a function with both interpreters
+
+static const int NUM_STATIC_VARS = 4;
+
+struct RunResult {
+	std::vector<std::string> trace;
+	std::vector<int> stack;
+	std::vector<int> startedMasks;
+	int state;
+	int retCode;
+	int wakeTime;
+};
+
+static void SetRetCode(int retCode, void* p1, void* p2) { *static_cast<int*>(p1) = retCode; }
+
+static void FinishRun(CCobInstance& owner, RunResult* result)
+{
+	for (size_t i = 0; i < startedThreads.size(); i++) {
+		result->startedMasks.push_back(startedThreads[i]->signalMask);
+		delete startedThreads[i];
+	}
+	for (int i = 0; i < NUM_STATIC_VARS; i++) {
+		Trace("static %d", owner.staticVars[i]);
+	}
+
+	result->trace.swap(trace);
+	startedThreads.clear();
+}
+
+static RunResult RunNew(CCobFile& file, int functionId, const std::vector<int>& args)
+{
+	RunResult result;
+	CCobInstance owner(file, NULL);
+	owner.staticVars.assign(NUM_STATIC_VARS, 0);
+	testRandSeed = 1;
+
+	CCobThread* thread = new CCobThread(file, &owner);
+	thread->Start(functionId, args, false);
+	thread->SetCallback(SetRetCode, &result.retCode, NULL);
+
+	for (int tick = 0; tick < MAX_TICKS && thread->Tick(); tick++) {
+		Trace("yield %d", thread->state);
+		thread->state = CCobThread::Run;
+	}
+
+	result.state = thread->state;
+	result.wakeTime = thread->GetWakeTime();
+
+	for (int i = 0, n = thread->CheckStack(-1u, false); i < n; i++) {
+		result.stack.push_back(thread->GetStackVal(i));
+	}
+
+	// calls SetRetCode
+	delete thread;
+	FinishRun(owner, &result);
+	return result;
+}
+
+static RunResult RunRef(CCobFile& file, int functionId, const std::vector<int>& args)
+{
+	RunResult result;
+	CCobInstance owner(file, NULL);
+	owner.staticVars.assign(NUM_STATIC_VARS, 0);
+	testRandSeed = 1;
+
+	RefCobThread thread(file, &owner);
+	thread.Start(functionId, args);
+
+	for (int tick = 0; tick < MAX_TICKS && thread.Tick(); tick++) {
+		Trace("yield %d", thread.state);
+		thread.state = CCobThread::Run;
+	}
+
+	result.state = thread.state;
+	result.wakeTime = thread.wakeTime;
+	result.stack = thread.stack;
+	result.retCode = thread.retCode;
+
+	FinishRun(owner, &result);
+	return result;
+}
+
+static void CompareRuns(const CobBuilder& builder, const std::string& function, const std::vector<int>& args)
+{
+	builder.Build(NUM_STATIC_VARS, &cobImage);
+
+	CFileHandler fh("test.cob", "r");
+	CCobFile file(fh, "test.cob");
+
+	const int functionId = builder.FunctionId(function);
+	const RunResult ref = RunRef(file, functionId, args);
+	const RunResult cur = RunNew(file, functionId, args);
+
+	BOOST_CHECK_EQUAL(ref.state, cur.state);
+	BOOST_CHECK_EQUAL(ref.retCode, cur.retCode);
+	BOOST_CHECK_EQUAL(ref.wakeTime, cur.wakeTime);
+	BOOST_CHECK(ref.stack == cur.stack);
+	BOOST_CHECK(ref.startedMasks == cur.startedMasks);
+	BOOST_CHECK_EQUAL(ref.trace.size(), cur.trace.size());
+
+	for (size_t i = 0; i < std::min(ref.trace.size(), cur.trace.size()); i++) {
+		if (ref.trace[i] != cur.trace[i]) {
+			BOOST_ERROR("traces differ at " << i << ": \"" << ref.trace[i] << "\" (old) vs \"" << cur.trace[i] << "\" (new)");
+			break;
+		}
+	}
+}
+
+// functions called by the test scripts
+static void AddHelpers(CobBuilder& b)
+{
+	// two parameters and one local, leaves junk on the stack for RETURN to remove
+	b.Function("Helper");
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(PUSH_CONSTANT, 3);
+	b.Op(POP_LOCAL_VAR, 2);
+	b.Op(PUSH_LOCAL_VAR, 0);
+	b.Op(PUSH_CONSTANT, 10);
+	b.Op(MUL);
+	b.Op(PUSH_LOCAL_VAR, 1);
+	b.Op(ADD);
+	b.Op(PUSH_LOCAL_VAR, 2);
+	b.Op(ADD);
+	b.Op(POP_STATIC, 0);
+	b.Op(PUSH_CONSTANT, 77);
+	b.Op(PUSH_STATIC, 0);
+	b.Op(RETURN);
+
+	// zero-length, calls and starts are skipped
+	b.Function("Empty");
+
+	b.Function("Leaf");
+	b.Op(ADD);
+	b.Op(POP_STATIC, 1);
+	b.Op(PUSH_CONSTANT, 0);
+	b.Op(RETURN);
+
+	b.Function("lua_Foo");
+	b.Op(PUSH_CONSTANT, 0);
+	b.Op(RETURN);
+
+	b.Function("FirePrimary");
+	b.Op(SHOW, 3);
+	b.Op(PUSH_CONSTANT, 0);
+	b.Op(RETURN);
+
+	// calls itself until static 2 reaches 20
+	b.Function("Recurse");
+	b.Op(PUSH_STATIC, 2);
+	b.Op(PUSH_CONSTANT, 1);
+	b.Op(ADD);
+	b.Op(POP_STATIC, 2);
+	b.Op(PUSH_STATIC, 2);
+	b.Op(PUSH_CONSTANT, 20);
+	b.Op(SET_LESS);
+	const int done = b.Op(JUMP_NOT_EQUAL, 0);
+	b.Op(CALL, b.FunctionId("Recurse"), 0);
+	b.SetTarget(done, b.Pos());
+	b.Op(PUSH_STATIC, 2);
+	b.Op(RETURN);
+}
+
+static void BinaryOp(CobBuilder& b, int opcode, int x, int y)
+{
+	b.Op(PUSH_CONSTANT, x);
+	b.Op(PUSH_CONSTANT, y);
+	b.Op(opcode);
+}
+
+// a straight sequence of random instructions with forward jumps only (so it
+// always ends), some of which land in the middle of other instructions
+static void AddRandomFunction(CobBuilder& b, unsigned int seed)
+{
+	// opcodes without operands, pushed as constants: executed when a jump
+	// lands on them
+	const int constOpcodes[] = {
+		PUSH_CONSTANT, POP_STACK, ADD, SUB, BITWISE_NOT, LOGICAL_NOT,
+		CREATE_LOCAL_VAR, SIGNAL, SET, DROP, SET_SIGNAL_MASK, RETURN
+	};
+	const int simpleOpcodes[] = {
+		POP_STACK, CREATE_LOCAL_VAR, ADD, SUB, MUL, DIV, MOD,
+		BITWISE_AND, BITWISE_OR, BITWISE_XOR, BITWISE_NOT,
+		SET_LESS, SET_LESS_OR_EQUAL, SET_GREATER, SET_GREATER_OR_EQUAL,
+		SET_EQUAL, SET_NOT_EQUAL, LOGICAL_AND, LOGICAL_OR, LOGICAL_XOR, LOGICAL_NOT,
+		GET_UNIT_VALUE, GET, SET, SIGNAL, SET_SIGNAL_MASK, ATTACH, DROP, SLEEP
+	};
+	const int pieceOpcodes[] = {
+		MOVE, TURN, SPIN, STOP_SPIN, MOVE_NOW, TURN_NOW, WAIT_TURN, WAIT_MOVE,
+		SHOW, HIDE, CACHE, DONT_CACHE, SHADE, DONT_SHADE, EMIT_SFX, EXPLODE, PLAY_SOUND
+	};
+	const int numConstOpcodes = sizeof(constOpcodes) / sizeof(constOpcodes[0]);
+	const int numSimpleOpcodes = sizeof(simpleOpcodes) / sizeof(simpleOpcodes[0]);
+	const int numPieceOpcodes = sizeof(pieceOpcodes) / sizeof(pieceOpcodes[0]);
+
+	#define RANDOM(n) ((seed = seed * 1103515245 + 12345), int((seed >> 8) % (n)))
+
+	std::vector<int> jumps;
+	std::vector<int> unitStarts;
+	// positions that must not be jumped to, they would let RAND divide by
+	// zero or let a function read locals it does not have
+	std::vector<bool> noTarget;
+
+	b.Function("Random");
+
+	const int start = b.Pos();
+
+	for (int unit = 0; unit < 100; unit++) {
+		const int unitStart = b.Pos();
+		bool unsafeInside = false;
+
+		unitStarts.push_back(unitStart);
+
+		switch (RANDOM(10)) {
+			case 0: {
+				b.Op(PUSH_CONSTANT, (RANDOM(4) == 0)? constOpcodes[RANDOM(numConstOpcodes)]: (RANDOM(101) - 50));
+			} break;
+			case 1:
+			case 2: {
+				b.Op(simpleOpcodes[RANDOM(numSimpleOpcodes)]);
+			} break;
+			case 3: {
+				const int opcode = pieceOpcodes[RANDOM(numPieceOpcodes)];
+
+				if (GetCobOperandCount(DecodeCobOpcode(opcode)) == 2) {
+					// named, the order of argument evaluation is unspecified
+					const int piece = RANDOM(4);
+					const int axis = RANDOM(3);
+					b.Op(opcode, piece, axis);
+				} else {
+					b.Op(opcode, RANDOM(4));
+				}
+			} break;
+			case 4: {
+				b.Op(PUSH_STATIC, RANDOM(NUM_STATIC_VARS));
+				b.Op(POP_STATIC, RANDOM(NUM_STATIC_VARS));
+			} break;
+			case 5: {
+				const int lo = RANDOM(21) - 10;
+				b.Op(PUSH_CONSTANT, lo);
+				b.Op(PUSH_CONSTANT, lo + RANDOM(20));
+				b.Op(RAND);
+				unsafeInside = true;
+			} break;
+			case 6: {
+				jumps.push_back(b.Op((RANDOM(2) == 0)? JUMP: JUMP_NOT_EQUAL, 0));
+			} break;
+			case 7: {
+				switch (RANDOM(5)) {
+					case 0: {
+						b.Op(PUSH_CONSTANT, RANDOM(9));
+						b.Op(PUSH_CONSTANT, RANDOM(9));
+						b.Op(CALL, b.FunctionId("Helper"), 2);
+						unsafeInside = true;
+					} break;
+					case 1: { b.Op(CALL, b.FunctionId("Leaf"), RANDOM(3)); } break;
+					case 2: { b.Op(CALL, b.FunctionId("lua_Foo"), RANDOM(4)); } break;
+					case 3: { b.Op(CALL, b.FunctionId("Empty"), 0); } break;
+					case 4: { b.Op(CALL, b.FunctionId("FirePrimary"), 0); } break;
+				}
+			} break;
+			case 8: {
+				const int func = b.FunctionId((RANDOM(2) == 0)? "Leaf": "Empty");
+				const int numArgs = RANDOM(4);
+				b.Op(START, func, numArgs);
+			} break;
+			case 9: {
+				b.Op(PUSH_CONSTANT, LUA0 + RANDOM(4));
+				b.Op(GET_UNIT_VALUE);
+			} break;
+		}
+
+		noTarget.resize(b.Pos() - start, false);
+
+		for (int pos = unitStart + 1; unsafeInside && pos < b.Pos(); pos++) {
+			noTarget[pos - start] = true;
+		}
+	}
+
+	unitStarts.push_back(b.Pos());
+	b.Op(PUSH_CONSTANT, 7);
+	b.Op(RETURN);
+
+	noTarget.resize(b.Pos() - start, false);
+
+	// most jumps go to the start of a later unit, the others anywhere ahead
+	for (size_t i = 0; i < jumps.size(); i++) {
+		int target;
+
+		if (RANDOM(4) != 0) {
+			const int first = std::upper_bound(unitStarts.begin(), unitStarts.end(), jumps[i]) - unitStarts.begin();
+			target = unitStarts[first + RANDOM(unitStarts.size() - first)];
+		} else {
+			do {
+				target = jumps[i] + 2 + RANDOM(b.Pos() - jumps[i] - 2);
+			} while (noTarget[target - start]);
+		}
+
+		b.SetTarget(jumps[i], target);
+	}
+
+	#undef RANDOM
+}
+
+
+
+BOOST_AUTO_TEST_CASE(AllInstructions)
+{
+	CobBuilder b;
+	AddHelpers(b);
+
+	b.Function("Main");
+
+	// two of the three locals are the arguments
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(CREATE_LOCAL_VAR);
+	b.Op(PUSH_LOCAL_VAR, 0);
+	b.Op(PUSH_LOCAL_VAR, 1);
+	b.Op(ADD);
+	b.Op(POP_LOCAL_VAR, 2);
+
+	// results stay on the stack
+	const int binaryOps[] = {
+		ADD, SUB, MUL, DIV, MOD, BITWISE_AND, BITWISE_OR, BITWISE_XOR,
+		SET_LESS, SET_LESS_OR_EQUAL, SET_GREATER, SET_GREATER_OR_EQUAL,
+		SET_EQUAL, SET_NOT_EQUAL, LOGICAL_AND, LOGICAL_OR, LOGICAL_XOR
+	};
+	const int operands[][2] = {{17, 5}, {-17, 5}, {5, 5}, {7, 0}, {0, 3}};
+
+	for (size_t i = 0; i < sizeof(binaryOps) / sizeof(binaryOps[0]); i++) {
+		for (size_t j = 0; j < sizeof(operands) / sizeof(operands[0]); j++) {
+			BinaryOp(b, binaryOps[i], operands[j][0], operands[j][1]);
+		}
+	}
+
+	b.Op(PUSH_CONSTANT, 0x0F0F); b.Op(BITWISE_NOT);
+	b.Op(PUSH_CONSTANT, 0); b.Op(LOGICAL_NOT);
+	b.Op(PUSH_CONSTANT, 9); b.Op(LOGICAL_NOT);
+	BinaryOp(b, RAND, 1, 100);
+	BinaryOp(b, RAND, -5, -5);
+
+	// unit values, and the Lua values next to them
+	b.Op(PUSH_CONSTANT, 4); b.Op(GET_UNIT_VALUE);
+	BinaryOp(b, SET, 20, 9);
+	BinaryOp(b, SET, LUA0 + 3, 42);
+	b.Op(PUSH_CONSTANT, LUA0 + 3); b.Op(GET_UNIT_VALUE);
+	for (int i = 0; i < 5; i++) { b.Op(PUSH_CONSTANT, 30 + i); }
+	b.Op(GET);
+	for (int i = 0; i < 5; i++) { b.Op(PUSH_CONSTANT, (i == 0)? LUA0 + 3: i); }
+	b.Op(GET);
+
+	// statics
+	b.Op(PUSH_CONSTANT, 5); b.Op(POP_STATIC, 1);
+	b.Op(PUSH_STATIC, 1);
+
+	// the model, including the axes that are flipped
+	for (int axis = 0; axis < 3; axis++) {
+		b.Op(PUSH_CONSTANT, 1000 * axis + 100); b.Op(PUSH_CONSTANT, 65536); b.Op(MOVE, 1, axis);
+		b.Op(PUSH_CONSTANT, 2000 * axis + 100); b.Op(PUSH_CONSTANT, 8192); b.Op(TURN, 2, axis);
+		b.Op(PUSH_CONSTANT, 3000); b.Op(PUSH_CONSTANT, 300 * axis); b.Op(SPIN, 3, axis);
+		b.Op(PUSH_CONSTANT, 40 * axis); b.Op(STOP_SPIN, 3, axis);
+		b.Op(PUSH_CONSTANT, 50000 * axis); b.Op(MOVE_NOW, 0, axis);
+		b.Op(PUSH_CONSTANT, 6000 * axis); b.Op(TURN_NOW, 0, axis);
+	}
+	b.Op(SHOW, 1);
+	b.Op(HIDE, 2);
+	b.Op(CACHE, 1); b.Op(DONT_CACHE, 1); b.Op(SHADE, 1); b.Op(DONT_SHADE, 1);
+	b.Op(PUSH_CONSTANT, 1024); b.Op(EMIT_SFX, 2);
+	b.Op(PUSH_CONSTANT, 7); b.Op(EXPLODE, 3);
+	b.Op(PUSH_CONSTANT, 8); b.Op(PLAY_SOUND, 1);
+	b.Op(PUSH_CONSTANT, 11); b.Op(PUSH_CONSTANT, 12); b.Op(PUSH_CONSTANT, 13); b.Op(ATTACH);
+	b.Op(PUSH_CONSTANT, 14); b.Op(DROP);
+	b.Op(PUSH_CONSTANT, 4); b.Op(SIGNAL);
+
+	// calls: raw CALLs get resolved, REAL_CALL and LUA_CALL are taken as they are
+	b.Op(CALL, b.FunctionId("Helper"), 2);
+	b.Op(CALL, b.FunctionId("Empty"), 0);
+	b.Op(CALL, b.FunctionId("FirePrimary"), 0);
+	b.Op(PUSH_CONSTANT, 1); b.Op(PUSH_CONSTANT, 2);
+	b.Op(REAL_CALL, b.FunctionId("Leaf"), 2);
+	b.Op(PUSH_CONSTANT, 1); b.Op(PUSH_CONSTANT, 2); b.Op(PUSH_CONSTANT, 3);
+	b.Op(CALL, b.FunctionId("lua_Foo"), 3);
+	b.Op(PUSH_CONSTANT, LUA0); b.Op(GET_UNIT_VALUE);
+	b.Op(PUSH_CONSTANT, LUA0 + 1); b.Op(GET_UNIT_VALUE);
+	b.Op(PUSH_CONSTANT, 4);
+	b.Op(LUA_CALL, b.FunctionId("lua_Foo"), 1);
+	b.Op(PUSH_CONSTANT, 0x70); b.Op(SET_SIGNAL_MASK);
+	b.Op(PUSH_CONSTANT, 5); b.Op(PUSH_CONSTANT, 6);
+	b.Op(START, b.FunctionId("Leaf"), 2);
+	b.Op(START, b.FunctionId("Empty"), 0);
+
+	// blocking: sleep, then wait for a busy and an idle piece
+	b.Op(PUSH_CONSTANT, 50); b.Op(SLEEP);
+	b.Op(WAIT_TURN, 1, 2);
+	b.Op(WAIT_MOVE, 2, 0);
+	b.Op(WAIT_MOVE, 3, 1);
+
+	// a loop counting static 0 up to 3, and a jump over junk
+	const int loop = b.Pos();
+	b.Op(PUSH_STATIC, 0); b.Op(PUSH_CONSTANT, 1); b.Op(ADD); b.Op(POP_STATIC, 0);
+	b.Op(PUSH_STATIC, 0); b.Op(PUSH_CONSTANT, 3); b.Op(SET_GREATER_OR_EQUAL); b.Op(LOGICAL_NOT);
+	const int exitLoop = b.Op(JUMP_NOT_EQUAL, 0);
+	b.Op(JUMP, loop);
+	b.SetTarget(exitLoop, b.Pos());
+	const int skip = b.Op(JUMP, 0);
+	b.Op(0x12345678);
+	b.SetTarget(skip, b.Pos());
+
+	b.Op(PUSH_LOCAL_VAR, 2);
+	b.Op(POP_STACK);
+	b.Op(PUSH_CONSTANT, 123);
+	b.Op(RETURN);
+
+	std::vector<int> args;
+	args.push_back(9);
+	args.push_back(8);
+	CompareRuns(b, "Main", args);
+}
+
+BOOST_AUTO_TEST_CASE(StackAndCalls)
+{
+	CobBuilder b;
+	AddHelpers(b);
+
+	b.Function("Main");
+	// popping from an empty stack gives 0
+	b.Op(ADD);
+	b.Op(POP_STACK);
+	b.Op(POP_STACK);
+	// deep calls
+	b.Op(CALL, b.FunctionId("Recurse"), 0);
+	// more arguments than there are values on the stack
+	b.Op(PUSH_CONSTANT, 1);
+	b.Op(CALL, b.FunctionId("Leaf"), 3);
+	b.Op(CALL, b.FunctionId("lua_Foo"), 5);
+	b.Op(PUSH_CONSTANT, 2);
+	b.Op(START, b.FunctionId("Leaf"), 3);
+	// grow the stack to 200 values
+	const int loop = b.Pos();
+	b.Op(PUSH_STATIC, 3);
+	b.Op(PUSH_STATIC, 3); b.Op(PUSH_CONSTANT, 1); b.Op(ADD); b.Op(POP_STATIC, 3);
+	b.Op(PUSH_STATIC, 3); b.Op(PUSH_CONSTANT, 200); b.Op(SET_LESS);
+	const int exitLoop = b.Op(JUMP_NOT_EQUAL, 0);
+	b.Op(JUMP, loop);
+	b.SetTarget(exitLoop, b.Pos());
+	// and call with it
+	b.Op(CALL, b.FunctionId("Helper"), 2);
+	b.Op(RETURN);
+
+	CompareRuns(b, "Main", std::vector<int>());
+
+	// a thread started with more arguments than its function has locals
+	std::vector<int> args(5, 3);
+	CompareRuns(b, "Helper", args);
+}
+
+BOOST_AUTO_TEST_CASE(MidInstructionJumps)
+{
+	CobBuilder b;
+	AddHelpers(b);
+
+	b.Function("Main");
+	// lands on the constant of a PUSH_CONSTANT, which is BITWISE_NOT
+	const int j1 = b.Op(JUMP, 0);
+	const int p1 = b.Op(PUSH_CONSTANT, BITWISE_NOT);
+	b.SetTarget(j1, p1 + 1);
+	// lands on a constant that is PUSH_CONSTANT, whose operand is the next opcode
+	b.Op(PUSH_CONSTANT, 0);
+	const int j2 = b.Op(JUMP_NOT_EQUAL, 0);
+	const int p2 = b.Op(PUSH_CONSTANT, PUSH_CONSTANT);
+	b.SetTarget(j2, p2 + 1);
+	b.Op(PUSH_CONSTANT, 5);
+	// lands on a constant that is a two-operand instruction
+	const int j3 = b.Op(JUMP, 0);
+	const int p3 = b.Op(PUSH_CONSTANT, MOVE_NOW);
+	b.SetTarget(j3, p3 + 1);
+	b.Op(PUSH_CONSTANT, 6);
+	b.Op(PUSH_CONSTANT, 7);
+	b.Op(PUSH_CONSTANT, RETURN);
+	b.Op(RETURN);
+
+	// lands on an operand that is no instruction at all
+	b.Function("Dies");
+	b.Op(PUSH_CONSTANT, 1);
+	const int j4 = b.Op(JUMP, 0);
+	const int p4 = b.Op(HIDE, 2);
+	b.SetTarget(j4, p4 + 1);
+	b.Op(RETURN);
+
+	CompareRuns(b, "Main", std::vector<int>());
+	CompareRuns(b, "Dies", std::vector<int>());
+}
+
+BOOST_AUTO_TEST_CASE(RandomPrograms)
+{
+	for (int i = 0; i < NUM_RANDOM_PROGRAMS; i++) {
+		CobBuilder b;
+		AddHelpers(b);
+		AddRandomFunction(b, i + 1);
+
+		std::vector<int> args(i % 3, i);
+		CompareRuns(b, "Random", args);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(JumpsOutOfRange)
+{
+	// the old interpreter ran off into memory here, now the thread dies
+	CobBuilder b;
+
+	b.Function("Main");
+	b.Op(PUSH_CONSTANT, 1);
+	const int j1 = b.Op(JUMP_NOT_EQUAL, -4); // not taken
+	b.Op(PUSH_CONSTANT, 0);
+	const int j2 = b.Op(JUMP_NOT_EQUAL, 1 << 20);
+	b.Op(RETURN);
+
+	b.Build(NUM_STATIC_VARS, &cobImage);
+
+	CFileHandler fh("test.cob", "r");
+	CCobFile file(fh, "test.cob");
+	CCobInstance owner(file, NULL);
+
+	BOOST_CHECK_EQUAL(file.ops[j1].operands[0], file.ops[j2].operands[0]);
+	BOOST_CHECK_EQUAL(file.ops[file.ops[j1].operands[0]].instr, COB_BAD_JUMP);
+
+	CCobThread* thread = new CCobThread(file, &owner);
+	thread->Start(0, std::vector<int>(), false);
+
+	BOOST_CHECK(!thread->Tick());
+	BOOST_CHECK_EQUAL(thread->state, CCobThread::Dead);
+
+	delete thread;
+}
+
+BOOST_AUTO_TEST_CASE(Timings)
+{
+	// an arithmetic loop, no owner calls
+	CobBuilder b;
+
+	b.Function("Main");
+	const int loop = b.Pos();
+	b.Op(PUSH_STATIC, 0); b.Op(PUSH_CONSTANT, 1); b.Op(ADD); b.Op(POP_STATIC, 0);
+	b.Op(PUSH_STATIC, 1); b.Op(PUSH_STATIC, 0); b.Op(PUSH_CONSTANT, 7); b.Op(MOD); b.Op(ADD); b.Op(POP_STATIC, 1);
+	b.Op(PUSH_STATIC, 0); b.Op(PUSH_CONSTANT, 200000); b.Op(SET_LESS);
+	const int done = b.Op(JUMP_NOT_EQUAL, 0);
+	b.Op(JUMP, loop);
+	b.SetTarget(done, b.Pos());
+	b.Op(PUSH_STATIC, 1);
+	b.Op(RETURN);
+
+	b.Build(NUM_STATIC_VARS, &cobImage);
+
+	CFileHandler fh("test.cob", "r");
+	CCobFile file(fh, "test.cob");
+
+	const std::clock_t t0 = std::clock();
+	const RunResult ref = RunRef(file, 0, std::vector<int>());
+	const std::clock_t t1 = std::clock();
+	const RunResult cur = RunNew(file, 0, std::vector<int>());
+	const std::clock_t t2 = std::clock();
+
+	BOOST_TEST_MESSAGE("200000 loop iterations: " << ((t1 - t0) * 1000.0 / CLOCKS_PER_SEC) << "ms (old), " << ((t2 - t1) * 1000.0 / CLOCKS_PER_SEC) << "ms (new)");
+	BOOST_CHECK_EQUAL(ref.retCode, cur.retCode);
+	BOOST_CHECK(ref.trace == cur.trace);
+}
@@ -0,0 +1,414 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/Scripts/UnitScript.h"
+#include "Sim/Units/Scripts/UnitScriptEngine.h"
+#include "Sim/Units/Unit.h"
+#include "Rendering/Models/3DModel.h"
+#include "System/ThreadPool.h"
+#include "System/TimeProfiler.h"
+#include "System/Sync/SyncChecker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE UnitScriptAnims
+#include <boost/test/unit_test.hpp>
+
+// animates a crowd of units through CUnitScriptEngine::Tick (which ticks the
+// scripts in parallel and unblocks the listeners afterwards) and through the
+// serial path it replaced (SerialScriptEngine below, which ticks a script and
+// unblocks its listeners before moving on to the next one) and compares the
+// order in which the listeners were called and where all pieces ended up
+static const int NUM_UNITS = 100; // several ANIM_TICK_BATCH_SIZE batches
+static const int NUM_PIECES = 4;
+static const int NUM_FRAMES = 150;
+static const int NUM_ROUNDS = 6;  // animations a listener starts again
+static const int DELTA_TIME = 33;
+
+
+/******************************************************************************/
+// link-time stand-ins for the engine around the animations
+
+CObject::CObject() {}
+CObject::~CObject() {}
+void CObject::Detach() {}
+void CObject::DeleteDeathDependence(CObject* obj, DependenceType dep) {}
+void CObject::AddDeathDependence(CObject* obj, DependenceType dep) {}
+void CObject::DependentDied(CObject* obj) {}
+
+CSolidObject::CSolidObject() {}
+CSolidObject::~CSolidObject() {}
+void CSolidObject::Kill(CUnit* killer, const float3& impulse, bool crushed) {}
+void CSolidObject::UpdatePhysicalState(float eps) {}
+
+LuaMatRef::~LuaMatRef() {}
+
+// the scripts only reach the LocalModel through their unit
+CUnit::CUnit(): localModel(NULL) {}
+CUnit::~CUnit() {}
+void CUnit::PreInit(const UnitLoadParams& params) {}
+void CUnit::PostInit(const CUnit* builder) {}
+void CUnit::SlowUpdate() {}
+void CUnit::SlowUpdateWeapons() {}
+void CUnit::Update() {}
+void CUnit::DoDamage(const DamageArray& damages, const float3& impulse, CUnit* attacker, int weaponDefID, int projectileID) {}
+void CUnit::DoWaterDamage() {}
+void CUnit::FinishedBuilding(bool postInit) {}
+bool CUnit::ChangeTeam(int team, ChangeType type) { return false; }
+void CUnit::StopAttackingAllyTeam(int ally) {}
+void CUnit::KillUnit(CUnit* attacker, bool selfDestruct, bool reclaimed, bool showDeathSequence) {}
+void CUnit::IncomingMissile(CMissileProjectile* missile) {}
+void CUnit::DependentDied(CObject* obj) {}
+void CUnit::ApplyImpulse(const float3& impulse) {}
+bool CUnit::AddBuildPower(CUnit* builder, float amount) { return false; }
+void CUnit::ForcedMove(const float3& newPos) {}
+void CUnit::ForcedSpin(const float3& newDir) {}
+void CUnit::UpdatePhysicalState(float eps) {}
+CMatrix44f CUnit::GetTransformMatrix(const bool synced, const bool error) const { return CMatrix44f(); }
+const CollisionVolume* CUnit::GetCollisionVolume(const LocalModelPiece* lmp) const { return NULL; }
+
+CUnitScript::CUnitScript(CUnit* unit, const std::vector<LocalModelPiece*>& pieces): unit(unit), animatingIndex(-1), pieces(pieces) {}
+CUnitScript::~CUnitScript() { GUnitScriptEngine.RemoveInstance(this); } // like the real one
+
+VBO::VBO(GLenum defTarget) {}
+VBO::~VBO() {}
+
+S3DModelPiece::S3DModelPiece(): parent(NULL), colvol(NULL), offset(ZeroVector) {}
+S3DModelPiece::~S3DModelPiece() {}
+unsigned int S3DModelPiece::CreateDrawForList() const { return 0; }
+
+LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
+	: colvol(NULL)
+	, numUpdatesSynced(1)
+	, lastMatrixUpdate(0)
+	, original(piece)
+	, parent(NULL)
+{
+	pos = piece->offset;
+}
+
+LocalModelPiece::~LocalModelPiece() {}
+
+LocalModelPiece* LocalModel::CreateLocalModelPieces(const S3DModelPiece* mpParent)
+{
+	LocalModelPiece* lmpParent = new LocalModelPiece(mpParent);
+	pieces.push_back(lmpParent);
+
+	for (unsigned int i = 0; i < mpParent->GetChildCount(); i++) {
+		lmpParent->AddChild(CreateLocalModelPieces(mpParent->GetChild(i)));
+	}
+
+	return lmpParent;
+}
+
+BasicTimer::BasicTimer(const char* myname): hash(0), starttime(spring_notime) {}
+ScopedTimer::ScopedTimer(const char* name, bool autoShow): BasicTimer(name), autoShowGraph(autoShow) {}
+ScopedTimer::~ScopedTimer() {}
+
+
+struct TestModelPiece: public S3DModelPiece {
+	const float3& GetVertexPos(const int) const { return ZeroVector; }
+	const float3& GetNormal(const int) const { return UpVector; }
+	void DrawForList() const {}
+};
+
+
+/******************************************************************************/
+
+// every listener call, in the order they happened
+static std::vector<std::string> trace;
+static int curFrame = 0;
+
+class TestScript: public CUnitScript
+{
+public:
+	struct Listener: public IAnimListener {
+		Listener(): script(NULL), id(0), rounds(0) {}
+
+		void AnimFinished(AnimType type, int piece, int axis) {
+			script->AnimFinished(this, type, piece, axis);
+		}
+
+		TestScript* script;
+		int id;
+		int rounds;
+	};
+
+	TestScript(CUnit* unit, const std::vector<LocalModelPiece*>& pieces, int id)
+		: CUnitScript(unit, pieces)
+		, id(id)
+		, randSeed(id + 1)
+	{
+		for (int n = 0; n < NUM_LISTENERS; n++) {
+			listeners[n].script = this;
+			listeners[n].id = n;
+		}
+	}
+
+	// like COB scripts do: start an animation and wait for it
+	void StartAnim(Listener* listener, AnimType type, int piece, int axis)
+	{
+		const float speed = 0.05f + (Rand() % 100) * 0.01f;
+		const float dest = ((Rand() % 200) - 100) * 0.03f;
+
+		switch (type) {
+			case ATurn: { Turn(piece, axis, speed, dest); } break;
+			case AMove: { Move(piece, axis, speed * 10.0f, dest * 10.0f); } break;
+			case ASpin: { Spin(piece, axis, speed, speed * 0.1f); } break;
+			default: {} break;
+		}
+
+		if (type != ASpin) {
+			AddAnimListener(type, piece, axis, listener);
+		}
+	}
+
+	void Start()
+	{
+		for (int piece = 0; piece < NUM_PIECES; piece++) {
+			StartAnim(&listeners[(piece * 3 + 0) % NUM_LISTENERS], ATurn, piece, piece % 2);
+			StartAnim(&listeners[(piece * 3 + 1) % NUM_LISTENERS], AMove, piece, piece % 3);
+			StartAnim(&listeners[(piece * 3 + 2) % NUM_LISTENERS], ASpin, piece, 2);
+		}
+
+		// a second listener waiting for the same turn
+		AddAnimListener(ATurn, 0, 0, &listeners[NUM_LISTENERS - 1]);
+	}
+
+	void StopSpins()
+	{
+		for (int piece = 0; piece < NUM_PIECES; piece++) {
+			StopSpin(piece, 2, 0.01f * (1 + (Rand() % 5)));
+			AddAnimListener(ASpin, piece, 2, &listeners[piece % NUM_LISTENERS]);
+		}
+	}
+
+	void AnimFinished(Listener* listener, AnimType type, int piece, int axis)
+	{
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%d: unit %d listener %d type %d piece %d axis %d", curFrame, id, listener->id, type, piece, axis);
+		trace.push_back(buf);
+
+		if (listener->rounds++ >= NUM_ROUNDS)
+			return;
+
+		// pick another animation for this piece; turns on the spin
+		// axis replace the spin (and unblock its listeners right away)
+		const AnimType nextType = AnimType(Rand() % 2 == 0? ATurn: AMove);
+		StartAnim(listener, nextType, piece, Rand() % 3);
+	}
+
+private:
+	unsigned int Rand() { randSeed = randSeed * 214013 + 2531011; return ((randSeed >> 16) & 0x7FFF); }
+
+	void ShowScriptError(const std::string& msg) { BOOST_ERROR(msg); }
+
+	void RawCall(int functionId) {}
+	void Create() {}
+	void Killed() {}
+	void WindChanged(float heading, float speed) {}
+	void ExtractionRateChanged(float speed) {}
+	void RockUnit(const float3& rockDir) {}
+	void HitByWeapon(const float3& hitDir, int weaponDefId, float& inout_damage) {}
+	void SetSFXOccupy(int curTerrainType) {}
+	void QueryLandingPads(std::vector<int>& out_pieces) {}
+	void BeginTransport(const CUnit* unit) {}
+	int  QueryTransport(const CUnit* unit) { return -1; }
+	void TransportPickup(const CUnit* unit) {}
+	void TransportDrop(const CUnit* unit, const float3& pos) {}
+	void StartBuilding(float heading, float pitch) {}
+	int  QueryNanoPiece() { return -1; }
+	int  QueryBuildInfo() { return -1; }
+
+	void Destroy() {}
+	void StartMoving(bool reversing) {}
+	void StopMoving() {}
+	void StartUnload() {}
+	void EndTransport() {}
+	void StartBuilding() {}
+	void StopBuilding() {}
+	void Falling() {}
+	void Landed() {}
+	void Activate() {}
+	void Deactivate() {}
+	void MoveRate(int curRate) {}
+	void FireWeapon(int weaponNum) {}
+	void EndBurst(int weaponNum) {}
+
+	int   QueryWeapon(int weaponNum) { return -1; }
+	void  AimWeapon(int weaponNum, float heading, float pitch) {}
+	void  AimShieldWeapon(CPlasmaRepulser* weapon) {}
+	int   AimFromWeapon(int weaponNum) { return -1; }
+	void  Shot(int weaponNum) {}
+	bool  BlockShot(int weaponNum, const CUnit* targetUnit, bool userTarget) { return false; }
+	float TargetWeight(int weaponNum, const CUnit* targetUnit) { return 1.0f; }
+
+private:
+	static const int NUM_LISTENERS = 3;
+
+	Listener listeners[NUM_LISTENERS];
+
+	int id;
+	unsigned int randSeed;
+};
+
+
+// one unit with a root piece and NUM_PIECES - 1 children
+struct TestUnit {
+	TestUnit(int id)
+	{
+		for (int n = 0; n < NUM_PIECES; n++) {
+			modelPieces[n].offset = float3(n, n * 2, n * 3);
+		}
+		for (int n = 1; n < NUM_PIECES; n++) {
+			modelPieces[0].children.push_back(&modelPieces[n]);
+		}
+
+		model.numPieces = NUM_PIECES;
+		model.SetRootPiece(&modelPieces[0]);
+
+		unit.localModel = new LocalModel(&model);
+		script = new TestScript(&unit, unit.localModel->pieces, id);
+	}
+
+	~TestUnit()
+	{
+		delete script;
+		delete unit.localModel;
+	}
+
+	TestModelPiece modelPieces[NUM_PIECES];
+	S3DModel model;
+	CUnit unit;
+	TestScript* script;
+};
+
+
+// the serial path: every script is ticked and has its listeners unblocked
+// before the next one is looked at (in the order they started animating)
+struct SerialScriptEngine: public CUnitScriptEngine {
+	static void Tick(CUnitScriptEngine& engine, int deltaTime)
+	{
+		std::vector<CUnitScript*>& animating = engine.*(&SerialScriptEngine::animating);
+		const size_t numScripts = animating.size();
+
+		for (size_t n = 0; n < numScripts; n++) {
+			CUnitScript* script = animating[n];
+
+			if (script == NULL)
+				continue;
+
+			if (script->TickAnims(deltaTime)) {
+				script->FinishAnims();
+			}
+			if (!script->HaveAnimations()) {
+				engine.RemoveInstance(script);
+			}
+		}
+	}
+};
+
+
+struct RunResult {
+	std::vector<std::string> trace;
+	// position and rotation of every piece, compared exactly
+	// (float3::operator== allows for a small difference)
+	std::vector<float> pieceStates;
+	std::vector<unsigned int> dirtyPieces;
+};
+
+// numThreads == 0 runs the serial path
+static void RunFrames(int numThreads, RunResult& result)
+{
+	std::vector<TestUnit*> units;
+
+	trace.clear();
+
+	if (numThreads > 0)
+		ThreadPool::SetThreadCount(numThreads);
+
+	ENTER_SYNCED_CODE();
+
+	for (int n = 0; n < NUM_UNITS; n++) {
+		units.push_back(new TestUnit(n));
+	}
+
+	for (curFrame = 0; curFrame < NUM_FRAMES; curFrame++) {
+		// units start animating at different frames, so the
+		// order they are ticked in differs from their ids
+		for (int n = 0; n < NUM_UNITS; n++) {
+			if (curFrame == (n * 7) % 40) {
+				units[n]->script->Start();
+			}
+			if (curFrame == 60 + (n * 11) % 50) {
+				units[n]->script->StopSpins();
+			}
+		}
+
+		if (numThreads > 0) {
+			GUnitScriptEngine.Tick(DELTA_TIME);
+		} else {
+			SerialScriptEngine::Tick(GUnitScriptEngine, DELTA_TIME);
+		}
+
+		for (int n = 0; n < NUM_UNITS; n++) {
+			result.dirtyPieces.push_back(units[n]->unit.localModel->dirtyPieces);
+		}
+	}
+
+	for (int n = 0; n < NUM_UNITS; n++) {
+		for (int i = 0; i < NUM_PIECES; i++) {
+			const LocalModelPiece* piece = units[n]->script->pieces[i];
+
+			for (int axis = 0; axis < 3; axis++) {
+				result.pieceStates.push_back(piece->GetPosition()[axis]);
+				result.pieceStates.push_back(piece->GetRotation()[axis]);
+			}
+		}
+
+		delete units[n];
+	}
+
+	// drop the entries the deleted scripts left behind
+	GUnitScriptEngine.Tick(DELTA_TIME);
+
+	LEAVE_SYNCED_CODE();
+
+	result.trace.swap(trace);
+}
+
+
+static void CheckSameResult(const RunResult& serial, const RunResult& parallel)
+{
+	BOOST_CHECK_EQUAL(serial.trace.size(), parallel.trace.size());
+
+	for (size_t n = 0; n < std::min(serial.trace.size(), parallel.trace.size()); n++) {
+		if (serial.trace[n] != parallel.trace[n]) {
+			BOOST_ERROR("listener call " << n << " differs: " << serial.trace[n] << " vs. " << parallel.trace[n]);
+			break;
+		}
+	}
+
+	BOOST_CHECK(serial.pieceStates == parallel.pieceStates);
+	BOOST_CHECK(serial.dirtyPieces == parallel.dirtyPieces);
+}
+
+
+BOOST_AUTO_TEST_CASE(ListenerOrderAndPieceStateMatchSerialPath)
+{
+	RunResult serial;
+	RunFrames(0, serial);
+
+	// make sure the scenario actually has listeners to unblock
+	BOOST_CHECK(serial.trace.size() > size_t(NUM_UNITS * NUM_PIECES));
+
+	for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+		RunResult parallel;
+		RunFrames(numThreads, parallel);
+		CheckSameResult(serial, parallel);
+	}
+
+	ThreadPool::SetThreadCount(1);
+}
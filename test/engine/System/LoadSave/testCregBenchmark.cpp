@@ -0,0 +1,255 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/creg/creg_cond.h"
+#include "System/creg/Serializer.h"
+#include "System/LoadSave/BlockCompressor.h"
+#include "System/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE CregBenchmark
+#include <boost/test/unit_test.hpp>
+
+// saves and loads a synthetic late-game state (units with embedded
+// weapons, command queues and pointers to each other) and reports the
+// throughput of the serializer and of the block compression
+static const int NUM_UNITS = 20000;
+static const int NUM_WEAPONS = 3;
+static const int NUM_COMMANDS = 8;
+
+
+struct BenchUnit;
+
+struct BenchWeapon {
+	CR_DECLARE_STRUCT(BenchWeapon);
+
+	BenchWeapon(): reloadFrame(0), range(0.0f), target(NULL) {}
+
+	int reloadFrame;
+	float range;
+	BenchUnit* target;
+};
+
+CR_BIND(BenchWeapon, );
+CR_REG_METADATA(BenchWeapon, (
+	CR_MEMBER(reloadFrame),
+	CR_MEMBER(range),
+	CR_MEMBER(target)
+));
+
+struct BenchUnit {
+	CR_DECLARE(BenchUnit);
+
+	BenchUnit(): id(0), team(0), health(0.0f), transporter(NULL) {
+		pos[0] = pos[1] = pos[2] = 0.0f;
+	}
+	virtual ~BenchUnit() {}
+
+	int id;
+	int team;
+	float pos[3];
+	float health;
+	std::string name;
+	std::vector<int> commands;
+
+	BenchWeapon weapons[NUM_WEAPONS];
+	BenchUnit* transporter;
+};
+
+CR_BIND(BenchUnit, );
+CR_REG_METADATA(BenchUnit, (
+	CR_MEMBER(id),
+	CR_MEMBER(team),
+	CR_MEMBER(pos),
+	CR_MEMBER(health),
+	CR_MEMBER(name),
+	CR_MEMBER(commands),
+	CR_MEMBER(weapons),
+	CR_MEMBER(transporter)
+));
+
+struct BenchWorld {
+	CR_DECLARE(BenchWorld);
+
+	virtual ~BenchWorld() {
+		for (size_t n = 0; n < units.size(); n++) {
+			delete units[n];
+		}
+	}
+
+	std::vector<BenchUnit*> units;
+};
+
+CR_BIND(BenchWorld, );
+CR_REG_METADATA(BenchWorld, (
+	CR_MEMBER(units)
+));
+
+
+static BenchWorld* CreateWorld()
+{
+	BenchWorld* world = new BenchWorld();
+	world->units.resize(NUM_UNITS);
+
+	for (int n = 0; n < NUM_UNITS; n++) {
+		world->units[n] = new BenchUnit();
+	}
+
+	unsigned int seed = 1;
+
+	for (int n = 0; n < NUM_UNITS; n++) {
+		BenchUnit* u = world->units[n];
+
+		u->id = n;
+		u->team = n % 16;
+		u->pos[0] = n * 8.0f;
+		u->pos[1] = 100.0f;
+		u->pos[2] = (n % 1000) * 8.0f;
+		u->health = 1000.0f - (n % 700);
+		u->name = "unit" + std::string(1, 'a' + (n % 26));
+
+		for (int c = 0; c < NUM_COMMANDS; c++) {
+			u->commands.push_back(n * NUM_COMMANDS + c);
+		}
+		for (int w = 0; w < NUM_WEAPONS; w++) {
+			seed = seed * 1103515245 + 12345;
+			u->weapons[w].reloadFrame = n + w;
+			u->weapons[w].range = 300.0f + w * 100.0f;
+			u->weapons[w].target = world->units[(seed >> 8) % NUM_UNITS];
+		}
+
+		u->transporter = ((n % 10) == 0)? world->units[(n + 1) % NUM_UNITS]: NULL;
+	}
+
+	return world;
+}
+
+static bool SameWorld(const BenchWorld* a, const BenchWorld* b)
+{
+	if (a->units.size() != b->units.size())
+		return false;
+
+	for (size_t n = 0; n < a->units.size(); n++) {
+		const BenchUnit* ua = a->units[n];
+		const BenchUnit* ub = b->units[n];
+
+		if (ua->id != ub->id || ua->team != ub->team || ua->health != ub->health) return false;
+		if (ua->pos[0] != ub->pos[0] || ua->pos[2] != ub->pos[2]) return false;
+		if (ua->name != ub->name || ua->commands != ub->commands) return false;
+
+		// pointers must refer to the unit with the same index
+		for (int w = 0; w < NUM_WEAPONS; w++) {
+			if (ua->weapons[w].range != ub->weapons[w].range) return false;
+			if (ua->weapons[w].target->id != ub->weapons[w].target->id) return false;
+		}
+
+		if ((ua->transporter == NULL) != (ub->transporter == NULL)) return false;
+		if (ua->transporter != NULL && ua->transporter->id != ub->transporter->id) return false;
+	}
+
+	return true;
+}
+
+template<typename F> static double TimeSecs(F f)
+{
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	f();
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+static double MBPerSec(size_t numBytes, double secs)
+{
+	return (numBytes / (1024.0 * 1024.0)) / std::max(secs, 1e-6);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(SaveLoad20kUnits)
+{
+	creg::System::InitializeClasses();
+
+	BenchWorld* world = CreateWorld();
+	BenchWorld* loaded = NULL;
+
+	std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+
+	const double saveTime = TimeSecs([&]() {
+		creg::COutputStreamSerializer os;
+		os.SavePackage(&stream, world, world->GetClass());
+	});
+
+	const std::string raw = stream.str();
+
+	const double loadTime = TimeSecs([&]() {
+		void* root = NULL;
+		creg::Class* rootCls = NULL;
+
+		creg::CInputStreamSerializer is;
+		is.LoadPackage(&stream, root, rootCls);
+
+		loaded = static_cast<BenchWorld*>(root);
+	});
+
+	BOOST_TEST_MESSAGE(NUM_UNITS << " units, " << (raw.size() / 1024) << " KB: save "
+		<< MBPerSec(raw.size(), saveTime) << " MB/s (" << (saveTime * 1000.0) << "ms), load "
+		<< MBPerSec(raw.size(), loadTime) << " MB/s (" << (loadTime * 1000.0) << "ms)");
+
+	BOOST_CHECK(loaded != NULL);
+	BOOST_CHECK(loaded != NULL && SameWorld(world, loaded));
+
+	delete loaded;
+	delete world;
+}
+
+BOOST_AUTO_TEST_CASE(BlockCompression)
+{
+	BenchWorld* world = CreateWorld();
+
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+	creg::COutputStreamSerializer os;
+	os.SavePackage(&stream, world, world->GetClass());
+	delete world;
+
+	const std::string raw = stream.str();
+
+	// small blocks so that there are enough of them for all threads
+	const unsigned int blockSize = 64 * 1024;
+	const int maxThreads = ThreadPool::GetMaxThreads();
+
+	std::vector<char> reference;
+
+	for (int n = 1; ; n *= 2) {
+		const int numThreads = std::min(n, maxThreads);
+		ThreadPool::SetThreadCount(numThreads);
+
+		std::vector<char> compressed;
+		std::vector<char> decompressed;
+
+		const double compressTime = TimeSecs([&]() { BlockCompressor::Compress(raw.data(), raw.size(), compressed, blockSize); });
+		const double decompressTime = TimeSecs([&]() { BOOST_CHECK(BlockCompressor::Decompress(&compressed[0], compressed.size(), decompressed)); });
+
+		BOOST_TEST_MESSAGE(numThreads << " thread(s), " << (raw.size() / 1024) << " KB -> " << (compressed.size() / 1024) << " KB: compress "
+			<< MBPerSec(raw.size(), compressTime) << " MB/s, decompress "
+			<< MBPerSec(raw.size(), decompressTime) << " MB/s");
+
+		// the output must not depend on the number of threads
+		if (reference.empty())
+			reference = compressed;
+
+		BOOST_CHECK(compressed == reference);
+		BOOST_CHECK(decompressed.size() == raw.size() && std::equal(decompressed.begin(), decompressed.end(), raw.begin()));
+
+		if (numThreads == maxThreads)
+			break;
+	}
+
+	// damaged streams are rejected
+	std::vector<char> decompressed;
+	reference.resize(reference.size() / 2);
+	BOOST_CHECK(!BlockCompressor::Decompress(&reference[0], reference.size(), decompressed));
+}
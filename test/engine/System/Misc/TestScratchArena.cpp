@@ -0,0 +1,142 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Misc/ScratchArena.h"
+
+#include <cstdlib>
+#include <new>
+
+#define BOOST_TEST_MODULE ScratchArena
+#include <boost/test/unit_test.hpp>
+
+// counts every global heap allocation made by this test binary
+static size_t numHeapAllocs = 0;
+
+void* operator new(size_t size)
+{
+	numHeapAllocs += 1;
+
+	void* p = malloc(size);
+
+	if (p == NULL)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) throw()
+{
+	free(p);
+}
+
+
+static const int NUM_QUERIES = 2000;
+static const int NUM_QUADS_PER_QUERY = 16;
+static const int NUM_OBJECTS_PER_QUAD = 12;
+
+// allocates the two result lists of a QuadField query from a scope
+static int ScratchQuery(int queryIdx)
+{
+	CScratchArena::Scope scope;
+
+	ScratchSpan<int> quads = scope.Alloc<int>(NUM_QUADS_PER_QUERY);
+	for (int n = 0; n < NUM_QUADS_PER_QUERY; n++) {
+		quads.push_back(queryIdx + n);
+	}
+
+	ScratchSpan<const void*> objects = scope.Alloc<const void*>(NUM_QUADS_PER_QUERY * NUM_OBJECTS_PER_QUAD);
+	for (const int* q = quads.begin(); q != quads.end(); ++q) {
+		for (int n = 0; n < NUM_OBJECTS_PER_QUAD; n++) {
+			objects.push_back(q);
+		}
+	}
+
+	return objects.size();
+}
+
+
+BOOST_AUTO_TEST_CASE(LifoScopes)
+{
+	CScratchArena arena(256);
+
+	const CScratchArena::Marker m0 = arena.GetMarker();
+	int* a = static_cast<int*>(arena.Alloc(16 * sizeof(int)));
+
+	const CScratchArena::Marker m1 = arena.GetMarker();
+	int* b = static_cast<int*>(arena.Alloc(16 * sizeof(int)));
+
+	BOOST_CHECK((reinterpret_cast<size_t>(a) % CScratchArena::ALIGNMENT) == 0);
+	BOOST_CHECK((reinterpret_cast<size_t>(b) % CScratchArena::ALIGNMENT) == 0);
+	BOOST_CHECK(b >= a + 16);
+
+	// rewinding the inner allocation must hand out the same memory again
+	arena.Rewind(m1);
+	BOOST_CHECK(static_cast<int*>(arena.Alloc(16 * sizeof(int))) == b);
+
+	// requests larger than a block get a block of their own
+	arena.Alloc(1024);
+	BOOST_CHECK(arena.GetNumBlocks() == 2);
+
+	arena.Rewind(m0);
+	BOOST_CHECK(arena.GetNumBytesInUse() == 0);
+	BOOST_CHECK(static_cast<int*>(arena.Alloc(16 * sizeof(int))) == a);
+}
+
+BOOST_AUTO_TEST_CASE(NestedThreadScopes)
+{
+	CScratchArena::Scope outer;
+	ScratchSpan<int> outerSpan = outer.Alloc<int>(4);
+
+	for (int n = 0; n < 4; n++)
+		outerSpan.push_back(n);
+
+	{
+		// a nested query must not clobber the outer result
+		CScratchArena::Scope inner;
+		ScratchSpan<int> innerSpan = inner.Alloc<int>(4);
+
+		for (int n = 0; n < 4; n++)
+			innerSpan.push_back(-1);
+	}
+
+	for (int n = 0; n < 4; n++)
+		BOOST_CHECK(outerSpan[n] == n);
+}
+
+BOOST_AUTO_TEST_CASE(NoHeapAllocsAfterWarmUp)
+{
+	// the first scope makes the thread's arena reach its high-water mark
+	BOOST_CHECK(ScratchQuery(0) == NUM_QUADS_PER_QUERY * NUM_OBJECTS_PER_QUAD);
+
+	const size_t numAllocs = numHeapAllocs;
+	const size_t arenaHeapAllocs = CScratchArena::GetNumHeapAllocs();
+
+	int numResults = 0;
+
+	for (int n = 0; n < NUM_QUERIES; n++)
+		numResults += ScratchQuery(n);
+
+	// later scopes of the same size must only reuse the arena's blocks
+	BOOST_CHECK(numResults == NUM_QUERIES * NUM_QUADS_PER_QUERY * NUM_OBJECTS_PER_QUAD);
+	BOOST_CHECK(numHeapAllocs == numAllocs);
+	BOOST_CHECK(CScratchArena::GetNumHeapAllocs() == arenaHeapAllocs);
+}
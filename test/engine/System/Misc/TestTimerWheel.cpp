@@ -0,0 +1,151 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Misc/TimerWheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <vector>
+
+#define BOOST_TEST_MODULE TimerWheel
+#include <boost/test/unit_test.hpp>
+
+// as many sleeping script threads as in a large game
+static const int NUM_ITEMS = 50000;
+static const int TICK_TIME = 33;
+
+
+struct Item {
+	int id;
+	int time;
+};
+
+// reference scheduler: ordered by time, then by insertion
+struct QueueEntry {
+	int time;
+	unsigned int seq;
+	Item* item;
+
+	bool operator < (const QueueEntry& e) const {
+		if (time != e.time)
+			return (time > e.time);
+		return (seq > e.seq);
+	}
+};
+
+static unsigned int seed = 1;
+static int Rand(int max) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % max;
+}
+
+template<typename F> static double TimeSecs(F f)
+{
+	const std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+	f();
+	const std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(t1 - t0).count();
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Order)
+{
+	CTimerWheel<Item> wheel;
+	std::vector<Item> items(NUM_ITEMS);
+	std::vector<Item*> expected;
+	std::vector<Item*> woken;
+
+	for (int n = 0; n < NUM_ITEMS; n++) {
+		items[n].id = n;
+
+		// few distinct times so that there are many equal ones, on all levels
+		switch (n % 4) {
+			case 0: { items[n].time = Rand(200); } break;
+			case 1: { items[n].time = Rand(100) * 100; } break;
+			case 2: { items[n].time = Rand(50) * 10000; } break;
+			case 3: { items[n].time = (1 << 26) + Rand(10) * 1000; } break;
+		}
+	}
+
+	// insert in several steps, so that items for the same time get into different levels
+	const int endTime = (1 << 26) + 10 * 1000;
+
+	for (int step = 0, n = 0; step < 4; step++) {
+		for (; n < (NUM_ITEMS * (step + 1)) / 4; n++) {
+			// items due in the past are woken as soon as possible
+			items[n].time = std::max(items[n].time, wheel.GetTime());
+			wheel.Insert(&items[n], items[n].time);
+			expected.push_back(&items[n]);
+		}
+
+		wheel.Advance(step * 150, [&](Item* item) { woken.push_back(item); });
+	}
+
+	wheel.Advance(endTime, [&](Item* item) { woken.push_back(item); });
+
+	std::stable_sort(expected.begin(), expected.end(), [](const Item* a, const Item* b) { return (a->time < b->time); });
+
+	BOOST_CHECK(wheel.empty());
+	BOOST_CHECK(woken.size() == expected.size());
+	BOOST_CHECK(woken == expected);
+}
+
+
+BOOST_AUTO_TEST_CASE(Reschedule50kSleepers)
+{
+	std::vector<Item> items(NUM_ITEMS);
+	std::vector<int> wheelWoken;
+	std::vector<int> queueWoken;
+
+	const int numTicks = 30 * 30;
+
+	// every item sleeps, wakes up and goes back to sleep for a random time
+	const double wheelTime = TimeSecs([&]() {
+		CTimerWheel<Item> wheel;
+		seed = 1;
+
+		for (int n = 0; n < NUM_ITEMS; n++) {
+			items[n].id = n;
+			wheel.Insert(&items[n], Rand(2000));
+		}
+		for (int t = 1; t <= numTicks; t++) {
+			const int now = t * TICK_TIME;
+
+			wheel.Advance(now, [&](Item* item) {
+				wheelWoken.push_back(item->id);
+				wheel.Insert(item, now + Rand(2000));
+			});
+		}
+
+		BOOST_CHECK(wheel.size() == NUM_ITEMS);
+	});
+
+	const double queueTime = TimeSecs([&]() {
+		std::priority_queue<QueueEntry> queue;
+		unsigned int seq = 0;
+		seed = 1;
+
+		for (int n = 0; n < NUM_ITEMS; n++) {
+			const QueueEntry e = {Rand(2000), seq++, &items[n]};
+			queue.push(e);
+		}
+		for (int t = 1; t <= numTicks; t++) {
+			const int now = t * TICK_TIME;
+
+			while (!queue.empty() && queue.top().time < now) {
+				Item* item = queue.top().item;
+				queue.pop();
+				queueWoken.push_back(item->id);
+
+				const QueueEntry e = {now + Rand(2000), seq++, item};
+				queue.push(e);
+			}
+		}
+	});
+
+	BOOST_TEST_MESSAGE(NUM_ITEMS << " sleepers, " << numTicks << " ticks, " << wheelWoken.size() << " wake-ups: timer wheel "
+		<< (wheelTime * 1000.0) << "ms, priority queue " << (queueTime * 1000.0) << "ms");
+
+	BOOST_CHECK(wheelWoken == queueWoken);
+}
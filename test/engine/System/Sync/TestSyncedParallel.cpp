@@ -0,0 +1,145 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SYNCCHECK
+	#error "This test requires SYNCCHECK to be defined on the compiler command line."
+#endif
+#include "System/Sync/SyncedParallel.h"
+#include "System/Sync/SyncedPrimitive.h"
+
+#include <vector>
+
+#define BOOST_TEST_MODULE SyncedParallel
+#include <boost/test/unit_test.hpp>
+
+// stands in for a recorded game: a fixed set of objects whose synced
+// state is advanced by parallel loops (with uneven per-item cost, so
+// threads finish their items in a different order on every run)
+static const int NUM_OBJECTS = 3000;
+static const int NUM_FRAMES = 20;
+static const int BATCH_SIZE = 16;
+
+struct SimObject {
+	SyncedSint health;
+	SyncedFloat speed;
+	SyncedUint flags;
+};
+
+
+static unsigned RunFrames(int numThreads)
+{
+	ThreadPool::SetThreadCount(numThreads);
+
+	std::vector<SimObject> objects(NUM_OBJECTS);
+	unsigned checksum = 0;
+
+	ENTER_SYNCED_CODE();
+
+	for (int frame = 0; frame < NUM_FRAMES; frame++) {
+		CSyncChecker::NewFrame();
+
+		for_mt_synced(0, NUM_OBJECTS, [&](const int i) {
+			SimObject& o = objects[i];
+
+			for (int n = 0; n < (i % 7) * 10; n++) {
+				o.speed = o.speed * 0.5f + n;
+			}
+
+			o.health = o.health + (i ^ frame);
+		});
+
+		// serial code in between parallel sections stays ordered as before
+		objects[frame].flags = frame;
+
+		for_mt_synced(0, NUM_OBJECTS, BATCH_SIZE, [&](const int idx) {
+			for (int n = idx; n < std::min(idx + BATCH_SIZE, NUM_OBJECTS); n++) {
+				objects[n].flags = objects[n].flags * 31 + objects[n].health;
+			}
+		});
+
+		checksum ^= CSyncChecker::GetChecksum() * (frame + 1);
+	}
+
+	LEAVE_SYNCED_CODE();
+
+	return checksum;
+}
+
+
+BOOST_AUTO_TEST_CASE(ChecksumIndependentOfThreadCount)
+{
+	const unsigned checksum1 = RunFrames(1);
+
+	BOOST_CHECK(checksum1 == RunFrames(2));
+	BOOST_CHECK(checksum1 == RunFrames(8));
+	BOOST_CHECK(checksum1 == RunFrames(16));
+	BOOST_CHECK(checksum1 == RunFrames(1));
+}
+
+BOOST_AUTO_TEST_CASE(ChecksumDependsOnPartitionOrder)
+{
+	ENTER_SYNCED_CODE();
+
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelSection(2);
+	CSyncChecker::EnterPartition(0); { SyncedSint a = 1; (void) a; } CSyncChecker::LeavePartition();
+	CSyncChecker::EnterPartition(1); { SyncedSint b = 2; (void) b; } CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	const unsigned checksumAB = CSyncChecker::GetChecksum();
+
+	// same writes, performed in the opposite order
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelSection(2);
+	CSyncChecker::EnterPartition(1); { SyncedSint b = 2; (void) b; } CSyncChecker::LeavePartition();
+	CSyncChecker::EnterPartition(0); { SyncedSint a = 1; (void) a; } CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	BOOST_CHECK(checksumAB == CSyncChecker::GetChecksum());
+
+	// swapping the values between partitions must be detected
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelSection(2);
+	CSyncChecker::EnterPartition(0); { SyncedSint b = 2; (void) b; } CSyncChecker::LeavePartition();
+	CSyncChecker::EnterPartition(1); { SyncedSint a = 1; (void) a; } CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	BOOST_CHECK(checksumAB != CSyncChecker::GetChecksum());
+
+	LEAVE_SYNCED_CODE();
+}
+
+BOOST_AUTO_TEST_CASE(UnwrittenPartitionsAreNotFolded)
+{
+	ENTER_SYNCED_CODE();
+
+	CSyncChecker::NewFrame();
+	{ SyncedSint a = 1; (void) a; }
+
+	const unsigned serialChecksum = CSyncChecker::GetChecksum();
+
+	// a section without Sync calls must leave the checksum alone
+	CSyncChecker::NewFrame();
+	{ SyncedSint a = 1; (void) a; }
+	CSyncChecker::BeginParallelSection(4);
+	CSyncChecker::EnterPartition(2); CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	BOOST_CHECK(serialChecksum == CSyncChecker::GetChecksum());
+
+	// the same writes, spread over different (otherwise empty) partitions
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelSection(4);
+	CSyncChecker::EnterPartition(1); { SyncedSint a = 1; (void) a; } CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	const unsigned checksum1 = CSyncChecker::GetChecksum();
+
+	CSyncChecker::NewFrame();
+	CSyncChecker::BeginParallelSection(4);
+	CSyncChecker::EnterPartition(3); { SyncedSint a = 1; (void) a; } CSyncChecker::LeavePartition();
+	CSyncChecker::EndParallelSection();
+
+	BOOST_CHECK(checksum1 == CSyncChecker::GetChecksum());
+
+	LEAVE_SYNCED_CODE();
+}
@@ -0,0 +1,143 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/SlabMemPool.h"
+
+#include <cstring>
+#include <vector>
+#include <boost/thread/thread.hpp>
+
+#define BOOST_TEST_MODULE SlabMemPool
+#include <boost/test/unit_test.hpp>
+
+static CSlabMemPool testPool("Test");
+
+
+// stand-ins for a few particle classes of different sizes
+template<int Size> struct Particle {
+	static void* operator new(size_t size) { return testPool.Alloc(size); }
+	static void operator delete(void* p, size_t size) { testPool.Free(p, size); }
+
+	Particle(int ttl): ttl(ttl) { memset(data, ttl & 0xFF, sizeof(data)); }
+	virtual ~Particle() {}
+
+	int ttl;
+	char data[Size];
+};
+
+struct Any {
+	Any(): ttl(0), size(0), pnt(NULL) {}
+	int ttl;
+	int size;
+	void* pnt;
+};
+
+static unsigned int seed = 1;
+static int Rand(int max) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % max;
+}
+
+static Any Spawn(int frame)
+{
+	Any a;
+	a.ttl = frame + 1 + Rand(90);
+
+	switch (Rand(3)) {
+		case 0: { a.size =  64; a.pnt = new Particle< 64>(a.ttl); } break;
+		case 1: { a.size = 180; a.pnt = new Particle<180>(a.ttl); } break;
+		case 2: { a.size = 400; a.pnt = new Particle<400>(a.ttl); } break;
+	}
+
+	return a;
+}
+
+static void Kill(const Any& a)
+{
+	switch (a.size) {
+		case  64: { delete (Particle< 64>*) a.pnt; } break;
+		case 180: { delete (Particle<180>*) a.pnt; } break;
+		case 400: { delete (Particle<400>*) a.pnt; } break;
+	}
+}
+
+
+
+BOOST_AUTO_TEST_CASE(ParticleChurn)
+{
+	// ~2000 particles spawned and killed per frame, as in a large battle
+	std::vector<Any> alive;
+	size_t heapAllocsAfterWarmup = 0;
+	size_t allocsAfterWarmup = 0;
+
+	for (int frame = 0; frame < 30 * 60; frame++) {
+		for (int n = 0; n < 2000; n++)
+			alive.push_back(Spawn(frame));
+
+		for (size_t i = 0; i < alive.size(); ) {
+			if (alive[i].ttl > frame) {
+				i++; continue;
+			}
+
+			Kill(alive[i]);
+			alive[i] = alive.back();
+			alive.pop_back();
+		}
+
+		testPool.UpdateFrameStats();
+
+		// the number of live particles stops growing after ~90 frames
+		if (frame >= 300) {
+			heapAllocsAfterWarmup += testPool.GetFrameStats().numHeapAllocs;
+			allocsAfterWarmup += testPool.GetFrameStats().numAllocs;
+		}
+	}
+
+	const CSlabMemPool::Stats stats = testPool.GetStats();
+
+	BOOST_TEST_MESSAGE(stats.numAllocs << " allocs, " << stats.numHeapAllocs << " heap allocs ("
+		<< heapAllocsAfterWarmup << " of " << allocsAfterWarmup << " after warm-up), "
+		<< stats.numUsedBlocks << "/" << stats.numBlocks << " blocks used in " << stats.numSlabs << " slabs");
+
+	BOOST_CHECK(stats.numUsedBlocks == alive.size());
+	BOOST_CHECK(heapAllocsAfterWarmup * 10000 < allocsAfterWarmup);
+
+	for (size_t i = 0; i < alive.size(); i++) {
+		const Particle<64>* p = (const Particle<64>*) alive[i].pnt;
+		BOOST_CHECK(p->ttl == alive[i].ttl && p->data[0] == char(alive[i].ttl & 0xFF));
+		Kill(alive[i]);
+	}
+
+	BOOST_CHECK(testPool.GetStats().numUsedBlocks == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(CrossThreadFrees)
+{
+	// one thread spawns, another deletes, blocks flow back via the shared lists
+	const int numItems = 200000;
+	std::vector< Particle<100>* > items(numItems);
+
+	const size_t usedBefore = testPool.GetStats().numUsedBlocks;
+	int numBroken = 0;
+
+	for (int round = 0; round < 4; round++) {
+		boost::thread spawner([&]() {
+			for (int n = 0; n < numItems; n++)
+				items[n] = new Particle<100>(n);
+		});
+		spawner.join();
+
+		boost::thread killer([&]() {
+			for (int n = 0; n < numItems; n++) {
+				numBroken += (items[n]->ttl != n);
+				delete items[n];
+			}
+		});
+		killer.join();
+	}
+
+	BOOST_CHECK(numBroken == 0);
+	BOOST_CHECK(testPool.GetStats().numUsedBlocks == usedBefore);
+	// the blocks are reused, not every round gets new slabs
+	BOOST_CHECK(testPool.GetStats().numBlocks < size_t(numItems) * 2);
+}
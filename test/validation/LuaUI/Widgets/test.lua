@@ -17,6 +17,12 @@ local timer
 local unitscreated = 0
 local unitsdestroyed = 0
 local maxruntime = 120 -- run at max 2 minutes
+local arenawarmup = 900 -- frames after which the query arenas should not grow anymore
+local arenaallocs = 0 -- scratch-arena heap allocations since warm-up
+local arenaframes = 0
+local lastarenaallocs
+local simframeallocs = 0 -- operator new calls during sim frames since warm-up (COUNT_HEAP_ALLOCS builds)
+local simframes = 0
 
 local function ShowStats()
 	local time = Spring.DiffTimers(Spring.GetTimer(), timer)
@@ -26,6 +32,17 @@ local function ShowStats()
 	Spring.Echo(string.format("Realtime %is gametime: %is", time, gameseconds ))
 	Spring.Echo(string.format("Run at %.2fx real time", speed))
 	Spring.Echo(string.format("Units created: %i Units destroyed: %i", unitscreated, unitsdestroyed))
+	if arenaframes > 0 then
+		-- QuadField queries and weapon targeting allocate from the arenas, which
+		-- stop touching the heap once they reached their high-water mark
+		Spring.Echo(string.format("Query arena heap allocations per frame after warm-up: %.3f (%i in %i frames)", arenaallocs / arenaframes, arenaallocs, arenaframes))
+		if arenaallocs * 100 > arenaframes then
+			Spring.Log("test.lua", LOG.ERROR, string.format("Query arenas still allocate after %i frames!", arenawarmup))
+		end
+	end
+	if simframes > 0 then
+		Spring.Echo(string.format("Heap allocations per sim frame after warm-up: %.1f (%i in %i frames)", simframeallocs / simframes, simframeallocs, simframes))
+	end
 	if unitscreated <= minunits or unitsdestroyed <= minunits then
 		Spring.Log("test.lua", LOG.ERROR, string.format("Fewer then minunits %i units were created/destroyed!", minunits))
 	end
@@ -51,6 +68,18 @@ function widget:Initialize()
 end
 
 function widget:GameFrame(n)
+	local allocs = Spring.GetScratchArenaStats()
+	if n > arenawarmup and lastarenaallocs then
+		arenaallocs = arenaallocs + (allocs - lastarenaallocs)
+		arenaframes = arenaframes + 1
+	end
+	lastarenaallocs = allocs
+	-- GameFrame runs inside the sim frame, this is the count of the previous one
+	local frameallocs = Spring.GetSimFrameHeapAllocs()
+	if n > arenawarmup + 1 and frameallocs then
+		simframeallocs = simframeallocs + frameallocs
+		simframes = simframes + 1
+	end
 	if n==maxframes then
 		ShowStats()
 		Spring.SendCommands("quit")
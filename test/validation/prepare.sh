@@ -3,17 +3,20 @@
 set -e #abort on error
 
 if [ $# -lt 4 ]; then
-	echo "Usage: $0 Game Map AI AIversion"
+	echo "Usage: $0 Game Map AI AIversion [AI2 AI2version]"
 	exit 1
 fi
 GAME="$1"
 MAP="$2"
 AI="$3"
 AIVERSION="$4"
+# the second team is played by the same AI unless another one is given
+AI2="${5:-$AI}"
+AI2VERSION="${6:-$AIVERSION}"
 
 cat <<EOD
 // a validation script
-// runs $GAME with $AI $AIVERSION vs $AI $AIVERSION on $MAP
+// runs $GAME with $AI $AIVERSION vs $AI2 $AI2VERSION on $MAP
 [GAME]
 {
 	IsHost=1;
@@ -86,8 +89,8 @@ cat <<EOD
 	[AI1]
 	{
 		Name=Bot2;
-		ShortName=$AI;
-		Version=$AIVERSION;
+		ShortName=$AI2;
+		Version=$AI2VERSION;
 		Team=1;
 		IsFromDemo=0;
 		Host=2;